@@ -275,6 +275,34 @@ public:
     void queryByFeature(const Feature& feature, const Size& feature_index, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const;
     void queryByConsensusFeature(const ConsensusFeature& cfeat, const Size& cf_index, const Size& number_of_maps, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const;
 
+    /// Compact record of a single database match as reported by queryByMZs(). No strings are copied; use the indices to look them up.
+    struct QueryHit
+    {
+      Size query_index;  ///< position of the query in the batch
+      Size adduct_index; ///< position of the adduct in the adduct list of the ion mode
+      Size db_index;     ///< position of the database entry (as reported by AccurateMassSearchResult::getMatchingIndex())
+      double query_mass; ///< neutral mass reconstructed from the observed m/z and the adduct
+    };
+
+    /**
+      @brief Batched version of queryByMZ() for many observed m/z values at once.
+
+      The neutral query masses of all queries and all (matching) adducts are sorted and joined against the (sorted) database
+      in a single pass, using a cursor which only moves forward. Queries are processed in chunks in parallel.
+      The result is identical to calling queryByMZ() for each query, but hits are reported as compact QueryHit records
+      without the 'not-found' dummies.
+
+      @param observed_mzs The m/z values to query
+      @param observed_charges One charge per query (0 = unknown)
+      @param ion_mode 'positive' or 'negative'
+      @param hits The hits, sorted by query index, then by adduct index, then by database index (i.e. the order of queryByMZ())
+      @param observed_adducts Either empty, or one adduct per query (use an empty EmpiricalFormula if unknown)
+
+      @throw Exception::IllegalArgument if init() was not called
+      @throw Exception::InvalidParameter if @p ion_mode is invalid or the sizes of the input vectors do not match
+    */
+    void queryByMZs(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<QueryHit>& hits, const std::vector<EmpiricalFormula>& observed_adducts = std::vector<EmpiricalFormula>()) const;
+
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
     void run(FeatureMap&, MzTab&) const;
@@ -340,7 +368,19 @@ private:
     void parseMappingFile_(const StringList&);
     void parseStructMappingFile_(const StringList&);
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
-    void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
+    /// the adducts of @p ion_mode; throws InvalidParameter for unknown ion modes
+    const std::vector<AdductInfo>& getAdducts_(const String& ion_mode) const;
+
+    /// converts the hits [@p first, @p last) of a single query to AccurateMassSearchResults and appends them to @p results.
+    /// Adds a 'not-found' dummy if @p results is still empty and unidentified masses are kept.
+    void materializeHits_(std::vector<QueryHit>::const_iterator first, std::vector<QueryHit>::const_iterator last, double observed_mz, Int observed_charge,
+                          const std::vector<AdductInfo>& adducts, std::vector<AccurateMassSearchResult>& results) const;
+
+    /// sets RT, intensity etc. of @p feature on its hits
+    void addFeatureInfo_(const Feature& feature, Size feature_index, std::vector<AccurateMassSearchResult>& results) const;
+
+    /// sets RT and individual intensities of @p cfeat on its hits
+    void addConsensusFeatureInfo_(const ConsensusFeature& cfeat, Size cf_index, Size number_of_maps, std::vector<AccurateMassSearchResult>& results) const;
 
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
@@ -367,6 +407,16 @@ private:
     };
     std::vector<MappingEntry_> mass_mappings_;
 
+    /// mass window of a (query, adduct) pair, used by queryByMZs()
+    struct QueryWindow_
+    {
+      double lower;
+      double upper;
+      double query_mass;
+      Size query_index;
+      Size adduct_index;
+    };
+
     struct CompareEntryAndMass_ // defined here to allow for inlining by compiler
     {
       double asMass(const MappingEntry_& v) const
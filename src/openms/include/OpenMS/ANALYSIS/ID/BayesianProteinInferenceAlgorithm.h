@@ -70,7 +70,9 @@ namespace OpenMS
    * - Learns best parameters via grid search if the parameters were not given in the param section.
    * - Writes posteriors to peptides and/or proteins and adds indistinguishable protein groups to the underlying
    *   data structures.
-   * - Can make use of OpenMP to parallelize over connected components.
+   * - Can make use of OpenMP to parallelize over connected components (largest components are scheduled first).
+   *   The structure of the factor graph of each component is only computed once and reused for all parameter
+   *   combinations of the grid search. Timings per component are reported at the end.
    */
   class OPENMS_DLLAPI BayesianProteinInferenceAlgorithm :
       public DefaultParamHandler,
@@ -97,6 +99,10 @@ namespace OpenMS
     /// A function object to pass into the GridSearch class
     struct GridSearchEvaluator;
 
+    /// Parameter-independent node structure of the factor graph of a connected component (reused across grid
+    /// search points) including timing statistics
+    struct ComponentFactorization;
+
     /// Perform inference. Filter, build graph, run the private inferPosteriorProbabilities_ function.
     /// Writes its results into protein and (optionally also) peptide hits (as new score).
     /// Optionally adds indistinguishable protein groups with separate scores, too. See Param object of class.
@@ -122,6 +128,9 @@ namespace OpenMS
     /// with which the graph was built
     void inferPosteriorProbabilities_(Internal::IDBoostGraph& ibg);
 
+    /// log timing and size statistics of the connected components (most expensive first)
+    void reportComponentStatistics_(const std::vector<ComponentFactorization>& factorizations) const;
+
     /// read Param object and set the grid
     GridSearch<double,double,double> initGridSearchFromParams_(
         std::vector<double>& alpha_search,
@@ -130,7 +130,13 @@ public:
     double applyEvaluateProteinIDs(const std::vector<ProteinIdentification>& ids, double pepCutoff = 1.0, UInt fpCutoff = 50, double diffWeight = 0.2);
     double applyEvaluateProteinIDs(const ProteinIdentification& ids, double pepCutoff = 1.0, UInt fpCutoff = 50, double diffWeight = 0.2);
 
-    /// simpler reimplemetation of the apply function above.
+    /**
+      @brief simpler reimplemetation of the apply function above.
+
+      Works on flat score/label arrays instead of a score -> FDR map: all considered hits of a run are sorted once,
+      FDRs/q-values are computed in a single scan and written back to the hits in collection order.
+      If "treat_runs_separately" is set, the identification runs are processed independently (and in parallel).
+    */
     void applyBasic(std::vector<PeptideIdentification> & ids);
     /// simpler reimplemetation of the apply function above for peptides in ConsensusMaps.
     void applyBasic(ConsensusMap & cmap, bool use_unassigned_peptides = true);
@@ -197,6 +203,27 @@ private:
     /// @note Formula used depends on Param "conservative": false -> (D+1)/T, true (e.g. used in Fido) -> (D+1)/(T+D)
     void calculateFDRBasic_(std::map<double,double>& scores_to_FDR, ScoreToTgtDecLabelPairs& scores_labels, bool qvalue, bool higher_score_better) const;
 
+    /**
+      @brief Flat-array core of calculateFDRBasic_ (same formulas, same results)
+
+      Sorts the scores once (stable radix sort on their bit patterns), counts decoys in a single prefix scan over the
+      sorted order and applies the cumulative minimum for q-values on the distinct scores.
+
+      @param scores Scores of the considered hits
+      @param is_target Target/decoy label for every entry in @p scores (non-zero = target)
+      @param fdrs Output: FDR (or q-value) for every entry in @p scores, in input order
+      @param unique_scores Output: the distinct scores in increasing order
+      @param unique_fdrs Output: FDR (or q-value) for every entry in @p unique_scores
+      @param qvalue Compute q-values instead of FDRs
+      @param higher_score_better Score orientation
+    */
+    void calculateFDRBasicFlat_(const std::vector<double>& scores, const std::vector<char>& is_target,
+                                std::vector<double>& fdrs, std::vector<double>& unique_scores, std::vector<double>& unique_fdrs,
+                                bool qvalue, bool higher_score_better) const;
+
+    /// Computes the permutation @p perm that stably sorts @p keys in increasing order (LSD radix sort with 8 bit digits)
+    static void radixSortPermutation_(const std::vector<UInt64>& keys, std::vector<Size>& perm);
+
     //TODO the next two methods could potentially be merged for speed (they iterate over the same structure)
     //But since they have different cutoff types and it is more generic, I leave it like this.
     /// calculates the area of the difference between estimated and empirical FDR on the fly. Does not store results.
@@ -37,6 +37,7 @@
 // define to get timings for connected components
 //#define INFERENCE_BENCH
 
+#include <OpenMS/ANALYSIS/ID/IDCompactGraph.h>
 #include <OpenMS/ANALYSIS/ID/MessagePasserFactory.h> //included in BPI
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Types.h>
@@ -333,9 +334,21 @@ namespace OpenMS {
                 bool use_unassigned_ids,
                 const boost::optional<const ExperimentalDesign>& ed = boost::optional<const ExperimentalDesign>());
 
+    /// Creates the graph directly split into connected components from a compact graph
+    /// (i.e. computeConnectedComponents does not need to be called). Much cheaper than building
+    /// the full graph and copying its components for large inputs. Only for the basic graph
+    /// without run information.
+    /// @pre The connected components of @p compact_graph have to be computed.
+    IDBoostGraph(ProteinIdentification& proteins,
+                 const IDCompactGraph& compact_graph);
+
 
     /// Do sth on connected components (your functor object has to inherit from std::function or be a lambda)
+    /// Components are processed in parallel, the largest ones (by number of edges) are scheduled first.
     void applyFunctorOnCCs(const std::function<unsigned long(Graph&)>& functor);
+    /// As applyFunctorOnCCs but the functor additionally gets the index of the connected component,
+    /// e.g. to cache per-component data across several calls.
+    void applyIndexedFunctorOnCCs(const std::function<unsigned long(Graph&, Size)>& functor);
     /// Do sth on connected components single threaded (your functor object has to inherit from std::function or be a lambda)
     void applyFunctorOnCCsST(const std::function<void(Graph&)>& functor);
 
@@ -362,6 +375,7 @@ namespace OpenMS {
     void calculateAndAnnotateIndistProteins(bool addSingletons = true);
 
     /// Splits the initialized graph into connected components and clears it.
+    /// Does nothing if the graph was created already split (from an IDCompactGraph).
     void computeConnectedComponents();
 
 
@@ -438,6 +452,9 @@ namespace OpenMS {
     /* ----------------------------------------------------------- */
 
 
+    /// indices of the connected components, ordered by decreasing size (edges, then vertices)
+    std::vector<Size> getCCsLargestFirst_() const;
+
     /// helper function to add a vertex if it is not present yet, otherwise return the present one
     /// needs a temporary filled vertex_map that is modifiable
     vertex_t addVertexWithLookup_(IDPointer& ptr, std::unordered_map<IDPointer, vertex_t, boost::hash<IDPointer>>& vertex_map);
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  namespace Internal
+  {
+
+  /**
+   @brief A compact, immutable protein-PSM graph in compressed sparse row (CSR) layout
+
+   Lightweight alternative to the basic (i.e. without run information) IDBoostGraph for very large
+   inputs. Nodes are plain integers: the first getNrPSMs() nodes are the PSMs (PeptideHits) in the
+   order they were encountered, the remaining ones are the protein hits of the ProteinIdentification
+   in their original order. Edges are stored once per direction in two flat arrays (offsets and
+   adjacencies), so building the graph needs no per-node allocations and no hashing of node pointers.
+
+   Connected components are labeled with a union-find pass over the edges. The components are
+   represented as a second CSR structure over the node ids (nothing is copied) and are numbered
+   in the order of their first PSM, i.e. the same order that IDBoostGraph::computeConnectedComponents
+   produces. Proteins without any PSM are not part of any component.
+
+   The same restrictions as for IDBoostGraph apply: do not modify the hit vectors of the underlying
+   ID structures while the graph is in use. Scores and meta values may be changed.
+
+   @ingroup Analysis_ID
+   */
+  class OPENMS_DLLAPI IDCompactGraph
+  {
+  public:
+
+    /// node ids are 32 bit to keep the adjacency arrays small
+    typedef UInt32 Node;
+
+    /// a range of node ids (e.g. neighbors of a node or nodes of a component)
+    typedef std::pair<const Node*, const Node*> NodeRange;
+
+    /// Builds the graph from PeptideIdentifications. Only IDs of the run of @p proteins are used.
+    /// @param use_top_psms Nr of top PSMs used per spectrum (0 means all)
+    IDCompactGraph(ProteinIdentification& proteins,
+                   std::vector<PeptideIdentification>& idedSpectra,
+                   Size use_top_psms);
+
+    /// Builds the graph from the PeptideIdentifications of a ConsensusMap. Only IDs of the run of @p proteins are used.
+    /// @param use_top_psms Nr of top PSMs used per spectrum (0 means all)
+    /// @param use_unassigned_ids Also include unassigned PeptideIdentifications
+    IDCompactGraph(ProteinIdentification& proteins,
+                   ConsensusMap& cmap,
+                   Size use_top_psms,
+                   bool use_unassigned_ids);
+
+    /// Number of nodes (PSMs and proteins)
+    Size getNrNodes() const;
+    /// Number of PSM nodes
+    Size getNrPSMs() const;
+    /// Number of protein nodes (all hits of the ProteinIdentification, also unreferenced ones)
+    Size getNrProteins() const;
+    /// Number of (undirected) protein-PSM edges
+    Size getNrEdges() const;
+
+    /// Is node @p n a protein node?
+    bool isProtein(Node n) const
+    {
+      return n >= psms_.size();
+    }
+
+    /// The PeptideHit of PSM node @p n
+    PeptideHit* getPSM(Node n) const;
+    /// The ProteinHit of protein node @p n
+    ProteinHit* getProtein(Node n) const;
+    /// The node id of the protein hit at position @p protein_index in the ProteinIdentification
+    Node getProteinNode(Size protein_index) const;
+
+    /// Neighbors of node @p n, sorted by node id
+    NodeRange getNeighbors(Node n) const;
+
+    /// Labels connected components (union-find). Does not copy or modify the graph.
+    void computeConnectedComponents();
+
+    /// Zero means the components were not computed yet
+    Size getNrConnectedComponents() const;
+
+    /// Nodes of component @p cc, sorted by node id (i.e. PSMs first)
+    NodeRange getComponent(Size cc) const;
+
+    /// Number of edges in component @p cc
+    Size getNrEdgesInComponent(Size cc) const;
+
+    /// The component node @p n belongs to. Proteins without PSMs do not belong to any (returns getNrConnectedComponents()).
+    Size getComponentOf(Node n) const;
+
+    /// Annotate indistinguishable proteins (proteins with the same set of PSMs) by adding the groups to the underlying
+    /// ProteinIdentification::ProteinGroups object. Same semantics as IDBoostGraph::calculateAndAnnotateIndistProteins.
+    /// The graph itself is not modified. Connected components are computed if this was not done yet.
+    /// @param addSingletons if you want to annotate groups with just one protein entry
+    void calculateAndAnnotateIndistProteins(bool addSingletons = true);
+
+    ProteinIdentification& getProteinIDs();
+
+  private:
+
+    ProteinIdentification& protIDs_;
+
+    /// the hits behind the PSM nodes
+    std::vector<PeptideHit*> psms_;
+
+    /// CSR: neighbors of node n are adjacency_[offsets_[n]] ... adjacency_[offsets_[n+1]-1]
+    std::vector<Size> offsets_;
+    std::vector<Node> adjacency_;
+
+    /// CSR over the components: nodes of component c are cc_nodes_[cc_offsets_[c]] ... cc_nodes_[cc_offsets_[c+1]-1]
+    std::vector<Size> cc_offsets_;
+    std::vector<Node> cc_nodes_;
+    /// component label per node
+    std::vector<UInt32> cc_of_node_;
+
+    /// collects the PSM nodes and their (PSM index, protein index) edges of one PeptideIdentification
+    void addPeptideID_(PeptideIdentification& spectrum,
+                       const std::unordered_map<std::string, Size>& accession_map,
+                       Size use_top_psms,
+                       std::vector<std::pair<Node, Node>>& edges,
+                       Size& nr_unknown_accessions);
+
+    /// creates the CSR arrays from the collected edges (counting sort, no per-node containers)
+    void buildCSR_(const std::vector<std::pair<Node, Node>>& edges);
+
+    static std::unordered_map<std::string, Size> buildAccessionMap_(ProteinIdentification& proteins);
+
+    /// groups the proteins of component @p cc by their PSMs
+    void calculateIndistProteins_(Size cc, bool addSingletons, std::vector<ProteinIdentification::ProteinGroup>& groups) const;
+  };
+
+  } // namespace Internal
+} // namespace OpenMS
@@ -21,6 +21,7 @@ ConsensusMapMergerAlgorithm.h
 FalseDiscoveryRate.h
 HiddenMarkovModel.h
 IDBoostGraph.h
+IDCompactGraph.h
 IDDecoyProbability.h
 IDConflictResolverAlgorithm.h
 IDMapper.h
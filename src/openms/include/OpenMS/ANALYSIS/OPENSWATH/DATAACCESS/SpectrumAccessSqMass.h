@@ -52,12 +52,19 @@ namespace OpenMS
    * @brief An implementation of the Spectrum Access interface using SQL files
    *
    * The interface takes an MzMLSqliteHandler object to access spectra and
-   * chromatograms from a sqlite file (sqMass). Currently access to individual
-   * spectra and chromatograms are not supported due to large overhead of
-   * opening a DB connection and performing a single query.
+   * chromatograms from a sqlite file (sqMass). The retention times and meta
+   * data of the accessible spectra are read once on construction and kept in
+   * memory, so getSpectraByRT and getSpectrumMetaById do not access the
+   * database. Individual spectra are read through a pool of database
+   * connections with prepared statements (one connection per concurrently
+   * reading thread) and the most recently decoded spectra are kept in a
+   * cache of bounded size (see setCacheSize), so OpenSwath can work directly
+   * on the file without loading it into memory. Connections and cache are
+   * shared by all copies of an object and by all objects derived from it
+   * through the subset constructor. Cached spectra are copied on access, so
+   * callers own the returned spectrum and may modify it.
    *
-   * Instead, the users should use getAllSpectra which returns all available
-   * spectra together.
+   * To load all spectra into memory at once, getAllSpectra should be used.
    *
    * The interface allows to be constructed in a way as to only provide access
    * to a subset of spectra / chromatograms by supplying a set of indices which
@@ -114,6 +121,14 @@ public:
     /// Load all spectra from the underlying sqMass file into memory
     void getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra, std::vector< OpenSwath::SpectrumMeta > & spectra_meta) const;
 
+    /**
+      @brief Set the maximal number of decoded spectra kept in the cache
+
+      The least recently used spectra are removed first. The cache is shared
+      with all copies of this object (default: 256 spectra, 0 disables the cache).
+    */
+    void setCacheSize(Size max_spectra);
+
     std::vector<std::size_t> getSpectraByRT(double /* RT */, double /* deltaRT */) const override;
 
     size_t getNrSpectra() const override;
@@ -126,10 +141,22 @@ public:
 
 private:
 
+    /// Meta data and retention time index of the accessible spectra
+    struct SpectrumIndex_;
+    /// Database connections and decoded spectra, shared between objects accessing the same file
+    struct SharedData_;
+
+    /// Read the meta data of the accessible spectra and build the retention time index
+    void buildIndex_();
+
     /// Access to underlying sqMass file
     OpenMS::Internal::MzMLSqliteHandler handler_;
     /// Optional subset of spectral indices
     std::vector<int> sidx_;
+    /// Meta data and retention time index (immutable, shared between copies)
+    boost::shared_ptr<const SpectrumIndex_> index_;
+    /// Connection pool and spectrum cache
+    boost::shared_ptr<SharedData_> shared_;
   };
 } //end namespace OpenMS
 
@@ -42,10 +42,12 @@
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ITransition.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
+#include <memory>
 
 namespace OpenMS
 {
   class TheoreticalSpectrumGenerator;
+  class CoarseIsotopePatternCache;
 
   /**
     @brief Scoring of an spectrum at the peak apex of an chromatographic elution peak.
@@ -182,15 +184,25 @@ private:
       monoisotopic peak or not. It will do so by searching for an intense peak
       at a lower m/z that could explain the current peak as part of a isotope
       pattern.
+      The signal at the lower m/z positions needs to be integrated beforehand
+      (see getPreIsotopeWindows_), so it can be looked up together with other
+      windows of the same spectrum.
 
-      @param spectrum The spectrum (MS1 or MS2)
+      @param pre_mz Intensity-weighted m/z of the signal at (mono_mz - 1 / charge) for each charge state (see getPreIsotopeWindows_)
+      @param pre_int Intensity of the signal at (mono_mz - 1 / charge) for each charge state
       @param mono_mz The m/z value where a monoisotopic is expected
       @param mono_int The intensity of the monoisotopic peak (peak at mono_mz)
       @param nr_occurrences Will contain the count of how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
       @param nr_occurrences Will contain the maximum ratio of a peaks intensity compared to the monoisotopic peak intensity how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
 
     */
-    void largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio);
+    void largePeaksBeforeFirstIsotope_(const double* pre_mz, const double* pre_int, double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio);
+
+    /// Appends the extraction windows of the isotopes of a peak at mono_mz (dia_nr_isotopes_ + 1 windows)
+    void getIsotopeWindows_(double mono_mz, int charge, std::vector<double>& left, std::vector<double>& right) const;
+
+    /// Appends the extraction windows in front of a peak at mono_mz used by largePeaksBeforeFirstIsotope_ (one per charge state)
+    void getPreIsotopeWindows_(double mono_mz, std::vector<double>& left, std::vector<double>& right) const;
 
     /**
       @brief Compare an experimental isotope pattern to a theoretical one
@@ -216,6 +228,10 @@ private:
     bool dia_extraction_ppm_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    /// isotope distributions of sum formulas (dia_nr_isotopes_ isotopes) and of averagine peptides (dia_nr_isotopes_ + 1 isotopes)
+    std::unique_ptr<CoarseIsotopePatternCache> formula_isotopes_;
+    std::unique_ptr<CoarseIsotopePatternCache> averagine_isotopes_;
   };
 }
 
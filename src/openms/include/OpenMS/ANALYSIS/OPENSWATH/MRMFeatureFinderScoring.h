@@ -188,6 +188,24 @@ public:
                          FeatureMap& output,
                          bool ms1only = false);
 
+    /** @brief Compute the DIA / SWATH scores of many transition groups at once
+     *
+     * Scores the peak groups of all given (already picked) transition groups
+     * together, ordered by their apex retention time (see
+     * OpenSwathScoring::calculateDIAScoresBatch). The added-up spectrum at
+     * an apex is thus only retrieved once, even if it is shared by peak
+     * groups of different compounds. The scores are kept until
+     * scorePeakgroups() is called for the respective transition group, which
+     * then uses them instead of scoring each peak group individually. The
+     * resulting scores are identical.
+     *
+     * @param transition_groups The picked transition groups (e.g. all transition groups of a SWATH window)
+     * @param swath_maps The SWATH-MS (DIA) maps from which the chromatograms were extracted
+     *
+    */
+    void precomputeDIAScores(const std::vector<MRMTransitionGroupType*>& transition_groups,
+                             const std::vector<OpenSwath::SwathMap>& swath_maps);
+
     /** @brief Set the flag for strict mapping
     */
     void setStrictFlag(bool f)
@@ -315,6 +333,9 @@ private:
     // data
     OpenSwath::SpectrumAccessPtr ms1_map_;
 
+    /// DIA / SWATH scores and mass errors per transition group and peak group (see precomputeDIAScores)
+    std::map<String, std::vector<std::pair<OpenSwath_Scores, std::vector<double> > > > precomputed_dia_scores_;
+
   };
 }
 
@@ -160,6 +160,7 @@ public:
       // and terminate.
       int chr_idx, peak_idx, cnt = 0;
       std::vector<MRMFeature> features;
+      TransitionGroupData_<SpectrumT> group_data; // shared by all features of this group
       while (true)
       {
         chr_idx = -1; peak_idx = -1;
@@ -176,7 +177,7 @@ public:
         if (chr_idx == -1 && peak_idx == -1) break;
 
         // Compute a feature from the individual chromatograms and add non-zero features
-        MRMFeature mrm_feature = createMRMFeature(transition_group, picked_chroms, smoothed_chroms, chr_idx, peak_idx);
+        MRMFeature mrm_feature = createMRMFeature_(transition_group, picked_chroms, smoothed_chroms, chr_idx, peak_idx, group_data);
         if (mrm_feature.getIntensity() > 0)
         {
           features.push_back(mrm_feature);
@@ -217,6 +218,237 @@ public:
                                 const std::vector<SpectrumT>& smoothed_chroms,
                                 const int chr_idx,
                                 const int peak_idx)
+    {
+      TransitionGroupData_<SpectrumT> group_data;
+      return createMRMFeature_(transition_group, picked_chroms, smoothed_chroms, chr_idx, peak_idx, group_data);
+    }
+
+    // maybe private, but we have tests
+
+    /**
+      @brief Remove overlapping features.
+
+      Remove features that are within the current seed (between best_left and
+      best_right) or overlap with it. An overlapping feature is defined as a
+      feature that has either of its borders within the border of the current
+      peak
+
+      Directly adjacent features are allowed, e.g. they can share one
+      border.
+    */
+    template <typename SpectrumT>
+    void remove_overlapping_features(std::vector<SpectrumT>& picked_chroms, double best_left, double best_right)
+    {
+      // delete all seeds that lie within the current seed
+      //std::cout << "Removing features for peak  between " << best_left << " " << best_right << std::endl;
+      for (Size k = 0; k < picked_chroms.size(); k++)
+      {
+        for (Size i = 0; i < picked_chroms[k].size(); i++)
+        {
+          if (picked_chroms[k][i].getMZ() >= best_left && picked_chroms[k][i].getMZ() <= best_right)
+          {
+            //std::cout << "For Chrom " << k << " removing peak " << picked_chroms[k][i].getMZ() << " l/r : " << picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i] << " " <<
+            //  picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i] << " with int " <<  picked_chroms[k][i].getIntensity() <<std::endl;
+            picked_chroms[k][i].setIntensity(0.0);
+          }
+        }
+      }
+
+      // delete all seeds that overlap within the current seed
+      for (Size k = 0; k < picked_chroms.size(); k++)
+      {
+        for (Size i = 0; i < picked_chroms[k].size(); i++)
+        {
+          if (picked_chroms[k][i].getIntensity() <= 0.0) {continue; }
+
+          double left = picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i];
+          double right = picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i];
+          if ((left > best_left && left < best_right)
+             || (right > best_left && right < best_right))
+          {
+            //std::cout << "= For Chrom " << k << " removing contained peak " << picked_chroms[k][i].getMZ() << " l/r : " << picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i] << " " <<
+            //  picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i] << " with int " <<  picked_chroms[k][i].getIntensity() <<std::endl;
+            picked_chroms[k][i].setIntensity(0.0);
+          }
+        }
+      }
+    }
+
+    /// Find largest peak in a vector of chromatograms
+    void findLargestPeak(const std::vector<MSChromatogram >& picked_chroms, int& chr_idx, int& peak_idx);
+
+    /**
+      @brief Given a vector of chromatograms, find the indices of the chromatogram
+      containing the widest peak and of the position of highest intensity.
+
+      @param[in] picked_chroms The vector of chromatograms
+      @param[out] chrom_idx The index of the chromatogram containing the widest peak
+      @param[out] point_idx The index of the point with highest intensity
+    */
+    void findWidestPeakIndices(const std::vector<MSChromatogram>& picked_chroms, Int& chrom_idx, Int& point_idx) const;
+
+protected:
+
+    /// Synchronize members with param class
+    void updateMembers_() override;
+
+    /// Assignment operator is protected for algorithm
+    MRMTransitionGroupPicker& operator=(const MRMTransitionGroupPicker& rhs);
+
+    /**
+      @brief Data of a transition group that does not depend on the picked peak
+
+      The intensity sums and mutual information of the chromatograms are the
+      same for every feature of a transition group and are therefore computed
+      only once. If resample_once is set, all chromatograms are also resampled
+      only once onto a shared retention time grid, instead of once per
+      feature and chromatogram.
+    */
+    template <typename SpectrumT>
+    struct TransitionGroupData_
+    {
+      /// Whether the data has been computed
+      bool initialized = false;
+      /// Intensity sum over all detecting transitions
+      double total_xic = 0.0;
+      /// Mutual information on peak group level (only if compute_total_mi is set)
+      double total_mi = 0.0;
+      /// Whether the chromatograms have been resampled onto a shared grid
+      bool resampled = false;
+      /// Intensity sum of each transition
+      std::vector<double> transition_total_xic;
+      /// Mutual information of each transition (only if compute_total_mi is set)
+      std::vector<double> transition_total_mi;
+      /// Transition chromatograms resampled onto the shared grid (only if resample_once is set)
+      std::vector<SpectrumT> resampled_chroms;
+      /// Precursor chromatograms resampled onto the shared grid (only if resample_once is set)
+      std::vector<SpectrumT> resampled_precursor_chroms;
+      /// Smoothed chromatograms resampled onto the shared grid (only if resample_once is set)
+      std::vector<SpectrumT> resampled_smoothed_chroms;
+    };
+
+    /**
+      @brief Compute the data of a transition group that does not depend on the picked peak
+
+      @param transition_group The transition group
+      @param smoothed_chroms The smoothed chromatograms
+      @param ref_chromatogram Chromatogram providing the retention time grid for resample_once
+      @param group_data Output data
+    */
+    template <typename SpectrumT, typename TransitionT>
+    void prepareTransitionGroupData_(const MRMTransitionGroup<SpectrumT, TransitionT>& transition_group,
+                                     const std::vector<SpectrumT>& smoothed_chroms,
+                                     const SpectrumT& ref_chromatogram,
+                                     TransitionGroupData_<SpectrumT>& group_data)
+    {
+      const std::vector<TransitionT>& transitions = transition_group.getTransitions();
+      group_data.total_xic = 0.0;
+      group_data.total_mi = 0.0;
+      group_data.transition_total_xic.assign(transitions.size(), 0.0);
+      group_data.transition_total_mi.assign(transitions.size(), 0.0);
+
+      // Compute total intensity on transition-level and overall
+      std::vector<std::vector<double> > intensities(transitions.size());
+      for (Size k = 0; k < transitions.size(); k++)
+      {
+        const SpectrumT& chromatogram = selectChromHelper_(transition_group, transitions[k].getNativeID());
+        const bool detecting = transitions[k].isDetectingTransition();
+        double transition_total_xic = 0;
+        for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
+        {
+          transition_total_xic += it->getIntensity();
+          if (detecting) { group_data.total_xic += it->getIntensity(); }
+        }
+        group_data.transition_total_xic[k] = transition_total_xic;
+
+        if (compute_total_mi_)
+        {
+          intensities[k].reserve(chromatogram.size());
+          for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
+          {
+            intensities[k].push_back(it->getIntensity());
+          }
+        }
+      }
+
+      // Compute total mutual information on transition-level
+      if (compute_total_mi_)
+      {
+        for (Size k = 0; k < transitions.size(); k++)
+        {
+          // compute baseline mutual information
+          double transition_total_mi = 0;
+          int transition_total_mi_norm = 0;
+          for (Size m = 0; m < transitions.size(); m++)
+          {
+            if (transitions[m].isDetectingTransition())
+            {
+              transition_total_mi += OpenSwath::Scoring::rankedMutualInformation(intensities[m], intensities[k]);
+              transition_total_mi_norm++;
+            }
+          }
+          if (transition_total_mi_norm > 0) { transition_total_mi /= transition_total_mi_norm; }
+          group_data.transition_total_mi[k] = transition_total_mi;
+
+          if (transitions[k].isDetectingTransition())
+          {
+            // sum up all transition-level total MI and divide by the number of detection transitions to have peak group level total MI
+            group_data.total_mi += transition_total_mi / transition_total_mi_norm;
+          }
+        }
+      }
+
+      // Resample all chromatograms onto the grid of the reference chromatogram
+      group_data.resampled_chroms.clear();
+      group_data.resampled_precursor_chroms.clear();
+      group_data.resampled_smoothed_chroms.clear();
+      group_data.resampled = resample_once_ && !ref_chromatogram.empty();
+      if (group_data.resampled)
+      {
+        const double left = ref_chromatogram.front().getMZ();
+        const double right = ref_chromatogram.back().getMZ();
+        SpectrumT master_peak_container;
+        prepareMasterContainer_(ref_chromatogram, master_peak_container, left, right);
+        if (peak_integration_ == "original")
+        {
+          group_data.resampled_chroms.reserve(transitions.size());
+          for (Size k = 0; k < transitions.size(); k++)
+          {
+            const SpectrumT& chromatogram = selectChromHelper_(transition_group, transitions[k].getNativeID());
+            group_data.resampled_chroms.push_back(resampleChromatogram_(chromatogram, master_peak_container, left, right));
+          }
+          group_data.resampled_precursor_chroms.reserve(transition_group.getPrecursorChromatograms().size());
+          for (Size k = 0; k < transition_group.getPrecursorChromatograms().size(); k++)
+          {
+            group_data.resampled_precursor_chroms.push_back(resampleChromatogram_(transition_group.getPrecursorChromatograms()[k],
+                                                                                  master_peak_container, left, right));
+          }
+        }
+        else if (peak_integration_ == "smoothed")
+        {
+          group_data.resampled_smoothed_chroms.reserve(smoothed_chroms.size());
+          for (Size k = 0; k < smoothed_chroms.size(); k++)
+          {
+            group_data.resampled_smoothed_chroms.push_back(resampleChromatogram_(smoothed_chroms[k], master_peak_container, left, right));
+          }
+        }
+      }
+      group_data.initialized = true;
+    }
+    /**
+      @brief Create feature from a vector of chromatograms and a specified peak
+
+      Same as createMRMFeature(), but takes the data that does not depend on
+      the peak from @p group_data. The data is computed on the first call and
+      reused by all further features of the same transition group.
+    */
+    template <typename SpectrumT, typename TransitionT>
+    MRMFeature createMRMFeature_(const MRMTransitionGroup<SpectrumT, TransitionT>& transition_group,
+                                 std::vector<SpectrumT>& picked_chroms,
+                                 const std::vector<SpectrumT>& smoothed_chroms,
+                                 const int chr_idx,
+                                 const int peak_idx,
+                                 TransitionGroupData_<SpectrumT>& group_data)
     {
       OPENMS_PRECONDITION(transition_group.isInternallyConsistent(), "Consistent state required")
       OPENMS_PRECONDITION(transition_group.chromatogramIdsMatch(), "Chromatogram native IDs need to match keys in transition group")
@@ -322,12 +554,20 @@ public:
       // maximal right boundary to prepare the container.
       SpectrumT master_peak_container;
       const SpectrumT& ref_chromatogram = selectChromHelper_(transition_group, picked_chroms[chr_idx].getNativeID());
-      prepareMasterContainer_(ref_chromatogram, master_peak_container, min_left, max_right);
+      if (!group_data.initialized)
+      {
+        // the first feature of the group provides the grid for resample_once
+        prepareTransitionGroupData_(transition_group, smoothed_chroms, ref_chromatogram, group_data);
+      }
+      if (!group_data.resampled)
+      {
+        prepareMasterContainer_(ref_chromatogram, master_peak_container, min_left, max_right);
+      }
 
       // Iterate over initial transitions / chromatograms (note that we may
       // have a different number of picked chromatograms than total transitions
       // as not all are detecting transitions).
-      double total_intensity = 0; double total_peak_apices = 0; double total_xic = 0; double total_mi = 0;
+      double total_intensity = 0; double total_peak_apices = 0;
       for (Size k = 0; k < transition_group.getTransitions().size(); k++)
       {
 
@@ -348,63 +588,25 @@ public:
         }
 
         const SpectrumT& chromatogram = selectChromHelper_(transition_group, transition_group.getTransitions()[k].getNativeID()); 
-        if (transition_group.getTransitions()[k].isDetectingTransition())
-        {
-          for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
-          {
-            total_xic += it->getIntensity();
-          }
-        }
 
-        // Compute total intensity on transition-level
-        double transition_total_xic = 0; 
-
-        for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
-        {
-          transition_total_xic += it->getIntensity();
-        }
+        // Total intensity and mutual information on transition-level
+        const double transition_total_xic = group_data.transition_total_xic[k];
+        const double transition_total_mi = group_data.transition_total_mi[k];
 
-        // Compute total mutual information on transition-level.
-        double transition_total_mi = 0;
-        if (compute_total_mi_)
+        SpectrumT resampled_chromatogram;
+        const SpectrumT* used_chromatogram = &resampled_chromatogram;
+        // resample the current chromatogram (unless already done for the whole group)
+        if (peak_integration_ == "original")
         {
-          std::vector<double> chrom_vect_id, chrom_vect_det;
-          for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
+          if (group_data.resampled)
           {
-            chrom_vect_id.push_back(it->getIntensity());
+            used_chromatogram = &group_data.resampled_chroms[k];
           }
-
-          // compute baseline mutual information
-          int transition_total_mi_norm = 0;
-          for (Size m = 0; m < transition_group.getTransitions().size(); m++)
+          else
           {
-            if (transition_group.getTransitions()[m].isDetectingTransition())
-            {
-              const SpectrumT& chromatogram_det = selectChromHelper_(transition_group, transition_group.getTransitions()[m].getNativeID());
-              chrom_vect_det.clear();
-              for (typename SpectrumT::const_iterator it = chromatogram_det.begin(); it != chromatogram_det.end(); it++)
-              {
-                chrom_vect_det.push_back(it->getIntensity());
-              }
-              transition_total_mi += OpenSwath::Scoring::rankedMutualInformation(chrom_vect_det, chrom_vect_id);
-              transition_total_mi_norm++;
-            }
-          }
-          if (transition_total_mi_norm > 0) { transition_total_mi /= transition_total_mi_norm; }
-
-          if (transition_group.getTransitions()[k].isDetectingTransition())
-          {
-            // sum up all transition-level total MI and divide by the number of detection transitions to have peak group level total MI
-            total_mi += transition_total_mi / transition_total_mi_norm;
+            resampled_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
           }
         }
-
-        SpectrumT used_chromatogram;
-        // resample the current chromatogram
-        if (peak_integration_ == "original")
-        {
-          used_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
-        }
         else if (peak_integration_ == "smoothed")
         {
           if (smoothed_chroms.size() <= k) 
@@ -412,7 +614,14 @@ public:
             throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                              "Tried to calculate peak area and height without any smoothed chromatograms");
           }
-          used_chromatogram = resampleChromatogram_(smoothed_chroms[k], master_peak_container, local_left, local_right);
+          if (group_data.resampled)
+          {
+            used_chromatogram = &group_data.resampled_smoothed_chroms[k];
+          }
+          else
+          {
+            resampled_chromatogram = resampleChromatogram_(smoothed_chroms[k], master_peak_container, local_left, local_right);
+          }
         }
         else
         {
@@ -425,7 +634,7 @@ public:
         f.setQuality(0, quality);
         f.setOverallQuality(quality);
 
-        PeakIntegrator::PeakArea pa = pi_.integratePeak(used_chromatogram, local_left, local_right);
+        PeakIntegrator::PeakArea pa = pi_.integratePeak(*used_chromatogram, local_left, local_right);
         double peak_integral = pa.area;
         double peak_apex_int = pa.height;
         f.setMetaValue("peak_apex_position", pa.apex_pos);
@@ -443,7 +652,7 @@ public:
           }
           else if (background_subtraction_ == "exact")
           {
-            PeakIntegrator::PeakBackground pb = pi_.estimateBackground(used_chromatogram, local_left, local_right, pa.apex_pos);
+            PeakIntegrator::PeakBackground pb = pi_.estimateBackground(*used_chromatogram, local_left, local_right, pa.apex_pos);
             background = pb.area;
             avg_noise_level = pb.height;
           }
@@ -487,7 +696,7 @@ public:
 
         // for backwards compatibility with TOPP tests
         // Calculate peak shape metrics that will be used for later QC
-        PeakIntegrator::PeakShapeMetrics psm = pi_.calculatePeakShapeMetrics(used_chromatogram, local_left, local_right, peak_apex_int, pa.apex_pos);
+        PeakIntegrator::PeakShapeMetrics psm = pi_.calculatePeakShapeMetrics(*used_chromatogram, local_left, local_right, peak_apex_int, pa.apex_pos);
         f.setMetaValue("width_at_50", psm.width_at_50);
         if (compute_peak_shape_metrics_)
         {
@@ -529,11 +738,19 @@ public:
           local_right = right_edges[prec_idx];
         }
 
-        SpectrumT used_chromatogram;
-        // resample the current chromatogram
+        SpectrumT resampled_chromatogram;
+        const SpectrumT* used_chromatogram = &resampled_chromatogram;
+        // resample the current chromatogram (unless already done for the whole group)
         if (peak_integration_ == "original")
         {
-          used_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
+          if (group_data.resampled)
+          {
+            used_chromatogram = &group_data.resampled_precursor_chroms[k];
+          }
+          else
+          {
+            resampled_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
+          }
           // const SpectrumT& used_chromatogram = chromatogram; // instead of resampling
         }
         else if (peak_integration_ == "smoothed" && smoothed_chroms.size() <= prec_idx)
@@ -543,7 +760,14 @@ public:
         }
         else if (peak_integration_ == "smoothed")
         {
-          used_chromatogram = resampleChromatogram_(smoothed_chroms[prec_idx], master_peak_container, local_left, local_right);
+          if (group_data.resampled)
+          {
+            used_chromatogram = &group_data.resampled_smoothed_chroms[prec_idx];
+          }
+          else
+          {
+            resampled_chromatogram = resampleChromatogram_(smoothed_chroms[prec_idx], master_peak_container, local_left, local_right);
+          }
         }
         else
         {
@@ -556,7 +780,7 @@ public:
         f.setQuality(0, quality);
         f.setOverallQuality(quality);
 
-        PeakIntegrator::PeakArea pa = pi_.integratePeak(used_chromatogram, local_left, local_right);
+        PeakIntegrator::PeakArea pa = pi_.integratePeak(*used_chromatogram, local_left, local_right);
         double peak_integral = pa.area;
         double peak_apex_int = pa.height;
 
@@ -579,7 +803,7 @@ public:
           }
           else if (background_subtraction_ == "exact")
           {
-            PeakIntegrator::PeakBackground pb = pi_.estimateBackground(used_chromatogram, local_left, local_right, pa.apex_pos);
+            PeakIntegrator::PeakBackground pb = pi_.estimateBackground(*used_chromatogram, local_left, local_right, pa.apex_pos);
             background = pb.area;
             avg_noise_level = pb.height;
           }
@@ -622,10 +846,10 @@ public:
       mrmFeature.setMetaValue("PeptideRef", transition_group.getTransitionGroupID());
       mrmFeature.setMetaValue("leftWidth", best_left);
       mrmFeature.setMetaValue("rightWidth", best_right);
-      mrmFeature.setMetaValue("total_xic", total_xic);
+      mrmFeature.setMetaValue("total_xic", group_data.total_xic);
       if (compute_total_mi_)
       {
-        mrmFeature.setMetaValue("total_mi", total_mi);
+        mrmFeature.setMetaValue("total_mi", group_data.total_mi);
       }
       mrmFeature.setMetaValue("peak_apices_sum", total_peak_apices);
 
@@ -633,77 +857,6 @@ public:
       return mrmFeature;
     }
 
-    // maybe private, but we have tests
-
-    /**
-      @brief Remove overlapping features.
-
-      Remove features that are within the current seed (between best_left and
-      best_right) or overlap with it. An overlapping feature is defined as a
-      feature that has either of its borders within the border of the current
-      peak
-
-      Directly adjacent features are allowed, e.g. they can share one
-      border.
-    */
-    template <typename SpectrumT>
-    void remove_overlapping_features(std::vector<SpectrumT>& picked_chroms, double best_left, double best_right)
-    {
-      // delete all seeds that lie within the current seed
-      //std::cout << "Removing features for peak  between " << best_left << " " << best_right << std::endl;
-      for (Size k = 0; k < picked_chroms.size(); k++)
-      {
-        for (Size i = 0; i < picked_chroms[k].size(); i++)
-        {
-          if (picked_chroms[k][i].getMZ() >= best_left && picked_chroms[k][i].getMZ() <= best_right)
-          {
-            //std::cout << "For Chrom " << k << " removing peak " << picked_chroms[k][i].getMZ() << " l/r : " << picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i] << " " <<
-            //  picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i] << " with int " <<  picked_chroms[k][i].getIntensity() <<std::endl;
-            picked_chroms[k][i].setIntensity(0.0);
-          }
-        }
-      }
-
-      // delete all seeds that overlap within the current seed
-      for (Size k = 0; k < picked_chroms.size(); k++)
-      {
-        for (Size i = 0; i < picked_chroms[k].size(); i++)
-        {
-          if (picked_chroms[k][i].getIntensity() <= 0.0) {continue; }
-
-          double left = picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i];
-          double right = picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i];
-          if ((left > best_left && left < best_right)
-             || (right > best_left && right < best_right))
-          {
-            //std::cout << "= For Chrom " << k << " removing contained peak " << picked_chroms[k][i].getMZ() << " l/r : " << picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][i] << " " <<
-            //  picked_chroms[k].getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][i] << " with int " <<  picked_chroms[k][i].getIntensity() <<std::endl;
-            picked_chroms[k][i].setIntensity(0.0);
-          }
-        }
-      }
-    }
-
-    /// Find largest peak in a vector of chromatograms
-    void findLargestPeak(const std::vector<MSChromatogram >& picked_chroms, int& chr_idx, int& peak_idx);
-
-    /**
-      @brief Given a vector of chromatograms, find the indices of the chromatogram
-      containing the widest peak and of the position of highest intensity.
-
-      @param[in] picked_chroms The vector of chromatograms
-      @param[out] chrom_idx The index of the chromatogram containing the widest peak
-      @param[out] point_idx The index of the point with highest intensity
-    */
-    void findWidestPeakIndices(const std::vector<MSChromatogram>& picked_chroms, Int& chrom_idx, Int& point_idx) const;
-
-protected:
-
-    /// Synchronize members with param class
-    void updateMembers_() override;
-
-    /// Assignment operator is protected for algorithm
-    MRMTransitionGroupPicker& operator=(const MRMTransitionGroupPicker& rhs);
 
     /**
       @brief Select matching precursor or fragment ion chromatogram
@@ -1067,6 +1220,7 @@ protected:
     bool compute_peak_quality_;
     bool compute_peak_shape_metrics_;
     bool compute_total_mi_;
+    bool resample_once_;
     double min_qual_;
 
     int stop_after_feature_;
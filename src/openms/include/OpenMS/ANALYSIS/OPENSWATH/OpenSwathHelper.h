@@ -125,6 +125,76 @@ public:
                                        double min_upper_edge_dist,
                                        double lower, double upper);
 
+    /**
+      @brief Precursor m/z index of a LightTargetedExperiment
+
+      Holds the transitions sorted by precursor m/z together with integer
+      references from transitions to compounds and from compounds to
+      proteins. Selecting the transitions of a SWATH window (and their
+      compounds and proteins) then becomes a range query without any string
+      comparisons. Compounds (proteins) sharing an id are assigned the same
+      key, which is the index of the first of them.
+
+      The index refers to positions in the experiment it was built from, which
+      must not be modified while the index is in use. It is kept in addition
+      to the experiment (three numbers per transition plus two per compound
+      and one per protein reference) and does not reduce the memory needed
+      for the library itself.
+    */
+    struct OPENMS_DLLAPI TransitionIndex
+    {
+      explicit TransitionIndex(const OpenSwath::LightTargetedExperiment& targeted_exp);
+
+      /// Precursor m/z of the transitions, sorted ascending
+      std::vector<double> precursor_mz;
+      /// Transition index for each entry of precursor_mz
+      std::vector<Size> transition;
+      /// Compound key of each transition (Size(-1) if its compound does not exist)
+      std::vector<Size> transition_compound;
+      /// Key of each compound
+      std::vector<Size> compound_key;
+      /// Key of each protein
+      std::vector<Size> protein_key;
+      /// Protein keys of compound c are compound_proteins[compound_protein_offsets[c]] up to compound_proteins[compound_protein_offsets[c + 1]]
+      std::vector<Size> compound_protein_offsets;
+      /// Protein keys of all compounds
+      std::vector<Size> compound_proteins;
+    };
+
+    /**
+      @brief Select transitions between lower and upper and write them into the new TargetedExperiment
+
+      Version for the LightTargetedExperiment using a precursor m/z index,
+      produces the same result as the version without index.
+
+      @param[in] targeted_exp Transition list for selection
+      @param[in] index Precursor m/z index built from @p targeted_exp
+      @param[out] selected_transitions Selected transitions for SWATH window
+      @param[in] min_upper_edge_dist Distance in Th to the upper edge
+      @param[in] lower Lower edge of SWATH window (in Th)
+      @param[in] upper Upper edge of SWATH window (in Th)
+    */
+    static void selectSwathTransitions(const OpenSwath::LightTargetedExperiment& targeted_exp,
+                                       const TransitionIndex& index,
+                                       OpenSwath::LightTargetedExperiment& selected_transitions,
+                                       double min_upper_edge_dist,
+                                       double lower, double upper);
+
+    /**
+      @brief Copy the given transitions with their compounds and proteins into the new TargetedExperiment
+
+      Transitions, compounds and proteins are added in the order of @p targeted_exp.
+
+      @param[in] targeted_exp Transition list for selection
+      @param[in] index Precursor m/z index built from @p targeted_exp
+      @param[in] transitions Indices of the transitions to select (will be sorted)
+      @param[out] selected_transitions Selected transitions
+    */
+    static void selectTransitions(const OpenSwath::LightTargetedExperiment& targeted_exp,
+                                  const TransitionIndex& index,
+                                  std::vector<Size>& transitions,
+                                  OpenSwath::LightTargetedExperiment& selected_transitions);
+
     /**
       @brief Get the lower / upper offset for this SWATH map and do some sanity checks
 
@@ -41,6 +41,8 @@
 
 #include <OpenMS/KERNEL/FeatureMap.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
 
 namespace OpenMS
@@ -54,6 +56,16 @@ namespace OpenMS
     directly linked to the PQP file format described in the TransitionPQPFile class.
     See also OpenSwathTSVWriter for another output format.
 
+    For multi-threaded use, prepareRecords creates typed rows instead of SQL
+    text. After startAsyncWriting, writeRecords hands these over to a
+    dedicated writer thread (and returns immediately), which inserts them
+    through prepared statements inside large transactions; finishAsyncWriting
+    waits for all rows to be written and reports the write throughput.
+
+    Numeric values are stored at full double precision by both output paths
+    (versions before the typed rows printed them with six significant
+    digits, e.g. retention times and intensities).
+
     The file format has the following tables:
 
       <table>
@@ -122,8 +134,34 @@ namespace OpenMS
     bool sonar_;
     bool enable_uis_scoring_;
 
+    /// Background writer (shared between copies, only set between startAsyncWriting and finishAsyncWriting)
+    struct AsyncWriter_;
+    boost::shared_ptr<AsyncWriter_> async_writer_;
   public:
 
+    /**
+     * @brief Typed rows of all OSW feature tables for one transition group
+     *
+     * Each vector holds the rows of one table in row-major order (FEATURE: 8
+     * values, FEATURE_MS1: 15, FEATURE_PRECURSOR: 4, FEATURE_MS2: 36 and
+     * FEATURE_TRANSITION: 17 values per row), empty values are stored as NULL.
+     *
+     */
+    struct FeatureRecords
+    {
+      std::vector<DataValue> feature;
+      std::vector<DataValue> feature_ms1;
+      std::vector<DataValue> feature_precursor;
+      std::vector<DataValue> feature_ms2;
+      std::vector<DataValue> feature_transition;
+
+      /// Number of features (rows in the FEATURE table)
+      Size nrFeatures() const;
+
+      /// Number of rows in all tables
+      Size nrRows() const;
+    };
+
     OpenSwathOSWWriter(const String& output_filename,
                        const String& input_filename = "inputfile",
                        bool ms1_scores = false,
@@ -172,11 +210,31 @@ namespace OpenMS
      */
     std::vector<String> getSeparateScore(const Feature& feature, std::string score_name) const;
 
+    /**
+     * @brief Prepare the typed rows of a transition group for output
+     *
+     * The result can be written using writeRecords. The rows are identical to
+     * the ones created by prepareLine. Numeric values are kept as doubles and
+     * are stored at full precision.
+     *
+     * @param pep The compound (peptide/metabolite) used for extraction
+     * @param transition The transition used for extraction
+     * @param output The feature map containing all features (each feature will generate one entry in the output)
+     * @param id The transition group identifier (peptide/metabolite id)
+     *
+     * @returns The rows to be written using writeRecords
+     *
+     */
+    FeatureRecords prepareRecords(const OpenSwath::LightCompound& /* pep */,
+        const OpenSwath::LightTransition* /* transition */,
+        FeatureMap& output, String id) const;
+
     /**
      * @brief Prepare a single line (feature) for output
      *
      * The result can be flushed to disk using writeLines (either line by line
-     * or after collecting several lines).
+     * or after collecting several lines). Numeric values are printed at full
+     * double precision (formerly six significant digits).
      *
      * @param pep The compound (peptide/metabolite) used for extraction
      * @param transition The transition used for extraction 
@@ -205,7 +263,48 @@ namespace OpenMS
      */
     void writeLines(const std::vector<String>& to_osw_output);
 
+    /**
+     * @brief Start the background writer thread
+     *
+     * Until finishAsyncWriting is called, writeRecords only queues the rows
+     * for the writer thread. Call after writeHeader.
+     *
+     * @param max_queued_batches Number of batches that may wait for the writer
+     * thread before writeRecords blocks (0 = twice the number of threads)
+     *
+     */
+    void startAsyncWriting(Size max_queued_batches = 0);
+
+    /**
+     * @brief Write typed rows to disk
+     *
+     * If the background writer is running, the rows are handed over to it
+     * and this function may be called concurrently from several threads.
+     * Rows handed over after a copy of this object has called
+     * finishAsyncWriting are written directly (serialized, without throwing).
+     * Otherwise they are written immediately (like writeLines, only call
+     * inside an OpenMP critical section in this case).
+     *
+     * @param records Rows generated by prepareRecords (will be empty afterwards)
+     *
+     */
+    void writeRecords(std::vector<FeatureRecords>& records);
+
+    /**
+     * @brief Wait until all queued rows are written and stop the background writer
+     *
+     * Reports the number of rows written and the write throughput to the log.
+     *
+     * @exception Exception::IllegalArgument is thrown if writing to the database failed
+     *
+     */
+    void finishAsyncWriting();
+
+  private:
+
+    /// Writes the records in a single transaction on a new connection
+    void writeRecordsDirectly_(std::vector<FeatureRecords>& records) const;
+
   };
 
 }
-
@@ -69,6 +69,28 @@ namespace OpenMS
 
   public:
 
+    /** @brief A single peak group for batched DIA / SWATH scoring
+     *
+     * @see calculateDIAScoresBatch
+    */
+    struct DIAScoringTask
+    {
+      /// The feature to be scored
+      OpenSwath::IMRMFeature* imrmfeature;
+      /// The library transitions to score the feature against
+      const std::vector<TransitionType>* transitions;
+      /// The compound corresponding to the library transitions
+      const CompoundType* compound;
+      /// Drift time lower extraction boundary
+      double drift_lower;
+      /// Drift time upper extraction boundary
+      double drift_upper;
+      /// The resulting scores (only the DIA / SWATH scores are set)
+      OpenSwath_Scores scores;
+      /// The resulting m/z and mass error (in ppm) for all transitions
+      std::vector<double> masserror_ppm;
+    };
+
     /// Constructor
     OpenSwathScoring();
 
@@ -188,6 +210,26 @@ namespace OpenMS
                             double drift_lower,
                             double drift_upper);
 
+    /** @brief Score many chromatographic features using DIA / SWATH scores.
+     *
+     * Produces the same scores as calling calculateDIAScores() on each
+     * task, but peak groups are processed in order of their apex retention
+     * time and all peak groups whose apex maps to the same spectrum (and
+     * drift time window) share one added-up spectrum, which is only
+     * retrieved and summed once. This pays off when many peak groups of
+     * different compounds from the same SWATH window are scored together.
+     *
+     * @param tasks The peak groups to be scored, the scores are stored in each task
+     * @param swath_maps The SWATH-MS (DIA) maps from which to retrieve full MS/MS spectra at the chromatographic peak apices
+     * @param ms1_map The corresponding MS1 (precursor ion map) from which the precursor spectra can be retrieved (optional, may be NULL)
+     * @param diascoring DIA Scoring object to use for scoring
+     *
+    */
+    void calculateDIAScoresBatch(std::vector<DIAScoringTask>& tasks,
+                                 const std::vector<OpenSwath::SwathMap>& swath_maps,
+                                 OpenSwath::SpectrumAccessPtr ms1_map,
+                                 OpenMS::DIAScoring& diascoring);
+
     /** @brief Score a single chromatographic feature using the precursor map.
      *
      * The scores are returned in the OpenSwath_Scores object. 
@@ -307,6 +349,45 @@ namespace OpenMS
                                             const double drift_lower,
                                             const double drift_upper);
 
+    /// Returns an averaged spectrum around the spectrum with index @p closest_idx (see getAddedSpectra_, an empty spectrum if the index is negative)
+    OpenSwath::SpectrumPtr getAddedSpectraByIndex_(OpenSwath::SpectrumAccessPtr swath_map,
+                                                   int closest_idx,
+                                                   int nr_spectra_to_add,
+                                                   const double drift_lower,
+                                                   const double drift_upper);
+
+    /// Returns the index of the spectrum closest to @p RT (or -1 if there is none)
+    int getClosestSpectrumIndex_(OpenSwath::SpectrumAccessPtr swath_map, double RT);
+
+    /// Prepares a spectrum for DIA analysis (multiple maps, see fetchSpectrumSwath) given the closest spectrum in each map
+    OpenSwath::SpectrumPtr fetchSpectrumSwath_(const std::vector<OpenSwath::SwathMap>& swath_maps,
+                                               const std::vector<int>& closest_indices,
+                                               int nr_spectra_to_add,
+                                               const double drift_lower,
+                                               const double drift_upper);
+
+    /// Selects the maps that cover the precursor of @p transitions (SONAR), or all maps if there is only one
+    void selectSwathMaps_(const std::vector<OpenSwath::SwathMap>& swath_maps,
+                          const std::vector<TransitionType>& transitions,
+                          std::vector<OpenSwath::SwathMap>& used_swath_maps);
+
+    /// DIA / SWATH scores of a feature given its (added up) spectrum and MS1 spectrum (may be empty)
+    void calculateDIAScores_(OpenSwath::IMRMFeature* imrmfeature,
+                             const std::vector<TransitionType>& transitions,
+                             OpenSwath::SpectrumPtr spectrum,
+                             OpenSwath::SpectrumPtr ms1_spectrum,
+                             OpenMS::DIAScoring& diascoring,
+                             const CompoundType& compound,
+                             OpenSwath_Scores& scores,
+                             std::vector<double>& masserror_ppm);
+
+    /// Precursor scores of a feature given its (added up) MS1 spectrum
+    void calculatePrecursorDIAScores_(OpenSwath::SpectrumPtr ms1_spectrum,
+                                      OpenMS::DIAScoring& diascoring,
+                                      double precursor_mz,
+                                      const CompoundType& compound,
+                                      OpenSwath_Scores& scores);
+
   };
 }
 
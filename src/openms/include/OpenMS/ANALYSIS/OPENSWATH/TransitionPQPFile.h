@@ -221,6 +221,24 @@ private:
     */
     void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
 
+    /** @brief Read PQP SQLite file row by row
+     *
+     * Either appends each row to @p transition_list or, if @p light_exp is
+     * given, converts it directly to the light representation. In the latter
+     * case, only the columns used by LightTargetedExperiment are read and no
+     * TSVTransition objects are kept in memory.
+     *
+     * @param filename The input file
+     * @param transition_list The output list of transitions (or nullptr)
+     * @param light_exp The output light experiment (or nullptr)
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     *
+    */
+    void readPQPInput_(const char* filename,
+                       std::vector<TSVTransition>* transition_list,
+                       OpenSwath::LightTargetedExperiment* light_exp,
+                       bool legacy_traml_id);
+
     /** @brief Write a TargetedExperiment to a file
      *
      * @param filename Name of the output file
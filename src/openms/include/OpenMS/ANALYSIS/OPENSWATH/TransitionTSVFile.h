@@ -43,6 +43,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
 #include <fstream>
+#include <unordered_set>
 
 namespace OpenMS
 {
@@ -220,6 +221,34 @@ protected:
     */
     void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp);
 
+    /** @brief Add a single TSVTransition to a LightTargetedExperiment
+     *
+     * Adds the transition and, unless already present, its compound and
+     * proteins. This allows to convert transitions one by one while they are
+     * read (without keeping all TSVTransition objects in memory).
+     *
+     * @param tr_it The transition to be added
+     * @param exp The output experiment
+     * @param compound_ids Identifiers of the compounds already added to @p exp
+     * @param protein_ids Identifiers of the proteins already added to @p exp
+     *
+    */
+    void addLightTransition_(std::vector<TSVTransition>::const_iterator tr_it, OpenSwath::LightTargetedExperiment& exp,
+                             std::unordered_set<std::string>& compound_ids, std::unordered_set<std::string>& protein_ids);
+
+    /** @brief Resolve cases where the same peptide label group has different sequences.
+     *
+     * Same as resolveMixedSequenceGroups_ for TSVTransition, but operates on
+     * already converted compounds (used after streaming conversion with
+     * addLightTransition_).
+     *
+     * @param first The first compound to be checked
+     * @param last The end of the compounds to be checked
+     *
+     */
+    void resolveMixedSequenceGroups_(std::vector<OpenSwath::LightCompound>::iterator first,
+                                     std::vector<OpenSwath::LightCompound>::iterator last) const;
+
     /// Convert an OpenMS transition to a TSVTransition for output writing
     TransitionTSVFile::TSVTransition convertTransition_(const ReactionMonitoringTransition* it, OpenMS::TargetedExperiment& targeted_exp);
     //@}
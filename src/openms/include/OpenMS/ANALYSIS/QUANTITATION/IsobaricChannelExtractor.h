@@ -39,6 +39,9 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 
+#include <map>
+#include <vector>
+
 namespace OpenMS
 {
   class IsobaricQuantitationMethod;
@@ -62,6 +65,10 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    The reporter ions and the precursor purity of the individual MS/MS spectra are extracted in
+    parallel (if OpenMP is available). For runs which do not fit into memory, see
+    MSDataChannelExtractingConsumer, which extracts the channels while the spectra are read.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -91,7 +98,87 @@ public:
     */
     void extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map);
 
-private:
+protected:
+    /// MSn spectrum to quantify, together with the spectra needed for its precursor purity and position
+    struct ExtractionTask_
+    {
+      /// spectrum containing the reporter ions
+      const MSSpectrum* spectrum;
+      /// MS1 scan preceding @p spectrum (nullptr if there is none)
+      const MSSpectrum* precursor_scan;
+      /// first MS1 scan following @p spectrum (nullptr if there is none)
+      const MSSpectrum* follow_up_scan;
+      /// spectrum whose precursor defines the feature position (the MS2 of an MS3 spectrum, otherwise @p spectrum; nullptr if not found)
+      const MSSpectrum* ms2_spectrum;
+    };
+
+    /// signal found for a single reporter channel
+    struct ChannelSignal_
+    {
+      /// intensity assigned to the channel (after applying the thresholds)
+      Peak2D::IntensityType intensity;
+      /// distance between the expected and the closest observed reporter m/z (if @p found)
+      double mz_delta;
+      /// a non-zero peak was found within the QC window around the reporter
+      bool found;
+      /// more than one peak was found within the reporter mass shift
+      bool not_unique;
+    };
+
+    /// result of an ExtractionTask_
+    struct ExtractionResult_
+    {
+      /// precursor purity (-1 if there is no precursor scan)
+      double precursor_purity;
+      /// false if the spectrum was skipped because of its precursor purity (channels are empty then)
+      bool pure;
+      /// one entry per channel of the quantitation method
+      std::vector<ChannelSignal_> channels;
+    };
+
+    /// small quality control struct, holding temporary data for reporting
+    struct ChannelQC_
+    {
+      ChannelQC_() :
+        mz_deltas(),
+        signal_not_unique(0)
+      {}
+
+      std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
+      int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
+    };
+
+    typedef std::map<String, ChannelQC_> ChannelQCSet_;
+
+    /// Computes the precursor purity and the reporter intensities of @p tasks (in parallel)
+    void extractTasks_(const std::vector<ExtractionTask_>& tasks, std::vector<ExtractionResult_>& results) const;
+
+    /**
+      @brief Creates the consensus features of the extracted @p tasks (in order) and appends them to @p consensus_map.
+
+      @throw Exception::MissingInformation if the MS2 spectrum of an MS3 spectrum or its precursor information is missing
+    */
+    void appendFeatures_(const std::vector<ExtractionTask_>& tasks,
+                         const std::vector<ExtractionResult_>& results,
+                         ConsensusMap& consensus_map,
+                         ChannelQCSet_& channel_qc,
+                         UInt64& element_index) const;
+
+    /**
+      @brief Logs the number of MS/MS spectra per MS level and returns the highest level, which is used for quantification.
+
+      @param ms_level Number of spectra with a valid activation method per MS level
+      @param activation_modes Number of spectra per activation method (logged if no spectrum passes the filter)
+      @return The MS level to quantify, or 0 if there is none
+    */
+    UInt selectQuantMSLevel_(const std::map<UInt, UInt>& ms_level, const std::map<String, int>& activation_modes) const;
+
+    /// Writes the reporter m/z calibration stats to the log
+    void logChannelQC_(ChannelQCSet_& channel_qc) const;
+
+    /// Extracts the reporter ion signals of a single spectrum
+    void extractReporters_(const MSSpectrum& spectrum, std::vector<ChannelSignal_>& channels) const;
+
     /**
       @brief Small struct to capture the current state of the purity computation.
 
@@ -183,22 +270,21 @@ private:
     bool hasLowIntensityReporter_(const ConsensusFeature& cf) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and one to the precursor spectrum.
+      @brief Computes the purity of the precursor of the MS/MS spectrum of @p task, interpolated between the precursor and follow up scan if requested.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param task The MS/MS spectrum and its surrounding MS1 scans (the precursor scan must be set).
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
+    double computePrecursorPurity_(const ExtractionTask_& task) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
+      @brief Computes the purity of the precursor given the MS/MS spectrum and the potential precursor spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS2 spectrum.
+      @param precursor_spec The precursor spectrum of ms2_spec.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
+    double computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
 
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
@@ -222,6 +308,9 @@ protected:
 
     /// implemented for DefaultParamHandler
     void updateMembers_() override;
+
+    /// Number of spectra which are extracted (in parallel) at once
+    static const Size EXTRACTION_BATCH_SIZE = 1000;
   };
 } // namespace
 
@@ -37,6 +37,8 @@
 #include <OpenMS/DATASTRUCTURES/Matrix.h>
 #include <Eigen/Core>
 
+#include <map>
+
 namespace OpenMS
 {
   class IsobaricQuantitationMethod;
@@ -46,6 +48,10 @@ namespace OpenMS
 
   /**
     @brief Performs isotope impurity correction on the intensities extracted from an isobaric labeling experiment.
+
+    The correction matrix is factorized once and the linear systems of blocks of features are solved together.
+    The (slower) non-negative least squares solver is only used for features whose exact solution contains
+    negative intensities.
   */
   class OPENMS_DLLAPI IsobaricIsotopeCorrector
   {
@@ -66,12 +72,12 @@ public:
 
 private:
     /**
-     @brief Fills the input vector for the Eigen/NNLS step given the ConsensusFeature.
+     @brief Fills column @p column of the right-hand sides for the Eigen/NNLS step given the ConsensusFeature.
      */
-    static void fillInputVector_(Eigen::VectorXd& b,
-                                 Matrix<double>& m_b,
+    static void fillInputVector_(Eigen::MatrixXd& b,
+                                 Size column,
                                  const ConsensusFeature& cf,
-                                 const ConsensusMap& cm);
+                                 const std::map<Size, Int>& channel_ids);
 
     /**
      @brief
@@ -83,7 +89,7 @@ private:
      @brief
      */
     static void computeStats_(const Matrix<double>& m_x,
-                              const Eigen::MatrixXd& x,
+                              const Eigen::VectorXd& x,
                               const float cf_intensity,
                               const IsobaricQuantitationMethod* quant_method,
                               IsobaricQuantifierStatistics& stats);
@@ -94,7 +100,8 @@ private:
     static float updateOutpuMap_(const ConsensusMap& consensus_map_in,
                                  ConsensusMap& consensus_map_out,
                                  Size current_cf,
-                                 const Matrix<double>& m_x);
+                                 const Matrix<double>& m_x,
+                                 const std::map<Size, Int>& channel_ids);
   };
 } // namespace
 
@@ -41,6 +41,8 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/ExperimentalDesign.h>
 
+#include <vector>
+
 namespace OpenMS
 {
   /**
@@ -48,6 +50,9 @@ namespace OpenMS
 
       This class is used by @ref TOPP_ProteinQuantifier. See there for further documentation.
 
+      Internally, quantities are aggregated in flat tables: peptides are interned to consecutive indices, feature-level quantities are stored contiguously per peptide and total peptide abundances form a dense peptide x sample matrix.
+      Protein abundances are rolled up in parallel (if OpenMP is enabled). The map-based results (PeptideQuant, ProteinQuant) are only assembled when they are requested.
+
       @htmlinclude OpenMS_PeptideAndProteinQuant.parameters
   */
   class OPENMS_DLLAPI PeptideAndProteinQuant :
@@ -161,7 +166,7 @@ public:
     /**
          @brief Compute peptide abundances.
 
-         Based on quantitative data for individual charge states (in member @p pep_quant_), overall abundances for peptides are computed (and stored again in @p pep_quant_).
+         Based on quantitative data for individual charge states, overall abundances for peptides are computed.
 
          Quantitative data must first be read via readQuantData().
 
@@ -182,10 +187,10 @@ public:
     /// Get summary statistics
     const Statistics& getStatistics();
 
-    /// Get peptide abundance data
+    /// Get peptide abundance data (assembled on the first call after changes)
     const PeptideQuant& getPeptideResults();
 
-    /// Get protein abundance data
+    /// Get protein abundance data (assembled on the first call after changes)
     const ProteinQuant& getProteinResults();
 
     /// Annotate protein quant results as meta data to protein ids
@@ -196,15 +201,107 @@ public:
 
 private:
 
+    /**
+         @brief A feature-level quantity of a peptide, as collected while reading the input.
+
+         Identifications without quantities are recorded with @p sample set to NO_SAMPLE_, so that their charge states show up in the peptide results.
+    */
+    struct Observation_
+    {
+      Size peptide;
+      Int fraction;
+      Int charge;
+      UInt64 sample;
+      double abundance;
+    };
+
+    /// A merged quantity in the flat peptide table (@p column indexes sample_ids_; equal to the number of samples for identifications without quantities)
+    struct Entry_
+    {
+      Int fraction;
+      Int charge;
+      Size column;
+      double abundance;
+    };
+
+    /// Identification data of a peptide
+    struct PeptideInfo_
+    {
+      std::set<String> accessions;
+      Size id_count;
+
+      PeptideInfo_() :
+        id_count(0) {}
+    };
+
+    /// Protein-level roll-up: quantified (unmodified) peptides x samples and the protein abundances
+    struct ProteinRollup_
+    {
+      String accession;
+      Size id_count;
+      std::vector<String> peptides;
+      /// peptides x samples (row-major)
+      std::vector<double> abundances;
+      /// is the corresponding element of @p abundances set?
+      std::vector<char> has_abundance;
+      /// protein abundance per sample
+      std::vector<double> totals;
+      /// is the corresponding element of @p totals set?
+      std::vector<char> has_total;
+
+      ProteinRollup_() :
+        id_count(0) {}
+    };
+
+    /// Sample ID of identifications without quantities
+    static const UInt64 NO_SAMPLE_;
+
     /// Processing statistics for output in the end
     Statistics stats_;
 
-    /// Peptide quantification data
+    /// Peptide quantification data (built from the flat tables on request)
     PeptideQuant pep_quant_;
 
-    /// Protein quantification data
+    /// Protein quantification data (built from the flat tables on request)
     ProteinQuant prot_quant_;
 
+    /// Are @p pep_quant_ and @p prot_quant_ up to date?
+    bool pep_quant_valid_, prot_quant_valid_;
+
+    /// Peptide interning while reading: sequence -> index into @p peptide_info_
+    std::map<AASequence, Size> peptide_index_;
+
+    /// Accessions and ID counts per peptide
+    std::vector<PeptideInfo_> peptide_info_;
+
+    /// Quantities collected while reading (merged into @p entries_ by finalizeQuantData_())
+    std::vector<Observation_> observations_;
+
+    /// Peptide sequences, sorted (i.e. in the order of PeptideQuant)
+    std::vector<AASequence> sequences_;
+
+    /// Unmodified peptide sequences (parallel to @p sequences_, computed on demand)
+    std::vector<String> unmodified_;
+
+    /// Sample IDs (sorted), one column each
+    std::vector<UInt64> sample_ids_;
+
+    /// Entries of peptide i are entries_[entry_offsets_[i]] ... entries_[entry_offsets_[i + 1] - 1], sorted by fraction, charge and sample
+    std::vector<Size> entry_offsets_;
+    std::vector<Entry_> entries_;
+
+    /// Peptides supported by the protein inference results (all, if none were given)
+    std::vector<char> peptide_used_;
+
+    /// Total peptide abundances: peptides x samples (row-major)
+    std::vector<double> peptide_totals_;
+
+    /// Is the corresponding element of @p peptide_totals_ set (i.e. is the peptide quantified in that sample)?
+    std::vector<char> peptide_has_total_;
+
+    /// Protein roll-ups, sorted by accession
+    std::vector<ProteinRollup_> proteins_;
+
 
     /**
          @brief Get the "canonical" annotation (a single peptide hit) of a feature/consensus feature from the associated list of peptide identifications.
@@ -217,7 +314,7 @@ private:
     /**
          @brief Gather quantitative information from a feature.
 
-         Store quantitative information from @p feature in member @p pep_quant_, based on the peptide annotation in @p hit. 
+         Store quantitative information from @p feature as an observation, based on the peptide annotation in @p hit. 
          @p fraction, use 0 for first fraction (or if no fractionation was performed)
          @p sample, use 0 for first sample, 1 for second, ... 
          If @p hit is empty ("ambiguous/no annotation"), nothing is stored.
@@ -227,89 +324,42 @@ private:
       size_t sample, 
       const PeptideHit& hit);
 
+    /// Index of peptide @p seq (a new index is assigned to unknown sequences)
+    Size internPeptide_(const AASequence& seq);
+
     /**
-     *   @brief Determine fraction and charge state of a peptide with the highest
-     *   number of abundances.
-     *   @param peptide_abundances Const input map fraction -> charge -> SampleAbundances
-     *   @param best Will additionally return the best fraction and charge state
-     *   @return true if at least one abundance was found, false otherwise
-     */ 
-    bool getBest_(
-      const std::map<Int, std::map<Int, SampleAbundances>> & peptide_abundances, 
-      std::pair<size_t, size_t> & best)
-    {
-      size_t best_n_quant(0);
-      double best_abundance(0);
-      best = std::make_pair(0,0);
-
-      for (auto & fa : peptide_abundances)  // for all fractions 
-      {
-        for (auto & ca : fa.second) // for all charge states
-        {
-          const Int & fraction = fa.first;
-          const Int & charge = ca.first;
-
-          double current_abundance = std::accumulate(
-              std::begin(ca.second),
-              std::end(ca.second),
-              0.0,
-              [] (int value, const SampleAbundances::value_type& p)
-              { return value + p.second; }
-          ); // loop over abundances
-
-          if (current_abundance <= 0) { continue; }
-
-          const size_t current_n_quant = ca.second.size();
-          if (current_n_quant > best_n_quant)
-          {           
-            best_abundance = current_abundance;
-            best_n_quant = current_n_quant;
-            best = std::make_pair(fraction, charge);
-          }
-          else if (current_n_quant == best_n_quant 
-            && current_abundance > best_abundance)  // resolve tie by abundance
-          {
-            best_abundance = current_abundance;
-            best = std::make_pair(fraction, charge);
-          }
-        }
-      }
-      return best_abundance > 0.;
-    }
+         @brief Build the flat peptide table from the collected observations.
+
+         Peptides are renumbered in sequence order, sample IDs are mapped to columns and observations of the same peptide, fraction, charge and sample are summed up (in the order in which they were read).
+    */
+    void finalizeQuantData_();
+
+    /// Fill @p unmodified_ (if necessary)
+    void computeUnmodifiedSequences_();
 
     /**
-         @brief Order keys (charges/peptides for peptide/protein quantification) according to how many samples they allow to quantify, breaking ties by total abundance.
+         @brief Compute the total abundances of one peptide (a row of @p peptide_totals_).
 
-         The keys of @p abundances are stored ordered in @p result, best first.
+         With @p best_charge_and_fraction, only the fraction and charge state with the highest number of abundances is used (ties are broken by total abundance).
+         Otherwise, abundances are summed over all fractions and charge states.
     */
-    template <typename T>
-    void orderBest_(const std::map<T, SampleAbundances> & abundances,
-                    std::vector<T>& result)
-    {
-      typedef std::pair<Size, double> PairType;
-      std::multimap<PairType, T, std::greater<PairType> > order;
-      for (typename std::map<T, SampleAbundances>::const_iterator ab_it =
-             abundances.begin(); ab_it != abundances.end(); ++ab_it)
-      {
-        double total = 0.0;
-        for (SampleAbundances::const_iterator samp_it = ab_it->second.begin();
-             samp_it != ab_it->second.end(); ++samp_it)
-        {
-          total += samp_it->second;
-        }
-        if (total <= 0.0) continue;         // not quantified
-        PairType key = std::make_pair(ab_it->second.size(), total);
-        order.insert(std::make_pair(key, ab_it->first));
-      }
-      result.clear();
-      for (typename std::multimap<PairType, T, std::greater<PairType> >::
-           iterator ord_it = order.begin(); ord_it != order.end(); ++ord_it)
-      {
-        result.push_back(ord_it->second);
-      }
-    }
+    void quantifyPeptide_(Size peptide, bool best_charge_and_fraction);
 
+    /**
+         @brief Compute the abundances of one protein from its (quantified) peptides.
+
+         @return Number of times the protein is counted as having too few peptides
+    */
+    Size quantifyProtein_(ProteinRollup_& protein, Size top,
+                          const String& average, bool include_all,
+                          bool fix_peptides) const;
 
+    /**
+         @brief Order peptides of a protein according to how many samples they allow to quantify, breaking ties by total abundance.
+
+         Indices of the peptides (rows of @p protein.abundances) are stored ordered in @p result, best first. Peptides without abundances are left out.
+    */
+    void orderBest_(const ProteinRollup_& protein, std::vector<Size>& result) const;
 
     /**
          @brief Normalize peptide abundances across samples by (multiplicative) scaling to equal medians.
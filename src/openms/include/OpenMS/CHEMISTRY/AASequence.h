@@ -621,6 +621,19 @@ protected:
     static AASequence fromString(const char* s,
                                  bool permissive = true);
 
+    /**
+      @brief Clears the process-wide cache of parsed modifications used by fromString()
+
+      The cache holds at most a fixed number of distinct modification tokens
+      (in their sequence context, see parseModification_()); once it is full,
+      further tokens are parsed without being cached. Clearing it frees its
+      memory, e.g. after parsing a file with many distinct mass-tag
+      modifications.
+
+      @note Must not be called while other threads parse sequences.
+    */
+    static void clearModificationCache();
+
   protected:
 
     std::vector<const Residue*> peptide_;
@@ -666,6 +679,57 @@ protected:
                                                          AASequence& aas,
                                                          const ResidueModification::TermSpecificity& specificity);
 
+    /// A modification token in its sequence context (key of the cache used by parseModification_())
+    struct ModificationToken_
+    {
+      std::string token; ///< modification including the brackets
+      const Residue* residue; ///< residue preceding the modification (null at the start of the sequence)
+      char next_aa; ///< following residue (only set where an N-terminal modification is possible)
+      ResidueModification::TermSpecificity specificity; /// specificity as determined by parseString_()
+      bool single_residue; ///< only one residue parsed so far
+      bool at_end; ///< the modification closes the sequence
+
+      bool operator==(const ModificationToken_& rhs) const;
+    };
+
+    /// Hash function for ModificationToken_
+    struct ModificationTokenHash_
+    {
+      std::size_t operator()(const ModificationToken_& t) const;
+    };
+
+    /// The outcome of parsing a modification token (null pointers for the parts that were not changed)
+    struct ParsedModification_
+    {
+      const Residue* residue;
+      const ResidueModification* n_term_mod;
+      const ResidueModification* c_term_mod;
+    };
+
+    /**
+      @brief Parses a modification in round or square brackets, reusing earlier results for the same token
+
+      The outcome of parseModRoundBrackets_() and parseModSquareBrackets_()
+      only depends on the token and its context in the sequence (see
+      ModificationToken_), so it is memoized in a process-wide cache with
+      lock-free lookups. Repeated modifications (e.g. "M(Oxidation)" in
+      millions of PSMs) are then resolved without any database queries.
+      The cache is bounded (see ModificationCache_) and can be emptied with
+      clearModificationCache().
+
+      @return Position at which to continue parsing
+    */
+    static String::ConstIterator parseModification_(const String::ConstIterator str_it,
+                                                    const String& str,
+                                                    AASequence& aas,
+                                                    const ResidueModification::TermSpecificity& specificity);
+
+    /// Cache of parsed modifications used by parseModification_() (defined in the .cpp)
+    struct ModificationCache_;
+
+    /// Returns the process-wide modification cache
+    static ModificationCache_& getModificationCache_();
+
     static void parseString_(const String& peptide, AASequence& aas,
                              bool permissive = true);
   };
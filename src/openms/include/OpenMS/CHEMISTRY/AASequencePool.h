@@ -0,0 +1,102 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+
+#include <memory>
+#include <unordered_map>
+
+namespace OpenMS
+{
+  /**
+      @brief Pool of shared, immutable peptide sequences
+
+      Identification files often contain the same peptide sequence many times
+      (in different PSMs, runs or as decoys of the same targets). The pool
+      parses each distinct sequence string only once and hands out a shared
+      pointer to the resulting AASequence. PeptideHits that are given such a
+      pointer (PeptideHit::setSequence) all refer to the same instance, i.e.
+      the residues of a sequence are stored once, no matter how many hits use
+      it, and copying hits does not copy their sequences.
+
+      The shared sequences stay valid after the pool is cleared or destroyed
+      (as long as they are referenced).
+
+      @note The pool itself is not thread-safe; use one pool per thread or
+      protect it externally.
+
+      @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI AASequencePool
+  {
+public:
+    /// handle to a shared sequence
+    typedef std::shared_ptr<const AASequence> SharedSequence;
+
+    /// Default constructor
+    AASequencePool();
+
+    /// Destructor
+    virtual ~AASequencePool();
+
+    /**
+      @brief Returns the shared sequence for the string representation @p sequence
+
+      The string is parsed with AASequence::fromString() the first time it is
+      seen with the given @p permissive setting. Strings interned permissively
+      are validated again when they are interned with @p permissive = false.
+
+      @throw Exception::ParseError if @p sequence is not a valid sequence (via AASequence::fromString())
+    */
+    const SharedSequence& intern(const String& sequence, bool permissive = true);
+
+    /// Returns the shared instance of @p sequence (keyed by its string representation)
+    const SharedSequence& intern(const AASequence& sequence);
+
+    /// Number of sequences in the pool (a string interned both permissively and strictly counts twice)
+    Size size() const;
+
+    /// Removes all sequences from the pool (handed out sequences remain valid)
+    void clear();
+
+protected:
+    /// distinct sequences by their string representation (as given to intern()), parsed permissively
+    std::unordered_map<String, SharedSequence> sequences_;
+
+    /// distinct sequences by their string representation, parsed with permissive = false
+    std::unordered_map<String, SharedSequence> strict_sequences_;
+  };
+}
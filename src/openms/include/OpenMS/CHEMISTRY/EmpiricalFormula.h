@@ -35,6 +35,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <iterator>
 #include <map>
 #include <set>
 #include <algorithm>
@@ -76,24 +77,80 @@ namespace OpenMS
     are supported in different flavors. However, one must be careful, because this can lead to negative
     frequencies. In most cases this might be misleading, however, the class therefore supports difference
     formulae. E.g. formula differences of reactions from post-translational modifications.
+
+    Internally, the counts of the common elements (CHNOPS and the halogens) are
+    stored in a fixed-size array and only other elements (and specific isotopes)
+    go to a map, so that arithmetic on typical formulas does not allocate. The
+    mono-isotopic and average weights are cached and updated on every change.
+    Elements with a count of zero are not stored.
   */
 
   class OPENMS_DLLAPI EmpiricalFormula
   {
 
 protected:
-	  /// Internal typedef for the used map type
+	  /// Internal typedef for the map type of the elements that are not stored in the dense array
 	  typedef std::map<const Element*, SignedSize> MapType_;
 
 public:
+    /// Number of common elements that are stored in a fixed-size array (Br, C, Cl, F, H, I, N, O, P, S)
+    static const Size NUMBER_OF_DENSE_ELEMENTS = 10;
+
+    /**
+      @brief Forward iterator over the elements (with non-zero count) of a formula
+
+      Dereferencing yields a pair of element pointer and count. The common
+      elements come first (in alphabetical order of their symbols), followed by
+      all other elements. The referenced pair is owned by the iterator.
+    */
+    class OPENMS_DLLAPI ElementIterator
+    {
+public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef std::pair<const Element*, SignedSize> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const value_type* pointer;
+      typedef const value_type& reference;
+
+      /// Default constructor
+      ElementIterator();
+
+      reference operator*() const { return current_; }
+
+      pointer operator->() const { return &current_; }
+
+      /// Prefix increment
+      ElementIterator& operator++();
+
+      /// Postfix increment
+      ElementIterator operator++(int);
+
+      bool operator==(const ElementIterator& rhs) const;
+
+      bool operator!=(const ElementIterator& rhs) const { return !operator==(rhs); }
+
+protected:
+      friend class EmpiricalFormula;
+
+      ElementIterator(const EmpiricalFormula* formula, Size slot, MapType_::const_iterator spill_it);
+
+      /// moves to the next non-zero entry (starting at the current position) and updates current_
+      void settle_();
+
+      const EmpiricalFormula* formula_;
+      Size slot_; ///< position in the dense array, NUMBER_OF_DENSE_ELEMENTS when in the map
+      MapType_::const_iterator spill_it_;
+      value_type current_;
+    };
+
     /** @name Typedefs
     */
     //@{
-    /// Iterators
-    typedef MapType_::const_iterator ConstIterator;
-    typedef MapType_::const_iterator const_iterator;
-    typedef MapType_::iterator Iterator;
-    typedef MapType_::iterator iterator;
+    /// Iterators (formulas cannot be modified through iterators)
+    typedef ElementIterator ConstIterator;
+    typedef ElementIterator const_iterator;
+    typedef ElementIterator Iterator;
+    typedef ElementIterator iterator;
     //@}
 
     /** @name Constructors and Destructors
@@ -105,8 +162,8 @@ public:
     /// Copy constructor
     EmpiricalFormula(const EmpiricalFormula&) = default;
 
-    /// Move constructor
-    EmpiricalFormula(EmpiricalFormula&&) = default;
+    /// Move constructor (leaves @p rhs empty)
+    EmpiricalFormula(EmpiricalFormula&& rhs);
 
     /**
       Constructor from an OpenMS String
@@ -216,8 +273,8 @@ public:
     /// Assignment operator
     EmpiricalFormula& operator=(const EmpiricalFormula&) = default;
 
-    /// Move assignment operator
-    EmpiricalFormula& operator=(EmpiricalFormula&&) & = default;
+    /// Move assignment operator (leaves @p rhs empty)
+    EmpiricalFormula& operator=(EmpiricalFormula&& rhs) &;
 
     /// adds the elements of the given formula
     EmpiricalFormula& operator+=(const EmpiricalFormula& rhs);
@@ -225,6 +282,9 @@ public:
     /// multiplies the elements and charge with a factor
     EmpiricalFormula operator*(const SignedSize& times) const;
 
+    /// multiplies the elements and charge with a factor (in place)
+    EmpiricalFormula& operator*=(const SignedSize& times);
+
     /// adds the elements of the given formula and returns a new formula
     EmpiricalFormula operator+(const EmpiricalFormula& rhs) const;
 
@@ -268,25 +328,52 @@ public:
     /** @name Iterators
     */
     //@{
-    inline ConstIterator begin() const { return formula_.begin(); }
-
-    inline ConstIterator end() const { return formula_.end(); }
-    
-    inline Iterator begin() { return formula_.begin(); }
+    ConstIterator begin() const;
 
-    inline Iterator end() { return formula_.end(); }
+    ConstIterator end() const;
     //@}
 
 protected:
 
-    /// remove elements with count 0
-    void removeZeroedElements_();
+    /// The common elements of the dense array and their weights
+    struct DenseElements_
+    {
+      const Element* elements[NUMBER_OF_DENSE_ELEMENTS];
+      double mono_weights[NUMBER_OF_DENSE_ELEMENTS];
+      double average_weights[NUMBER_OF_DENSE_ELEMENTS];
+    };
+
+    /// Returns the common elements (resolved from the ElementDB on first use)
+    static const DenseElements_& getDenseElements_();
 
-    MapType_ formula_;
+    /// Position of @p element in the dense array (NUMBER_OF_DENSE_ELEMENTS if it is not a common element)
+    static Size getDenseIndex_(const Element* element);
+
+    /// Adds @p number atoms of @p element (without updating the weights)
+    void addElement_(const Element* element, SignedSize number);
+
+    /// Recomputes the cached weights from the element counts
+    void updateWeights_();
+
+    /// Calls @p f(element, count) for all elements in alphabetical order of their symbols
+    template <typename Function>
+    void forEachBySymbol_(Function f) const;
+
+    /// counts of the common elements (see getDenseElements_())
+    SignedSize dense_[NUMBER_OF_DENSE_ELEMENTS];
+
+    /// counts of all other elements (only non-zero counts are stored)
+    MapType_ spill_;
 
     Int charge_;
 
-    Int parseFormula_(std::map<const Element*, SignedSize>& ef, const String& formula) const;
+    /// cached weights of the elements (without the charge)
+    double mono_weight_;
+
+    double average_weight_;
+
+    /// parses @p formula, adds its elements to this formula and returns the charge
+    Int parseFormula_(const String& formula);
 
   };
 
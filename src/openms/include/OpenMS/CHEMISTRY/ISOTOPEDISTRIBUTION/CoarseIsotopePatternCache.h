@@ -0,0 +1,123 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  class Element;
+
+  /**
+    * @ingroup Chemistry
+    * @brief CoarseIsotopePatternGenerator with precomputed element distributions
+    *
+    * CoarseIsotopePatternGenerator::run() computes the distribution of n atoms of an element by
+    * repeated squaring and convolution (see convolvePow_) for every formula. This class precomputes
+    * these convolution powers for a set of elements (by default C, H, N, O, S and P) and all atom counts
+    * up to a maximum count, so a formula only needs one convolution per element. All averagine estimates
+    * (estimateFromPeptideWeight() etc.) use the tables as well, since the averagine formula of a
+    * weight is an integer composition.
+    *
+    * The results are identical to the ones of a CoarseIsotopePatternGenerator with the same settings.
+    * Elements or counts which are not in the tables are computed as in CoarseIsotopePatternGenerator.
+    *
+    * The tables are computed in the constructor and never modified afterwards, so one instance can be
+    * used from several threads at the same time. They depend on the maximal isotope: if setMaxIsotope()
+    * is called with a different value afterwards (or the maximal isotope is 0, i.e. unlimited) the tables
+    * are not used.
+    *
+    * Memory consumption is about (number of elements) * (max_count + 1) * (max_isotope + 1) peaks.
+    **/
+  class OPENMS_DLLAPI CoarseIsotopePatternCache
+    : public CoarseIsotopePatternGenerator
+  {
+
+ public:
+    /**
+      @brief Constructor, precomputes the tables
+
+      @param max_isotope Maximal isotope (see CoarseIsotopePatternGenerator::setMaxIsotope); 0 disables the tables
+      @param round_masses See CoarseIsotopePatternGenerator::setRoundMasses
+      @param max_count Largest number of atoms of an element which is precomputed
+      @param elements Symbols of the elements which are precomputed
+    */
+    CoarseIsotopePatternCache(const Size& max_isotope,
+                              const bool round_masses = false,
+                              const Size max_count = 512,
+                              const std::vector<String>& elements = std::vector<String>{"C", "H", "N", "O", "S", "P"});
+
+    ~CoarseIsotopePatternCache() override;
+
+    using CoarseIsotopePatternGenerator::estimateFromPeptideWeight;
+
+    /// Creates an isotope distribution from an empirical sum formula (same result as CoarseIsotopePatternGenerator::run)
+    IsotopeDistribution run(const EmpiricalFormula& formula) const override;
+
+    /// Creates the isotope distributions of all @p formulas (in parallel)
+    void run(const std::vector<EmpiricalFormula>& formulas, std::vector<IsotopeDistribution>& result) const;
+
+    /// Estimates the peptide isotope distributions of all @p average_weights (in parallel, see estimateFromPeptideWeight)
+    void estimateFromPeptideWeight(const std::vector<double>& average_weights, std::vector<IsotopeDistribution>& result);
+
+    /// Largest number of atoms of an element which is precomputed
+    Size getMaxCount() const;
+
+ protected:
+
+    /// distributions of 0 ... max_count atoms of an element
+    struct ElementTable_
+    {
+      const Element* element;
+      std::vector<IsotopeDistribution::ContainerType> counts;
+    };
+
+    /// computes the table of one element (same convolutions as convolvePow_)
+    void fillTable_(ElementTable_& table) const;
+
+    /// the precomputed distribution of @p count atoms of @p element, or nullptr if not available
+    const IsotopeDistribution::ContainerType* lookup_(const Element* element, SignedSize count) const;
+
+    Size max_count_;
+    /// maximal isotope the tables were computed for
+    Size table_max_isotope_;
+    /// a handful of elements, a linear search is faster than a map
+    std::vector<ElementTable_> tables_;
+  };
+
+} // namespace OpenMS
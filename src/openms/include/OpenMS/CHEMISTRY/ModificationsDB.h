@@ -35,10 +35,12 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/Map.h>
+#include <OpenMS/DATASTRUCTURES/ReadMostlyHashMap.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 
 #include <set>
+#include <unordered_map>
 
 namespace OpenMS
 {
@@ -68,6 +70,14 @@ namespace OpenMS
       In some scenarios, it might be useful to define different modification
       databases. This can be done by providing a path when initializing
       ModificationsDB.
+
+      Name lookups (has(), searchModifications(), getModification()) do not
+      lock and can be used concurrently with each other and with
+      addModification(). The names read in the constructor are stored in a
+      hash map that is never modified once the constructor has finished; every
+      name added afterwards (by addModification() or
+      CrossLinksDB::readFromOBOFile()) goes to a separate insert-only index
+      (see ReadMostlyHashMap) whose entries are copied on write.
   */
   class OPENMS_DLLAPI ModificationsDB
   {
@@ -178,12 +188,33 @@ protected:
     /// Stores the modifications
     std::vector<ResidueModification*> mods_;
 
-    /// Stores the mappings of (unique) names to the modifications
-    Map<String, std::set<const ResidueModification*> > modification_names_;
+    /// Stores the mappings of (unique) names to the modifications read in the constructor (only written while @p names_frozen_ is false)
+    std::unordered_map<String, std::set<const ResidueModification*> > modification_names_;
+
+    /// Mappings of names to the modifications added after construction (lock-free lookup, insertions are serialized)
+    ReadMostlyHashMap<String, std::set<const ResidueModification*> > added_modification_names_;
+
+    /// Set once construction is complete; afterwards @p modification_names_ must not be written anymore
+    bool names_frozen_;
+
+    /**
+      @brief Registers @p mod under @p name
+
+      Writes @p modification_names_ during construction and
+      @p added_modification_names_ (copy-on-write) afterwards.
+      Must be called inside the OpenMS_ModificationsDB critical section.
+    */
+    void addName_(const String& name, const ResidueModification* mod);
+
+    /// Returns all modifications registered under @p name (without locking)
+    std::set<const ResidueModification*> getNamed_(const String& name) const;
 
     /// Helper function to check if a residue matches the origin for a modification
     bool residuesMatch_(const String& residue, const ResidueModification* origin) const;
 
+    /// Looks up the modifications registered under @p name (without locking); returns false if the name is unknown
+    bool findNamed_(const String& name, const std::set<const ResidueModification*>*& initial, const std::set<const ResidueModification*>*& added) const;
+
 private:
 
     /** @name Constructors and Destructors
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/Map.h>
+#include <OpenMS/DATASTRUCTURES/ReadMostlyHashMap.h>
 #include <boost/unordered_map.hpp>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
@@ -56,6 +57,10 @@ namespace OpenMS
       By default no modified residues are stored in an instance. However, if one
       queries the instance with getModifiedResidue, a new modified residue is
       added.
+
+      Lookups of residues by name and of already existing modified residues
+      do not lock and can be used concurrently from many threads; only the
+      creation of a new modified residue is serialized.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -157,7 +162,7 @@ public:
     //@}
 
 protected:
-    /// sets the residues from given file
+    /// sets the residues from given file (rebuilds residue_names_, so it must not be called once lookups may run concurrently)
     void setResidues_(const String& filename);
 
     /** @name Private Constructors
@@ -201,6 +206,7 @@ protected:
 
     void addResidue_(Residue* residue);
 
+    /// residue names (incl. synonyms) of the unmodified residues; only written during construction, read without locking
     boost::unordered_map<String, Residue*> residue_names_;
 
     // fast lookup table for residues
@@ -208,6 +214,9 @@ protected:
 
     Map<String, Map<String, Residue*> > residue_mod_names_;
 
+    /// modified residues by residue name and modification name as queried in getModifiedResidue (lock-free lookup)
+    ReadMostlyHashMap<String, const Residue*> modified_residue_lookup_;
+
     std::set<Residue*> residues_;
 
     std::set<const Residue*> const_residues_;
@@ -37,6 +37,7 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
 
 #include <functional>
 #include <fstream>
@@ -49,6 +50,7 @@ namespace OpenMS
 
   struct TFI_File; ///< template parameter for file-based FASTA access
   struct TFI_Vector; ///< template parameter for vector-based FASTA access
+  struct TFI_Mapped; ///< template parameter for memory-mapped FASTA access
 
   /**
   @brief This class allows for a chunk-wise single linear read over a (large) FASTA file, 
@@ -57,7 +59,7 @@ namespace OpenMS
   
   Internally uses FASTAFile class to read single sequences.
 
-  FASTAContainer supports two template specializations FASTAContainer<TFI_File> and FASTAContainer<TFI_Vector>.
+  FASTAContainer supports three template specializations FASTAContainer<TFI_File>, FASTAContainer<TFI_Mapped> and FASTAContainer<TFI_Vector>.
   
   FASTAContainer<TFI_File> will make FASTA entries available chunk-wise from start to end by loading it from a FASTA file.
   This avoids having to load the full file into memory. While loading, the container will
@@ -67,6 +69,9 @@ namespace OpenMS
   FASTAContainer<TFI_Vector> simply takes an existing vector of FASTAEntries and provides the same interface
   (with a potentially huge speed benefit over FASTAContainer<TFI_File> since it does not need disk access, but at the cost of memory).
 
+  FASTAContainer<TFI_Mapped> maps an (uncompressed) FASTA file into memory and indexes all entries upfront (see MappedFASTAFile).
+  Chunks are parsed from the mapped file by multiple threads, and access to earlier entries is fast as well.
+
   If an algorithm searches through a FASTA file linearly, you can use FASTAContainer<TFI_File> to pre-load a small chunk
   and start working, while loading the next chunk in a background thread and swap it in when the active chunk 
   was processed.
@@ -227,6 +232,140 @@ private:
   size_t chunk_offset_; ///< number of entries before the current chunk
 };
 
+/**
+  @brief FASTAContainer<TFI_Mapped> makes FASTA entries available chunk-wise from start to end, like FASTAContainer<TFI_File>,
+  but reads them from a MappedFASTAFile.
+
+  The file is mapped into memory and the start of every entry is located (in parallel) when constructing the container.
+  Chunks are then parsed from the mapped file (see MappedFASTAFile::getEntries()), and readAt() for entries outside
+  the active chunk is fast, since no disk seek and re-parsing of the stream is required.
+
+  Compressed FASTA files cannot be mapped; use FASTAContainer<TFI_File> for them.
+*/
+template<>
+class FASTAContainer<TFI_Mapped>
+{
+public:
+  FASTAContainer() = delete;
+
+  /// C'tor with FASTA filename
+  FASTAContainer(const String& FASTA_file)
+    : f_(FASTA_file),
+    data_fg_(),
+    data_bg_(),
+    chunk_offset_(0),
+    read_(0)
+  {
+  }
+
+  /// how many entries were read and got swapped out already
+  size_t getChunkOffset() const
+  {
+    return chunk_offset_;
+  }
+
+  /** @brief Swaps in the background cache of entries, read previously via @p cacheChunk()
+      
+      If you call this function without a prior call to @p cacheChunk(), the cache will be empty.
+      @return true if cache contains data; false if empty
+      @note Should be invoked by a single thread, followed by a barrier to sync access of subsequent calls to chunkAt()
+  */
+  bool activateCache()
+  {
+    chunk_offset_ += data_fg_.size();
+    data_fg_.swap(data_bg_);
+    data_bg_.clear(); // just in case someone calls activateCache() multiple times...
+    return !data_fg_.empty();
+  }
+
+  /** @brief Prefetch a new cache in the background, with up to @p suggestedSize entries (or fewer upon reaching EOF)
+
+     Call @p activateCache() afterwards to make the data available via @p chunkAt() or @p readAt().
+     @param suggested_size Number of FASTA entries to parse
+     @return true if new data is available; false if background data is empty
+  */
+  bool cacheChunk(int suggested_size)
+  {
+    f_.getEntries(read_, suggested_size, data_bg_);
+    read_ += data_bg_.size();
+    return !data_bg_.empty();
+  }
+
+  /// number of entries in active cache
+  size_t chunkSize() const
+  {
+    return data_fg_.size();
+  }
+
+  /** @brief Retrieve a FASTA entry at cache position @p pos (fast)
+      
+      Requires prior call to activateCache().
+      Index @p pos must be smaller than chunkSize().
+
+      @note: can be used by multiple threads at a time (until activateCache() is called)
+  */
+  const FASTAFile::FASTAEntry& chunkAt(size_t pos) const
+  {
+    return data_fg_[pos];
+  }
+
+  /** @brief Retrieve a FASTA entry at global position @pos (must not be behind the currently active chunk, but can be smaller)
+
+    Entries outside the active chunk are parsed from the mapped file (no disk seek required).
+    
+    @param protein Return value
+    @param pos Absolute entry number in FASTA file
+    @return true if reading was successful
+    @throw Exception::IndexOverflow if @p pos is beyond active chunk
+  */
+  bool readAt(FASTAFile::FASTAEntry& protein, size_t pos) const
+  {
+    // check if position is currently cached...
+    if (chunk_offset_ <= pos && pos < chunk_offset_ + chunkSize())
+    {
+      protein = data_fg_[pos - chunk_offset_];
+      return true;
+    }
+    if (pos >= read_)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, pos, read_);
+    }
+    f_.getEntry(pos, protein);
+    return true;
+  }
+
+  /// is the FASTA file empty?
+  bool empty() const
+  {
+    return f_.size() == 0;
+  }
+
+  /// resets reading of the FASTA file, enables fresh reading of the FASTA from the beginning
+  void reset()
+  {
+    data_fg_.clear();
+    data_bg_.clear();
+    chunk_offset_ = 0;
+    read_ = 0;
+  }
+
+  /** @brief NOT the number of entries in the FASTA file, but merely the number of already read entries (same as for FASTAContainer<TFI_File>)
+
+      @note Data in the background cache is included here.
+  */
+  size_t size() const
+  {
+    return read_;
+  }
+
+private:
+  MappedFASTAFile f_; ///< memory-mapped and indexed FASTA file
+  std::vector<FASTAFile::FASTAEntry> data_fg_; ///< active (foreground) data
+  std::vector<FASTAFile::FASTAEntry> data_bg_; ///< prefetched (background) data; will become the next active data
+  size_t chunk_offset_; ///< number of entries before the current chunk
+  size_t read_; ///< number of entries parsed so far (active and background cache)
+};
+
 /**
 @brief 
 FASTAContainer<TFI_Vector> simply takes an existing vector of FASTAEntries and provides the same interface
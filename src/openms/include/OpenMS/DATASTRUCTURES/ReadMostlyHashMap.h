@@ -0,0 +1,167 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Insert-only hash map with lock-free lookups
+
+    Lookup table for data that is queried concurrently by many threads but only
+    rarely extended (e.g. the name indices of ResidueDB and ModificationsDB).
+    Entries are immutable once published: insert() prepends a new entry to its
+    bucket, shadowing an older entry with the same key, so a reader never sees
+    a chain change underneath it. Superseded entries stay allocated until the
+    map is cleared or destroyed, i.e. updating the value of a key costs a copy
+    of that value only and no other entry is touched.
+
+    find() may run concurrently with find() and insert(). Calls to insert() have
+    to be serialized by the caller (e.g. in a critical section); clear() must not
+    run concurrently with anything. The number of buckets is fixed at construction.
+
+    @ingroup Datastructures
+  */
+  template <typename Key, typename T, typename Hash = std::hash<Key> >
+  class ReadMostlyHashMap
+  {
+public:
+    /// Constructor
+    explicit ReadMostlyHashMap(Size bucket_count = 1024) :
+      buckets_(bucket_count > 0 ? bucket_count : 1),
+      size_(0)
+    {
+      for (auto& b : buckets_)
+      {
+        b.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    /// Destructor
+    ~ReadMostlyHashMap()
+    {
+      clear();
+    }
+
+    /// Returns the value stored for @p key or a null pointer (lock-free)
+    const T* find(const Key& key) const
+    {
+      for (const Entry_* e = buckets_[bucket_(key)].load(std::memory_order_acquire); e != nullptr; e = e->next)
+      {
+        if (e->key == key) return &e->value;
+      }
+      return nullptr;
+    }
+
+    /// Returns true if @p key is contained (lock-free)
+    bool has(const Key& key) const
+    {
+      return find(key) != nullptr;
+    }
+
+    /// Stores @p value for @p key, replacing the value visible for an existing key. Not reentrant (see class documentation).
+    void insert(const Key& key, const T& value)
+    {
+      std::atomic<const Entry_*>& bucket = buckets_[bucket_(key)];
+      const Entry_* head = bucket.load(std::memory_order_relaxed);
+      bool replaced = false;
+      for (const Entry_* e = head; e != nullptr; e = e->next)
+      {
+        if (e->key == key)
+        {
+          replaced = true;
+          break;
+        }
+      }
+      // the entry is fully constructed before it becomes visible to readers
+      bucket.store(new Entry_(key, value, head), std::memory_order_release);
+      if (!replaced) size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Number of distinct keys
+    Size size() const
+    {
+      return size_.load(std::memory_order_relaxed);
+    }
+
+    /// Removes all entries (must not run concurrently with other calls)
+    void clear()
+    {
+      for (auto& b : buckets_)
+      {
+        const Entry_* e = b.load(std::memory_order_relaxed);
+        while (e != nullptr)
+        {
+          const Entry_* next = e->next;
+          delete e;
+          e = next;
+        }
+        b.store(nullptr, std::memory_order_relaxed);
+      }
+      size_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    /// not copyable (readers may hold pointers into the entries)
+    ReadMostlyHashMap(const ReadMostlyHashMap&) = delete;
+    ReadMostlyHashMap& operator=(const ReadMostlyHashMap&) = delete;
+
+    struct Entry_
+    {
+      Entry_(const Key& k, const T& v, const Entry_* n) :
+        key(k), value(v), next(n)
+      {}
+
+      const Key key;
+      const T value;
+      const Entry_* const next;
+    };
+
+    Size bucket_(const Key& key) const
+    {
+      return hash_(key) % buckets_.size();
+    }
+
+    std::vector<std::atomic<const Entry_*> > buckets_;
+    std::atomic<Size> size_;
+    Hash hash_;
+  };
+
+} // namespace OpenMS
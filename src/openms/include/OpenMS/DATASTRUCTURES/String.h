@@ -505,6 +505,11 @@ public:
     {
     }
 
+    // create view on a character range (e.g. inside a memory-mapped file; not null-terminated)
+    StringView(const char* begin, Size size) : begin_(begin), size_(size)
+    {
+    }
+
     /// less operator
     bool operator<(const StringView other) const
     {
@@ -542,6 +547,12 @@ public:
       return size_;
     }
 
+    /// pointer to the first character of the view (not null-terminated)
+    inline const char* data() const
+    {
+      return begin_;
+    }
+
     /// create String object from view
     inline String getString() const
     {
@@ -36,6 +36,7 @@ MatchedIterator.h
 Matrix.h
 Param.h
 QTCluster.h
+ReadMostlyHashMap.h
 SeqanIncludeWrapper.h
 String.h
 StringUtils.h
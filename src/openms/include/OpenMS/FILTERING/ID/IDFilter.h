@@ -37,6 +37,7 @@
 #include <OpenMS/config.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FILTERING/ID/ProteinAccessionIndex.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
@@ -50,6 +51,7 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace OpenMS
@@ -303,7 +305,7 @@ public:
     struct GetMatchingItems
     {
       typedef HitType argument_type; // for use as a predicate
-      typedef std::map<String, Entry*> ItemMap;//Store pointers to avoid copying data
+      typedef std::unordered_map<String, Entry*> ItemMap;//Store pointers to avoid copying data
       ItemMap items;
 
       GetMatchingItems(std::vector<Entry>& records)
@@ -748,6 +750,52 @@ public:
         ConsensusMap& cmap,
         bool remove_peptides_without_reference = false);
 
+    /**
+       @brief Settings for filterByProteinAccessions
+
+       By default nothing is filtered.
+    */
+    struct AccessionFilter
+    {
+      /// if not empty, only hits matching (one of) these accessions are kept (see keepHitsMatchingProteins)
+      std::set<String> whitelist;
+      /// hits matching (one of) these accessions are removed (see removeHitsMatchingProteins)
+      std::set<String> blacklist;
+      /// remove references to proteins that are not (or no longer) present (see updateProteinReferences)
+      bool update_references = false;
+      /// with @p update_references: remove peptide hits without any remaining protein reference
+      bool remove_peptides_without_reference = false;
+      /// remove protein hits that are not referenced by the (remaining) peptides (see removeUnreferencedProteins)
+      bool remove_unreferenced_proteins = false;
+    };
+
+    /**
+       @brief Protein accession based filtering of peptide and protein hits in one pass
+
+       Combines keepHitsMatchingProteins, removeHitsMatchingProteins, removeUnreferencedProteins and updateProteinReferences
+       (in this order) according to @p filter. All accession checks use the interned ids of @p index, so every peptide
+       evidence is looked up only once, and the peptide IDs are processed in parallel.
+       The index can be reused for further calls; it is kept up to date with the removed protein hits.
+
+       @param peptides Input/output
+       @param proteins Input/output
+       @param index Accession index built from @p proteins
+       @param filter Filters to apply
+
+       @note The ranks of the hits may be invalidated.
+    */
+    static void filterByProteinAccessions(
+      std::vector<PeptideIdentification>& peptides,
+      std::vector<ProteinIdentification>& proteins,
+      ProteinAccessionIndex& index,
+      const AccessionFilter& filter);
+
+    /// As above, but creates the accession index on the fly
+    static void filterByProteinAccessions(
+      std::vector<PeptideIdentification>& peptides,
+      std::vector<ProteinIdentification>& proteins,
+      const AccessionFilter& filter);
+
     /**
        @brief Update protein groups after protein hits were filtered
 
@@ -1308,6 +1356,30 @@ public:
     static void removeDecoys(IdentificationData& id_data);
     ///@}
 
+protected:
+
+    /**
+       @brief Applies the peptide side of the accession filters to a single peptide ID
+
+       @param referenced If not null, flags (per run of @p index) the accessions referenced by the remaining hits
+    */
+    static void filterPeptideIDByAccessions_(
+      PeptideIdentification& peptide,
+      const ProteinAccessionIndex& index,
+      const std::vector<char>& whitelist,
+      const std::vector<char>& blacklist,
+      bool update_references,
+      bool remove_peptides_without_reference,
+      std::vector<std::vector<char> >* referenced);
+
+    /// Applies the protein side of the accession filters and keeps @p index up to date
+    static void filterProteinIDsByAccessions_(
+      std::vector<ProteinIdentification>& proteins,
+      ProteinAccessionIndex& index,
+      const std::vector<char>& whitelist,
+      const std::vector<char>& blacklist,
+      const std::vector<std::vector<char> >* referenced);
+
   };
 
 } // namespace OpenMS
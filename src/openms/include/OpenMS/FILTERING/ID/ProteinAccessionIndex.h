@@ -0,0 +1,126 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Interned protein accessions of a set of protein identification runs.
+
+    Every accession is stored once and mapped to a dense integer id, so filters can work with
+    flat masks over the ids instead of building (and hashing into) new sets of strings.
+    Additionally, the index knows which accessions are present as protein hits in which run
+    (by ProteinIdentification identifier).
+
+    The index is built once from the protein identifications and can be reused for several
+    filter steps (see IDFilter::filterByProteinAccessions). It has to be kept up to date if
+    protein hits are removed elsewhere (see removeFromRun or build).
+
+    Lookups (const member functions) are thread-safe.
+  */
+  class OPENMS_DLLAPI ProteinAccessionIndex
+  {
+public:
+
+    /// Id of accessions or runs that are not in the index
+    static const UInt32 NOT_FOUND;
+
+    /// Constructor (empty index)
+    ProteinAccessionIndex();
+
+    /// Constructor, indexing the accessions of all protein hits in @p proteins
+    explicit ProteinAccessionIndex(const std::vector<ProteinIdentification>& proteins);
+
+    /// (Re-)computes the run membership from @p proteins. Ids of already known accessions are kept.
+    void build(const std::vector<ProteinIdentification>& proteins);
+
+    /// Returns the id of @p accession, adding it to the pool if it is not known yet
+    UInt32 insert(const String& accession);
+
+    /// Returns the id of @p accession or NOT_FOUND
+    UInt32 find(const String& accession) const;
+
+    /// Returns the accession with the given id
+    const String& getAccession(UInt32 id) const;
+
+    /// Number of interned accessions
+    Size size() const;
+
+    /// Number of runs (distinct identifiers of the protein identifications)
+    Size getNrRuns() const;
+
+    /// Returns the index of the run with the given identifier or NOT_FOUND
+    UInt32 findRun(const String& identifier) const;
+
+    /// Is accession @p id a protein hit of run @p run? Unknown ids or runs return false.
+    bool isInRun(UInt32 id, UInt32 run) const
+    {
+      return run < run_members_.size() && id < run_members_[run].size() && run_members_[run][id];
+    }
+
+    /// Marks accession @p id as no longer present in run @p run (e.g. after its protein hit was removed)
+    void removeFromRun(UInt32 id, UInt32 run);
+
+    /**
+      @brief Creates a mask over the accession ids that is set for the given accessions.
+
+      Unknown accessions are added to the pool. Ids added later are outside of the mask and count as not set.
+    */
+    std::vector<char> createMask(const std::set<String>& accessions);
+
+protected:
+
+    /// accession -> id (the keys are the string pool, nodes are stable)
+    std::unordered_map<String, UInt32> ids_;
+
+    /// id -> accession
+    std::vector<const String*> accessions_;
+
+    /// run identifier -> run index
+    std::unordered_map<String, UInt32> runs_;
+
+    /// per run: flags which accession ids have a protein hit in this run
+    std::vector<std::vector<char> > run_members_;
+  };
+
+} // namespace OpenMS
@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <set>
 #include <vector>
 
 namespace OpenMS
@@ -66,6 +67,12 @@ namespace OpenMS
 
     Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
 
+    Alternatively (param: <i>median_method</i> = 'exact'), the exact median of each window is computed.
+    The intensities of the current window are kept in two sorted halves which are updated incrementally while the
+    window slides, i.e. each data point is inserted and removed once (O(n log w) for n data points and w data points per window).
+    This needs neither a maximal intensity nor a bin count and does not suffer from the binning error.
+    For an even number of elements in a window, the lower median is used (as in the histogram case).
+
     @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>OPENMS_LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
     @note If more than 1 percent of median estimations had to rely on the last(=rightmost) bin (which gives an unreliable result), a warning is issued to <i>OPENMS_LOG_WARN</i>.  In this case you should increase <i>max_intensity</i> (and optionally the <i>bin_count</i>). 
     @note You can disable logging this error by setting <i>write_log_messages</i> and read out the values 
@@ -135,6 +142,9 @@ public:
 
       defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
 
+      defaults_.setValue("median_method", "histogram", "'histogram': approximate the median of each window using an intensity histogram (see 'bin_count' and 'max_intensity'); 'exact': compute the exact median of each window incrementally (ignores the histogram parameters)");
+      defaults_.setValidStrings("median_method", ListUtils::create<String>("histogram,exact"));
+
       defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows or median in rightmost histogram bin");
       defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
 
@@ -198,6 +208,12 @@ protected:
       // reset the results
       stn_estimates_.clear();
 
+      if (exact_median_)
+      {
+        computeSTNExact_(scan_first_, scan_last_);
+        return;
+      }
+
       // maximal range of histogram needs to be calculated first
       if (auto_mode_ == AUTOMAXBYSTDEV)
       {
@@ -385,14 +401,7 @@ protected:
       sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
       histogram_oob_percent_ = histogram_oob_percent_ * 100 / window_count;
 
-      // warn if percentage of sparse windows is above 20%
-      if (sparse_window_percent_ > 20 && write_log_messages_)
-      {
-        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
-                 << sparse_window_percent_
-                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
-                 << std::endl;
-      }
+      warnSparseWindows_();
 
       // warn if percentage of possibly wrong median estimates is above 1%
       if (histogram_oob_percent_ > 1 && write_log_messages_)
@@ -406,6 +415,123 @@ protected:
 
     } // end of shiftWindow_
 
+    /** Calculate signal-to-noise values for all data points given, using the exact median of each window
+
+        The window contents are kept in two multisets: @p lower holds the smaller half (including the median),
+        @p upper the larger half. Elements entering or leaving the window are inserted/removed in O(log w).
+
+        @param scan_first_ first element in the scan
+        @param scan_last_ last element in the scan (disregarded)
+    */
+    void computeSTNExact_(const PeakIterator & scan_first_, const PeakIterator & scan_last_)
+    {
+      typedef typename PeakType::IntensityType IntensityType;
+      std::multiset<IntensityType> lower, upper;
+
+      PeakIterator window_pos_center  = scan_first_;
+      PeakIterator window_pos_borderleft = scan_first_;
+      PeakIterator window_pos_borderright = scan_first_;
+
+      double window_half_size = win_len_ / 2;
+      int window_count = 0;
+      double noise;    // noise value of a datapoint
+
+      int windows_overall = (int)std::distance(scan_first_, scan_last_);
+      SignalToNoiseEstimator<Container>::startProgress(0, windows_overall, "noise estimation of data");
+
+      while (window_pos_center != scan_last_)
+      {
+        // erase all elements that will leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() <  (*window_pos_center).getMZ() - window_half_size)
+        {
+          IntensityType intensity = (*window_pos_borderleft).getIntensity();
+          typename std::multiset<IntensityType>::iterator it = lower.find(intensity);
+          if (it != lower.end())
+          {
+            lower.erase(it);
+          }
+          else
+          {
+            upper.erase(upper.find(intensity));
+          }
+          ++window_pos_borderleft;
+        }
+
+        // add all elements that will enter the window on the RIGHT side
+        while ((window_pos_borderright != scan_last_)
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          IntensityType intensity = (*window_pos_borderright).getIntensity();
+          // keep max(lower) <= min(upper); 'lower' may have been emptied by removals on the left
+          bool to_lower = lower.empty() ? (upper.empty() || intensity <= *upper.begin()) : (intensity <= *lower.rbegin());
+          if (to_lower)
+          {
+            lower.insert(intensity);
+          }
+          else
+          {
+            upper.insert(intensity);
+          }
+          ++window_pos_borderright;
+        }
+
+        // rebalance: lower holds ceil[elements_in_window/2] elements, its maximum is the median
+        Size elements_in_window = lower.size() + upper.size();
+        Size element_in_window_half = (elements_in_window + 1) / 2;
+        while (lower.size() > element_in_window_half)
+        {
+          typename std::multiset<IntensityType>::iterator it = --lower.end();
+          upper.insert(*it);
+          lower.erase(it);
+        }
+        while (lower.size() < element_in_window_half)
+        {
+          lower.insert(*upper.begin());
+          upper.erase(upper.begin());
+        }
+
+        if ((int)elements_in_window < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          // just avoid division by 0
+          noise = std::max(1.0, (double)*lower.rbegin());
+        }
+
+        // store result
+        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
+
+        // advance the window center by one datapoint
+        ++window_pos_center;
+        ++window_count;
+        // update progress
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+      }
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      if (window_count > 0)
+      {
+        sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
+      }
+      warnSparseWindows_();
+    }
+
+    /// warn if percentage of sparse windows is above 20%
+    void warnSparseWindows_() const
+    {
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
     /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
     void updateMembers_() override
     {
@@ -418,6 +544,7 @@ protected:
       min_required_elements_   = param_.getValue("min_required_elements");
       noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
       write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      exact_median_            = param_.getValue("median_method").toString() == "exact";
       is_result_valid_         = false;
     }
 
@@ -442,6 +569,9 @@ protected:
     // whether to write out log messages in the case of failure
     bool write_log_messages_;
 
+    /// compute the exact median per window instead of the histogram approximation
+    bool exact_median_;
+
     // counter for sparse windows
     double sparse_window_percent_;
     // counter for histogram overflow
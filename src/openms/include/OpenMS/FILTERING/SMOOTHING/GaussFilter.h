@@ -90,6 +90,38 @@ public:
         @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
       */
     void filter(MSSpectrum & spectrum)
+    {
+      filter_(spectrum, gauss_algo_);
+    }
+
+    void filter(MSChromatogram & chromatogram)
+    {
+      if (param_.getValue("use_ppm_tolerance").toBool())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "GaussFilter: Cannot use ppm tolerance on chromatograms");
+      }
+      filter_(chromatogram, gauss_algo_);
+    }
+
+    /**
+      @brief Smoothes an MSExperiment containing profile data.
+
+      Spectra and chromatograms are filtered in parallel.
+
+      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
+    */
+    void filterExperiment(PeakMap & map);
+
+protected:
+
+    GaussFilterAlgorithm gauss_algo_;
+
+    /// The spacing of the pre-tabulated kernel coefficients
+    double spacing_;
+
+    /// smoothes @p spectrum using @p gauss_algo (which is modified in ppm mode, so use one per thread)
+    void filter_(MSSpectrum & spectrum, GaussFilterAlgorithm & gauss_algo) const
     {
       typedef std::vector<double> ContainerT;
 
@@ -109,7 +141,7 @@ public:
       // apply filter
       ContainerT::iterator mz_out_it = mz_out.begin();
       ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(mz_in.begin(), mz_in.end(), int_in.begin(), mz_out_it, int_out_it);
+      found_signal = gauss_algo.filter(mz_in.begin(), mz_in.end(), int_in.begin(), mz_out_it, int_out_it);
 
       // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
       // This is the case if the Gaussian filter is smaller than the spacing of raw data
@@ -120,6 +152,9 @@ public:
         {
           error_message += String(" The error occurred in the spectrum with retention time ") + spectrum.getRT() + ".";
         }
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_log)
+#endif
         OPENMS_LOG_ERROR << error_message << std::endl;
       }
       else
@@ -135,16 +170,11 @@ public:
       }
     }
 
-    void filter(MSChromatogram & chromatogram)
+    /// smoothes @p chromatogram using @p gauss_algo
+    void filter_(MSChromatogram & chromatogram, GaussFilterAlgorithm & gauss_algo) const
     {
       typedef std::vector<double> ContainerT;
 
-      if (param_.getValue("use_ppm_tolerance").toBool())
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          "GaussFilter: Cannot use ppm tolerance on chromatograms");
-      }
-
       bool found_signal = false;
       const Size data_size = chromatogram.size();
       ContainerT rt_in(data_size), int_in(data_size), rt_out(data_size), int_out(data_size);
@@ -159,7 +189,7 @@ public:
       // apply filter
       ContainerT::iterator mz_out_it = rt_out.begin();
       ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(rt_in.begin(), rt_in.end(), int_in.begin(), mz_out_it, int_out_it);
+      found_signal = gauss_algo.filter(rt_in.begin(), rt_in.end(), int_in.begin(), mz_out_it, int_out_it);
 
       // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
       // This is the case if the Gaussian filter is smaller than the spacing of raw data
@@ -170,6 +200,9 @@ public:
         {
           error_message += String(" The error occurred in the chromatogram with m/z time ") + chromatogram.getMZ() + ".";
         }
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_log)
+#endif
         OPENMS_LOG_ERROR << error_message << std::endl;
       }
       else
@@ -185,35 +218,6 @@ public:
       }
     }
 
-    /**
-      @brief Smoothes an MSExperiment containing profile data.
-
-      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
-    */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
-
-protected:
-
-    GaussFilterAlgorithm gauss_algo_;
-
-    /// The spacing of the pre-tabulated kernel coefficients
-    double spacing_;
-
     // Docu in base class
     void updateMembers_() override;
   };
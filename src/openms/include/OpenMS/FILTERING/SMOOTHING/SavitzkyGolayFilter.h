@@ -111,6 +111,7 @@ public:
 
     // low level template to filters spectra and chromatograms
     // raw data and meta data needs to be copied to the output container before calling this function
+    // (filtering in-place, i.e. d_first == first, is allowed)
     template<class InputIt, class OutputIt>
     void filter(InputIt first, InputIt last, OutputIt d_first)
     {
@@ -118,68 +119,21 @@ public:
 
       if (frame_size_ > n) { return; }
 
-      int i;
-      UInt j;
-      int mid = (frame_size_ / 2);
-      double help;
-
-      // compute the transient on
-      OutputIt out_it = d_first;
-
-      for (i = 0; i <= mid; ++i)
+      // copy the intensities to a contiguous array, so the convolution can be vectorized
+      std::vector<double> intensities(n), smoothed;
+      InputIt it = first;
+      for (size_t i = 0; i < n; ++i, ++it)
       {
-        InputIt it_forward = (first - i);
-        help = 0;
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[(i + 1) * frame_size_ - 1 - j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
+        intensities[i] = it->getIntensity();
       }
 
-      // compute the steady state output
-      InputIt it_help = (last - mid);
-
-      while (first != it_help)
-      {
-        InputIt it_forward = (first - mid);
-        help = 0;
-
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[mid * frame_size_ + j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
-      }
+      convolve_(intensities, smoothed);
 
-      // compute the transient off
-      for (i = (mid - 1); i >= 0; --i)
+      for (size_t i = 0; i < n; ++i, ++first, ++d_first)
       {
-        InputIt it_forward = (first - (frame_size_ - i - 1));
-        help = 0;
-
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[i * frame_size_ + j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
+        d_first->setPosition(first->getPosition());
+        d_first->setIntensity(smoothed[i]);
       }
-
     }
 
     /**
@@ -187,12 +141,8 @@ public:
     */
     void filter(MSSpectrum & spectrum)
     {
-      // copy the data AND META DATA to the output container
-      MSSpectrum output = spectrum;
-      // filter
-      filter(spectrum.begin(), spectrum.end(), output.begin());
-      // swap back
-      std::swap(spectrum, output);
+      // positions and meta data do not change, so we can filter in-place
+      filter(spectrum.begin(), spectrum.end(), spectrum.begin());
     }
 
     /**
@@ -200,33 +150,15 @@ public:
     */
     void filter(MSChromatogram & chromatogram)
     {
-      // copy the data AND META DATA to the output container
-      MSChromatogram output = chromatogram;
-      // filter
-      filter(chromatogram.begin(), chromatogram.end(), output.begin());
-      // swap back
-      std::swap(chromatogram, output);
+      filter(chromatogram.begin(), chromatogram.end(), chromatogram.begin());
     }
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra and chromatograms are filtered in parallel.
     */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & map);
 
 protected:
     /// Coefficients
@@ -238,6 +170,16 @@ protected:
     /// The order of the smoothing polynomial.
     UInt order_;
 
+    /**
+      @brief Convolutes @p in with the filter coefficients and stores the (non-negative) result in @p out
+
+      The first and last frame_size/2 data points use the asymmetric coefficients (transient on/off).
+      The steady state is computed block-wise coefficient by coefficient over contiguous arrays,
+      which allows the compiler to vectorize it without changing the order of summation.
+      @p in must contain at least frame_size elements.
+    */
+    void convolve_(const std::vector<double>& in, std::vector<double>& out) const;
+
     // Docu in base class
     void updateMembers_() override;
   };
@@ -97,7 +97,7 @@ public:
       }
 
       // measure of SIMILARITY (not distance, i.e. 1-distance)!!
-      double operator()(const BaseFeature& first, const BaseFeature& second) const
+      double operator()(const Peak2D& first, const Peak2D& second) const
       {
         // get RT distance:
         double d_rt = fabs(first.getRT() - second.getRT());
@@ -199,95 +199,46 @@ public:
       exp.sortSpectra();
     }
 
-    /// merges spectra with similar precursors (must have MS2 level)
+    /**
+      @brief merges spectra with similar precursors (must have MS2 level)
+
+      Two MS2 spectra are linked if their precursors are within precursor_method:rt_tolerance and
+      precursor_method:mz_tolerance of each other. All spectra which are (transitively) linked are merged
+      (single linkage). Candidate pairs are taken from a m/z-RT grid, i.e. no distance matrix is built and
+      memory consumption is linear in the number of MS2 spectra.
+    */
     template <typename MapType>
     void mergeSpectraPrecursors(MapType& exp)
     {
-
       // convert spectra's precursors to clusterizable data
-      Size data_size;
-      std::vector<BinaryTreeNode> tree;
-      Map<Size, Size> index_mapping;
-      // local scope to save memory - we do not need the clustering stuff later
+      std::vector<Peak2D> data;
+      std::vector<Size> index_mapping; // index in data ==> experiment index
+      for (Size i = 0; i < exp.size(); ++i)
       {
-        std::vector<BaseFeature> data;
-
-        for (Size i = 0; i < exp.size(); ++i)
+        if (exp[i].getMSLevel() != 2)
         {
-          if (exp[i].getMSLevel() != 2)
-          {
-            continue;
-          }
-
-          // remember which index in distance data ==> experiment index
-          index_mapping[data.size()] = i;
-
-          // make cluster element
-          BaseFeature bf;
-          bf.setRT(exp[i].getRT());
-          std::vector<Precursor> pcs = exp[i].getPrecursors();
-          if (pcs.empty())
-          {
-            throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
-          }
-          if (pcs.size() > 1)
-          {
-            OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
-          }
-          bf.setMZ(pcs[0].getMZ());
-          data.push_back(bf);
+          continue;
         }
-        data_size = data.size();
-
-        SpectraDistance_ llc;
-        llc.setParameters(param_.copy("precursor_method:", true));
-        SingleLinkage sl;
-        DistanceMatrix<float> dist; // will be filled
-        ClusterHierarchical ch;
-
-        //ch.setThreshold(0.99);
-        // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
-        ch.cluster<BaseFeature, SpectraDistance_>(data, llc, sl, tree, dist);
+        index_mapping.push_back(i);
+        data.push_back(getPrecursorPosition_(exp[i], i));
       }
 
-      // extract the clusters
-      ClusterAnalyzer ca;
       std::vector<std::vector<Size> > clusters;
-      // count number of real tree nodes (not the -1 ones):
-      Size node_count = 0;
-      for (Size ii = 0; ii < tree.size(); ++ii)
-      {
-        if (tree[ii].distance >= 1)
-        {
-          tree[ii].distance = -1;  // manually set to disconnect, as SingleLinkage does not support it
-        }
-        if (tree[ii].distance != -1)
-        {
-          ++node_count;
-        }
-      }
-      ca.cut(data_size - node_count, tree, clusters);
-
-      //std::cerr << "Treesize: " << (tree.size()+1) << "   #clusters: " << clusters.size() << std::endl;
-      //std::cerr << "tree:\n" << ca.newickTree(tree, true) << "\n";
+      clusterPrecursors_(data, clusters);
 
       // convert to blocks
       MergeBlocks spectra_to_merge;
-
       for (Size i_outer = 0; i_outer < clusters.size(); ++i_outer)
       {
         if (clusters[i_outer].size() <= 1)
         {
           continue;
         }
-        // init block with first cluster element
-        Size cl_index0 = clusters[i_outer][0];
-        spectra_to_merge[index_mapping[cl_index0]] = std::vector<Size>();
-        // add all other elements
+        // init block with first cluster element and add all other elements
+        std::vector<Size>& block = spectra_to_merge[index_mapping[clusters[i_outer][0]]];
         for (Size i_inner = 1; i_inner < clusters[i_outer].size(); ++i_inner)
         {
-          Size cl_index = clusters[i_outer][i_inner];
-          spectra_to_merge[index_mapping[cl_index0]].push_back(index_mapping[cl_index]);
+          block.push_back(index_mapping[clusters[i_outer][i_inner]]);
         }
       }
 
@@ -479,149 +430,185 @@ public:
 
 protected:
 
-    /**
-        @brief merges blocks of spectra of a certain level
-
-        Merges spectra belonging to the same block, setting their MS level to @p ms_level.
-        All old spectra of level @p ms_level are removed, and the new consensus spectra (one per block)
-        are added.
-        All spectra with other MS levels remain untouched.
-        The resulting map is NOT sorted!
+    /// configures @p sas with the m/z binning parameters
+    void setUpAlignment_(SpectrumAlignment& sas) const;
 
-    */
-    template <typename MapType>
-    void mergeSpectra_(MapType& exp, const MergeBlocks& spectra_to_merge, const UInt ms_level)
+    /// returns RT and m/z of the (first) precursor of MS2 spectrum @p spec (with index @p index, for error messages)
+    template <typename SpectrumType>
+    Peak2D getPrecursorPosition_(const SpectrumType& spec, Size index) const
     {
-      double mz_binning_width(param_.getValue("mz_binning_width"));
-      String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
+      const std::vector<Precursor>& pcs = spec.getPrecursors();
+      if (pcs.empty())
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(index) + " does not contain any precursor information! Unable to cluster!");
+      }
+      if (pcs.size() > 1)
+      {
+        OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
+      }
+      Peak2D position;
+      position.setRT(spec.getRT());
+      position.setMZ(pcs[0].getMZ());
+      return position;
+    }
 
-      // merge spectra
-      MapType merged_spectra;
+    /**
+        @brief single linkage clustering of precursor positions
 
-      Map<Size, Size> cluster_sizes;
-      std::set<Size> merged_indices;
+        Two positions are linked if their SpectraDistance_ similarity (using the precursor_method parameters) is
+        larger than zero. Candidate pairs are found via a grid with cells of the size of the RT and m/z tolerances,
+        i.e. only positions in neighbouring cells are compared.
 
-      // set up alignment
-      SpectrumAlignment sas;
-      Param p;
-      p.setValue("tolerance", mz_binning_width);
-      if (!(mz_binning_unit == "Da" || mz_binning_unit == "ppm"))
-      {
-        throw Exception::IllegalSelfOperation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);  // sanity check
-      }
+        @param data Precursor positions
+        @param clusters All clusters (including singletons) as sorted indices into @p data, ordered by their first element
+    */
+    void clusterPrecursors_(const std::vector<Peak2D>& data, std::vector<std::vector<Size> >& clusters) const;
 
-      p.setValue("is_relative_tolerance", mz_binning_unit == "Da" ? "false" : "true");
-      sas.setParameters(p);
+    /**
+        @brief merges one block of spectra
+
+        The consensus spectrum starts as a copy of the master spectrum @p master, the spectra in @p block are added
+        one after another (see mergeSpectra_). Works on any container of spectra with operator[].
+    */
+    template <typename SpectrumContainer, typename SpectrumType>
+    void mergeBlock_(const SpectrumContainer& spectra, Size master, const std::vector<Size>& block, const UInt ms_level,
+                     const SpectrumAlignment& sas, SpectrumType& consensus_spec, Size& count_peaks_aligned, Size& count_peaks_overall) const
+    {
       std::vector<std::pair<Size, Size> > alignment;
 
-      Size count_peaks_aligned(0);
-      Size count_peaks_overall(0);
+      consensus_spec = spectra[master];
+      consensus_spec.setMSLevel(ms_level);
 
-      // each BLOCK
-      for (auto it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
+      double rt_average = consensus_spec.getRT();
+      double precursor_mz_average = 0.0;
+      Size precursor_count(0);
+      if (!consensus_spec.getPrecursors().empty())
       {
-        ++cluster_sizes[it->second.size() + 1]; // for stats
+        precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
+        ++precursor_count;
+      }
 
-        typename MapType::SpectrumType consensus_spec = exp[it->first];
-        consensus_spec.setMSLevel(ms_level);
+      count_peaks_overall += consensus_spec.size();
 
-        //consensus_spec.unify(exp[it->first]); // append meta info
-        merged_indices.insert(it->first);
+      // block elements
+      for (auto sit = block.begin(); sit != block.end(); ++sit)
+      {
+        const SpectrumType& spec_b = spectra[*sit];
+        consensus_spec.unify(spec_b); // append meta info
 
-        //typename MapType::SpectrumType all_peaks = exp[it->first];
-        double rt_average = consensus_spec.getRT();
-        double precursor_mz_average = 0.0;
-        Size precursor_count(0);
-        if (!consensus_spec.getPrecursors().empty())
+        rt_average += spec_b.getRT();
+        if (ms_level >= 2 && spec_b.getPrecursors().size() > 0)
         {
-          precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
+          precursor_mz_average += spec_b.getPrecursors()[0].getMZ();
           ++precursor_count;
         }
 
-        count_peaks_overall += consensus_spec.size();
+        // merge data points
+        sas.getSpectrumAlignment(alignment, consensus_spec, spec_b);
+        count_peaks_aligned += alignment.size();
+        count_peaks_overall += spec_b.size();
 
-        // block elements
-        for (auto sit = it->second.begin(); sit != it->second.end(); ++sit)
-        {
-          consensus_spec.unify(exp[*sit]); // append meta info
-          merged_indices.insert(*sit);
+        Size align_index(0);
+        Size spec_b_index(0);
 
-          rt_average += exp[*sit].getRT();
-          if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
+        // sanity check for number of peaks
+        Size spec_a = consensus_spec.size(), spec_b_size = spec_b.size(), align_size = alignment.size();
+        for (auto pit = spec_b.begin(); pit != spec_b.end(); ++pit)
+        {
+          if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
+            // ... add unaligned peak
           {
-            precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
-            ++precursor_count;
+            consensus_spec.push_back(*pit);
           }
-
-          // merge data points
-          sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
-          //std::cerr << "alignment of " << it->first << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
-          count_peaks_aligned += alignment.size();
-          count_peaks_overall += exp[*sit].size();
-
-          Size align_index(0);
-          Size spec_b_index(0);
-
-          // sanity check for number of peaks
-          Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
-          for (auto pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
+          // or add aligned peak height to ALL corresponding existing peaks
+          else
           {
-            if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
-              // ... add unaligned peak
-            {
-              consensus_spec.push_back(*pit);
-            }
-            // or add aligned peak height to ALL corresponding existing peaks
-            else
-            {
-              Size counter(0);
-              Size copy_of_align_index(align_index);
+            Size counter(0);
+            Size copy_of_align_index(align_index);
 
-              while (alignment.size() > 0 && 
-                     copy_of_align_index < alignment.size() && 
-                     alignment[copy_of_align_index].second == spec_b_index)
-              {
-                ++copy_of_align_index;
-                ++counter;
-              } // Count the number of peaks in a which correspond to a single b peak.
+            while (alignment.size() > 0 &&
+                   copy_of_align_index < alignment.size() &&
+                   alignment[copy_of_align_index].second == spec_b_index)
+            {
+              ++copy_of_align_index;
+              ++counter;
+            } // Count the number of peaks in a which correspond to a single b peak.
 
-              while (alignment.size() > 0 &&
-                     align_index < alignment.size() &&  
-                     alignment[align_index].second == spec_b_index)
+            while (alignment.size() > 0 &&
+                   align_index < alignment.size() &&
+                   alignment[align_index].second == spec_b_index)
+            {
+              consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
+                  (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
+              ++align_index; // this aligned peak was explained, wait for next aligned peak ...
+              if (align_index == alignment.size())
               {
-                consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
-                    (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
-                ++align_index; // this aligned peak was explained, wait for next aligned peak ...
-                if (align_index == alignment.size())
-                {
-                  alignment.clear();  // end reached -> avoid going into this block again
-                }
+                alignment.clear();  // end reached -> avoid going into this block again
               }
-              align_size = align_size + 1 - counter; //Decrease align_size by number of
             }
-            ++spec_b_index;
-          }
-          consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
-          if (spec_a + spec_b - align_size != consensus_spec.size())
-          {
-            OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b - align_size << " got: " << consensus_spec.size() << "\n";
+            align_size = align_size + 1 - counter; //Decrease align_size by number of
           }
+          ++spec_b_index;
         }
-        rt_average /= it->second.size() + 1;
-        consensus_spec.setRT(rt_average);
+        consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
+        if (spec_a + spec_b_size - align_size != consensus_spec.size())
+        {
+          OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b_size - align_size << " got: " << consensus_spec.size() << "\n";
+        }
+      }
+      rt_average /= block.size() + 1;
+      consensus_spec.setRT(rt_average);
 
-        if (ms_level >= 2)
+      if (ms_level >= 2)
+      {
+        if (precursor_count)
         {
-          if (precursor_count)
-          {
-            precursor_mz_average /= precursor_count;
-          }
-          std::vector<Precursor> pcs = consensus_spec.getPrecursors();
-          //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
-          pcs.resize(1);
-          pcs[0].setMZ(precursor_mz_average);
-          consensus_spec.setPrecursors(pcs);
+          precursor_mz_average /= precursor_count;
         }
+        std::vector<Precursor> pcs = consensus_spec.getPrecursors();
+        //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
+        pcs.resize(1);
+        pcs[0].setMZ(precursor_mz_average);
+        consensus_spec.setPrecursors(pcs);
+      }
+    }
+
+    /**
+        @brief merges blocks of spectra of a certain level
+
+        Merges spectra belonging to the same block, setting their MS level to @p ms_level.
+        All old spectra of level @p ms_level are removed, and the new consensus spectra (one per block)
+        are added.
+        All spectra with other MS levels remain untouched.
+        The resulting map is NOT sorted!
+
+    */
+    template <typename MapType>
+    void mergeSpectra_(MapType& exp, const MergeBlocks& spectra_to_merge, const UInt ms_level)
+    {
+      // merge spectra
+      MapType merged_spectra;
+
+      Map<Size, Size> cluster_sizes;
+      std::set<Size> merged_indices;
+
+      // set up alignment
+      SpectrumAlignment sas;
+      setUpAlignment_(sas);
+
+      Size count_peaks_aligned(0);
+      Size count_peaks_overall(0);
+
+      // each BLOCK
+      for (auto it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
+      {
+        ++cluster_sizes[it->second.size() + 1]; // for stats
+
+        merged_indices.insert(it->first);
+        merged_indices.insert(it->second.begin(), it->second.end());
+
+        typename MapType::SpectrumType consensus_spec;
+        mergeBlock_(exp, it->first, it->second, ms_level, sas, consensus_spec, count_peaks_aligned, count_peaks_overall);
 
         if (consensus_spec.empty())
         {
@@ -36,7 +36,7 @@
 
 #include <xercesc/util/BinInputStream.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
-#include <OpenMS/FORMAT/Bzip2Ifstream.h>
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
 
 
 namespace OpenMS
@@ -45,6 +45,8 @@ namespace OpenMS
   /**
     * @brief Implements the BinInputStream class of the xerces-c library in order to read bzip2 compressed XML files.
     *
+    * Decompression runs on a read-ahead thread (see ReadAheadDecompressor), so it overlaps with parsing.
+    *
   */
   class OPENMS_DLLAPI Bzip2InputStream :
     public xercesc::BinInputStream
@@ -96,7 +98,7 @@ public:
 
 private:
     ///pointer to an compression stream
-    Bzip2Ifstream* bzip2_;
+    ReadAheadDecompressor* bzip2_;
     ///current index of the actual file
     XMLSize_t       file_current_index_;
 
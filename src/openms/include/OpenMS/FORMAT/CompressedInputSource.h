@@ -56,6 +56,8 @@ public:
 
     /**
        @brief Depending on the header in the Constructor a Bzip2InputStream or a GzipInputStream object is returned
+
+       Both streams decompress on a background thread (see ReadAheadDecompressor).
        @note InputSource interface implementation
     */
     xercesc::BinInputStream * makeStream() const override;
@@ -0,0 +1,171 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/ANALYSIS/QUANTITATION/IsobaricChannelExtractor.h>
+
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/KERNEL/RangeUtils.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Consumer of MS data which extracts isobaric reporter ion channels on the fly (see IsobaricChannelExtractor)
+
+      Streaming variant of IsobaricChannelExtractor::extractChannels, using the same parameters and producing
+      the same consensus map. Only the spectra which are still needed are kept in memory:
+
+      - the current MS1 scan and the MS1 scans that serve as precursor or follow up scan of spectra which
+        were not extracted yet (with @p purity_interpolation, a spectrum is extracted once the next MS1 scan arrives)
+      - the last MS2 spectra (without peaks unless they are quantified), to find the MS2 spectrum of an MS3 spectrum
+      - batches of spectra waiting for their extraction, which is done in parallel
+
+      Since the MS level used for quantification (the highest MS level which passes the activation filter) is not known
+      in advance, the results of a lower MS level are discarded as soon as a spectrum of a higher level is consumed.
+
+      The spectra must be consumed in order of increasing RT and are moved into the consumer. Chromatograms are ignored.
+      Call finish() to extract the remaining spectra and to obtain the result.
+
+      @note Only the last MS2 spectra are searched for the precursor spectrum of an MS3 spectrum (see
+      MSExperiment::getPrecursorSpectrum), which is sufficient for all common acquisition schemes.
+    */
+    class OPENMS_DLLAPI MSDataChannelExtractingConsumer :
+      public IsobaricChannelExtractor,
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param quant_method The quantitation method providing the channels to extract (not owned)
+      */
+      explicit MSDataChannelExtractingConsumer(const IsobaricQuantitationMethod* const quant_method);
+
+      ~MSDataChannelExtractingConsumer() override;
+
+      /// Ignored
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// Ignored
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      /**
+        @brief Takes over the spectrum and extracts all spectra whose surrounding MS1 scans are known
+
+        @throw Exception::InvalidParameter if the spectrum has a smaller RT than the previous one
+        @throw Exception::MissingInformation if the MS2 spectrum of an MS3 spectrum or its precursor information is missing
+      */
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Ignored
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Extracts the remaining spectra and stores the result in @p consensus_map
+
+        The consumer is reset afterwards and can be used for the next run.
+
+        @throw Exception::MissingInformation if no spectrum was consumed
+      */
+      void finish(ConsensusMap& consensus_map);
+
+    protected:
+
+      typedef std::shared_ptr<const MSSpectrum> SpectrumPtr_;
+
+      /// an ExtractionTask_ which keeps its spectra alive
+      struct PendingSpectrum_
+      {
+        SpectrumPtr_ spectrum;
+        SpectrumPtr_ precursor_scan;
+        SpectrumPtr_ follow_up_scan;
+        SpectrumPtr_ ms2_spectrum;
+      };
+
+      void updateMembers_() override;
+
+      /// discards the results of the current quantification level and continues with level @p ms_level
+      void setQuantMSLevel_(UInt ms_level);
+
+      /// returns the MS2 spectrum of MS3 spectrum @p s (see MSExperiment::getPrecursorSpectrum) or a null pointer
+      SpectrumPtr_ findMS2Spectrum_(const MSSpectrum& s) const;
+
+      /// extracts the ready spectra
+      void extractReady_();
+
+      /// resets the consumer
+      void clear_();
+
+      /// Number of last MS2 spectra searched for the precursor spectrum of an MS3 spectrum
+      static const Size MS2_BUFFER_SIZE = 100;
+
+      HasActivationMethod<MSSpectrum> is_valid_activation_;
+
+      /// number of spectra per activation mode and number of spectra with a valid activation per MS level
+      std::map<String, int> activation_modes_;
+      std::map<UInt, UInt> ms_level_;
+      /// highest MS level with a valid activation seen so far (0 if none)
+      UInt quant_ms_level_;
+
+      SpectrumPtr_ current_ms1_;
+      std::deque<SpectrumPtr_> last_ms2_;
+
+      /// spectra which wait for the next MS1 scan (purity interpolation), sorted by RT
+      std::vector<PendingSpectrum_> waiting_;
+      /// spectra which can be extracted, sorted by RT
+      std::vector<PendingSpectrum_> ready_;
+
+      /// extracted features of quant_ms_level_
+      ConsensusMap features_;
+      ChannelQCSet_ channel_qc_;
+      UInt64 element_index_;
+
+      double last_rt_;
+      Size nr_consumed_;
+    };
+
+} //end namespace OpenMS
@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Transforming consumer of MS data which processes batches of spectra/chromatograms in parallel
+
+      Collects up to batch_size spectra (or chromatograms), applies the user-provided function to all of
+      them in parallel (using OpenMP) and then passes them on to the next consumer in their original order.
+      At most one batch is held in memory, so memory consumption is bounded independent of the input size.
+      The buffers of the batch are re-used for the next batch.
+
+      The processing functions are called concurrently from several threads and therefore must be thread-safe.
+      Besides the spectrum/chromatogram, they get a scratch object which belongs to the calling thread and keeps
+      its capacity between calls (e.g. to be used as output buffer which is then swapped with the input).
+
+      Spectra and chromatograms are forwarded in the order they were consumed (pending spectra are flushed
+      before the first chromatogram is passed on and vice versa).
+
+      @note This does not transfer ownership of the next consumer. Call flush() before the next consumer
+      is finalized, otherwise the last batch is lost.
+    */
+    class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      typedef std::function<void (SpectrumType& s, SpectrumType& scratch)> SpectrumFunction;
+      typedef std::function<void (ChromatogramType& c, ChromatogramType& scratch)> ChromatogramFunction;
+
+      /**
+        @brief Constructor
+
+        @param next_consumer The consumer which receives the processed data
+        @param batch_size Number of spectra (or chromatograms) which are processed together
+
+        @note This does not transfer ownership of the consumer
+      */
+      MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 1000);
+
+      /**
+        @brief Destructor
+
+        Flushes remaining data to the next consumer. Errors raised while doing so are only logged,
+        call flush() explicitly to handle them.
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataParallelTransformingConsumer() override;
+
+      /// forwarded to the next consumer
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// forwarded to the next consumer
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      /// Copies the spectrum into the current batch (processes the batch if it is full)
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Copies the chromatogram into the current batch (processes the batch if it is full)
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /// Sets the (thread-safe) function applied to every spectrum. Pass a nullptr to leave spectra unchanged.
+      void setSpectraProcessingFunc(SpectrumFunction f_spec);
+
+      /// Sets the (thread-safe) function applied to every chromatogram. Pass a nullptr to leave chromatograms unchanged.
+      void setChromatogramProcessingFunc(ChromatogramFunction f_chrom);
+
+      /// Processes all pending spectra and chromatograms and passes them on to the next consumer
+      void flush();
+
+    protected:
+
+      /// processes the pending spectra and forwards them to the next consumer
+      void processSpectra_();
+      /// processes the pending chromatograms and forwards them to the next consumer
+      void processChromatograms_();
+
+      /// applies @p func to the first @p size elements of @p batch in parallel
+      template <typename DataType, typename FunctionType>
+      void processBatch_(std::vector<DataType>& batch, Size size, std::vector<DataType>& scratch, const FunctionType& func);
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      Size batch_size_;
+
+      SpectrumFunction spectrum_func_;
+      ChromatogramFunction chromatogram_func_;
+
+      /// the spectra of the current batch (only the first nr_spectra_ are valid; the others keep their buffers for re-use)
+      std::vector<SpectrumType> spectra_;
+      Size nr_spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+      Size nr_chromatograms_;
+
+      /// one scratch object per thread
+      std::vector<SpectrumType> spectrum_scratch_;
+      std::vector<ChromatogramType> chromatogram_scratch_;
+    };
+
+} //end namespace OpenMS
+
@@ -0,0 +1,174 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <map>
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Consumer of MS data which merges spectra on the fly (see SpectraMerger)
+
+      Streaming variant of SpectraMerger::mergeSpectraBlockWise ("block_method") and
+      SpectraMerger::mergeSpectraPrecursors ("precursor_method"), using the same parameters.
+      Only the spectra of an RT window are kept in memory, so arbitrarily large runs can be merged
+      in bounded memory:
+
+      - block_method: one open block per MS level, which is merged as soon as the next block starts.
+      - precursor_method: MS2 spectra are kept until no later spectrum can be linked to their cluster anymore,
+        i.e. until the RT of the incoming spectra exceeds the last RT of the cluster by more than
+        precursor_method:rt_tolerance. Clusters are formed via the same m/z-RT grid as in
+        SpectraMerger::mergeSpectraPrecursors.
+
+      Merged spectra and spectra which are passed on unchanged are forwarded to the next consumer sorted by RT,
+      as soon as no spectrum with an earlier RT can be produced anymore. The result is the same as loading the
+      whole map and calling the corresponding SpectraMerger function, except that blocks (or clusters) which
+      contain only a single spectrum are always passed on unchanged.
+
+      The spectra must be consumed in order of increasing RT. Chromatograms are passed on unchanged (all
+      pending spectra are forwarded before the first chromatogram).
+
+      @note This does not transfer ownership of the next consumer. Call flush() before the next consumer
+      is finalized, otherwise the last spectra are lost.
+    */
+    class OPENMS_DLLAPI MSDataSpectraMergingConsumer :
+      public SpectraMerger,
+      public Interfaces::IMSDataConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer The consumer which receives the merged data
+        @param merging_method Either "block_method" or "precursor_method"
+
+        @throw Exception::IllegalArgument if @p merging_method is not supported
+
+        @note This does not transfer ownership of the consumer
+      */
+      MSDataSpectraMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const String& merging_method);
+
+      /**
+        @brief Destructor
+
+        Flushes remaining data to the next consumer. Errors raised while doing so are only logged,
+        call flush() explicitly to handle them.
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataSpectraMergingConsumer() override;
+
+      /// forwarded to the next consumer (the number of spectra is an upper bound after merging)
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// forwarded to the next consumer
+      void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+      /**
+        @brief Adds the spectrum to the current RT window and forwards all spectra which are final
+
+        @throw Exception::IllegalArgument if the spectrum has a smaller RT than the previous one
+        @throw Exception::MissingInformation if an MS2 spectrum has no precursor (precursor_method)
+      */
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Forwards all pending spectra and passes the chromatogram on
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /// Merges and forwards all pending spectra
+      void flush();
+
+    protected:
+
+      void updateMembers_() override;
+
+      /// merges (or passes on) the open block of the MS level with index @p level_index in ms_levels_
+      void closeBlock_(Size level_index);
+
+      /// clusters the MS2 window and finishes all clusters whose last spectrum has an RT below @p rt_limit
+      void closeClusters_(double rt_limit);
+
+      /// merges the spectra @p members of @p spectra (or passes on a single spectrum) into the pending spectra
+      void finishCluster_(std::vector<SpectrumType>& spectra, const std::vector<Size>& members, UInt ms_level);
+
+      /// forwards the pending spectra with an RT below @p rt_limit
+      void writeSpectra_(double rt_limit);
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      bool precursor_method_;
+
+      /// block_method parameters
+      IntList ms_levels_;
+      Int rt_block_size_;
+      double rt_max_length_;
+      /// precursor_method:rt_tolerance
+      double rt_tolerance_;
+
+      /// open block per entry of ms_levels_ (block_method)
+      std::vector<std::vector<SpectrumType> > blocks_;
+      std::vector<Int> block_size_count_;
+
+      /// MS2 spectra (sorted by RT) which are not part of a finished cluster yet and their precursor positions (precursor_method)
+      std::vector<SpectrumType> window_;
+      std::vector<Peak2D> window_positions_;
+      double last_clustering_rt_;
+
+      /// merged and unchanged spectra which wait for being forwarded, by RT (stable for equal RT)
+      std::multimap<double, SpectrumType> pending_;
+
+      double last_rt_;
+      Size nr_consumed_;
+
+      SpectrumAlignment sas_;
+
+      /// statistics (logged by flush())
+      Map<Size, Size> cluster_sizes_;
+      Size count_peaks_aligned_;
+      Size count_peaks_overall_;
+    };
+
+} //end namespace OpenMS
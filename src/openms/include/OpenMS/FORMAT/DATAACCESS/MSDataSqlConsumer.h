@@ -69,7 +69,10 @@ namespace OpenMS
       /**
         @brief Constructor
 
-        Opens the SQLite file and writes the tables.
+        Opens the SQLite file and writes the tables. Buffered data is
+        compressed and written in the background (see
+        MzMLSqliteHandler::startPipelinedWriting), the file is complete once
+        the consumer is destroyed.
 
         @param filename The filename of the SQLite database
         @param buffer_size How large the internal buffer size should be (defaults to 500 spectra / chromatograms)
@@ -7,6 +7,9 @@ set(sources_list_h
   MSDataAggregatingConsumer.h
   MSDataCachedConsumer.h
   MSDataChainingConsumer.h
+  MSDataChannelExtractingConsumer.h
+  MSDataParallelTransformingConsumer.h
+  MSDataSpectraMergingConsumer.h
   MSDataStoringConsumer.h
   MSDataSqlConsumer.h
   MSDataTransformingConsumer.h
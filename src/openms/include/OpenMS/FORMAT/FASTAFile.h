@@ -59,6 +59,9 @@ namespace OpenMS
     Reading from one and writing to another FASTA file can be handled by 
     one single FASTAFile instance.
 
+    gzip and bzip2 compressed files (e.g. *.fasta.gz) are read transparently;
+    they are decompressed by a ReadAheadDecompressor on a background thread.
+
   */
 
   class OPENMS_DLLAPI FASTAFile
@@ -214,6 +217,9 @@ public:
     void static store(const String& filename, const std::vector<FASTAEntry>& data);
 
 protected:
+    class DecompressionBuffer_;
+
+    std::unique_ptr<DecompressionBuffer_> decompression_buffer_; ///< stream buffer of infile_ for compressed files; init using FastaFile::readStart()
     std::fstream infile_;   ///< filestream for reading; init using FastaFile::readStart()
     std::ofstream outfile_; ///< filestream for writing; init using FastaFile::writeStart()
     std::unique_ptr<void, std::function<void(void*) > > reader_; ///< filestream for reading; init using FastaFile::readStart(); needs to be a pointer, since its not copy-constructable; we use void* here, to avoid pulling in seqan includes
@@ -35,7 +35,7 @@
 #pragma once
 
 #include <OpenMS/config.h>
-#include <OpenMS/FORMAT/GzipIfstream.h>
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
 
 #include <xercesc/util/BinInputStream.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
@@ -46,6 +46,8 @@ namespace OpenMS
 
   /**
     * @brief Implements the BinInputStream class of the xerces-c library in order to read gzip compressed XML files.
+    *
+    * Decompression runs on a read-ahead thread (see ReadAheadDecompressor), so it overlaps with parsing.
     * 
   */
   class OPENMS_DLLAPI GzipInputStream :
@@ -98,7 +100,7 @@ public:
 
 private:
     ///pointer to an compression stream
-    GzipIfstream* gzip_;
+    ReadAheadDecompressor* gzip_;
     ///current index of the actual file
     XMLSize_t file_current_index_;
 
@@ -39,6 +39,8 @@
 
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
+#include <boost/shared_ptr.hpp>
+
 // forward declarations
 struct sqlite3;
 struct sqlite3_stmt;
@@ -68,7 +70,9 @@ namespace OpenMS
         back).
 
         This class also supports writing data using the lossy numpress
-        compression format.
+        compression format. For large outputs, startPipelinedWriting moves
+        the compression onto worker threads and the inserts onto a separate
+        writer thread, so writing overlaps with data generation.
 
         This class contains the internal data structures and SQL statements for
         communication with the SQLite database
@@ -94,6 +98,12 @@ public:
        */
       //@{
 
+      /// Returns the name of the underlying sqMass file
+      const String& getFilename() const
+      {
+        return filename_;
+      }
+
       /**
           @brief Read an experiment into an MSExperiment structure
 
@@ -160,6 +170,18 @@ public:
       */
       std::vector<size_t> getSpectraIndicesbyRT(double RT, double deltaRT, const std::vector<int> & indices) const;
 
+      /**
+          @brief Decode a binary data array as stored in the DATA table
+
+          @param blob The raw binary data
+          @param blob_bytes Size of the raw binary data (in bytes)
+          @param compression Compression type as stored in the DATA table
+          @param data The decoded values
+
+          @throw Exception::IllegalArgument if the compression type is not supported
+      */
+      static void decodeBinaryData(const void* blob, Size blob_bytes, int compression, std::vector<double>& data);
+
 protected:
 
       void populateChromatogramsWithData_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms) const;
@@ -217,6 +239,40 @@ public:
       */
       void writeChromatograms(const std::vector<MSChromatogram>& chroms);
 
+      /**
+          @brief Start pipelined writing of spectra and chromatograms
+
+          Until finishPipelinedWriting is called, writeSpectra and
+          writeChromatograms only prepare the meta data and queue the data
+          arrays (in chunks of half the SQL batch size). The arrays are
+          compressed on @p nr_workers worker threads while a single writer
+          thread inserts them into the file inside large transactions.
+          Calls block while more than @p max_inflight_bytes of raw or
+          compressed data are waiting to be written. Once compressing or
+          writing has failed, writeSpectra and writeChromatograms rethrow
+          the error (and so does finishPipelinedWriting).
+
+          @note No other connection may write to the file until
+                finishPipelinedWriting has returned (e.g. call
+                writeRunLevelInformation afterwards).
+
+          @param nr_workers Number of compression threads (0 uses the number of OpenMP threads)
+          @param max_inflight_bytes Memory limit for queued data (in bytes)
+
+          @throw Exception::IllegalArgument if pipelined writing was already started
+      */
+      void startPipelinedWriting(Size nr_workers = 0, Size max_inflight_bytes = 512 * 1024 * 1024);
+
+      /**
+          @brief Wait until all queued data is written and stop the worker threads
+
+          Does nothing if pipelined writing was not started.
+
+          @throw Exception::IllegalArgument (or any other exception raised
+                 while compressing or writing) if writing failed
+      */
+      void finishPipelinedWriting();
+
       /**
           @brief Write the run-level information for an experiment into tables
 
@@ -250,6 +306,10 @@ protected:
       double linear_abs_mass_acc_; 
       double write_full_meta_; 
       int sql_batch_size_; 
+
+      /// Compression workers and writer thread (only set between startPipelinedWriting and finishPipelinedWriting)
+      struct PipelinedWriter_;
+      boost::shared_ptr<PipelinedWriter_> pipeline_;
     };
 
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/FORMAT/HANDLERS/XMLHandler.h>
@@ -174,6 +175,8 @@ protected:
     std::vector<PeptideEvidence> peptide_evidences_;
     /// Map from protein id to accession
     std::unordered_map<std::string, String> proteinid_to_accession_;
+    /// Sequences of the peptide hits (parsed once, shared by all hits with the same sequence)
+    AASequencePool sequence_pool_;
     /// Document identifier
     String* document_id_;
     /// true if a prot id is contained in the current run
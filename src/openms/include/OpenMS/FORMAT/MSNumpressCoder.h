@@ -215,6 +215,25 @@ public:
     */
     void decodeNPRaw(const std::string & in, std::vector<double> & out, const NumpressConfig & config);
 
+    /**
+     * @brief Decode a raw byte array into the result vector out (unsafe)
+     *
+     * Same as above, but reads directly from a buffer (e.g. the output of
+     * zlib decompression) without copying it into a string first. The
+     * number of values is determined before decoding, so @p out is resized
+     * exactly once and its memory is reused: decoding many arrays into the
+     * same vector neither reallocates nor re-initializes it.
+     *
+     * @param in Pointer to the raw numpress data
+     * @param in_size Number of bytes in @p in
+     * @param out The resulting vector of doubles
+     * @param config The numpress configuration defining the compression strategy
+     *
+     * @throw throws Exception::ConversionError if the data cannot be converted
+     *
+    */
+    void decodeNPRaw(const unsigned char* in, size_t in_size, std::vector<double> & out, const NumpressConfig & config);
+
 private:
 
     void decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config);
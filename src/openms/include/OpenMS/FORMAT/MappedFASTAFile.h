@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Random access to the entries of a (large) FASTA file which is mapped into memory
+
+    Instead of reading the file line by line (as FASTAFile does), the whole
+    file is mapped into the address space of the process. When opening the file,
+    the start of each record (a '>' at the beginning of a line) is located by
+    several threads scanning separate parts of the file. Afterwards, every entry can be
+    accessed in constant time and from multiple threads at once.
+
+    Identifier, description and the raw sequence lines are available as StringView,
+    i.e. without copying them out of the mapped file. The views stay valid until
+    the file is closed. Use getSequence() or getEntry() to obtain the sequence
+    without line breaks and whitespace, exactly as FASTAFile::readNext() would
+    return it.
+
+    Headers of PEFF files (lines starting with '#' before the first record) are skipped.
+
+    Compressed files cannot be mapped; use FASTAFile for those.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI MappedFASTAFile
+  {
+public:
+    /// Default constructor
+    MappedFASTAFile();
+
+    /**
+      @brief Maps @p filename into memory and indexes its records
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::FileNotReadable is thrown if the file cannot be mapped
+      @exception Exception::ParseError is thrown if the file does not start with a FASTA record
+    */
+    explicit MappedFASTAFile(const String& filename);
+
+    /// Destructor (unmaps the file)
+    virtual ~MappedFASTAFile();
+
+    /**
+      @brief Maps @p filename into memory and indexes its records (a previously opened file is closed first)
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::FileNotReadable is thrown if the file cannot be mapped
+      @exception Exception::ParseError is thrown if the file does not start with a FASTA record
+    */
+    void open(const String& filename);
+
+    /// Unmaps the current file (invalidates all views)
+    void close();
+
+    /// Returns whether a file is open
+    bool isOpen() const;
+
+    /// Number of entries in the file
+    Size size() const;
+
+    /// Identifier of entry @p index (the header up to the first whitespace)
+    StringView getIdentifier(Size index) const;
+
+    /// Description of entry @p index (the header after the first whitespace)
+    StringView getDescription(Size index) const;
+
+    /// Sequence lines of entry @p index as they are in the file (including line breaks)
+    StringView getRawSequence(Size index) const;
+
+    /// Sequence of entry @p index with line breaks and whitespace removed
+    void getSequence(Size index, String& sequence) const;
+
+    /// Copies entry @p index into @p entry
+    void getEntry(Size index, FASTAFile::FASTAEntry& entry) const;
+
+    /**
+      @brief Copies @p count entries starting at @p first into @p entries (in parallel)
+
+      Fewer entries are returned if the end of the file is reached.
+
+      @note When called from within a parallel region (and nested parallelism is disabled, the
+      default), the entries are parsed by the calling thread only.
+    */
+    void getEntries(Size first, Size count, std::vector<FASTAFile::FASTAEntry>& entries) const;
+
+protected:
+    /// Returns the (trimmed) header line of entry @p index without the leading '>'
+    StringView getHeader_(Size index) const;
+
+    /// Locates the records in the mapped file
+    void index_(const String& filename);
+
+    struct Mapping_;
+    boost::shared_ptr<Mapping_> mapping_;
+
+    /// start of the mapped file
+    const char* data_;
+
+    /// size of the mapped file
+    Size data_size_;
+
+    /// position of the '>' of every record (plus the size of the file as sentinel)
+    std::vector<Size> records_;
+
+private:
+    /// not implemented
+    MappedFASTAFile(const MappedFASTAFile& rhs);
+    MappedFASTAFile& operator=(const MappedFASTAFile& rhs);
+  };
+
+  inline bool MappedFASTAFile::isOpen() const
+  {
+    return mapping_.get() != nullptr;
+  }
+
+  inline Size MappedFASTAFile::size() const
+  {
+    return records_.empty() ? 0 : records_.size() - 1;
+  }
+
+} // namespace OpenMS
@@ -0,0 +1,147 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace OpenMS
+{
+  /**
+    @brief Decompresses gzip and bzip2 files on background threads
+
+    Drop-in replacement for GzipIfstream and Bzip2Ifstream (the format is
+    detected from the magic bytes, uncompressed files are passed through)
+    which moves decompression off the thread that consumes the data.  A
+    read-ahead thread decompresses the file in blocks of @p chunk_size bytes
+    and keeps up to two finished blocks ahead of the reader (double
+    buffering), so parsing and decompression overlap.
+
+    Files which consist of independently compressed pieces are additionally
+    decompressed on several worker threads:
+      - BGZF files (gzip files written as a series of members which carry
+        their compressed size in the header, e.g. by bgzip)
+      - bzip2 files written as a series of streams (e.g. by pbzip2)
+
+    For all other files (plain single-member gzip, single-stream bzip2) the
+    position of the next member is only known after decompressing the
+    previous one, so these are decompressed by the read-ahead thread alone.
+
+    Errors in the compressed data are reported by read() once all data
+    preceding the error has been consumed, i.e. at the same point in the
+    stream as with the sequential classes: gzip errors raise
+    Exception::ConversionError, bzip2 errors raise Exception::ParseError.
+  */
+  class OPENMS_DLLAPI ReadAheadDecompressor
+  {
+public:
+    /// Default constructor
+    ReadAheadDecompressor();
+
+    /**
+      @brief Opens @p filename for reading
+
+      @param filename The file to decompress
+      @param nr_threads Number of threads used for parallel decompression (0 = as many as OpenMP uses)
+      @param chunk_size Size of the decompressed blocks (and of the compressed chunks handed to the workers)
+
+      @exception Exception::FileNotFound is thrown if the file cannot be opened
+    */
+    explicit ReadAheadDecompressor(const char* filename, Size nr_threads = 0, Size chunk_size = 1024 * 1024);
+
+    /// Destructor (stops the background threads)
+    virtual ~ReadAheadDecompressor();
+
+    /**
+      @brief Reads n bytes of decompressed data into buffer s
+
+      @return The number of bytes read. If it is less than n, the end of the file was reached and the stream is closed.
+
+      @note This returns a raw byte stream that is *not* null-terminated.
+
+      @exception Exception::ConversionError is thrown if gzip decompression fails
+      @exception Exception::ParseError is thrown if bzip2 decompression fails
+      @exception Exception::IllegalArgument is thrown if no file is open (also after the end of the file was reached)
+    */
+    size_t read(char* s, size_t n);
+
+    /// Returns true if the end of the file was reached (or no file is open)
+    bool streamEnd() const;
+
+    /// Returns whether a file is open
+    bool isOpen() const;
+
+    /// Returns whether the current file is decompressed by several worker threads
+    bool isParallel() const;
+
+    /**
+      @brief Opens a file for reading (any previously opened file is closed first)
+
+      @exception Exception::FileNotFound is thrown if the file cannot be opened
+    */
+    void open(const char* filename, Size nr_threads = 0, Size chunk_size = 1024 * 1024);
+
+    /// Closes the current file and stops the background threads
+    void close();
+
+    /// Returns true if @p filename starts with the gzip or bzip2 magic bytes
+    static bool isCompressed(const char* filename);
+
+protected:
+    struct Pipeline_;
+    boost::shared_ptr<Pipeline_> pipeline_;
+
+    /// true if end of file is reached
+    bool stream_at_end_;
+
+private:
+    /// not implemented
+    ReadAheadDecompressor(const ReadAheadDecompressor& rhs);
+    ReadAheadDecompressor& operator=(const ReadAheadDecompressor& rhs);
+  };
+
+  inline bool ReadAheadDecompressor::isOpen() const
+  {
+    return pipeline_.get() != nullptr;
+  }
+
+  inline bool ReadAheadDecompressor::streamEnd() const
+  {
+    return stream_at_end_;
+  }
+
+} // namespace OpenMS
@@ -180,6 +180,22 @@ namespace MSNumpress {
 	void decodeLinear(
 		const std::vector<unsigned char> &data,
 		std::vector<double> &result);
+
+	/**
+	 * Number of doubles that decodeLinear will decode from data, computed 
+	 * without decoding the values (allows decoding into a buffer of exactly
+	 * the right size)
+	 *
+	 * For corrupt data the returned number is at least the number of doubles 
+	 * written by decodeLinear before it throws.
+	 *
+	 * @data		pointer to array of bytes to be decoded (need memorycont. repr.)
+	 * @dataSize	number of bytes from *data to decode
+	 * @return		the number of doubles decodeLinear will return
+	 */
+	size_t decodeLinearLength(
+		const unsigned char *data,
+		const size_t dataSize);
 		
 /////////////////////////////////////////////////////////////
 	
@@ -282,6 +298,18 @@ namespace MSNumpress {
 		const std::vector<unsigned char> &data,
 		std::vector<double> &result);
 
+	/**
+	 * Number of doubles that decodePic will decode from data, computed 
+	 * without decoding the values (see decodeLinearLength)
+	 *
+	 * @data		pointer to array of bytes to be decoded (need memorycont. repr.)
+	 * @dataSize	number of bytes from *data to decode
+	 * @return		the number of doubles decodePic will return
+	 */
+	size_t decodePicLength(
+		const unsigned char *data,
+		const size_t dataSize);
+
 /////////////////////////////////////////////////////////////
 
 
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include <OpenMS/CONCEPT/Types.h>
@@ -49,6 +50,11 @@ namespace OpenMS
 
     It contains the fields score, score_type, rank, and sequence.
 
+    The sequence is stored in the hit itself unless it is set as a shared
+    pointer. Then hits with the same sequence share a single AASequence
+    instance (see AASequencePool). Shared sequences are never modified:
+    setting a new sequence on a hit only affects that hit.
+
     @ingroup Metadata
   */
   class OPENMS_DLLAPI PeptideHit :
@@ -270,6 +276,12 @@ public:
     /// sets the peptide sequence
     void setSequence(AASequence&& sequence);
 
+    /// sets a shared peptide sequence (e.g. from an AASequencePool) without copying it
+    void setSequence(const std::shared_ptr<const AASequence>& sequence);
+
+    /// returns the shared peptide sequence (a null pointer if the sequence is not shared)
+    const std::shared_ptr<const AASequence>& getSharedSequence() const;
+
     /// returns the charge of the peptide
     Int getCharge() const;
 
@@ -320,8 +332,12 @@ public:
     std::set<String> extractProteinAccessionsSet() const;
 
 protected:
+    /// the peptide sequence (unused if shared_sequence_ is set)
     AASequence sequence_;
 
+    /// the peptide sequence if it is shared with other hits (see AASequencePool)
+    std::shared_ptr<const AASequence> shared_sequence_;
+
     /// the score of the peptide hit
     double score_;
 
@@ -42,6 +42,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <algorithm>
 #include <numeric>
 
 namespace OpenMS
@@ -564,101 +565,194 @@ namespace OpenMS
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "AccurateMassSearchEngine::init() was not called!");
     }
 
-    // Depending on ion_mode_internal_, either positive or negative adducts are used
-    std::vector<AdductInfo>::const_iterator it_s, it_e;
-    if (ion_mode == "positive")
+    // Depending on ion_mode, either positive or negative adducts are used
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode);
+
+    std::vector<QueryHit> hits;
+    queryByMZs(std::vector<double>(1, observed_mz), std::vector<Int>(1, observed_charge), ion_mode, hits, std::vector<EmpiricalFormula>(1, observed_adduct));
+
+    materializeHits_(hits.begin(), hits.end(), observed_mz, observed_charge, adducts, results);
+  }
+
+  void AccurateMassSearchEngine::queryByMZs(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<QueryHit>& hits, const std::vector<EmpiricalFormula>& observed_adducts) const
+  {
+    if (!is_initialized_)
     {
-      it_s = pos_adducts_.begin();
-      it_e = pos_adducts_.end();
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "AccurateMassSearchEngine::init() was not called!");
     }
-    else if (ion_mode == "negative")
+    if (observed_mzs.size() != observed_charges.size() || (!observed_adducts.empty() && observed_adducts.size() != observed_mzs.size()))
     {
-      it_s = neg_adducts_.begin();
-      it_e = neg_adducts_.end();
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of m/z values, charges and adducts of the queries must match!");
     }
-    else
+
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode);
+
+    // only adducts with losses (e.g. M+H-H2O) can be incompatible with a DB entry;
+    // for all others we can skip parsing the sum formula of every hit
+    std::vector<bool> needs_compatibility_check(adducts.size());
+    for (Size a = 0; a < adducts.size(); ++a)
     {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
+      needs_compatibility_check[a] = !adducts[a].isCompatible(EmpiricalFormula());
     }
 
-    std::pair<Size, Size> hit_idx;
-    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
+    const EmpiricalFormula no_adduct;
+    const bool use_ppm = (mass_error_unit_ == "ppm");
+    const Size chunk_size = 1024;
+    const Size nr_chunks = (observed_mzs.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<QueryHit> > chunk_hits(nr_chunks);
+    bool db_empty_but_queried = false;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize chunk = 0; chunk < (SignedSize)nr_chunks; ++chunk)
     {
-      if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(it->getCharge())))
-      { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
-        // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
-        continue;
-      }
+      const Size q_start = chunk * chunk_size;
+      const Size q_end = std::min(q_start + chunk_size, observed_mzs.size());
 
-      if ((observed_adduct != EmpiricalFormula()) && (observed_adduct != it->getEmpiricalFormula()))
-      { // If feature has no adduct annotation, method call defaults to empty EF(). If feature is annotated with an adduct, it must match.
-        continue;
-      }
+      // collect the mass windows of all (query, adduct) pairs of this chunk
+      std::vector<QueryWindow_> windows;
+      windows.reserve((q_end - q_start) * adducts.size());
+      for (Size q = q_start; q < q_end; ++q)
+      {
+        const double observed_mz = observed_mzs[q];
+        const Int observed_charge = observed_charges[q];
+        const EmpiricalFormula& observed_adduct = observed_adducts.empty() ? no_adduct : observed_adducts[q];
+        const bool has_observed_adduct = (observed_adduct != no_adduct);
 
+        for (Size a = 0; a < adducts.size(); ++a)
+        {
+          const AdductInfo& adduct = adducts[a];
+          if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(adduct.getCharge())))
+          { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
+            // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
+            continue;
+          }
 
-      // get potential hits as indices in masskey_table
-      double neutral_mass = it->getNeutralMass(observed_mz); // calculate mass of uncharged small molecule without adduct mass
+          if (has_observed_adduct && (observed_adduct != adduct.getEmpiricalFormula()))
+          { // If feature has no adduct annotation, it defaults to empty EF(). If feature is annotated with an adduct, it must match.
+            continue;
+          }
 
-      // Our database is just a set of neutral masses (i.e., without adducts)
-      // However, given is either an absolute m/z tolerance or a ppm tolerance for the observed m/z
-      // We now need an upper bound on the absolute allowed mass difference, given the above tolerance in m/z.
-      // The selected candidates then have an mass tolerance which corresponds to the user's m/z tolerance.
-      // (the other approach is to precompute m/z values for all combinations of adducts, charges and DB entries -- too much)
-      double diff_mz;
-      // check if mass error window is given in ppm or Da
-      if (mass_error_unit_ == "ppm")
+          // calculate mass of uncharged small molecule without adduct mass
+          QueryWindow_ w;
+          w.query_mass = adduct.getNeutralMass(observed_mz);
+          w.query_index = q;
+          w.adduct_index = a;
+
+          // Our database is just a set of neutral masses (i.e., without adducts)
+          // However, given is either an absolute m/z tolerance or a ppm tolerance for the observed m/z
+          // We now need an upper bound on the absolute allowed mass difference, given the above tolerance in m/z.
+          // The selected candidates then have an mass tolerance which corresponds to the user's m/z tolerance.
+          // (the other approach is to precompute m/z values for all combinations of adducts, charges and DB entries -- too much)
+          double diff_mz = use_ppm ? (observed_mz / 1e6) * mass_error_value_ : mass_error_value_;
+          // convert absolute m/z diff to absolute mass diff
+          // absolute mass error: the adduct itself is irrelevant here since its a constant for both the theoretical and observed mass
+          //       ppm tolerance: the diff_mz accounts for it already (heavy adducts lead to larger m/z tolerance)
+          double diff_mass = diff_mz * std::abs(adduct.getCharge()); // do not use observed charge (could be 0=unknown)
+          w.lower = w.query_mass - diff_mass;
+          w.upper = w.query_mass + diff_mass;
+          windows.push_back(w);
+        }
+      }
+
+      if (windows.empty())
       {
-        // convert ppm to absolute m/z tolerance for the current candidate
-        diff_mz = (observed_mz / 1e6) * mass_error_value_;
+        continue;
       }
-      else
+      if (mass_mappings_.empty())
       {
-        diff_mz = mass_error_value_;
+        db_empty_but_queried = true; // reported after the parallel region
+        continue;
       }
-      // convert absolute m/z diff to absolute mass diff
-      // What about the adduct?
-      // absolute mass error: the adduct itself is irrelevant here since its a constant for both the theoretical and observed mass
-      //       ppm tolerance: the diff_mz accounts for it already (heavy adducts lead to larger m/z tolerance)
-      double diff_mass = diff_mz * std::abs(it->getCharge()); // do not use observed charge (could be 0=unknown)
-
-      searchMass_(neutral_mass, diff_mass, hit_idx);
 
-      //std::cerr << ion_mode_internal_ << " adduct: " << adduct_name << ", " << adduct_mass << " Da, " << query_mass << " qm(against DB), " << charge << " q\n";
+      // merge-join: with ascending lower bounds, the first candidate in the DB can only move forward
+      std::sort(windows.begin(), windows.end(),
+                [](const QueryWindow_& a, const QueryWindow_& b) { return a.lower < b.lower; });
 
-      // store information from query hits in AccurateMassSearchResult objects
-      for (Size i = hit_idx.first; i < hit_idx.second; ++i)
+      std::vector<QueryHit>& hits_chunk = chunk_hits[chunk];
+      std::vector<MappingEntry_>::const_iterator db_first = mass_mappings_.begin();
+      for (std::vector<QueryWindow_>::const_iterator w_it = windows.begin(); w_it != windows.end(); ++w_it)
       {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        db_first = std::lower_bound(db_first, mass_mappings_.end(), w_it->lower, CompareEntryAndMass_()); // first element equal or larger
+        for (std::vector<MappingEntry_>::const_iterator db_it = db_first;
+             db_it != mass_mappings_.end() && !(w_it->upper < db_it->mass); ++db_it)
         {
-          // only written if TOPP tool has --debug
-          OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
-          continue;
-        }
+          // check if DB entry is compatible to the adduct
+          if (needs_compatibility_check[w_it->adduct_index] && !adducts[w_it->adduct_index].isCompatible(EmpiricalFormula(db_it->formula)))
+          {
+#ifdef _OPENMP
+#pragma omp critical (LOG_DEBUG_access)
+#endif
+            // only written if TOPP tool has --debug
+            OPENMS_LOG_DEBUG << "'" << db_it->formula << "' cannot have adduct '" << adducts[w_it->adduct_index].getName() << "'. Omitting.\n";
+            continue;
+          }
 
-        // compute ppm errors
-        double db_mass = mass_mappings_[i].mass;
-        double theoretical_mz = it->getMZ(db_mass);
-        double error_ppm_mz = Math::getPPM(observed_mz, theoretical_mz); // negative values are allowed!
-
-        AccurateMassSearchResult ams_result;
-        ams_result.setObservedMZ(observed_mz);
-        ams_result.setCalculatedMZ(theoretical_mz);
-        ams_result.setQueryMass(neutral_mass);
-        ams_result.setFoundMass(db_mass);
-        ams_result.setCharge(std::abs(it->getCharge())); // use theoretical adducts charge (is always valid); native charge might be zero
-        ams_result.setMZErrorPPM(error_ppm_mz);
-        ams_result.setMatchingIndex(i);
-        ams_result.setFoundAdduct(it->getName());
-        ams_result.setEmpiricalFormula(mass_mappings_[i].formula);
-        ams_result.setMatchingHMDBids(mass_mappings_[i].massIDs);
-
-        results.push_back(ams_result);
-
-        // ams_result.outputResults();
-        // std::cout << "****************************************************" << std::endl;
+          QueryHit hit;
+          hit.query_index = w_it->query_index;
+          hit.adduct_index = w_it->adduct_index;
+          hit.db_index = std::distance(mass_mappings_.begin(), db_it);
+          hit.query_mass = w_it->query_mass;
+          hits_chunk.push_back(hit);
+        }
       }
 
+      // restore the order of queryByMZ(): by query, then adduct, then DB entry
+      std::sort(hits_chunk.begin(), hits_chunk.end(),
+                [](const QueryHit& a, const QueryHit& b)
+                {
+                  if (a.query_index != b.query_index) return a.query_index < b.query_index;
+                  if (a.adduct_index != b.adduct_index) return a.adduct_index < b.adduct_index;
+                  return a.db_index < b.db_index;
+                });
+    }
+
+    if (db_empty_but_queried)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
+    }
+
+    hits.clear();
+    Size nr_hits(0);
+    for (Size chunk = 0; chunk < nr_chunks; ++chunk)
+    {
+      nr_hits += chunk_hits[chunk].size();
+    }
+    hits.reserve(nr_hits);
+    for (Size chunk = 0; chunk < nr_chunks; ++chunk)
+    {
+      hits.insert(hits.end(), chunk_hits[chunk].begin(), chunk_hits[chunk].end());
+    }
+  }
+
+  void AccurateMassSearchEngine::materializeHits_(std::vector<QueryHit>::const_iterator first, std::vector<QueryHit>::const_iterator last, double observed_mz, Int observed_charge,
+                                                  const std::vector<AdductInfo>& adducts, std::vector<AccurateMassSearchResult>& results) const
+  {
+    // store information from query hits in AccurateMassSearchResult objects
+    for (std::vector<QueryHit>::const_iterator it = first; it != last; ++it)
+    {
+      const AdductInfo& adduct = adducts[it->adduct_index];
+      const MappingEntry_& entry = mass_mappings_[it->db_index];
+
+      // compute ppm errors
+      double db_mass = entry.mass;
+      double theoretical_mz = adduct.getMZ(db_mass);
+      double error_ppm_mz = Math::getPPM(observed_mz, theoretical_mz); // negative values are allowed!
+
+      AccurateMassSearchResult ams_result;
+      ams_result.setObservedMZ(observed_mz);
+      ams_result.setCalculatedMZ(theoretical_mz);
+      ams_result.setQueryMass(it->query_mass);
+      ams_result.setFoundMass(db_mass);
+      ams_result.setCharge(std::abs(adduct.getCharge())); // use theoretical adducts charge (is always valid); native charge might be zero
+      ams_result.setMZErrorPPM(error_ppm_mz);
+      ams_result.setMatchingIndex(it->db_index);
+      ams_result.setFoundAdduct(adduct.getName());
+      ams_result.setEmpiricalFormula(entry.formula);
+      ams_result.setMatchingHMDBids(entry.massIDs);
+
+      results.push_back(ams_result);
     }
 
     // if result is empty, add a 'not-found' indicator if empty hits should be stored
@@ -677,8 +771,6 @@ namespace OpenMS
       ams_result.setMatchingHMDBids(std::vector<String>(1, "null"));
       results.push_back(ams_result);
     }
-
-    return;
   }
 
   void AccurateMassSearchEngine::queryByFeature(const Feature& feature, const Size& feature_index, const String& ion_mode, std::vector<AccurateMassSearchResult>& results) const
@@ -700,13 +792,21 @@ namespace OpenMS
       queryByMZ(feature.getMZ(), feature.getCharge(), ion_mode, results_part);
     }
 
+    addFeatureInfo_(feature, feature_index, results_part);
+
+    // append
+    results.insert(results.end(), results_part.begin(), results_part.end());
+  }
+
+  void AccurateMassSearchEngine::addFeatureInfo_(const Feature& feature, Size feature_index, std::vector<AccurateMassSearchResult>& results) const
+  {
     Size isotope_export = (Size)param_.getValue("mzTab:exportIsotopeIntensities");
 
-    for (Size hit_idx = 0; hit_idx < results_part.size(); ++hit_idx)
+    for (Size hit_idx = 0; hit_idx < results.size(); ++hit_idx)
     {
-      results_part[hit_idx].setObservedRT(feature.getRT());
-      results_part[hit_idx].setSourceFeatureIndex(feature_index);
-      results_part[hit_idx].setObservedIntensity(feature.getIntensity());
+      results[hit_idx].setObservedRT(feature.getRT());
+      results[hit_idx].setSourceFeatureIndex(feature_index);
+      results[hit_idx].setObservedIntensity(feature.getIntensity());
 
       std::vector<double> mti;
       if (isotope_export > 0)
@@ -715,11 +815,8 @@ namespace OpenMS
           {
             mti = feature.getMetaValue("masstrace_intensity");
           }
-        results_part[hit_idx].setMasstraceIntensities(mti);
+        results[hit_idx].setMasstraceIntensities(mti);
       }
-
-      // append
-      results.push_back(results_part[hit_idx]);
     }
   }
 
@@ -733,6 +830,11 @@ namespace OpenMS
     // get hits
     queryByMZ(cfeat.getMZ(), cfeat.getCharge(), ion_mode, results);
 
+    addConsensusFeatureInfo_(cfeat, cf_index, number_of_maps, results);
+  }
+
+  void AccurateMassSearchEngine::addConsensusFeatureInfo_(const ConsensusFeature& cfeat, Size cf_index, Size number_of_maps, std::vector<AccurateMassSearchResult>& results) const
+  {
     // collect meta data:
     // intensities for all maps as given in handles; 0 if no handle is present for a map
     ConsensusFeature::HandleSetType ind_feats(cfeat.getFeatures()); // sorted by MapIndices
@@ -787,15 +889,41 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
+    // search all features at once; results are materialized per feature below
+    std::vector<double> mzs(fmap.size());
+    std::vector<Int> charges(fmap.size());
+    std::vector<EmpiricalFormula> feature_adducts;
+    bool use_feature_adducts = param_.getValue("use_feature_adducts").toString() == "true";
+    if (use_feature_adducts)
+    {
+      feature_adducts.resize(fmap.size());
+    }
+    for (Size i = 0; i < fmap.size(); ++i)
+    {
+      mzs[i] = fmap[i].getMZ();
+      charges[i] = fmap[i].getCharge();
+      if (use_feature_adducts && fmap[i].metaValueExists("dc_charge_adducts"))
+      {
+        feature_adducts[i] = EmpiricalFormula(fmap[i].getMetaValue("dc_charge_adducts"));
+      }
+    }
+    std::vector<QueryHit> hits;
+    queryByMZs(mzs, charges, ion_mode_internal, hits, feature_adducts);
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode_internal);
+
     // map for storing overall results
     QueryResultsTable overall_results;
     Size dummy_count(0);
+    std::vector<QueryHit>::const_iterator hit_it = hits.begin();
     for (Size i = 0; i < fmap.size(); ++i)
     {
       std::vector<AccurateMassSearchResult> query_results;
 
-      // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+      std::vector<QueryHit>::const_iterator hit_end = hit_it;
+      while (hit_end != hits.end() && hit_end->query_index == i) ++hit_end;
+      materializeHits_(hit_it, hit_end, mzs[i], charges[i], adducts, query_results);
+      addFeatureInfo_(fmap[i], i, query_results);
+      hit_it = hit_end;
 
       if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
 
@@ -901,14 +1029,31 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
+    // search all consensus features at once; results are materialized per feature below
+    std::vector<double> mzs(cmap.size());
+    std::vector<Int> charges(cmap.size());
+    for (Size i = 0; i < cmap.size(); ++i)
+    {
+      mzs[i] = cmap[i].getMZ();
+      charges[i] = cmap[i].getCharge();
+    }
+    std::vector<QueryHit> hits;
+    queryByMZs(mzs, charges, ion_mode_internal, hits);
+    const std::vector<AdductInfo>& adducts = getAdducts_(ion_mode_internal);
+
     // map for storing overall results
     QueryResultsTable overall_results;
 
+    std::vector<QueryHit>::const_iterator hit_it = hits.begin();
     for (Size i = 0; i < cmap.size(); ++i)
     {
       std::vector<AccurateMassSearchResult> query_results;
-      // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
+
+      std::vector<QueryHit>::const_iterator hit_end = hit_it;
+      while (hit_end != hits.end() && hit_end->query_index == i) ++hit_end;
+      materializeHits_(hit_it, hit_end, mzs[i], charges[i], adducts, query_results);
+      addConsensusFeatureInfo_(cmap[i], i, num_of_maps, query_results);
+      hit_it = hit_end;
       annotate_(query_results, cmap[i]);
       overall_results.push_back(query_results);
     }
@@ -1460,27 +1605,17 @@ namespace OpenMS
     return;
   }
 
-  void AccurateMassSearchEngine::searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const
+  const std::vector<AdductInfo>& AccurateMassSearchEngine::getAdducts_(const String& ion_mode) const
   {
-    //OPENMS_LOG_INFO << "searchMass: neutral_query_mass=" << neutral_query_mass << " diff_mz=" << diff_mz << " ppm allowed:" << mass_error_value_ << std::endl;
-
-    // binary search for formulas which are within diff_mz distance
-    if (mass_mappings_.empty())
+    if (ion_mode == "positive")
     {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There are no entries found in mass-to-ids mapping file! Aborting... ", "0");
+      return pos_adducts_;
     }
-
-    std::vector<MappingEntry_>::const_iterator lower_it = std::lower_bound(mass_mappings_.begin(), mass_mappings_.end(), neutral_query_mass - diff_mass, CompareEntryAndMass_()); // first element equal or larger
-    std::vector<MappingEntry_>::const_iterator upper_it = std::upper_bound(mass_mappings_.begin(), mass_mappings_.end(), neutral_query_mass + diff_mass, CompareEntryAndMass_()); // first element greater than
-
-    //std::cout << *lower_it << " " << *upper_it << "idx: " << lower_it - masskey_table_.begin() << " " << upper_it - masskey_table_.begin() << std::endl;
-    Size start_idx = std::distance(mass_mappings_.begin(), lower_it);
-    Size end_idx = std::distance(mass_mappings_.begin(), upper_it);
-
-    hit_indices.first = start_idx;
-    hit_indices.second = end_idx;
-
-    return;
+    else if (ion_mode == "negative")
+    {
+      return neg_adducts_;
+    }
+    throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Ion mode cannot be set to '") + ion_mode + "'. Must be 'positive' or 'negative'!");
   }
 
   double AccurateMassSearchEngine::computeCosineSim_( const std::vector<double>& x, const std::vector<double>& y ) const
@@ -41,6 +41,7 @@
 #include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
 #include <OpenMS/FILTERING/ID/IDFilter.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/openms_package_version.h>
 
 #include <set>
@@ -53,218 +54,284 @@ using namespace OpenMS::Internal;
 namespace OpenMS
 {
 
+  /// Parameter-independent node structure (types and parents of the factor nodes) of a connected component.
+  /// Built on first use and reused for every parameter combination of the grid search and the final inference.
+  /// Only the graph traversal is saved: the factors and the evergreen factor graph are still created anew for
+  /// every parameter combination.
+  /// Additionally keeps timing and size statistics of the component.
+  struct BayesianProteinInferenceAlgorithm::ComponentFactorization
+  {
+    /// a node that contributes factors, together with its neighbors on the "left" (protein) side
+    struct Node
+    {
+      IDBoostGraph::vertex_t id;
+      int type; // IDPointer::which(): 0 = prot, 1 = prot group, 2 = pep group, 6 = PSM
+      std::vector<IDBoostGraph::vertex_t> in;
+    };
+
+    bool initialized = false;
+    std::vector<Node> nodes;
+
+    // statistics
+    Size nr_vertices = 0;
+    Size nr_edges = 0;
+    /// number of entries in the probability tables of all factors (to estimate the memory footprint)
+    Size nr_table_entries = 0;
+    unsigned long nr_messages = 0;
+    Size nr_evaluations = 0;
+    double time_last = 0.0;
+    double time_total = 0.0;
+
+    void build(const IDBoostGraph::Graph& fg)
+    {
+      nr_vertices = boost::num_vertices(fg);
+      nr_edges = boost::num_edges(fg);
+      nodes.clear();
+      nodes.reserve(nr_vertices);
+
+      IDBoostGraph::Graph::vertex_iterator ui, ui_end;
+      boost::tie(ui,ui_end) = boost::vertices(fg);
+      for (; ui != ui_end; ++ui)
+      {
+        int type = fg[*ui].which();
+        if (type != 0 && type != 1 && type != 2 && type != 6) continue; // no factors for other node types
+
+        nodes.push_back(Node{*ui, type, {}});
+        // direct neighbors are proteins on the "left" side and peptides on the "right" side
+        IDBoostGraph::Graph::adjacency_iterator nbIt, nbIt_end;
+        boost::tie(nbIt, nbIt_end) = boost::adjacent_vertices(*ui, fg);
+        for (; nbIt != nbIt_end; ++nbIt)
+        {
+          if (fg[*nbIt].which() < type)
+          {
+            nodes.back().in.push_back(*nbIt);
+          }
+        }
+
+        if (type == 6) // evidence table + (nr. parents + 1) x 2 conditional table
+        {
+          nr_table_entries += 2 + 2 * (boost::get<PeptideHit*>(fg[*ui])->getPeptideEvidences().size() + 1);
+        }
+        else if (type == 0)
+        {
+          nr_table_entries += 2;
+        }
+        else // convolution tree over the inputs
+        {
+          nr_table_entries += 2 * (nodes.back().in.size() + 1);
+        }
+      }
+      initialized = true;
+    }
+  };
+
   /// A functor that specifies what to do on a connected component (IDBoostGraph::FilteredGraph)
   class BayesianProteinInferenceAlgorithm::GraphInferenceFunctor
-      //: public std::function<unsigned long(IDBoostGraph::Graph&)>
+      //: public std::function<unsigned long(IDBoostGraph::Graph&, Size)>
   {
   public:
     //TODO think about restructuring the passed params (we do not need every param from the BPI class here.
     const Param& param_;
     unsigned int debug_lvl_;
-    unsigned long cnt_;
+    /// cached factorizations, indexed by connected component
+    std::vector<ComponentFactorization>& factorizations_;
 
-    explicit GraphInferenceFunctor(const Param& param, unsigned int debug_lvl):
+    explicit GraphInferenceFunctor(const Param& param, unsigned int debug_lvl,
+                                   std::vector<ComponentFactorization>& factorizations):
         param_(param),
         debug_lvl_(debug_lvl),
-        cnt_(0)
+        factorizations_(factorizations)
     {}
 
-    unsigned long operator() (IDBoostGraph::Graph& fg) {
+    unsigned long operator() (IDBoostGraph::Graph& fg, Size cc_index) {
       //TODO do quick bruteforce calculation if the cc is really small?
-      cnt_++;
       // this skips CCs with just peps or prots. We only add edges between different types.
       // and if there were no edges, it would not be a CC.
       if (boost::num_vertices(fg) >= 2)
       {
-        bool graph_mp_ownership_acquired = false;
-        bool update_PSM_probabilities = param_.getValue("update_PSM_probabilities").toBool();
-        bool annotate_group_posterior = param_.getValue("annotate_group_probabilities").toBool();
-        bool user_defined_priors = param_.getValue("user_defined_priors").toBool();
-        bool regularize = param_.getValue("model_parameters:regularize").toBool();
-        double pnorm = param_.getValue("loopy_belief_propagation:p_norm_inference");
-        if (pnorm <= 0)
+        StopWatch sw;
+        sw.start();
+
+        // every cc is processed by exactly one thread, so no locking needed
+        ComponentFactorization& factorization = factorizations_.at(cc_index);
+        if (!factorization.initialized)
         {
-          pnorm = std::numeric_limits<double>::infinity();
+          factorization.build(fg);
         }
 
-        MessagePasserFactory<IDBoostGraph::vertex_t> mpf (param_.getValue("model_parameters:pep_emission"),
-                                                 param_.getValue("model_parameters:pep_spurious_emission"),
-                                                 param_.getValue("model_parameters:prot_prior"),
-                                                 pnorm,
-                                                 param_.getValue("model_parameters:pep_prior")); // the p used for marginalization: 1 = sum product, inf = max product
-        evergreen::BetheInferenceGraphBuilder<IDBoostGraph::vertex_t> bigb;
+        unsigned long nrMessagesNeeded = inferOnComponent_(fg, cc_index, factorization);
 
-        IDBoostGraph::Graph::vertex_iterator ui, ui_end;
-        boost::tie(ui,ui_end) = boost::vertices(fg);
+        sw.stop();
+        factorization.nr_messages = nrMessagesNeeded;
+        factorization.time_last = sw.getClockTime();
+        factorization.time_total += factorization.time_last;
+        ++factorization.nr_evaluations;
+        return nrMessagesNeeded;
+      }
+      else
+      {
+        std::cout << "Skipped cc with only one type (proteins or peptides)" << std::endl;
+        return 0;
+      }
+    }
 
-        // Store the IDs of the nodes for which you want the posteriors in the end
-        vector<vector<IDBoostGraph::vertex_t>> posteriorVars;
+  private:
+    unsigned long inferOnComponent_(IDBoostGraph::Graph& fg, Size cc_index, const ComponentFactorization& factorization)
+    {
+      bool graph_mp_ownership_acquired = false;
+      bool update_PSM_probabilities = param_.getValue("update_PSM_probabilities").toBool();
+      bool annotate_group_posterior = param_.getValue("annotate_group_probabilities").toBool();
+      bool user_defined_priors = param_.getValue("user_defined_priors").toBool();
+      bool regularize = param_.getValue("model_parameters:regularize").toBool();
+      double pnorm = param_.getValue("loopy_belief_propagation:p_norm_inference");
+      if (pnorm <= 0)
+      {
+        pnorm = std::numeric_limits<double>::infinity();
+      }
 
-        // direct neighbors are proteins on the "left" side and peptides on the "right" side
-        // TODO Can be sped up using directed graph. Needs some restructuring in IDBoostGraph class first tho.
-        std::vector<IDBoostGraph::vertex_t> in{};
-        //std::vector<IDBoostGraph::vertex_t> out{};
+      MessagePasserFactory<IDBoostGraph::vertex_t> mpf (param_.getValue("model_parameters:pep_emission"),
+                                               param_.getValue("model_parameters:pep_spurious_emission"),
+                                               param_.getValue("model_parameters:prot_prior"),
+                                               pnorm,
+                                               param_.getValue("model_parameters:pep_prior")); // the p used for marginalization: 1 = sum product, inf = max product
+      evergreen::BetheInferenceGraphBuilder<IDBoostGraph::vertex_t> bigb;
 
-        //TODO the try section could in theory be slimmed down a little bit. Start at first use of insertDependency maybe.
-        // check performance impact.
-        try
-        {
-          for (; ui != ui_end; ++ui)
-          {
-            IDBoostGraph::Graph::adjacency_iterator nbIt, nbIt_end;
-            boost::tie(nbIt, nbIt_end) = boost::adjacent_vertices(*ui, fg);
+      // Store the IDs of the nodes for which you want the posteriors in the end
+      vector<vector<IDBoostGraph::vertex_t>> posteriorVars;
 
-            in.clear();
-            //out.clear(); // we dont need out edges currently
+      //TODO the try section could in theory be slimmed down a little bit. Start at first use of insertDependency maybe.
+      // check performance impact.
+      try
+      {
+        // the types and parents of the nodes come from the cached factorization,
+        // the factors themselves depend on the current parameters and are created here
+        for (const ComponentFactorization::Node& node : factorization.nodes)
+        {
+          const std::vector<IDBoostGraph::vertex_t>& in = node.in;
 
-            for (; nbIt != nbIt_end; ++nbIt)
+          if (node.type == 6) // pep hit = psm
+          {
+            PeptideHit* psm = boost::get<PeptideHit *>(fg[node.id]);
+            if (regularize)
             {
-              if (fg[*nbIt].which() < fg[*ui].which())
-              {
-                in.push_back(*nbIt);
-              }
-              /*else
-              {
-                out.push_back(*nbIt);
-              }*/
+              bigb.insert_dependency(mpf.createRegularizingSumEvidenceFactor(psm->getPeptideEvidences().size(), in[0], node.id));
             }
-
-            //TODO introduce an enum for the types to make it more clear.
-            //Or use the static_visitor pattern: You have to pass the vertex with its neighbors as a second arg though.
-
-            if (fg[*ui].which() == 6) // pep hit = psm
+            else
             {
-              if (regularize)
-              {
-                bigb.insert_dependency(mpf.createRegularizingSumEvidenceFactor(boost::get<PeptideHit *>(fg[*ui])
-                                                                                   ->getPeptideEvidences().size(), in[0], *ui));
-              }
-              else
-              {
-                bigb.insert_dependency(mpf.createSumEvidenceFactor(boost::get<PeptideHit *>(fg[*ui])
-                                                                                   ->getPeptideEvidences().size(), in[0], *ui));
-              }
+              bigb.insert_dependency(mpf.createSumEvidenceFactor(psm->getPeptideEvidences().size(), in[0], node.id));
+            }
 
-              bigb.insert_dependency(mpf.createPeptideEvidenceFactor(*ui,
-                                                                     boost::get<PeptideHit *>(fg[*ui])->getScore()));
-              if (update_PSM_probabilities)
-              {
-                posteriorVars.push_back({*ui});
-              }
+            bigb.insert_dependency(mpf.createPeptideEvidenceFactor(node.id, psm->getScore()));
+            if (update_PSM_probabilities)
+            {
+              posteriorVars.push_back({node.id});
             }
-            else if (fg[*ui].which() == 2) // pep group
+          }
+          else if (node.type == 2) // pep group
+          {
+            bigb.insert_dependency(mpf.createPeptideProbabilisticAdderFactor(in, node.id));
+          }
+          else if (node.type == 1) // prot group
+          {
+            bigb.insert_dependency(mpf.createPeptideProbabilisticAdderFactor(in, node.id));
+            if (annotate_group_posterior)
             {
-              bigb.insert_dependency(mpf.createPeptideProbabilisticAdderFactor(in, *ui));
+              posteriorVars.push_back({node.id});
             }
-            else if (fg[*ui].which() == 1) // prot group
+          }
+          else if (node.type == 0) // prot
+          {
+            //TODO modify createProteinFactor to start with a modified prior based on the number of missing
+            // peptides (later tweak to include conditional prob. for that peptide
+            if (user_defined_priors)
             {
-              bigb.insert_dependency(mpf.createPeptideProbabilisticAdderFactor(in, *ui));
-              if (annotate_group_posterior)
-              {
-                posteriorVars.push_back({*ui});
-              }
+              bigb.insert_dependency(mpf.createProteinFactor(node.id,
+                                                             (double) boost::get<ProteinHit *>(fg[node.id])
+                                                                 ->getMetaValue("Prior")));
             }
-            else if (fg[*ui].which() == 0) // prot
+            else
             {
-              //TODO modify createProteinFactor to start with a modified prior based on the number of missing
-              // peptides (later tweak to include conditional prob. for that peptide
-              if (user_defined_priors)
-              {
-                bigb.insert_dependency(mpf.createProteinFactor(*ui,
-                                                               (double) boost::get<ProteinHit *>(fg[*ui])
-                                                                   ->getMetaValue("Prior")));
-              }
-              else
-              {
-                bigb.insert_dependency(mpf.createProteinFactor(*ui));
-              }
-              posteriorVars.push_back({*ui});
+              bigb.insert_dependency(mpf.createProteinFactor(node.id));
             }
+            posteriorVars.push_back({node.id});
           }
+        }
 
-          // create factor graph for Bayesian network
-          evergreen::InferenceGraph < IDBoostGraph::vertex_t > ig = bigb.to_graph();
-          graph_mp_ownership_acquired = true;
+        // create factor graph for Bayesian network
+        evergreen::InferenceGraph < IDBoostGraph::vertex_t > ig = bigb.to_graph();
+        graph_mp_ownership_acquired = true;
 
-          unsigned long maxMessages = param_
-              .getValue("loopy_belief_propagation:max_nr_iterations");
-          double initDampeningLambda = param_
-              .getValue("loopy_belief_propagation:dampening_lambda");
-          double initConvergenceThreshold = param_.getValue(
-              "loopy_belief_propagation:convergence_threshold");
-          unsigned long nrEdges = boost::num_edges(fg);
+        unsigned long maxMessages = param_
+            .getValue("loopy_belief_propagation:max_nr_iterations");
+        double initDampeningLambda = param_
+            .getValue("loopy_belief_propagation:dampening_lambda");
+        double initConvergenceThreshold = param_.getValue(
+            "loopy_belief_propagation:convergence_threshold");
+        unsigned long nrEdges = factorization.nr_edges;
 
-          //TODO parametrize the type of scheduler.
-          evergreen::PriorityScheduler<IDBoostGraph::vertex_t> scheduler(initDampeningLambda,
-                                                              initConvergenceThreshold,
-                                                              maxMessages);
-          scheduler.add_ab_initio_edges(ig);
+        //TODO parametrize the type of scheduler.
+        evergreen::PriorityScheduler<IDBoostGraph::vertex_t> scheduler(initDampeningLambda,
+                                                            initConvergenceThreshold,
+                                                            maxMessages);
+        scheduler.add_ab_initio_edges(ig);
 
-          evergreen::BeliefPropagationInferenceEngine<IDBoostGraph::vertex_t> bpie(scheduler, ig);
+        evergreen::BeliefPropagationInferenceEngine<IDBoostGraph::vertex_t> bpie(scheduler, ig);
 
-          auto posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
-              {
-                  std::make_tuple(std::max<unsigned long>(10000ul, nrEdges*nrEdges*2ul), initDampeningLambda, initConvergenceThreshold),
-                  std::make_tuple(nrEdges*nrEdges, std::min(0.5,initDampeningLambda*10), std::min(0.01,initConvergenceThreshold*10)),
-                  std::make_tuple(nrEdges*nrEdges/2ul, std::min(0.5,initDampeningLambda*100), std::min(0.01,initConvergenceThreshold*100))
-              });
+        auto posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
+            {
+                std::make_tuple(std::max<unsigned long>(10000ul, nrEdges*nrEdges*2ul), initDampeningLambda, initConvergenceThreshold),
+                std::make_tuple(nrEdges*nrEdges, std::min(0.5,initDampeningLambda*10), std::min(0.01,initConvergenceThreshold*10)),
+                std::make_tuple(nrEdges*nrEdges/2ul, std::min(0.5,initDampeningLambda*100), std::min(0.01,initConvergenceThreshold*100))
+            });
 
-          // TODO move the writing of statistics from IDBoostGraph here and write more stats
-          //  like nr messages and failure/success
-          unsigned long nrMessagesNeeded = bpie.getNrMessagesPassed();
+        unsigned long nrMessagesNeeded = bpie.getNrMessagesPassed();
 
-          for (auto const &posteriorFactor : posteriorFactors)
+        for (auto const &posteriorFactor : posteriorFactors)
+        {
+          double posterior = 1.0;
+          IDBoostGraph::SetPosteriorVisitor pv;
+          IDBoostGraph::vertex_t nodeId = posteriorFactor.ordered_variables()[0];
+          const evergreen::PMF &pmf = posteriorFactor.pmf();
+          // If Index 0 is in the range of this result PMFFactor is probability is non-zero
+          // and the prob of presence is 1-P(p=0). Important in multi-value factors like protein groups.
+          if (0 >= pmf.first_support()[0] && 0 <= pmf.last_support()[0])
           {
-            double posterior = 1.0;
-            IDBoostGraph::SetPosteriorVisitor pv;
-            IDBoostGraph::vertex_t nodeId = posteriorFactor.ordered_variables()[0];
-            const evergreen::PMF &pmf = posteriorFactor.pmf();
-            // If Index 0 is in the range of this result PMFFactor is probability is non-zero
-            // and the prob of presence is 1-P(p=0). Important in multi-value factors like protein groups.
-            if (0 >= pmf.first_support()[0] && 0 <= pmf.last_support()[0])
-            {
-              posterior = 1. - pmf.table()[0ul];
-            }
-            auto bound_visitor = std::bind(pv, std::placeholders::_1, posterior);
-            boost::apply_visitor(bound_visitor, fg[nodeId]);
+            posterior = 1. - pmf.table()[0ul];
           }
-          //TODO we could write out/save the posteriors here,
-          // so we can easily read them later for the best params of the grid search
-          return nrMessagesNeeded;
+          auto bound_visitor = std::bind(pv, std::placeholders::_1, posterior);
+          boost::apply_visitor(bound_visitor, fg[nodeId]);
         }
-        catch (const std::runtime_error& /*e*/)
-        {
-          //TODO print failing component and implement the following options
-          // 1) Leave posteriors (e.g. if Percolator was ran before. Make sure they are PPs not PEPs)
-          // 2) set posteriors to priors (implicitly done right now)
-          // 3) try another type of inference on that connected component. Different scheduler,
-          //    different extreme probabilities or maybe best: trivial aggregation-based inference.
-          // 4) Cancelling this and all other threads/ the loop and call this set of parameters invalid
+        //TODO we could write out/save the posteriors here,
+        // so we can easily read them later for the best params of the grid search
+        return nrMessagesNeeded;
+      }
+      catch (const std::runtime_error& /*e*/)
+      {
+        //TODO print failing component and implement the following options
+        // 1) Leave posteriors (e.g. if Percolator was ran before. Make sure they are PPs not PEPs)
+        // 2) set posteriors to priors (implicitly done right now)
+        // 3) try another type of inference on that connected component. Different scheduler,
+        //    different extreme probabilities or maybe best: trivial aggregation-based inference.
+        // 4) Cancelling this and all other threads/ the loop and call this set of parameters invalid
 
-          //For now we just warn and continue with the rest of the iterations. Might still be a valid run.
+        //For now we just warn and continue with the rest of the iterations. Might still be a valid run.
 
-          // Graph builder needs to build otherwise it leaks memory.
-          if (!graph_mp_ownership_acquired) bigb.to_graph();
+        // Graph builder needs to build otherwise it leaks memory.
+        if (!graph_mp_ownership_acquired) bigb.to_graph();
 
-          if (debug_lvl_ > 2)
-          {
-            std::ofstream ofs;
-            ofs.open ("failed_cc_a"+ String(param_.getValue("model_parameters:pep_emission")) +
-                "_b" + String(param_.getValue("model_parameters:pep_spurious_emission")) + "_g" +
-                String(param_.getValue("model_parameters:prot_prior")) + "_c" +
-                String(param_.getValue("model_parameters:pep_prior")) + "_p" + String(pnorm) + "_"
-                + String(cnt_) + ".graphviz"
-                , std::ofstream::out | std::ofstream::app);
-            IDBoostGraph::printGraph(ofs, fg);
-          }
-          std::cout << "Warning: Loopy belief propagation encountered a problem in a connected component. Skipping"
-                      " inference there." << std::endl;
-          return 0;
+        if (debug_lvl_ > 2)
+        {
+          std::ofstream ofs;
+          ofs.open ("failed_cc_a"+ String(param_.getValue("model_parameters:pep_emission")) +
+              "_b" + String(param_.getValue("model_parameters:pep_spurious_emission")) + "_g" +
+              String(param_.getValue("model_parameters:prot_prior")) + "_c" +
+              String(param_.getValue("model_parameters:pep_prior")) + "_p" + String(pnorm) + "_"
+              + String(cc_index) + ".graphviz"
+              , std::ofstream::out | std::ofstream::app);
+          IDBoostGraph::printGraph(ofs, fg);
         }
-      }
-      else
-      {
-        std::cout << "Skipped cc with only one type (proteins or peptides)" << std::endl;
+        std::cout << "Warning: Loopy belief propagation encountered a problem in a connected component. Skipping"
+                    " inference there." << std::endl;
         return 0;
       }
     }
@@ -277,12 +344,43 @@ namespace OpenMS
   {
   public:
     const Param& param_;
+    /// statistics, indexed by connected component
+    std::vector<ComponentFactorization>& factorizations_;
 
-    explicit ExtendedGraphInferenceFunctor(const Param& param):
-        param_(param)
+    explicit ExtendedGraphInferenceFunctor(const Param& param, std::vector<ComponentFactorization>& factorizations):
+        param_(param),
+        factorizations_(factorizations)
     {}
 
-    unsigned long operator() (IDBoostGraph::Graph& fg) {
+    unsigned long operator() (IDBoostGraph::Graph& fg, Size cc_index) {
+      unsigned long nr_messages = 0;
+      if (boost::num_vertices(fg) < 2)
+      {
+        return inferOnComponent_(fg, nr_messages);
+      }
+      StopWatch sw;
+      sw.start();
+
+      // every cc is processed by exactly one thread, so no locking needed
+      ComponentFactorization& factorization = factorizations_.at(cc_index);
+      if (!factorization.initialized)
+      {
+        factorization.build(fg);
+      }
+
+      unsigned long result = inferOnComponent_(fg, nr_messages);
+
+      sw.stop();
+      factorization.nr_messages = nr_messages;
+      factorization.time_last = sw.getClockTime();
+      factorization.time_total += factorization.time_last;
+      ++factorization.nr_evaluations;
+      return result;
+    }
+
+  private:
+    /// @p nr_messages is set to the number of messages passed
+    unsigned long inferOnComponent_(IDBoostGraph::Graph& fg, unsigned long& nr_messages) {
       //TODO do quick bruteforce calculation if the cc is really small
 
       double pnorm = param_.getValue("loopy_belief_propagation:p_norm_inference");
@@ -377,6 +475,7 @@ namespace OpenMS
           evergreen::BeliefPropagationInferenceEngine<IDBoostGraph::vertex_t> bpie(scheduler, ig);
 
           auto posteriorFactors = bpie.estimate_posteriors(posteriorVars);
+          nr_messages = bpie.getNrMessagesPassed();
 
           //TODO you could also save the indices of the peptides here and request + update their posteriors, too.
           for (auto const &posteriorFactor : posteriorFactors)
@@ -424,11 +523,14 @@ namespace OpenMS
     Param& param_;
     IDBoostGraph& ibg_;
     const unsigned int debug_lvl_;
+    std::vector<ComponentFactorization>& factorizations_;
 
-    explicit GridSearchEvaluator(Param& param, IDBoostGraph& ibg, unsigned int debug_lvl):
+    explicit GridSearchEvaluator(Param& param, IDBoostGraph& ibg, unsigned int debug_lvl,
+                                 std::vector<ComponentFactorization>& factorizations):
         param_(param),
         ibg_(ibg),
-        debug_lvl_(debug_lvl)
+        debug_lvl_(debug_lvl),
+        factorizations_(factorizations)
     {}
 
     double operator() (double alpha, double beta, double gamma)
@@ -437,8 +539,8 @@ namespace OpenMS
       param_.setValue("model_parameters:prot_prior", gamma);
       param_.setValue("model_parameters:pep_emission", alpha);
       param_.setValue("model_parameters:pep_spurious_emission", beta);
-      GraphInferenceFunctor gif {param_, debug_lvl_};
-      ibg_.applyFunctorOnCCs(gif);
+      GraphInferenceFunctor gif {param_, debug_lvl_, factorizations_};
+      ibg_.applyIndexedFunctorOnCCs(gif);
       FalseDiscoveryRate fdr;
       Param fdrparam = fdr.getParameters();
       fdrparam.setValue("conservative",param_.getValue("param_optimize:conservative_fdr"));
@@ -697,8 +799,18 @@ namespace OpenMS
       // TODO try to calc AUC partial only (e.g. up to 5% FDR)
       OPENMS_LOG_INFO << "Peptide FDR AUC before protein inference: " << pepFDR.rocN(cmap, 0) << std::endl;
 
-      IDBoostGraph ibg(proteinIDs[0], cmap, nr_top_psms, use_run_info, use_unannotated_ids, exp_des);
-      inferPosteriorProbabilities_(ibg);
+      if (use_run_info)
+      {
+        IDBoostGraph ibg(proteinIDs[0], cmap, nr_top_psms, use_run_info, use_unannotated_ids, exp_des);
+        inferPosteriorProbabilities_(ibg);
+      }
+      else
+      {
+        IDCompactGraph icg(proteinIDs[0], cmap, nr_top_psms, use_unannotated_ids);
+        icg.computeConnectedComponents();
+        IDBoostGraph ibg(proteinIDs[0], icg);
+        inferPosteriorProbabilities_(ibg);
+      }
       setScoreTypeAndSettings_(proteinIDs[0]);
 
       OPENMS_LOG_INFO << "Peptide FDR AUC after protein inference: " << pepFDR.rocN(cmap, 0) << std::endl;
@@ -721,8 +833,18 @@ namespace OpenMS
         OPENMS_LOG_INFO << "Peptide FDR AUC before protein inference: " << pepFDR.rocN(cmap, 0, proteinID.getIdentifier()) << std::endl;
 
         setScoreTypeAndSettings_(proteinID);
-        IDBoostGraph ibg(proteinID, cmap, nr_top_psms, use_run_info, use_unannotated_ids);
-        inferPosteriorProbabilities_(ibg);
+        if (use_run_info)
+        {
+          IDBoostGraph ibg(proteinID, cmap, nr_top_psms, use_run_info, use_unannotated_ids);
+          inferPosteriorProbabilities_(ibg);
+        }
+        else
+        {
+          IDCompactGraph icg(proteinID, cmap, nr_top_psms, use_unannotated_ids);
+          icg.computeConnectedComponents();
+          IDBoostGraph ibg(proteinID, icg);
+          inferPosteriorProbabilities_(ibg);
+        }
 
         OPENMS_LOG_INFO << "Peptide FDR AUC after protein inference: " << pepFDR.rocN(cmap, 0, proteinID.getIdentifier()) << std::endl;
       }
@@ -737,6 +859,10 @@ namespace OpenMS
     ibg.computeConnectedComponents();
     ibg.clusterIndistProteinsAndPeptides();
 
+    // the node structure of the factor graphs does not depend on the model parameters: determine it for every
+    // connected component once and reuse it for all parameter combinations (also collects statistics)
+    std::vector<ComponentFactorization> factorizations(ibg.getNrConnectedComponents());
+
     vector<double> gamma_search;
     vector<double> beta_search;
     vector<double> alpha_search;
@@ -759,7 +885,7 @@ namespace OpenMS
     if (gs.getNrCombos() > 1)
     {
      OPENMS_LOG_INFO << "Testing " << gs.getNrCombos() << " param combinations." << std::endl;
-      /*double res =*/ gs.evaluate(GridSearchEvaluator(param_, ibg, debug_lvl_), -1.0, bestParams);
+      /*double res =*/ gs.evaluate(GridSearchEvaluator(param_, ibg, debug_lvl_, factorizations), -1.0, bestParams);
     }
     else
     {
@@ -780,20 +906,52 @@ namespace OpenMS
 
     if (!use_run_info)
     {
-      GraphInferenceFunctor gif {param_, debug_lvl_};
-      ibg.applyFunctorOnCCs(gif);
+      GraphInferenceFunctor gif {param_, debug_lvl_, factorizations};
+      ibg.applyIndexedFunctorOnCCs(gif);
     }
     else
     {
       //TODO under construction
-      ExtendedGraphInferenceFunctor gif {param_};
-      ibg.applyFunctorOnCCs(gif);
+      ExtendedGraphInferenceFunctor gif {param_, factorizations};
+      ibg.applyIndexedFunctorOnCCs(gif);
     }
+    reportComponentStatistics_(factorizations);
 
     //uses the existing protein group nodes in the graph
     ibg.annotateIndistProteins(true);
   }
 
+  void BayesianProteinInferenceAlgorithm::reportComponentStatistics_(
+      const std::vector<ComponentFactorization>& factorizations) const
+  {
+    std::vector<Size> order;
+    double time_total = 0.0;
+    for (Size i = 0; i < factorizations.size(); ++i)
+    {
+      if (factorizations[i].initialized)
+      {
+        order.push_back(i);
+        time_total += factorizations[i].time_total;
+      }
+    }
+    if (order.empty()) return;
+
+    std::stable_sort(order.begin(), order.end(), [&factorizations](Size a, Size b)
+        { return factorizations[a].time_total > factorizations[b].time_total; });
+
+    // with debug level > 1 report every component, otherwise only the most expensive ones
+    Size nr_reported = debug_lvl_ > 1 ? order.size() : std::min(order.size(), Size(10));
+    OPENMS_LOG_INFO << "Inference on " << order.size() << " connected components took " << time_total
+                    << " s (wall time summed over all threads and parameter sets). Most expensive components:" << std::endl;
+    OPENMS_LOG_INFO << "cc\t#vertices\t#edges\t#messages\test. table memory (kB)\ttime last (s)\ttime all params (s)" << std::endl;
+    for (Size k = 0; k < nr_reported; ++k)
+    {
+      const ComponentFactorization& f = factorizations[order[k]];
+      OPENMS_LOG_INFO << order[k] << "\t" << f.nr_vertices << "\t" << f.nr_edges << "\t" << f.nr_messages << "\t"
+                      << (f.nr_table_entries * sizeof(double)) / 1024.0 << "\t" << f.time_last << "\t" << f.time_total << std::endl;
+    }
+  }
+
   GridSearch<double,double,double> BayesianProteinInferenceAlgorithm::initGridSearchFromParams_(
       vector<double>& alpha_search,
       vector<double>& beta_search,
@@ -912,8 +1070,19 @@ namespace OpenMS
     OPENMS_LOG_INFO << "Peptide FDR AUC before protein inference: " << pepFDR.rocN(peptideIDs, 0, proteinIDs[0].getIdentifier()) << std::endl;
 
     setScoreTypeAndSettings_(proteinIDs[0]);
-    IDBoostGraph ibg(proteinIDs[0], peptideIDs, nr_top_psms, use_run_info, exp_des);
-    inferPosteriorProbabilities_(ibg);
+    if (use_run_info)
+    {
+      IDBoostGraph ibg(proteinIDs[0], peptideIDs, nr_top_psms, use_run_info, exp_des);
+      inferPosteriorProbabilities_(ibg);
+    }
+    else
+    {
+      // without run information, build the compact graph and create the components directly from it
+      IDCompactGraph icg(proteinIDs[0], peptideIDs, nr_top_psms);
+      icg.computeConnectedComponents();
+      IDBoostGraph ibg(proteinIDs[0], icg);
+      inferPosteriorProbabilities_(ibg);
+    }
 
     OPENMS_LOG_INFO << "Peptide FDR AUC after protein inference: " << pepFDR.rocN(peptideIDs, 0, proteinIDs[0].getIdentifier()) << std::endl;
   }
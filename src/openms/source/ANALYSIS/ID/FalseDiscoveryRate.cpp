@@ -37,6 +37,7 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 
 #include <algorithm>
+#include <cstring>
 #include <numeric>
 
 // #define FALSE_DISCOVERY_RATE_DEBUG
@@ -1053,40 +1054,119 @@ namespace OpenMS
 
   void FalseDiscoveryRate::applyBasic(std::vector<PeptideIdentification> & ids)
   {
+    if (ids.empty())
+    {
+      OPENMS_LOG_WARN << "No peptide identifications given to FalseDiscoveryRate! No calculation performed.\n";
+      return;
+    }
+
     bool q_value = !param_.getValue("no_qvalues").toBool();
     //TODO Check naming conventions. Ontology?
     const string& score_type = q_value ? "q-value" : "FDR";
 
     bool use_all_hits = param_.getValue("use_all_hits").toBool();
+    bool treat_runs_separately = param_.getValue("treat_runs_separately").toBool();
 
     //TODO this assumes all runs have the same ordering! Otherwise do it per identifier.
     bool higher_score_better(ids.begin()->isHigherScoreBetter());
 
-    //TODO not yet implemented
-    //bool treat_runs_separately = param_.getValue("treat_runs_separately").toBool();
+    //TODO split_charge_variants not yet implemented
 
-    ScoreToTgtDecLabelPairs scores_labels;
-    std::map<double,double> scores_to_FDR;
+    // indices of the peptide IDs belonging to each run (or a single group with all IDs)
+    std::vector<std::vector<Size>> runs;
+    if (treat_runs_separately)
+    {
+      std::map<String, Size> run_to_index;
+      for (Size i = 0; i < ids.size(); ++i)
+      {
+        auto it = run_to_index.insert(std::make_pair(ids[i].getIdentifier(), runs.size()));
+        if (it.second)
+        {
+          runs.emplace_back();
+        }
+        runs[it.first->second].push_back(i);
+      }
+    }
+    else
+    {
+      runs.emplace_back(ids.size());
+      std::iota(runs.back().begin(), runs.back().end(), 0);
+    }
+
+    // first pass: collect scores and target/decoy labels (no modification of the IDs yet, so that we can throw)
+    std::vector<std::vector<double>> run_scores(runs.size());
+    std::vector<std::vector<char>> run_labels(runs.size());
+    std::vector<char> run_missing_td(runs.size(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize r = 0; r < static_cast<SignedSize>(runs.size()); ++r)
+    {
+      std::vector<double>& scores = run_scores[r];
+      std::vector<char>& labels = run_labels[r];
+      for (Size id_idx : runs[r])
+      {
+        const std::vector<PeptideHit>& hits = ids[id_idx].getHits();
+        Size n_hits = use_all_hits ? hits.size() : std::min(hits.size(), Size(1));
+        for (Size h = 0; h < n_hits; ++h)
+        {
+          if (!hits[h].metaValueExists("target_decoy"))
+          {
+            run_missing_td[r] = 1;
+            break;
+          }
+          scores.push_back(hits[h].getScore());
+          labels.push_back(IDScoreGetterSetter::getTDLabel_(hits[h]));
+        }
+      }
+    }
 
-    std::vector<int> charges = {0};
-    std::vector<String> identifiers = {""};
-    // if charge states or separate runs: look ahead for possible values and add them to the vecs above
+    for (Size r = 0; r < runs.size(); ++r)
+    {
+      if (run_missing_td[r])
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Meta value 'target_decoy' does not exist in all PeptideHits! Reindex the idXML file with 'PeptideIndexer'");
+      }
+      if (run_scores[r].empty())
+      {
+        OPENMS_LOG_ERROR << "No scores for run " << (treat_runs_separately ? ids[runs[r][0]].getIdentifier() : String("")) << std::endl;
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No scores could be extracted!");
+      }
+    }
 
-    for (const String& identifier : identifiers)
+    // second pass: compute FDRs per run and write them back in collection order
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize r = 0; r < static_cast<SignedSize>(runs.size()); ++r)
     {
-      for (const int& charge : charges)
+      std::vector<double> fdrs, unique_scores, unique_fdrs;
+      calculateFDRBasicFlat_(run_scores[r], run_labels[r], fdrs, unique_scores, unique_fdrs, q_value, higher_score_better);
+      // release the input arrays early, they are not needed anymore
+      std::vector<double>().swap(run_scores[r]);
+      std::vector<char>().swap(run_labels[r]);
+
+      Size k = 0;
+      for (Size id_idx : runs[r])
       {
-        //TODO setScores also should have a filter mechanism!!
-        IDScoreGetterSetter::getScores_(scores_labels, ids, use_all_hits, charge, identifier);
-        if (scores_labels.empty())
+        PeptideIdentification& id = ids[id_idx];
+        String old_score_type = IDScoreGetterSetter::setScoreType_(id, score_type, false);
+        std::vector<PeptideHit>& hits = id.getHits();
+        for (Size h = 0; h < hits.size(); ++h)
         {
-         OPENMS_LOG_ERROR << "No scores for run " << identifier << " and charge " << charge << std::endl;
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No scores could be extracted!");
+          double score = hits[h].getScore();
+          hits[h].setMetaValue(old_score_type, score);
+          if (use_all_hits || h == 0)
+          {
+            hits[h].setScore(fdrs[k++]);
+          }
+          else // not part of the calculation, take the value of the next higher score (like map::lower_bound)
+          {
+            Size pos = std::lower_bound(unique_scores.begin(), unique_scores.end(), score) - unique_scores.begin();
+            hits[h].setScore(unique_fdrs[std::min(pos, unique_fdrs.size() - 1)]);
+          }
         }
-        calculateFDRBasic_(scores_to_FDR, scores_labels, q_value, higher_score_better);
-        if (!scores_labels.empty())
-          IDScoreGetterSetter::setScores_(scores_to_FDR, ids, score_type, false);
-        scores_to_FDR.clear();
       }
     }
   }
@@ -1329,77 +1409,148 @@ namespace OpenMS
       bool qvalue,
       bool higher_score_better) const
   {
-    //TODO put in separate function to avoid ifs in iteration
-    bool conservative = param_.getValue("conservative").toBool();
     if (scores_labels.empty())
     {
      OPENMS_LOG_WARN << "Warning: No scores extracted for FDR calculation. Skipping. Do you have target-decoy annotated Hits?" << std::endl;
       return;
     }
 
-    if (higher_score_better)
-    { // decreasing
-      std::sort(scores_labels.rbegin(), scores_labels.rend());
-    }
-    else
-    { // increasing
-      std::sort(scores_labels.begin(), scores_labels.end());
+    std::vector<double> scores;
+    std::vector<char> is_target;
+    scores.reserve(scores_labels.size());
+    is_target.reserve(scores_labels.size());
+    for (const auto& sl : scores_labels)
+    {
+      scores.push_back(sl.first);
+      is_target.push_back(sl.second);
     }
 
-    //uniquify scores and add decoy proportions
-    size_t decoys = 0;
-    double last_score = scores_labels[0].first;
+    std::vector<double> fdrs, unique_scores, unique_fdrs;
+    calculateFDRBasicFlat_(scores, is_target, fdrs, unique_scores, unique_fdrs, qvalue, higher_score_better);
 
-    size_t j = 0;
-    for (; j < scores_labels.size(); ++j)
+    // unique scores are increasing, so every insertion happens at the end
+    for (Size i = 0; i < unique_scores.size(); ++i)
     {
-      //TODO think about double comparison here, but an equal should actually be fine here.
-      if (scores_labels[j].first != last_score)
-      {
-        #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        std::cerr << "Recording score: " << last_score << " with " << decoys << " decoys at index+1 = " << (j+1) << " -> fdr: " << decoys/(j+1.0) << std::endl;
-        #endif
-        //we are using the conservative formula (Decoy + 1) / (Tgts)
-        if (conservative)
-        {
-          scores_to_FDR[last_score] = (decoys+1.0)/(j+1.0-decoys);
-        }
-        else
-        {
-          scores_to_FDR[last_score] = (decoys+1.0)/(j+1.0);
-        }
+      scores_to_FDR.emplace_hint(scores_to_FDR.end(), unique_scores[i], unique_fdrs[i]);
+    }
+  }
 
-        last_score = scores_labels[j].first;
+  void FalseDiscoveryRate::calculateFDRBasicFlat_(
+      const std::vector<double>& scores,
+      const std::vector<char>& is_target,
+      std::vector<double>& fdrs,
+      std::vector<double>& unique_scores,
+      std::vector<double>& unique_fdrs,
+      bool qvalue,
+      bool higher_score_better) const
+  {
+    bool conservative = param_.getValue("conservative").toBool();
+    const Size n = scores.size();
+    fdrs.assign(n, 0.0);
+    unique_scores.clear();
+    unique_fdrs.clear();
+    if (n == 0) return;
+
+    // map the scores onto unsigned integers with the same ordering (flip all bits of negative numbers,
+    // only the sign bit of positive ones); the best score gets the smallest key
+    std::vector<UInt64> keys(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      double d = scores[i] == 0.0 ? 0.0 : scores[i]; // -0.0 == 0.0
+      UInt64 bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      bits = (bits >> 63) ? ~bits : (bits | (UInt64(1) << 63));
+      keys[i] = higher_score_better ? ~bits : bits;
+    }
+
+    std::vector<Size> perm;
+    radixSortPermutation_(keys, perm);
+
+    // best-first scan over groups of equal scores: FDR of a group uses the counts up to and including the group
+    // (conservative: (D+1)/(T+1), otherwise (D+1)/(T+D+1))
+    std::vector<Size> group_end; // exclusive end of each group in perm
+    Size decoys = 0;
+    for (Size j = 0; j < n; )
+    {
+      const UInt64 key = keys[perm[j]];
+      const double score = scores[perm[j]];
+      for (; j < n && keys[perm[j]] == key; ++j)
+      {
+        decoys += !is_target[perm[j]];
       }
+      unique_scores.push_back(score);
+      unique_fdrs.push_back(conservative ? (decoys + 1.0) / (j + 1.0 - decoys) : (decoys + 1.0) / (j + 1.0));
+      group_end.push_back(j);
+    }
 
-      if (!scores_labels[j].second)
+    // bring the distinct scores into increasing order
+    if (higher_score_better)
+    {
+      std::reverse(unique_scores.begin(), unique_scores.end());
+      std::reverse(unique_fdrs.begin(), unique_fdrs.end());
+    }
+
+    if (qvalue) // apply a cumulative minimum (from low to high scores)
+    {
+      double cummin = 1.0;
+      for (double& fdr : unique_fdrs)
       {
-        decoys++;
+        cummin = std::min(fdr, cummin);
+        fdr = cummin;
       }
     }
 
-    // in case there is only one score and generally to include the last score, I guess we need to do this
-    if (conservative)
+    // scatter the group values back to the input order
+    const Size n_groups = group_end.size();
+    Size begin = 0;
+    for (Size g = 0; g < n_groups; ++g)
     {
-      scores_to_FDR[last_score] = (decoys+1.0)/(j+1.0-decoys);
+      const double fdr = unique_fdrs[higher_score_better ? n_groups - 1 - g : g];
+      for (Size j = begin; j < group_end[g]; ++j)
+      {
+        fdrs[perm[j]] = fdr;
+      }
+      begin = group_end[g];
     }
-    else
+  }
+
+  void FalseDiscoveryRate::radixSortPermutation_(const std::vector<UInt64>& keys, std::vector<Size>& perm)
+  {
+    const Size n = keys.size();
+    perm.resize(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    if (n < 2) return;
+
+    // histograms for all eight byte positions in one sweep
+    std::vector<Size> counts(8 * 256, 0);
+    for (UInt64 key : keys)
     {
-      scores_to_FDR[last_score] = (decoys+1.0)/(j+1.0);
+      for (Size b = 0; b < 8; ++b)
+      {
+        ++counts[b * 256 + ((key >> (8 * b)) & 0xFF)];
+      }
     }
 
-    if (qvalue) //apply a cumulative minimum on the map (from low to high fdrs)
+    std::vector<Size> buffer(n);
+    for (Size b = 0; b < 8; ++b)
     {
-      double cummin = 1.0;
+      Size* count = &counts[b * 256];
+      // all keys share this byte (common for the high bytes of similar doubles): nothing to do
+      if (count[(keys[0] >> (8 * b)) & 0xFF] == n) continue;
 
-      for (auto&& rit = scores_to_FDR.begin(); rit != scores_to_FDR.end(); ++rit)
+      Size offset = 0;
+      for (Size d = 0; d < 256; ++d)
+      {
+        Size c = count[d];
+        count[d] = offset;
+        offset += c;
+      }
+      for (Size i = 0; i < n; ++i)
       {
-        #ifdef FALSE_DISCOVERY_RATE_DEBUG
-        std::cerr << "Comparing " << rit->second << " to " << cummin << std::endl;
-        #endif
-        cummin = std::min(rit->second, cummin);
-        rit->second = cummin;
+        Size idx = perm[i];
+        buffer[count[(keys[idx] >> (8 * b)) & 0xFF]++] = idx;
       }
+      perm.swap(buffer);
     }
   }
 
@@ -43,6 +43,7 @@
 #include <boost/graph/graph_utility.hpp>
 #include <boost/graph/connected_components.hpp>
 
+#include <numeric>
 #include <ostream>
 #ifdef _OPENMP
 #include <omp.h>
@@ -172,6 +173,51 @@ namespace OpenMS
     }
   }
 
+  IDBoostGraph::IDBoostGraph(ProteinIdentification& proteins,
+                             const IDCompactGraph& compact_graph):
+      protIDs_(proteins)
+  {
+    if (compact_graph.getNrConnectedComponents() == 0 && compact_graph.getNrNodes() > 0)
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Connected components of the compact graph have to be computed first.");
+    }
+
+    ccs_.resize(compact_graph.getNrConnectedComponents());
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < static_cast<int>(ccs_.size()); ++i)
+    {
+      Graph& cc = ccs_[i];
+      IDCompactGraph::NodeRange nodes = compact_graph.getComponent(i);
+      // nodes are sorted, so the vertex of a node is its position in the range (PSMs come first)
+      for (const IDCompactGraph::Node* n = nodes.first; n != nodes.second; ++n)
+      {
+        if (compact_graph.isProtein(*n))
+        {
+          boost::add_vertex(IDPointer(compact_graph.getProtein(*n)), cc);
+        }
+        else
+        {
+          boost::add_vertex(IDPointer(compact_graph.getPSM(*n)), cc);
+        }
+      }
+      for (const IDCompactGraph::Node* n = nodes.first; n != nodes.second && !compact_graph.isProtein(*n); ++n)
+      {
+        vertex_t pepV = static_cast<vertex_t>(n - nodes.first);
+        IDCompactGraph::NodeRange prots = compact_graph.getNeighbors(*n);
+        for (const IDCompactGraph::Node* p = prots.first; p != prots.second; ++p)
+        {
+          vertex_t protV = static_cast<vertex_t>(std::lower_bound(nodes.first, nodes.second, *p) - nodes.first);
+          boost::add_edge(protV, pepV, cc);
+        }
+      }
+    }
+    OPENMS_LOG_INFO << "Created " << ccs_.size() << " connected components." << std::endl;
+    #ifdef INFERENCE_BENCH
+    sizes_and_times_.resize(ccs_.size());
+    #endif
+  }
+
   unordered_map<unsigned, unsigned> convertMapLabelFree_(
       const map<pair<String, unsigned>, unsigned>& fileToRun,
       const StringList& files)
@@ -600,17 +646,42 @@ namespace OpenMS
   }*/
 
 
+  std::vector<Size> IDBoostGraph::getCCsLargestFirst_() const
+  {
+    std::vector<Size> order(ccs_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [this](Size a, Size b)
+        {
+          Size ea = boost::num_edges(ccs_[a]);
+          Size eb = boost::num_edges(ccs_[b]);
+          return ea != eb ? ea > eb : boost::num_vertices(ccs_[a]) > boost::num_vertices(ccs_[b]);
+        });
+    return order;
+  }
+
   /// Do sth on ccs
   void IDBoostGraph::applyFunctorOnCCs(const std::function<unsigned long(Graph&)>& functor)
+  {
+    applyIndexedFunctorOnCCs([&functor](Graph& cc, Size /*cc_index*/) { return functor(cc); });
+  }
+
+  /// Do sth on ccs, passing the index of the cc
+  void IDBoostGraph::applyIndexedFunctorOnCCs(const std::function<unsigned long(Graph&, Size)>& functor)
   {
     if (ccs_.empty()) {
       throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No connected components annotated. Run computeConnectedComponents first!");
     }
 
-    // Use dynamic schedule because big CCs take much longer!
-    #pragma omp parallel for schedule(dynamic)
-    for (int i = 0; i < static_cast<int>(ccs_.size()); i += 1)
+    // Big CCs take much longer: start with them and hand out the rest dynamically,
+    // so that a single huge CC does not end up as the last task of one thread.
+    const std::vector<Size> order = getCCsLargestFirst_();
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < static_cast<int>(order.size()); k += 1)
     {
+      const Size i = order[k];
+
       #ifdef INFERENCE_BENCH
       StopWatch sw;
       sw.start();
@@ -630,9 +701,9 @@ namespace OpenMS
       #endif
 
       #ifdef INFERENCE_BENCH
-      unsigned long result = functor(curr_cc);
+      unsigned long result = functor(curr_cc, i);
       #else
-      functor(curr_cc);
+      functor(curr_cc, i);
       #endif
 
 
@@ -1538,6 +1609,11 @@ namespace OpenMS
   //TODO we should probably rename it to splitCC now. Add logging and timing?
   void IDBoostGraph::computeConnectedComponents()
   {
+    if (boost::num_vertices(g) == 0 && !ccs_.empty())
+    {
+      // already split, e.g. when created from an IDCompactGraph
+      return;
+    }
     auto vis = dfs_ccsplit_visitor(ccs_);
     boost::depth_first_search(g, visitor(vis));
    OPENMS_LOG_INFO << "Found " << ccs_.size() << " connected components." << std::endl;
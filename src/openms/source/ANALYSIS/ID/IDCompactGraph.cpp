@@ -0,0 +1,436 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2017.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/IDCompactGraph.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace Internal
+  {
+
+  IDCompactGraph::IDCompactGraph(ProteinIdentification& proteins,
+                                 std::vector<PeptideIdentification>& idedSpectra,
+                                 Size use_top_psms):
+    protIDs_(proteins)
+  {
+    const unordered_map<string, Size> accession_map = buildAccessionMap_(proteins);
+    vector<pair<Node, Node>> edges;
+    Size nr_unknown(0);
+
+    ProgressLogger pl;
+    pl.setLogType(ProgressLogger::CMD);
+    pl.startProgress(0, idedSpectra.size(), "Building graph...");
+    const String& protRun = proteins.getIdentifier();
+    for (auto& spectrum : idedSpectra)
+    {
+      if (spectrum.getIdentifier() == protRun)
+      {
+        addPeptideID_(spectrum, accession_map, use_top_psms, edges, nr_unknown);
+      }
+      pl.nextProgress();
+    }
+    pl.endProgress();
+
+    if (nr_unknown > 0)
+    {
+      OPENMS_LOG_WARN << "Warning: Building graph: skipped " << nr_unknown << " references of PSMs to non existent protein accessions." << std::endl;
+    }
+    buildCSR_(edges);
+  }
+
+  IDCompactGraph::IDCompactGraph(ProteinIdentification& proteins,
+                                 ConsensusMap& cmap,
+                                 Size use_top_psms,
+                                 bool use_unassigned_ids):
+    protIDs_(proteins)
+  {
+    const unordered_map<string, Size> accession_map = buildAccessionMap_(proteins);
+    vector<pair<Node, Node>> edges;
+    Size nr_unknown(0);
+
+    ProgressLogger pl;
+    Size roughNrIds = cmap.size();
+    if (use_unassigned_ids) roughNrIds += cmap.getUnassignedPeptideIdentifications().size();
+    pl.setLogType(ProgressLogger::CMD);
+    pl.startProgress(0, roughNrIds, "Building graph...");
+    const String& protRun = proteins.getIdentifier();
+    for (auto& feature : cmap)
+    {
+      for (auto& id : feature.getPeptideIdentifications())
+      {
+        if (id.getIdentifier() == protRun)
+        {
+          addPeptideID_(id, accession_map, use_top_psms, edges, nr_unknown);
+        }
+      }
+      pl.nextProgress();
+    }
+    if (use_unassigned_ids)
+    {
+      for (auto& id : cmap.getUnassignedPeptideIdentifications())
+      {
+        if (id.getIdentifier() == protRun)
+        {
+          addPeptideID_(id, accession_map, use_top_psms, edges, nr_unknown);
+        }
+        pl.nextProgress();
+      }
+    }
+    pl.endProgress();
+
+    if (nr_unknown > 0)
+    {
+      OPENMS_LOG_WARN << "Warning: Building graph: skipped " << nr_unknown << " references of PSMs to non existent protein accessions." << std::endl;
+    }
+    buildCSR_(edges);
+  }
+
+  unordered_map<string, Size> IDCompactGraph::buildAccessionMap_(ProteinIdentification& proteins)
+  {
+    unordered_map<string, Size> accession_map;
+    accession_map.reserve(proteins.getHits().size());
+    for (Size i = 0; i < proteins.getHits().size(); ++i)
+    {
+      // same as in IDBoostGraph: the last hit wins for duplicated accessions
+      accession_map[proteins.getHits()[i].getAccession()] = i;
+    }
+    return accession_map;
+  }
+
+  void IDCompactGraph::addPeptideID_(PeptideIdentification& spectrum,
+                                     const unordered_map<string, Size>& accession_map,
+                                     Size use_top_psms,
+                                     vector<pair<Node, Node>>& edges,
+                                     Size& nr_unknown_accessions)
+  {
+    vector<PeptideHit>& hits = spectrum.getHits();
+    Size nr_hits = (use_top_psms == 0 || hits.size() <= use_top_psms) ? hits.size() : use_top_psms;
+    for (Size h = 0; h < nr_hits; ++h)
+    {
+      Node psm = static_cast<Node>(psms_.size());
+      psms_.push_back(&hits[h]);
+      for (const auto& acc : hits[h].extractProteinAccessionsSet())
+      {
+        auto it = accession_map.find(acc);
+        if (it == accession_map.end())
+        {
+          ++nr_unknown_accessions;
+          continue;
+        }
+        // the protein index is turned into a node id as soon as the number of PSMs is known
+        edges.emplace_back(psm, static_cast<Node>(it->second));
+      }
+    }
+  }
+
+  void IDCompactGraph::buildCSR_(const vector<pair<Node, Node>>& edges)
+  {
+    const Size nr_psms = psms_.size();
+    const Size nr_nodes = nr_psms + protIDs_.getHits().size();
+    if (nr_nodes >= static_cast<Size>(numeric_limits<Node>::max()))
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, nr_nodes);
+    }
+
+    // count degrees, then prefix sums
+    offsets_.assign(nr_nodes + 1, 0);
+    for (const auto& e : edges)
+    {
+      ++offsets_[e.first + 1];
+      ++offsets_[nr_psms + e.second + 1];
+    }
+    for (Size n = 0; n < nr_nodes; ++n)
+    {
+      offsets_[n + 1] += offsets_[n];
+    }
+
+    // scatter. Edges come ordered by PSM, so the PSM lists of the proteins end up sorted already.
+    adjacency_.resize(offsets_.back());
+    vector<Size> pos(offsets_.begin(), offsets_.end() - 1);
+    for (const auto& e : edges)
+    {
+      const Node prot = static_cast<Node>(nr_psms + e.second);
+      adjacency_[pos[e.first]++] = prot;
+      adjacency_[pos[prot]++] = e.first;
+    }
+    // protein lists of the PSMs are in accession order, sort them by node id
+    for (Size n = 0; n < nr_psms; ++n)
+    {
+      std::sort(adjacency_.begin() + offsets_[n], adjacency_.begin() + offsets_[n + 1]);
+    }
+  }
+
+  Size IDCompactGraph::getNrNodes() const
+  {
+    return offsets_.size() - 1;
+  }
+
+  Size IDCompactGraph::getNrPSMs() const
+  {
+    return psms_.size();
+  }
+
+  Size IDCompactGraph::getNrProteins() const
+  {
+    return getNrNodes() - psms_.size();
+  }
+
+  Size IDCompactGraph::getNrEdges() const
+  {
+    return adjacency_.size() / 2;
+  }
+
+  PeptideHit* IDCompactGraph::getPSM(Node n) const
+  {
+    return psms_.at(n);
+  }
+
+  ProteinHit* IDCompactGraph::getProtein(Node n) const
+  {
+    return &protIDs_.getHits().at(n - psms_.size());
+  }
+
+  IDCompactGraph::Node IDCompactGraph::getProteinNode(Size protein_index) const
+  {
+    return static_cast<Node>(psms_.size() + protein_index);
+  }
+
+  IDCompactGraph::NodeRange IDCompactGraph::getNeighbors(Node n) const
+  {
+    const Node* first = adjacency_.data();
+    return NodeRange(first + offsets_[n], first + offsets_[n + 1]);
+  }
+
+  void IDCompactGraph::computeConnectedComponents()
+  {
+    const Size nr_nodes = getNrNodes();
+    const Size nr_psms = psms_.size();
+
+    // union-find with the smallest node id as representative (path halving).
+    // Every component contains at least one PSM, hence its root is its first PSM.
+    vector<Node> parent(nr_nodes);
+    for (Size n = 0; n < nr_nodes; ++n) parent[n] = static_cast<Node>(n);
+    auto find = [&parent](Node x)
+    {
+      while (parent[x] != x)
+      {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+      }
+      return x;
+    };
+    for (Size p = 0; p < nr_psms; ++p)
+    {
+      for (Size e = offsets_[p]; e < offsets_[p + 1]; ++e)
+      {
+        Node a = find(static_cast<Node>(p));
+        Node b = find(adjacency_[e]);
+        if (a != b)
+        {
+          if (a < b) parent[b] = a; else parent[a] = b;
+        }
+      }
+    }
+
+    // label in node order: representatives are always visited before the other members
+    const UInt32 no_cc = numeric_limits<UInt32>::max();
+    cc_of_node_.assign(nr_nodes, no_cc);
+    UInt32 nr_ccs(0);
+    for (Size n = 0; n < nr_nodes; ++n)
+    {
+      if (n >= nr_psms && offsets_[n] == offsets_[n + 1]) continue; // protein without PSMs
+      Node root = find(static_cast<Node>(n));
+      cc_of_node_[n] = (root == n) ? nr_ccs++ : cc_of_node_[root];
+    }
+
+    // components as CSR over the node ids
+    cc_offsets_.assign(nr_ccs + 1, 0);
+    for (Size n = 0; n < nr_nodes; ++n)
+    {
+      if (cc_of_node_[n] != no_cc) ++cc_offsets_[cc_of_node_[n] + 1];
+    }
+    for (Size c = 0; c < nr_ccs; ++c)
+    {
+      cc_offsets_[c + 1] += cc_offsets_[c];
+    }
+    cc_nodes_.resize(cc_offsets_.back());
+    vector<Size> pos(cc_offsets_.begin(), cc_offsets_.end() - 1);
+    for (Size n = 0; n < nr_nodes; ++n)
+    {
+      if (cc_of_node_[n] != no_cc) cc_nodes_[pos[cc_of_node_[n]]++] = static_cast<Node>(n);
+    }
+
+    // keep the no_cc label consistent with getNrConnectedComponents()
+    for (auto& c : cc_of_node_)
+    {
+      if (c == no_cc) c = nr_ccs;
+    }
+    OPENMS_LOG_INFO << "Found " << nr_ccs << " connected components." << std::endl;
+  }
+
+  Size IDCompactGraph::getNrConnectedComponents() const
+  {
+    return cc_offsets_.empty() ? 0 : cc_offsets_.size() - 1;
+  }
+
+  IDCompactGraph::NodeRange IDCompactGraph::getComponent(Size cc) const
+  {
+    if (cc >= getNrConnectedComponents())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, cc, getNrConnectedComponents());
+    }
+    const Node* first = cc_nodes_.data();
+    return NodeRange(first + cc_offsets_[cc], first + cc_offsets_[cc + 1]);
+  }
+
+  Size IDCompactGraph::getNrEdgesInComponent(Size cc) const
+  {
+    Size nr_edges(0);
+    NodeRange nodes = getComponent(cc);
+    for (const Node* n = nodes.first; n != nodes.second && !isProtein(*n); ++n)
+    {
+      nr_edges += offsets_[*n + 1] - offsets_[*n];
+    }
+    return nr_edges;
+  }
+
+  Size IDCompactGraph::getComponentOf(Node n) const
+  {
+    if (cc_of_node_.empty())
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Connected components not computed yet.");
+    }
+    return cc_of_node_.at(n);
+  }
+
+  void IDCompactGraph::calculateAndAnnotateIndistProteins(bool addSingletons)
+  {
+    if (getNrNodes() == 0)
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Graph empty. Build it first.");
+    }
+    if (cc_offsets_.empty())
+    {
+      computeConnectedComponents();
+    }
+
+    const Size nr_ccs = getNrConnectedComponents();
+    vector<vector<ProteinIdentification::ProteinGroup>> groups_per_cc(nr_ccs);
+
+    ProgressLogger pl;
+    pl.setLogType(ProgressLogger::CMD);
+    pl.startProgress(0, nr_ccs, "Annotating indistinguishable proteins...");
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < static_cast<int>(nr_ccs); ++i)
+    {
+      calculateIndistProteins_(i, addSingletons, groups_per_cc[i]);
+      pl.setProgress(i);
+    }
+    pl.endProgress();
+
+    // append single threaded in the order of the components, so the result is deterministic
+    vector<ProteinIdentification::ProteinGroup>& indist = protIDs_.getIndistinguishableProteins();
+    for (auto& groups : groups_per_cc)
+    {
+      for (auto& pg : groups)
+      {
+        indist.push_back(std::move(pg));
+      }
+    }
+  }
+
+  void IDCompactGraph::calculateIndistProteins_(Size cc, bool addSingletons, vector<ProteinIdentification::ProteinGroup>& groups) const
+  {
+    NodeRange nodes = getComponent(cc);
+    // nodes are sorted by id, so the proteins are at the end
+    const Node* prot_begin = std::find_if(nodes.first, nodes.second, [this](Node n) { return isProtein(n); });
+    vector<Node> prots(prot_begin, nodes.second);
+
+    // sort the proteins by their (sorted) PSM lists, identical lists become adjacent
+    std::stable_sort(prots.begin(), prots.end(), [this](Node a, Node b)
+    {
+      NodeRange na = getNeighbors(a);
+      NodeRange nb = getNeighbors(b);
+      return std::lexicographical_compare(na.first, na.second, nb.first, nb.second);
+    });
+
+    Size group_start(0);
+    while (group_start < prots.size())
+    {
+      NodeRange first_peps = getNeighbors(prots[group_start]);
+      Size group_end = group_start + 1;
+      while (group_end < prots.size())
+      {
+        NodeRange peps = getNeighbors(prots[group_end]);
+        if ((peps.second - peps.first) != (first_peps.second - first_peps.first) ||
+            !std::equal(peps.first, peps.second, first_peps.first))
+        {
+          break;
+        }
+        ++group_end;
+      }
+
+      if (group_end - group_start > 1 || addSingletons)
+      {
+        ProteinIdentification::ProteinGroup pg{};
+        // the group gets the max score of its members (see IDBoostGraph)
+        pg.probability = -1.0;
+        // report the members in their original order
+        std::sort(prots.begin() + group_start, prots.begin() + group_end);
+        for (Size p = group_start; p < group_end; ++p)
+        {
+          const ProteinHit* prot = getProtein(prots[p]);
+          pg.accessions.push_back(prot->getAccession());
+          pg.probability = std::max(pg.probability, static_cast<double>(prot->getScore()));
+        }
+        groups.push_back(std::move(pg));
+      }
+      group_start = group_end;
+    }
+  }
+
+  ProteinIdentification& IDCompactGraph::getProteinIDs()
+  {
+    return protIDs_;
+  }
+
+  } // namespace Internal
+} // namespace OpenMS
@@ -21,6 +21,7 @@ ConsensusMapMergerAlgorithm.cpp
 FalseDiscoveryRate.cpp
 HiddenMarkovModel.cpp
 IDBoostGraph.cpp
+IDCompactGraph.cpp
 IDConflictResolverAlgorithm.cpp
 IDMapper.cpp
 IDMergerAlgorithm.cpp
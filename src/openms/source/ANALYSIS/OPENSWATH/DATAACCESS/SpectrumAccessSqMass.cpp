@@ -34,82 +34,127 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>
 
-namespace OpenMS
-{
+#include <OpenMS/FORMAT/SqliteConnector.h>
 
-    /// Constructor
-  SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler) :
-      handler_(handler)
-    {}
+#include <sqlite3.h>
 
-    SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices) :
-      handler_(handler),
-      sidx_(indices)
-    {}
+#include <cmath>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
+namespace OpenMS
+{
 
-    SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices) :
-      handler_(sp.handler_)
+  struct SpectrumAccessSqMass::SpectrumIndex_
+  {
+    /// Meta data of each accessible spectrum (index is the spectrum id in the sqMass file)
+    std::vector<OpenSwath::SpectrumMeta> meta;
+    /// Retention times of the accessible spectra (sorted, spectra without retention time are left out)
+    std::vector<double> rt;
+    /// Accessible spectrum for each entry in rt
+    std::vector<Size> order;
+    /// Smallest accessible spectrum in order[i] up to order.back()
+    std::vector<Size> min_order;
+
+    /// Sort spectra by retention time (call after meta is populated)
+    void build(const std::vector<bool>& has_rt)
     {
-      if (indices.empty())
+      rt.clear(); order.clear(); min_order.clear();
+      for (Size k = 0; k < meta.size(); k++)
       {
-        sidx_ = sp.sidx_;
+        if (has_rt[k]) order.push_back(k);
       }
-      else if (sp.sidx_.empty())
+      const std::vector<OpenSwath::SpectrumMeta>& m = meta;
+      std::stable_sort(order.begin(), order.end(), [&m](Size a, Size b) { return m[a].RT < m[b].RT; });
+      rt.reserve(order.size());
+      for (Size k = 0; k < order.size(); k++) rt.push_back(meta[order[k]].RT);
+      min_order.resize(order.size());
+      for (Size k = order.size(); k > 0; k--)
       {
-        sidx_ = indices;
-      }
-      else
-      {
-        // we only want to select a subset of the currently selected indices
-        for (Size k = 0; k < indices.size(); k++)
-        {
-          if (indices[k] >= (int)sp.sidx_.size()) throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-              String("Error creating SpectrumAccessSqMass with an index ") + indices[k] + " that exceeds the number of available data " + sp.sidx_.size());
-          sidx_.push_back( sp.sidx_[ indices[k] ] );
-        }
+        min_order[k - 1] = (k == order.size()) ? order[k - 1] : std::min(order[k - 1], min_order[k]);
       }
     }
+  };
 
-    /// Destructor
-    SpectrumAccessSqMass::~SpectrumAccessSqMass() {}
-
-    /// Copy constructor
-    SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass & rhs) :
-      handler_(rhs.handler_),
-      sidx_(rhs.sidx_)
-    {
-    }
+  struct SpectrumAccessSqMass::SharedData_
+  {
+    explicit SharedData_(const String& f) :
+      filename(f),
+      cache_size(256)
+    {}
 
-    /// Light clone operator (actual data will not get copied)
-    boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessSqMass::lightClone() const
+    ~SharedData_()
     {
-      return boost::shared_ptr<SpectrumAccessSqMass>(new SpectrumAccessSqMass(*this));
+      // statements need to be finalized before their connections are closed
+      for (Size k = 0; k < statements.size(); k++) sqlite3_finalize(statements[k]);
     }
 
-    OpenSwath::SpectrumPtr SpectrumAccessSqMass::getSpectrumById(int id)
+    /// Read and decode a single spectrum (not cached)
+    OpenSwath::SpectrumPtr readSpectrum(int spec_id)
     {
-      std::vector<int> indices;
-      if (sidx_.empty())
+      // take an idle connection with its prepared statement or open a new one
+      boost::shared_ptr<SqliteConnector> conn;
+      sqlite3_stmt* stmt = nullptr;
       {
-        indices.push_back(id);
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (!connections.empty())
+        {
+          conn = connections.back(); connections.pop_back();
+          stmt = statements.back(); statements.pop_back();
+        }
       }
-      else
+      if (!conn)
       {
-        indices.push_back(sidx_[id]);
+        conn = boost::shared_ptr<SqliteConnector>(new SqliteConnector(filename));
+        SqliteConnector::executePreparedStatement(conn->getDB(), &stmt,
+          "SELECT DATA_TYPE, COMPRESSION, DATA FROM DATA WHERE SPECTRUM_ID = ?;");
       }
 
-      // read MSSpectra and prepare for conversion
-      std::vector<MSSpectrum> tmp_spectra;
-      handler_.readSpectra(tmp_spectra, indices, false);
-
-      const MSSpectrumType& spectrum = tmp_spectra[0];
       OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
       OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
-      for (MSSpectrumType::const_iterator it = spectrum.begin(); it != spectrum.end(); ++it)
+      int nr_arrays = 0;
+      try
       {
-        mz_array->data.push_back(it->getMZ());
-        intensity_array->data.push_back(it->getIntensity());
+        sqlite3_bind_int(stmt, 1, spec_id);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+          int data_type = sqlite3_column_int(stmt, 0);
+          int compression = sqlite3_column_int(stmt, 1);
+          const void* raw_data = sqlite3_column_blob(stmt, 2);
+          Size blob_bytes = sqlite3_column_bytes(stmt, 2);
+
+          // data_type is one of 0 = mz, 1 = int, 2 = rt
+          if (data_type == 0)
+          {
+            Internal::MzMLSqliteHandler::decodeBinaryData(raw_data, blob_bytes, compression, mz_array->data);
+          }
+          else if (data_type == 1)
+          {
+            Internal::MzMLSqliteHandler::decodeBinaryData(raw_data, blob_bytes, compression, intensity_array->data);
+          }
+          else
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "Found data type other than m/z/Intensity for spectra");
+          }
+          nr_arrays++;
+        }
+      }
+      catch (...)
+      {
+        sqlite3_reset(stmt);
+        releaseConnection(conn, stmt);
+        throw;
+      }
+      sqlite3_reset(stmt);
+      releaseConnection(conn, stmt);
+
+      if (nr_arrays < 2 || mz_array->data.size() != intensity_array->data.size())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            String("Spectrum ") + spec_id + " does not have 2 data arrays.");
       }
 
       OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
@@ -118,129 +163,327 @@ namespace OpenMS
       return sptr;
     }
 
-    OpenSwath::SpectrumMeta SpectrumAccessSqMass::getSpectrumMetaById(int id) const
+    /// Return a connection to the pool
+    void releaseConnection(const boost::shared_ptr<SqliteConnector>& conn, sqlite3_stmt* stmt)
     {
-      std::vector<int> indices;
-      if (sidx_.empty())
-      {
-        indices.push_back(id);
-      }
-      else
-      {
-        indices.push_back(sidx_[id]);
-      }
-
-      // read MSSpectra and prepare for conversion
-      std::vector<MSSpectrum> tmp_spectra;
-      handler_.readSpectra(tmp_spectra, indices, false);
-
-      const MSSpectrumType& spectrum = tmp_spectra[0];
-      OpenSwath::SpectrumMeta m;
-      m.id = spectrum.getNativeID();
-      m.RT = spectrum.getRT();
-      m.ms_level = spectrum.getMSLevel();
-      return m;
+      std::lock_guard<std::mutex> lock(pool_mutex);
+      connections.push_back(conn);
+      statements.push_back(stmt);
     }
 
-    void SpectrumAccessSqMass::getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra, std::vector< OpenSwath::SpectrumMeta > & spectra_meta) const
+    /// Copy the data arrays of a cached spectrum into a new spectrum
+    static OpenSwath::SpectrumPtr copySpectrum_(const OpenSwath::SpectrumPtr& cached_spectrum)
     {
-      // read MSSpectra and prepare for conversion
-      std::vector<MSSpectrum> tmp_spectra;
+      OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray(*cached_spectrum->getMZArray()));
+      OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray(*cached_spectrum->getIntensityArray()));
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->setMZArray(mz_array);
+      sptr->setIntensityArray(intensity_array);
+      return sptr;
+    }
 
-      if (sidx_.empty())
+    /**
+      @brief Return a spectrum from the cache or read it from the file
+
+      Callers may modify the returned spectrum (e.g. SpectrumAccessQuadMZTransforming
+      recalibrates the m/z array in place), so cached spectra are never handed
+      out directly: every call returns its own copy of the decoded arrays.
+    */
+    OpenSwath::SpectrumPtr getSpectrum(int spec_id)
+    {
       {
-        MSExperiment exp;
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        std::unordered_map<int, LRUList::iterator>::iterator it = cached.find(spec_id);
+        if (it != cached.end())
         {
-          handler_.readExperiment(exp, false);
+          lru.splice(lru.begin(), lru, it->second); // mark as most recently used
+          return copySpectrum_(it->second->second);
         }
+      }
+
+      // decode outside of the lock, other threads may read other spectra meanwhile
+      OpenSwath::SpectrumPtr sptr = readSpectrum(spec_id);
 
-        tmp_spectra = exp.getSpectra();
+      {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (cache_size == 0) return sptr;
+        if (cached.find(spec_id) == cached.end())
+        {
+          lru.push_front(std::make_pair(spec_id, sptr));
+          cached[spec_id] = lru.begin();
+          shrinkCache_();
+        }
       }
-      else
+      return copySpectrum_(sptr);
+    }
+
+    /// Remove least recently used spectra beyond the cache size (cache_mutex needs to be held)
+    void shrinkCache_()
+    {
+      while (lru.size() > cache_size)
       {
-        handler_.readSpectra(tmp_spectra, sidx_, false);
+        cached.erase(lru.back().first);
+        lru.pop_back();
       }
-      spectra.reserve(tmp_spectra.size());
-      spectra_meta.reserve(tmp_spectra.size());
-    
-      for (Size k = 0; k < tmp_spectra.size(); k++)
+    }
+
+    typedef std::list<std::pair<int, OpenSwath::SpectrumPtr> > LRUList;
+
+    String filename;
+
+    /// Idle connections and their prepared statements
+    std::mutex pool_mutex;
+    std::vector<boost::shared_ptr<SqliteConnector> > connections;
+    std::vector<sqlite3_stmt*> statements;
+
+    /// Decoded spectra, most recently used first
+    std::mutex cache_mutex;
+    Size cache_size;
+    LRUList lru;
+    std::unordered_map<int, LRUList::iterator> cached;
+  };
+
+  SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler) :
+    handler_(handler),
+    shared_(new SharedData_(handler.getFilename()))
+  {
+    buildIndex_();
+  }
+
+  SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices) :
+    handler_(handler),
+    sidx_(indices),
+    shared_(new SharedData_(handler.getFilename()))
+  {
+    buildIndex_();
+  }
+
+  SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices) :
+    handler_(sp.handler_),
+    shared_(sp.shared_)
+  {
+    if (indices.empty())
+    {
+      sidx_ = sp.sidx_;
+      index_ = sp.index_;
+      return;
+    }
+
+    for (Size k = 0; k < indices.size(); k++)
+    {
+      if (indices[k] < 0 || indices[k] >= (int)sp.getNrSpectra())
       {
-        const MSSpectrumType& spectrum = tmp_spectra[k];
-        OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
-        OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
-        for (MSSpectrumType::const_iterator it = spectrum.begin(); it != spectrum.end(); ++it)
-        {
-          mz_array->data.push_back(it->getMZ());
-          intensity_array->data.push_back(it->getIntensity());
-        }
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            String("Error creating SpectrumAccessSqMass with an index ") + indices[k] + " that exceeds the number of available data " + sp.getNrSpectra());
+      }
+    }
+
+    // we only want to select a subset of the currently selected indices
+    boost::shared_ptr<SpectrumIndex_> index(new SpectrumIndex_);
+    std::vector<bool> has_rt(indices.size(), false);
+    std::vector<bool> parent_has_rt(sp.index_->meta.size(), false);
+    for (Size k = 0; k < sp.index_->order.size(); k++) parent_has_rt[sp.index_->order[k]] = true;
+    for (Size k = 0; k < indices.size(); k++)
+    {
+      sidx_.push_back(sp.sidx_.empty() ? indices[k] : sp.sidx_[indices[k]]);
+      index->meta.push_back(sp.index_->meta[indices[k]]);
+      has_rt[k] = parent_has_rt[indices[k]];
+    }
+    index->build(has_rt);
+    index_ = index;
+  }
+
+  SpectrumAccessSqMass::~SpectrumAccessSqMass() {}
 
-        OpenSwath::SpectrumMeta m;
-        m.id = spectrum.getNativeID();
-        m.RT = spectrum.getRT();
-        m.ms_level = spectrum.getMSLevel();
-        spectra_meta.push_back(m);
+  SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass & rhs) :
+    handler_(rhs.handler_),
+    sidx_(rhs.sidx_),
+    index_(rhs.index_),
+    shared_(rhs.shared_)
+  {
+  }
 
-        OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
-        sptr->setMZArray(mz_array);
-        sptr->setIntensityArray(intensity_array);
-        spectra.push_back(sptr);
+  void SpectrumAccessSqMass::buildIndex_()
+  {
+    boost::shared_ptr<SpectrumIndex_> index(new SpectrumIndex_);
+    SqliteConnector conn(handler_.getFilename());
+
+    String select_sql = "SELECT ID, NATIVE_ID, MSLEVEL, RETENTION_TIME FROM SPECTRUM";
+    std::unordered_map<int, std::vector<Size> > positions; // spectrum id -> accessible spectra
+    if (sidx_.empty())
+    {
+      index->meta.resize(handler_.getNrSpectra());
+    }
+    else
+    {
+      index->meta.resize(sidx_.size());
+      String id_list;
+      for (Size k = 0; k < sidx_.size(); k++)
+      {
+        if (positions[sidx_[k]].empty()) id_list += (id_list.empty() ? "" : ",") + String(sidx_[k]);
+        positions[sidx_[k]].push_back(k);
       }
+      select_sql += " WHERE ID IN (" + id_list + ")";
     }
+    select_sql += ";";
 
-    std::vector<std::size_t> SpectrumAccessSqMass::getSpectraByRT(double RT, double deltaRT) const
+    std::vector<bool> has_rt(index->meta.size(), false);
+    std::vector<bool> found(index->meta.size(), false);
+    sqlite3_stmt* stmt;
+    conn.executePreparedStatement(&stmt, select_sql);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
     {
-      OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
-      std::vector<std::size_t> res = handler_.getSpectraIndicesbyRT(RT, deltaRT, sidx_);
+      OpenSwath::SpectrumMeta m;
+      m.index = sqlite3_column_int(stmt, 0);
+      m.id = String(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+      m.ms_level = sqlite3_column_type(stmt, 2) != SQLITE_NULL ? sqlite3_column_int(stmt, 2) : 1;
+      m.RT = sqlite3_column_type(stmt, 3) != SQLITE_NULL ? sqlite3_column_double(stmt, 3) : -1.0;
+      const bool rt_set = sqlite3_column_type(stmt, 3) != SQLITE_NULL;
 
       if (sidx_.empty())
       {
-        return res;
+        if (m.index >= index->meta.size()) continue; // not addressable by id
+        index->meta[m.index] = m;
+        has_rt[m.index] = rt_set;
+        found[m.index] = true;
       }
       else
       {
-        // we need to map the resulting indices back to the external indices
-        std::vector<std::size_t> res_mapped;
-        for (Size k = 0; k < res.size(); k++)
+        const std::vector<Size>& pos = positions[(int)m.index];
+        for (Size k = 0; k < pos.size(); k++)
         {
-          for (Size s_it = 0; s_it < sidx_.size(); s_it++)
-          {
-            if (res[k] == (size_t)sidx_[s_it]) {res_mapped.push_back(s_it);}
-          }
+          index->meta[pos[k]] = m;
+          has_rt[pos[k]] = rt_set;
+          found[pos[k]] = true;
         }
-        return res_mapped;
       }
     }
+    sqlite3_finalize(stmt);
 
-    size_t SpectrumAccessSqMass::getNrSpectra() const
+    if (!sidx_.empty() && std::find(found.begin(), found.end(), false) != found.end())
     {
-      size_t res;
-      if (sidx_.empty())
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          String("Illegal spectral indices detected for file of size ") + handler_.getNrSpectra());
+    }
+    index->build(has_rt);
+    index_ = index;
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessSqMass::lightClone() const
+  {
+    return boost::shared_ptr<SpectrumAccessSqMass>(new SpectrumAccessSqMass(*this));
+  }
+
+  void SpectrumAccessSqMass::setCacheSize(Size max_spectra)
+  {
+    std::lock_guard<std::mutex> lock(shared_->cache_mutex);
+    shared_->cache_size = max_spectra;
+    shared_->shrinkCache_();
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessSqMass::getSpectrumById(int id)
+  {
+    OPENMS_PRECONDITION(id >= 0 && id < (int)getNrSpectra(), "Spectrum index out of range")
+    return shared_->getSpectrum(sidx_.empty() ? id : sidx_[id]);
+  }
+
+  OpenSwath::SpectrumMeta SpectrumAccessSqMass::getSpectrumMetaById(int id) const
+  {
+    OPENMS_PRECONDITION(id >= 0 && id < (int)getNrSpectra(), "Spectrum index out of range")
+    return index_->meta[id];
+  }
+
+  void SpectrumAccessSqMass::getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra, std::vector< OpenSwath::SpectrumMeta > & spectra_meta) const
+  {
+    // read MSSpectra and prepare for conversion
+    std::vector<MSSpectrum> tmp_spectra;
+
+    if (sidx_.empty())
+    {
+      MSExperiment exp;
       {
-        res = handler_.getNrSpectra();
+        handler_.readExperiment(exp, false);
       }
-      else
+
+      tmp_spectra = exp.getSpectra();
+    }
+    else
+    {
+      handler_.readSpectra(tmp_spectra, sidx_, false);
+    }
+    spectra.reserve(tmp_spectra.size());
+    spectra_meta.reserve(tmp_spectra.size());
+  
+    for (Size k = 0; k < tmp_spectra.size(); k++)
+    {
+      const MSSpectrumType& spectrum = tmp_spectra[k];
+      OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
+      OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
+      for (MSSpectrumType::const_iterator it = spectrum.begin(); it != spectrum.end(); ++it)
       {
-        res = sidx_.size();
+        mz_array->data.push_back(it->getMZ());
+        intensity_array->data.push_back(it->getIntensity());
       }
-      return res;
-    }
 
-    OpenSwath::ChromatogramPtr SpectrumAccessSqMass::getChromatogramById(int /* id */)
-    {
-      throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
+      OpenSwath::SpectrumMeta m;
+      m.id = spectrum.getNativeID();
+      m.RT = spectrum.getRT();
+      m.ms_level = spectrum.getMSLevel();
+      spectra_meta.push_back(m);
+
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->setMZArray(mz_array);
+      sptr->setIntensityArray(intensity_array);
+      spectra.push_back(sptr);
     }
+  }
 
-    size_t SpectrumAccessSqMass::getNrChromatograms() const
+  std::vector<std::size_t> SpectrumAccessSqMass::getSpectraByRT(double RT, double deltaRT) const
+  {
+    OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
+    const SpectrumIndex_& index = *index_;
+    std::vector<std::size_t> result;
+    if (deltaRT > 0.0)
     {
-      size_t res;
-      // TODO: currently chrom indices are not supported
-      res = handler_.getNrChromatograms();
-      return res;
+      // all spectra with RT - deltaRT <= rt <= RT + deltaRT, in spectrum order
+      std::vector<double>::const_iterator first = std::lower_bound(index.rt.begin(), index.rt.end(), RT - deltaRT);
+      std::vector<double>::const_iterator last = std::upper_bound(first, index.rt.end(), RT + deltaRT);
+      for (std::vector<double>::const_iterator it = first; it != last; ++it)
+      {
+        result.push_back(index.order[it - index.rt.begin()]);
+      }
+      std::sort(result.begin(), result.end());
     }
-
-    std::string SpectrumAccessSqMass::getChromatogramNativeID(int /* id */) const
+    else
     {
-      throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
+      // only the first spectrum (in spectrum order) with rt >= RT
+      Size first = std::lower_bound(index.rt.begin(), index.rt.end(), RT) - index.rt.begin();
+      if (first < index.rt.size()) result.push_back(index.min_order[first]);
     }
+    return result;
+  }
+
+  size_t SpectrumAccessSqMass::getNrSpectra() const
+  {
+    return index_->meta.size();
+  }
+
+  OpenSwath::ChromatogramPtr SpectrumAccessSqMass::getChromatogramById(int /* id */)
+  {
+    throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
+  }
+
+  size_t SpectrumAccessSqMass::getNrChromatograms() const
+  {
+    size_t res;
+    // TODO: currently chrom indices are not supported
+    res = handler_.getNrChromatograms();
+    return res;
+  }
+
+  std::string SpectrumAccessSqMass::getChromatogramNativeID(int /* id */) const
+  {
+    throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
+  }
 
 } //end namespace OpenMS
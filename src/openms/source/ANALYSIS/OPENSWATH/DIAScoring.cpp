@@ -35,7 +35,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
 
 #include <OpenMS/CONCEPT/Constants.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternCache.h>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
@@ -118,6 +118,9 @@ namespace OpenMS
     dia_nr_isotopes_ = (int)param_.getValue("dia_nr_isotopes");
     dia_nr_charges_ = (int)param_.getValue("dia_nr_charges");
     peak_before_mono_max_ppm_diff_ = (double)param_.getValue("peak_before_mono_max_ppm_diff");
+
+    formula_isotopes_.reset(new CoarseIsotopePatternCache(Size(dia_nr_isotopes_)));
+    averagine_isotopes_.reset(new CoarseIsotopePatternCache(Size(dia_nr_isotopes_) + 1));
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -144,14 +147,23 @@ namespace OpenMS
     ppm_score = 0;
     ppm_score_weighted = 0;
     diff_ppm.clear();
+
+    // look up all transitions at once
+    std::vector<double> left(transitions.size()), right(transitions.size());
+    for (std::size_t k = 0; k < transitions.size(); k++)
+    {
+      left[k] = right[k] = transitions[k].getProductMZ();
+      DIAHelpers::adjustExtractionWindow(right[k], left[k], dia_extract_window_, dia_extraction_ppm_);
+    }
+    std::vector<double> mz_found, int_found;
+    integrateWindows(spectrum, left, right, mz_found, int_found, dia_centroided_);
+
     for (std::size_t k = 0; k < transitions.size(); k++)
     {
       const TransitionType& transition = transitions[k];
       // Calculate the difference of the theoretical mass and the actually measured mass
-      double left(transition.getProductMZ()), right(transition.getProductMZ());
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      double mz = mz_found[k];
+      bool signalFound = int_found[k] > 0;
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
@@ -207,21 +219,17 @@ namespace OpenMS
     // collect the potential isotopes of this peak
     double max_ratio;
     int nr_occurences;
-    std::vector<double> isotopes_int;
-    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-    {
-      double left  = precursor_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge_state);
-      double right = precursor_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge_state);
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      isotopes_int.push_back(intensity);
-    }
+    std::vector<double> left, right, mz, intensity;
+    getIsotopeWindows_(precursor_mz, static_cast<int>(charge_state), left, right);
+    const Size nr_isotopes = left.size();
+    getPreIsotopeWindows_(precursor_mz, left, right);
+    integrateWindows(spectrum, left, right, mz, intensity, dia_centroided_);
+    std::vector<double> isotopes_int(intensity.begin(), intensity.begin() + nr_isotopes);
 
     // calculate the scores:
     // isotope correlation (forward) and the isotope overlap (backward) scores
     isotope_corr = scoreIsotopePattern_(precursor_mz, isotopes_int, charge_state, sum_formula);
-    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, isotopes_int[0], nr_occurences, max_ratio);
+    largePeaksBeforeFirstIsotope_(mz.data() + nr_isotopes, intensity.data() + nr_isotopes, precursor_mz, isotopes_int[0], nr_occurences, max_ratio);
     isotope_overlap = max_ratio;
   }
 
@@ -233,33 +241,33 @@ namespace OpenMS
     yseries_score = 0;
     OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
 
-    double mz, intensity, left, right;
     std::vector<double> yseries, bseries;
     OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
-    for (Size it = 0; it < bseries.size(); it++)
-    {
-      left = bseries[it];
-      right = bseries[it];
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
 
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      double ppmdiff = std::fabs(bseries[it] - mz) * 1000000 / bseries[it];
-      if (signalFound && ppmdiff < dia_byseries_ppm_diff_ && intensity > dia_byseries_intensity_min_)
-      {
-        bseries_score++;
-      }
-    }
-    for (Size it = 0; it < yseries.size(); it++)
+    // look up b and y ions at once (b ions first)
+    std::vector<double> ions(bseries);
+    ions.insert(ions.end(), yseries.begin(), yseries.end());
+    std::vector<double> left(ions), right(ions), mz, intensity;
+    for (Size it = 0; it < ions.size(); it++)
     {
-      left = yseries[it];
-      right = yseries[it];
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
+      DIAHelpers::adjustExtractionWindow(right[it], left[it], dia_extract_window_, dia_extraction_ppm_);
+    }
+    integrateWindows(spectrum, left, right, mz, intensity, dia_centroided_);
 
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      double ppmdiff = std::fabs(yseries[it] - mz) * 1000000 / yseries[it];
-      if (signalFound && ppmdiff < dia_byseries_ppm_diff_ && intensity > dia_byseries_intensity_min_)
+    for (Size it = 0; it < ions.size(); it++)
+    {
+      bool signalFound = intensity[it] > 0;
+      double ppmdiff = std::fabs(ions[it] - mz[it]) * 1000000 / ions[it];
+      if (signalFound && ppmdiff < dia_byseries_ppm_diff_ && intensity[it] > dia_byseries_intensity_min_)
       {
-        yseries_score++;
+        if (it < bseries.size())
+        {
+          bseries_score++;
+        }
+        else
+        {
+          yseries_score++;
+        }
       }
     }
   }
@@ -295,53 +303,77 @@ namespace OpenMS
     std::vector<double> isotopes_int;
     double max_ratio;
     int nr_occurences;
+
+    // collect the potential isotopes and the peaks before the first isotope
+    // of all transitions and look them up at once
+    std::vector<int> fragment_charges(transitions.size());
+    std::vector<Size> window_offsets(transitions.size() + 1, 0);
+    std::vector<double> left, right, mz, intensity;
+    Size nr_isotopes = 0;
     for (Size k = 0; k < transitions.size(); k++)
     {
-      isotopes_int.clear();
-      const String native_id = transitions[k].getNativeID();
-      double rel_intensity = intensities[native_id];
-
       // If no charge is given, we assume it to be 1
       int putative_fragment_charge = 1;
       if (transitions[k].fragment_charge > 0)
       {
         putative_fragment_charge = transitions[k].fragment_charge;
       }
+      fragment_charges[k] = putative_fragment_charge;
 
-      // collect the potential isotopes of this peak
-      for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-      {
-        double left = transitions[k].getProductMZ() +
-                        iso * C13C12_MASSDIFF_U / static_cast<double>(putative_fragment_charge);
-        double right = transitions[k].getProductMZ() +
-                        iso * C13C12_MASSDIFF_U / static_cast<double>(putative_fragment_charge);
-        DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-        double mz, intensity;
-        integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-        isotopes_int.push_back(intensity);
-      }
+      getIsotopeWindows_(transitions[k].getProductMZ(), putative_fragment_charge, left, right);
+      nr_isotopes = left.size() - window_offsets[k];
+      getPreIsotopeWindows_(transitions[k].getProductMZ(), left, right);
+      window_offsets[k + 1] = left.size();
+    }
+    integrateWindows(spectrum, left, right, mz, intensity, dia_centroided_);
+
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      const String native_id = transitions[k].getNativeID();
+      double rel_intensity = intensities[native_id];
+      const Size offset = window_offsets[k];
+      isotopes_int.assign(intensity.begin() + offset, intensity.begin() + offset + nr_isotopes);
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, putative_fragment_charge);
+      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, fragment_charges[k]);
       isotope_corr += score * rel_intensity;
-      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
+      largePeaksBeforeFirstIsotope_(mz.data() + offset + nr_isotopes, intensity.data() + offset + nr_isotopes,
+                                    transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
     }
   }
 
-  void DIAScoring::largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurences, double& max_ratio)
+  void DIAScoring::getIsotopeWindows_(double mono_mz, int charge, std::vector<double>& left, std::vector<double>& right) const
+  {
+    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
+    {
+      left.push_back(mono_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge));
+      right.push_back(mono_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge));
+      DIAHelpers::adjustExtractionWindow(right.back(), left.back(), dia_extract_window_, dia_extraction_ppm_);
+    }
+  }
+
+  void DIAScoring::getPreIsotopeWindows_(double mono_mz, std::vector<double>& left, std::vector<double>& right) const
+  {
+    for (int ch = 1; ch <= dia_nr_charges_; ++ch)
+    {
+      left.push_back(mono_mz  - C13C12_MASSDIFF_U / (double) ch);
+      right.push_back(mono_mz - C13C12_MASSDIFF_U / (double) ch);
+      DIAHelpers::adjustExtractionWindow(right.back(), left.back(), dia_extract_window_, dia_extraction_ppm_);
+    }
+  }
+
+  void DIAScoring::largePeaksBeforeFirstIsotope_(const double* pre_mz, const double* pre_int, double mono_mz, double mono_int, int& nr_occurences, double& max_ratio)
   {
-    double mz, intensity;
     nr_occurences = 0;
     max_ratio = 0.0;
 
     for (int ch = 1; ch <= dia_nr_charges_; ++ch)
     {
-      double left = mono_mz  - C13C12_MASSDIFF_U / (double) ch;
-      double right = mono_mz - C13C12_MASSDIFF_U / (double) ch;
-      DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      double mz = pre_mz[ch - 1];
+      double intensity = pre_int[ch - 1];
+      bool signalFound = intensity > 0;
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
@@ -393,13 +425,12 @@ namespace OpenMS
     {
       // create the theoretical distribution from the sum formula
       EmpiricalFormula empf(sum_formula);
-      isotope_dist = empf.getIsotopeDistribution(CoarseIsotopePatternGenerator(dia_nr_isotopes_));
+      isotope_dist = empf.getIsotopeDistribution(*formula_isotopes_);
     }
     else
     {
       // create the theoretical distribution from the peptide weight
-      CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
-      isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
+      isotope_dist = averagine_isotopes_->estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
     }
 
 
@@ -232,8 +232,11 @@ namespace OpenMS
     }
     trgroup_picker.setParameters(trgroup_picker_param);
 
+    // Pick all transition groups first so that the full spectrum (DIA)
+    // scores of all peak groups can be computed in one go
     Size progress = 0;
     startProgress(0, transition_group_map.size(), "picking peaks");
+    std::vector<MRMTransitionGroupType*> picked_groups;
     for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
     {
 
@@ -245,10 +248,16 @@ namespace OpenMS
       }
 
       trgroup_picker.pickTransitionGroup(transition_group);
-      scorePeakgroups(trgroup_it->second, trafo, swath_maps, output);
+      picked_groups.push_back(&transition_group);
     }
     endProgress();
 
+    precomputeDIAScores(picked_groups, swath_maps);
+    for (Size i = 0; i < picked_groups.size(); ++i)
+    {
+      scorePeakgroups(*picked_groups[i], trafo, swath_maps, output);
+    }
+
     //output.sortByPosition(); // if the exact same order is needed
     return;
   }
@@ -461,6 +470,83 @@ namespace OpenMS
     return idscores;
   }
 
+  void MRMFeatureFinderScoring::precomputeDIAScores(const std::vector<MRMTransitionGroupType*>& transition_groups,
+                                                    const std::vector<OpenSwath::SwathMap>& swath_maps)
+  {
+    precomputed_dia_scores_.clear();
+    bool swath_present = (!swath_maps.empty() && swath_maps[0].sptr->getNrSpectra() > 0);
+    if (!swath_present || !su_.use_dia_scores_)
+    {
+      return;
+    }
+
+    // collect the peak groups of all transition groups, using the same
+    // (detecting) transitions and drift time window as scorePeakgroups
+    std::vector<std::vector<TransitionType> > detecting_transitions(transition_groups.size());
+    std::vector<boost::shared_ptr<OpenSwath::IMRMFeature> > imrmfeatures;
+    std::vector<OpenSwathScoring::DIAScoringTask> tasks;
+    std::vector<Size> task_groups;
+    for (Size g = 0; g < transition_groups.size(); ++g)
+    {
+      MRMTransitionGroupType& transition_group = *transition_groups[g];
+      std::map<OpenMS::String, const PeptideType*>::const_iterator pep_it = PeptideRefMap_.find(transition_group.getTransitionGroupID());
+      if (pep_it == PeptideRefMap_.end() || transition_group.getFeatures().empty()) {continue;}
+
+      const MSChromatogram* drift_chrom = nullptr;
+      for (const TransitionType& tr : transition_group.getTransitions())
+      {
+        if (!tr.isDetectingTransition()) {continue;}
+        detecting_transitions[g].push_back(tr);
+        if (drift_chrom == nullptr && transition_group.hasChromatogram(tr.getNativeID()))
+        {
+          drift_chrom = &transition_group.getChromatogram(tr.getNativeID());
+        }
+      }
+      if (detecting_transitions[g].empty()) {continue;}
+      if (detecting_transitions[g].size() == transition_group.getTransitions().size() && !transition_group.getChromatograms().empty())
+      {
+        drift_chrom = &transition_group.getChromatograms()[0]; // scorePeakgroups uses a copy of the group
+      }
+      if (drift_chrom == nullptr && !transition_group.getPrecursorChromatograms().empty())
+      {
+        drift_chrom = &transition_group.getPrecursorChromatograms()[0];
+      }
+      double drift_lower(0), drift_upper(0);
+      if (drift_chrom != nullptr)
+      {
+        auto & prec = drift_chrom->getPrecursor();
+        drift_lower = prec.getDriftTime() - prec.getDriftTimeWindowLowerOffset();
+        drift_upper = prec.getDriftTime() + prec.getDriftTimeWindowUpperOffset();
+      }
+
+      for (MRMFeature& mrmfeature : transition_group.getFeaturesMuteable())
+      {
+        imrmfeatures.push_back(boost::shared_ptr<OpenSwath::IMRMFeature>(new MRMFeatureOpenMS(mrmfeature)));
+        OpenSwathScoring::DIAScoringTask task;
+        task.imrmfeature = imrmfeatures.back().get();
+        task.transitions = &detecting_transitions[g];
+        task.compound = pep_it->second;
+        task.drift_lower = drift_lower;
+        task.drift_upper = drift_upper;
+        tasks.push_back(task);
+        task_groups.push_back(g);
+      }
+    }
+
+    OpenSwathScoring scorer;
+    scorer.initialize(rt_normalization_factor_, add_up_spectra_, spacing_for_spectra_resampling_, su_, spectrum_addition_method_);
+    scorer.calculateDIAScoresBatch(tasks, swath_maps, ms1_map_, diascoring_);
+
+    // tasks are still in order of transition groups and features
+    for (Size i = 0; i < tasks.size(); ++i)
+    {
+      std::vector<std::pair<OpenSwath_Scores, std::vector<double> > >& group_scores =
+        precomputed_dia_scores_[transition_groups[task_groups[i]]->getTransitionGroupID()];
+      group_scores.push_back(std::make_pair(tasks[i].scores, std::vector<double>()));
+      group_scores.back().second.swap(tasks[i].masserror_ppm);
+    }
+  }
+
   void MRMFeatureFinderScoring::scorePeakgroups(MRMTransitionGroupType& transition_group,
                                                 const TransformationDescription& trafo, 
                                                 const std::vector<OpenSwath::SwathMap>& swath_maps,
@@ -534,6 +620,19 @@ namespace OpenMS
     OpenSwathScoring scorer;
     scorer.initialize(rt_normalization_factor_, add_up_spectra_, spacing_for_spectra_resampling_, su_, spectrum_addition_method_);
 
+    // use the DIA / SWATH scores from precomputeDIAScores if available
+    std::vector<std::pair<OpenSwath_Scores, std::vector<double> > > precomputed_dia_scores;
+    std::map<String, std::vector<std::pair<OpenSwath_Scores, std::vector<double> > > >::iterator precomputed_it =
+      precomputed_dia_scores_.find(transition_group.getTransitionGroupID());
+    if (precomputed_it != precomputed_dia_scores_.end())
+    {
+      if (precomputed_it->second.size() == transition_group_detection.getFeatures().size())
+      {
+        precomputed_dia_scores.swap(precomputed_it->second);
+      }
+      precomputed_dia_scores_.erase(precomputed_it);
+    }
+
     ProteaseDigestion pd;
     pd.setEnzyme("Trypsin");
 
@@ -663,6 +762,11 @@ namespace OpenMS
         }
 
         OpenSwath_Scores& scores = mrmfeature->getScores();
+        if (!precomputed_dia_scores.empty())
+        {
+          // only the DIA / SWATH scores are set, all others are computed below
+          scores = precomputed_dia_scores[feature_idx].first;
+        }
         scorer.calculateChromatographicScores(imrmfeature, native_ids_detection, precursor_ids, normalized_library_intensity,
                                               signal_noise_estimators, scores);
 
@@ -671,9 +775,16 @@ namespace OpenMS
         if (swath_present && su_.use_dia_scores_)
         {
           std::vector<double> masserror_ppm;
-          scorer.calculateDIAScores(imrmfeature,
-                                    transition_group_detection.getTransitions(),
-                                    swath_maps, ms1_map_, diascoring_, *pep, scores, masserror_ppm, drift_lower, drift_upper);
+          if (!precomputed_dia_scores.empty())
+          {
+            masserror_ppm.swap(precomputed_dia_scores[feature_idx].second);
+          }
+          else
+          {
+            scorer.calculateDIAScores(imrmfeature,
+                                      transition_group_detection.getTransitions(),
+                                      swath_maps, ms1_map_, diascoring_, *pep, scores, masserror_ppm, drift_lower, drift_upper);
+          }
           mrmfeature->setMetaValue("masserror_ppm", masserror_ppm);
         }
         if (sonar_present && su_.use_sonar_scores)
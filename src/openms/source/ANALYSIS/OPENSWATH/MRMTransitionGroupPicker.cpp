@@ -73,6 +73,9 @@ namespace OpenMS
 
     defaults_.setValue("minimal_quality", -10000.0, "Only if compute_peak_quality is set, this parameter will not consider peaks below this quality threshold", ListUtils::create<String>("advanced"));
 
+    defaults_.setValue("resample_once", "false", "Resample all chromatograms of a transition group only once onto the retention time grid of the chromatogram containing the first picked peak, instead of once per feature. This is faster when many features are picked per group, but may change peak areas slightly at the boundaries if the chromatograms were not sampled at identical retention times.", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("resample_once", ListUtils::create<String>("true,false"));
+
     defaults_.setValue("resample_boundary", 15.0, "For computing peak quality, how many extra seconds should be sample left and right of the actual peak", ListUtils::create<String>("advanced"));
 
     defaults_.setValue("compute_peak_quality", "false", "Tries to compute a quality value for each peakgroup and detect outlier transitions. The resulting score is centered around zero and values above 0 are generally good and below -1 or -2 are usually bad.", ListUtils::create<String>("advanced"));
@@ -125,6 +128,7 @@ namespace OpenMS
     min_qual_ = (double)param_.getValue("minimal_quality");
     min_peak_width_ = (double)param_.getValue("min_peak_width");
     resample_boundary_ = (double)param_.getValue("resample_boundary");
+    resample_once_ = (bool)param_.getValue("resample_once").toBool();
     boundary_selection_method_ = param_.getValue("boundary_selection_method");
 
     picker_.setParameters(param_.copy("PeakPickerMRM:", true));
@@ -34,6 +34,9 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace OpenMS
 {
   void OpenSwathHelper::selectSwathTransitions(const OpenMS::TargetedExperiment& targeted_exp,
@@ -125,6 +128,120 @@ namespace OpenMS
     }
   }
 
+  OpenSwathHelper::TransitionIndex::TransitionIndex(const OpenSwath::LightTargetedExperiment& targeted_exp)
+  {
+    const std::vector<OpenSwath::LightTransition>& transitions = targeted_exp.transitions;
+    const std::vector<OpenSwath::LightCompound>& compounds = targeted_exp.compounds;
+    const std::vector<OpenSwath::LightProtein>& proteins = targeted_exp.proteins;
+
+    // sort transitions by precursor m/z (stable, so ties keep library order);
+    // NaN values never fall into a window and are left out
+    for (Size i = 0; i < transitions.size(); i++)
+    {
+      if (!std::isnan(transitions[i].precursor_mz)) transition.push_back(i);
+    }
+    std::stable_sort(transition.begin(), transition.end(),
+                     [&transitions](Size a, Size b)
+                     {
+                       return transitions[a].precursor_mz < transitions[b].precursor_mz;
+                     });
+    precursor_mz.reserve(transition.size());
+    for (Size i = 0; i < transition.size(); i++)
+    {
+      precursor_mz.push_back(transitions[transition[i]].precursor_mz);
+    }
+
+    std::unordered_map<std::string, Size> compound_ids;
+    compound_key.resize(compounds.size());
+    for (Size i = 0; i < compounds.size(); i++)
+    {
+      compound_key[i] = compound_ids.insert(std::make_pair(compounds[i].id, i)).first->second;
+    }
+    transition_compound.resize(transitions.size(), Size(-1));
+    for (Size i = 0; i < transitions.size(); i++)
+    {
+      std::unordered_map<std::string, Size>::const_iterator it = compound_ids.find(transitions[i].peptide_ref);
+      if (it != compound_ids.end()) transition_compound[i] = it->second;
+    }
+
+    std::unordered_map<std::string, Size> protein_ids;
+    protein_key.resize(proteins.size());
+    for (Size i = 0; i < proteins.size(); i++)
+    {
+      protein_key[i] = protein_ids.insert(std::make_pair(proteins[i].id, i)).first->second;
+    }
+    compound_protein_offsets.reserve(compounds.size() + 1);
+    compound_protein_offsets.push_back(0);
+    for (Size i = 0; i < compounds.size(); i++)
+    {
+      for (Size j = 0; j < compounds[i].protein_refs.size(); j++)
+      {
+        std::unordered_map<std::string, Size>::const_iterator it = protein_ids.find(compounds[i].protein_refs[j]);
+        if (it != protein_ids.end()) compound_proteins.push_back(it->second);
+      }
+      compound_protein_offsets.push_back(compound_proteins.size());
+    }
+  }
+
+  void OpenSwathHelper::selectSwathTransitions(const OpenSwath::LightTargetedExperiment& targeted_exp,
+                                               const TransitionIndex& index,
+                                               OpenSwath::LightTargetedExperiment& transition_exp_used,
+                                               double min_upper_edge_dist,
+                                               double lower, double upper)
+  {
+    // transitions with lower < precursor m/z < upper
+    std::vector<double>::const_iterator first =
+      std::upper_bound(index.precursor_mz.begin(), index.precursor_mz.end(), lower);
+    std::vector<double>::const_iterator last =
+      std::lower_bound(first, index.precursor_mz.end(), upper);
+
+    std::vector<Size> transitions;
+    for (std::vector<double>::const_iterator it = first; it != last; ++it)
+    {
+      if (std::fabs(upper - *it) >= min_upper_edge_dist)
+      {
+        transitions.push_back(index.transition[it - index.precursor_mz.begin()]);
+      }
+    }
+    selectTransitions(targeted_exp, index, transitions, transition_exp_used);
+  }
+
+  void OpenSwathHelper::selectTransitions(const OpenSwath::LightTargetedExperiment& targeted_exp,
+                                          const TransitionIndex& index,
+                                          std::vector<Size>& transitions,
+                                          OpenSwath::LightTargetedExperiment& transition_exp_used)
+  {
+    std::sort(transitions.begin(), transitions.end()); // library order
+    std::vector<char> matching_compounds(targeted_exp.compounds.size(), 0);
+    transition_exp_used.transitions.reserve(transition_exp_used.transitions.size() + transitions.size());
+    for (Size i = 0; i < transitions.size(); i++)
+    {
+      transition_exp_used.transitions.push_back(targeted_exp.transitions[transitions[i]]);
+      const Size compound = index.transition_compound[transitions[i]];
+      if (compound != Size(-1)) matching_compounds[compound] = 1;
+    }
+
+    std::vector<char> matching_proteins(targeted_exp.proteins.size(), 0);
+    for (Size i = 0; i < targeted_exp.compounds.size(); i++)
+    {
+      if (matching_compounds[index.compound_key[i]])
+      {
+        transition_exp_used.compounds.push_back( targeted_exp.compounds[i] );
+        for (Size j = index.compound_protein_offsets[i]; j < index.compound_protein_offsets[i + 1]; j++)
+        {
+          matching_proteins[index.compound_proteins[j]] = 1;
+        }
+      }
+    }
+    for (Size i = 0; i < targeted_exp.proteins.size(); i++)
+    {
+      if (matching_proteins[index.protein_key[i]])
+      {
+        transition_exp_used.proteins.push_back( targeted_exp.proteins[i] );
+      }
+    }
+  }
+
   std::pair<double,double> OpenSwathHelper::estimateRTRange(const OpenSwath::LightTargetedExperiment & exp)
   {
     if (exp.getCompounds().empty()) 
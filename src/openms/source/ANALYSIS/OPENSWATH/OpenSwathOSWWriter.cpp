@@ -34,13 +34,379 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
 
+#include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
 #include <sqlite3.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
+  // Columns of the feature tables, in the order of OpenSwathOSWWriter::FeatureRecords
+  static const char* const osw_feature_columns[] = {"ID", "RUN_ID", "PRECURSOR_ID", "EXP_RT", "NORM_RT",
+    "DELTA_RT", "LEFT_WIDTH", "RIGHT_WIDTH"};
+
+  static const char* const osw_feature_ms1_columns[] = {"FEATURE_ID", "AREA_INTENSITY", "APEX_INTENSITY",
+    "VAR_MASSDEV_SCORE", "VAR_MI_SCORE", "VAR_MI_CONTRAST_SCORE", "VAR_MI_COMBINED_SCORE",
+    "VAR_ISOTOPE_CORRELATION_SCORE", "VAR_ISOTOPE_OVERLAP_SCORE", "VAR_XCORR_COELUTION",
+    "VAR_XCORR_COELUTION_CONTRAST", "VAR_XCORR_COELUTION_COMBINED", "VAR_XCORR_SHAPE",
+    "VAR_XCORR_SHAPE_CONTRAST", "VAR_XCORR_SHAPE_COMBINED"};
+
+  // meta values stored in FEATURE_MS1 (after FEATURE_ID)
+  static const char* const osw_feature_ms1_scores[] = {"ms1_area_intensity", "ms1_apex_intensity",
+    "var_ms1_ppm_diff", "var_ms1_mi_score", "var_ms1_mi_contrast_score", "var_ms1_mi_combined_score",
+    "var_ms1_isotope_correlation", "var_ms1_isotope_overlap", "var_ms1_xcorr_coelution",
+    "var_ms1_xcorr_coelution_contrast", "var_ms1_xcorr_coelution_combined", "var_ms1_xcorr_shape",
+    "var_ms1_xcorr_shape_contrast", "var_ms1_xcorr_shape_combined"};
+
+  static const char* const osw_feature_precursor_columns[] = {"FEATURE_ID", "ISOTOPE", "AREA_INTENSITY",
+    "APEX_INTENSITY"};
+
+  static const char* const osw_feature_ms2_columns[] = {"FEATURE_ID", "AREA_INTENSITY",
+    "TOTAL_AREA_INTENSITY", "APEX_INTENSITY", "TOTAL_MI", "VAR_BSERIES_SCORE", "VAR_DOTPROD_SCORE",
+    "VAR_INTENSITY_SCORE", "VAR_ISOTOPE_CORRELATION_SCORE", "VAR_ISOTOPE_OVERLAP_SCORE", "VAR_LIBRARY_CORR",
+    "VAR_LIBRARY_DOTPROD", "VAR_LIBRARY_MANHATTAN", "VAR_LIBRARY_RMSD", "VAR_LIBRARY_ROOTMEANSQUARE",
+    "VAR_LIBRARY_SANGLE", "VAR_LOG_SN_SCORE", "VAR_MANHATTAN_SCORE", "VAR_MASSDEV_SCORE",
+    "VAR_MASSDEV_SCORE_WEIGHTED", "VAR_MI_SCORE", "VAR_MI_WEIGHTED_SCORE", "VAR_MI_RATIO_SCORE",
+    "VAR_NORM_RT_SCORE", "VAR_XCORR_COELUTION", "VAR_XCORR_COELUTION_WEIGHTED", "VAR_XCORR_SHAPE",
+    "VAR_XCORR_SHAPE_WEIGHTED", "VAR_YSERIES_SCORE", "VAR_ELUTION_MODEL_FIT_SCORE", "VAR_SONAR_LAG",
+    "VAR_SONAR_SHAPE", "VAR_SONAR_LOG_SN", "VAR_SONAR_LOG_DIFF", "VAR_SONAR_LOG_TREND", "VAR_SONAR_RSQ"};
+
+  // meta values stored in FEATURE_MS2 (after FEATURE_ID and AREA_INTENSITY)
+  static const char* const osw_feature_ms2_scores[] = {"total_xic", "peak_apices_sum", "total_mi",
+    "var_bseries_score", "var_dotprod_score", "var_intensity_score", "var_isotope_correlation_score",
+    "var_isotope_overlap_score", "var_library_corr", "var_library_dotprod", "var_library_manhattan",
+    "var_library_rmsd", "var_library_rootmeansquare", "var_library_sangle", "var_log_sn_score",
+    "var_manhatt_score", "var_massdev_score", "var_massdev_score_weighted", "var_mi_score",
+    "var_mi_weighted_score", "var_mi_ratio_score", "var_norm_rt_score", "var_xcorr_coelution",
+    "var_xcorr_coelution_weighted", "var_xcorr_shape", "var_xcorr_shape_weighted", "var_yseries_score",
+    "var_elution_model_fit_score", "var_sonar_lag", "var_sonar_shape", "var_sonar_log_sn",
+    "var_sonar_log_diff", "var_sonar_log_trend", "var_sonar_rsq"};
+
+  static const char* const osw_feature_transition_columns[] = {"FEATURE_ID", "TRANSITION_ID",
+    "AREA_INTENSITY", "TOTAL_AREA_INTENSITY", "APEX_INTENSITY", "TOTAL_MI", "VAR_INTENSITY_SCORE",
+    "VAR_INTENSITY_RATIO_SCORE", "VAR_LOG_INTENSITY", "VAR_XCORR_COELUTION", "VAR_XCORR_SHAPE",
+    "VAR_LOG_SN_SCORE", "VAR_MASSDEV_SCORE", "VAR_MI_SCORE", "VAR_MI_RATIO_SCORE",
+    "VAR_ISOTOPE_CORRELATION_SCORE", "VAR_ISOTOPE_OVERLAP_SCORE"};
+
+  // meta value lists (prefixed by "id_target_" or "id_decoy_") stored in FEATURE_TRANSITION for UIS scoring (after FEATURE_ID)
+  static const char* const osw_uis_transition_scores[] = {"transition_names", "area_intensity",
+    "total_area_intensity", "apex_intensity", "total_mi", "intensity_score", "intensity_ratio_score",
+    "ind_log_intensity", "ind_xcorr_coelution", "ind_xcorr_shape", "ind_log_sn_score", "ind_massdev_score",
+    "ind_mi_score", "ind_mi_ratio_score", "ind_isotope_correlation", "ind_isotope_overlap"};
+
+  struct OSWTableInfo
+  {
+    const char* name;
+    const char* const* columns;
+    Size nr_columns;
+    std::vector<DataValue> OpenSwathOSWWriter::FeatureRecords::* rows;
+  };
+
+#define OSW_NR_COLUMNS(columns) (sizeof(columns) / sizeof(columns[0]))
+
+  static const OSWTableInfo osw_tables[] =
+  {
+    {"FEATURE", osw_feature_columns, OSW_NR_COLUMNS(osw_feature_columns),
+      &OpenSwathOSWWriter::FeatureRecords::feature},
+    {"FEATURE_MS1", osw_feature_ms1_columns, OSW_NR_COLUMNS(osw_feature_ms1_columns),
+      &OpenSwathOSWWriter::FeatureRecords::feature_ms1},
+    {"FEATURE_PRECURSOR", osw_feature_precursor_columns, OSW_NR_COLUMNS(osw_feature_precursor_columns),
+      &OpenSwathOSWWriter::FeatureRecords::feature_precursor},
+    {"FEATURE_MS2", osw_feature_ms2_columns, OSW_NR_COLUMNS(osw_feature_ms2_columns),
+      &OpenSwathOSWWriter::FeatureRecords::feature_ms2},
+    {"FEATURE_TRANSITION", osw_feature_transition_columns, OSW_NR_COLUMNS(osw_feature_transition_columns),
+      &OpenSwathOSWWriter::FeatureRecords::feature_transition}
+  };
+
+  /// Inserts FeatureRecords through one prepared statement per table
+  class OSWRecordInserter
+  {
+  public:
+    explicit OSWRecordInserter(sqlite3* db) :
+      db_(db)
+    {
+      try
+      {
+        for (const OSWTableInfo& table : osw_tables)
+        {
+          String sql = String("INSERT INTO ") + table.name + " (";
+          String values;
+          for (Size k = 0; k < table.nr_columns; ++k)
+          {
+            if (k > 0)
+            {
+              sql += ", ";
+              values += ", ";
+            }
+            sql += table.columns[k];
+            values += "?" + String(k + 1);
+          }
+          sql += ") VALUES (" + values + ");";
+          statements_.push_back(nullptr);
+          SqliteConnector::executePreparedStatement(db_, &statements_.back(), sql);
+        }
+      }
+      catch (...)
+      {
+        finalize_();
+        throw;
+      }
+    }
+
+    ~OSWRecordInserter()
+    {
+      finalize_();
+    }
+
+    void insert(const OpenSwathOSWWriter::FeatureRecords& records)
+    {
+      for (Size t = 0; t < statements_.size(); ++t)
+      {
+        const OSWTableInfo& table = osw_tables[t];
+        const std::vector<DataValue>& values = records.*(table.rows);
+        sqlite3_stmt* stmt = statements_[t];
+        for (Size row = 0; row < values.size(); row += table.nr_columns)
+        {
+          for (Size k = 0; k < table.nr_columns; ++k)
+          {
+            bind_(stmt, int(k + 1), values[row + k]);
+          }
+          if (sqlite3_step(stmt) != SQLITE_DONE)
+          {
+            String error = String("Error inserting into ") + table.name + ": " + sqlite3_errmsg(db_);
+            sqlite3_reset(stmt);
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error);
+          }
+          sqlite3_reset(stmt);
+        }
+      }
+    }
+
+  private:
+    void bind_(sqlite3_stmt* stmt, int pos, const DataValue& value)
+    {
+      switch (value.valueType())
+      {
+        case DataValue::EMPTY_VALUE:
+          sqlite3_bind_null(stmt, pos);
+          break;
+        case DataValue::INT_VALUE:
+          sqlite3_bind_int64(stmt, pos, static_cast<sqlite3_int64>(static_cast<long long>(value)));
+          break;
+        case DataValue::DOUBLE_VALUE:
+          sqlite3_bind_double(stmt, pos, static_cast<double>(value));
+          break;
+        default:
+        {
+          // text is converted according to the column affinity (e.g. native ids to INT)
+          String text = value.toString();
+          sqlite3_bind_text(stmt, pos, text.c_str(), int(text.size()), SQLITE_TRANSIENT);
+        }
+      }
+    }
+
+    void finalize_()
+    {
+      for (sqlite3_stmt* stmt : statements_)
+      {
+        sqlite3_finalize(stmt);
+      }
+      statements_.clear();
+    }
+
+    sqlite3* db_;
+    std::vector<sqlite3_stmt*> statements_;
+  };
+
+  /// Background writer thread consuming batches of FeatureRecords
+  struct OpenSwathOSWWriter::AsyncWriter_
+  {
+    /// Number of rows after which the current transaction is committed
+    static const Size commit_rows = 100000;
+
+    AsyncWriter_(const String& output_filename, Size max_queued) :
+      filename(output_filename),
+      max_queued_batches(max_queued),
+      stopping(false),
+      failed(false),
+      nr_features(0),
+      nr_rows(0),
+      busy_time(0.0)
+    {
+      wall_clock.start();
+      thread = std::thread(&AsyncWriter_::run, this);
+    }
+
+    ~AsyncWriter_()
+    {
+      stop();
+    }
+
+    /// Queue the records for the writer thread, returns false (without throwing) if the thread has already been stopped
+    bool push(std::vector<FeatureRecords>& records)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (stopping) return false;
+      queue_not_full.wait(lock, [this]() { return queue.size() < max_queued_batches || failed; });
+      if (failed) // error is reported by finishAsyncWriting
+      {
+        records.clear();
+        return true;
+      }
+      queue.push_back(std::vector<FeatureRecords>());
+      queue.back().swap(records);
+      lock.unlock();
+      queue_not_empty.notify_one();
+      return true;
+    }
+
+    void stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      queue_not_empty.notify_one();
+      if (thread.joinable())
+      {
+        thread.join();
+        wall_clock.stop();
+      }
+    }
+
+    void run()
+    {
+      try
+      {
+        SqliteConnector conn(filename);
+        OSWRecordInserter inserter(conn.getDB());
+        conn.executeStatement("BEGIN TRANSACTION");
+        Size rows_in_transaction = 0;
+        std::vector<FeatureRecords> batch;
+        while (true)
+        {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            queue_not_empty.wait(lock, [this]() { return !queue.empty() || stopping; });
+            if (queue.empty())
+            {
+              break; // stopped and everything written
+            }
+            batch.swap(queue.front());
+            queue.pop_front();
+          }
+          queue_not_full.notify_one();
+
+          StopWatch sw;
+          sw.start();
+          for (const FeatureRecords& records : batch)
+          {
+            inserter.insert(records);
+            nr_features += records.nrFeatures();
+            rows_in_transaction += records.nrRows();
+          }
+          if (rows_in_transaction >= commit_rows)
+          {
+            conn.executeStatement("END TRANSACTION");
+            conn.executeStatement("BEGIN TRANSACTION");
+            nr_rows += rows_in_transaction;
+            rows_in_transaction = 0;
+          }
+          sw.stop();
+          busy_time += sw.getClockTime();
+          batch.clear();
+        }
+        StopWatch sw;
+        sw.start();
+        conn.executeStatement("END TRANSACTION");
+        nr_rows += rows_in_transaction;
+        sw.stop();
+        busy_time += sw.getClockTime();
+      }
+      catch (...)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          error = std::current_exception();
+          failed = true;
+          queue.clear();
+        }
+        queue_not_full.notify_all();
+      }
+    }
+
+    String filename;
+    Size max_queued_batches;
+
+    std::mutex mutex;
+    std::mutex late_write_mutex; ///< serializes direct writes of records pushed after stop()
+    std::condition_variable queue_not_empty;
+    std::condition_variable queue_not_full;
+    std::deque<std::vector<FeatureRecords> > queue;
+    bool stopping;
+    bool failed;
+    std::exception_ptr error;
+
+    // statistics (only accessed by the writer thread until it is joined)
+    Size nr_features;
+    Size nr_rows;
+    double busy_time;
+    StopWatch wall_clock;
+
+    std::thread thread;
+  };
+
+  Size OpenSwathOSWWriter::FeatureRecords::nrFeatures() const
+  {
+    return feature.size() / OSW_NR_COLUMNS(osw_feature_columns);
+  }
+
+  Size OpenSwathOSWWriter::FeatureRecords::nrRows() const
+  {
+    Size rows = 0;
+    for (const OSWTableInfo& table : osw_tables)
+    {
+      rows += (this->*(table.rows)).size() / table.nr_columns;
+    }
+    return rows;
+  }
+
+  /// Splits a list-valued meta value into its (typed) elements
+  static std::vector<DataValue> separateValues(const Feature& feature, const String& score_name)
+  {
+    std::vector<DataValue> values;
+    const DataValue& value = feature.getMetaValue(score_name);
+    switch (value.valueType())
+    {
+      case DataValue::EMPTY_VALUE:
+        break;
+      case DataValue::STRING_LIST:
+        for (const String& s : value.toStringList()) values.push_back(DataValue(s));
+        break;
+      case DataValue::INT_LIST:
+        for (int i : value.toIntList()) values.push_back(DataValue(i));
+        break;
+      case DataValue::DOUBLE_LIST:
+        for (double d : value.toDoubleList()) values.push_back(DataValue(d));
+        break;
+      default:
+        values.push_back(value);
+    }
+    return values;
+  }
+
   bool OpenSwathOSWWriter::isActive() const
   {
     return doWrite_;
@@ -202,45 +568,50 @@ namespace OpenMS
     return separated_scores;
   }
 
-  String OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& /* pep */,
-                                         const OpenSwath::LightTransition* /* transition */,
-                                         FeatureMap& output,
-                                         String id) const
+  OpenSwathOSWWriter::FeatureRecords OpenSwathOSWWriter::prepareRecords(const OpenSwath::LightCompound& /* pep */,
+                                                                        const OpenSwath::LightTransition* /* transition */,
+                                                                        FeatureMap& output,
+                                                                        String id) const
   {
-    std::stringstream sql, sql_feature, sql_feature_ms1, sql_feature_ms1_precursor, sql_feature_ms2, sql_feature_ms2_transition, sql_feature_uis_transition;
+    FeatureRecords records;
+    const Size nr_transition_columns = OSW_NR_COLUMNS(osw_feature_transition_columns);
+    const DataValue empty;
+
+    // Conversion from UInt64 to int64_t to support SQLite (and conversion to 63 bits)
+    const DataValue run_id(static_cast<long long>(run_id_ & ~(1ULL << 63)));
+    const DataValue precursor_id(id);
 
     for (const auto& feature_it : output)
     {
       UInt64 uint64_feature_id = feature_it.getUniqueId();
-      int64_t feature_id = static_cast<int64_t >(uint64_feature_id & ~(1ULL << 63)); // clear sign bit
+      const DataValue feature_id(static_cast<long long>(uint64_feature_id & ~(1ULL << 63))); // clear sign bit
 
       for (const auto& sub_it : feature_it.getSubordinates())
       {
         if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS2")
         {
-          std::string total_mi = "NULL"; // total_mi is not guaranteed to be set
-          if (!sub_it.getMetaValue("total_mi").isEmpty())
-          {
-            total_mi = sub_it.getMetaValue("total_mi").toString();
-          }
-          sql_feature_ms2_transition  << "INSERT INTO FEATURE_TRANSITION "\
-            "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI) VALUES ("
-                                      << feature_id << ", "
-                                      << sub_it.getMetaValue("native_id") << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("total_xic") << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << ", "
-                                      << total_mi << "); ";
+          // with UIS scoring, the identification transitions below are reported instead
+          if (enable_uis_scoring_) continue;
+
+          std::vector<DataValue>& row = records.feature_transition;
+          row.push_back(feature_id);
+          row.push_back(sub_it.getMetaValue("native_id"));
+          row.push_back(DataValue(sub_it.getIntensity()));
+          row.push_back(sub_it.getMetaValue("total_xic"));
+          row.push_back(sub_it.getMetaValue("peak_apex_int"));
+          row.push_back(sub_it.getMetaValue("total_mi")); // total_mi is not guaranteed to be set
+          row.resize(row.size() + nr_transition_columns - 6); // scores are only reported for UIS
         }
         else if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS1" && sub_it.getIntensity() > 0.0)
         {
-          std::vector<String> precursor_id;
-          OpenMS::String(sub_it.getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), precursor_id);
-          sql_feature_ms1_precursor  << "INSERT INTO FEATURE_PRECURSOR (FEATURE_ID, ISOTOPE, AREA_INTENSITY, APEX_INTENSITY) VALUES ("
-                                      << feature_id << ", "
-                                      << precursor_id[1] << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << "); ";
+          std::vector<String> isotope;
+          OpenMS::String(sub_it.getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), isotope);
+
+          std::vector<DataValue>& row = records.feature_precursor;
+          row.push_back(feature_id);
+          row.push_back(DataValue(isotope[1].toInt()));
+          row.push_back(DataValue(sub_it.getIntensity()));
+          row.push_back(sub_it.getMetaValue("peak_apex_int"));
         }
       }
 
@@ -249,203 +620,89 @@ namespace OpenMS
       if (feature_it.metaValueExists("norm_RT") ) norm_rt = feature_it.getMetaValue("norm_RT");
       if (feature_it.metaValueExists("delta_rt") ) delta_rt = feature_it.getMetaValue("delta_rt");
 
-      sql_feature << "INSERT INTO FEATURE (ID, RUN_ID, PRECURSOR_ID, EXP_RT, NORM_RT, DELTA_RT, LEFT_WIDTH, RIGHT_WIDTH) VALUES ("
-                  << feature_id << ", "
-                  // Conversion from UInt64 to int64_t to support SQLite (and conversion to 63 bits)
-                  <<  static_cast<int64_t >(run_id_ & ~(1ULL << 63)) << ", "
-                  << id << ", "
-                  << feature_it.getRT() << ", "
-                  << norm_rt << ", "
-                  << delta_rt << ", "
-                  << feature_it.getMetaValue("leftWidth") << ", "
-                  << feature_it.getMetaValue("rightWidth") << "); ";
-
-      sql_feature_ms2 << "INSERT INTO FEATURE_MS2 " \
-        "(FEATURE_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, "\
-        "VAR_BSERIES_SCORE, VAR_DOTPROD_SCORE, VAR_INTENSITY_SCORE, " \
-        "VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_LIBRARY_CORR,  "\
-        "VAR_LIBRARY_DOTPROD, VAR_LIBRARY_MANHATTAN, VAR_LIBRARY_RMSD, VAR_LIBRARY_ROOTMEANSQUARE, "\
-        "VAR_LIBRARY_SANGLE, VAR_LOG_SN_SCORE, VAR_MANHATTAN_SCORE, VAR_MASSDEV_SCORE, VAR_MASSDEV_SCORE_WEIGHTED, "\
-        "VAR_MI_SCORE, VAR_MI_WEIGHTED_SCORE, VAR_MI_RATIO_SCORE, VAR_NORM_RT_SCORE, "\
-        "VAR_XCORR_COELUTION,VAR_XCORR_COELUTION_WEIGHTED, VAR_XCORR_SHAPE, "\
-        "VAR_XCORR_SHAPE_WEIGHTED, VAR_YSERIES_SCORE, VAR_ELUTION_MODEL_FIT_SCORE, "\
-        "VAR_SONAR_LAG, VAR_SONAR_SHAPE, VAR_SONAR_LOG_SN, VAR_SONAR_LOG_DIFF, VAR_SONAR_LOG_TREND, VAR_SONAR_RSQ "\
-        ") VALUES ("
-                      << feature_id << ", "
-                      << feature_it.getIntensity() << ", "
-                      << getScore(feature_it, "total_xic") << ", "
-                      << getScore(feature_it, "peak_apices_sum") << ", "
-                      << getScore(feature_it, "total_mi") << ", "
-                      << getScore(feature_it, "var_bseries_score") << ", "
-                      << getScore(feature_it, "var_dotprod_score") << ", "
-                      << getScore(feature_it, "var_intensity_score") << ", "
-                      << getScore(feature_it, "var_isotope_correlation_score") << ", "
-                      << getScore(feature_it, "var_isotope_overlap_score") << ", "
-                      << getScore(feature_it, "var_library_corr") << ", "
-                      << getScore(feature_it, "var_library_dotprod") << ", "
-                      << getScore(feature_it, "var_library_manhattan") << ", "
-                      << getScore(feature_it, "var_library_rmsd") << ", "
-                      << getScore(feature_it, "var_library_rootmeansquare") << ", "
-                      << getScore(feature_it, "var_library_sangle") << ", "
-                      << getScore(feature_it, "var_log_sn_score") << ", "
-                      << getScore(feature_it, "var_manhatt_score") << ", "
-                      << getScore(feature_it, "var_massdev_score") << ", "
-                      << getScore(feature_it, "var_massdev_score_weighted") << ", "
-                      << getScore(feature_it, "var_mi_score") << ", "
-                      << getScore(feature_it, "var_mi_weighted_score") << ", "
-                      << getScore(feature_it, "var_mi_ratio_score") << ", "
-                      << getScore(feature_it, "var_norm_rt_score") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution_weighted") << ", "
-                      << getScore(feature_it, "var_xcorr_shape") << ", "
-                      << getScore(feature_it, "var_xcorr_shape_weighted") << ", "
-                      << getScore(feature_it, "var_yseries_score") << ", "
-                      << getScore(feature_it, "var_elution_model_fit_score") << ", "
-                      << getScore(feature_it, "var_sonar_lag") << ", "
-                      << getScore(feature_it, "var_sonar_shape") << ", "
-                      << getScore(feature_it, "var_sonar_log_sn") << ", "
-                      << getScore(feature_it, "var_sonar_log_diff") << ", "
-                      << getScore(feature_it, "var_sonar_log_trend") << ", "
-                      << getScore(feature_it, "var_sonar_rsq") << "); ";
+      records.feature.push_back(feature_id);
+      records.feature.push_back(run_id);
+      records.feature.push_back(precursor_id);
+      records.feature.push_back(DataValue(feature_it.getRT()));
+      records.feature.push_back(DataValue(norm_rt));
+      records.feature.push_back(DataValue(delta_rt));
+      records.feature.push_back(feature_it.getMetaValue("leftWidth"));
+      records.feature.push_back(feature_it.getMetaValue("rightWidth"));
+
+      records.feature_ms2.push_back(feature_id);
+      records.feature_ms2.push_back(DataValue(feature_it.getIntensity()));
+      for (const char* score : osw_feature_ms2_scores)
+      {
+        records.feature_ms2.push_back(feature_it.getMetaValue(score));
+      }
 
       if (use_ms1_traces_)
       {
-        sql_feature_ms1 << "INSERT INTO FEATURE_MS1 "\
-          "(FEATURE_ID, AREA_INTENSITY, APEX_INTENSITY, VAR_MASSDEV_SCORE, "\
-          " VAR_MI_SCORE, VAR_MI_CONTRAST_SCORE, VAR_MI_COMBINED_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, "\
-          " VAR_ISOTOPE_OVERLAP_SCORE, VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_CONTRAST, "\
-          " VAR_XCORR_COELUTION_COMBINED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_CONTRAST, VAR_XCORR_SHAPE_COMBINED "\
-          ") VALUES ("
-                        << feature_id << ", "
-                        << getScore(feature_it, "ms1_area_intensity") << ", "
-                        << getScore(feature_it, "ms1_apex_intensity") << ", "
-                        << getScore(feature_it, "var_ms1_ppm_diff") << ", "
-                        << getScore(feature_it, "var_ms1_mi_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_contrast_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_combined_score") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_correlation") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_overlap") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_combined") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_combined") << "); ";
+        records.feature_ms1.push_back(feature_id);
+        for (const char* score : osw_feature_ms1_scores)
+        {
+          records.feature_ms1.push_back(feature_it.getMetaValue(score));
+        }
       }
 
       if (enable_uis_scoring_)
       {
-        auto id_target_transition_names = getSeparateScore(feature_it, "id_target_transition_names");
-        auto id_target_area_intensity = getSeparateScore(feature_it, "id_target_area_intensity");
-        auto id_target_total_area_intensity = getSeparateScore(feature_it, "id_target_total_area_intensity");
-        auto id_target_apex_intensity = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_total_mi = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_intensity_score = getSeparateScore(feature_it, "id_target_intensity_score");
-        auto id_target_intensity_ratio_score = getSeparateScore(feature_it, "id_target_intensity_ratio_score");
-        auto id_target_log_intensity = getSeparateScore(feature_it, "id_target_ind_log_intensity");
-        auto id_target_ind_xcorr_coelution = getSeparateScore(feature_it, "id_target_ind_xcorr_coelution");
-        auto id_target_ind_xcorr_shape = getSeparateScore(feature_it, "id_target_ind_xcorr_shape");
-        auto id_target_ind_log_sn_score = getSeparateScore(feature_it, "id_target_ind_log_sn_score");
-        auto id_target_ind_massdev_score = getSeparateScore(feature_it, "id_target_ind_massdev_score");
-        auto id_target_ind_mi_score = getSeparateScore(feature_it, "id_target_ind_mi_score");
-        auto id_target_ind_mi_ratio_score = getSeparateScore(feature_it, "id_target_ind_mi_ratio_score");
-        auto id_target_ind_isotope_correlation = getSeparateScore(feature_it, "id_target_ind_isotope_correlation");
-        auto id_target_ind_isotope_overlap = getSeparateScore(feature_it, "id_target_ind_isotope_overlap");
-
-        if (feature_it.metaValueExists("id_target_num_transitions"))
+        for (const String prefix : {"id_target_", "id_decoy_"})
         {
-          int id_target_num_transitions = feature_it.getMetaValue("id_target_num_transitions");
+          if (!feature_it.metaValueExists(prefix + "num_transitions")) continue;
 
-          for (int i = 0; i < id_target_num_transitions; ++i)
+          std::vector<std::vector<DataValue> > columns;
+          for (const char* score : osw_uis_transition_scores)
           {
-            sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-              "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-              " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-              " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-              " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-              " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE "\
-              ") VALUES ("
-                                        << feature_id << ", "
-                                        << id_target_transition_names[i] << ", "
-                                        << id_target_area_intensity[i] << ", "
-                                        << id_target_total_area_intensity[i] << ", "
-                                        << id_target_apex_intensity[i] << ", "
-                                        << id_target_total_mi[i] << ", "
-                                        << id_target_intensity_score[i] << ", "
-                                        << id_target_intensity_ratio_score[i] << ", "
-                                        << id_target_log_intensity[i] << ", "
-                                        << id_target_ind_xcorr_coelution[i] << ", "
-                                        << id_target_ind_xcorr_shape[i] << ", "
-                                        << id_target_ind_log_sn_score[i] << ", "
-                                        << id_target_ind_massdev_score[i] << ", "
-                                        << id_target_ind_mi_score[i] << ", "
-                                        << id_target_ind_mi_ratio_score[i] << ", "
-                                        << id_target_ind_isotope_correlation[i] << ", "
-                                        << id_target_ind_isotope_overlap[i] << "); ";
+            String score_name = prefix + score;
+            // TOTAL_MI of target transitions is taken from the apex intensities (as in previous versions)
+            if (score_name == "id_target_total_mi") score_name = "id_target_apex_intensity";
+            columns.push_back(separateValues(feature_it, score_name));
           }
-        }
 
-        auto id_decoy_transition_names = getSeparateScore(feature_it, "id_decoy_transition_names");
-        auto id_decoy_area_intensity = getSeparateScore(feature_it, "id_decoy_area_intensity");
-        auto id_decoy_total_area_intensity = getSeparateScore(feature_it, "id_decoy_total_area_intensity");
-        auto id_decoy_apex_intensity = getSeparateScore(feature_it, "id_decoy_apex_intensity");
-        auto id_decoy_total_mi = getSeparateScore(feature_it, "id_decoy_total_mi");
-        auto id_decoy_intensity_score = getSeparateScore(feature_it, "id_decoy_intensity_score");
-        auto id_decoy_intensity_ratio_score = getSeparateScore(feature_it, "id_decoy_intensity_ratio_score");
-        auto id_decoy_log_intensity = getSeparateScore(feature_it, "id_decoy_ind_log_intensity");
-        auto id_decoy_ind_xcorr_coelution = getSeparateScore(feature_it, "id_decoy_ind_xcorr_coelution");
-        auto id_decoy_ind_xcorr_shape = getSeparateScore(feature_it, "id_decoy_ind_xcorr_shape");
-        auto id_decoy_ind_log_sn_score = getSeparateScore(feature_it, "id_decoy_ind_log_sn_score");
-        auto id_decoy_ind_massdev_score = getSeparateScore(feature_it, "id_decoy_ind_massdev_score");
-        auto id_decoy_ind_mi_score = getSeparateScore(feature_it, "id_decoy_ind_mi_score");
-        auto id_decoy_ind_mi_ratio_score = getSeparateScore(feature_it, "id_decoy_ind_mi_ratio_score");
-        auto id_decoy_ind_isotope_correlation = getSeparateScore(feature_it, "id_decoy_ind_isotope_correlation");
-        auto id_decoy_ind_isotope_overlap = getSeparateScore(feature_it, "id_decoy_ind_isotope_overlap");
-
-        if (feature_it.metaValueExists("id_decoy_num_transitions"))
-        {
-          int id_decoy_num_transitions = feature_it.getMetaValue("id_decoy_num_transitions");
-
-          for (int i = 0; i < id_decoy_num_transitions; ++i)
+          int num_transitions = feature_it.getMetaValue(prefix + "num_transitions");
+          for (int i = 0; i < num_transitions; ++i)
           {
-             sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-                "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-                " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-                " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-                " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-                " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE) "\
-                "VALUES ("
-                                        << feature_id << ", "
-                                        << id_decoy_transition_names[i] << ", "
-                                        << id_decoy_area_intensity[i] << ", "
-                                        << id_decoy_total_area_intensity[i] << ", "
-                                        << id_decoy_apex_intensity[i] << ", "
-                                        << id_decoy_total_mi[i] << ", "
-                                        << id_decoy_intensity_score[i] << ", "
-                                        << id_decoy_intensity_ratio_score[i] << ", "
-                                        << id_decoy_log_intensity[i] << ", "
-                                        << id_decoy_ind_xcorr_coelution[i] << ", "
-                                        << id_decoy_ind_xcorr_shape[i] << ", "
-                                        << id_decoy_ind_log_sn_score[i] << ", "
-                                        << id_decoy_ind_massdev_score[i] << ", "
-                                        << id_decoy_ind_mi_score[i] << ", "
-                                        << id_decoy_ind_mi_ratio_score[i] << ", "
-                                        << id_decoy_ind_isotope_correlation[i] << ", "
-                                        << id_decoy_ind_isotope_overlap[i] << "); ";
+            records.feature_transition.push_back(feature_id);
+            for (const auto& column : columns)
+            {
+              records.feature_transition.push_back(Size(i) < column.size() ? column[i] : empty);
+            }
           }
         }
       }
     }
 
-    if (enable_uis_scoring_)
-    {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_uis_transition.str();
-    }
-    else
+    return records;
+  }
+
+  String OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& pep,
+                                         const OpenSwath::LightTransition* transition,
+                                         FeatureMap& output,
+                                         String id) const
+  {
+    FeatureRecords records = prepareRecords(pep, transition, output, id);
+
+    std::stringstream sql;
+    for (const OSWTableInfo& table : osw_tables)
     {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_ms2_transition.str();
+      const std::vector<DataValue>& values = records.*(table.rows);
+      for (Size row = 0; row < values.size(); row += table.nr_columns)
+      {
+        sql << "INSERT INTO " << table.name << " (";
+        for (Size k = 0; k < table.nr_columns; ++k)
+        {
+          sql << (k > 0 ? ", " : "") << table.columns[k];
+        }
+        sql << ") VALUES (";
+        for (Size k = 0; k < table.nr_columns; ++k)
+        {
+          const DataValue& value = values[row + k];
+          sql << (k > 0 ? ", " : "") << (value.isEmpty() ? String("NULL") : value.toString());
+        }
+        sql << "); ";
+      }
     }
-
     return sql.str();
   }
 
@@ -459,5 +716,66 @@ namespace OpenMS
     }
     conn.executeStatement("END TRANSACTION");
   }
-}
 
+  void OpenSwathOSWWriter::startAsyncWriting(Size max_queued_batches)
+  {
+    if (!doWrite_ || async_writer_) return;
+
+    if (max_queued_batches == 0)
+    {
+#ifdef _OPENMP
+      max_queued_batches = 2 * omp_get_max_threads();
+#else
+      max_queued_batches = 2;
+#endif
+    }
+    async_writer_.reset(new AsyncWriter_(output_filename_, max_queued_batches));
+  }
+
+  void OpenSwathOSWWriter::writeRecords(std::vector<FeatureRecords>& records)
+  {
+    boost::shared_ptr<AsyncWriter_> writer = async_writer_;
+    if (writer)
+    {
+      if (writer->push(records)) return;
+
+      // The writer thread has already been stopped through a copy of this object. This is usually
+      // called from OpenMP workers, so instead of throwing, the records are written directly.
+      std::lock_guard<std::mutex> lock(writer->late_write_mutex);
+      writeRecordsDirectly_(records);
+      return;
+    }
+    writeRecordsDirectly_(records);
+  }
+
+  void OpenSwathOSWWriter::writeRecordsDirectly_(std::vector<FeatureRecords>& records) const
+  {
+    SqliteConnector conn(output_filename_);
+    OSWRecordInserter inserter(conn.getDB());
+    conn.executeStatement("BEGIN TRANSACTION");
+    for (const FeatureRecords& r : records)
+    {
+      inserter.insert(r);
+    }
+    conn.executeStatement("END TRANSACTION");
+    records.clear();
+  }
+
+  void OpenSwathOSWWriter::finishAsyncWriting()
+  {
+    if (!async_writer_) return;
+
+    boost::shared_ptr<AsyncWriter_> writer;
+    writer.swap(async_writer_);
+    writer->stop();
+    if (writer->error)
+    {
+      std::rethrow_exception(writer->error);
+    }
+
+    OPENMS_LOG_INFO << "Wrote " << writer->nr_features << " features (" << writer->nr_rows << " rows) to "
+      << output_filename_ << " in " << writer->wall_clock.getClockTime() << " s, writer thread busy for "
+      << writer->busy_time << " s (" << (writer->busy_time > 0 ? writer->nr_rows / writer->busy_time : 0.0)
+      << " rows/s)." << std::endl;
+  }
+}
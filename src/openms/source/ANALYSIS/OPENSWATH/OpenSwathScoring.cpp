@@ -47,6 +47,9 @@
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SpectrumAddition.h>
 
+#include <algorithm>
+#include <tuple>
+
 // basic file operations
 
 namespace OpenMS
@@ -137,29 +140,92 @@ namespace OpenMS
 
     // Identify corresponding SONAR maps (if more than one map is used)
     std::vector<OpenSwath::SwathMap> used_swath_maps;
-    if (swath_maps.size() > 1 || transitions.empty())
+    selectSwathMaps_(swath_maps, transitions, used_swath_maps);
+
+    // find spectrum that is closest to the apex of the peak using binary search
+    OpenSwath::SpectrumPtr spectrum = fetchSpectrumSwath(used_swath_maps, imrmfeature->getRT(), add_up_spectra_, drift_lower, drift_upper);
+
+    OpenSwath::SpectrumPtr ms1_spectrum;
+    if (ms1_map && ms1_map->getNrSpectra() > 0) 
     {
-      double precursor_mz = transitions[0].getPrecursorMZ();
-      for (size_t i = 0; i < swath_maps.size(); ++i)
+      ms1_spectrum = fetchSpectrumSwath(ms1_map, imrmfeature->getRT(), add_up_spectra_, drift_lower, drift_upper);
+    }
+
+    calculateDIAScores_(imrmfeature, transitions, spectrum, ms1_spectrum, diascoring, compound, scores, masserror_ppm);
+  }
+
+  void OpenSwathScoring::calculateDIAScoresBatch(std::vector<DIAScoringTask>& tasks,
+                                                 const std::vector<OpenSwath::SwathMap>& swath_maps,
+                                                 OpenSwath::SpectrumAccessPtr ms1_map,
+                                                 OpenMS::DIAScoring& diascoring)
+  {
+    OPENMS_PRECONDITION(swath_maps.size() > 0, "There needs to be at least one swath map.");
+
+    // The spectrum used for a peak group is fully determined by the spectrum
+    // closest to its apex in each of the used maps and the drift time window.
+    // Sorting the peak groups by this key orders them by apex RT and puts
+    // peak groups that share a spectrum next to each other.
+    typedef std::vector<std::pair<int, const OpenSwath::ISpectrumAccess*> > SpectrumKey;
+    bool use_ms1 = (ms1_map && ms1_map->getNrSpectra() > 0);
+    std::vector<SpectrumKey> keys(tasks.size());
+    std::vector<int> ms1_indices(tasks.size(), -1);
+    std::vector<OpenSwath::SwathMap> used_swath_maps;
+    for (Size i = 0; i < tasks.size(); ++i)
+    {
+      double rt = tasks[i].imrmfeature->getRT();
+      selectSwathMaps_(swath_maps, *tasks[i].transitions, used_swath_maps);
+      for (const auto& m : used_swath_maps)
       {
-        if (swath_maps[i].ms1) {continue;} // skip MS1
-        if (precursor_mz > swath_maps[i].lower && precursor_mz < swath_maps[i].upper)
-        {
-          used_swath_maps.push_back(swath_maps[i]);
-        }
+        keys[i].push_back(std::make_pair(getClosestSpectrumIndex_(m.sptr, rt), m.sptr.get()));
       }
+      if (use_ms1) {ms1_indices[i] = getClosestSpectrumIndex_(ms1_map, rt);}
     }
-    else
+
+    std::vector<Size> order(tasks.size());
+    for (Size i = 0; i < order.size(); ++i) {order[i] = i;}
+    std::sort(order.begin(), order.end(), [&](Size a, Size b)
     {
-      used_swath_maps = swath_maps;
+      return std::tie(keys[a], tasks[a].drift_lower, tasks[a].drift_upper, ms1_indices[a]) <
+             std::tie(keys[b], tasks[b].drift_lower, tasks[b].drift_upper, ms1_indices[b]);
+    });
+
+    // score all peak groups, adding up each spectrum only once
+    OpenSwath::SpectrumPtr spectrum, ms1_spectrum;
+    for (Size n = 0; n < order.size(); ++n)
+    {
+      const Size i = order[n];
+      DIAScoringTask& task = tasks[i];
+      bool same_drift = (n > 0 && tasks[order[n - 1]].drift_lower == task.drift_lower &&
+                         tasks[order[n - 1]].drift_upper == task.drift_upper);
+      if (!same_drift || keys[i] != keys[order[n - 1]])
+      {
+        selectSwathMaps_(swath_maps, *task.transitions, used_swath_maps);
+        std::vector<int> closest_indices;
+        for (const auto& k : keys[i]) {closest_indices.push_back(k.first);}
+        spectrum = fetchSpectrumSwath_(used_swath_maps, closest_indices, add_up_spectra_, task.drift_lower, task.drift_upper);
+      }
+      if (use_ms1 && (!same_drift || ms1_indices[i] != ms1_indices[order[n - 1]]))
+      {
+        ms1_spectrum = getAddedSpectraByIndex_(ms1_map, ms1_indices[i], add_up_spectra_, task.drift_lower, task.drift_upper);
+      }
+
+      calculateDIAScores_(task.imrmfeature, *task.transitions, spectrum, ms1_spectrum, diascoring,
+                          *task.compound, task.scores, task.masserror_ppm);
     }
+  }
 
+  void OpenSwathScoring::calculateDIAScores_(OpenSwath::IMRMFeature* imrmfeature,
+                                             const std::vector<TransitionType>& transitions,
+                                             OpenSwath::SpectrumPtr spectrum,
+                                             OpenSwath::SpectrumPtr ms1_spectrum,
+                                             OpenMS::DIAScoring& diascoring,
+                                             const CompoundType& compound,
+                                             OpenSwath_Scores& scores,
+                                             std::vector<double>& masserror_ppm)
+  {
     std::vector<double> normalized_library_intensity;
     getNormalized_library_intensities_(transitions, normalized_library_intensity);
 
-    // find spectrum that is closest to the apex of the peak using binary search
-    OpenSwath::SpectrumPtr spectrum = fetchSpectrumSwath(used_swath_maps, imrmfeature->getRT(), add_up_spectra_, drift_lower, drift_upper);
-
     // Mass deviation score
     diascoring.dia_massdiff_score(transitions, spectrum, normalized_library_intensity, scores.massdev_score, scores.weighted_massdev_score, masserror_ppm);
 
@@ -184,16 +250,37 @@ namespace OpenMS
       diascoring.dia_by_ion_score(spectrum, aas, by_charge_state, scores.bseries_score, scores.yseries_score);
     }
 
-    if (ms1_map && ms1_map->getNrSpectra() > 0) 
+    if (ms1_spectrum) 
     {
       double precursor_mz = transitions[0].precursor_mz;
-      double rt = imrmfeature->getRT();
-
-      calculatePrecursorDIAScores(ms1_map, diascoring, precursor_mz, rt, compound, scores, drift_lower, drift_upper);
+      calculatePrecursorDIAScores_(ms1_spectrum, diascoring, precursor_mz, compound, scores);
     }
 
   }
 
+  void OpenSwathScoring::selectSwathMaps_(const std::vector<OpenSwath::SwathMap>& swath_maps,
+                                          const std::vector<TransitionType>& transitions,
+                                          std::vector<OpenSwath::SwathMap>& used_swath_maps)
+  {
+    used_swath_maps.clear();
+    if (swath_maps.size() > 1 || transitions.empty())
+    {
+      double precursor_mz = transitions[0].getPrecursorMZ();
+      for (size_t i = 0; i < swath_maps.size(); ++i)
+      {
+        if (swath_maps[i].ms1) {continue;} // skip MS1
+        if (precursor_mz > swath_maps[i].lower && precursor_mz < swath_maps[i].upper)
+        {
+          used_swath_maps.push_back(swath_maps[i]);
+        }
+      }
+    }
+    else
+    {
+      used_swath_maps = swath_maps;
+    }
+  }
+
   void OpenSwathScoring::calculatePrecursorDIAScores(OpenSwath::SpectrumAccessPtr ms1_map, 
                                    OpenMS::DIAScoring & diascoring, 
                                    double precursor_mz, 
@@ -208,27 +295,36 @@ namespace OpenMS
     if (ms1_map && ms1_map->getNrSpectra() > 0)
     {
       OpenSwath::SpectrumPtr ms1_spectrum = fetchSpectrumSwath(ms1_map, rt, add_up_spectra_, drift_lower, drift_upper);
-      diascoring.dia_ms1_massdiff_score(precursor_mz, ms1_spectrum, scores.ms1_ppm_score);
+      calculatePrecursorDIAScores_(ms1_spectrum, diascoring, precursor_mz, compound, scores);
+    }
+  }
 
-      // derive precursor charge state (get from data if possible)
-      int precursor_charge = 1;
-      if (compound.getChargeState() != 0) 
-      {
-        precursor_charge = compound.getChargeState();
-      }
+  void OpenSwathScoring::calculatePrecursorDIAScores_(OpenSwath::SpectrumPtr ms1_spectrum,
+                                                      OpenMS::DIAScoring & diascoring,
+                                                      double precursor_mz,
+                                                      const CompoundType& compound,
+                                                      OpenSwath_Scores & scores)
+  {
+    diascoring.dia_ms1_massdiff_score(precursor_mz, ms1_spectrum, scores.ms1_ppm_score);
 
-      if (compound.isPeptide())
-      {
-        diascoring.dia_ms1_isotope_scores(precursor_mz, ms1_spectrum,
-                                          precursor_charge, scores.ms1_isotope_correlation,
-                                          scores.ms1_isotope_overlap);
-      }
-      else
-      {
-        diascoring.dia_ms1_isotope_scores(precursor_mz, ms1_spectrum,
-                                          precursor_charge, scores.ms1_isotope_correlation,
-                                          scores.ms1_isotope_overlap, compound.sum_formula);
-      }
+    // derive precursor charge state (get from data if possible)
+    int precursor_charge = 1;
+    if (compound.getChargeState() != 0) 
+    {
+      precursor_charge = compound.getChargeState();
+    }
+
+    if (compound.isPeptide())
+    {
+      diascoring.dia_ms1_isotope_scores(precursor_mz, ms1_spectrum,
+                                        precursor_charge, scores.ms1_isotope_correlation,
+                                        scores.ms1_isotope_overlap);
+    }
+    else
+    {
+      diascoring.dia_ms1_isotope_scores(precursor_mz, ms1_spectrum,
+                                        precursor_charge, scores.ms1_isotope_correlation,
+                                        scores.ms1_isotope_overlap, compound.sum_formula);
     }
   }
 
@@ -463,10 +559,22 @@ namespace OpenMS
 
   OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
                                                               double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  {
+    std::vector<int> closest_indices;
+    for (size_t i = 0; i < swath_maps.size(); ++i)
+    {
+      closest_indices.push_back(getClosestSpectrumIndex_(swath_maps[i].sptr, RT));
+    }
+    return fetchSpectrumSwath_(swath_maps, closest_indices, nr_spectra_to_add, drift_lower, drift_upper);
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath_(const std::vector<OpenSwath::SwathMap>& swath_maps,
+                                                               const std::vector<int>& closest_indices,
+                                                               int nr_spectra_to_add, const double drift_lower, const double drift_upper)
   {
     if (swath_maps.size() == 1)
     {
-      return getAddedSpectra_(swath_maps[0].sptr, RT, nr_spectra_to_add, drift_lower, drift_upper);
+      return getAddedSpectraByIndex_(swath_maps[0].sptr, closest_indices[0], nr_spectra_to_add, drift_lower, drift_upper);
     }
     else
     {
@@ -474,7 +582,7 @@ namespace OpenMS
       std::vector<OpenSwath::SpectrumPtr> all_spectra;
       for (size_t i = 0; i < swath_maps.size(); ++i)
       {
-        OpenSwath::SpectrumPtr spec = getAddedSpectra_(swath_maps[i].sptr, RT, nr_spectra_to_add, drift_lower, drift_upper);
+        OpenSwath::SpectrumPtr spec = getAddedSpectraByIndex_(swath_maps[i].sptr, closest_indices[i], nr_spectra_to_add, drift_lower, drift_upper);
         all_spectra.push_back(spec);
       }
       OpenSwath::SpectrumPtr spectrum_ = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
@@ -530,14 +638,12 @@ namespace OpenMS
   }
 
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(OpenSwath::SpectrumAccessPtr swath_map,
-                                                            double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  int OpenSwathScoring::getClosestSpectrumIndex_(OpenSwath::SpectrumAccessPtr swath_map, double RT)
   {
     std::vector<std::size_t> indices = swath_map->getSpectraByRT(RT, 0.0);
-    OpenSwath::SpectrumPtr added_spec(new OpenSwath::Spectrum);
     if (indices.empty() )
     {
-      return added_spec;
+      return -1;
     }
     int closest_idx = boost::numeric_cast<int>(indices[0]);
     if (indices[0] != 0 &&
@@ -546,6 +652,23 @@ namespace OpenMS
     {
       closest_idx--;
     }
+    return closest_idx;
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(OpenSwath::SpectrumAccessPtr swath_map,
+                                                            double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  {
+    return getAddedSpectraByIndex_(swath_map, getClosestSpectrumIndex_(swath_map, RT), nr_spectra_to_add, drift_lower, drift_upper);
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectraByIndex_(OpenSwath::SpectrumAccessPtr swath_map,
+                                                                   int closest_idx, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  {
+    OpenSwath::SpectrumPtr added_spec(new OpenSwath::Spectrum);
+    if (closest_idx < 0)
+    {
+      return added_spec;
+    }
 
     if (nr_spectra_to_add == 1)
     {
@@ -453,6 +453,7 @@ namespace OpenMS
   {
     tsv_writer.writeHeader();
     osw_writer.writeHeader();
+    osw_writer.startAsyncWriting();
 
     bool ms1_only = (swath_maps.size() == 1 && swath_maps[0].ms1);
 
@@ -499,6 +500,9 @@ namespace OpenMS
       writeOutFeaturesAndChroms_(chromatograms, featureFile, out_featureFile, store_features, chromConsumer);
     }
 
+    // precursor m/z index shared by all threads for selecting the transitions of each window
+    const OpenSwathHelper::TransitionIndex transition_index(transition_exp);
+
     std::vector<int> prm_map;
     if (prm_)
     {
@@ -560,42 +564,19 @@ namespace OpenMS
         if (!prm_)
         {
           // Step 1.1: select transitions matching the window
-          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_index, transition_exp_used_all,
               cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
         }
         else
         {
           // Step 1.2: select transitions based on matching PRM window (best window)
-          std::set<std::string> matching_compounds;
+          std::vector<Size> matching_transitions;
           for (Size k = 0; k < prm_map.size(); k++)
           {
-            if (prm_map[k] == i)
-            {
-               const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
-               transition_exp_used_all.transitions.push_back(tr);
-               matching_compounds.insert(tr.getPeptideRef());
-            }
-          }
-
-          std::set<std::string> matching_proteins;
-          for (Size i = 0; i < transition_exp.compounds.size(); i++)
-          {
-            if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
-            {
-              transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
-              for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
-              {
-                matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
-              }
-            }
-          }
-          for (Size i = 0; i < transition_exp.proteins.size(); i++)
-          {
-            if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
-            {
-              transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
-            }
+            if (prm_map[k] == i) matching_transitions.push_back(k);
           }
+          OpenSwathHelper::selectTransitions(transition_exp, transition_index,
+              matching_transitions, transition_exp_used_all);
         }
 
         if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
@@ -722,6 +703,9 @@ namespace OpenMS
 
     }
     this->endProgress();
+
+    // wait for the OSW writer thread to write out all features
+    osw_writer.finishAsyncWriting();
     
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
@@ -903,16 +887,23 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String> to_tsv_output;
+    std::vector<OpenSwathOSWWriter::FeatureRecords> to_osw_output;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
     ///////////////////////////////////
-    for (AssayMapT::iterator assay_it = assay_map.begin(); assay_it != assay_map.end(); ++assay_it)
+    // All transition groups are picked first, so that the full spectrum
+    // (DIA) scores of all peak groups in this window can be computed
+    // together, sharing the spectra at nearby peak apices.
+    std::vector<MRMTransitionGroupType> transition_groups(assay_map.size());
+    std::vector<int> detection_assay_its(assay_map.size(), -1);
+    Size assay_idx = 0;
+    for (AssayMapT::iterator assay_it = assay_map.begin(); assay_it != assay_map.end(); ++assay_it, ++assay_idx)
     {
       // Create new MRMTransitionGroup
       String id = assay_it->first;
-      MRMTransitionGroupType transition_group;
+      MRMTransitionGroupType& transition_group = transition_groups[assay_idx];
       transition_group.setTransitionGroupID(id);
       double expected_rt = transition_exp.getCompounds()[ assay_peptide_map[id] ].rt;
 
@@ -956,9 +947,7 @@ namespace OpenMS
         transition_group.addTransition(*transition, transition->getNativeID());
         transition_group.addChromatogram(chromatogram, chromatogram.getNativeID());
       }
-
-      // currently .tsv, .osw and .featureXML are mutually exclusive
-      if (tsv_writer.isActive() || osw_writer.isActive()) { output.clear(); }
+      detection_assay_its[assay_idx] = detection_assay_it;
 
       // 2. Set the MS1 chromatograms for the different isotopes, if available
       // (note that for 3 isotopes, we include the monoisotopic peak plus three
@@ -973,8 +962,30 @@ namespace OpenMS
         }
       }
 
-      // 3. / 4. Process the MRMTransitionGroup: find peakgroups and score them
+      // 3. Process the MRMTransitionGroup: find peakgroups
       trgroup_picker.pickTransitionGroup(transition_group);
+    }
+
+    // 4. Score the peakgroups, computing the DIA scores of all of them at once
+    if (!ms1only)
+    {
+      std::vector<MRMTransitionGroupType*> picked_groups;
+      for (Size i = 0; i < transition_groups.size(); ++i)
+      {
+        picked_groups.push_back(&transition_groups[i]);
+      }
+      featureFinder.precomputeDIAScores(picked_groups, swath_maps);
+    }
+    assay_idx = 0;
+    for (AssayMapT::iterator assay_it = assay_map.begin(); assay_it != assay_map.end(); ++assay_it, ++assay_idx)
+    {
+      String id = assay_it->first;
+      MRMTransitionGroupType& transition_group = transition_groups[assay_idx];
+      int detection_assay_it = detection_assay_its[assay_idx];
+
+      // currently .tsv, .osw and .featureXML are mutually exclusive
+      if (tsv_writer.isActive() || osw_writer.isActive()) { output.clear(); }
+
       featureFinder.scorePeakgroups(transition_group, trafo, swath_maps, output, ms1only);
 
       // Ensure that a detection transition is used to derive features for output
@@ -997,8 +1008,11 @@ namespace OpenMS
       {
         const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
         const TransitionType* transition = assay_it->second[detection_assay_it];
-        to_osw_output.push_back(osw_writer.prepareLine(pep, transition, output, id));
+        to_osw_output.push_back(osw_writer.prepareRecords(pep, transition, output, id));
       }
+
+      // release the chromatograms of this transition group
+      transition_group = MRMTransitionGroupType();
     }
 
     // Only write at the very end since this is a step that needs a barrier
@@ -1012,15 +1026,10 @@ namespace OpenMS
       }
     }
 
-    // Only write at the very end since this is a step that needs a barrier
+    // Hand over to the background writer thread (see performExtraction), no barrier needed
     if (osw_writer.isActive())
     {
-#ifdef _OPENMP
-#pragma omp critical (osw_write_tsv)
-#endif
-      {
-        osw_writer.writeLines(to_osw_output);
-      }
+      osw_writer.writeRecords(to_osw_output);
     }
   }
 
@@ -1109,6 +1118,7 @@ namespace OpenMS
     {
       tsv_writer.writeHeader();
       osw_writer.writeHeader();
+      osw_writer.startAsyncWriting();
 
       // Compute inversion of the transformation
       TransformationDescription trafo_inverse = trafo;
@@ -1140,6 +1150,9 @@ namespace OpenMS
       int progress = 0;
       this->startProgress(0, sonar_total_win, "Extracting and scoring transitions");
 
+      // precursor m/z index shared by all threads for selecting the transitions of each window
+      const OpenSwathHelper::TransitionIndex transition_index(transition_exp);
+
       ///////////////////////////////////////////////////////////////////////////
       // Iterate through all SONAR windows
       // We set dynamic scheduling such that the SONAR windows are worked on in
@@ -1157,7 +1170,7 @@ namespace OpenMS
 
         // Step 1: select which transitions to extract with the current windows (proceed in batches)
         OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_index, transition_exp_used_all,
             0, currwin_start, currwin_end);
 
         if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
@@ -1271,6 +1284,9 @@ namespace OpenMS
         this->setProgress(++progress);
       }
       this->endProgress();
+
+      // wait for the OSW writer thread to write out all features
+      osw_writer.finishAsyncWriting();
     }
 
 
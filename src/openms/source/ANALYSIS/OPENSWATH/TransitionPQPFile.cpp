@@ -37,6 +37,8 @@
 #include <sqlite3.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
+#include <unordered_set>
+
 namespace OpenMS
 {
 
@@ -63,6 +65,14 @@ namespace OpenMS
   }
 
   void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  {
+    readPQPInput_(filename, &transition_list, nullptr, legacy_traml_id);
+  }
+
+  void TransitionPQPFile::readPQPInput_(const char* filename,
+                                        std::vector<TSVTransition>* transition_list,
+                                        OpenSwath::LightTargetedExperiment* light_exp,
+                                        bool legacy_traml_id)
   {
     sqlite3 *db;
     sqlite3_stmt * cntstmt;
@@ -105,6 +115,24 @@ namespace OpenMS
                   "INNER JOIN GENE ON PEPTIDE_GENE_MAPPING.GENE_ID = GENE.ID ";
     }
 
+    // When converting directly to the light representation, only read the
+    // columns it uses (and skip the peptidoform aggregation)
+    const bool light = (light_exp != nullptr);
+    String select_annotation = light ? "NULL" : "TRANSITION.ANNOTATION";
+    String select_ordinal = light ? "NULL" : "TRANSITION.ORDINAL";
+    String select_type = light ? "NULL" : "TRANSITION.TYPE";
+    String select_peptidoforms = light ? "NULL" : "PEPTIDE_AGGREGATED.PEPTIDOFORMS";
+    String join_peptidoforms = "";
+    if (!light)
+    {
+      join_peptidoforms = "LEFT OUTER JOIN " \
+                            "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
+                            "FROM TRANSITION_PEPTIDE_MAPPING "\
+                            "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
+                            "GROUP BY TRANSITION_ID) "\
+                            "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+    }
+
     // Get peptides
     select_sql = "SELECT " \
                   "PRECURSOR.PRECURSOR_MZ AS precursor, " \
@@ -126,16 +154,16 @@ namespace OpenMS
                   "PRECURSOR.CHARGE AS precursor_charge, " \
                   "PRECURSOR.GROUP_LABEL AS peptide_group_label, " \
                   "NULL AS label_type, " \
-                  "TRANSITION.CHARGE AS fragment_charge, " \
-                  "TRANSITION.ORDINAL AS fragment_nr, " \
+                  "TRANSITION.CHARGE AS fragment_charge, " +
+                  select_ordinal + " AS fragment_nr, " \
                   "NULL AS fragment_mzdelta, " \
-                  "NULL AS fragment_modification, " \
-                  "TRANSITION.TYPE AS fragment_type, " \
+                  "NULL AS fragment_modification, " +
+                  select_type + " AS fragment_type, " \
                   "NULL AS uniprot_id, " \
                   "TRANSITION.DETECTING AS detecting_transition, " \
                   "TRANSITION.IDENTIFYING AS identifying_transition, " \
-                  "TRANSITION.QUANTIFYING AS quantifying_transition, " \
-                  "PEPTIDE_AGGREGATED.PEPTIDOFORMS AS peptidoforms " + \
+                  "TRANSITION.QUANTIFYING AS quantifying_transition, " +
+                  select_peptidoforms + " AS peptidoforms " + \
                   select_drift_time + \
                   select_gene + \
                   "FROM PRECURSOR " + \
@@ -149,13 +177,8 @@ namespace OpenMS
                     "FROM PROTEIN " \
                     "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID "\
                     "GROUP BY PEPTIDE_ID) " \
-                    "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " \
-                  "LEFT OUTER JOIN " \
-                    "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
-                    "FROM TRANSITION_PEPTIDE_MAPPING "\
-                    "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
-                    "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                    "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " +
+                  join_peptidoforms;
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -168,8 +191,8 @@ namespace OpenMS
                   "PRECURSOR." + traml_id + " AS group_id, " \
                   "TRANSITION.DECOY AS decoy, " \
                   "NULL AS PeptideSequence, " \
-                  "NULL AS ProteinName, " \
-                  "TRANSITION.ANNOTATION AS Annotation, " \
+                  "NULL AS ProteinName, " +
+                  select_annotation + " AS Annotation, " \
                   "NULL AS FullPeptideName, " \
                   "COMPOUND.COMPOUND_NAME AS CompoundName, " \
                   "COMPOUND.SMILES AS SMILES, " \
@@ -178,11 +201,11 @@ namespace OpenMS
                   "PRECURSOR.CHARGE AS precursor_charge, " \
                   "PRECURSOR.GROUP_LABEL AS peptide_group_label, " \
                   "NULL AS label_type, " \
-                  "TRANSITION.CHARGE AS fragment_charge, " \
-                  "TRANSITION.ORDINAL AS fragment_nr, " \
+                  "TRANSITION.CHARGE AS fragment_charge, " +
+                  select_ordinal + " AS fragment_nr, " \
                   "NULL AS fragment_mzdelta, " \
-                  "NULL AS fragment_modification, " \
-                  "TRANSITION.TYPE AS fragment_type, " \
+                  "NULL AS fragment_modification, " +
+                  select_type + " AS fragment_type, " \
                   "NULL AS uniprot_id, " \
                   "TRANSITION.DETECTING AS detecting_transition, " \
                   "TRANSITION.IDENTIFYING AS identifying_transition, " \
@@ -201,13 +224,31 @@ namespace OpenMS
     SqliteConnector::executePreparedStatement(db, &stmt, select_sql);
     sqlite3_step( stmt );
 
+    // Identifiers of the compounds and proteins added to light_exp
+    std::unordered_set<std::string> compound_ids;
+    std::unordered_set<std::string> protein_ids;
+    Size first_compound = 0;
+    if (light)
+    {
+      light_exp->transitions.reserve(light_exp->transitions.size() + num_transitions);
+      first_compound = light_exp->compounds.size();
+    }
+    else
+    {
+      transition_list->reserve(transition_list->size() + num_transitions);
+    }
+
+    // the current row (only kept if a transition list is requested)
+    std::vector<TSVTransition> row(1);
+
     Size progress = 0;
     startProgress(0, num_transitions, "reading PQP file");
     // Convert SQLite data to TSVTransition data structure
     while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
     {
       setProgress(progress++);
-      TSVTransition mytransition;
+      row[0] = TSVTransition();
+      TSVTransition& mytransition = row[0];
 
       Sql::extractValue<double>(&mytransition.precursor, stmt, 0);
       Sql::extractValue<double>(&mytransition.product, stmt, 1);
@@ -253,12 +294,24 @@ namespace OpenMS
 
       if (mytransition.GeneName == "NA") mytransition.GeneName = "";
 
-      transition_list.push_back(mytransition);
+      if (light)
+      {
+        addLightTransition_(row.cbegin(), *light_exp, compound_ids, protein_ids);
+      }
+      else
+      {
+        transition_list->push_back(mytransition);
+      }
       sqlite3_step( stmt );
     }
     endProgress();
 
     sqlite3_finalize(stmt);
+
+    if (light)
+    {
+      resolveMixedSequenceGroups_(light_exp->compounds.begin() + first_compound, light_exp->compounds.end());
+    }
   }
 
   void TransitionPQPFile::writePQPOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp)
@@ -698,9 +751,8 @@ namespace OpenMS
                                                          OpenSwath::LightTargetedExperiment& targeted_exp,
                                                          bool legacy_traml_id)
   {
-    std::vector<TSVTransition> transition_list;
-    readPQPInput_(filename, transition_list, legacy_traml_id);
-    TSVToTargetedExperiment_(transition_list, targeted_exp);
+    // stream rows directly into the light representation
+    readPQPInput_(filename, nullptr, &targeted_exp, legacy_traml_id);
   }
 
 }
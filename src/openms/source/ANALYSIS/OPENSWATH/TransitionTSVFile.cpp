@@ -672,72 +672,116 @@ namespace OpenMS
 
   void TransitionTSVFile::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
+    std::unordered_set<std::string> compound_ids;
+    std::unordered_set<std::string> protein_ids;
 
     resolveMixedSequenceGroups_(transition_list);
 
     Size progress = 0;
+    exp.transitions.reserve(exp.transitions.size() + transition_list.size());
     startProgress(0, transition_list.size(), "conversion to internal data representation");
     for (auto tr_it = transition_list.cbegin(); tr_it != transition_list.cend(); ++tr_it)
     {
-      OpenSwath::LightTransition transition;
-      transition.transition_name  = tr_it->transition_name;
-      transition.peptide_ref  = tr_it->group_id;
-      transition.library_intensity  = tr_it->library_intensity;
-      transition.precursor_mz  = tr_it->precursor;
-      transition.product_mz  = tr_it->product;
-      transition.fragment_charge = 0; // use zero for charge that is not set
-      if (!tr_it->fragment_charge.empty() && tr_it->fragment_charge != "NA")
+      addLightTransition_(tr_it, exp, compound_ids, protein_ids);
+      setProgress(progress++);
+    }
+    endProgress();
+
+    OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
+  }
+
+  void TransitionTSVFile::addLightTransition_(std::vector<TSVTransition>::const_iterator tr_it,
+                                              OpenSwath::LightTargetedExperiment& exp,
+                                              std::unordered_set<std::string>& compound_ids,
+                                              std::unordered_set<std::string>& protein_ids)
+  {
+    OpenSwath::LightTransition transition;
+    transition.transition_name  = tr_it->transition_name;
+    transition.peptide_ref  = tr_it->group_id;
+    transition.library_intensity  = tr_it->library_intensity;
+    transition.precursor_mz  = tr_it->precursor;
+    transition.product_mz  = tr_it->product;
+    transition.fragment_charge = 0; // use zero for charge that is not set
+    if (!tr_it->fragment_charge.empty() && tr_it->fragment_charge != "NA")
+    {
+      transition.fragment_charge = tr_it->fragment_charge.toInt();
+    }
+
+    transition.decoy = tr_it->decoy;
+    transition.detecting_transition = tr_it->detecting_transition;
+    transition.identifying_transition = tr_it->identifying_transition;
+    transition.quantifying_transition = tr_it->quantifying_transition;
+
+    exp.transitions.push_back(transition);
+
+    // check whether we need a new compound
+    if (compound_ids.find(tr_it->group_id) == compound_ids.end())
+    {
+      OpenSwath::LightCompound compound;
+      if (tr_it->isPeptide())
       {
-        transition.fragment_charge = tr_it->fragment_charge.toInt();
+        OpenMS::TargetedExperiment::Peptide tramlpeptide;
+        createPeptide_(tr_it, tramlpeptide);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
       }
+      else
+      {
+        OpenMS::TargetedExperiment::Compound tramlcompound;
+        createCompound_(tr_it, tramlcompound);
+        OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
+      }
+      exp.compounds.push_back(compound);
+      compound_ids.insert(compound.id);
+    }
 
-      transition.decoy = tr_it->decoy;
-      transition.detecting_transition = tr_it->detecting_transition;
-      transition.identifying_transition = tr_it->identifying_transition;
-      transition.quantifying_transition = tr_it->quantifying_transition;
+    // check whether we need new proteins
+    for (Size i = 0; i < tr_it->ProteinName.size(); ++i)
+    {
+      if (tr_it->isPeptide() && protein_ids.find(tr_it->ProteinName[i]) == protein_ids.end())
+      {
+        OpenSwath::LightProtein protein;
+        protein.id = tr_it->ProteinName[i];
+        protein.sequence = "";
+        exp.proteins.push_back(protein);
+        protein_ids.insert(tr_it->ProteinName[i]);
+      }
+    }
+  }
 
-      exp.transitions.push_back(transition);
+  void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<OpenSwath::LightCompound>::iterator first,
+                                                      std::vector<OpenSwath::LightCompound>::iterator last) const
+  {
+    // The sequence of the first compound of each peptide label group (all
+    // transitions of a compound share its label and sequence, so this is
+    // the same check as for the individual transitions)
+    std::map<String, String> label_sequence;
+    for (auto comp_it = first; comp_it != last; ++comp_it)
+    {
+      if (comp_it->peptide_group_label.empty()) continue;
 
-      // check whether we need a new compound
-      if (compound_map.find(tr_it->group_id) == compound_map.end())
+      auto label_it = label_sequence.insert(std::make_pair(comp_it->peptide_group_label, comp_it->sequence)).first;
+      const String& curr_sequence = label_it->second;
+
+      // Sanity check: different peptide sequence in the same peptide label
+      // group means that something is probably wrong ...
+      if (!curr_sequence.empty() && comp_it->sequence != curr_sequence)
       {
-        OpenSwath::LightCompound compound;
-        if (tr_it->isPeptide())
+        if (override_group_label_check_)
         {
-          OpenMS::TargetedExperiment::Peptide tramlpeptide;
-          createPeptide_(tr_it, tramlpeptide);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
+          // We wont fix it but give out a warning
+          OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+            ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
         }
         else
         {
-          OpenMS::TargetedExperiment::Compound tramlcompound;
-          createCompound_(tr_it, tramlcompound);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
+          // Lets fix it and inform the user
+          OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+            ". This is most likely an error and to fix this, a new peptide label group will be inferred - " <<
+            "to override this decision, please use the override_group_label_check parameter." << std::endl;
+          comp_it->peptide_group_label = comp_it->id;
         }
-        exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
       }
-
-      // check whether we need new proteins
-      for (Size i = 0; i < tr_it->ProteinName.size(); ++i)
-      {
-        if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName[i]) == protein_map.end())
-        {
-          OpenSwath::LightProtein protein;
-          protein.id = tr_it->ProteinName[i];
-          protein.sequence = "";
-          exp.proteins.push_back(protein);
-          protein_map[tr_it->ProteinName[i]] = 0;
-        }
-      }
-
-      setProgress(progress++);
     }
-    endProgress();
-
-    OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
   }
 
   void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list) const
@@ -43,6 +43,9 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <cmath>
+#include <exception>
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -54,20 +57,6 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
-  /// small quality control class, holding temporary data for reporting
-  struct ChannelQC
-  {
-    // C'tor
-    ChannelQC() :
-      mz_deltas(),
-      signal_not_unique(0)
-    {}
-
-    std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
-    int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
-  };
-
-
   IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
     baseExperiment(targetExp)
   {
@@ -241,28 +230,28 @@ namespace OpenMS
     return false;
   }
 
-  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
+  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
   {
 
     typedef PeakMap::SpectrumType::ConstIterator const_spec_iterator;
 
     // compute distance between isotopic peaks based on the precursor charge.
-    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec->getPrecursors()[0].getCharge());
+    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec.getPrecursors()[0].getCharge());
 
     // the actual boundary values
-    const double strict_lower_mz = ms2_spec->getPrecursors()[0].getMZ() - ms2_spec->getPrecursors()[0].getIsolationWindowLowerOffset();
-    const double strict_upper_mz = ms2_spec->getPrecursors()[0].getMZ() + ms2_spec->getPrecursors()[0].getIsolationWindowUpperOffset();
+    const double strict_lower_mz = ms2_spec.getPrecursors()[0].getMZ() - ms2_spec.getPrecursors()[0].getIsolationWindowLowerOffset();
+    const double strict_upper_mz = ms2_spec.getPrecursors()[0].getMZ() + ms2_spec.getPrecursors()[0].getIsolationWindowUpperOffset();
 
     const double fuzzy_lower_mz = strict_lower_mz - (strict_lower_mz * max_precursor_isotope_deviation_ / 1000000);
     const double fuzzy_upper_mz = strict_upper_mz + (strict_upper_mz * max_precursor_isotope_deviation_ / 1000000);
 
     // first find the actual precursor peak
-    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec->getPrecursors()[0].getMZ());
+    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec.getPrecursors()[0].getMZ());
     const Peak1D& precursor_peak = precursor_spec[precursor_peak_idx];
 
     // now we get ourselves some border iterators
     const_spec_iterator lower_bound = precursor_spec.MZBegin(fuzzy_lower_mz);
-    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec->getPrecursors()[0].getMZ());
+    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec.getPrecursors()[0].getMZ());
 
     Peak1D::IntensityType precursor_intensity = precursor_peak.getIntensity();
     Peak1D::IntensityType total_intensity = precursor_peak.getIntensity();
@@ -325,7 +314,7 @@ namespace OpenMS
     // try to find a match for our isotopic peak on the right
 
     // redefine bounds
-    lower_bound = precursor_spec.MZBegin(ms2_spec->getPrecursors()[0].getMZ());
+    lower_bound = precursor_spec.MZBegin(ms2_spec.getPrecursors()[0].getMZ());
     upper_bound = precursor_spec.MZEnd(fuzzy_upper_mz);
 
     expected_next_mz = precursor_peak.getMZ() + charge_dist;
@@ -416,32 +405,33 @@ namespace OpenMS
     return precursor_intensity / total_intensity;
   }
 
-  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const
+  double IsobaricChannelExtractor::computePrecursorPurity_(const ExtractionTask_& task) const
   {
+    const MSSpectrum& ms2_spec = *task.spectrum;
     // we cannot analyze precursors without a charge
-    if (ms2_spec->getPrecursors()[0].getCharge() == 0)
+    if (ms2_spec.getPrecursors()[0].getCharge() == 0)
     {
       return 1.0;
     }
     else
     {
 #ifdef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
-      std::cerr << "------------------ analyzing " << ms2_spec->getNativeID() << std::endl;
+      std::cerr << "------------------ analyzing " << ms2_spec.getNativeID() << std::endl;
 #endif
 
       // compute purity of preceding ms1 scan
-      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.precursorScan));
+      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *task.precursor_scan);
 
-      if (pState.hasFollowUpScan && interpolate_precursor_purity_)
+      if (task.follow_up_scan != nullptr && interpolate_precursor_purity_)
       {
-        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.followUpScan));
+        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *task.follow_up_scan);
 
         // calculating the extrapolated, S2I value as a time weighted linear combination of the two scans
         // see: Savitski MM, Sweetman G, Askenazi M, Marto JA, Lang M, Zinn N, et al. (2011).
         // Analytical chemistry 83: 8959–67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
         // std::fabs is applied to compensate for potentially negative RTs
-        return std::fabs(ms2_spec->getRT() - pState.precursorScan->getRT()) *
-               ((late_scan_purity - early_scan_purity) / std::fabs(pState.followUpScan->getRT() - pState.precursorScan->getRT()))
+        return std::fabs(ms2_spec.getRT() - task.precursor_scan->getRT()) *
+               ((late_scan_purity - early_scan_purity) / std::fabs(task.follow_up_scan->getRT() - task.precursor_scan->getRT()))
                + early_scan_purity;
       }
       else
@@ -451,208 +441,171 @@ namespace OpenMS
     }
   }
 
-  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  void IsobaricChannelExtractor::extractReporters_(const MSSpectrum& spectrum, std::vector<ChannelSignal_>& channels) const
   {
-    if (ms_exp_data.empty())
-    {
-      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
-                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
-    }
-
-    // check if RT is sorted (we rely on it)
-    if (!ms_exp_data.isSorted(false))
-    {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
-    }
-
-    // clear the output map
-    consensus_map.clear(false);
-    consensus_map.setExperimentType("labeled_MS2");
-
-    // create predicate for spectrum checking
-    OPENMS_LOG_INFO << "Selecting scans with activation mode: " << (selected_activation_ == "" ? "any" : selected_activation_) << std::endl;
-    HasActivationMethod<PeakMap::SpectrumType> isValidActivation(ListUtils::create<String>(selected_activation_));
-
-    // walk through spectra and count the number of scans with valid activation method per MS-level
-    // only the highest level will be used for quantification (e.g. MS3, if present)
-    std::map<UInt, UInt> ms_level;
-    std::map<String, int> activation_modes;
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
-    {
-      if (it->getMSLevel() == 1) continue; // never report MS1
-      ++activation_modes[getActivationMethod_(*it)]; // count HCD, CID, ...
-      if (selected_activation_ == "" || isValidActivation(*it))
-      {
-        ++ms_level[it->getMSLevel()];
-      }
-    }
-    if (ms_level.empty())
-    {
-      OPENMS_LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
-               << "Activation modes found:\n";
-      for (std::map<String, int>::const_iterator it = activation_modes.begin(); it != activation_modes.end(); ++it)
-      {
-        OPENMS_LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
-      }
-      OPENMS_LOG_WARN << "Result will be empty!" << std::endl;
-      return;
-    }
-    OPENMS_LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
-    for (std::map<UInt, UInt>::const_iterator it = ms_level.begin(); it != ms_level.end(); ++it)
-    {
-      OPENMS_LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
-    }
-    UInt quant_ms_level = ms_level.rbegin()->first;
-    OPENMS_LOG_INFO << "Using MS-level " << quant_ms_level << " for quantification." << std::endl;
-
-    // now we have picked data
-    // --> assign peaks to channels
-    UInt64 element_index(0);
-
-    // remember the current precursor spectrum
-    PuritySate_ pState(ms_exp_data);
-
-    typedef std::map<String, ChannelQC > ChannelQCSet;
-    ChannelQCSet channel_mz_delta;
     const double qc_dist_mz = 0.5; // fixed! Do not change!
 
-    Size number_of_channels = quant_method_->getNumberOfChannels();
-
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-
-    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    const IsobaricQuantitationMethod::IsobaricChannelList& channel_list = quant_method_->getChannelInformation();
+    channels.resize(channel_list.size());
+    for (Size i = 0; i < channel_list.size(); ++i)
     {
-      // remember the last MS1 spectra as we assume it to be the precursor spectrum
-      if (it->getMSLevel() ==  1)
+      const double center = channel_list[i].center;
+      ChannelSignal_& signal = channels[i];
+      signal.intensity = 0;
+      signal.mz_delta = 0;
+      signal.found = false;
+      signal.not_unique = false;
+
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const PeakMap::SpectrumType::ConstIterator mz_end = spectrum.MZEnd(center + qc_dist_mz);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
+      for (PeakMap::SpectrumType::ConstIterator mz_it = spectrum.MZBegin(center - qc_dist_mz);
+            mz_it != mz_end;
+            ++mz_it)
       {
-        // remember potential precursor and continue
-        pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
-        continue;
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - center)))) // closer to best candidate
+        {
+          idx_nearest = mz_it;
+        }
       }
-
-      if (it->getMSLevel() != quant_ms_level) continue;
-      if ((*it).empty()) continue; // skip empty spectra
-      if (!(selected_activation_.empty() || isValidActivation(*it))) continue;
-
-      // find following ms1 scan (needed for purity computation)
-      if (!pState.followUpValid(it->getRT()))
+      if (idx_nearest != mz_end)
       {
-        // advance iterator
-        pState.advanceFollowUp(it->getRT());
+        signal.found = true;
+        // stats: we don't care what shift the user specified
+        signal.mz_delta = center - idx_nearest->getMZ();
+        signal.not_unique = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(signal.mz_delta) < reporter_mass_shift_)
+        {
+          signal.intensity = idx_nearest->getIntensity();
+        }
       }
 
-      // check precursor constraints
-      if (!isValidPrecursor_(it->getPrecursors()[0]))
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (signal.intensity < min_reporter_intensity_)
       {
-        OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
-        continue;
+        signal.intensity = 0;
       }
+    }
+  }
+
+  void IsobaricChannelExtractor::extractTasks_(const std::vector<ExtractionTask_>& tasks, std::vector<ExtractionResult_>& results) const
+  {
+    results.resize(tasks.size());
+    // exceptions must not leave the parallel region: the one of the first failing task is rethrown afterwards
+    std::exception_ptr error;
+    SignedSize error_task = (SignedSize)tasks.size();
+    // the spectra are independent of each other, only the (shared) input spectra are read
+#pragma omp parallel for schedule(dynamic, 16)
+    for (SignedSize i = 0; i < (SignedSize)tasks.size(); ++i)
+    {
+      const ExtractionTask_& task = tasks[i];
+      ExtractionResult_& result = results[i];
+      result.precursor_purity = -1.0;
+      result.pure = true;
+      result.channels.clear();
 
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+      try
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
-        // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
+        // check precursor purity if we have a valid precursor ..
+        if (task.precursor_scan != nullptr)
         {
-          OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
-          continue;
+          result.precursor_purity = computePrecursorPurity_(task);
+          // check if purity is high enough
+          if (result.precursor_purity < min_precursor_purity_)
+          {
+            result.pure = false;
+            continue;
+          }
         }
+        extractReporters_(*task.spectrum, result.channels);
       }
-      else
+      catch (...)
       {
-        OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
+#pragma omp critical (IsobaricChannelExtractor_extractTasks)
+        {
+          if (i < error_task)
+          {
+            error = std::current_exception();
+            error_task = i;
+          }
+        }
       }
+    }
+    if (error) std::rethrow_exception(error);
+  }
 
-      if (it->getMSLevel() == 3)
-      {
-        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
-        it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
+  void IsobaricChannelExtractor::appendFeatures_(const std::vector<ExtractionTask_>& tasks,
+                                                 const std::vector<ExtractionResult_>& results,
+                                                 ConsensusMap& consensus_map,
+                                                 ChannelQCSet_& channel_qc,
+                                                 UInt64& element_index) const
+  {
+    const IsobaricQuantitationMethod::IsobaricChannelList& channel_list = quant_method_->getChannelInformation();
 
-        if (it_last_MS2 == ms_exp_data.end())
-        { // this only happens if an MS3 spec does not have a preceding MS2
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
-        }
+    for (Size i = 0; i < tasks.size(); ++i)
+    {
+      const MSSpectrum& spectrum = *tasks[i].spectrum;
+      const ExtractionResult_& result = results[i];
+
+      if (!result.pure)
+      {
+        OPENMS_LOG_DEBUG << "Skip spectrum " << spectrum.getNativeID() << ": Precursor purity is below the threshold. [purity = " << result.precursor_purity << "]" << std::endl;
+        continue;
       }
-      else
+      if (tasks[i].precursor_scan == nullptr)
       {
-        it_last_MS2 = it;
+        OPENMS_LOG_INFO << "No precursor available for spectrum: " << spectrum.getNativeID() << std::endl;
+      }
+
+      const MSSpectrum* last_ms2 = tasks[i].ms2_spectrum;
+      if (last_ms2 == nullptr)
+      { // this only happens if an MS3 spec does not have a preceding MS2
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + spectrum.getNativeID() + " with RT " + String(spectrum.getRT()));
       }
 
       // check if MS1 precursor info is available
-      if (it_last_MS2->getPrecursors().empty())
+      if (last_ms2->getPrecursors().empty())
       {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + spectrum.getNativeID() + " with RT " + String(spectrum.getRT()));
       }
 
       // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
       ConsensusFeature cf;
       cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
+      cf.setRT(last_ms2->getRT());
+      cf.setMZ(last_ms2->getPrecursors()[0].getMZ());
 
       Peak2D channel_value;
-      channel_value.setRT(it->getRT());
-      // for each each channel
-      UInt64 map_index = 0;
+      channel_value.setRT(spectrum.getRT());
       Peak2D::IntensityType overall_intensity = 0;
 
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
+      // for each each channel
+      for (Size map_index = 0; map_index < channel_list.size(); ++map_index)
       {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
+        const ChannelSignal_& signal = result.channels[map_index];
+        if (signal.found)
         {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
-        }
-        if (idx_nearest != mz_end)
-        {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
-          {
-            channel_value.setIntensity(idx_nearest->getIntensity());
-          }
+          ChannelQC_& qc = channel_qc[channel_list[map_index].name];
+          qc.mz_deltas.push_back(signal.mz_delta);
+          if (signal.not_unique) ++qc.signal_not_unique;
         }
 
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
-        {
-          channel_value.setIntensity(0);
-        }
+        // set mz-position of channel
+        channel_value.setMZ(channel_list[map_index].center);
+        channel_value.setIntensity(signal.intensity);
 
         overall_intensity += channel_value.getIntensity();
         // add channel to ConsensusFeature
         cf.insert(map_index, channel_value, element_index);
-        ++map_index;
       } // ! channel_iterator
 
       // check if we keep this feature or if it contains low-intensity quantifications
@@ -667,23 +620,29 @@ namespace OpenMS
         cf.setMetaValue("all_empty", String("true"));
       }
       // add purity information if we could compute it
-      if (precursor_purity > 0.0)
+      if (result.precursor_purity > 0.0)
       {
-        cf.setMetaValue("precursor_purity", precursor_purity);
+        cf.setMetaValue("precursor_purity", result.precursor_purity);
       }
 
       // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
+      cf.setMetaValue("scan_id", spectrum.getNativeID());
       // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
+      cf.setMetaValue("precursor_intensity", spectrum.getPrecursors()[0].getIntensity());
 
-      cf.setCharge(it->getPrecursors()[0].getCharge());
+      cf.setCharge(spectrum.getPrecursors()[0].getCharge());
       cf.setIntensity(overall_intensity);
       consensus_map.push_back(cf);
 
       // the tandem-scan in the order they appear in the experiment
       ++element_index;
-    } // ! Experiment iterator
+    }
+  }
+
+  void IsobaricChannelExtractor::logChannelQC_(ChannelQCSet_& channel_mz_delta) const
+  {
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
+    Size number_of_channels = quant_method_->getNumberOfChannels();
 
     // print stats about m/z calibration / presence of signal
     OPENMS_LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
@@ -722,7 +681,135 @@ namespace OpenMS
     if (impurities_found) OPENMS_LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found." 
                                    << "They can be ignored if the spectra are m/z calibrated (see above), since only the peak closest to the theoretical position is used for quantification!";
     OPENMS_LOG_INFO << std::endl;
+  }
+
+  UInt IsobaricChannelExtractor::selectQuantMSLevel_(const std::map<UInt, UInt>& ms_level, const std::map<String, int>& activation_modes) const
+  {
+    if (ms_level.empty())
+    {
+      OPENMS_LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
+               << "Activation modes found:\n";
+      for (std::map<String, int>::const_iterator it = activation_modes.begin(); it != activation_modes.end(); ++it)
+      {
+        OPENMS_LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
+      }
+      OPENMS_LOG_WARN << "Result will be empty!" << std::endl;
+      return 0;
+    }
+    OPENMS_LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
+    for (std::map<UInt, UInt>::const_iterator it = ms_level.begin(); it != ms_level.end(); ++it)
+    {
+      OPENMS_LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
+    }
+    UInt quant_ms_level = ms_level.rbegin()->first;
+    OPENMS_LOG_INFO << "Using MS-level " << quant_ms_level << " for quantification." << std::endl;
+    return quant_ms_level;
+  }
+
+  void IsobaricChannelExtractor::extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map)
+  {
+    if (ms_exp_data.empty())
+    {
+      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    // check if RT is sorted (we rely on it)
+    if (!ms_exp_data.isSorted(false))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+
+    // clear the output map
+    consensus_map.clear(false);
+    consensus_map.setExperimentType("labeled_MS2");
+
+    // create predicate for spectrum checking
+    OPENMS_LOG_INFO << "Selecting scans with activation mode: " << (selected_activation_ == "" ? "any" : selected_activation_) << std::endl;
+    HasActivationMethod<PeakMap::SpectrumType> isValidActivation(ListUtils::create<String>(selected_activation_));
+
+    // walk through spectra and count the number of scans with valid activation method per MS-level
+    // only the highest level will be used for quantification (e.g. MS3, if present)
+    std::map<UInt, UInt> ms_level;
+    std::map<String, int> activation_modes;
+    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    {
+      if (it->getMSLevel() == 1) continue; // never report MS1
+      ++activation_modes[getActivationMethod_(*it)]; // count HCD, CID, ...
+      if (selected_activation_ == "" || isValidActivation(*it))
+      {
+        ++ms_level[it->getMSLevel()];
+      }
+    }
+    UInt quant_ms_level = selectQuantMSLevel_(ms_level, activation_modes);
+    if (quant_ms_level == 0)
+    {
+      return;
+    }
+
+    // collect the spectra to quantify together with their surrounding MS1 scans
+    std::vector<ExtractionTask_> tasks;
+
+    // remember the current precursor spectrum
+    PuritySate_ pState(ms_exp_data);
+
+    for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
+    {
+      // remember the last MS1 spectra as we assume it to be the precursor spectrum
+      if (it->getMSLevel() ==  1)
+      {
+        // remember potential precursor and continue
+        pState.precursorScan = it;
+        continue;
+      }
+
+      if (it->getMSLevel() != quant_ms_level) continue;
+      if ((*it).empty()) continue; // skip empty spectra
+      if (!(selected_activation_.empty() || isValidActivation(*it))) continue;
+
+      // find following ms1 scan (needed for purity computation)
+      if (!pState.followUpValid(it->getRT()))
+      {
+        // advance iterator
+        pState.advanceFollowUp(it->getRT());
+      }
+
+      // check precursor constraints
+      if (!isValidPrecursor_(it->getPrecursors()[0]))
+      {
+        OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+        continue;
+      }
+
+      ExtractionTask_ task;
+      task.spectrum = &(*it);
+      task.precursor_scan = pState.precursorScan != ms_exp_data.end() ? &(*pState.precursorScan) : nullptr;
+      task.follow_up_scan = pState.hasFollowUpScan ? &(*pState.followUpScan) : nullptr;
+      task.ms2_spectrum = task.spectrum;
+      if (it->getMSLevel() == 3)
+      {
+        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
+        PeakMap::ConstIterator it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
+        task.ms2_spectrum = it_last_MS2 != ms_exp_data.end() ? &(*it_last_MS2) : nullptr;
+      }
+      tasks.push_back(task);
+    }
+
+    // now we have picked data
+    // --> assign peaks to channels (in batches, to limit the memory of the intermediate results)
+    UInt64 element_index(0);
+    ChannelQCSet_ channel_mz_delta;
+    std::vector<ExtractionResult_> results;
+    for (Size batch_start = 0; batch_start < tasks.size(); batch_start += EXTRACTION_BATCH_SIZE)
+    {
+      std::vector<ExtractionTask_> batch(tasks.begin() + batch_start,
+                                         tasks.begin() + std::min(batch_start + EXTRACTION_BATCH_SIZE, tasks.size()));
+      extractTasks_(batch, results);
+      appendFeatures_(batch, results, consensus_map, channel_mz_delta, element_index);
+    }
 
+    logChannelQC_(channel_mz_delta);
 
     /// add meta information to the map
     registerChannelsInOutputMap_(consensus_map);
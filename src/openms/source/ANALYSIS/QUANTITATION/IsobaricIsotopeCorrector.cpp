@@ -44,6 +44,9 @@
 
 #include <Eigen/LU>
 
+#include <algorithm>
+#include <map>
+
 // #define ISOBARIC_QUANT_DEBUG
 
 namespace OpenMS
@@ -73,11 +76,8 @@ namespace OpenMS
 
     // convert to Eigen matrix
     EigenMatrixXdPtr m(convertOpenMSMatrix2EigenMatrixXd(correction_matrix));
+    // the factorization is computed once and reused for all features
     Eigen::FullPivLU<Eigen::MatrixXd> ludecomp(*m);
-    Eigen::VectorXd b;
-    b.resize(quant_method->getNumberOfChannels());
-    b.setZero();
-    std::vector<double> x(quant_method->getNumberOfChannels(), 0);
 
     if (!ludecomp.isInvertible())
     {
@@ -85,56 +85,97 @@ namespace OpenMS
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: The given isotope correction matrix is not invertible!");
     }
 
+    // the channel of every map index (avoids meta value lookups per reporter)
+    std::map<Size, Int> channel_ids;
+    for (ConsensusMap::ColumnHeaders::const_iterator it = consensus_map_in.getColumnHeaders().begin();
+         it != consensus_map_in.getColumnHeaders().end();
+         ++it)
+    {
+      channel_ids[it->first] = Int(it->second.getMetaValue("channel_id"));
+    }
+
+    const Size nr_channels = quant_method->getNumberOfChannels();
+
     // data structures for NNLS
-    Matrix<double> m_b(quant_method->getNumberOfChannels(), 1);
-    Matrix<double> m_x(quant_method->getNumberOfChannels(), 1);
+    Matrix<double> m_b(nr_channels, 1);
+    Matrix<double> m_x(nr_channels, 1);
 
-    // correct all consensus elements
-    for (ConsensusMap::size_type i = 0; i < consensus_map_out.size(); ++i)
+    // correct the consensus elements block-wise: all right-hand sides of a block are solved at once
+    const Size block_size = 1024;
+    Eigen::MatrixXd b(nr_channels, block_size);
+    for (ConsensusMap::size_type block_start = 0; block_start < consensus_map_out.size(); block_start += block_size)
     {
-#ifdef ISOBARIC_QUANT_DEBUG
-      std::cout << "\nMAP element  #### " << i << " #### \n" << std::endl;
-#endif
-      // delete only the consensus handles from the output map
-      consensus_map_out[i].clear();
+      const Size block_end = std::min(block_start + block_size, consensus_map_out.size());
+      const Size nr_features = block_end - block_start;
 
-      // fill b vector
-      fillInputVector_(b, m_b, consensus_map_in[i], consensus_map_in);
+      // fill b matrix
+      b.setZero();
+      for (Size j = 0; j < nr_features; ++j)
+      {
+        fillInputVector_(b, j, consensus_map_in[block_start + j], channel_ids);
+      }
 
       //solve
-      Eigen::MatrixXd e_mx = ludecomp.solve(b);
-      if (!((*m) * e_mx).isApprox(b))
+      Eigen::MatrixXd e_mx = ludecomp.solve(b.leftCols(nr_features));
+      Eigen::MatrixXd e_b = (*m) * e_mx;
+
+      for (Size j = 0; j < nr_features; ++j)
       {
-        throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
-      }
-      solveNNLS_(correction_matrix, m_b, m_x);
+        const ConsensusMap::size_type i = block_start + j;
+#ifdef ISOBARIC_QUANT_DEBUG
+        std::cout << "\nMAP element  #### " << i << " #### \n" << std::endl;
+#endif
+        if (!e_b.col(j).isApprox(b.col(j)))
+        {
+          throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsobaricIsotopeCorrector: Cannot multiply!");
+        }
+
+        // The correction matrix is square and invertible, so a non-negative solution of the linear system
+        // has zero residual and is the (unique) NNLS solution. NNLS is only needed if the solution is negative.
+        if ((e_mx.col(j).array() >= 0.0).all())
+        {
+          for (Size index = 0; index < nr_channels; ++index)
+          {
+            m_x(index, 0) = e_mx(index, j);
+          }
+        }
+        else
+        {
+          for (Size index = 0; index < nr_channels; ++index)
+          {
+            m_b(index, 0) = b(index, j);
+          }
+          solveNNLS_(correction_matrix, m_b, m_x);
+        }
 
-      // update the output consensus map with the corrected intensities
-      float cf_intensity = updateOutpuMap_(consensus_map_in, consensus_map_out, i, m_x);
+        // delete only the consensus handles from the output map
+        consensus_map_out[i].clear();
 
-      // check consistency
-      computeStats_(m_x, e_mx, cf_intensity, quant_method, stats);    
+        // update the output consensus map with the corrected intensities
+        float cf_intensity = updateOutpuMap_(consensus_map_in, consensus_map_out, i, m_x, channel_ids);
+
+        // check consistency
+        computeStats_(m_x, e_mx.col(j), cf_intensity, quant_method, stats);
+      }
     }
 
     return stats;
   }
 
   void
-  IsobaricIsotopeCorrector::fillInputVector_(Eigen::VectorXd& b,
-                                             Matrix<double>& m_b, const ConsensusFeature& cf, const ConsensusMap& cm)
+  IsobaricIsotopeCorrector::fillInputVector_(Eigen::MatrixXd& b, Size column,
+                                             const ConsensusFeature& cf, const std::map<Size, Int>& channel_ids)
   {
     for (ConsensusFeature::HandleSetType::const_iterator it_elements = cf.getFeatures().begin();
          it_elements != cf.getFeatures().end();
          ++it_elements)
     {
       //find channel_id of current element
-      Int index = Int(cm.getColumnHeaders().find(it_elements->getMapIndex())->second.getMetaValue("channel_id"));
+      Int index = channel_ids.find(it_elements->getMapIndex())->second;
 #ifdef ISOBARIC_QUANT_DEBUG
       std::cout << "  map_index " << it_elements->getMapIndex() << "-> id " << index << " with intensity " << it_elements->getIntensity() << "\n" << std::endl;
 #endif
-      // this is deprecated, but serves as quality measurement
-      b(index) = it_elements->getIntensity();
-      m_b(index, 0) = it_elements->getIntensity();
+      b(index, column) = it_elements->getIntensity();
     }
   }
 
@@ -151,7 +192,7 @@ namespace OpenMS
 
   void
   IsobaricIsotopeCorrector::computeStats_(const Matrix<double>& m_x,
-                                          const Eigen::MatrixXd& x, const float cf_intensity,
+                                          const Eigen::VectorXd& x, const float cf_intensity,
                                           const IsobaricQuantitationMethod* quant_method, IsobaricQuantifierStatistics& stats)
   {
     Size s_negative(0);
@@ -192,7 +233,8 @@ namespace OpenMS
   float
   IsobaricIsotopeCorrector::updateOutpuMap_(
     const ConsensusMap& consensus_map_in, ConsensusMap& consensus_map_out,
-    ConsensusMap::size_type current_cf, const Matrix<double>& m_x)
+    ConsensusMap::size_type current_cf, const Matrix<double>& m_x,
+    const std::map<Size, Int>& channel_ids)
   {
     float cf_intensity(0);
     for (ConsensusFeature::HandleSetType::const_iterator it_elements = consensus_map_in[current_cf].begin();
@@ -201,7 +243,7 @@ namespace OpenMS
     {
       FeatureHandle handle = *it_elements;
       //find channel_id of current element
-      Int index = Int(consensus_map_out.getColumnHeaders()[it_elements->getMapIndex()].getMetaValue("channel_id"));
+      Int index = channel_ids.find(it_elements->getMapIndex())->second;
       handle.setIntensity(float(m_x(index, 0)));
 
       consensus_map_out[current_cf].insert(handle);
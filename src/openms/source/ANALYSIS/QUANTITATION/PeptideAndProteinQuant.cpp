@@ -36,14 +36,19 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <limits>
+#include <numeric>
+
 using namespace std;
 
 namespace OpenMS
 {
 
+  const UInt64 PeptideAndProteinQuant::NO_SAMPLE_ = numeric_limits<UInt64>::max();
+
   PeptideAndProteinQuant::PeptideAndProteinQuant() :
     DefaultParamHandler("PeptideAndProteinQuant"), stats_(), pep_quant_(),
-    prot_quant_()
+    prot_quant_(), pep_quant_valid_(true), prot_quant_valid_(true)
   {
     defaults_.setValue("top", 3, "Calculate protein abundance from this number of proteotypic peptides (most abundant first; '0' for all)");
     defaults_.setMinInt("top", 0);
@@ -71,6 +76,18 @@ namespace OpenMS
   }
 
 
+  Size PeptideAndProteinQuant::internPeptide_(const AASequence& seq)
+  {
+    map<AASequence, Size>::const_iterator pos = peptide_index_.find(seq);
+    if (pos != peptide_index_.end()) { return pos->second; }
+
+    Size index = peptide_info_.size();
+    peptide_index_.insert(make_pair(seq, index));
+    peptide_info_.push_back(PeptideInfo_());
+    return index;
+  }
+
+
   void PeptideAndProteinQuant::countPeptides_(
     vector<PeptideIdentification>& peptides)
   {
@@ -82,13 +99,16 @@ namespace OpenMS
       {
         pep.sort();
         const PeptideHit& hit = pep.getHits()[0]; // get best hit
-        PeptideData& data = pep_quant_[hit.getSequence()];
-        data.id_count++;
-        data.abundances[fraction][hit.getCharge()]; // insert empty element for charge
+        Size index = internPeptide_(hit.getSequence());
+        PeptideInfo_& info = peptide_info_[index];
+        info.id_count++;
+        // record the charge state (without a quantity):
+        Observation_ obs = {index, fraction, hit.getCharge(), NO_SAMPLE_, 0.0};
+        observations_.push_back(obs);
 
         // add protein accessions:
         set<String> protein_accessions = hit.extractProteinAccessionsSet();
-        data.accessions.insert(protein_accessions.begin(), protein_accessions.end());
+        info.accessions.insert(protein_accessions.begin(), protein_accessions.end());
       }
     }
   }
@@ -126,9 +146,187 @@ namespace OpenMS
     if (hit == PeptideHit()) { return; }
 
     stats_.quant_features++;
-    const AASequence& seq = hit.getSequence();
-    pep_quant_[seq].abundances[fraction][hit.getCharge()][sample] +=
-      feature.getIntensity(); // new map element is initialized with 0
+    Observation_ obs = {internPeptide_(hit.getSequence()), Int(fraction),
+                        hit.getCharge(), sample, feature.getIntensity()};
+    observations_.push_back(obs);
+  }
+
+
+  void PeptideAndProteinQuant::finalizeQuantData_()
+  {
+    // renumber peptides in sequence order:
+    vector<Size> new_index(peptide_info_.size());
+    vector<PeptideInfo_> info;
+    info.reserve(peptide_info_.size());
+    sequences_.clear();
+    sequences_.reserve(peptide_index_.size());
+    for (auto const & pi : peptide_index_)
+    {
+      new_index[pi.second] = sequences_.size();
+      sequences_.push_back(pi.first);
+      info.push_back(std::move(peptide_info_[pi.second]));
+    }
+    peptide_info_.swap(info);
+    peptide_index_.clear();
+
+    // map sample IDs to columns:
+    set<UInt64> samples;
+    for (auto const & obs : observations_)
+    {
+      if (obs.sample != NO_SAMPLE_) { samples.insert(obs.sample); }
+    }
+    sample_ids_.assign(samples.begin(), samples.end());
+    const Size n_samples = sample_ids_.size();
+
+    // group observations by peptide (counting sort, keeps the order in which
+    // they were read); from here on, "sample" holds the column (or
+    // "n_samples" for IDs without quantities):
+    vector<Size> offsets(sequences_.size() + 1, 0);
+    for (auto const & obs : observations_)
+    {
+      offsets[new_index[obs.peptide] + 1]++;
+    }
+    partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    vector<Observation_> grouped(observations_.size());
+    vector<Size> next(offsets.begin(), offsets.end() - 1);
+    for (auto const & obs : observations_)
+    {
+      Observation_& target = grouped[next[new_index[obs.peptide]]++];
+      target = obs;
+      target.peptide = new_index[obs.peptide];
+      target.sample = (obs.sample == NO_SAMPLE_) ? n_samples :
+        lower_bound(sample_ids_.begin(), sample_ids_.end(), obs.sample) -
+        sample_ids_.begin();
+    }
+    vector<Observation_>().swap(observations_); // free memory
+
+    // sort and merge the observations of each peptide (in place, at the
+    // front of its range); stable sort, so quantities are summed up in the
+    // order they were read:
+    vector<Size> n_merged(sequences_.size(), 0);
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < SignedSize(sequences_.size()); ++i)
+    {
+      vector<Observation_>::iterator begin = grouped.begin() + offsets[i];
+      vector<Observation_>::iterator end = grouped.begin() + offsets[i + 1];
+      stable_sort(begin, end,
+                  [](const Observation_& a, const Observation_& b)
+                  {
+                    if (a.fraction != b.fraction) return a.fraction < b.fraction;
+                    if (a.charge != b.charge) return a.charge < b.charge;
+                    return a.sample < b.sample;
+                  });
+      vector<Observation_>::iterator merged = begin;
+      for (vector<Observation_>::iterator it = begin; it != end; ++it)
+      {
+        if ((it != begin) && (it->fraction == (merged - 1)->fraction) &&
+            (it->charge == (merged - 1)->charge) &&
+            (it->sample == (merged - 1)->sample))
+        {
+          (merged - 1)->abundance += it->abundance;
+          continue;
+        }
+        *merged++ = *it;
+      }
+      n_merged[i] = merged - begin;
+    }
+
+    entries_.clear();
+    entry_offsets_.assign(sequences_.size() + 1, 0);
+    for (Size i = 0; i < sequences_.size(); ++i)
+    {
+      entry_offsets_[i + 1] = entry_offsets_[i] + n_merged[i];
+    }
+    entries_.reserve(entry_offsets_.back());
+    for (Size i = 0; i < sequences_.size(); ++i)
+    {
+      for (Size j = offsets[i]; j < offsets[i] + n_merged[i]; ++j)
+      {
+        const Observation_& obs = grouped[j];
+        Entry_ entry = {obs.fraction, obs.charge, Size(obs.sample), obs.abundance};
+        entries_.push_back(entry);
+      }
+    }
+
+    stats_.total_peptides = sequences_.size();
+    pep_quant_valid_ = false;
+  }
+
+
+  void PeptideAndProteinQuant::computeUnmodifiedSequences_()
+  {
+    if (unmodified_.size() == sequences_.size()) { return; }
+
+    unmodified_.resize(sequences_.size());
+#pragma omp parallel for
+    for (SignedSize i = 0; i < SignedSize(sequences_.size()); ++i)
+    {
+      unmodified_[i] = sequences_[i].toUnmodifiedString();
+    }
+  }
+
+
+  void PeptideAndProteinQuant::quantifyPeptide_(Size peptide,
+                                                bool best_charge_and_fraction)
+  {
+    const Size n_samples = sample_ids_.size();
+    double* totals = peptide_totals_.data() + peptide * n_samples;
+    char* has_total = peptide_has_total_.data() + peptide * n_samples;
+    const Entry_* begin = entries_.data() + entry_offsets_[peptide];
+    const Entry_* end = entries_.data() + entry_offsets_[peptide + 1];
+
+    if (best_charge_and_fraction)
+    { // quantify according to the best charge state only:
+
+      // determine which fraction and charge state yields the maximum number
+      // of abundances (break ties by total abundance); entries of the same
+      // fraction and charge are adjacent:
+      const Entry_* best_begin = end;
+      const Entry_* best_end = end;
+      Size best_n_quant = 0;
+      double best_abundance = 0.0;
+      for (const Entry_* group = begin; group != end; )
+      {
+        const Entry_* group_end = group;
+        Size n_quant = 0;
+        double abundance = 0.0;
+        for (; (group_end != end) && (group_end->fraction == group->fraction) &&
+               (group_end->charge == group->charge); ++group_end)
+        {
+          if (group_end->column == n_samples) { continue; } // ID only
+          abundance += group_end->abundance;
+          n_quant++;
+        }
+        if ((abundance > 0.0) && ((n_quant > best_n_quant) ||
+             ((n_quant == best_n_quant) && (abundance > best_abundance))))
+        {
+          best_n_quant = n_quant;
+          best_abundance = abundance;
+          best_begin = group;
+          best_end = group_end;
+        }
+        group = group_end;
+      }
+
+      // if nothing was found, the peptide was only identified, not quantified
+      for (const Entry_* entry = best_begin; entry != best_end; ++entry)
+      {
+        if (entry->column < n_samples)
+        {
+          totals[entry->column] = entry->abundance;
+          has_total[entry->column] = true;
+        }
+      }
+    }
+    else
+    { // sum up sample abundances over all fractions and charge states:
+      for (const Entry_* entry = begin; entry != end; ++entry)
+      {
+        if (entry->column == n_samples) { continue; } // ID only
+        totals[entry->column] += entry->abundance;
+        has_total[entry->column] = true;
+      }
+    }
   }
 
 
@@ -150,8 +348,6 @@ namespace OpenMS
         String seq = hit.getSequence().toUnmodifiedString();
         set<String> accessions = hit.extractProteinAccessionsSet();
 
-        // cout << "Sequence: " << seq << " size: " << accessions.size() << " " << *(accessions.begin()) << endl;
-
         // If a peptide is seen multiple times, the protein accessions should
         // always be the same, so only the first time it should be necessary to
         // insert them. However, just in case there a differences in the
@@ -159,21 +355,21 @@ namespace OpenMS
         pep_info[seq].insert(accessions.begin(), accessions.end());
       }
     }
+
+    peptide_used_.assign(sequences_.size(), true);
     // if inference results are given, filter quant. data accordingly:
     if (!pep_info.empty())
     {
-      if (pep_quant_.empty())
+      if (sequences_.empty())
       {
-        OPENMS_LOG_ERROR << "No peptides quantified (pep_quant_ is empty)!" << endl;
+        OPENMS_LOG_ERROR << "No peptides quantified!" << endl;
       }
 
-      PeptideQuant filtered;
-
-      for (auto & pep_q : pep_quant_)  // for all quantified peptides
+      computeUnmodifiedSequences_();
+      for (Size i = 0; i < sequences_.size(); ++i) // for all quantified peptides
       {
-        String seq = pep_q.first.toUnmodifiedString();
-        OPENMS_LOG_DEBUG << "Sequence: " << seq << endl;
-        map<String, set<String> >::iterator pos = pep_info.find(seq);
+        OPENMS_LOG_DEBUG << "Sequence: " << unmodified_[i] << endl;
+        map<String, set<String> >::iterator pos = pep_info.find(unmodified_[i]);
         if (pos != pep_info.end()) // sequence found in protein inference data
         {
           OPENMS_LOG_DEBUG << "Accessions: ";
@@ -181,129 +377,121 @@ namespace OpenMS
             OPENMS_LOG_DEBUG << a << "\t";
           }
           OPENMS_LOG_DEBUG << "\n";
-          pep_q.second.accessions = pos->second; // replace accessions
-          filtered.insert(pep_q);
+          peptide_info_[i].accessions = pos->second; // replace accessions
         }
         else
         {
           OPENMS_LOG_DEBUG << "not found in inference data." << endl;
+          peptide_used_[i] = false;
         }
       }
-      pep_quant_ = filtered;
     }
 
     //////////////////////////////////////////////////////
     // second, perform the actual peptide quantification:
-    for (auto & pep_q : pep_quant_)
+    bool best_charge_and_fraction =
+      param_.getValue("best_charge_and_fraction") == "true";
+    const Size n_samples = sample_ids_.size();
+    peptide_totals_.assign(sequences_.size() * n_samples, 0.0);
+    peptide_has_total_.assign(sequences_.size() * n_samples, false);
+
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < SignedSize(sequences_.size()); ++i)
     {
-      if (param_.getValue("best_charge_and_fraction") == "true")
-      { // quantify according to the best charge state only:
-
-        // determine which fraction and charge state yields the maximum number of abundances 
-        // (break ties by total abundance)
-        std::pair<size_t, size_t> best_fraction_and_charge;
-
-        // return false: only identified, not quantified
-        if (!getBest_(pep_q.second.abundances, best_fraction_and_charge)) 
-        { 
-          continue;
-        }
-        
-        // quantify according to the best fraction and charge state only:
-        for (auto & sa : pep_q.second.abundances[best_fraction_and_charge.first][best_fraction_and_charge.second])
-        {
-          pep_q.second.total_abundances[sa.first] = sa.second;
-        }
-      }
-      else
-      { // sum up sample abundances over all fractions and charge states:
+      if (peptide_used_[i]) { quantifyPeptide_(i, best_charge_and_fraction); }
+    }
 
-        for (auto & fa : pep_q.second.abundances)  // for all fractions 
-        {
-          for (auto & ca : fa.second) // for all charge states
-          {  
-            for (auto & sa : ca.second) // loop over abundances
-            {
-              const UInt64 & sample_id = sa.first;
-              const double & sample_abundance = sa.second;
-              pep_q.second.total_abundances[sample_id] += sample_abundance;
-            }
-          }
-        }
+    // count quantified peptides:
+    for (Size i = 0; i < sequences_.size(); ++i)
+    {
+      if (!peptide_used_[i]) { continue; }
+      const char* has_total = peptide_has_total_.data() + i * n_samples;
+      if (find(has_total, has_total + n_samples, true) != has_total + n_samples)
+      {
+        stats_.quant_peptides++;
       }
-
-      // count quantified peptide
-      if (!pep_q.second.total_abundances.empty()) { stats_.quant_peptides++; }
     }
 
     //////////////////////////////////////////////////////
     // normalize (optional):
     if ((stats_.n_samples > 1) &&
        (param_.getValue("consensus:normalize") == "true"))
-    {      
+    {
       normalizePeptides_();
     }
+    pep_quant_valid_ = false;
   }
 
+
   void PeptideAndProteinQuant::normalizePeptides_()
   {
     /////////////////////////////////////////////////////
-    // calculate total peptide abundances 
+    // collect total peptide abundances
     // depending on earlier options, these include:
     // - all charges or only the best charge state
     // - all fractions (if multiple fractions are analyzed)
-    map<UInt64, DoubleList> abundances; // all peptide abundances by sample
-    for (auto & pq : pep_quant_)
+    const Size n_samples = sample_ids_.size();
+    vector<DoubleList> abundances(n_samples); // all peptide abundances by sample
+    for (Size i = 0; i < sequences_.size(); ++i)
     {
+      if (!peptide_used_[i]) { continue; }
       // maybe TODO: treat missing abundance values as zero
-      for (auto & sa : pq.second.total_abundances)
+      const double* totals = peptide_totals_.data() + i * n_samples;
+      const char* has_total = peptide_has_total_.data() + i * n_samples;
+      for (Size col = 0; col < n_samples; ++col)
       {
-        abundances[sa.first].push_back(sa.second);
+        if (has_total[col]) { abundances[col].push_back(totals[col]); }
       }
     }
-    if (abundances.size() <= 1) { return; }
+    vector<Size> columns; // samples with abundances
+    for (Size col = 0; col < n_samples; ++col)
+    {
+      if (!abundances[col].empty()) { columns.push_back(col); }
+    }
+    if (columns.size() <= 1) { return; }
 
     /////////////////////////////////////////////////////
     // compute scale factors on the sample level:
-    SampleAbundances medians; // median abundance by sample
-    for (auto & ab : abundances)
+    vector<double> medians(n_samples); // median abundance by sample
+#pragma omp parallel for
+    for (SignedSize i = 0; i < SignedSize(columns.size()); ++i)
     {
-      medians[ab.first] = Math::median(ab.second.begin(), ab.second.end());
+      DoubleList& ab = abundances[columns[i]];
+      medians[columns[i]] = Math::median(ab.begin(), ab.end());
     }
 
     DoubleList all_medians;
-    for (auto & sa : medians)
+    for (Size col : columns)
     {
-      all_medians.push_back(sa.second);
+      all_medians.push_back(medians[col]);
     }
     double overall_median = Math::median(all_medians.begin(),
                                          all_medians.end());
-    SampleAbundances scale_factors;
-    for (auto & med : medians)
+    // samples without peptide abundances get factor zero; the extra last
+    // element is for IDs without quantities:
+    vector<double> scale_factors(n_samples + 1, 0.0);
+    for (Size col : columns)
     {
-      scale_factors[med.first] = overall_median / med.second;
+      scale_factors[col] = overall_median / medians[col];
     }
 
     /////////////////////////////////////////////////////
     // scale all abundance values:
-    for (auto & pep_q : pep_quant_)
+    for (Size i = 0; i < sequences_.size(); ++i)
     {
+      if (!peptide_used_[i]) { continue; }
+
       // scale total abundances
-      for (auto & sta : pep_q.second.total_abundances)
+      double* totals = peptide_totals_.data() + i * n_samples;
+      for (Size col = 0; col < n_samples; ++col)
       {
-        sta.second *= scale_factors[sta.first];
+        totals[col] *= scale_factors[col];
       }
 
       // scale individual abundances
-      for (auto & fa : pep_q.second.abundances) // for all fractions
+      for (Size e = entry_offsets_[i]; e < entry_offsets_[i + 1]; ++e)
       {
-        for (auto & ca : fa.second) // for all charge states
-        {
-          for (auto & sa : ca.second) // loop over abundances
-          {
-            sa.second *= scale_factors[sa.first];
-          }
-        }
+        entries_[e].abundance *= scale_factors[entries_[e].column];
       }
     }
   }
@@ -345,10 +533,153 @@ namespace OpenMS
   }
 
 
+  void PeptideAndProteinQuant::orderBest_(const ProteinRollup_& protein,
+                                          vector<Size>& result) const
+  {
+    typedef pair<Size, double> PairType;
+    const Size n_samples = sample_ids_.size();
+    vector<pair<PairType, Size> > order;
+    for (Size pep = 0; pep < protein.peptides.size(); ++pep)
+    {
+      const double* abundances = protein.abundances.data() + pep * n_samples;
+      const char* has_abundance = protein.has_abundance.data() + pep * n_samples;
+      Size n_quant = 0;
+      double total = 0.0;
+      for (Size col = 0; col < n_samples; ++col)
+      {
+        if (!has_abundance[col]) { continue; }
+        n_quant++;
+        total += abundances[col];
+      }
+      if (total <= 0.0) continue; // not quantified
+      order.push_back(make_pair(make_pair(n_quant, total), pep));
+    }
+    // stable, so ties keep the order of peptides:
+    stable_sort(order.begin(), order.end(),
+                [](const pair<PairType, Size>& a, const pair<PairType, Size>& b)
+                {
+                  return a.first > b.first;
+                });
+    result.clear();
+    for (auto const & ord : order)
+    {
+      result.push_back(ord.second);
+    }
+  }
+
+
+  Size PeptideAndProteinQuant::quantifyProtein_(ProteinRollup_& protein,
+                                                Size top,
+                                                const String& average,
+                                                bool include_all,
+                                                bool fix_peptides) const
+  {
+    const Size n_samples = sample_ids_.size();
+    const Size n_peptides = protein.peptides.size();
+    protein.totals.assign(n_samples, 0.0);
+    protein.has_total.assign(n_samples, false);
+
+    Size too_few_peptides = 0;
+    if ((top > 0) && (n_peptides < top))
+    {
+      too_few_peptides++;
+      if (!include_all) { return too_few_peptides; } // not enough proteotypic peptides
+    }
+
+    vector<Size> peptides; // peptides selected for quantification
+    if (fix_peptides && (top == 0))
+    {
+      // consider all peptides that occur in every sample:
+      for (Size pep = 0; pep < n_peptides; ++pep)
+      {
+        const char* has_abundance = protein.has_abundance.data() + pep * n_samples;
+        Size n_quant = count(has_abundance, has_abundance + n_samples, true);
+        if (n_quant == stats_.n_samples) { peptides.push_back(pep); }
+      }
+    }
+    else if (fix_peptides && (top > 0) && (n_peptides > top))
+    {
+      orderBest_(protein, peptides);
+      if (peptides.size() > top) { peptides.resize(top); }
+    }
+    else
+    {
+      // consider all peptides of the protein:
+      for (Size pep = 0; pep < n_peptides; ++pep)
+      {
+        peptides.push_back(pep);
+      }
+    }
+
+    DoubleList abundances; // peptide abundances of the current sample
+    bool quantified = false;
+    for (Size col = 0; col < n_samples; ++col)
+    {
+      // consider only the selected peptides for quantification:
+      abundances.clear();
+      for (Size pep : peptides)
+      {
+        if (protein.has_abundance[pep * n_samples + col])
+        {
+          abundances.push_back(protein.abundances[pep * n_samples + col]);
+        }
+      }
+      if (abundances.empty()) { continue; }
+
+      // check if the protein has enough peptides in this sample
+      if (!include_all && (top > 0) && (abundances.size() < top))
+      {
+        continue;
+      }
+
+      // if we have more than "top", reduce to the top ones
+      if ((top > 0) && (abundances.size() > top))
+      {
+        // best "top" values, sorted descending:
+        partial_sort(abundances.begin(), abundances.begin() + top,
+                     abundances.end(), greater<double>());
+        abundances.resize(top);
+      }
+
+      double result;
+      if (average == "median")
+      {
+        result = Math::median(abundances.begin(), abundances.end());
+      }
+      else if (average == "mean")
+      {
+        result = Math::mean(abundances.begin(), abundances.end());
+      }
+      else if (average == "weighted_mean")
+      {
+        double sum_intensities = 0;
+        double sum_intensities_squared = 0;
+        for (auto const & in : abundances)
+        {
+          sum_intensities += in;
+          sum_intensities_squared += in * in;
+        }
+        result = sum_intensities_squared / sum_intensities;
+      }
+      else // "sum"
+      {
+        result = Math::sum(abundances.begin(), abundances.end());
+      }
+      protein.totals[col] = result;
+      protein.has_total[col] = true;
+      quantified = true;
+    }
+
+    if (!quantified) { too_few_peptides++; }
+    return too_few_peptides;
+  }
+
+
   void PeptideAndProteinQuant::quantifyProteins(const ProteinIdentification&
                                                 proteins)
   {
-    if (pep_quant_.empty())
+    if (find(peptide_used_.begin(), peptide_used_.end(), true) ==
+        peptide_used_.end())
     {
       OPENMS_LOG_WARN << "Warning: No peptides quantified." << endl;
     }
@@ -368,133 +699,106 @@ namespace OpenMS
       }
     }
 
-    // for (auto & a : accession_to_leader) { std::cout << a.first << "\tis led by:\t" << a.second << endl; }
-
-    for (auto const& pep_q : pep_quant_)
+    // assign proteotypic peptides to proteins:
+    // mapping: accession -> ID count, peptides (in sequence order)
+    map<String, pair<Size, vector<Size> > > protein_peptides;
+    for (Size i = 0; i < sequences_.size(); ++i)
     {
-      String accession = getAccession_(pep_q.second.accessions,
+      if (!peptide_used_.empty() && !peptide_used_[i]) { continue; }
+
+      String accession = getAccession_(peptide_info_[i].accessions,
                                        accession_to_leader);
       OPENMS_LOG_DEBUG << "Peptide id mapped to leader: " << accession << endl;
       if (!accession.empty()) // proteotypic peptide
       {
-        prot_quant_[accession].id_count += pep_q.second.id_count;
-        for (auto const & sta : pep_q.second.total_abundances)
-        {
-          // add up contributions of same peptide with different mods:
-          String raw_peptide = pep_q.first.toUnmodifiedString();
-          prot_quant_[accession].abundances[raw_peptide][sta.first] +=
-            sta.second;
-        }
+        pair<Size, vector<Size> >& pp = protein_peptides[accession];
+        pp.first += peptide_info_[i].id_count;
+        pp.second.push_back(i);
       }
     }
 
+    proteins_.clear();
+    proteins_.resize(protein_peptides.size());
+    vector<vector<Size> > members;
+    members.reserve(protein_peptides.size());
+    Size index = 0;
+    for (auto & pp : protein_peptides)
+    {
+      proteins_[index].accession = pp.first;
+      proteins_[index].id_count = pp.second.first;
+      members.push_back(vector<Size>());
+      members.back().swap(pp.second.second);
+      ++index;
+    }
+    protein_peptides.clear();
+
+    computeUnmodifiedSequences_();
+
     Size top = param_.getValue("top");
     String average = param_.getValue("average");
     bool include_all = param_.getValue("include_all") == "true";
     bool fix_peptides = param_.getValue("consensus:fix_peptides") == "true";
 
-    for (auto & prot_q : prot_quant_)
+    const Size n_samples = sample_ids_.size();
+    vector<Size> too_few_peptides(proteins_.size());
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < SignedSize(proteins_.size()); ++i)
     {
-      if ((top > 0) && (prot_q.second.abundances.size() < top))
+      ProteinRollup_& protein = proteins_[i];
+      vector<Size>& peptides = members[i];
+
+      // add up contributions of same peptide with different mods (stable
+      // sort, so the summation order doesn't change):
+      stable_sort(peptides.begin(), peptides.end(),
+                  [this](Size a, Size b)
+                  {
+                    return unmodified_[a] < unmodified_[b];
+                  });
+      for (Size pep : peptides)
       {
-        stats_.too_few_peptides++;
-        if (!include_all) { continue; } // not enough proteotypic peptides
-      }
-
-      vector<String> peptides; // peptides selected for quantification
-      if (fix_peptides && (top == 0))
-      {
-        // consider all peptides that occur in every sample:
-        for (auto const & ab : prot_q.second.abundances)
+        if (peptide_totals_.empty()) { break; } // peptides not quantified yet
+        const double* totals = peptide_totals_.data() + pep * n_samples;
+        const char* has_total = peptide_has_total_.data() + pep * n_samples;
+        if (find(has_total, has_total + n_samples, true) ==
+            has_total + n_samples) { continue; } // not quantified
+
+        if (protein.peptides.empty() ||
+            (protein.peptides.back() != unmodified_[pep]))
         {
-          if (ab.second.size() == stats_.n_samples)
-          {
-            peptides.push_back(ab.first);
-          }
+          protein.peptides.push_back(unmodified_[pep]);
+          protein.abundances.resize(protein.abundances.size() + n_samples, 0.0);
+          protein.has_abundance.resize(protein.has_abundance.size() + n_samples,
+                                       false);
         }
-      }
-      else if (fix_peptides && (top > 0) &&
-               (prot_q.second.abundances.size() > top))
-      {
-        orderBest_(prot_q.second.abundances, peptides);
-        peptides.resize(top);
-      }
-      else
-      {
-        // consider all peptides of the protein:
-        for (auto const & ab : prot_q.second.abundances)
+        double* row = protein.abundances.data() + protein.abundances.size() -
+          n_samples;
+        char* has_row = protein.has_abundance.data() +
+          protein.has_abundance.size() - n_samples;
+        for (Size col = 0; col < n_samples; ++col)
         {
-          peptides.push_back(ab.first);
+          if (!has_total[col]) { continue; }
+          row[col] += totals[col];
+          has_row[col] = true;
         }
       }
 
-      map<UInt64, DoubleList> abundances; // all peptide abundances by sample
-
-      // consider only the selected peptides for quantification:
-      for (auto & pep : peptides)
-      {       
-        for (auto & sa : prot_q.second.abundances[pep])
-        {
-          abundances[sa.first].push_back(sa.second);
-        }
-      }
-
-      for (auto & ab : abundances)
-      {
-        // check if the protein has enough peptides in this sample
-        if (!include_all && (top > 0) && (ab.second.size() < top))
-        {
-          continue;
-        }
-
-        // if we have more than "top", reduce to the top ones
-        if ((top > 0) && (ab.second.size() > top))
-        {
-          // sort descending:
-          sort(ab.second.begin(), ab.second.end(), greater<double>());
-          ab.second.resize(top); // remove all but best "top" values
-        }
-
-        double result;
-        if (average == "median")
-        {
-          result = Math::median(ab.second.begin(), ab.second.end());
-        }
-        else if (average == "mean")
-        {
-          result = Math::mean(ab.second.begin(), ab.second.end());
-        }
-        else if (average == "weighted_mean")
-        {
-          double sum_intensities = 0;
-          double sum_intensities_squared = 0;
-          for (auto const & in : ab.second)
-          {
-            sum_intensities += in;
-            sum_intensities_squared += in * in;
-          }
-          result = sum_intensities_squared / sum_intensities;
-        }
-        else // "sum"
-        {
-          result = Math::sum(ab.second.begin(), ab.second.end());
-        }
-        prot_q.second.total_abundances[ab.first] = result;
-      }
+      too_few_peptides[i] = quantifyProtein_(protein, top, average,
+                                             include_all, fix_peptides);
+    }
 
-      // update statistics:
-      if (prot_q.second.total_abundances.empty()) 
-      { 
-        stats_.too_few_peptides++; 
-      }
-      else 
+    // update statistics:
+    for (Size i = 0; i < proteins_.size(); ++i)
+    {
+      stats_.too_few_peptides += too_few_peptides[i];
+      const vector<char>& has_total = proteins_[i].has_total;
+      if (find(has_total.begin(), has_total.end(), true) != has_total.end())
       {
         stats_.quant_proteins++;
       }
     }
+    prot_quant_valid_ = false;
   }
 
-
   // FRACTIONS: DONE
   void PeptideAndProteinQuant::readQuantData(
     FeatureMap& features,
@@ -508,6 +812,7 @@ namespace OpenMS
 
     stats_.total_features = features.size();
 
+    observations_.reserve(features.size() * 2);
     for (auto & f : features)
     {
       if (f.getPeptideIdentifications().empty())
@@ -522,7 +827,7 @@ namespace OpenMS
       quantifyFeature_(handle, fraction, sample, hit); // updates "stats_.quant_features"
     }
     countPeptides_(features.getUnassignedPeptideIdentifications());
-    stats_.total_peptides = pep_quant_.size();
+    finalizeQuantData_(); // updates "stats_.total_peptides"
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
   }
@@ -574,7 +879,7 @@ namespace OpenMS
       }
     }
     countPeptides_(consensus.getUnassignedPeptideIdentifications());
-    stats_.total_peptides = pep_quant_.size();
+    finalizeQuantData_(); // updates "stats_.total_peptides"
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
                             stats_.quant_features;
   }
@@ -626,7 +931,6 @@ namespace OpenMS
 
       const PeptideHit& hit = p.getHits()[0];
       stats_.quant_features++;
-      const AASequence& seq = hit.getSequence();
       const String& ms_file_path = identifier_to_ms_file[p.getIdentifier()];
 
       // determine sample and fraction by MS file name (stored in protein identification)
@@ -641,9 +945,11 @@ namespace OpenMS
 
       // TODO MULTIPLEXING: think about how id-based quant is done for SILAC, TMT, etc.
       // count peptides in the different fractions, charge states, and samples
-      pep_quant_[seq].abundances[fraction][hit.getCharge()][sample] += 1;
+      Observation_ obs = {internPeptide_(hit.getSequence()), Int(fraction),
+                          hit.getCharge(), sample, 1.0};
+      observations_.push_back(obs);
     }
-    stats_.total_peptides = pep_quant_.size();
+    finalizeQuantData_(); // updates "stats_.total_peptides"
   }
 
 
@@ -653,6 +959,19 @@ namespace OpenMS
     stats_ = Statistics();
     pep_quant_.clear();
     prot_quant_.clear();
+    pep_quant_valid_ = prot_quant_valid_ = true;
+    peptide_index_.clear();
+    peptide_info_.clear();
+    observations_.clear();
+    sequences_.clear();
+    unmodified_.clear();
+    sample_ids_.clear();
+    entry_offsets_.clear();
+    entries_.clear();
+    peptide_used_.clear();
+    peptide_totals_.clear();
+    peptide_has_total_.clear();
+    proteins_.clear();
   }
 
 
@@ -666,6 +985,40 @@ namespace OpenMS
   const PeptideAndProteinQuant::PeptideQuant&
   PeptideAndProteinQuant::getPeptideResults()
   {
+    if (pep_quant_valid_) { return pep_quant_; }
+
+    pep_quant_.clear();
+    const Size n_samples = sample_ids_.size();
+    for (Size i = 0; i < sequences_.size(); ++i)
+    {
+      if (!peptide_used_.empty() && !peptide_used_[i]) { continue; }
+
+      // peptides are sorted, so we can always insert at the end:
+      PeptideData& data = pep_quant_.insert(pep_quant_.end(),
+        make_pair(sequences_[i], PeptideData()))->second;
+      data.accessions = peptide_info_[i].accessions;
+      data.id_count = peptide_info_[i].id_count;
+      for (Size e = entry_offsets_[i]; e < entry_offsets_[i + 1]; ++e)
+      {
+        const Entry_& entry = entries_[e];
+        SampleAbundances& abundances = data.abundances[entry.fraction][entry.charge];
+        if (entry.column < n_samples)
+        {
+          abundances[sample_ids_[entry.column]] = entry.abundance;
+        }
+      }
+      if (peptide_totals_.empty()) { continue; } // not quantified yet
+
+      const double* totals = peptide_totals_.data() + i * n_samples;
+      const char* has_total = peptide_has_total_.data() + i * n_samples;
+      for (Size col = 0; col < n_samples; ++col)
+      {
+        if (!has_total[col]) { continue; }
+        data.total_abundances.insert(data.total_abundances.end(),
+                                     make_pair(sample_ids_[col], totals[col]));
+      }
+    }
+    pep_quant_valid_ = true;
     return pep_quant_;
   }
 
@@ -673,6 +1026,38 @@ namespace OpenMS
   const PeptideAndProteinQuant::ProteinQuant&
   PeptideAndProteinQuant::getProteinResults()
   {
+    if (prot_quant_valid_) { return prot_quant_; }
+
+    prot_quant_.clear();
+    const Size n_samples = sample_ids_.size();
+    for (auto const & protein : proteins_)
+    {
+      // proteins are sorted by accession, so we can always insert at the end:
+      ProteinData& data = prot_quant_.insert(prot_quant_.end(),
+        make_pair(protein.accession, ProteinData()))->second;
+      data.id_count = protein.id_count;
+      for (Size pep = 0; pep < protein.peptides.size(); ++pep)
+      {
+        SampleAbundances& abundances = data.abundances.insert(
+          data.abundances.end(),
+          make_pair(protein.peptides[pep], SampleAbundances()))->second;
+        const double* values = protein.abundances.data() + pep * n_samples;
+        const char* has_value = protein.has_abundance.data() + pep * n_samples;
+        for (Size col = 0; col < n_samples; ++col)
+        {
+          if (!has_value[col]) { continue; }
+          abundances.insert(abundances.end(),
+                            make_pair(sample_ids_[col], values[col]));
+        }
+      }
+      for (Size col = 0; col < n_samples; ++col)
+      {
+        if (!protein.has_total[col]) { continue; }
+        data.total_abundances.insert(data.total_abundances.end(),
+          make_pair(sample_ids_[col], protein.totals[col]));
+      }
+    }
+    prot_quant_valid_ = true;
     return prot_quant_;
   }
 
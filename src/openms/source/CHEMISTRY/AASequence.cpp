@@ -41,6 +41,9 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CONCEPT/Macros.h>
 #include <OpenMS/CONCEPT/PrecisionWrapper.h>
+#include <OpenMS/DATASTRUCTURES/ReadMostlyHashMap.h>
+
+#include <boost/functional/hash.hpp>
 
 #include <cmath>
 
@@ -1297,10 +1300,149 @@ namespace OpenMS
     }
   }
 
+  bool AASequence::ModificationToken_::operator==(const ModificationToken_& rhs) const
+  {
+    return residue == rhs.residue && next_aa == rhs.next_aa && specificity == rhs.specificity &&
+           single_residue == rhs.single_residue && at_end == rhs.at_end && token == rhs.token;
+  }
+
+  std::size_t AASequence::ModificationTokenHash_::operator()(const ModificationToken_& t) const
+  {
+    std::size_t seed = std::hash<std::string>()(t.token);
+    boost::hash_combine(seed, t.residue);
+    boost::hash_combine(seed, t.next_aa);
+    boost::hash_combine(seed, int(t.specificity));
+    boost::hash_combine(seed, t.single_residue);
+    boost::hash_combine(seed, t.at_end);
+    return seed;
+  }
+
+  /**
+    Bounded to max_size distinct tokens: the number of buckets is fixed, so
+    the chains stay short (at most four entries on average) and the memory is
+    limited to a few MB. Tokens beyond the limit are parsed without caching.
+  */
+  struct AASequence::ModificationCache_
+  {
+    static const Size max_size = 65536;
+
+    ModificationCache_() :
+      map(max_size / 4)
+    {}
+
+    ReadMostlyHashMap<ModificationToken_, ParsedModification_, ModificationTokenHash_> map;
+  };
+
+  AASequence::ModificationCache_& AASequence::getModificationCache_()
+  {
+    static ModificationCache_ cache;
+    return cache;
+  }
+
+  void AASequence::clearModificationCache()
+  {
+    ModificationCache_& cache = getModificationCache_();
+    #pragma omp critical (AASequence_ModificationCache)
+    {
+      cache.map.clear();
+    }
+  }
+
+  String::ConstIterator AASequence::parseModification_(const String::ConstIterator str_it,
+                                                       const String& str,
+                                                       AASequence& aas,
+                                                       const ResidueModification::TermSpecificity& specificity)
+  {
+    static ReadMostlyHashMap<ModificationToken_, ParsedModification_, ModificationTokenHash_>& cache = getModificationCache_().map;
+
+    const bool round = (*str_it == '(');
+
+    // find the end of the token (same rules as in parseModRoundBrackets_/parseModSquareBrackets_)
+    String::ConstIterator mod_end = str_it + 1;
+    Size open_brackets = 1;
+    while (mod_end != str.end())
+    {
+      if (round)
+      {
+        if (*mod_end == ')') --open_brackets;
+        else if (*mod_end == '(') ++open_brackets;
+        if (!open_brackets) break;
+      }
+      else if (*mod_end == ']')
+      {
+        break;
+      }
+      ++mod_end;
+    }
+    if (mod_end == str.end()) // let the actual parser report the error
+    {
+      return round ? parseModRoundBrackets_(str_it, str, aas, specificity) : parseModSquareBrackets_(str_it, str, aas, specificity);
+    }
+
+    ModificationToken_ key;
+    key.token.assign(str_it, mod_end + 1);
+    key.residue = aas.peptide_.empty() ? nullptr : aas.peptide_.back();
+    key.next_aa = 0;
+    if (aas.peptide_.empty() || specificity == ResidueModification::N_TERM)
+    {
+      String::ConstIterator next_aa = mod_end + 1;
+      if (next_aa != str.end() && *next_aa == '.') ++next_aa;
+      if (next_aa != str.end()) key.next_aa = *next_aa;
+    }
+    key.specificity = specificity;
+    key.single_residue = (aas.peptide_.size() == 1);
+    key.at_end = (std::distance(mod_end, str.end()) == 1);
+
+    const ParsedModification_* known = cache.find(key);
+    if (known == nullptr)
+    {
+      const Residue* residue_before = key.residue;
+      const ResidueModification* n_term_before = aas.n_term_mod_;
+      const ResidueModification* c_term_before = aas.c_term_mod_;
+
+      // throws for invalid modifications, these are not cached
+      String::ConstIterator end = round ? parseModRoundBrackets_(str_it, str, aas, specificity) : parseModSquareBrackets_(str_it, str, aas, specificity);
+
+      ParsedModification_ parsed;
+      parsed.residue = (aas.peptide_.empty() || aas.peptide_.back() == residue_before) ? nullptr : aas.peptide_.back();
+      parsed.n_term_mod = (aas.n_term_mod_ == n_term_before) ? nullptr : aas.n_term_mod_;
+      parsed.c_term_mod = (aas.c_term_mod_ == c_term_before) ? nullptr : aas.c_term_mod_;
+      #pragma omp critical (AASequence_ModificationCache)
+      {
+        if (cache.size() < ModificationCache_::max_size && !cache.has(key)) cache.insert(key, parsed);
+      }
+      return end;
+    }
+
+    if (known->residue != nullptr) aas.peptide_.back() = known->residue;
+    if (known->n_term_mod != nullptr) aas.n_term_mod_ = known->n_term_mod;
+    if (known->c_term_mod != nullptr) aas.c_term_mod_ = known->c_term_mod;
+    return mod_end;
+  }
+
   void AASequence::parseString_(const String& pep, AASequence& aas,
                                 bool permissive)
   {
     aas.peptide_.clear();
+
+    static ResidueDB* rdb = ResidueDB::getInstance();
+
+    // fast path for unmodified sequences (e.g. "PEPTIDE"): no copy of the string, no modification parsing
+    aas.peptide_.reserve(pep.size());
+    bool unmodified = true;
+    for (const char c : pep)
+    {
+      const Residue* r = rdb->getResidue(static_cast<unsigned char>(c));
+      if (r == nullptr)
+      {
+        unmodified = false;
+        break;
+      }
+      aas.peptide_.push_back(r);
+    }
+    if (unmodified) return;
+    aas.peptide_.clear();
+
     String peptide(pep);
     peptide.trim();
 
@@ -1325,8 +1467,6 @@ namespace OpenMS
     // track if last char denoted a terminus
     bool dot_terminal(false), dot_notation(false);
 
-    static ResidueDB* rdb = ResidueDB::getInstance();
-
     for (String::ConstIterator str_it = peptide.begin();
          str_it != peptide.end(); ++str_it)
     {
@@ -1370,13 +1510,9 @@ namespace OpenMS
         specificity = ResidueModification::C_TERM;
       }
      
-      if (*str_it == '(')
-      {
-        str_it = parseModRoundBrackets_(str_it, peptide, aas, specificity);
-      }
-      else if (*str_it == '[')
+      if ((*str_it == '(') || (*str_it == '['))
       {
-        str_it = parseModSquareBrackets_(str_it, peptide, aas, specificity);
+        str_it = parseModification_(str_it, peptide, aas, specificity);
       }
       else
       {
@@ -0,0 +1,92 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+
+namespace OpenMS
+{
+  AASequencePool::AASequencePool() :
+    sequences_(),
+    strict_sequences_()
+  {
+  }
+
+  AASequencePool::~AASequencePool()
+  {
+  }
+
+  const AASequencePool::SharedSequence& AASequencePool::intern(const String& sequence, bool permissive)
+  {
+    std::unordered_map<String, SharedSequence>& sequences = permissive ? sequences_ : strict_sequences_;
+    auto it = sequences.find(sequence);
+    if (it == sequences.end())
+    {
+      // parse first, so that invalid sequences are not added
+      SharedSequence shared = std::make_shared<AASequence>(AASequence::fromString(sequence, permissive));
+      if (!permissive)
+      {
+        // a valid sequence is parsed the same either way: reuse a permissively interned instance
+        auto perm_it = sequences_.find(sequence);
+        if (perm_it != sequences_.end() && *perm_it->second == *shared)
+        {
+          shared = perm_it->second;
+        }
+      }
+      it = sequences.emplace(sequence, std::move(shared)).first;
+    }
+    return it->second;
+  }
+
+  const AASequencePool::SharedSequence& AASequencePool::intern(const AASequence& sequence)
+  {
+    String key = sequence.toString();
+    auto it = sequences_.find(key);
+    if (it == sequences_.end())
+    {
+      it = sequences_.emplace(std::move(key), std::make_shared<AASequence>(sequence)).first;
+    }
+    return it->second;
+  }
+
+  Size AASequencePool::size() const
+  {
+    return sequences_.size() + strict_sequences_.size();
+  }
+
+  void AASequencePool::clear()
+  {
+    sequences_.clear();
+    strict_sequences_.clear();
+  }
+}
@@ -45,9 +45,13 @@ namespace OpenMS
 {
   CrossLinksDB::CrossLinksDB()
   {
+    // not visible to other threads yet, so the name index can be rebuilt directly
     mods_.clear();
     modification_names_.clear();
+    added_modification_names_.clear();
+    names_frozen_ = false;
     readFromOBOFile("CHEMISTRY/XLMOD.obo");
+    names_frozen_ = true;
   }
 
 
@@ -313,6 +317,7 @@ namespace OpenMS
     }
 
     // now use the term and all synonyms to build the database
+    #pragma omp critical(OpenMS_ModificationsDB)
     for (multimap<String, ResidueModification>::const_iterator it = all_mods.begin(); it != all_mods.end(); ++it)
     {
 
@@ -320,11 +325,10 @@ namespace OpenMS
       if (it->second.getUniModRecordId() > 0)
       {
         //cerr << "Found UniMod PSI-MOD mapping: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-        set<const ResidueModification*> mods = modification_names_[it->second.getUniModAccession()];
-        for (set<const ResidueModification*>::const_iterator mit = mods.begin(); mit != mods.end(); ++mit)
+        for (const ResidueModification* mod : getNamed_(it->second.getUniModAccession()))
         {
           //cerr << "Adding PSIMOD accession: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-          modification_names_[it->second.getPSIMODAccession()].insert(*mit);
+          addName_(it->second.getPSIMODAccession(), mod);
         }
       }
       else
@@ -351,7 +355,7 @@ namespace OpenMS
           // now check each of the names and link it to the residue modification
           for (set<String>::const_iterator nit = synonyms.begin(); nit != synonyms.end(); ++nit)
           {
-            modification_names_[*nit].insert(mods_.back());
+            addName_(*nit, mods_.back());
           }
         }
       }
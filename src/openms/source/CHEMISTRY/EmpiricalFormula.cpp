@@ -52,19 +52,209 @@ using namespace std;
 
 namespace OpenMS
 {
+  EmpiricalFormula::ElementIterator::ElementIterator() :
+    formula_(nullptr),
+    slot_(NUMBER_OF_DENSE_ELEMENTS),
+    spill_it_(),
+    current_(nullptr, 0)
+  {
+  }
+
+  EmpiricalFormula::ElementIterator::ElementIterator(const EmpiricalFormula* formula, Size slot, MapType_::const_iterator spill_it) :
+    formula_(formula),
+    slot_(slot),
+    spill_it_(spill_it),
+    current_(nullptr, 0)
+  {
+    settle_();
+  }
+
+  void EmpiricalFormula::ElementIterator::settle_()
+  {
+    while (slot_ < NUMBER_OF_DENSE_ELEMENTS && formula_->dense_[slot_] == 0)
+    {
+      ++slot_;
+    }
+    if (slot_ < NUMBER_OF_DENSE_ELEMENTS)
+    {
+      current_ = value_type(getDenseElements_().elements[slot_], formula_->dense_[slot_]);
+    }
+    else if (spill_it_ != formula_->spill_.end())
+    {
+      current_ = value_type(spill_it_->first, spill_it_->second);
+    }
+  }
+
+  EmpiricalFormula::ElementIterator& EmpiricalFormula::ElementIterator::operator++()
+  {
+    if (slot_ < NUMBER_OF_DENSE_ELEMENTS)
+    {
+      ++slot_;
+    }
+    else
+    {
+      ++spill_it_;
+    }
+    settle_();
+    return *this;
+  }
+
+  EmpiricalFormula::ElementIterator EmpiricalFormula::ElementIterator::operator++(int)
+  {
+    ElementIterator tmp(*this);
+    ++(*this);
+    return tmp;
+  }
+
+  bool EmpiricalFormula::ElementIterator::operator==(const ElementIterator& rhs) const
+  {
+    return formula_ == rhs.formula_ && slot_ == rhs.slot_ &&
+           (slot_ < NUMBER_OF_DENSE_ELEMENTS || formula_ == nullptr || spill_it_ == rhs.spill_it_);
+  }
+
+  EmpiricalFormula::ConstIterator EmpiricalFormula::begin() const
+  {
+    return ConstIterator(this, 0, spill_.begin());
+  }
+
+  EmpiricalFormula::ConstIterator EmpiricalFormula::end() const
+  {
+    return ConstIterator(this, NUMBER_OF_DENSE_ELEMENTS, spill_.end());
+  }
+
+  const EmpiricalFormula::DenseElements_& EmpiricalFormula::getDenseElements_()
+  {
+    // sorted by symbol, so that toString() does not need to sort common formulas
+    static const DenseElements_ dense = []() -> DenseElements_
+    {
+      const char* symbols[NUMBER_OF_DENSE_ELEMENTS] = {"Br", "C", "Cl", "F", "H", "I", "N", "O", "P", "S"};
+      const ElementDB* db = ElementDB::getInstance();
+      DenseElements_ d;
+      for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i)
+      {
+        d.elements[i] = db->getElement(symbols[i]);
+        d.mono_weights[i] = d.elements[i]->getMonoWeight();
+        d.average_weights[i] = d.elements[i]->getAverageWeight();
+      }
+      return d;
+    }();
+    return dense;
+  }
+
+  Size EmpiricalFormula::getDenseIndex_(const Element* element)
+  {
+    const DenseElements_& dense = getDenseElements_();
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i)
+    {
+      if (dense.elements[i] == element) return i;
+    }
+    return NUMBER_OF_DENSE_ELEMENTS;
+  }
+
+  void EmpiricalFormula::addElement_(const Element* element, SignedSize number)
+  {
+    Size index = getDenseIndex_(element);
+    if (index < NUMBER_OF_DENSE_ELEMENTS)
+    {
+      dense_[index] += number;
+      return;
+    }
+    if (number == 0) return;
+    auto it = spill_.find(element);
+    if (it == spill_.end())
+    {
+      spill_.insert(std::make_pair(element, number));
+    }
+    else if ((it->second += number) == 0)
+    {
+      spill_.erase(it);
+    }
+  }
+
+  void EmpiricalFormula::updateWeights_()
+  {
+    const DenseElements_& dense = getDenseElements_();
+    mono_weight_ = 0.0;
+    average_weight_ = 0.0;
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i)
+    {
+      mono_weight_ += dense.mono_weights[i] * (double)dense_[i];
+      average_weight_ += dense.average_weights[i] * (double)dense_[i];
+    }
+    for (const auto& it : spill_)
+    {
+      mono_weight_ += it.first->getMonoWeight() * (double)it.second;
+      average_weight_ += it.first->getAverageWeight() * (double)it.second;
+    }
+  }
+
+  template <typename Function>
+  void EmpiricalFormula::forEachBySymbol_(Function f) const
+  {
+    const DenseElements_& dense = getDenseElements_();
+    if (spill_.empty()) // common case: the dense array is already sorted
+    {
+      for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i)
+      {
+        if (dense_[i] != 0) f(dense.elements[i], dense_[i]);
+      }
+      return;
+    }
+    std::vector<std::pair<const Element*, SignedSize> > sorted(begin(), end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<const Element*, SignedSize>& a, const std::pair<const Element*, SignedSize>& b)
+    {
+      return a.first->getSymbol() < b.first->getSymbol();
+    });
+    for (const auto& it : sorted)
+    {
+      f(it.first, it.second);
+    }
+  }
+
   EmpiricalFormula::EmpiricalFormula() :
-    charge_(0)
+    dense_(),
+    spill_(),
+    charge_(0),
+    mono_weight_(0.0),
+    average_weight_(0.0)
   {}
 
-  EmpiricalFormula::EmpiricalFormula(const String& formula)
+  EmpiricalFormula::EmpiricalFormula(EmpiricalFormula&& rhs) :
+    EmpiricalFormula()
+  {
+    *this = std::move(rhs);
+  }
+
+  EmpiricalFormula& EmpiricalFormula::operator=(EmpiricalFormula&& rhs) &
+  {
+    if (this == &rhs) return *this;
+    std::copy(rhs.dense_, rhs.dense_ + NUMBER_OF_DENSE_ELEMENTS, dense_);
+    spill_ = std::move(rhs.spill_);
+    charge_ = rhs.charge_;
+    mono_weight_ = rhs.mono_weight_;
+    average_weight_ = rhs.average_weight_;
+    // the dense array cannot be moved, so reset the source explicitly
+    std::fill(rhs.dense_, rhs.dense_ + NUMBER_OF_DENSE_ELEMENTS, 0);
+    rhs.spill_.clear();
+    rhs.charge_ = 0;
+    rhs.mono_weight_ = 0.0;
+    rhs.average_weight_ = 0.0;
+    return *this;
+  }
+
+  EmpiricalFormula::EmpiricalFormula(const String& formula) :
+    EmpiricalFormula()
   {
-    charge_ = parseFormula_(formula_, formula);
+    charge_ = parseFormula_(formula);
+    updateWeights_();
   }
 
-  EmpiricalFormula::EmpiricalFormula(SignedSize number, const Element* element, SignedSize charge)
+  EmpiricalFormula::EmpiricalFormula(SignedSize number, const Element* element, SignedSize charge) :
+    EmpiricalFormula()
   {
-    formula_[element] = number;
+    addElement_(element, number);
     charge_ = charge;
+    updateWeights_();
   }
 
   EmpiricalFormula::~EmpiricalFormula()
@@ -73,28 +263,18 @@ namespace OpenMS
 
   double EmpiricalFormula::getMonoWeight() const
   {
-    double weight = Constants::PROTON_MASS_U * charge_;
-    for (const auto& it : formula_)
-    {
-      weight += it.first->getMonoWeight() * (double)it.second;
-    }
-    return weight;
+    return mono_weight_ + Constants::PROTON_MASS_U * charge_;
   }
 
   double EmpiricalFormula::getAverageWeight() const
   {
-    double weight = Constants::PROTON_MASS_U * charge_;
-    for (const auto& it : formula_)
-    {
-      weight += it.first->getAverageWeight() * (double)it.second;
-    }
-    return weight;
+    return average_weight_ + Constants::PROTON_MASS_U * charge_;
   }
 
   double EmpiricalFormula::calculateTheoreticalIsotopesNumber() const
   {
     double total = 1;
-    for (const auto& element : formula_)
+    for (const auto& element : *this)
     {
       UInt non_trace_isotopes = 0;
       const auto& distr = element.first->getIsotopeDistribution();
@@ -128,7 +308,8 @@ namespace OpenMS
     // without requesting a negative number of hydrogens.
     bool ret = estimateFromWeightAndComp(remaining_weight, C, H, N, O, 0.0, P);
 
-    formula_.at(db->getElement("S")) = S;
+    dense_[getDenseIndex_(db->getElement("S"))] = S;
+    updateWeights_();
 
     return ret;
   }
@@ -146,13 +327,15 @@ namespace OpenMS
 
     double factor = average_weight / avgTotal;
 
-    formula_.clear();
+    std::fill(dense_, dense_ + NUMBER_OF_DENSE_ELEMENTS, 0);
+    spill_.clear();
 
-    formula_.insert(make_pair(db->getElement("C"), (SignedSize) Math::round(C * factor)));
-    formula_.insert(make_pair(db->getElement("N"), (SignedSize) Math::round(N * factor)));
-    formula_.insert(make_pair(db->getElement("O"), (SignedSize) Math::round(O * factor)));
-    formula_.insert(make_pair(db->getElement("S"), (SignedSize) Math::round(S * factor)));
-    formula_.insert(make_pair(db->getElement("P"), (SignedSize) Math::round(P * factor)));
+    addElement_(db->getElement("C"), (SignedSize) Math::round(C * factor));
+    addElement_(db->getElement("N"), (SignedSize) Math::round(N * factor));
+    addElement_(db->getElement("O"), (SignedSize) Math::round(O * factor));
+    addElement_(db->getElement("S"), (SignedSize) Math::round(S * factor));
+    addElement_(db->getElement("P"), (SignedSize) Math::round(P * factor));
+    updateWeights_();
 
     double remaining_mass = average_weight-getAverageWeight();
     SignedSize adjusted_H = Math::round(remaining_mass / db->getElement("H")->getAverageWeight());
@@ -165,7 +348,8 @@ namespace OpenMS
     }
 
     // Only insert hydrogens if their number is not negative.
-    formula_.insert(make_pair(db->getElement("H"), adjusted_H));
+    addElement_(db->getElement("H"), adjusted_H);
+    updateWeights_();
     // The approximation had no issues.
     return true;
   }
@@ -198,8 +382,13 @@ namespace OpenMS
 
   SignedSize EmpiricalFormula::getNumberOf(const Element* element) const
   {
-    const auto& it  = formula_.find(element);
-    if (it != formula_.end())
+    Size index = getDenseIndex_(element);
+    if (index < NUMBER_OF_DENSE_ELEMENTS)
+    {
+      return dense_[index];
+    }
+    const auto& it  = spill_.find(element);
+    if (it != spill_.end())
     {
       return it->second;
     }
@@ -209,7 +398,8 @@ namespace OpenMS
   SignedSize EmpiricalFormula::getNumberOfAtoms() const
   {
     SignedSize num_atoms(0);
-    for (const auto& it : formula_) num_atoms += it.second;
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i) num_atoms += dense_[i];
+    for (const auto& it : spill_) num_atoms += it.second;
     return num_atoms;
   }
 
@@ -226,17 +416,11 @@ namespace OpenMS
   String EmpiricalFormula::toString() const
   {
     String formula;
-    std::map<String, SignedSize> new_formula;
-
-    for (const auto& it : formula_)
-    {
-      new_formula[it.first->getSymbol()] = it.second;
-    }
-
-    for (const auto& it : new_formula)
+    forEachBySymbol_([&formula](const Element* element, SignedSize number)
     {
-      formula += it.first + String(it.second);
-    }
+      formula += element->getSymbol();
+      formula += String(number);
+    });
     return formula;
   }
 
@@ -244,7 +428,7 @@ namespace OpenMS
   {
     std::map<std::string, int> new_formula;
 
-    for (const auto & it : formula_)
+    for (const auto & it : *this)
     {
       new_formula[it.first->getSymbol()] = it.second;
     }
@@ -254,91 +438,55 @@ namespace OpenMS
   EmpiricalFormula EmpiricalFormula::operator*(const SignedSize& times) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula_) ef.formula_[it.first] *= times;
-    ef.charge_ *= times;
-    ef.removeZeroedElements_();
+    ef *= times;
     return ef;
   }
 
-  EmpiricalFormula EmpiricalFormula::operator+(const EmpiricalFormula& formula) const
+  EmpiricalFormula& EmpiricalFormula::operator*=(const SignedSize& times)
   {
-    EmpiricalFormula ef;
-    ef.formula_ = formula.formula_;
-    for (const auto& it : formula_)
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i) dense_[i] *= times;
+    if (times == 0)
     {
-      auto ef_it  = ef.formula_.find(it.first);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second += it.second;
-      }
-      else
-      {
-        ef.formula_.insert(it);
-      }
+      spill_.clear();
+    }
+    else
+    {
+      for (auto& it : spill_) it.second *= times;
     }
-    ef.charge_ = charge_ + formula.charge_;
-    ef.removeZeroedElements_();
+    charge_ *= times;
+    updateWeights_();
+    return *this;
+  }
+
+  EmpiricalFormula EmpiricalFormula::operator+(const EmpiricalFormula& formula) const
+  {
+    EmpiricalFormula ef(*this);
+    ef += formula;
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator+=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
-    {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second += it.second;
-      }
-      else
-      {
-        formula_.insert(it);
-      }
-    }
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i) dense_[i] += formula.dense_[i];
+    for (const auto& it : formula.spill_) addElement_(it.first, it.second);
     charge_ += formula.charge_;
-    removeZeroedElements_();
+    updateWeights_();
     return *this;
   }
 
   EmpiricalFormula EmpiricalFormula::operator-(const EmpiricalFormula& formula) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula.formula_)
-    {
-      const Element* e = it.first;
-      SignedSize num = it.second;
-      auto ef_it  = ef.formula_.find(e);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second -= num;
-      }
-      else
-      {
-        ef.formula_[e] = -num;
-      }
-    }
-
-    ef.charge_ = charge_ - formula.charge_;
-    ef.removeZeroedElements_();
+    ef -= formula;
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator-=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
-    {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second -= it.second;
-      }
-      else
-      {
-        formula_[it.first] = -it.second;
-      }
-    }
+    for (Size i = 0; i < NUMBER_OF_DENSE_ELEMENTS; ++i) dense_[i] -= formula.dense_[i];
+    for (const auto& it : formula.spill_) addElement_(it.first, -it.second);
     charge_ -= formula.charge_;
-    removeZeroedElements_();
+    updateWeights_();
     return *this;
   }
 
@@ -349,12 +497,12 @@ namespace OpenMS
 
   bool EmpiricalFormula::isEmpty() const
   {
-    return formula_.empty();
+    return begin() == end();
   }
 
   bool EmpiricalFormula::hasElement(const Element* element) const
   {
-    return formula_.find(element) != formula_.end();
+    return getNumberOf(element) != 0;
   }
 
   bool EmpiricalFormula::contains(const EmpiricalFormula& ef)
@@ -371,27 +519,22 @@ namespace OpenMS
 
   bool EmpiricalFormula::operator==(const EmpiricalFormula& formula) const
   {
-    return formula_ == formula.formula_ && charge_ == formula.charge_;
+    return std::equal(dense_, dense_ + NUMBER_OF_DENSE_ELEMENTS, formula.dense_) &&
+           spill_ == formula.spill_ && charge_ == formula.charge_;
   }
 
   bool EmpiricalFormula::operator!=(const EmpiricalFormula& formula) const
   {
-    return formula_ != formula.formula_ || charge_ != formula.charge_;
+    return !(*this == formula);
   }
 
   ostream& operator<<(ostream& os, const EmpiricalFormula& formula)
   {
-    std::map<String, SignedSize> new_formula;
-    for (const auto& it : formula.formula_)
+    formula.forEachBySymbol_([&os](const Element* element, SignedSize number)
     {
-      new_formula[it.first->getSymbol()] = it.second;
-    }
-
-    for (const auto& it : new_formula)
-    {
-      os << it.first;
-      if (it.second > 1) os << it.second;
-    }
+      os << element->getSymbol();
+      if (number > 1) os << number;
+    });
     if (formula.charge_ == 0)
     {
       return os;
@@ -422,7 +565,7 @@ namespace OpenMS
     return os;
   }
 
-  Int EmpiricalFormula::parseFormula_(std::map<const Element*, SignedSize>& ef, const String& input_formula) const
+  Int EmpiricalFormula::parseFormula_(const String& input_formula)
   {
     Int charge = 0;
     String formula(input_formula);
@@ -583,19 +726,7 @@ namespace OpenMS
       const ElementDB* db = ElementDB::getInstance();
       if (db->hasElement(symbol))
       {
-        if (num != 0)
-        {
-          const Element* e = db->getElement(symbol);
-          std::map<const Element*, SignedSize>::iterator it = ef.find(e);
-          if (it != ef.end())
-          {
-            it->second += num;
-          }
-          else
-          {
-            ef.insert(std::make_pair(e, num));
-          }
-        }
+        addElement_(db->getElement(symbol), num);
       }
       else
       {
@@ -603,50 +734,22 @@ namespace OpenMS
       }
     }
 
-    // remove elements with 0 counts
-    std::map<const Element*, SignedSize>::iterator it = ef.begin();
-    while (it != ef.end())
-    {
-      if (it->second == 0)
-      {
-        ef.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
-      }
-      else
-      {
-        ++it;
-      }
-    }
-
     return charge;
   }
 
-  void EmpiricalFormula::removeZeroedElements_()
-  {
-    MapType_::iterator it = formula_.begin();
-    while (it != formula_.end())
-    {
-      if (it->second == 0)
-      {
-        formula_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
-      }
-      else
-      {
-        ++it;
-      }
-    }
-  }
-
   bool EmpiricalFormula::operator<(const EmpiricalFormula& rhs) const
   {
-    if (formula_.size() != rhs.formula_.size())
+    const Size size = std::distance(begin(), end());
+    const Size rhs_size = std::distance(rhs.begin(), rhs.end());
+    if (size != rhs_size)
     {
-      return formula_.size() < rhs.formula_.size();
+      return size < rhs_size;
     }
 
-    // both maps have same size
-    auto it = formula_.begin();
-    auto rhs_it = rhs.formula_.begin();
-    for (; it != formula_.end(); ++it, ++rhs_it)
+    // both formulas have the same number of elements
+    auto it = begin();
+    auto rhs_it = rhs.begin();
+    for (; it != end(); ++it, ++rhs_it)
     {
       if (*(it->first) != *(rhs_it->first)) return *(it->first) < *(rhs_it->first); // element
       if (it->second != rhs_it->second) return it->second < rhs_it->second; // count
@@ -0,0 +1,187 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+
+using namespace std;
+
+namespace OpenMS
+{
+  CoarseIsotopePatternCache::CoarseIsotopePatternCache(const Size& max_isotope, const bool round_masses, const Size max_count, const std::vector<String>& elements) :
+    CoarseIsotopePatternGenerator(max_isotope, round_masses),
+    max_count_(max_count),
+    table_max_isotope_(max_isotope)
+  {
+    if (max_isotope == 0)
+    {
+      return; // unlimited distributions would make the tables too large
+    }
+
+    const ElementDB* db = ElementDB::getInstance();
+    for (const String& symbol : elements)
+    {
+      const Element* element = db->getElement(symbol);
+      if (element == nullptr)
+      {
+        throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, symbol);
+      }
+      ElementTable_ table;
+      table.element = element;
+      fillTable_(table);
+      tables_.push_back(table);
+    }
+  }
+
+  CoarseIsotopePatternCache::~CoarseIsotopePatternCache()
+  {
+  }
+
+  Size CoarseIsotopePatternCache::getMaxCount() const
+  {
+    return max_count_;
+  }
+
+  void CoarseIsotopePatternCache::fillTable_(ElementTable_& table) const
+  {
+    const IsotopeDistribution::ContainerType& input = table.element->getIsotopeDistribution().getContainer();
+    IsotopeDistribution::ContainerType input_l = fillGaps_(input);
+
+    // powers[i] is the distribution of 2^i atoms
+    std::vector<IsotopeDistribution::ContainerType> powers(1, input_l);
+
+    table.counts.resize(max_count_ + 1);
+    for (Size n = 0; n <= max_count_; ++n)
+    {
+      if (n == 1)
+      {
+        table.counts[n] = input;
+        continue;
+      }
+      // the same sequence of convolutions as convolvePow_, so the results are identical
+      IsotopeDistribution::ContainerType result;
+      if (n & 1)
+      {
+        result = input_l;
+      }
+      else
+      {
+        result.push_back(IsotopeDistribution::MassAbundance(0, 1.0));
+      }
+      for (Size i = 1; (Size(1) << i) <= n; ++i)
+      {
+        if (powers.size() <= i)
+        {
+          powers.push_back(convolveSquare_(powers.back()));
+        }
+        if (n & (Size(1) << i))
+        {
+          result = convolve_(result, powers[i]);
+        }
+      }
+      table.counts[n].swap(result);
+    }
+  }
+
+  const IsotopeDistribution::ContainerType* CoarseIsotopePatternCache::lookup_(const Element* element, SignedSize count) const
+  {
+    if (count < 0 || Size(count) > max_count_ || max_isotope_ != table_max_isotope_)
+    {
+      return nullptr;
+    }
+    for (const ElementTable_& table : tables_)
+    {
+      if (table.element == element)
+      {
+        return &table.counts[count];
+      }
+    }
+    return nullptr;
+  }
+
+  IsotopeDistribution CoarseIsotopePatternCache::run(const EmpiricalFormula& formula) const
+  {
+    IsotopeDistribution result;
+
+    for (auto it = formula.begin(); it != formula.end(); ++it)
+    {
+      const IsotopeDistribution::ContainerType* power = lookup_(it->first, it->second);
+      if (power != nullptr)
+      {
+        result.set(convolve_(result.getContainer(), *power));
+      }
+      else
+      {
+        IsotopeDistribution tmp = it->first->getIsotopeDistribution();
+        result.set(convolve_(result.getContainer(),
+                             convolvePow_(tmp.getContainer(), it->second)));
+      }
+    }
+
+    // replace atomic numbers with masses.
+    result.set(correctMass_(result.getContainer(), formula.getMonoWeight()));
+
+    result.renormalize();
+
+    return result;
+  }
+
+  void CoarseIsotopePatternCache::run(const std::vector<EmpiricalFormula>& formulas, std::vector<IsotopeDistribution>& result) const
+  {
+    result.resize(formulas.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)formulas.size(); ++i)
+    {
+      result[i] = run(formulas[i]);
+    }
+  }
+
+  void CoarseIsotopePatternCache::estimateFromPeptideWeight(const std::vector<double>& average_weights, std::vector<IsotopeDistribution>& result)
+  {
+    result.resize(average_weights.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)average_weights.size(); ++i)
+    {
+      result[i] = estimateFromPeptideWeight(average_weights[i]);
+    }
+  }
+
+}
@@ -50,7 +50,8 @@ namespace OpenMS
 {
   bool ModificationsDB::is_instantiated_ = false;
 
-  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file)
+  ModificationsDB::ModificationsDB(OpenMS::String unimod_file, OpenMS::String psimod_file, OpenMS::String xlmod_file) :
+    names_frozen_(false)
   {
     if (!unimod_file.empty())
     {
@@ -66,6 +67,7 @@ namespace OpenMS
     {
       readFromOBOFile(xlmod_file);
     }
+    names_frozen_ = true; // from now on, new names go to added_modification_names_
     is_instantiated_ = true;
   }
 
@@ -73,6 +75,7 @@ namespace OpenMS
   ModificationsDB::~ModificationsDB()
   {
     modification_names_.clear();
+    added_modification_names_.clear();
     for (auto it = mods_.begin(); it != mods_.end(); ++it)
     {
       delete *it;
@@ -111,38 +114,37 @@ namespace OpenMS
 
     String mod_name = mod_name_;
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    // no lock required: the name indices can be read concurrently (see class documentation)
+    const set<const ResidueModification*>* initial(nullptr);
+    const set<const ResidueModification*>* added(nullptr);
+    if (!findNamed_(mod_name, initial, added))
     {
-      bool found = true;
-      if (!modification_names_.has(mod_name))
+      // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
+      if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
       {
-        // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
-        if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
-        {
-          mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
-        }
+        mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
+      }
 
-        if (!modification_names_.has(mod_name))
-        {
-          OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
-          found = false; 
-        }
+      if (!findNamed_(mod_name, initial, added))
+      {
+        OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
+        return;
       }
+    }
 
-      if (found)
+    for (const set<const ResidueModification*>* named : {initial, added})
+    {
+      if (named == nullptr) continue;
+      for (const auto& it : *named)
       {
-        const set<const ResidueModification*>& temp = modification_names_[mod_name];
-        for (const auto& it : temp)
+        if (residuesMatch_(residue, it) &&
+             (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
+             (term_spec == it->getTermSpecificity())))
         {
-          if (residuesMatch_(residue, it) &&
-               (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
-               (term_spec == it->getTermSpecificity())))
-          {
-            mods.insert(it);
-          }
+          mods.insert(it);
         }
       }
-    } 
+    }
   }
 
   const ResidueModification* ModificationsDB::getModification(const String& mod_name, const String& residue, ResidueModification::TermSpecificity term_spec) const
@@ -179,30 +181,57 @@ namespace OpenMS
 
   bool ModificationsDB::has(String modification) const
   {
-    bool has_mod;
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const set<const ResidueModification*>* initial(nullptr);
+    const set<const ResidueModification*>* added(nullptr);
+    return findNamed_(modification, initial, added);
+  }
+
+  bool ModificationsDB::findNamed_(const String& name, const set<const ResidueModification*>*& initial, const set<const ResidueModification*>*& added) const
+  {
+    auto it = modification_names_.find(name);
+    initial = (it != modification_names_.end()) ? &it->second : nullptr;
+    added = added_modification_names_.find(name);
+    return (initial != nullptr) || (added != nullptr);
+  }
+
+  set<const ResidueModification*> ModificationsDB::getNamed_(const String& name) const
+  {
+    const set<const ResidueModification*>* initial(nullptr);
+    const set<const ResidueModification*>* added(nullptr);
+    set<const ResidueModification*> named;
+    if (findNamed_(name, initial, added))
     {
-      has_mod = modification_names_.has(modification);
+      if (initial != nullptr) named.insert(initial->begin(), initial->end());
+      if (added != nullptr) named.insert(added->begin(), added->end());
     }
-    return has_mod;
+    return named;
   }
 
-  Size ModificationsDB::findModificationIndex(const String & mod_name) const
+  void ModificationsDB::addName_(const String& name, const ResidueModification* mod)
   {
-    if (!has(mod_name))
+    if (!names_frozen_)
     {
-      throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: " + mod_name);
+      // still constructing: no other thread can see the database yet
+      modification_names_[name].insert(mod);
+      return;
     }
+    // copy-on-write: concurrent readers keep using the previous entry
+    const set<const ResidueModification*>* previous = added_modification_names_.find(name);
+    if (previous != nullptr && previous->count(mod) > 0) return;
+    set<const ResidueModification*> named;
+    if (previous != nullptr) named = *previous;
+    named.insert(mod);
+    added_modification_names_.insert(name, named);
+  }
 
-    bool one_mod(true);
-    #pragma omp critical(OpenMS_ModificationsDB)
+  Size ModificationsDB::findModificationIndex(const String & mod_name) const
+  {
+    set<const ResidueModification*> named = getNamed_(mod_name);
+    if (named.empty())
     {
-      if (modification_names_[mod_name].size() > 1)
-      {
-        one_mod = false;
-      }
+      throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: " + mod_name);
     }
-    if (!one_mod) 
+    if (named.size() > 1)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "More than one modification with name: " + mod_name);
     }
@@ -210,7 +239,7 @@ namespace OpenMS
     Size index(numeric_limits<Size>::max());
     #pragma omp critical(OpenMS_ModificationsDB)
     {
-      const ResidueModification* mod = *modification_names_[mod_name].begin();
+      const ResidueModification* mod = *named.begin();
       for (Size i = 0; i != mods_.size(); ++i)
       {
         if (mods_[i] == mod)
@@ -286,13 +315,13 @@ namespace OpenMS
       #pragma omp critical(OpenMS_ModificationsDB)
       {
         // e.g. Oxidation (M)
-        modification_names_[m->getFullId()].insert(m);
+        addName_(m->getFullId(), m);
         // e.g. Oxidation
-        modification_names_[m->getId()].insert(m);
+        addName_(m->getId(), m);
         // e.g. Oxidized
-        modification_names_[m->getFullName()].insert(m);
+        addName_(m->getFullName(), m);
         // e.g. UniMod:312
-        modification_names_[m->getUniModAccession()].insert(m);
+        addName_(m->getUniModAccession(), m);
         mods_.push_back(m);
       }
     }
@@ -300,19 +329,23 @@ namespace OpenMS
 
   void ModificationsDB::addModification(ResidueModification* new_mod)
   {
-    if (has(new_mod->getFullId()))
+    bool exists(false);
+    #pragma omp critical(OpenMS_ModificationsDB)
     {
-      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
-      return;
+      // check inside the critical section, so that the same modification cannot be added twice concurrently
+      exists = has(new_mod->getFullId());
+      if (!exists)
+      {
+        for (const String& name : {new_mod->getFullId(), new_mod->getId(), new_mod->getFullName(), new_mod->getUniModAccession()})
+        {
+          addName_(name, new_mod);
+        }
+        mods_.push_back(new_mod); // we probably want that
+      }
     }
-
-    #pragma omp critical(OpenMS_ModificationsDB)
+    if (exists)
     {
-      modification_names_[new_mod->getFullId()].insert(new_mod);
-      modification_names_[new_mod->getId()].insert(new_mod);
-      modification_names_[new_mod->getFullName()].insert(new_mod);
-      modification_names_[new_mod->getUniModAccession()].insert(new_mod);
-      mods_.push_back(new_mod); // we probably want that
+      OPENMS_LOG_WARN << "Modification already exists in ModificationsDB. Skipping." << new_mod->getFullId() << endl;
     }
   }
 
@@ -579,11 +612,10 @@ namespace OpenMS
         if (it->second.getUniModRecordId() > 0)
         {
           //cerr << "Found UniMod PSI-MOD mapping: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-          set<const ResidueModification*> mods = modification_names_[it->second.getUniModAccession()];
-          for (set<const ResidueModification*>::const_iterator mit = mods.begin(); mit != mods.end(); ++mit)
+          for (const ResidueModification* mod : getNamed_(it->second.getUniModAccession()))
           {
             //cerr << "Adding PSIMOD accession: " << it->second.getPSIMODAccession() << " " << it->second.getUniModAccession() << endl;
-            modification_names_[it->second.getPSIMODAccession()].insert(*mit);
+            addName_(it->second.getPSIMODAccession(), mod);
           }
         }
         else
@@ -610,7 +642,7 @@ namespace OpenMS
             // now check each of the names and link it to the residue modification
             for (set<String>::const_iterator nit = synonyms.begin(); nit != synonyms.end(); ++nit)
             {
-              modification_names_[*nit].insert(mods_.back());
+              addName_(*nit, mods_.back());
             }
           }
         }
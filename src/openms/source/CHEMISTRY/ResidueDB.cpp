@@ -75,17 +75,13 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No residue specified.", "");
     }
 
-    Residue* r(nullptr);
-    #pragma omp critical (ResidueDB)
-    {   
-      auto it = residue_names_.find(name);
-      if (it != residue_names_.end()) r = it->second;
-    }
-    if (r == nullptr)
+    // no lock required here because residue_names_ is only written during construction
+    auto it = residue_names_.find(name);
+    if (it == residue_names_.end())
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", name);
     }
-    return r;
+    return it->second;
   }
 
   const Residue* ResidueDB::getResidue(const unsigned char& one_letter_code) const
@@ -195,18 +191,13 @@ namespace OpenMS
         }
       }
     }
-    buildResidueNames_();
     return;
   }
 
   bool ResidueDB::hasResidue(const String& res_name) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = residue_names_.find(res_name) != residue_names_.end();
-    }  
-    return found;
+    // no lock required (see getResidue())
+    return residue_names_.find(res_name) != residue_names_.end();
   }
 
   bool ResidueDB::hasResidue(const Residue* residue) const
@@ -304,6 +295,7 @@ namespace OpenMS
     for (auto& r : modified_residues_) { delete r; }
     modified_residues_.clear();
     residue_mod_names_.clear();
+    modified_residue_lookup_.clear();
     const_modified_residues_.clear();
   }
 
@@ -508,8 +500,16 @@ namespace OpenMS
   const Residue* ResidueDB::getModifiedResidue(const Residue* residue, const String& modification)
   {
     OPENMS_PRECONDITION(!modification.empty(), "Modification cannot be empty")
-    // search if the mod already exists
+    // fast path: this combination was queried before
     const String & res_name = residue->getName();
+    const String key = res_name + '\t' + modification;
+    const Residue* const* known = modified_residue_lookup_.find(key);
+    if (known != nullptr)
+    {
+      return *known;
+    }
+
+    // search if the mod already exists
     Residue* res(nullptr);
     bool residue_found(true), mod_found(true);
     #pragma omp critical (ResidueDB)
@@ -548,6 +548,8 @@ namespace OpenMS
             res->setModification_(*mod);
             addResidue_(res);
           }
+          // also remember the name as queried, to skip the modification lookup next time
+          modified_residue_lookup_.insert(key, res);
         }
       }
     }
@@ -237,83 +237,199 @@ namespace OpenMS
   }
 
 
-  void IDFilter::removeUnreferencedProteins(
-    vector<ProteinIdentification>& proteins,
-    const vector<PeptideIdentification>& peptides)
+  void IDFilter::filterPeptideIDByAccessions_(
+    PeptideIdentification& peptide,
+    const ProteinAccessionIndex& index,
+    const vector<char>& whitelist,
+    const vector<char>& blacklist,
+    bool update_references,
+    bool remove_peptides_without_reference,
+    vector<vector<char> >* referenced)
   {
-    // collect accessions that are referenced by peptides for each ID run:
-    map<String, unordered_set<String> > run_to_accessions;
-    for (vector<PeptideIdentification>::const_iterator pep_it =
-           peptides.begin(); pep_it != peptides.end(); ++pep_it)
-    {
-      const String& run_id = pep_it->getIdentifier();
-      // extract protein accessions of each peptide hit:
-      for (vector<PeptideHit>::const_iterator hit_it =
-             pep_it->getHits().begin(); hit_it != pep_it->getHits().end();
-           ++hit_it)
+    const UInt32 run = index.findRun(peptide.getIdentifier());
+    const bool use_whitelist = !whitelist.empty();
+    vector<UInt32> ids;
+    vector<PeptideHit>& hits = peptide.getHits();
+    vector<PeptideHit>::iterator out = hits.begin();
+    for (vector<PeptideHit>::iterator hit_it = hits.begin(); hit_it != hits.end(); ++hit_it)
+    {
+      // one look-up per evidence for all filters:
+      const vector<PeptideEvidence>& evidences = hit_it->getPeptideEvidences();
+      ids.resize(evidences.size());
+      bool whitelisted = !use_whitelist, blacklisted = false;
+      for (Size i = 0; i < evidences.size(); ++i)
       {
+        ids[i] = index.find(evidences[i].getProteinAccession());
+        if (ids[i] == ProteinAccessionIndex::NOT_FOUND) continue;
+        if (ids[i] < whitelist.size() && whitelist[ids[i]]) whitelisted = true;
+        if (ids[i] < blacklist.size() && blacklist[ids[i]]) blacklisted = true;
+      }
+      if (!whitelisted || blacklisted) continue;
 
-        const set<String>& current_accessions = 
-          hit_it->extractProteinAccessionsSet();
+      if (update_references)
+      {
+        // remaining proteins: present in the run and not removed by the accession lists
+        vector<PeptideEvidence> kept;
+        kept.reserve(evidences.size());
+        for (Size i = 0; i < evidences.size(); ++i)
+        {
+          UInt32 id = ids[i];
+          if (!index.isInRun(id, run)) continue;
+          if (use_whitelist && !(id < whitelist.size() && whitelist[id])) continue;
+          if (id < blacklist.size() && blacklist[id]) continue;
+          kept.push_back(evidences[i]);
+        }
+        if (kept.size() != evidences.size()) hit_it->setPeptideEvidences(kept);
+        if (kept.empty() && remove_peptides_without_reference) continue;
+      }
 
-        run_to_accessions[run_id].insert(current_accessions.begin(),
-                                         current_accessions.end());
+      if (referenced && run != ProteinAccessionIndex::NOT_FOUND)
+      {
+        vector<char>& flags = (*referenced)[run];
+        for (UInt32 id : ids)
+        {
+          if (id < flags.size())
+          {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+            flags[id] = 1;
+          }
+        }
       }
-    }
 
-    for (vector<ProteinIdentification>::iterator prot_it = proteins.begin();
-         prot_it != proteins.end(); ++prot_it)
-    {
-      const String& run_id = prot_it->getIdentifier();
-      const unordered_set<String>& accessions = run_to_accessions[run_id];
-      struct HasMatchingAccessionUnordered<ProteinHit> acc_filter(accessions);
-      keepMatchingItems(prot_it->getHits(), acc_filter);
+      if (out != hit_it) *out = std::move(*hit_it);
+      ++out;
     }
+    hits.erase(out, hits.end());
   }
 
-  void IDFilter::updateProteinReferences(
-      ConsensusMap& cmap,
-      bool remove_peptides_without_reference)
+  void IDFilter::filterProteinIDsByAccessions_(
+    vector<ProteinIdentification>& proteins,
+    ProteinAccessionIndex& index,
+    const vector<char>& whitelist,
+    const vector<char>& blacklist,
+    const vector<vector<char> >* referenced)
   {
-    vector<ProteinIdentification>& proteins = cmap.getProteinIdentifications();
-    // collect valid protein accessions for each ID run:
-    map<String, unordered_set<String> > run_to_accessions;
-    for (vector<ProteinIdentification>::const_iterator prot_it =
-        proteins.begin(); prot_it != proteins.end(); ++prot_it)
+    for (ProteinIdentification& prot : proteins)
     {
-      const String& run_id = prot_it->getIdentifier();
-      for (vector<ProteinHit>::const_iterator hit_it =
-          prot_it->getHits().begin(); hit_it != prot_it->getHits().end();
-           ++hit_it)
+      const UInt32 run = index.findRun(prot.getIdentifier());
+      vector<ProteinHit>& hits = prot.getHits();
+      vector<ProteinHit> kept;
+      kept.reserve(hits.size());
+      for (ProteinHit& hit : hits)
       {
-        run_to_accessions[run_id].insert(hit_it->getAccession());
+        const UInt32 id = index.find(hit.getAccession());
+        bool keep = whitelist.empty() || (id < whitelist.size() && whitelist[id]);
+        keep = keep && !(id < blacklist.size() && blacklist[id]);
+        keep = keep && (!referenced || (run < referenced->size() && id < (*referenced)[run].size() && (*referenced)[run][id]));
+        if (keep)
+        {
+          kept.push_back(std::move(hit));
+        }
       }
+      hits.swap(kept);
     }
 
-    function<void(PeptideIdentification&)> f = [&run_to_accessions,&remove_peptides_without_reference]
-        (PeptideIdentification& pep_it) -> void
+    // the removed accessions may still be present in another ID of the same run
+    index.build(proteins);
+  }
+
+  void IDFilter::filterByProteinAccessions(
+    vector<PeptideIdentification>& peptides,
+    vector<ProteinIdentification>& proteins,
+    ProteinAccessionIndex& index,
+    const AccessionFilter& filter)
+  {
+    vector<char> whitelist, blacklist;
+    if (!filter.whitelist.empty()) whitelist = index.createMask(filter.whitelist);
+    if (!filter.blacklist.empty()) blacklist = index.createMask(filter.blacklist);
+
+    vector<vector<char> > referenced;
+    if (filter.remove_unreferenced_proteins)
     {
-      const String& run_id = pep_it.getIdentifier();
-      const unordered_set<String>& accessions = run_to_accessions[run_id];
-      struct HasMatchingAccessionUnordered<PeptideEvidence> acc_filter(accessions);
-      // check protein accessions of each peptide hit
-      for (vector<PeptideHit>::iterator hit_it = pep_it.getHits().begin();
-           hit_it != pep_it.getHits().end(); ++hit_it)
+      referenced.assign(index.getNrRuns(), vector<char>(index.size(), 0));
+    }
+    vector<vector<char> >* referenced_ptr = filter.remove_unreferenced_proteins ? &referenced : nullptr;
+
+    const bool filter_peptides = !whitelist.empty() || !blacklist.empty() || filter.update_references;
+    if (filter_peptides || referenced_ptr)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)peptides.size(); ++i)
       {
-        // no non-const "PeptideHit::getPeptideEvidences" implemented, so we
-        // can't use "keepMatchingItems":
-        vector<PeptideEvidence> evidences;
-        remove_copy_if(hit_it->getPeptideEvidences().begin(),
-                       hit_it->getPeptideEvidences().end(),
-                       back_inserter(evidences),
-                       not1(acc_filter));
-        hit_it->setPeptideEvidences(evidences);
+        filterPeptideIDByAccessions_(peptides[i], index, whitelist, blacklist,
+                                     filter.update_references,
+                                     filter.remove_peptides_without_reference,
+                                     referenced_ptr);
       }
+    }
 
-      if (remove_peptides_without_reference)
+    if (!whitelist.empty() || !blacklist.empty() || referenced_ptr)
+    {
+      filterProteinIDsByAccessions_(proteins, index, whitelist, blacklist, referenced_ptr);
+    }
+  }
+
+  void IDFilter::filterByProteinAccessions(
+    vector<PeptideIdentification>& peptides,
+    vector<ProteinIdentification>& proteins,
+    const AccessionFilter& filter)
+  {
+    ProteinAccessionIndex index(proteins);
+    filterByProteinAccessions(peptides, proteins, index, filter);
+  }
+
+  void IDFilter::removeUnreferencedProteins(
+    vector<ProteinIdentification>& proteins,
+    const vector<PeptideIdentification>& peptides)
+  {
+    ProteinAccessionIndex index(proteins);
+
+    // flag accessions that are referenced by peptides for each ID run:
+    vector<vector<char> > referenced(index.getNrRuns(), vector<char>(index.size(), 0));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)peptides.size(); ++i)
+    {
+      const UInt32 run = index.findRun(peptides[i].getIdentifier());
+      if (run == ProteinAccessionIndex::NOT_FOUND) continue;
+      vector<char>& flags = referenced[run];
+      for (const PeptideHit& hit : peptides[i].getHits())
       {
-        removeMatchingItems(pep_it.getHits(), HasNoEvidence());
+        for (const PeptideEvidence& evidence : hit.getPeptideEvidences())
+        {
+          const UInt32 id = index.find(evidence.getProteinAccession());
+          if (id != ProteinAccessionIndex::NOT_FOUND)
+          {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+            flags[id] = 1;
+          }
+        }
       }
+    }
+
+    filterProteinIDsByAccessions_(proteins, index, vector<char>(), vector<char>(), &referenced);
+  }
+
+  void IDFilter::updateProteinReferences(
+      ConsensusMap& cmap,
+      bool remove_peptides_without_reference)
+  {
+    // interned accessions of the valid proteins for each ID run:
+    const ProteinAccessionIndex index(cmap.getProteinIdentifications());
+    const vector<char> no_filter;
+
+    function<void(PeptideIdentification&)> f = [&index, &no_filter, &remove_peptides_without_reference]
+        (PeptideIdentification& pep) -> void
+    {
+      filterPeptideIDByAccessions_(pep, index, no_filter, no_filter, true,
+                                   remove_peptides_without_reference, nullptr);
     };
 
     cmap.applyFunctionOnPeptideIDs(f);
@@ -324,44 +440,17 @@ namespace OpenMS
     const vector<ProteinIdentification>& proteins,
     bool remove_peptides_without_reference)
   {
-    // collect valid protein accessions for each ID run:
-    map<String, unordered_set<String> > run_to_accessions;
-    for (vector<ProteinIdentification>::const_iterator prot_it =
-           proteins.begin(); prot_it != proteins.end(); ++prot_it)
-    {
-      const String& run_id = prot_it->getIdentifier();
-      for (vector<ProteinHit>::const_iterator hit_it =
-             prot_it->getHits().begin(); hit_it != prot_it->getHits().end();
-           ++hit_it)
-      {
-        run_to_accessions[run_id].insert(hit_it->getAccession());
-      }
-    }
+    // interned accessions of the valid proteins for each ID run:
+    const ProteinAccessionIndex index(proteins);
+    const vector<char> no_filter;
 
-    for (vector<PeptideIdentification>::iterator pep_it = peptides.begin();
-         pep_it != peptides.end(); ++pep_it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)peptides.size(); ++i)
     {
-      const String& run_id = pep_it->getIdentifier();
-      const unordered_set<String>& accessions = run_to_accessions[run_id];
-      struct HasMatchingAccessionUnordered<PeptideEvidence> acc_filter(accessions);
-      // check protein accessions of each peptide hit
-      for (vector<PeptideHit>::iterator hit_it = pep_it->getHits().begin();
-           hit_it != pep_it->getHits().end(); ++hit_it)
-      {
-        // no non-const "PeptideHit::getPeptideEvidences" implemented, so we
-        // can't use "keepMatchingItems":
-        vector<PeptideEvidence> evidences;
-        remove_copy_if(hit_it->getPeptideEvidences().begin(),
-                       hit_it->getPeptideEvidences().end(),
-                       back_inserter(evidences),
-                       not1(acc_filter));
-        hit_it->setPeptideEvidences(evidences);
-      }
-
-      if (remove_peptides_without_reference)
-      {
-        removeMatchingItems(pep_it->getHits(), HasNoEvidence());
-      }
+      filterPeptideIDByAccessions_(peptides[i], index, no_filter, no_filter, true,
+                                   remove_peptides_without_reference, nullptr);
     }
   }
 
@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FILTERING/ID/ProteinAccessionIndex.h>
+
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const UInt32 ProteinAccessionIndex::NOT_FOUND = numeric_limits<UInt32>::max();
+
+  ProteinAccessionIndex::ProteinAccessionIndex()
+  {
+  }
+
+  ProteinAccessionIndex::ProteinAccessionIndex(const vector<ProteinIdentification>& proteins)
+  {
+    build(proteins);
+  }
+
+  void ProteinAccessionIndex::build(const vector<ProteinIdentification>& proteins)
+  {
+    Size nr_hits = 0;
+    for (const ProteinIdentification& prot : proteins)
+    {
+      nr_hits += prot.getHits().size();
+    }
+    ids_.reserve(ids_.size() + nr_hits);
+    accessions_.reserve(accessions_.size() + nr_hits);
+
+    // intern first, so that all membership vectors can be sized to the pool
+    runs_.clear();
+    vector<UInt32> run_of_id(proteins.size());
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      run_of_id[i] = runs_.emplace(proteins[i].getIdentifier(), static_cast<UInt32>(runs_.size())).first->second;
+      for (const ProteinHit& hit : proteins[i].getHits())
+      {
+        insert(hit.getAccession());
+      }
+    }
+
+    run_members_.assign(runs_.size(), vector<char>(accessions_.size(), 0));
+    for (Size i = 0; i < proteins.size(); ++i)
+    {
+      vector<char>& members = run_members_[run_of_id[i]];
+      for (const ProteinHit& hit : proteins[i].getHits())
+      {
+        members[find(hit.getAccession())] = 1;
+      }
+    }
+  }
+
+  UInt32 ProteinAccessionIndex::insert(const String& accession)
+  {
+    auto pos = ids_.emplace(accession, static_cast<UInt32>(accessions_.size()));
+    if (pos.second)
+    {
+      accessions_.push_back(&pos.first->first);
+    }
+    return pos.first->second;
+  }
+
+  UInt32 ProteinAccessionIndex::find(const String& accession) const
+  {
+    auto pos = ids_.find(accession);
+    return (pos == ids_.end()) ? NOT_FOUND : pos->second;
+  }
+
+  const String& ProteinAccessionIndex::getAccession(UInt32 id) const
+  {
+    return *accessions_.at(id);
+  }
+
+  Size ProteinAccessionIndex::size() const
+  {
+    return accessions_.size();
+  }
+
+  Size ProteinAccessionIndex::getNrRuns() const
+  {
+    return run_members_.size();
+  }
+
+  UInt32 ProteinAccessionIndex::findRun(const String& identifier) const
+  {
+    auto pos = runs_.find(identifier);
+    return (pos == runs_.end()) ? NOT_FOUND : pos->second;
+  }
+
+  void ProteinAccessionIndex::removeFromRun(UInt32 id, UInt32 run)
+  {
+    if (isInRun(id, run))
+    {
+      run_members_[run][id] = 0;
+    }
+  }
+
+  vector<char> ProteinAccessionIndex::createMask(const set<String>& accessions)
+  {
+    vector<UInt32> ids;
+    ids.reserve(accessions.size());
+    for (const String& acc : accessions)
+    {
+      ids.push_back(insert(acc));
+    }
+    vector<char> mask(accessions_.size(), 0);
+    for (UInt32 id : ids)
+    {
+      mask[id] = 1;
+    }
+    return mask;
+  }
+
+} // namespace OpenMS
@@ -4,6 +4,7 @@ set(directory source/FILTERING/ID)
 ### list all filenames of the directory here
 set(sources_list
 IDFilter.cpp
+ProteinAccessionIndex.cpp
 )
 
 ### add path to the filenames
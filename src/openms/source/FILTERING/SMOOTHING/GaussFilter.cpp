@@ -34,6 +34,10 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -54,6 +58,54 @@ namespace OpenMS
   {
   }
 
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    if (!map.getChromatograms().empty() && param_.getValue("use_ppm_tolerance").toBool())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "GaussFilter: Cannot use ppm tolerance on chromatograms");
+    }
+
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      // in ppm mode, the kernel is re-initialized for every data point, so each thread needs its own copy
+      GaussFilterAlgorithm gauss_algo = gauss_algo_;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+      {
+        filter_(map[i], gauss_algo);
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
+      }
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
+      {
+        filter_(map.getChromatogram(i), gauss_algo);
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
+      }
+    }
+    endProgress();
+  }
+
   void GaussFilter::updateMembers_()
   {
     gauss_algo_.initialize((double)param_.getValue("gaussian_width"), spacing_,
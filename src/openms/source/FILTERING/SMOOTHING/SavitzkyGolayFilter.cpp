@@ -38,6 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -55,6 +59,99 @@ namespace OpenMS
   {
   }
 
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map)
+  {
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      filter(map[i]);
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+      IF_MASTERTHREAD setProgress(progress);
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
+    {
+      filter(map.getChromatogram(i));
+
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++progress;
+      IF_MASTERTHREAD setProgress(progress);
+    }
+    endProgress();
+  }
+
+  void SavitzkyGolayFilter::convolve_(const std::vector<double>& in, std::vector<double>& out) const
+  {
+    const Size n = in.size();
+    const Size frame_size = frame_size_;
+    const Size mid = frame_size / 2;
+    const double* x = &in[0];
+    out.assign(n, 0.0);
+    double* y = &out[0];
+
+    // compute the transient on (all use the first frame_size data points)
+    for (Size i = 0; i <= mid; ++i)
+    {
+      const double* c = &coeffs_[(i + 1) * frame_size - 1];
+      double help = 0;
+      for (Size j = 0; j < frame_size; ++j)
+      {
+        help += x[j] * *(c - j);
+      }
+      y[i] = help;
+    }
+
+    // compute the steady state output: y[k] = sum_j x[k - mid + j] * c[j]
+    // Loop over the coefficients outside and over a block of outputs inside (keeps the block in cache,
+    // the inner loop is a plain axpy and the summation order per output is the same as in a dot product).
+    const double* c = &coeffs_[mid * frame_size];
+    const Size steady_begin = mid + 1;
+    const Size steady_end = n - mid;
+    const Size block_size = 1024;
+    for (Size block_begin = steady_begin; block_begin < steady_end; block_begin += block_size)
+    {
+      const Size block_end = std::min(block_begin + block_size, steady_end);
+      for (Size j = 0; j < frame_size; ++j)
+      {
+        const double cj = c[j];
+        for (Size k = block_begin; k < block_end; ++k)
+        {
+          y[k] += x[k + j - mid] * cj;
+        }
+      }
+    }
+
+    // compute the transient off (all use the last frame_size data points)
+    const double* x_last = x + (n - frame_size);
+    for (Size i = 0; i < mid; ++i)
+    {
+      const double* c_i = &coeffs_[i * frame_size];
+      double help = 0;
+      for (Size j = 0; j < frame_size; ++j)
+      {
+        help += x_last[j] * c_i[j];
+      }
+      y[n - 1 - i] = help;
+    }
+
+    for (Size k = 0; k < n; ++k)
+    {
+      y[k] = std::max(0.0, y[k]);
+    }
+  }
+
   void SavitzkyGolayFilter::updateMembers_()
   {
     frame_size_ = (UInt)param_.getValue("frame_length");
@@ -35,6 +35,9 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 namespace OpenMS
 {
@@ -112,4 +115,105 @@ namespace OpenMS
     return *this;
   }
 
+  void SpectraMerger::setUpAlignment_(SpectrumAlignment& sas) const
+  {
+    double mz_binning_width(param_.getValue("mz_binning_width"));
+    String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
+    if (!(mz_binning_unit == "Da" || mz_binning_unit == "ppm"))
+    {
+      throw Exception::IllegalSelfOperation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);  // sanity check
+    }
+
+    Param p;
+    p.setValue("tolerance", mz_binning_width);
+    p.setValue("is_relative_tolerance", mz_binning_unit == "Da" ? "false" : "true");
+    sas.setParameters(p);
+  }
+
+  void SpectraMerger::clusterPrecursors_(const std::vector<Peak2D>& data, std::vector<std::vector<Size> >& clusters) const
+  {
+    clusters.clear();
+    if (data.empty())
+    {
+      return;
+    }
+
+    SpectraDistance_ llc;
+    llc.setParameters(param_.copy("precursor_method:", true));
+
+    // grid cells must not be smaller than the tolerances (otherwise linked positions might not be in neighbouring cells)
+    const double min_cell_size = 1e-6;
+    double rt_cell = std::max(double(param_.getValue("precursor_method:rt_tolerance")), min_cell_size);
+    double mz_cell = std::max(double(param_.getValue("precursor_method:mz_tolerance")), min_cell_size);
+
+    // grid: (cell, index) sorted by cell
+    typedef std::pair<Int64, Int64> Cell;
+    std::vector<std::pair<Cell, Size> > grid;
+    grid.reserve(data.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      grid.push_back(std::make_pair(Cell(Int64(std::floor(data[i].getRT() / rt_cell)), Int64(std::floor(data[i].getMZ() / mz_cell))), i));
+    }
+    std::sort(grid.begin(), grid.end());
+
+    // union-find; the root of each set is its smallest index
+    std::vector<Size> parent(data.size());
+    for (Size i = 0; i < parent.size(); ++i)
+    {
+      parent[i] = i;
+    }
+    auto find_root = [&parent](Size i) -> Size
+    {
+      while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]]; // path halving
+        i = parent[i];
+      }
+      return i;
+    };
+
+    for (auto it = grid.begin(); it != grid.end(); ++it)
+    {
+      const Cell& cell = it->first;
+      const Size i = it->second;
+      for (Int64 d_rt = -1; d_rt <= 1; ++d_rt)
+      {
+        for (Int64 d_mz = -1; d_mz <= 1; ++d_mz)
+        {
+          const Cell neighbour(cell.first + d_rt, cell.second + d_mz);
+          auto first = std::lower_bound(grid.begin(), grid.end(), std::make_pair(neighbour, Size(0)));
+          for (auto it_n = first; it_n != grid.end() && it_n->first == neighbour; ++it_n)
+          {
+            const Size j = it_n->second;
+            // every pair is tested once; clustering threshold is at similarity 0 (see ClusterHierarchical)
+            if (j <= i || !(llc(data[i], data[j]) > 0))
+            {
+              continue;
+            }
+            Size root_i = find_root(i);
+            Size root_j = find_root(j);
+            if (root_i != root_j)
+            {
+              parent[std::max(root_i, root_j)] = std::min(root_i, root_j);
+            }
+          }
+        }
+      }
+    }
+
+    // collect clusters; members are visited in ascending order and roots are the smallest members,
+    // so clusters are sorted internally and by their first element
+    std::vector<Size> cluster_of_root(data.size(), data.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      Size root = find_root(i);
+      if (cluster_of_root[root] == data.size())
+      {
+        cluster_of_root[root] = clusters.size();
+        clusters.push_back(std::vector<Size>());
+      }
+      clusters[cluster_of_root[root]].push_back(i);
+    }
+  }
+
 }
@@ -41,12 +41,12 @@ using namespace xercesc;
 namespace OpenMS
 {
   Bzip2InputStream::Bzip2InputStream(const   String & file_name) :
-    bzip2_(new Bzip2Ifstream(file_name.c_str())), file_current_index_(0)
+    bzip2_(new ReadAheadDecompressor(file_name.c_str())), file_current_index_(0)
   {
   }
 
   Bzip2InputStream::Bzip2InputStream(const   char * file_name) :
-    bzip2_(new Bzip2Ifstream(file_name)), file_current_index_(0)
+    bzip2_(new ReadAheadDecompressor(file_name)), file_current_index_(0)
   {
   }
 
@@ -0,0 +1,281 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChannelExtractingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <limits>
+
+namespace OpenMS
+{
+
+  MSDataChannelExtractingConsumer::MSDataChannelExtractingConsumer(const IsobaricQuantitationMethod* const quant_method) :
+    IsobaricChannelExtractor(quant_method),
+    is_valid_activation_(StringList()),
+    quant_ms_level_(0),
+    element_index_(0),
+    last_rt_(-std::numeric_limits<double>::max()),
+    nr_consumed_(0)
+  {
+    updateMembers_();
+  }
+
+  MSDataChannelExtractingConsumer::~MSDataChannelExtractingConsumer()
+  {
+  }
+
+  void MSDataChannelExtractingConsumer::updateMembers_()
+  {
+    IsobaricChannelExtractor::updateMembers_();
+    is_valid_activation_ = HasActivationMethod<MSSpectrum>(ListUtils::create<String>(selected_activation_));
+  }
+
+  void MSDataChannelExtractingConsumer::setExpectedSize(Size /* expectedSpectra */, Size /* expectedChromatograms */)
+  {
+  }
+
+  void MSDataChannelExtractingConsumer::setExperimentalSettings(const ExperimentalSettings& /* exp */)
+  {
+  }
+
+  void MSDataChannelExtractingConsumer::consumeChromatogram(ChromatogramType& /* c */)
+  {
+  }
+
+  void MSDataChannelExtractingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    const double rt = s.getRT();
+    if (rt < last_rt_)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Spectra are not sorted in RT! Please sort them first! (spectrum #" + String(nr_consumed_) + ")");
+    }
+    last_rt_ = rt;
+    ++nr_consumed_;
+
+    const UInt ms_level = s.getMSLevel();
+    if (ms_level == 1)
+    {
+      SpectrumPtr_ ms1(new MSSpectrum(std::move(s)));
+
+      // this is the follow up scan of all waiting spectra with a smaller RT
+      Size nr_followed = 0;
+      while (nr_followed < waiting_.size() && waiting_[nr_followed].spectrum->getRT() < rt)
+      {
+        waiting_[nr_followed].follow_up_scan = ms1;
+        ready_.push_back(waiting_[nr_followed]);
+        ++nr_followed;
+      }
+      waiting_.erase(waiting_.begin(), waiting_.begin() + nr_followed);
+
+      // remember potential precursor
+      current_ms1_ = ms1;
+
+      if (ready_.size() >= EXTRACTION_BATCH_SIZE)
+      {
+        extractReady_();
+      }
+      return;
+    }
+
+    ++activation_modes_[getActivationMethod_(s)]; // count HCD, CID, ...
+    const bool valid_activation = selected_activation_.empty() || is_valid_activation_(s);
+    if (valid_activation)
+    {
+      ++ms_level_[ms_level];
+      if (ms_level > quant_ms_level_)
+      {
+        setQuantMSLevel_(ms_level);
+      }
+    }
+
+    bool quantify = valid_activation && ms_level == quant_ms_level_ && !s.empty();
+    if (quantify && !isValidPrecursor_(s.getPrecursors()[0]))
+    {
+      OPENMS_LOG_DEBUG << "Skip spectrum " << s.getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+      quantify = false;
+    }
+    if (!quantify && ms_level != 2)
+    {
+      return;
+    }
+
+    std::shared_ptr<MSSpectrum> spectrum(new MSSpectrum(std::move(s)));
+    if (!quantify)
+    {
+      // only the meta data is needed (as precursor of an MS3 spectrum)
+      spectrum->clear(false);
+    }
+    if (ms_level == 2)
+    {
+      last_ms2_.push_back(spectrum);
+      if (last_ms2_.size() > MS2_BUFFER_SIZE)
+      {
+        last_ms2_.pop_front();
+      }
+    }
+    if (!quantify)
+    {
+      return;
+    }
+
+    PendingSpectrum_ pending;
+    pending.spectrum = spectrum;
+    pending.precursor_scan = current_ms1_;
+    pending.ms2_spectrum = (ms_level == 3) ? findMS2Spectrum_(*spectrum) : pending.spectrum;
+
+    // the follow up scan is only needed for the interpolation of the precursor purity
+    if (interpolate_precursor_purity_ && current_ms1_)
+    {
+      waiting_.push_back(pending);
+    }
+    else
+    {
+      ready_.push_back(pending);
+      if (ready_.size() >= EXTRACTION_BATCH_SIZE)
+      {
+        extractReady_();
+      }
+    }
+  }
+
+  void MSDataChannelExtractingConsumer::setQuantMSLevel_(UInt ms_level)
+  {
+    // everything of the lower level is not needed anymore
+    waiting_.clear();
+    ready_.clear();
+    features_.clear(false);
+    channel_qc_.clear();
+    element_index_ = 0;
+    quant_ms_level_ = ms_level;
+  }
+
+  MSDataChannelExtractingConsumer::SpectrumPtr_ MSDataChannelExtractingConsumer::findMS2Spectrum_(const MSSpectrum& s) const
+  {
+    if (last_ms2_.empty())
+    {
+      return SpectrumPtr_();
+    }
+    // same logic as MSExperiment::getPrecursorSpectrum, restricted to the last MS2 spectra
+    if (!s.getPrecursors().empty() && s.getPrecursors()[0].metaValueExists("spectrum_ref"))
+    {
+      const String ref = s.getPrecursors()[0].getMetaValue("spectrum_ref");
+      for (std::deque<SpectrumPtr_>::const_reverse_iterator it = last_ms2_.rbegin(); it != last_ms2_.rend(); ++it)
+      {
+        if ((*it)->getNativeID() == ref)
+        {
+          return *it;
+        }
+      }
+    }
+    return last_ms2_.back();
+  }
+
+  void MSDataChannelExtractingConsumer::extractReady_()
+  {
+    if (ready_.empty())
+    {
+      return;
+    }
+
+    std::vector<ExtractionTask_> tasks(ready_.size());
+    for (Size i = 0; i < ready_.size(); ++i)
+    {
+      tasks[i].spectrum = ready_[i].spectrum.get();
+      tasks[i].precursor_scan = ready_[i].precursor_scan.get();
+      tasks[i].follow_up_scan = ready_[i].follow_up_scan.get();
+      tasks[i].ms2_spectrum = ready_[i].ms2_spectrum.get();
+    }
+
+    std::vector<ExtractionResult_> results;
+    extractTasks_(tasks, results);
+    appendFeatures_(tasks, results, features_, channel_qc_, element_index_);
+    ready_.clear();
+  }
+
+  void MSDataChannelExtractingConsumer::finish(ConsensusMap& consensus_map)
+  {
+    if (nr_consumed_ == 0)
+    {
+      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    // the waiting spectra have no follow up scan
+    ready_.insert(ready_.end(), waiting_.begin(), waiting_.end());
+    waiting_.clear();
+    extractReady_();
+
+    // clear the output map
+    consensus_map.clear(false);
+    consensus_map.setExperimentType("labeled_MS2");
+
+    OPENMS_LOG_INFO << "Selecting scans with activation mode: " << (selected_activation_ == "" ? "any" : selected_activation_) << std::endl;
+    if (selectQuantMSLevel_(ms_level_, activation_modes_) != 0)
+    {
+      consensus_map.reserve(features_.size());
+      for (ConsensusMap::iterator it = features_.begin(); it != features_.end(); ++it)
+      {
+        consensus_map.push_back(std::move(*it));
+      }
+
+      logChannelQC_(channel_qc_);
+
+      /// add meta information to the map
+      registerChannelsInOutputMap_(consensus_map);
+    }
+
+    clear_();
+  }
+
+  void MSDataChannelExtractingConsumer::clear_()
+  {
+    activation_modes_.clear();
+    ms_level_.clear();
+    quant_ms_level_ = 0;
+    current_ms1_.reset();
+    last_ms2_.clear();
+    waiting_.clear();
+    ready_.clear();
+    features_.clear(false);
+    channel_qc_.clear();
+    element_index_ = 0;
+    last_rt_ = -std::numeric_limits<double>::max();
+    nr_consumed_ = 0;
+  }
+
+} // namespace OpenMS
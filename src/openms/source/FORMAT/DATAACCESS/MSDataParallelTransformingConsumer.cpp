@@ -0,0 +1,218 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    next_consumer_(next_consumer),
+    batch_size_(std::max(batch_size, Size(1))),
+    spectrum_func_(nullptr),
+    chromatogram_func_(nullptr),
+    nr_spectra_(0),
+    nr_chromatograms_(0)
+  {
+#ifdef _OPENMP
+    Size nr_threads = omp_get_max_threads();
+#else
+    Size nr_threads = 1;
+#endif
+    spectrum_scratch_.resize(nr_threads);
+    chromatogram_scratch_.resize(nr_threads);
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    // flush remaining data (errors of the processing functions or the next consumer must not escape the destructor)
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "MSDataParallelTransformingConsumer: could not process the remaining data: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+      OPENMS_LOG_ERROR << "MSDataParallelTransformingConsumer: could not process the remaining data." << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataParallelTransformingConsumer::setSpectraProcessingFunc(SpectrumFunction f_spec)
+  {
+    spectrum_func_ = f_spec;
+  }
+
+  void MSDataParallelTransformingConsumer::setChromatogramProcessingFunc(ChromatogramFunction f_chrom)
+  {
+    chromatogram_func_ = f_chrom;
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the original order of spectra and chromatograms
+    processChromatograms_();
+
+    // copy (not move), since the caller might still need the spectrum; assignment re-uses the buffers of the slot
+    if (nr_spectra_ == spectra_.size())
+    {
+      spectra_.push_back(s);
+    }
+    else
+    {
+      spectra_[nr_spectra_] = s;
+    }
+    ++nr_spectra_;
+
+    if (nr_spectra_ == batch_size_)
+    {
+      processSpectra_();
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the original order of spectra and chromatograms
+    processSpectra_();
+
+    if (nr_chromatograms_ == chromatograms_.size())
+    {
+      chromatograms_.push_back(c);
+    }
+    else
+    {
+      chromatograms_[nr_chromatograms_] = c;
+    }
+    ++nr_chromatograms_;
+
+    if (nr_chromatograms_ == batch_size_)
+    {
+      processChromatograms_();
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    processSpectra_();
+    processChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::processSpectra_()
+  {
+    if (nr_spectra_ == 0) return;
+
+    // reset before processing, so a throwing function does not leave us in an inconsistent state
+    Size size = nr_spectra_;
+    nr_spectra_ = 0;
+    processBatch_(spectra_, size, spectrum_scratch_, spectrum_func_);
+
+    // forward in original order
+    for (Size i = 0; i < size; ++i)
+    {
+      next_consumer_->consumeSpectrum(spectra_[i]);
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::processChromatograms_()
+  {
+    if (nr_chromatograms_ == 0) return;
+
+    Size size = nr_chromatograms_;
+    nr_chromatograms_ = 0;
+    processBatch_(chromatograms_, size, chromatogram_scratch_, chromatogram_func_);
+
+    for (Size i = 0; i < size; ++i)
+    {
+      next_consumer_->consumeChromatogram(chromatograms_[i]);
+    }
+  }
+
+  template <typename DataType, typename FunctionType>
+  void MSDataParallelTransformingConsumer::processBatch_(std::vector<DataType>& batch, Size size, std::vector<DataType>& scratch, const FunctionType& func)
+  {
+    if (!func) return;
+
+    // exceptions must not leave the parallel region; re-throw the first one afterwards
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)size; ++i)
+    {
+#ifdef _OPENMP
+      DataType& thread_scratch = scratch[omp_get_thread_num()];
+#else
+      DataType& thread_scratch = scratch[0];
+#endif
+      try
+      {
+        func(batch[i], thread_scratch);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (MSDataParallelTransformingConsumer_error)
+#endif
+        if (!error) error = std::current_exception();
+      }
+    }
+
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+} // namespace OpenMS
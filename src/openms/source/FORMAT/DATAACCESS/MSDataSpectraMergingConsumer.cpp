@@ -0,0 +1,298 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataSpectraMergingConsumer.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace OpenMS
+{
+
+  MSDataSpectraMergingConsumer::MSDataSpectraMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const String& merging_method) :
+    SpectraMerger(),
+    next_consumer_(next_consumer),
+    precursor_method_(merging_method == "precursor_method"),
+    last_clustering_rt_(-std::numeric_limits<double>::max()),
+    last_rt_(-std::numeric_limits<double>::max()),
+    nr_consumed_(0),
+    count_peaks_aligned_(0),
+    count_peaks_overall_(0)
+  {
+    if (merging_method != "precursor_method" && merging_method != "block_method")
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Merging method '" + merging_method + "' cannot be used on a stream of spectra. Use 'block_method' or 'precursor_method'.");
+    }
+    updateMembers_();
+  }
+
+  MSDataSpectraMergingConsumer::~MSDataSpectraMergingConsumer()
+  {
+    // flush remaining data (errors of the next consumer must not escape the destructor)
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "MSDataSpectraMergingConsumer: could not write the remaining spectra: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+      OPENMS_LOG_ERROR << "MSDataSpectraMergingConsumer: could not write the remaining spectra." << std::endl;
+    }
+  }
+
+  void MSDataSpectraMergingConsumer::updateMembers_()
+  {
+    // parameters must not change while spectra are pending
+    flush();
+
+    ms_levels_ = param_.getValue("block_method:ms_levels");
+    rt_block_size_ = param_.getValue("block_method:rt_block_size");
+    rt_max_length_ = param_.getValue("block_method:rt_max_length");
+    if (rt_max_length_ == 0) // no rt restriction set?
+    {
+      rt_max_length_ = (std::numeric_limits<double>::max)(); // set max rt span to very large value
+    }
+    rt_tolerance_ = param_.getValue("precursor_method:rt_tolerance");
+
+    blocks_.assign(ms_levels_.size(), std::vector<SpectrumType>());
+    block_size_count_.assign(ms_levels_.size(), rt_block_size_ + 1);
+
+    setUpAlignment_(sas_);
+  }
+
+  void MSDataSpectraMergingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataSpectraMergingConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void MSDataSpectraMergingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    const double rt = s.getRT();
+    if (rt < last_rt_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Spectra must be sorted by RT for merging them on the fly (spectrum #" + String(nr_consumed_) + ").");
+    }
+    last_rt_ = rt;
+
+    // the earliest RT of any spectrum that might still be produced
+    double rt_limit = rt;
+
+    if (precursor_method_)
+    {
+      if (s.getMSLevel() == 2)
+      {
+        window_positions_.push_back(getPrecursorPosition_(s, nr_consumed_));
+        window_.push_back(s);
+        // a cluster is finished once its last spectrum is further away than the RT tolerance;
+        // clustering the window again only makes sense after the RT advanced by this distance
+        if (rt - last_clustering_rt_ > rt_tolerance_)
+        {
+          closeClusters_(rt - rt_tolerance_);
+          last_clustering_rt_ = rt;
+        }
+      }
+      else
+      {
+        pending_.insert(std::make_pair(rt, s));
+      }
+      if (!window_.empty())
+      {
+        rt_limit = std::min(rt_limit, window_.front().getRT());
+      }
+    }
+    else
+    {
+      Size level_index = std::find(ms_levels_.begin(), ms_levels_.end(), Int(s.getMSLevel())) - ms_levels_.begin();
+      if (level_index == ms_levels_.size())
+      {
+        pending_.insert(std::make_pair(rt, s));
+      }
+      else
+      {
+        // block full if it contains a maximum number of scans or if maximum rt length spanned
+        std::vector<SpectrumType>& block = blocks_[level_index];
+        if (++block_size_count_[level_index] >= rt_block_size_ ||
+            block.empty() ||
+            rt - block.front().getRT() > rt_max_length_)
+        {
+          closeBlock_(level_index);
+          block_size_count_[level_index] = 0;
+        }
+        block.push_back(s);
+      }
+      for (Size i = 0; i < blocks_.size(); ++i)
+      {
+        if (!blocks_[i].empty())
+        {
+          rt_limit = std::min(rt_limit, blocks_[i].front().getRT());
+        }
+      }
+    }
+
+    ++nr_consumed_;
+    writeSpectra_(rt_limit);
+  }
+
+  void MSDataSpectraMergingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    flush();
+    next_consumer_->consumeChromatogram(c);
+  }
+
+  void MSDataSpectraMergingConsumer::flush()
+  {
+    for (Size i = 0; i < blocks_.size(); ++i)
+    {
+      closeBlock_(i);
+      block_size_count_[i] = rt_block_size_ + 1;
+    }
+    closeClusters_(std::numeric_limits<double>::infinity());
+    writeSpectra_(std::numeric_limits<double>::infinity());
+
+    if (cluster_sizes_.empty())
+    {
+      return;
+    }
+    OPENMS_LOG_INFO << "Cluster sizes:\n";
+    for (Map<Size, Size>::const_iterator it = cluster_sizes_.begin(); it != cluster_sizes_.end(); ++it)
+    {
+      OPENMS_LOG_INFO << "  size " << it->first << ": " << it->second << "x\n";
+    }
+    OPENMS_LOG_INFO << "Number of merged peaks: " << count_peaks_aligned_ << "/" << count_peaks_overall_ << " of blocked spectra" << std::endl;
+    cluster_sizes_.clear();
+    count_peaks_aligned_ = 0;
+    count_peaks_overall_ = 0;
+  }
+
+  void MSDataSpectraMergingConsumer::closeBlock_(Size level_index)
+  {
+    std::vector<SpectrumType>& block = blocks_[level_index];
+    if (block.empty())
+    {
+      return;
+    }
+    std::vector<Size> members(block.size());
+    for (Size i = 0; i < members.size(); ++i)
+    {
+      members[i] = i;
+    }
+    finishCluster_(block, members, ms_levels_[level_index]);
+    block.clear();
+  }
+
+  void MSDataSpectraMergingConsumer::closeClusters_(double rt_limit)
+  {
+    if (window_.empty())
+    {
+      return;
+    }
+
+    std::vector<std::vector<Size> > clusters;
+    clusterPrecursors_(window_positions_, clusters);
+
+    std::vector<bool> finished(window_.size(), false);
+    for (Size c = 0; c < clusters.size(); ++c)
+    {
+      // the window is sorted by RT, so the last member has the largest RT
+      if (window_positions_[clusters[c].back()].getRT() >= rt_limit)
+      {
+        continue;
+      }
+      finishCluster_(window_, clusters[c], 2);
+      for (Size i = 0; i < clusters[c].size(); ++i)
+      {
+        finished[clusters[c][i]] = true;
+      }
+    }
+
+    // keep the unfinished spectra (in their order)
+    Size kept = 0;
+    for (Size i = 0; i < window_.size(); ++i)
+    {
+      if (finished[i])
+      {
+        continue;
+      }
+      if (kept != i)
+      {
+        std::swap(window_[kept], window_[i]);
+        window_positions_[kept] = window_positions_[i];
+      }
+      ++kept;
+    }
+    window_.resize(kept);
+    window_positions_.resize(kept);
+  }
+
+  void MSDataSpectraMergingConsumer::finishCluster_(std::vector<SpectrumType>& spectra, const std::vector<Size>& members, UInt ms_level)
+  {
+    if (members.size() == 1)
+    {
+      // nothing to merge, pass on unchanged
+      SpectrumType& spec = spectra[members[0]];
+      std::swap(pending_.insert(std::make_pair(spec.getRT(), SpectrumType()))->second, spec);
+      return;
+    }
+
+    ++cluster_sizes_[members.size()]; // for stats
+
+    std::vector<Size> block(members.begin() + 1, members.end());
+    SpectrumType consensus_spec;
+    mergeBlock_(spectra, members[0], block, ms_level, sas_, consensus_spec, count_peaks_aligned_, count_peaks_overall_);
+    if (!consensus_spec.empty())
+    {
+      std::swap(pending_.insert(std::make_pair(consensus_spec.getRT(), SpectrumType()))->second, consensus_spec);
+    }
+  }
+
+  void MSDataSpectraMergingConsumer::writeSpectra_(double rt_limit)
+  {
+    while (!pending_.empty() && pending_.begin()->first < rt_limit)
+    {
+      next_consumer_->consumeSpectrum(pending_.begin()->second);
+      pending_.erase(pending_.begin());
+    }
+  }
+
+} // namespace OpenMS
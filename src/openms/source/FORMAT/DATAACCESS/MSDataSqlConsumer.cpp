@@ -35,6 +35,7 @@
 #include <OpenMS/FORMAT/DATAACCESS/MSDataSqlConsumer.h>
 
 #include <OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>
+#include <OpenMS/CONCEPT/LogStream.h>
 
 namespace OpenMS
 {
@@ -50,17 +51,33 @@ namespace OpenMS
 
     handler_->setConfig(full_meta, lossy_compression, linear_mass_acc, flush_after_);
     handler_->createTables();
+
+    // compress and insert the data in the background while new data is consumed
+    handler_->startPipelinedWriting();
   }
 
   MSDataSqlConsumer::~MSDataSqlConsumer()
   {
-    flush();
-
-    // Write run level information into the file (e.g. run id, run name and mzML structure)
-    bool write_full_meta = full_meta_;
-    int run_id = 0;
-    peak_meta_.setLoadedFilePath(filename_);
-    handler_->writeRunLevelInformation(peak_meta_, write_full_meta, run_id);
+    // errors while writing must not escape the destructor
+    try
+    {
+      flush();
+      handler_->finishPipelinedWriting();
+
+      // Write run level information into the file (e.g. run id, run name and mzML structure)
+      bool write_full_meta = full_meta_;
+      int run_id = 0;
+      peak_meta_.setLoadedFilePath(filename_);
+      handler_->writeRunLevelInformation(peak_meta_, write_full_meta, run_id);
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "MSDataSqlConsumer: writing to '" << filename_ << "' failed: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+      OPENMS_LOG_ERROR << "MSDataSqlConsumer: writing to '" << filename_ << "' failed." << std::endl;
+    }
 
     delete handler_;
   }
@@ -9,6 +9,9 @@ set(sources_list
   MSDataAggregatingConsumer.cpp
   MSDataCachedConsumer.cpp
   MSDataChainingConsumer.cpp
+  MSDataChannelExtractingConsumer.cpp
+  MSDataParallelTransformingConsumer.cpp
+  MSDataSpectraMergingConsumer.cpp
   MSDataStoringConsumer.cpp
   MSDataSqlConsumer.cpp
   MSDataTransformingConsumer.cpp
@@ -34,6 +34,7 @@
 
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/SYSTEM/File.h>
 
@@ -44,11 +45,102 @@
 #include <seqan/seq_io/guess_stream_format.h>
 #include <seqan/seq_io/read_fasta_fastq.h>
 
+#include <exception>
+#include <vector>
+
 namespace OpenMS
 {
   using namespace std;
   typedef seqan::RecordReader<std::fstream, seqan::SinglePass<> > FASTARecordReader;
 
+  /**
+    @brief Stream buffer which serves the decompressed content of a gzip/bzip2 file
+
+    Installed as the buffer of FASTAFile::infile_, so the record reader and the
+    PEFF header handling work unchanged on compressed files. Positions refer to
+    the decompressed data; seeking backwards beyond the current buffer restarts
+    decompression from the beginning of the file.
+  */
+  class FASTAFile::DecompressionBuffer_ :
+    public std::streambuf
+  {
+public:
+    explicit DecompressionBuffer_(const String& filename) :
+      filename_(filename),
+      buffer_(1024 * 1024),
+      offset_(0)
+    {
+      stream_.open(filename_.c_str());
+    }
+
+    /// Rethrows a decompression error (std::istream turns exceptions of its buffer into EOF)
+    void checkError() const
+    {
+      if (error_) std::rethrow_exception(error_);
+    }
+
+protected:
+    int_type underflow() override
+    {
+      if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+      offset_ += egptr() - eback();
+      size_t n = 0;
+      try
+      {
+        if (!stream_.streamEnd()) n = stream_.read(&buffer_[0], buffer_.size());
+      }
+      catch (...)
+      {
+        error_ = std::current_exception();
+      }
+      setg(&buffer_[0], &buffer_[0], &buffer_[0] + n);
+      if (n == 0) return traits_type::eof();
+      return traits_type::to_int_type(*gptr());
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+      off_type current = offset_ + (gptr() - eback());
+      if (dir == std::ios_base::cur)
+      {
+        if (off == 0) return pos_type(current); // tellg()
+        return seekpos(pos_type(current + off), which);
+      }
+      if (dir == std::ios_base::beg) return seekpos(pos_type(off), which);
+      return pos_type(off_type(-1)); // the decompressed size is unknown
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode /* which */) override
+    {
+      off_type target = off_type(pos);
+      if (target < 0) return pos_type(off_type(-1));
+      if (target < offset_)
+      {
+        // restart from the beginning of the file
+        stream_.open(filename_.c_str());
+        error_ = nullptr;
+        offset_ = 0;
+        setg(&buffer_[0], &buffer_[0], &buffer_[0]);
+      }
+      // skip forward to the block which contains the target
+      while (target > offset_ + (egptr() - eback()))
+      {
+        setg(eback(), egptr(), egptr());
+        if (traits_type::eq_int_type(underflow(), traits_type::eof())) return pos_type(off_type(-1));
+      }
+      setg(eback(), eback() + (target - offset_), egptr());
+      return pos;
+    }
+
+private:
+    String filename_;
+    ReadAheadDecompressor stream_;
+    std::vector<char> buffer_;
+    off_type offset_; ///< position of eback() in the decompressed data
+    std::exception_ptr error_;
+  };
+
   FASTAFile::FASTAFile()
   : reader_(std::nullptr_t()), // point to nothing
     entries_read_(0)
@@ -74,7 +166,18 @@ namespace OpenMS
 
     if (infile_.is_open()) infile_.close(); // precaution
 
-    infile_.open(filename.c_str(), std::ios::binary | std::ios::in);
+    if (ReadAheadDecompressor::isCompressed(filename.c_str()))
+    {
+      // replace the file buffer of the stream by a decompressing one
+      decompression_buffer_.reset(new DecompressionBuffer_(filename));
+      static_cast<std::ios&>(infile_).rdbuf(decompression_buffer_.get());
+    }
+    else
+    {
+      static_cast<std::ios&>(infile_).rdbuf(infile_.rdbuf()); // the stream's own file buffer
+      decompression_buffer_.reset();
+      infile_.open(filename.c_str(), std::ios::binary | std::ios::in);
+    }
 
     // Skip the header of PEFF files (http://www.psidev.info/peff)
     std::string line;
@@ -103,12 +206,14 @@ namespace OpenMS
   {
     if (seqan::atEnd(*static_cast<FASTARecordReader*>(reader_.get())))
     { 
+      if (decompression_buffer_) decompression_buffer_->checkError();
       // do NOT close(), since we still might want to seek to certain positions
       return false;
     }
     String id, s;
     if (readRecord(id, s, *static_cast<FASTARecordReader*>(reader_.get()), seqan::Fasta()) != 0)
     {
+      if (decompression_buffer_) decompression_buffer_->checkError();
       if (entries_read_ == 0) s = "The first entry could not be read!";
       else s = "Only " + String(entries_read_) + " proteins could be read. The record after failed.";
       throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Error while parsing FASTA file! " + s + " Please check the file!");
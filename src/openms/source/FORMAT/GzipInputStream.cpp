@@ -35,19 +35,18 @@
 #include <OpenMS/FORMAT/GzipInputStream.h>
 
 #include <OpenMS/DATASTRUCTURES/String.h>
-#include <OpenMS/FORMAT/GzipIfstream.h>
 
 using namespace xercesc;
 
 namespace OpenMS
 {
   GzipInputStream::GzipInputStream(const String & file_name) :
-    gzip_(new GzipIfstream(file_name.c_str())), file_current_index_(0)
+    gzip_(new ReadAheadDecompressor(file_name.c_str())), file_current_index_(0)
   {
   }
 
   GzipInputStream::GzipInputStream(const char * file_name) :
-    gzip_(new GzipIfstream(file_name)), file_current_index_(0)
+    gzip_(new ReadAheadDecompressor(file_name)), file_current_index_(0)
   {
   }
 
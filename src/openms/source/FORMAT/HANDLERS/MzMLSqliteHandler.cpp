@@ -43,6 +43,7 @@
 #include <OpenMS/FORMAT/ZlibCompression.h>
 #include <OpenMS/FORMAT/Base64.h>
 #include <OpenMS/FORMAT/MSNumpressCoder.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
 #include <QtCore/QFileInfo>
@@ -55,6 +56,11 @@
 #endif
 
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace OpenMS
 {
@@ -141,45 +147,8 @@ namespace OpenMS
         size_t blob_bytes = sqlite3_column_bytes(stmt, 4);
 
         // data_type is one of 0 = mz, 1 = int, 2 = rt
-        // compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
         std::vector<double> data;
-        if (compression == 1)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
-
-          void* byte_buffer = reinterpret_cast<void *>(&uncompressed[0]);
-          Size buffer_size = uncompressed.size();
-          const double * float_buffer = reinterpret_cast<const double *>(byte_buffer);
-          if (buffer_size % sizeof(double) != 0)
-          {
-            throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-          }
-          Size float_count = buffer_size / sizeof(double);
-          // copy values
-          data.assign(float_buffer, float_buffer + float_count);
-        }
-        else if (compression == 5)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("linear");
-          MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
-        }
-        else if (compression == 6)
-        {
-          std::string uncompressed;
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, uncompressed);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("slof");
-          MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
-        }
-        else
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Compression not supported");
-        }
+        MzMLSqliteHandler::decodeBinaryData(raw_text, blob_bytes, compression, data);
 
         if (data_type == 1)
         {
@@ -245,6 +214,49 @@ namespace OpenMS
       }
     }
 
+    void MzMLSqliteHandler::decodeBinaryData(const void* blob, Size blob_bytes, int compression, std::vector<double>& data)
+    {
+      // compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+      data.clear();
+      if (compression == 1)
+      {
+        std::string uncompressed;
+        OpenMS::ZlibCompression::uncompressString(blob, blob_bytes, uncompressed);
+
+        void* byte_buffer = reinterpret_cast<void *>(&uncompressed[0]);
+        Size buffer_size = uncompressed.size();
+        const double * float_buffer = reinterpret_cast<const double *>(byte_buffer);
+        if (buffer_size % sizeof(double) != 0)
+        {
+          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+        }
+        Size float_count = buffer_size / sizeof(double);
+        // copy values
+        data.assign(float_buffer, float_buffer + float_count);
+      }
+      else if (compression == 5)
+      {
+        std::string uncompressed;
+        OpenMS::ZlibCompression::uncompressString(blob, blob_bytes, uncompressed);
+        MSNumpressCoder::NumpressConfig config;
+        config.setCompression("linear");
+        MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
+      }
+      else if (compression == 6)
+      {
+        std::string uncompressed;
+        OpenMS::ZlibCompression::uncompressString(blob, blob_bytes, uncompressed);
+        MSNumpressCoder::NumpressConfig config;
+        config.setCompression("slof");
+        MSNumpressCoder().decodeNPRaw(uncompressed, data, config);
+      }
+      else
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+            "Compression not supported");
+      }
+    }
+
     // the cost for initialization and copy should be minimal
     //  - a single C string is created
     //  - two ints
@@ -255,7 +267,8 @@ namespace OpenMS
       run_id_(0),
       use_lossy_compression_(true),
       linear_abs_mass_acc_(0.0001), // set the desired mass accuracy = 1ppm at 100 m/z
-      write_full_meta_(true)
+      write_full_meta_(true),
+      sql_batch_size_(500)
     {
     }
 
@@ -896,11 +909,516 @@ namespace OpenMS
       conn.executeStatement(create_sql);
     }
 
+    /// Compress a data array as stored in the DATA table (zlib or numpress + zlib)
+    static void encodeDataArray_(const std::vector<double>& data, bool lossy,
+                                 const MSNumpressCoder::NumpressConfig& config, String& encoded)
+    {
+      if (lossy)
+      {
+        String uncompressed_str;
+        MSNumpressCoder().encodeNPRaw(data, uncompressed_str, config);
+        OpenMS::ZlibCompression::compressString(uncompressed_str, encoded);
+      }
+      else
+      {
+        std::string str_data = std::string((const char*) data.data(), data.size() * sizeof(double));
+        OpenMS::ZlibCompression::compressString(str_data, encoded);
+      }
+    }
+
+    /// Numpress configuration for m/z (and retention time) arrays
+    static MSNumpressCoder::NumpressConfig linearNumpressConfig_(double linear_abs_acc)
+    {
+      MSNumpressCoder::NumpressConfig config;
+      config.estimate_fixed_point = true; // critical
+      config.numpressErrorTolerance = -1.0; // skip check, faster
+      config.setCompression("linear");
+      config.linear_fp_mass_acc = linear_abs_acc;
+      return config;
+    }
+
+    /// Numpress configuration for intensity arrays
+    static MSNumpressCoder::NumpressConfig slofNumpressConfig_()
+    {
+      MSNumpressCoder::NumpressConfig config;
+      config.estimate_fixed_point = true; // critical
+      config.numpressErrorTolerance = -1.0; // skip check, faster
+      config.setCompression("slof");
+      return config;
+    }
+
+    /// Append the SQL statements for the meta data of a spectrum
+    static void appendSpectrumSQL_(const MSSpectrum& spec, int spec_id, int run_id,
+                                   std::stringstream& insert_spectra_sql,
+                                   std::stringstream& insert_precursor_sql,
+                                   std::stringstream& insert_product_sql,
+                                   int& nr_precursors, int& nr_products)
+    {
+      int polarity = (spec.getInstrumentSettings().getPolarity() == IonSource::POSITIVE); // 1 = positive
+      insert_spectra_sql << "INSERT INTO SPECTRUM(ID, RUN_ID, NATIVE_ID, MSLEVEL, RETENTION_TIME, SCAN_POLARITY) VALUES (" <<
+        spec_id << "," <<
+        run_id << ",'" <<
+        spec.getNativeID() << "'," <<
+        spec.getMSLevel() << "," <<
+        spec.getRT() << "," <<
+        polarity << "); ";
+
+      if (!spec.getPrecursors().empty())
+      {
+        if (spec.getPrecursors().size() > 1)
+        {
+          std::cout << "WARNING cannot store more than first precursor" << std::endl;
+        }
+        if (spec.getPrecursors()[0].getActivationMethods().size() > 1)
+        {
+          std::cout << "WARNING cannot store more than one activation method" << std::endl;
+        }
+
+        const OpenMS::Precursor& prec = spec.getPrecursors()[0];
+        // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
+        int activation_method = -1;
+        if (!prec.getActivationMethods().empty() )
+        {
+          activation_method = *prec.getActivationMethods().begin();
+        }
+        String pepseq;
+        if (prec.metaValueExists("peptide_sequence"))
+        {
+          pepseq = prec.getMetaValue("peptide_sequence");
+          insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " <<
+              "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " <<
+              "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
+            spec_id << "," << prec.getCharge() << "," << prec.getMZ() <<
+            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
+            "," << prec.getDriftTime() << 
+            "," << prec.getActivationEnergy() << 
+            "," << activation_method << ",'" << pepseq << "'" << "); ";
+        }
+        else
+        {
+          insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
+            "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" <<
+            spec_id << "," << prec.getCharge() << "," << prec.getMZ() << 
+            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() << 
+            "," << prec.getDriftTime() <<
+            "," << prec.getActivationEnergy() <<
+            "," << activation_method << "); ";
+        }
+        nr_precursors++;
+      }
+
+      if (!spec.getProducts().empty())
+      {
+        if (spec.getProducts().size() > 1)
+        {
+          std::cout << "WARNING cannot store more than first product" << std::endl;
+        }
+        const OpenMS::Product& prod = spec.getProducts()[0];
+        insert_product_sql << "INSERT INTO PRODUCT (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
+          "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
+          spec_id << "," << 0 << "," << prod.getMZ() << 
+          "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
+        nr_products++;
+      }
+    }
+
+    /// Append the SQL statements for the meta data of a chromatogram
+    static void appendChromatogramSQL_(const MSChromatogram& chrom, int chrom_id, int run_id,
+                                       std::stringstream& insert_chrom_sql,
+                                       std::stringstream& insert_precursor_sql,
+                                       std::stringstream& insert_product_sql)
+    {
+      insert_chrom_sql << "INSERT INTO CHROMATOGRAM (ID, RUN_ID, NATIVE_ID) VALUES (" << chrom_id << "," << run_id << ",'" << chrom.getNativeID() << "'); ";
+
+      const OpenMS::Precursor& prec = chrom.getPrecursor();
+      // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
+      int activation_method = -1;
+      if (!prec.getActivationMethods().empty() )
+      {
+        activation_method = *prec.getActivationMethods().begin();
+      }
+      String pepseq;
+      if (prec.metaValueExists("peptide_sequence"))
+      {
+        pepseq = prec.getMetaValue("peptide_sequence");
+        insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " <<
+          "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " << 
+          "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
+          chrom_id << "," << prec.getCharge() << "," << prec.getMZ() << 
+          "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
+          "," << prec.getDriftTime() << 
+          "," << prec.getActivationEnergy() << 
+          "," << activation_method << ",'" << pepseq << "'" << "); ";
+      }
+      else
+      {
+        insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
+          "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" << 
+          chrom_id << "," << prec.getCharge() << "," << prec.getMZ() << 
+          "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
+          "," << prec.getDriftTime() << 
+          "," << prec.getActivationEnergy() << 
+          "," << activation_method << "); ";
+      }
+
+      const OpenMS::Product& prod = chrom.getProduct();
+      insert_product_sql << "INSERT INTO PRODUCT (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
+        "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
+        chrom_id << "," << 0 << "," << prod.getMZ() << 
+        "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
+    }
+
+    /// Write pipeline: compression on worker threads, inserts on a single writer thread
+    struct MzMLSqliteHandler::PipelinedWriter_
+    {
+      /// A chunk of spectra or chromatograms on its way through the pipeline
+      struct Job
+      {
+        Job() :
+          seq(0),
+          chromatograms(false),
+          lossy(false),
+          bytes(0)
+        {}
+
+        Size seq;
+        bool chromatograms;
+        String meta_sql; ///< Inserts into SPECTRUM/CHROMATOGRAM, PRECURSOR and PRODUCT
+
+        //  data_type is one of 0 = mz, 1 = int, 2 = rt
+        std::vector<int> ids;
+        std::vector<int> data_types;
+        std::vector<std::vector<double> > raw; ///< Released after encoding
+        std::vector<String> encoded;
+
+        bool lossy;
+        MSNumpressCoder::NumpressConfig config_linear; ///< for mz and rt arrays
+        MSNumpressCoder::NumpressConfig config_slof; ///< for intensity arrays
+        Size bytes; ///< Memory held by this job (raw data, then encoded data)
+      };
+
+      /// Number of DATA rows after which the current transaction is committed
+      static const Size commit_rows = 20000;
+
+      PipelinedWriter_(const String& file, Size nr_workers, Size max_bytes) :
+        filename(file),
+        max_inflight_bytes(max_bytes),
+        inflight_bytes(0),
+        next_seq(0),
+        next_write(0),
+        stopping(false),
+        failed(false),
+        nr_items(0),
+        nr_rows(0),
+        bytes_written(0),
+        busy_time(0.0)
+      {
+        wall_clock.start();
+        writer = std::thread(&PipelinedWriter_::write, this);
+        for (Size k = 0; k < std::max(nr_workers, Size(1)); k++)
+        {
+          workers.push_back(std::thread(&PipelinedWriter_::encode, this));
+        }
+      }
+
+      ~PipelinedWriter_()
+      {
+        stop();
+      }
+
+      /// Queue a job for compression, blocks while too much data is in flight (rethrows the error of a failed pipeline)
+      void submit(boost::shared_ptr<Job> job)
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        // a single job larger than the limit is still accepted once the pipeline is empty
+        space_available.wait(lock, [this, &job]()
+          { return failed || inflight_bytes == 0 || inflight_bytes + job->bytes <= max_inflight_bytes; });
+        if (failed)
+        {
+          // no data may be dropped silently: report the error to the caller of writeSpectra/writeChromatograms
+          std::exception_ptr e = error;
+          lock.unlock();
+          std::rethrow_exception(e);
+        }
+
+        job->seq = next_seq++;
+        inflight_bytes += job->bytes;
+        encode_queue.push_back(job);
+        lock.unlock();
+        work_available.notify_one();
+      }
+
+      void stop()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stopping = true;
+        }
+        work_available.notify_all();
+        job_encoded.notify_all();
+        for (Size k = 0; k < workers.size(); k++)
+        {
+          if (workers[k].joinable()) workers[k].join();
+        }
+        if (writer.joinable())
+        {
+          writer.join();
+          wall_clock.stop();
+        }
+      }
+
+      void fail_()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!failed) error = std::current_exception();
+          failed = true;
+          encode_queue.clear();
+          encoded.clear();
+        }
+        work_available.notify_all();
+        job_encoded.notify_all();
+        space_available.notify_all();
+      }
+
+      void encode()
+      {
+        while (true)
+        {
+          boost::shared_ptr<Job> job;
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_available.wait(lock, [this]() { return !encode_queue.empty() || stopping || failed; });
+            if (encode_queue.empty() || failed) return;
+            job = encode_queue.front();
+            encode_queue.pop_front();
+          }
+
+          Size encoded_bytes = 0;
+          try
+          {
+            job->encoded.resize(job->raw.size());
+            for (Size k = 0; k < job->raw.size(); k++)
+            {
+              const MSNumpressCoder::NumpressConfig& config = job->data_types[k] == 1 ? job->config_slof : job->config_linear;
+              encodeDataArray_(job->raw[k], job->lossy, config, job->encoded[k]);
+              encoded_bytes += job->encoded[k].size();
+            }
+            std::vector<std::vector<double> >().swap(job->raw);
+          }
+          catch (...)
+          {
+            fail_();
+            return;
+          }
+
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            inflight_bytes = inflight_bytes - job->bytes + encoded_bytes;
+            job->bytes = encoded_bytes;
+            encoded[job->seq] = job;
+          }
+          job_encoded.notify_one();
+          space_available.notify_all();
+        }
+      }
+
+      void write()
+      {
+        sqlite3_stmt* spectrum_stmt = nullptr;
+        sqlite3_stmt* chrom_stmt = nullptr;
+        try
+        {
+          SqliteConnector conn(filename);
+          sqlite3* db = conn.getDB();
+          SqliteConnector::executePreparedStatement(db, &spectrum_stmt,
+            "INSERT INTO DATA (SPECTRUM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES (?1, ?2, ?3, ?4);");
+          SqliteConnector::executePreparedStatement(db, &chrom_stmt,
+            "INSERT INTO DATA (CHROMATOGRAM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES (?1, ?2, ?3, ?4);");
+
+          conn.executeStatement("BEGIN TRANSACTION");
+          Size rows_in_transaction = 0;
+          while (true)
+          {
+            boost::shared_ptr<Job> job;
+            {
+              std::unique_lock<std::mutex> lock(mutex);
+              // jobs are written in the order in which they were submitted
+              job_encoded.wait(lock, [this]()
+                { return failed || encoded.count(next_write) > 0 || (stopping && next_write == next_seq); });
+              if (failed) break;
+              if (encoded.count(next_write) == 0) break; // stopped and everything written
+              job = encoded[next_write];
+              encoded.erase(next_write);
+            }
+
+            StopWatch sw;
+            sw.start();
+            conn.executeStatement(job->meta_sql);
+            sqlite3_stmt* stmt = job->chromatograms ? chrom_stmt : spectrum_stmt;
+            for (Size k = 0; k < job->encoded.size(); k++)
+            {
+              //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+              int compression = 1;
+              if (job->lossy) compression = job->data_types[k] == 1 ? 6 : 5;
+              sqlite3_bind_int(stmt, 1, job->ids[k]);
+              sqlite3_bind_int(stmt, 2, job->data_types[k]);
+              sqlite3_bind_int(stmt, 3, compression);
+              sqlite3_bind_blob(stmt, 4, job->encoded[k].c_str(), job->encoded[k].size(), SQLITE_STATIC);
+              if (sqlite3_step(stmt) != SQLITE_DONE)
+              {
+                throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sqlite3_errmsg(db));
+              }
+              sqlite3_reset(stmt);
+              bytes_written += job->encoded[k].size();
+            }
+            nr_items += job->ids.size() / 2;
+            rows_in_transaction += job->encoded.size();
+            if (rows_in_transaction >= commit_rows)
+            {
+              conn.executeStatement("END TRANSACTION");
+              conn.executeStatement("BEGIN TRANSACTION");
+              nr_rows += rows_in_transaction;
+              rows_in_transaction = 0;
+            }
+            sw.stop();
+            busy_time += sw.getClockTime();
+
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              inflight_bytes -= job->bytes;
+              next_write++;
+            }
+            space_available.notify_all();
+          }
+          conn.executeStatement("END TRANSACTION");
+          nr_rows += rows_in_transaction;
+
+          sqlite3_finalize(spectrum_stmt);
+          sqlite3_finalize(chrom_stmt);
+        }
+        catch (...)
+        {
+          sqlite3_finalize(spectrum_stmt);
+          sqlite3_finalize(chrom_stmt);
+          fail_();
+        }
+      }
+
+      String filename;
+      Size max_inflight_bytes;
+
+      std::mutex mutex;
+      std::condition_variable work_available;
+      std::condition_variable job_encoded;
+      std::condition_variable space_available;
+      std::deque<boost::shared_ptr<Job> > encode_queue;
+      std::map<Size, boost::shared_ptr<Job> > encoded;
+      Size inflight_bytes;
+      Size next_seq;
+      Size next_write;
+      bool stopping;
+      bool failed;
+      std::exception_ptr error;
+
+      // statistics (only accessed by the writer thread until it is joined)
+      Size nr_items;
+      Size nr_rows;
+      Size bytes_written;
+      double busy_time;
+      StopWatch wall_clock;
+
+      std::vector<std::thread> workers;
+      std::thread writer;
+    };
+
+    void MzMLSqliteHandler::startPipelinedWriting(Size nr_workers, Size max_inflight_bytes)
+    {
+      if (pipeline_)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Pipelined writing has already been started.");
+      }
+      if (nr_workers == 0)
+      {
+#ifdef _OPENMP
+        nr_workers = omp_get_max_threads();
+#else
+        nr_workers = 1;
+#endif
+      }
+      pipeline_.reset(new PipelinedWriter_(filename_, nr_workers, max_inflight_bytes));
+    }
+
+    void MzMLSqliteHandler::finishPipelinedWriting()
+    {
+      if (!pipeline_) return;
+
+      boost::shared_ptr<PipelinedWriter_> pipeline;
+      pipeline.swap(pipeline_);
+      pipeline->stop();
+      if (pipeline->error)
+      {
+        std::rethrow_exception(pipeline->error);
+      }
+
+      OPENMS_LOG_DEBUG << "Wrote " << pipeline->nr_items << " spectra/chromatograms (" << pipeline->nr_rows
+        << " data arrays, " << pipeline->bytes_written / (1024.0 * 1024.0) << " MiB) to " << filename_ << " in "
+        << pipeline->wall_clock.getClockTime() << " s, writer thread busy for " << pipeline->busy_time << " s." << std::endl;
+    }
+
     void MzMLSqliteHandler::writeSpectra(const std::vector<MSSpectrum>& spectra)
     {
       // prevent writing of empty data which would throw an SQL exception
       if (spectra.empty()) return;
 
+      MSNumpressCoder::NumpressConfig npconfig_mz = linearNumpressConfig_(linear_abs_mass_acc_);
+      MSNumpressCoder::NumpressConfig npconfig_int = slofNumpressConfig_();
+
+      if (pipeline_)
+      {
+        // hand chunks of spectra to the compression workers, meta data SQL is created here
+        const Size chunk_size = std::max(sql_batch_size_ / 2, 1);
+        for (Size start = 0; start < spectra.size(); start += chunk_size)
+        {
+          boost::shared_ptr<PipelinedWriter_::Job> job(new PipelinedWriter_::Job);
+          job->lossy = use_lossy_compression_;
+          job->config_linear = npconfig_mz;
+          job->config_slof = npconfig_int;
+
+          std::stringstream insert_spectra_sql, insert_precursor_sql, insert_product_sql;
+          insert_spectra_sql.precision(11);
+          insert_precursor_sql.precision(11);
+          insert_product_sql.precision(11);
+          int nr_precursors = 0;
+          int nr_products = 0;
+          for (Size k = start; k < std::min(start + chunk_size, spectra.size()); k++)
+          {
+            const MSSpectrum& spec = spectra[k];
+            appendSpectrumSQL_(spec, spec_id_, run_id_, insert_spectra_sql, insert_precursor_sql, insert_product_sql, nr_precursors, nr_products);
+
+            job->raw.push_back(std::vector<double>(spec.size()));
+            job->raw.push_back(std::vector<double>(spec.size()));
+            std::vector<double>& mz = job->raw[job->raw.size() - 2];
+            std::vector<double>& intensity = job->raw.back();
+            for (Size p = 0; p < spec.size(); ++p)
+            {
+              mz[p] = spec[p].getMZ();
+              intensity[p] = spec[p].getIntensity();
+            }
+            job->ids.push_back(spec_id_);
+            job->data_types.push_back(0);
+            job->ids.push_back(spec_id_);
+            job->data_types.push_back(1);
+            job->bytes += 2 * spec.size() * sizeof(double);
+            spec_id_++;
+          }
+          job->meta_sql = insert_spectra_sql.str() + insert_precursor_sql.str() + insert_product_sql.str();
+          pipeline_->submit(job);
+        }
+        return;
+      }
+
       SqliteConnector conn(filename_);
 
       // prepare streams and set required precision (default is 6 digits)
@@ -912,17 +1430,6 @@ namespace OpenMS
       insert_precursor_sql.precision(11);
       insert_product_sql.precision(11);
 
-      // Encoding options
-      MSNumpressCoder::NumpressConfig npconfig_mz;
-      npconfig_mz.estimate_fixed_point = true; // critical
-      npconfig_mz.numpressErrorTolerance = -1.0; // skip check, faster
-      npconfig_mz.setCompression("linear");
-      npconfig_mz.linear_fp_mass_acc = linear_abs_mass_acc_;
-      MSNumpressCoder::NumpressConfig npconfig_int;
-      npconfig_int.estimate_fixed_point = true; // critical
-      npconfig_int.numpressErrorTolerance = -1.0; // skip check, faster
-      npconfig_int.setCompression("slof");
-
       String prepare_statement = "INSERT INTO DATA (SPECTRUM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
       std::vector<String> data;
       int sql_it = 1;
@@ -944,21 +1451,7 @@ namespace OpenMS
           {
             data_to_encode[p] = spec[p].getMZ();
           }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_mz);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_mz[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_mz[k] = encoded_string;
-          }
+          encodeDataArray_(data_to_encode, use_lossy_compression_, npconfig_mz, encoded_strings_mz[k]);
         }
 
         // encode intensity data (zlib or np-slof + zlib)
@@ -969,21 +1462,7 @@ namespace OpenMS
           {
             data_to_encode[p] = spec[p].getIntensity();
           }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_int);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
+          encodeDataArray_(data_to_encode, use_lossy_compression_, npconfig_int, encoded_strings_int[k]);
         }
       }
 
@@ -991,73 +1470,7 @@ namespace OpenMS
       int nr_products = 0;
       for (Size k = 0; k < spectra.size(); k++)
       {
-        const MSSpectrum& spec = spectra[k];
-        int polarity = (spec.getInstrumentSettings().getPolarity() == IonSource::POSITIVE); // 1 = positive
-        insert_spectra_sql << "INSERT INTO SPECTRUM(ID, RUN_ID, NATIVE_ID, MSLEVEL, RETENTION_TIME, SCAN_POLARITY) VALUES (" <<
-          spec_id_ << "," <<
-          run_id_ << ",'" <<
-          spec.getNativeID() << "'," <<
-          spec.getMSLevel() << "," <<
-          spec.getRT() << "," <<
-          polarity << "); ";
-
-        if (!spec.getPrecursors().empty())
-        {
-          if (spec.getPrecursors().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than first precursor" << std::endl;
-          }
-          if (spec.getPrecursors()[0].getActivationMethods().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than one activation method" << std::endl;
-          }
-
-          OpenMS::Precursor prec = spec.getPrecursors()[0];
-          // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
-          int activation_method = -1;
-          if (!prec.getActivationMethods().empty() )
-          {
-            activation_method = *prec.getActivationMethods().begin();
-          }
-          String pepseq;
-          if (prec.metaValueExists("peptide_sequence"))
-          {
-            pepseq = prec.getMetaValue("peptide_sequence");
-            insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " <<
-                "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " <<
-                "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
-              spec_id_ << "," << prec.getCharge() << "," << prec.getMZ() <<
-              "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-              "," << prec.getDriftTime() << 
-              "," << prec.getActivationEnergy() << 
-              "," << activation_method << ",'" << pepseq << "'" << "); ";
-          }
-          else
-          {
-            insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
-              "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" <<
-              spec_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-              "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() << 
-              "," << prec.getDriftTime() <<
-              "," << prec.getActivationEnergy() <<
-              "," << activation_method << "); ";
-          }
-          nr_precursors++;
-        }
-
-        if (!spec.getProducts().empty())
-        {
-          if (spec.getProducts().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than first product" << std::endl;
-          }
-          OpenMS::Product prod = spec.getProducts()[0];
-          insert_product_sql << "INSERT INTO PRODUCT (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
-            "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
-            spec_id_ << "," << 0 << "," << prod.getMZ() << 
-            "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
-          nr_products++;
-        }
+        appendSpectrumSQL_(spectra[k], spec_id_, run_id_, insert_spectra_sql, insert_precursor_sql, insert_product_sql, nr_precursors, nr_products);
 
         //  data_type is one of 0 = mz, 1 = int, 2 = rt
         //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
@@ -1124,6 +1537,53 @@ namespace OpenMS
       // prevent writing of empty data which would throw an SQL exception
       if (chroms.empty()) return;
 
+      // Encoding options
+      MSNumpressCoder::NumpressConfig npconfig_mz = linearNumpressConfig_(0.05); // set the desired RT accuracy (0.05 seconds)
+      MSNumpressCoder::NumpressConfig npconfig_int = slofNumpressConfig_();
+
+      if (pipeline_)
+      {
+        // hand chunks of chromatograms to the compression workers, meta data SQL is created here
+        const Size chunk_size = std::max(sql_batch_size_ / 2, 1);
+        for (Size start = 0; start < chroms.size(); start += chunk_size)
+        {
+          boost::shared_ptr<PipelinedWriter_::Job> job(new PipelinedWriter_::Job);
+          job->chromatograms = true;
+          job->lossy = use_lossy_compression_;
+          job->config_linear = npconfig_mz;
+          job->config_slof = npconfig_int;
+
+          std::stringstream insert_chrom_sql, insert_precursor_sql, insert_product_sql;
+          insert_chrom_sql.precision(11);
+          insert_precursor_sql.precision(11);
+          insert_product_sql.precision(11);
+          for (Size k = start; k < std::min(start + chunk_size, chroms.size()); k++)
+          {
+            const MSChromatogram& chrom = chroms[k];
+            appendChromatogramSQL_(chrom, chrom_id_, run_id_, insert_chrom_sql, insert_precursor_sql, insert_product_sql);
+
+            job->raw.push_back(std::vector<double>(chrom.size()));
+            job->raw.push_back(std::vector<double>(chrom.size()));
+            std::vector<double>& rt = job->raw[job->raw.size() - 2];
+            std::vector<double>& intensity = job->raw.back();
+            for (Size p = 0; p < chrom.size(); ++p)
+            {
+              rt[p] = chrom[p].getRT();
+              intensity[p] = chrom[p].getIntensity();
+            }
+            job->ids.push_back(chrom_id_);
+            job->data_types.push_back(2);
+            job->ids.push_back(chrom_id_);
+            job->data_types.push_back(1);
+            job->bytes += 2 * chrom.size() * sizeof(double);
+            chrom_id_++;
+          }
+          job->meta_sql = insert_chrom_sql.str() + insert_precursor_sql.str() + insert_product_sql.str();
+          pipeline_->submit(job);
+        }
+        return;
+      }
+
       SqliteConnector conn(filename_);
 
       // prepare streams and set required precision (default is 6 digits)
@@ -1135,17 +1595,6 @@ namespace OpenMS
       insert_precursor_sql.precision(11);
       insert_product_sql.precision(11);
 
-      // Encoding options
-      MSNumpressCoder::NumpressConfig npconfig_mz;
-      npconfig_mz.estimate_fixed_point = true; // critical
-      npconfig_mz.numpressErrorTolerance = -1.0; // skip check, faster
-      npconfig_mz.setCompression("linear");
-      npconfig_mz.linear_fp_mass_acc = 0.05; // set the desired RT accuracy (0.05 seconds)
-      MSNumpressCoder::NumpressConfig npconfig_int;
-      npconfig_int.estimate_fixed_point = true; // critical
-      npconfig_int.numpressErrorTolerance = -1.0; // skip check, faster
-      npconfig_int.setCompression("slof");
-
       String prepare_statement = "INSERT INTO DATA (CHROMATOGRAM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
       int sql_it = 1;
 
@@ -1166,21 +1615,7 @@ namespace OpenMS
           {
             data_to_encode[p] = chrom[p].getRT();
           }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_mz);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_rt[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_rt[k] = encoded_string;
-          }
+          encodeDataArray_(data_to_encode, use_lossy_compression_, npconfig_mz, encoded_strings_rt[k]);
         }
 
         // encode intensity data (zlib or np-slof + zlib)
@@ -1191,66 +1626,14 @@ namespace OpenMS
           {
             data_to_encode[p] = chrom[p].getIntensity();
           }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_int);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
+          encodeDataArray_(data_to_encode, use_lossy_compression_, npconfig_int, encoded_strings_int[k]);
         }
       }
 
       std::vector<String> data;
       for (Size k = 0; k < chroms.size(); k++)
       {
-        const MSChromatogram& chrom = chroms[k];
-        insert_chrom_sql << "INSERT INTO CHROMATOGRAM (ID, RUN_ID, NATIVE_ID) VALUES (" << chrom_id_ << "," << run_id_ << ",'" << chrom.getNativeID() << "'); ";
-
-        OpenMS::Precursor prec = chrom.getPrecursor();
-        // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
-        int activation_method = -1;
-        if (!prec.getActivationMethods().empty() )
-        {
-          activation_method = *prec.getActivationMethods().begin();
-        }
-        String pepseq;
-        if (prec.metaValueExists("peptide_sequence"))
-        {
-          pepseq = prec.getMetaValue("peptide_sequence");
-          insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " <<
-            "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " << 
-            "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
-            chrom_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-            "," << prec.getDriftTime() << 
-            "," << prec.getActivationEnergy() << 
-            "," << activation_method << ",'" << pepseq << "'" << "); ";
-        }
-        else
-        {
-          insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
-            "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" << 
-            chrom_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-            "," << prec.getDriftTime() << 
-            "," << prec.getActivationEnergy() << 
-            "," << activation_method << "); ";
-        }
-
-        OpenMS::Product prod = chrom.getProduct();
-        insert_product_sql << "INSERT INTO PRODUCT (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
-          "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
-          chrom_id_ << "," << 0 << "," << prod.getMZ() << 
-          "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
+        appendChromatogramSQL_(chroms[k], chrom_id_, run_id_, insert_chrom_sql, insert_precursor_sql, insert_product_sql);
 
         //  data_type is one of 0 = mz, 1 = int, 2 = rt
         //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
@@ -1314,4 +1697,3 @@ namespace OpenMS
 
   } // namespace Internal
 } // namespace OpenMS
-
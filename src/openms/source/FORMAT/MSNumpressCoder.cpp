@@ -58,8 +58,8 @@ namespace OpenMS
     }
 
     // Encode in base64 and compress
-    std::vector<String> tmp;
-    tmp.push_back(result);
+    std::vector<String> tmp(1);
+    tmp[0].swap(result);
     Base64::encodeStrings(tmp, result, zlib_compression, false);
   }
 
@@ -76,15 +76,8 @@ namespace OpenMS
     QByteArray base64_uncompressed;
     Base64::decodeSingleString(in, base64_uncompressed, zlib_compression);
 
-    // Create a temporary string (*not* null-terminated) to hold the data
-    std::string tmpstring(base64_uncompressed.constData(), base64_uncompressed.size());
-    decodeNPRaw(tmpstring, out, config);
-
-    // NOTE: it is possible (and likely faster) to call directly the const
-    // unsigned char * function but this would make it necessary to deal with
-    // reinterpret_cast ugliness here ... 
-    //
-    // decodeNP_internal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
+    // decode directly from the decompressed buffer (*not* null-terminated)
+    decodeNPInternal_(reinterpret_cast<const unsigned char*>(base64_uncompressed.constData()), base64_uncompressed.size(), out, config);
   }
 
   void MSNumpressCoder::encodeNPRaw(const std::vector<double>& in, String& result, const NumpressConfig & config)
@@ -107,12 +100,12 @@ namespace OpenMS
       // 1. Resize the data
       switch (config.np_compression)
       {
-      case LINEAR:
-        numpressed.resize(dataSize * sizeof(std::vector<double>::value_type) + 8);
+      case LINEAR: // 8 bytes fixed point, then at most 4.5 bytes per value
+        numpressed.resize(dataSize * 5 + 8);
         break;
 
-      case PIC:
-        numpressed.resize(dataSize * sizeof(std::vector<double>::value_type));
+      case PIC: // at most 4.5 bytes per value
+        numpressed.resize(dataSize * 5);
         break;
 
       case SLOF:
@@ -264,7 +257,7 @@ namespace OpenMS
       }
       else
       {
-        result = String(std::string(reinterpret_cast<const char*>(&numpressed[0]), byteCount));
+        result.assign(reinterpret_cast<const char*>(&numpressed[0]), byteCount);
         // Other solution:
         // http://stackoverflow.com/questions/2840835/way-to-get-unsigned-char-into-a-stdstring-without-reinterpret-cast
         // result = String( std::string(&numpressed[0], &numpressed[0] + byteCount) );
@@ -289,10 +282,18 @@ namespace OpenMS
     decodeNPInternal_(reinterpret_cast<const unsigned char*>(in.c_str()), in.size(), out, config);
   }
 
+  void MSNumpressCoder::decodeNPRaw(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config)
+  {
+    decodeNPInternal_(in, in_size, out, config);
+  }
+
   void MSNumpressCoder::decodeNPInternal_(const unsigned char* in, size_t in_size, std::vector<double>& out, const NumpressConfig & config)
   {
-    out.clear();
-    if (in_size == 0) return;
+    if (in_size == 0)
+    {
+      out.clear();
+      return;
+    }
 
     size_t byteCount = in_size;
 
@@ -306,43 +307,42 @@ namespace OpenMS
 
     try
     {
-      size_t initialSize;
-
+      // size the output exactly (counting is much cheaper than decoding), so
+      // that no more than the decoded values need to be initialized
       switch (config.np_compression)
       {
       case LINEAR:
       {
-        initialSize = byteCount * 2;
-        if (out.size() < initialSize) { out.resize(initialSize); }
-        size_t count = numpress::MSNumpress::decodeLinear(in, byteCount, &out[0]);
+        out.resize(numpress::MSNumpress::decodeLinearLength(in, byteCount));
+        size_t count = numpress::MSNumpress::decodeLinear(in, byteCount, out.data());
         out.resize(count);
         break;
       }
 
       case PIC:
       {
-        initialSize = byteCount * 2;
-        if (out.size() < initialSize) { out.resize(initialSize); }
-        size_t count = numpress::MSNumpress::decodePic(in, byteCount, &out[0]);
+        out.resize(numpress::MSNumpress::decodePicLength(in, byteCount));
+        size_t count = numpress::MSNumpress::decodePic(in, byteCount, out.data());
         out.resize(count);
         break;
       }
 
       case SLOF:
       {
-        initialSize = byteCount / 2;
-        if (out.size() < initialSize) { out.resize(initialSize); }
-        size_t count = numpress::MSNumpress::decodeSlof(in, byteCount, &out[0]);
+        out.resize(byteCount >= 8 ? (byteCount - 8 + 1) / 2 : 0);
+        size_t count = numpress::MSNumpress::decodeSlof(in, byteCount, out.data());
         out.resize(count);
         break;
       }
 
       case NONE:
       {
+        out.clear();
         return;
       }
 
       default:
+        out.clear();
         break;
       }
 
@@ -0,0 +1,339 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
+#include <OpenMS/CONCEPT/Macros.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#ifdef OPENMS_WINDOWSPLATFORM
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace OpenMS
+{
+
+  /// Read-only mapping of a whole file into memory
+  struct MappedFASTAFile::Mapping_
+  {
+    explicit Mapping_(const String& filename) :
+      data(nullptr),
+      size(0)
+    {
+#ifdef OPENMS_WINDOWSPLATFORM
+      file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      map = NULL;
+      if (file == INVALID_HANDLE_VALUE)
+      {
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      LARGE_INTEGER file_size;
+      if (!GetFileSizeEx(file, &file_size))
+      {
+        release_();
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      size = Size(file_size.QuadPart);
+      if (size == 0) return; // empty files cannot be mapped
+      map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      void* view = (map == NULL) ? NULL : MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+      if (view == NULL)
+      {
+        release_();
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      data = static_cast<const char*>(view);
+#else
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      struct stat file_stat;
+      if (fstat(fd, &file_stat) != 0)
+      {
+        ::close(fd);
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      size = Size(file_stat.st_size);
+      if (size == 0) // empty files cannot be mapped
+      {
+        ::close(fd);
+        return;
+      }
+      void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd); // the mapping keeps its own reference to the file
+      if (view == MAP_FAILED)
+      {
+        size = 0;
+        throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      data = static_cast<const char*>(view);
+#endif
+    }
+
+    ~Mapping_()
+    {
+      release_();
+    }
+
+    void release_()
+    {
+#ifdef OPENMS_WINDOWSPLATFORM
+      if (data != nullptr) UnmapViewOfFile(data);
+      if (map != NULL) CloseHandle(map);
+      if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+      map = NULL;
+      file = INVALID_HANDLE_VALUE;
+#else
+      if (data != nullptr) munmap(const_cast<char*>(data), size);
+#endif
+      data = nullptr;
+    }
+
+    const char* data;
+    Size size;
+#ifdef OPENMS_WINDOWSPLATFORM
+    HANDLE file;
+    HANDLE map;
+#endif
+  };
+
+  static inline bool isWhitespace(const char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  }
+
+  MappedFASTAFile::MappedFASTAFile() :
+    mapping_(),
+    data_(nullptr),
+    data_size_(0),
+    records_()
+  {
+  }
+
+  MappedFASTAFile::MappedFASTAFile(const String& filename) :
+    mapping_(),
+    data_(nullptr),
+    data_size_(0),
+    records_()
+  {
+    open(filename);
+  }
+
+  MappedFASTAFile::~MappedFASTAFile()
+  {
+  }
+
+  void MappedFASTAFile::open(const String& filename)
+  {
+    close();
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    mapping_.reset(new Mapping_(filename));
+    data_ = mapping_->data;
+    data_size_ = mapping_->size;
+    try
+    {
+      index_(filename);
+    }
+    catch (...)
+    {
+      close();
+      throw;
+    }
+  }
+
+  void MappedFASTAFile::close()
+  {
+    records_.clear();
+    data_ = nullptr;
+    data_size_ = 0;
+    mapping_.reset();
+  }
+
+  void MappedFASTAFile::index_(const String& filename)
+  {
+    records_.clear();
+    if (data_size_ == 0) return;
+
+    // skip the header of PEFF files (http://www.psidev.info/peff) and empty lines
+    Size start = 0;
+    while (start < data_size_)
+    {
+      const char* eol = static_cast<const char*>(memchr(data_ + start, '\n', data_size_ - start));
+      const char* line_end = (eol == nullptr) ? data_ + data_size_ : eol;
+      const char* p = data_ + start;
+      while (p != line_end && isWhitespace(*p)) ++p;
+      if (p != line_end && data_[start] != '#') break;
+      start = line_end - data_ + 1;
+    }
+    if (start >= data_size_) return; // no records
+
+    if (data_[start] != '>')
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Error while parsing FASTA file! The first entry could not be read! Please check the file!");
+    }
+
+    // Split the file into equal parts which are scanned for records independently.
+    // Records are the only place where '>' is expected, so memchr() skips
+    // over the sequence lines quickly.
+    const Size length = data_size_ - start;
+    int nr_parts = 1;
+#ifdef _OPENMP
+    nr_parts = omp_get_max_threads();
+#endif
+    nr_parts = (int)std::max(Size(1), std::min(Size(nr_parts), length / (1 << 20))); // at least 1 MB per part
+    std::vector<std::vector<Size> > parts(nr_parts);
+#pragma omp parallel for schedule(static, 1)
+    for (int part = 0; part < nr_parts; ++part)
+    {
+      const char* p = data_ + start + length * part / nr_parts;
+      const char* end = data_ + start + length * (part + 1) / nr_parts;
+      std::vector<Size>& found = parts[part];
+      while (p < end)
+      {
+        const char* gt = static_cast<const char*>(memchr(p, '>', end - p));
+        if (gt == nullptr) break;
+        if (gt == data_ + start || gt[-1] == '\n') found.push_back(gt - data_);
+        p = gt + 1;
+      }
+    }
+
+    Size nr_records = 0;
+    for (const std::vector<Size>& found : parts) nr_records += found.size();
+    records_.reserve(nr_records + 1);
+    for (const std::vector<Size>& found : parts)
+    {
+      records_.insert(records_.end(), found.begin(), found.end());
+    }
+    records_.push_back(data_size_);
+  }
+
+  StringView MappedFASTAFile::getHeader_(Size index) const
+  {
+    OPENMS_PRECONDITION(index < size(), "MappedFASTAFile: index out of range")
+    const char* begin = data_ + records_[index] + 1;
+    const char* end = data_ + records_[index + 1];
+    const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    if (eol != nullptr) end = eol;
+    // trim (like String::trim())
+    while (begin != end && isWhitespace(*begin)) ++begin;
+    while (end != begin && isWhitespace(end[-1])) --end;
+    return StringView(begin, end - begin);
+  }
+
+  StringView MappedFASTAFile::getIdentifier(Size index) const
+  {
+    StringView header = getHeader_(index);
+    const char* begin = header.data();
+    const char* end = begin + header.size();
+    const char* p = begin;
+    while (p != end && *p != ' ' && *p != '\v' && *p != '\t') ++p;
+    return StringView(begin, p - begin);
+  }
+
+  StringView MappedFASTAFile::getDescription(Size index) const
+  {
+    StringView header = getHeader_(index);
+    const char* begin = header.data();
+    const char* end = begin + header.size();
+    const char* p = begin;
+    while (p != end && *p != ' ' && *p != '\v' && *p != '\t') ++p;
+    if (p == end) return StringView();
+    return StringView(p + 1, end - p - 1);
+  }
+
+  StringView MappedFASTAFile::getRawSequence(Size index) const
+  {
+    OPENMS_PRECONDITION(index < size(), "MappedFASTAFile: index out of range")
+    const char* begin = data_ + records_[index] + 1;
+    const char* end = data_ + records_[index + 1];
+    const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    if (eol == nullptr) return StringView(); // header only
+    return StringView(eol + 1, end - eol - 1);
+  }
+
+  void MappedFASTAFile::getSequence(Size index, String& sequence) const
+  {
+    StringView raw = getRawSequence(index);
+    sequence.resize(raw.size());
+    if (raw.size() == 0) return;
+    // copy everything but whitespace (like String::removeWhitespaces())
+    char* dest = &sequence[0];
+    for (const char* p = raw.data(), *end = raw.data() + raw.size(); p != end; ++p)
+    {
+      const char c = *p;
+      if (isWhitespace(c)) continue;
+      *dest++ = c;
+    }
+    sequence.resize(dest - &sequence[0]);
+  }
+
+  void MappedFASTAFile::getEntry(Size index, FASTAFile::FASTAEntry& entry) const
+  {
+    StringView id = getIdentifier(index);
+    entry.identifier.assign(id.data(), id.size());
+    StringView description = getDescription(index);
+    entry.description.assign(description.data(), description.size());
+    getSequence(index, entry.sequence);
+  }
+
+  void MappedFASTAFile::getEntries(Size first, Size count, std::vector<FASTAFile::FASTAEntry>& entries) const
+  {
+    entries.clear();
+    if (first >= size()) return;
+    count = std::min(count, size() - first);
+    entries.resize(count);
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < SignedSize(count); ++i)
+    {
+      getEntry(first + i, entries[i]);
+    }
+  }
+
+} // namespace OpenMS
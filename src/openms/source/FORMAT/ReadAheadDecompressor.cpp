@@ -0,0 +1,762 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <zlib.h>
+#include <bzlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /// Decompression pipeline: a read-ahead thread plus (optionally) workers for independently compressed chunks
+  struct ReadAheadDecompressor::Pipeline_
+  {
+    enum Format {PLAIN, GZIP, BZIP2};
+
+    /// A piece of the file: compressed input (parallel mode only) and decompressed output
+    struct Block
+    {
+      Block() :
+        seq(0),
+        expected_size(0)
+      {}
+
+      Size seq;
+      std::vector<unsigned char> input;
+      std::vector<char> output;
+      Size expected_size; ///< decompressed size, if known from the gzip trailers
+      std::exception_ptr error; ///< raised after the output of this block has been read
+    };
+    typedef boost::shared_ptr<Block> BlockPtr;
+
+    /// Unsplittable data beyond this size is decompressed sequentially
+    static const Size max_pending_factor = 4;
+
+    Pipeline_(const char* filename, Size nr_threads, Size chunk) :
+      file(nullptr),
+      format(PLAIN),
+      chunk_size(std::max(chunk, Size(64))),
+      max_ahead(2),
+      parallel(false),
+      finished(false),
+      next_seq(0),
+      next_read(0),
+      failed(false),
+      reader_done(false),
+      stopping(false),
+      current_pos(0)
+    {
+      file = fopen(filename, "rb"); // always open in binary mode because windows and mac open in text mode
+      if (file == nullptr)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+
+      // peek at the header to decide how the file can be decompressed
+      unsigned char header[18];
+      Size n = fread(header, 1, sizeof(header), file);
+      rewind(file);
+      if (n >= 2 && header[0] == 0x1f && header[1] == 0x8b)
+      {
+        format = GZIP;
+        parallel = (n == sizeof(header) && isBgzfHeader_(header));
+      }
+      else if (n >= 3 && header[0] == 'B' && header[1] == 'Z' && header[2] == 'h')
+      {
+        format = BZIP2;
+        parallel = true; // confirmed by the reader once a second stream is found
+      }
+
+      if (nr_threads == 0)
+      {
+#ifdef _OPENMP
+        nr_threads = omp_get_max_threads();
+#else
+        nr_threads = 1;
+#endif
+      }
+      if (nr_threads < 2) parallel = false;
+
+      if (parallel)
+      {
+        max_ahead = 2 * nr_threads;
+        for (Size k = 0; k < nr_threads; k++)
+        {
+          workers.push_back(std::thread(&Pipeline_::decode, this));
+        }
+      }
+      reader = std::thread(&Pipeline_::read, this);
+    }
+
+    ~Pipeline_()
+    {
+      stop();
+      fclose(file);
+    }
+
+    void stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      work_available.notify_all();
+      space_available.notify_all();
+      if (reader.joinable()) reader.join();
+      for (Size k = 0; k < workers.size(); k++)
+      {
+        if (workers[k].joinable()) workers[k].join();
+      }
+    }
+
+    /// Returns the next decompressed block in file order (null at the end of the file)
+    BlockPtr next()
+    {
+      BlockPtr block;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        block_ready.wait(lock, [this]()
+          { return ready.count(next_read) > 0 || (reader_done && next_read == next_seq); });
+        if (ready.count(next_read) == 0) return block; // end of file
+        block = ready[next_read];
+        ready.erase(next_read);
+        next_read++;
+      }
+      space_available.notify_all();
+      return block;
+    }
+
+    /// Waits until another block may be queued, returns its sequence number (false if the pipeline stops)
+    bool reserve_(Size& seq)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      space_available.wait(lock, [this]() { return stopping || failed || next_seq < next_read + max_ahead; });
+      if (stopping || failed) return false;
+      seq = next_seq++;
+      return true;
+    }
+
+    /// Hands a decompressed block to the consumer, a block carrying an error ends the stream
+    bool emit_(const BlockPtr& block)
+    {
+      if (block->error)
+      {
+        // queued regardless of the read-ahead limit, nothing is produced after it
+        std::lock_guard<std::mutex> lock(mutex);
+        block->seq = next_seq++;
+        ready[block->seq] = block;
+        failed = true;
+      }
+      else
+      {
+        if (!reserve_(block->seq)) return false;
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[block->seq] = block;
+      }
+      block_ready.notify_all();
+      space_available.notify_all();
+      return !block->error;
+    }
+
+    /// Hands a compressed chunk to the workers
+    bool dispatch_(const BlockPtr& block)
+    {
+      if (!reserve_(block->seq))
+      {
+        finished = true; // pipeline stopped, nothing left to decompress
+        return false;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        work_queue.push_back(block);
+      }
+      work_available.notify_one();
+      return true;
+    }
+
+    /// Read-ahead thread
+    void read()
+    {
+      try
+      {
+        std::vector<unsigned char> pending;
+        if (parallel && format == GZIP)
+        {
+          splitBgzf_(pending);
+        }
+        else if (parallel && format == BZIP2)
+        {
+          splitBzip2_(pending);
+        }
+        // sequential decompression of the (rest of the) file
+        if (!finished)
+        {
+          if (format == GZIP) inflateSequential_(pending);
+          else if (format == BZIP2) bunzipSequential_(pending);
+          else copySequential_();
+        }
+      }
+      catch (...)
+      {
+        BlockPtr block(new Block);
+        block->error = std::current_exception();
+        emit_(block);
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        reader_done = true;
+      }
+      work_available.notify_all();
+      block_ready.notify_all();
+    }
+
+    /// Worker thread
+    void decode()
+    {
+      while (true)
+      {
+        BlockPtr block;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          work_available.wait(lock, [this]() { return !work_queue.empty() || stopping || reader_done; });
+          if (work_queue.empty() || stopping) return;
+          block = work_queue.front();
+          work_queue.pop_front();
+        }
+
+        try
+        {
+          if (format == GZIP) inflateChunk_(*block);
+          else bunzipChunk_(*block);
+        }
+        catch (...)
+        {
+          block->error = std::current_exception();
+        }
+        std::vector<unsigned char>().swap(block->input);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          ready[block->seq] = block;
+          if (block->error) failed = true; // stops the read-ahead thread
+        }
+        block_ready.notify_all();
+        space_available.notify_all();
+      }
+    }
+
+    /// A BGZF member header (gzip member with a 'BC' extra field holding the member size)
+    static bool isBgzfHeader_(const unsigned char* h)
+    {
+      return h[0] == 0x1f && h[1] == 0x8b && h[2] == 8 && (h[3] & 4) != 0 &&
+             h[10] == 6 && h[11] == 0 && h[12] == 'B' && h[13] == 'C' && h[14] == 2 && h[15] == 0;
+    }
+
+    /// Start of a bzip2 stream: "BZh" + block size + block header magic (or end of stream magic)
+    static bool isBzip2StreamStart_(const unsigned char* p)
+    {
+      if (p[0] != 'B' || p[1] != 'Z' || p[2] != 'h' || p[3] < '1' || p[3] > '9') return false;
+      static const unsigned char block_magic[6] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+      static const unsigned char eos_magic[6] = {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+      return memcmp(p + 4, block_magic, 6) == 0 || memcmp(p + 4, eos_magic, 6) == 0;
+    }
+
+    /// Collects BGZF members into chunks for the workers, leaves non-BGZF data in @p pending
+    void splitBgzf_(std::vector<unsigned char>& pending)
+    {
+      BlockPtr block(new Block);
+      while (true)
+      {
+        unsigned char header[18];
+        Size n = fread(header, 1, sizeof(header), file);
+        if (n == 0) break;
+
+        // a member without size information (or a truncated one): continue sequentially from here
+        Size member_size = (n == sizeof(header) && isBgzfHeader_(header)) ? (header[16] | (header[17] << 8)) + 1 : 0;
+        if (member_size < sizeof(header) + 8)
+        {
+          pending.assign(header, header + n);
+          break;
+        }
+
+        Size offset = block->input.size();
+        block->input.resize(offset + member_size);
+        memcpy(&block->input[offset], header, sizeof(header));
+        Size rest = fread(&block->input[offset + sizeof(header)], 1, member_size - sizeof(header), file);
+        if (rest < member_size - sizeof(header))
+        {
+          // truncated file, let the sequential decoder deal with it
+          pending.assign(block->input.begin() + offset, block->input.begin() + offset + sizeof(header) + rest);
+          block->input.resize(offset);
+          break;
+        }
+        const unsigned char* isize = &block->input[offset + member_size - 4];
+        block->expected_size += isize[0] | (isize[1] << 8) | (isize[2] << 16) | (Size(isize[3]) << 24);
+
+        if (block->input.size() >= chunk_size)
+        {
+          if (!dispatch_(block)) return;
+          block.reset(new Block);
+        }
+      }
+      if (!block->input.empty() && !dispatch_(block)) return;
+      finished = pending.empty();
+    }
+
+    /// Cuts the file into chunks of complete bzip2 streams, leaves unsplittable data in @p pending
+    void splitBzip2_(std::vector<unsigned char>& pending)
+    {
+      const Size magic_size = 10;
+      Size scan_from = 1; // the first stream starts at position 0
+      while (true)
+      {
+        Size offset = pending.size();
+        pending.resize(offset + chunk_size);
+        Size n = fread(&pending[offset], 1, chunk_size, file);
+        pending.resize(offset + n);
+        if (n == 0) break;
+
+        // find the last stream start within the data read so far
+        Size cut = 0;
+        for (Size i = scan_from; i + magic_size <= pending.size(); ++i)
+        {
+          const unsigned char* p = static_cast<const unsigned char*>(
+            memchr(&pending[i], 'B', pending.size() - magic_size + 1 - i));
+          if (p == nullptr) break;
+          i = p - &pending[0];
+          if (isBzip2StreamStart_(p)) cut = i;
+        }
+        scan_from = std::max(Size(1), pending.size() >= magic_size ? pending.size() - magic_size + 1 : Size(1));
+
+        if (cut > 0)
+        {
+          BlockPtr block(new Block);
+          block->input.assign(pending.begin(), pending.begin() + cut);
+          pending.erase(pending.begin(), pending.begin() + cut);
+          scan_from -= cut;
+          if (!dispatch_(block)) return;
+        }
+        else if (pending.size() > max_pending_factor * chunk_size)
+        {
+          // a single large stream (regular bzip2 output) cannot be split
+          return;
+        }
+      }
+      if (!pending.empty())
+      {
+        BlockPtr block(new Block);
+        block->input.swap(pending);
+        if (!dispatch_(block)) return;
+      }
+      finished = true;
+    }
+
+    /// Decompresses a chunk of complete gzip members (worker)
+    void inflateChunk_(Block& block)
+    {
+      z_stream strm;
+      memset(&strm, 0, sizeof(strm));
+      if (inflateInit2(&strm, 15 + 16) != Z_OK)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "zlib initialization failed");
+      }
+      block.output.resize(std::max(block.expected_size, block.input.size()));
+      strm.next_in = &block.input[0];
+      strm.avail_in = (uInt)block.input.size();
+      Size out_pos = 0;
+      while (strm.avail_in > 0)
+      {
+        if (out_pos == block.output.size()) block.output.resize(2 * block.output.size());
+        strm.next_out = reinterpret_cast<Bytef*>(&block.output[out_pos]);
+        strm.avail_out = (uInt)(block.output.size() - out_pos);
+        int ret = inflate(&strm, Z_NO_FLUSH);
+        out_pos = block.output.size() - strm.avail_out;
+        if (ret == Z_STREAM_END)
+        {
+          inflateReset(&strm);
+        }
+        else if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+          inflateEnd(&strm);
+          block.output.resize(out_pos);
+          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "gzip file seems to be corrupted");
+        }
+      }
+      inflateEnd(&strm);
+      block.output.resize(out_pos);
+    }
+
+    /// Decompresses a chunk of complete bzip2 streams (worker)
+    void bunzipChunk_(Block& block)
+    {
+      bz_stream strm;
+      memset(&strm, 0, sizeof(strm));
+      if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, " ", "bzip2 compression failed: ");
+      }
+      block.output.resize(4 * block.input.size());
+      strm.next_in = reinterpret_cast<char*>(&block.input[0]);
+      strm.avail_in = (unsigned int)block.input.size();
+      Size out_pos = 0;
+      while (true)
+      {
+        if (out_pos == block.output.size()) block.output.resize(2 * block.output.size());
+        strm.next_out = &block.output[out_pos];
+        strm.avail_out = (unsigned int)(block.output.size() - out_pos);
+        int ret = BZ2_bzDecompress(&strm);
+        out_pos = block.output.size() - strm.avail_out;
+        if (ret == BZ_STREAM_END)
+        {
+          // trailing garbage after the last stream is ignored, like BZ2_bzRead() does
+          if (strm.avail_in < 3 || memcmp(strm.next_in, "BZh", 3) != 0) break;
+          BZ2_bzDecompressEnd(&strm);
+          char* next_in = strm.next_in;
+          unsigned int avail_in = strm.avail_in;
+          memset(&strm, 0, sizeof(strm));
+          BZ2_bzDecompressInit(&strm, 0, 0);
+          strm.next_in = next_in;
+          strm.avail_in = avail_in;
+        }
+        else if (ret != BZ_OK || (strm.avail_in == 0 && strm.avail_out > 0))
+        {
+          // corrupt data or a stream which ends prematurely
+          BZ2_bzDecompressEnd(&strm);
+          block.output.resize(out_pos);
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, " ", "bzip2 compression failed: ");
+        }
+      }
+      BZ2_bzDecompressEnd(&strm);
+      block.output.resize(out_pos);
+    }
+
+    /// Refills @p in with data from the file, keeping @p avail unconsumed bytes at @p next (returns false at the end of the file)
+    bool refill_(std::vector<unsigned char>& in, unsigned char*& next, Size& avail)
+    {
+      if (avail > 0 && next != &in[0]) memmove(&in[0], next, avail);
+      if (in.size() < avail + chunk_size) in.resize(avail + chunk_size);
+      next = &in[0];
+      Size n = fread(&in[avail], 1, in.size() - avail, file);
+      avail += n;
+      return n > 0;
+    }
+
+    /// Sequential gzip decompression (read-ahead thread), starting with the data in @p pending
+    void inflateSequential_(std::vector<unsigned char>& in)
+    {
+      z_stream strm;
+      memset(&strm, 0, sizeof(strm));
+      if (inflateInit2(&strm, 15 + 16) != Z_OK)
+      {
+        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "zlib initialization failed");
+      }
+
+      Size avail = in.size();
+      in.resize(avail + chunk_size);
+      unsigned char* next = &in[0];
+      bool eof = false;
+      bool member_end = false;
+      BlockPtr block(new Block);
+      block->output.resize(chunk_size);
+      Size out_pos = 0;
+      while (true)
+      {
+        if (avail < 2 && !eof) eof = !refill_(in, next, avail);
+        if (member_end)
+        {
+          // gzread() continues with the next member and ignores trailing garbage
+          if (avail < 2 || next[0] != 0x1f || next[1] != 0x8b) break;
+          inflateReset(&strm);
+          member_end = false;
+        }
+        if (avail == 0) break; // truncated member, gzread() stops silently as well
+
+        strm.next_in = next;
+        strm.avail_in = (uInt)avail;
+        strm.next_out = reinterpret_cast<Bytef*>(&block->output[out_pos]);
+        strm.avail_out = (uInt)(chunk_size - out_pos);
+        int ret = inflate(&strm, Z_NO_FLUSH);
+        next = strm.next_in;
+        avail = strm.avail_in;
+        out_pos = chunk_size - strm.avail_out;
+        if (ret == Z_STREAM_END)
+        {
+          member_end = true;
+        }
+        else if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+          // data decompressed before the error is still handed out (as gzread() does)
+          inflateEnd(&strm);
+          block->output.resize(out_pos);
+          block->error = std::make_exception_ptr(Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                                                             "gzip file seems to be corrupted"));
+          emit_(block);
+          return;
+        }
+
+        if (out_pos == chunk_size)
+        {
+          if (!emit_(block))
+          {
+            inflateEnd(&strm);
+            return;
+          }
+          block.reset(new Block);
+          block->output.resize(chunk_size);
+          out_pos = 0;
+        }
+      }
+      inflateEnd(&strm);
+      block->output.resize(out_pos);
+      if (out_pos > 0) emit_(block);
+    }
+
+    /// Sequential bzip2 decompression (read-ahead thread), starting with the data in @p pending
+    void bunzipSequential_(std::vector<unsigned char>& in)
+    {
+      bz_stream strm;
+      memset(&strm, 0, sizeof(strm));
+      if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, " ", "bzip2 compression failed: ");
+      }
+
+      Size avail = in.size();
+      in.resize(avail + chunk_size);
+      unsigned char* next = &in[0];
+      bool eof = false;
+      bool stream_end = false;
+      BlockPtr block(new Block);
+      block->output.resize(chunk_size);
+      Size out_pos = 0;
+      while (true)
+      {
+        int ret = BZ_OK;
+        if (avail < 3 && !eof) eof = !refill_(in, next, avail);
+        if (stream_end)
+        {
+          // continue with the next stream, trailing garbage is ignored
+          if (avail < 3 || memcmp(next, "BZh", 3) != 0) break;
+          BZ2_bzDecompressEnd(&strm);
+          memset(&strm, 0, sizeof(strm));
+          BZ2_bzDecompressInit(&strm, 0, 0);
+          stream_end = false;
+        }
+        if (avail == 0 && eof) ret = BZ_UNEXPECTED_EOF;
+
+        else
+        {
+          strm.next_in = reinterpret_cast<char*>(next);
+          strm.avail_in = (unsigned int)avail;
+          strm.next_out = &block->output[out_pos];
+          strm.avail_out = (unsigned int)(chunk_size - out_pos);
+          ret = BZ2_bzDecompress(&strm);
+          next = reinterpret_cast<unsigned char*>(strm.next_in);
+          avail = strm.avail_in;
+          out_pos = chunk_size - strm.avail_out;
+        }
+        if (ret == BZ_STREAM_END)
+        {
+          stream_end = true;
+        }
+        else if (ret != BZ_OK)
+        {
+          // corrupt data or a file which ends prematurely
+          BZ2_bzDecompressEnd(&strm);
+          block->output.resize(out_pos);
+          block->error = std::make_exception_ptr(Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                                                        " ", "bzip2 compression failed: "));
+          emit_(block);
+          return;
+        }
+
+        if (out_pos == chunk_size)
+        {
+          if (!emit_(block))
+          {
+            BZ2_bzDecompressEnd(&strm);
+            return;
+          }
+          block.reset(new Block);
+          block->output.resize(chunk_size);
+          out_pos = 0;
+        }
+      }
+      BZ2_bzDecompressEnd(&strm);
+      block->output.resize(out_pos);
+      if (out_pos > 0) emit_(block);
+    }
+
+    /// Uncompressed files are passed through (as gzread() does)
+    void copySequential_()
+    {
+      while (true)
+      {
+        BlockPtr block(new Block);
+        block->output.resize(chunk_size);
+        Size n = fread(&block->output[0], 1, chunk_size, file);
+        if (n == 0) return;
+        block->output.resize(n);
+        if (!emit_(block) || n < chunk_size) return;
+      }
+    }
+
+    FILE* file;
+    Format format;
+    Size chunk_size;
+    Size max_ahead; ///< number of blocks which may be queued or decompressed ahead of the consumer
+    bool parallel;
+    bool finished; ///< whole file handed to the workers (read-ahead thread only)
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable block_ready;
+    std::condition_variable space_available;
+    std::deque<BlockPtr> work_queue;
+    std::map<Size, BlockPtr> ready;
+    Size next_seq;
+    Size next_read;
+    bool failed; ///< an error block was queued, no further blocks are produced
+    bool reader_done;
+    bool stopping;
+
+    // consumer state (only accessed by the consuming thread)
+    BlockPtr current;
+    Size current_pos;
+
+    std::vector<std::thread> workers;
+    std::thread reader;
+  };
+
+  ReadAheadDecompressor::ReadAheadDecompressor() :
+    stream_at_end_(true)
+  {
+  }
+
+  ReadAheadDecompressor::ReadAheadDecompressor(const char* filename, Size nr_threads, Size chunk_size) :
+    stream_at_end_(true)
+  {
+    open(filename, nr_threads, chunk_size);
+  }
+
+  ReadAheadDecompressor::~ReadAheadDecompressor()
+  {
+    close();
+  }
+
+  void ReadAheadDecompressor::open(const char* filename, Size nr_threads, Size chunk_size)
+  {
+    close();
+    pipeline_.reset(new Pipeline_(filename, nr_threads, chunk_size));
+    stream_at_end_ = false;
+  }
+
+  void ReadAheadDecompressor::close()
+  {
+    pipeline_.reset();
+    stream_at_end_ = true;
+  }
+
+  bool ReadAheadDecompressor::isParallel() const
+  {
+    return pipeline_ && pipeline_->parallel;
+  }
+
+  size_t ReadAheadDecompressor::read(char* s, size_t n)
+  {
+    if (!pipeline_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "no file for decompression initialized");
+    }
+
+    Pipeline_& p = *pipeline_;
+    size_t done = 0;
+    try
+    {
+      while (done < n)
+      {
+        if (!p.current || p.current_pos == p.current->output.size())
+        {
+          if (p.current && p.current->error) std::rethrow_exception(p.current->error);
+          p.current = p.next();
+          p.current_pos = 0;
+          if (!p.current) break;
+          continue;
+        }
+        size_t len = std::min(n - done, p.current->output.size() - p.current_pos);
+        memcpy(s + done, &p.current->output[p.current_pos], len);
+        p.current_pos += len;
+        done += len;
+      }
+    }
+    catch (...)
+    {
+      close();
+      throw;
+    }
+
+    // the stream is closed once the end of the file was reached
+    if (done < n) close();
+    return done;
+  }
+
+  bool ReadAheadDecompressor::isCompressed(const char* filename)
+  {
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr) return false;
+    unsigned char header[3] = {0, 0, 0};
+    Size n = fread(header, 1, sizeof(header), file);
+    fclose(file);
+    return (n >= 2 && header[0] == 0x1f && header[1] == 0x8b) ||
+           (n == 3 && header[0] == 'B' && header[1] == 'Z' && header[2] == 'h');
+  }
+
+} // namespace OpenMS
@@ -44,6 +44,7 @@ MascotInfile.cpp
 MascotGenericFile.cpp
 MascotRemoteQuery.cpp
 MascotXMLFile.cpp
+MappedFASTAFile.cpp
 MsInspectFile.cpp
 MzDataFile.cpp
 MzIdentMLFile.cpp
@@ -65,6 +66,7 @@ PepXMLFileMascot.cpp
 PercolatorOutfile.cpp
 ProtXMLFile.cpp
 QcMLFile.cpp
+ReadAheadDecompressor.cpp
 SequestInfile.cpp
 SequestOutfile.cpp
 SpecArrayFile.cpp
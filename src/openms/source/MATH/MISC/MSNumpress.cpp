@@ -90,61 +90,97 @@ static double decodeFixedPoint(
 /////////////////////////////////////////////////////////////
 
 /**
- * Encodes the int x as a number of halfbytes in res. 
- * res_length is incremented by the number of halfbytes, 
- * which will be 1 <= n <= 9
+ * Number of leading zero half bytes in x (8 for x == 0)
+ */
+static inline unsigned int leadingZeroHalfBytes(
+		const unsigned int x
+) {
+#if defined(__GNUC__) || defined(__clang__)
+	return x == 0 ? 8 : static_cast<unsigned int>(__builtin_clz(x)) / 4;
+#else
+	unsigned int l = 0;
+	while (l < 8 && (x & (0xf0000000u >> (4*l))) == 0) l++;
+	return l;
+#endif
+}
+
+
+
+/**
+ * Reverses the order of the half bytes in x (half byte 0 becomes half byte 7)
+ */
+static inline unsigned int reverseHalfBytes(
+		unsigned int x
+) {
+#if defined(__GNUC__) || defined(__clang__)
+	x = __builtin_bswap32(x);
+#else
+	x = (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) | (x << 24);
+#endif
+	return ((x & 0x0f0f0f0fu) << 4) | ((x >> 4) & 0x0f0f0f0fu);
+}
+
+
+
+/**
+ * Encodes the int x as a number of halfbytes and appends them to the half 
+ * byte stream. Completed bytes are written to result (ri is incremented),
+ * a trailing half byte is kept in the stream (pending = 0 or 1).
  *
- * see header file for a detailed description of the algorithm.
+ * The half bytes are identical to the original, loop-based encodeInt:
+ * a count half byte followed by 1 <= n <= 8 half bytes of x starting with
+ * the least significant one. see header file for a detailed description of 
+ * the algorithm.
  */
-static void encodeInt(
+static inline void encodeInt(
 		const unsigned int x,
-		unsigned char* res,
-		size_t *res_length	
+		unsigned long long *stream,
+		unsigned int *pending,
+		unsigned char *result,
+		size_t *ri
 ) {
-    // get the bit pattern of a signed int x_inp
-	unsigned int m;
-	unsigned char i, l; // numbers between 0 and 9
-
-    unsigned int mask = 0xf0000000;
-    unsigned int init = x & mask;
+	unsigned int l, head;
+	unsigned int init = x & 0xf0000000u;
 
 	if (init == 0) {
-		l = 8;
-		for (i=0; i<8; i++) {
-			m = mask >> (4*i);
-			if ((x & m) != 0) {
-				l = i;
-				break;
-			}
-		}
-		res[0] = l;
-		for (i=l; i<8; i++) {
-			res[1+i-l] = static_cast<unsigned char>( x >> (4*(i-l)) );
-		}
-		*res_length += 1+8-l;
+		l = leadingZeroHalfBytes(x);
+		head = l;
+	} else if (init == 0xf0000000u) {
+		l = min(leadingZeroHalfBytes(~x), 7u);
+		head = l + 8;
+	} else {
+		l = 0;
+		head = 0;
+	}
 
-	} else if (init == mask) {
-		l = 7;
-		for (i=0; i<8; i++) {
-			m = mask >> (4*i);
-			if ((x & m) != m) {
-				l = i;
-				break;
-			}
-		}
-		res[0] = l + 8;
-		for (i=l; i<8; i++) {
-			res[1+i-l] = static_cast<unsigned char>( x >> (4*(i-l)) );
-		}
-		*res_length += 1+8-l;
+	// count half byte followed by the 8 - l lowest half bytes (least significant first)
+	unsigned int n = 8 - l;
+	unsigned long long hb = (static_cast<unsigned long long>(head) << (4*n)) |
+		(static_cast<unsigned long long>(reverseHalfBytes(x)) >> (4*l));
+	unsigned long long acc = (*stream << (4*(n+1))) | hb;
+	unsigned int count = *pending + n + 1;
+
+	while (count >= 2) {
+		count -= 2;
+		result[(*ri)++] = static_cast<unsigned char>(acc >> (4*count));
+	}
+	*stream = acc & 0xf;
+	*pending = count;
+}
 
-	} else {
-		res[0] = 0;
-		for (i=0; i<8; i++) {
-			res[1+i] = static_cast<unsigned char>( x >> (4*i) );
-		}
-		*res_length += 9;
 
+
+/**
+ * Writes a pending half byte (padded with a zero half byte) to result
+ */
+static inline void flushHalfBytes(
+		const unsigned long long stream,
+		const unsigned int pending,
+		unsigned char *result,
+		size_t *ri
+) {
+	if (pending == 1) {
+		result[(*ri)++] = static_cast<unsigned char>(stream << 4);
 	}
 }
 
@@ -153,7 +189,7 @@ static void encodeInt(
 /**
  * Decodes an int from the half bytes in bp. Lossless reverse of encodeInt 
  */
-static void decodeInt(
+static inline void decodeInt(
 		const unsigned char *data,
 		size_t *di,
 		size_t max_di,
@@ -161,10 +197,31 @@ static void decodeInt(
 		unsigned int *res
 ) {
     size_t n, i;
-    unsigned int mask, m;
     unsigned char head;
     unsigned char hb;
 
+	// fast path: at least 8 bytes left, so the (at most 9) half bytes can be
+	// read from a single 64 bit window without any bounds checks
+	if (*di + 8 <= max_di) {
+		unsigned long long window = 0;
+		for (i=0; i<8; i++) {
+			window = (window << 8) | data[*di + i];
+		}
+		window <<= 4 * (*half); // current half byte at the top
+		head = static_cast<unsigned char>(window >> 60);
+		n = head <= 8 ? head : head - 8;
+		*res = head <= 8 ? 0 : 0xffffffffu << (32 - 4*n);
+		if (n < 8) {
+			// the following 8 - n half bytes, least significant first
+			unsigned int values = reverseHalfBytes(static_cast<unsigned int>(window >> 28));
+			*res |= values & (0xffffffffu >> (4*n));
+		}
+		size_t pos = 2 * (*di) + (*half) + 9 - n;
+		*di = pos / 2;
+		*half = pos % 2;
+		return;
+	}
+
 	if (*half == 0) {
 		head = data[*di] >> 4;
 	} else {
@@ -177,13 +234,9 @@ static void decodeInt(
 	
 	if (head <= 8) {
 		n = head;
-	} else { // leading ones, fill n half bytes in res
+	} else { // leading ones, fill n half bytes in res (1 <= n <= 7)
 		n = head - 8;
-		mask = 0xf0000000;
-		for (i=0; i<n; i++) {
-			m = mask >> (4*i);
-			*res = *res | m;
-		}
+		*res = 0xffffffffu << (32 - 4*n);
 	}
 	
 	if (n == 8) {
@@ -209,6 +262,49 @@ static void decodeInt(
 
 
 
+/**
+ * Counts the ints that the decode loop of decodeLinear / decodePic reads
+ * from the half bytes in data, starting at byte di (without decoding them).
+ * Stops where decodeInt would detect corrupt data, so the count is never
+ * smaller than the number of values written before such an error.
+ */
+static size_t countInts(
+		const unsigned char *data,
+		size_t di,
+		const size_t dataSize
+) {
+	size_t count = 0;
+	size_t half = 0;
+	size_t n;
+	unsigned char head;
+
+	while (di < dataSize) {
+		if (di == (dataSize - 1) && half == 1) {
+			if ((data[di] & 0xf) == 0x0) {
+				break;
+			}
+		}
+		if (half == 0) {
+			head = data[di] >> 4;
+		} else {
+			head = data[di] & 0xf;
+			di++;
+		}
+		half = 1 - half;
+		n = head <= 8 ? head : head - 8;
+		count++;
+		if (n == 8) continue;
+		if (di + ((8 - n) - (1 - half)) / 2 >= dataSize) break; // corrupt
+		size_t pos = 2 * di + half + (8 - n);
+		di = pos / 2;
+		half = pos % 2;
+	}
+	return count;
+}
+
+
+
+
 /////////////////////////////////////////////////////////////
 
 double optimalLinearFixedPointMass(
@@ -276,9 +372,8 @@ size_t encodeLinear(
 ) {
 	long long ints[3];
 	size_t i, ri;
-	unsigned char halfBytes[10];
-	size_t halfByteCount;
-	size_t hbi;
+	unsigned long long stream;
+	unsigned int pending;
 	long long extrapol;
 	int diff;
 
@@ -300,7 +395,8 @@ size_t encodeLinear(
 		result[12+i] = (ints[2] >> (i*8)) & 0xff;
 	}
 
-	halfByteCount = 0;
+	stream = 0;
+	pending = 0;
 	ri = 16;
 
 	for (i=2; i<dataSize; i++) {
@@ -322,38 +418,9 @@ size_t encodeLinear(
 
 		diff = static_cast<int>(ints[2] - extrapol);
 		//printf("%lu %lu %lu,   extrapol: %ld    diff: %d \n", ints[0], ints[1], ints[2], extrapol, diff);
-		encodeInt(
-				static_cast<unsigned int>(diff), 
-				&halfBytes[halfByteCount], 
-				&halfByteCount
-			);
-		/*
-		printf("%d (%d):  ", diff, (int)halfByteCount);
-		for (size_t j=0; j<halfByteCount; j++) {
-			printf("%x ", halfBytes[j] & 0xf);
-		}
-		printf("\n");
-		*/
-		
-		
-		for (hbi=1; hbi < halfByteCount; hbi+=2) {
-			result[ri] = static_cast<unsigned char>(
-					(halfBytes[hbi-1] << 4) | (halfBytes[hbi] & 0xf)
-				);
-			//printf("%x \n", result[ri]);
-			ri++;
-		}
-		if (halfByteCount % 2 != 0) {
-			halfBytes[0] = halfBytes[halfByteCount-1];
-			halfByteCount = 1;
-		} else {
-			halfByteCount = 0;
-		}
-	}
-	if (halfByteCount == 1) {
-		result[ri] = static_cast<unsigned char>(halfBytes[0] << 4);
-		ri++;
+		encodeInt(static_cast<unsigned int>(diff), &stream, &pending, result, &ri);
 	}
+	flushHalfBytes(stream, pending, result, &ri);
 	return ri;
 }
 
@@ -459,6 +526,17 @@ void decodeLinear(
 	result.resize(decodedLength);
 }
 
+
+
+size_t decodeLinearLength(
+		const unsigned char *data,
+		const size_t dataSize
+) {
+	if (dataSize < 12) return 0;
+	if (dataSize < 16) return 1;
+	return 2 + countInts(data, 16, dataSize);
+}
+
 /////////////////////////////////////////////////////////////
 
 
@@ -573,13 +651,13 @@ size_t encodePic(
 ) {
 	size_t i, ri;
 	unsigned int x;
-	unsigned char halfBytes[10];
-	size_t halfByteCount;
-	size_t hbi;
+	unsigned long long stream;
+	unsigned int pending;
 
 	//printf("Encoding %d doubles\n", (int)dataSize);
 
-	halfByteCount = 0;
+	stream = 0;
+	pending = 0;
 	ri = 0;
 
 	for (i=0; i<dataSize; i++) {
@@ -589,27 +667,9 @@ size_t encodePic(
 			throw "[MSNumpress::encodePic] Cannot use Pic to encode a number larger than INT_MAX or smaller than 0.";
 		}
 		x = static_cast<unsigned int>(data[i] + 0.5);
-		//printf("%d %d %d,   extrapol: %d    diff: %d \n", ints[0], ints[1], ints[2], extrapol, diff);
-		encodeInt(x, &halfBytes[halfByteCount], &halfByteCount);
-		
-		for (hbi=1; hbi < halfByteCount; hbi+=2) {
-			result[ri] = static_cast<unsigned char>(
-					(halfBytes[hbi-1] << 4) | (halfBytes[hbi] & 0xf)
-				);
-			//printf("%x \n", result[ri]);
-			ri++;
-		}
-		if (halfByteCount % 2 != 0) {
-			halfBytes[0] = halfBytes[halfByteCount-1];
-			halfByteCount = 1;
-		} else {
-			halfByteCount = 0;
-		}
-	}
-	if (halfByteCount == 1) {
-		result[ri] = static_cast<unsigned char>(halfBytes[0] << 4);
-		ri++;
+		encodeInt(x, &stream, &pending, result, &ri);
 	}
+	flushHalfBytes(stream, pending, result, &ri);
 	return ri;
 }
 
@@ -674,6 +734,15 @@ void decodePic(
 }
 
 
+
+size_t decodePicLength(
+		const unsigned char *data,
+		const size_t dataSize
+) {
+	return countInts(data, 0, dataSize);
+}
+
+
 /////////////////////////////////////////////////////////////
 
 
@@ -42,6 +42,7 @@ namespace OpenMS
   PeptideHit::PeptideHit() :
     MetaInfoInterface(),
     sequence_(),
+    shared_sequence_(),
     score_(0),
     analysis_results_(nullptr),
     rank_(0),
@@ -55,6 +56,7 @@ namespace OpenMS
   PeptideHit::PeptideHit(double score, UInt rank, Int charge, const AASequence& sequence) :
       MetaInfoInterface(),
       sequence_(sequence),
+      shared_sequence_(),
       score_(score),
       analysis_results_(nullptr),
       rank_(rank),
@@ -67,7 +69,8 @@ namespace OpenMS
   // values constructor
   PeptideHit::PeptideHit(double score, UInt rank, Int charge, AASequence&& sequence) :
     MetaInfoInterface(),
-    sequence_(sequence),
+    sequence_(std::move(sequence)),
+    shared_sequence_(),
     score_(score),
     analysis_results_(nullptr),
     rank_(rank),
@@ -81,6 +84,7 @@ namespace OpenMS
   PeptideHit::PeptideHit(const PeptideHit& source) :
     MetaInfoInterface(source),
     sequence_(source.sequence_),
+    shared_sequence_(source.shared_sequence_),
     score_(source.score_),
     analysis_results_(nullptr),
     rank_(source.rank_),
@@ -98,6 +102,7 @@ namespace OpenMS
   PeptideHit::PeptideHit(PeptideHit&& source) noexcept :
     MetaInfoInterface(std::move(source)), // NOTE: rhs itself is an lvalue
     sequence_(std::move(source.sequence_)),
+    shared_sequence_(std::move(source.shared_sequence_)),
     score_(source.score_),
     analysis_results_(std::move(source.analysis_results_)),
     rank_(source.rank_),
@@ -124,6 +129,7 @@ namespace OpenMS
 
     MetaInfoInterface::operator=(source);
     sequence_ = source.sequence_;
+    shared_sequence_ = source.shared_sequence_;
     score_ = source.score_;
     analysis_results_ = nullptr;
     if (source.analysis_results_ != nullptr)
@@ -148,7 +154,8 @@ namespace OpenMS
 
     MetaInfoInterface::operator=(std::move(source));
     //clang-tidy overly strict, should be fine to move the rest here
-    sequence_ = source.sequence_;
+    sequence_ = std::move(source.sequence_);
+    shared_sequence_ = std::move(source.shared_sequence_);
     score_ = source.score_;
 
     // free memory and assign rhs memory
@@ -175,7 +182,7 @@ namespace OpenMS
     else return false; // one is null the other isn't
 
     return MetaInfoInterface::operator==(rhs)
-           && sequence_ == rhs.sequence_
+           && ((shared_sequence_ != nullptr && shared_sequence_ == rhs.shared_sequence_) || getSequence() == rhs.getSequence())
            && score_ == rhs.score_
            && ar_equal
            && rank_ == rhs.rank_
@@ -204,19 +211,37 @@ namespace OpenMS
   // returns the peptide sequence without trailing or following spaces
   const AASequence& PeptideHit::getSequence() const
   {
+    if (shared_sequence_ != nullptr)
+    {
+      return *shared_sequence_;
+    }
     return sequence_;
   }
 
+  const std::shared_ptr<const AASequence>& PeptideHit::getSharedSequence() const
+  {
+    return shared_sequence_;
+  }
+
   void PeptideHit::setSequence(const AASequence& sequence)
   {
+    // never modify a shared sequence: it may be used by other hits or an AASequencePool
+    shared_sequence_.reset();
     sequence_ = sequence;
   }
 
   void PeptideHit::setSequence(AASequence&& sequence)
   {
+    shared_sequence_.reset();
     sequence_ = std::move(sequence);
   }
 
+  void PeptideHit::setSequence(const std::shared_ptr<const AASequence>& sequence)
+  {
+    shared_sequence_ = sequence;
+    sequence_ = AASequence();
+  }
+
   Int PeptideHit::getCharge() const
   {
     return charge_;
@@ -64,5 +64,24 @@ namespace OpenSwath
                                              std::vector<double>& integratedWindowsIntensity,
                                              std::vector<double>& integratedWindowsMZ, bool remZero = false);
 
+  /**
+    @brief Integrate intensity in a spectrum for many windows at once
+
+    Computes the same total intensity and intensity-weighted m/z as calling
+    integrateWindow() on each window. Instead of two full binary searches per
+    window, the windows are visited in order of their start and both
+    boundaries are searched forward from the previous position, so all
+    windows are resolved in a single merge-like pass over the spectrum.
+    Results are returned in the order of the input windows.
+
+    @note Windows without signal have an m/z of -1 and an intensity of 0
+  */
+  OPENSWATHALGO_DLLAPI void integrateWindows(const OpenSwath::SpectrumPtr spectrum, //!< [in] Spectrum
+                                             const std::vector<double>& windows_start, //!< [in] start m/z of each window
+                                             const std::vector<double>& windows_end, //!< [in] end m/z of each window
+                                             std::vector<double>& integrated_mz, //!< [out] intensity-weighted m/z of each window
+                                             std::vector<double>& integrated_intensity, //!< [out] total intensity of each window
+                                             bool centroided = false);
+
 }
 
@@ -48,25 +48,95 @@ namespace OpenSwath
                         std::vector<double> & integratedWindowsMZ,
                         bool remZero)
   {
-    std::vector<double>::const_iterator beg = windowsCenter.begin();
-    std::vector<double>::const_iterator end = windowsCenter.end();
-    double mz, intensity;
-    for (; beg != end; ++beg)
+    std::vector<double> windows_start, windows_end;
+    windows_start.reserve(windowsCenter.size());
+    windows_end.reserve(windowsCenter.size());
+    for (std::vector<double>::const_iterator beg = windowsCenter.begin(); beg != windowsCenter.end(); ++beg)
     {
-      double left = *beg - width / 2.0;
-      double right = *beg + width / 2.0;
-      if (integrateWindow(spectrum, left, right, mz, intensity, false))
+      windows_start.push_back(*beg - width / 2.0);
+      windows_end.push_back(*beg + width / 2.0);
+    }
+    std::vector<double> mz, intensity;
+    integrateWindows(spectrum, windows_start, windows_end, mz, intensity, false);
+
+    for (std::size_t i = 0; i < windowsCenter.size(); ++i)
+    {
+      if (intensity[i] > 0.)
       {
-        integratedWindowsIntensity.push_back(intensity);
-        integratedWindowsMZ.push_back(mz);
+        integratedWindowsIntensity.push_back(intensity[i]);
+        integratedWindowsMZ.push_back(mz[i]);
       }
       else if (!remZero)
       {
         integratedWindowsIntensity.push_back(0.);
-        integratedWindowsMZ.push_back(*beg);
+        integratedWindowsMZ.push_back(windowsCenter[i]);
       }
-      else
+    }
+  }
+
+  void integrateWindows(const OpenSwath::SpectrumPtr spectrum,
+                        const std::vector<double> & windows_start,
+                        const std::vector<double> & windows_end,
+                        std::vector<double> & integrated_mz,
+                        std::vector<double> & integrated_intensity,
+                        bool centroided)
+  {
+    OPENSWATH_PRECONDITION(windows_start.size() == windows_end.size(), "Need the same number of window starts and ends")
+    OPENSWATH_PRECONDITION( std::adjacent_find(spectrum->getMZArray()->data.begin(),
+            spectrum->getMZArray()->data.end(), std::greater<double>()) == spectrum->getMZArray()->data.end(),
+          "Precondition violated: m/z vector needs to be sorted!" )
+
+    if (centroided)
+    {
+      // not implemented
+      throw "Not implemented";
+    }
+
+    typedef std::vector<double>::const_iterator itType;
+    const std::vector<double>& mz_arr = spectrum->getMZArray()->data;
+    const std::vector<double>& int_arr = spectrum->getIntensityArray()->data;
+
+    // lower bound of value in [first, last), searching with exponentially
+    // growing steps from first (the bound is expected to be close by)
+    auto forward_lower_bound = [](itType first, itType last, double value) -> itType
+    {
+      std::ptrdiff_t step = 1;
+      while (step < std::distance(first, last) && *(first + step) < value)
+      {
+        first += step;
+        step *= 2;
+      }
+      itType limit = (step < std::distance(first, last)) ? first + step : last;
+      return std::lower_bound(first, limit, value);
+    };
+
+    // visit windows by increasing start, the start positions are then increasing as well
+    std::vector<std::size_t> order(windows_start.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+      [&windows_start](std::size_t a, std::size_t b) { return windows_start[a] < windows_start[b]; });
+
+    integrated_mz.assign(windows_start.size(), -1);
+    integrated_intensity.assign(windows_start.size(), 0);
+    itType mz_it = mz_arr.begin();
+    for (std::size_t i : order)
+    {
+      // identical ranges (and summation order) as in integrateWindow
+      mz_it = forward_lower_bound(mz_it, mz_arr.end(), windows_start[i]);
+      itType mz_it_end = forward_lower_bound(mz_it, mz_arr.end(), windows_end[i]);
+      itType int_it = int_arr.begin() + std::distance(mz_arr.begin(), mz_it);
+
+      double mz = 0, intensity = 0;
+      for (itType it = mz_it; it != mz_it_end; ++it, ++int_it)
+      {
+        intensity += (*int_it);
+        mz += (*int_it) * (*it);
+      }
+
+      if (intensity > 0.)
       {
+        integrated_mz[i] = mz / intensity;
+        integrated_intensity[i] = intensity;
       }
     }
   }
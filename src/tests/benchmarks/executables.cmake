@@ -0,0 +1,13 @@
+### the list of benchmark executables (built if ENABLE_BENCHMARKS is ON, never run by ctest)
+set(BENCHMARK_executables
+  AASequence_benchmark
+  CoarseIsotopePatternCache_benchmark
+  EmpiricalFormula_benchmark
+  MRMTransitionGroupPicker_benchmark
+  MSNumpressCoder_benchmark
+  MappedFASTAFile_benchmark
+  ModificationsDB_benchmark
+  MzMLSqliteHandler_benchmark
+  PeptideAndProteinQuant_benchmark
+  SignalToNoiseEstimatorMedian_benchmark
+)
@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: parsing of (modified) peptide sequences, with and without AASequencePool
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  const Size nr_peptides = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  std::vector<String> peptides;
+  peptides.reserve(nr_peptides);
+  const char* mods[] = {"", "M(Oxidation)", "C(Carbamidomethyl)", "S(Phospho)", "M[147]", "C[+57.021]"};
+  for (Size i = 0; i < nr_peptides; ++i)
+  {
+    String seq = (i % 7 == 0) ? ".(Acetyl)" : "";
+    seq += String("PEPTIDE").substr(0, 1 + i % 7) + mods[i % 6] + "LK";
+    peptides.push_back(seq);
+  }
+
+  StopWatch sw;
+  sw.start();
+  Size total = 0;
+  for (const String& p : peptides)
+  {
+    total += AASequence::fromString(p).size();
+  }
+  sw.stop();
+  std::cout << "parsed " << peptides.size() << " peptides in " << sw.getClockTime() << " s" << std::endl;
+
+  // the same through the pool (the peptides above repeat, as in PSM lists)
+  AASequencePool pool;
+  sw.reset();
+  sw.start();
+  Size total_pooled = 0;
+  for (const String& p : peptides)
+  {
+    total_pooled += pool.intern(p)->size();
+  }
+  sw.stop();
+  std::cout << "interned " << peptides.size() << " peptides (" << pool.size() << " distinct) in "
+            << sw.getClockTime() << " s" << std::endl;
+
+  return (total == total_pooled) ? 0 : 1;
+}
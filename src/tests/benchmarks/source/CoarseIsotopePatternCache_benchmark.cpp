@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: CoarseIsotopePatternCache vs. CoarseIsotopePatternGenerator on peptide formulas
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternCache.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  // random tryptic-like peptides
+  const Size nr_peptides = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  const String aas = "ACDEFGHIKLMNPQRSTVWY";
+  std::vector<EmpiricalFormula> formulas;
+  formulas.reserve(nr_peptides);
+  UInt64 seed = 42;
+  for (Size i = 0; i < nr_peptides; ++i)
+  {
+    String seq;
+    Size length = 7 + i % 20;
+    for (Size j = 0; j < length; ++j)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      seq += aas[(seed >> 33) % aas.size()];
+    }
+    seq += (i % 2 == 0) ? "K" : "R";
+    formulas.push_back(AASequence::fromString(seq).getFormula());
+  }
+
+  CoarseIsotopePatternGenerator gen(5);
+  CoarseIsotopePatternCache cache(5);
+
+  StopWatch sw;
+  sw.start();
+  std::vector<IsotopeDistribution> expected(formulas.size());
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    expected[i] = gen.run(formulas[i]);
+  }
+  sw.stop();
+  double time_generator = sw.getClockTime();
+
+  sw.reset();
+  sw.start();
+  std::vector<IsotopeDistribution> result;
+  cache.run(formulas, result);
+  sw.stop();
+  double time_cache = sw.getClockTime();
+
+  std::cout << nr_peptides << " peptides: CoarseIsotopePatternGenerator " << time_generator
+            << " s, CoarseIsotopePatternCache (batch) " << time_cache << " s" << std::endl;
+
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    if (result[i].size() != expected[i].size()) return 1;
+    for (Size k = 0; k < result[i].size(); ++k)
+    {
+      if (result[i].getContainer()[k].getMZ() != expected[i].getContainer()[k].getMZ() ||
+          result[i].getContainer()[k].getIntensity() != expected[i].getContainer()[k].getIntensity())
+      {
+        std::cerr << "Different isotope distribution for peptide " << i << std::endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: EmpiricalFormula arithmetic, cached weights and toString()
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  const Size nr_iterations = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  EmpiricalFormula residue("C5H7NO3");
+  EmpiricalFormula water("H2O");
+  EmpiricalFormula peptide;
+
+  StopWatch sw;
+  sw.start();
+  double weight = 0.0;
+  for (Size i = 0; i < nr_iterations; ++i)
+  {
+    peptide += residue;
+    peptide -= water;
+    weight += peptide.getMonoWeight();
+  }
+  sw.stop();
+  std::cout << 2 * nr_iterations << " formula additions (and weights) in " << sw.getClockTime() << " s" << std::endl;
+
+  sw.reset();
+  sw.start();
+  Size length = 0;
+  for (Size i = 0; i < nr_iterations; ++i)
+  {
+    length += residue.toString().size();
+  }
+  sw.stop();
+  std::cout << nr_iterations << " calls to toString in " << sw.getClockTime() << " s" << std::endl;
+
+  return (weight > 0.0 && length == 8 * nr_iterations) ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: MRMTransitionGroupPicker::pickTransitionGroup with and without 'resample_once'
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/ANALYSIS/OPENSWATH/MRMTransitionGroupPicker.h>
+#include <OpenMS/ANALYSIS/MRM/ReactionMonitoringTransition.h>
+#include <OpenMS/KERNEL/MRMTransitionGroup.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+typedef MRMTransitionGroup<MSChromatogram, ReactionMonitoringTransition> MRMTransitionGroupType;
+
+// transition group with three co-eluting peaks per chromatogram (all sampled at the same RTs)
+void createTransitionGroup(MRMTransitionGroupType& group, Size n_transitions, Size n_points, Size seed)
+{
+  const double apices[] = {60.0, 150.0, 230.0};
+  for (Size t = 0; t < n_transitions; ++t)
+  {
+    ReactionMonitoringTransition transition;
+    transition.setNativeID(String(t));
+    MSChromatogram chromatogram;
+    for (Size k = 0; k < n_points; ++k)
+    {
+      double rt = k * 1.0;
+      double intensity = 3.0 + (k * 7919 + t * 31 + seed) % 5;
+      for (Size p = 0; p < 3; ++p)
+      {
+        double height = 100.0 * (p + 1) * (1.0 + (t + seed) % 4);
+        intensity += height * std::exp(-0.5 * (rt - apices[p]) * (rt - apices[p]) / 16.0);
+      }
+      ChromatogramPeak peak;
+      peak.setRT(rt);
+      peak.setIntensity(intensity);
+      chromatogram.push_back(peak);
+    }
+    chromatogram.setMetaValue("product_mz", 500.0 + t);
+    chromatogram.setNativeID(String(t));
+    group.addChromatogram(chromatogram, chromatogram.getNativeID());
+    group.addTransition(transition, transition.getNativeID());
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  const Size n_groups = (argc > 1) ? std::atol(argv[1]) : 1000;
+  const Size n_transitions = (argc > 2) ? std::atol(argv[2]) : 12;
+  const Size n_points = 300;
+
+  std::vector<MRMTransitionGroupType> groups(n_groups), groups_once(n_groups);
+  for (Size i = 0; i < n_groups; ++i)
+  {
+    createTransitionGroup(groups[i], n_transitions, n_points, i);
+    createTransitionGroup(groups_once[i], n_transitions, n_points, i);
+  }
+
+  MRMTransitionGroupPicker picker;
+  Param param = picker.getDefaults();
+  param.setValue("PeakPickerMRM:signal_to_noise", 1.0);
+  param.setValue("compute_total_mi", "true");
+  picker.setParameters(param);
+
+  StopWatch sw;
+  sw.start();
+  for (Size i = 0; i < n_groups; ++i)
+  {
+    picker.pickTransitionGroup(groups[i]);
+  }
+  sw.stop();
+  std::cout << n_groups << " groups with " << n_transitions << " transitions: " << sw.getClockTime() << " s" << std::endl;
+
+  param.setValue("resample_once", "true");
+  picker.setParameters(param);
+  sw.reset();
+  sw.start();
+  for (Size i = 0; i < n_groups; ++i)
+  {
+    picker.pickTransitionGroup(groups_once[i]);
+  }
+  sw.stop();
+  std::cout << n_groups << " groups with " << n_transitions << " transitions (resample_once): " << sw.getClockTime() << " s" << std::endl;
+
+  // on a common RT grid, both modes give the same features
+  for (Size i = 0; i < n_groups; ++i)
+  {
+    const std::vector<MRMFeature>& features = groups[i].getFeatures();
+    const std::vector<MRMFeature>& features_once = groups_once[i].getFeatures();
+    if (features.size() != features_once.size()) return 1;
+    for (Size j = 0; j < features.size(); ++j)
+    {
+      if (std::fabs(features[j].getRT() - features_once[j].getRT()) > 1e-6 ||
+          std::fabs(features[j].getIntensity() - features_once[j].getIntensity()) > 1e-6 * features[j].getIntensity())
+      {
+        std::cerr << "Different feature " << j << " in group " << i << std::endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: MSNumpress encoding and decoding (linear, pic, slof)
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+// Usage: MSNumpressCoder_benchmark [repeats] [mzML file]; without a file, synthetic spectra are used.
+
+#include <OpenMS/FORMAT/MSNumpressCoder.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  const Size repeats = (argc > 1) ? std::atol(argv[1]) : 100;
+  std::vector<std::vector<double> > mz_arrays, int_arrays;
+  if (argc > 2)
+  {
+    PeakMap exp;
+    MzMLFile().load(argv[2], exp);
+    for (Size i = 0; i < exp.size(); ++i)
+    {
+      std::vector<double> mz, intensity;
+      for (Size j = 0; j < exp[i].size(); ++j)
+      {
+        mz.push_back(exp[i][j].getMZ());
+        intensity.push_back(exp[i][j].getIntensity());
+      }
+      mz_arrays.push_back(mz);
+      int_arrays.push_back(intensity);
+    }
+  }
+  else
+  {
+    // profile-like spectra: regular m/z spacing, smooth intensities with noise
+    UInt64 seed = 42;
+    for (Size i = 0; i < 100; ++i)
+    {
+      std::vector<double> mz, intensity;
+      for (Size j = 0; j < 20000; ++j)
+      {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        mz.push_back(300.0 + j * 0.0625 + (seed >> 54) * 1e-7);
+        intensity.push_back(1e4 * std::fabs(std::sin(j * 0.01)) + (seed >> 50));
+      }
+      mz_arrays.push_back(mz);
+      int_arrays.push_back(intensity);
+    }
+  }
+
+  MSNumpressCoder::NumpressCompression compressions[] = {MSNumpressCoder::LINEAR, MSNumpressCoder::PIC, MSNumpressCoder::SLOF};
+  for (Size c = 0; c < 3; ++c)
+  {
+    MSNumpressCoder::NumpressConfig config;
+    config.np_compression = compressions[c];
+    config.estimate_fixed_point = true;
+    config.numpressErrorTolerance = -1.0; // skip check, as when writing files
+    const std::vector<std::vector<double> >& arrays = (compressions[c] == MSNumpressCoder::LINEAR) ? mz_arrays : int_arrays;
+
+    double mbytes = 0;
+    double time_encode = 0, time_decode = 0;
+    std::vector<double> decoded;
+    for (Size a = 0; a < arrays.size(); ++a)
+    {
+      String raw;
+      StopWatch sw;
+      sw.start();
+      for (Size r = 0; r < repeats; ++r)
+      {
+        raw.clear();
+        MSNumpressCoder().encodeNPRaw(arrays[a], raw, config);
+      }
+      sw.stop();
+      time_encode += sw.getClockTime();
+
+      sw.reset();
+      sw.start();
+      for (Size r = 0; r < repeats; ++r)
+      {
+        MSNumpressCoder().decodeNPRaw(reinterpret_cast<const unsigned char*>(raw.c_str()), raw.size(), decoded, config);
+      }
+      sw.stop();
+      time_decode += sw.getClockTime();
+      mbytes += repeats * arrays[a].size() * sizeof(double) / (1024.0 * 1024.0);
+      if (decoded.size() != arrays[a].size()) return 1;
+    }
+    std::cout << MSNumpressCoder::NamesOfNumpressCompression[compressions[c]] << ": encode " << mbytes / time_encode
+              << " MiB/s, decode " << mbytes / time_decode << " MiB/s" << std::endl;
+  }
+  return 0;
+}
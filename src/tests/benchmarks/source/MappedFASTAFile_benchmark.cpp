@@ -0,0 +1,93 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: MappedFASTAFile vs. FASTAFile
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+// Usage: MappedFASTAFile_benchmark [number of proteins | FASTA file]
+
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  String filename;
+  if (argc > 1 && File::exists(argv[1]))
+  {
+    filename = argv[1];
+  }
+  else
+  {
+    const Size nr_proteins = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    std::vector<FASTAFile::FASTAEntry> proteins;
+    const String aa = "ACDEFGHIKLMNPQRSTVWY";
+    Size seed = 1;
+    for (Size i = 0; i < nr_proteins; ++i)
+    {
+      String sequence(150 + i % 700, 'A');
+      for (Size j = 0; j < sequence.size(); ++j)
+      {
+        seed = seed * 1103515245 + 12345;
+        sequence[j] = aa[(seed >> 16) % aa.size()];
+      }
+      proteins.push_back(FASTAFile::FASTAEntry("sp|P" + String(i) + "|PROT_" + String(i), "protein number " + String(i), sequence));
+    }
+    filename = File::getTemporaryFile() + ".fasta";
+    FASTAFile().store(filename, proteins);
+  }
+
+  StopWatch sw;
+  sw.start();
+  std::vector<FASTAFile::FASTAEntry> data;
+  FASTAFile().load(filename, data);
+  sw.stop();
+  double time_stream = sw.getClockTime();
+
+  sw.reset();
+  sw.start();
+  MappedFASTAFile f(filename);
+  std::vector<FASTAFile::FASTAEntry> entries;
+  f.getEntries(0, f.size(), entries);
+  sw.stop();
+  double time_mapped = sw.getClockTime();
+
+  std::cout << data.size() << " proteins: FASTAFile::load " << time_stream << " s, MappedFASTAFile " << time_mapped << " s" << std::endl;
+  return (entries == data) ? 0 : 1;
+}
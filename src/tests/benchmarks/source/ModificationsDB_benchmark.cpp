@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: concurrent name lookups in ModificationsDB and ResidueDB
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+// Run with OMP_NUM_THREADS set to compare different numbers of threads.
+
+#include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  const int nr_iterations = (argc > 1) ? std::atoi(argv[1]) : 2000000;
+  const char* names[] = {"Oxidation", "Phospho", "Carbamidomethyl", "Acetyl", "Deamidated", "UniMod:35", "unimod:21", "Oxidation (M)"};
+  const char* mod_residues[] = {"M", "S", "C", "K", "N", "M", "T", "M"};
+  const int nr_names = 8;
+  const char* mods[] = {"Oxidation (M)", "Carbamidomethyl (C)", "Phospho (S)", "Phospho (T)", "Phospho (Y)", "Deamidated (N)", "Acetyl (K)", "Methyl (R)"};
+  const char* residues[] = {"M", "C", "S", "T", "Y", "N", "K", "R"};
+  const int nr_mods = 8;
+
+  ModificationsDB* mdb = ModificationsDB::getInstance();
+  ResidueDB* rdb = ResidueDB::getInstance();
+  std::vector<const ResidueModification*> expected;
+  for (int i = 0; i < nr_names; ++i)
+  {
+    expected.push_back(mdb->getModification(names[i], mod_residues[i]));
+  }
+
+  // modification lookups (with an insertion every 10000th iteration)
+  int nr_wrong(0);
+  StopWatch sw;
+  sw.start();
+#pragma omp parallel for reduction (+: nr_wrong)
+  for (int k = 0; k < nr_iterations; ++k)
+  {
+    int i = k % nr_names;
+    if (mdb->getModification(names[i], mod_residues[i]) != expected[i]) ++nr_wrong;
+    if (!mdb->has(names[i])) ++nr_wrong;
+    if (k % 10000 == 0)
+    {
+      ResidueModification* new_mod = new ResidueModification();
+      new_mod->setFullId("benchmark_mod_" + String(k));
+      new_mod->setDiffMonoMass(0.001 * k);
+      mdb->addModification(new_mod);
+    }
+  }
+  sw.stop();
+  std::cout << nr_iterations << " concurrent modification lookups (with " << nr_iterations / 10000
+            << " insertions): " << sw.getClockTime() << " s" << std::endl;
+
+  // (modified) residue lookups
+  sw.reset();
+  sw.start();
+#pragma omp parallel for reduction (+: nr_wrong)
+  for (int k = 0; k < nr_iterations; ++k)
+  {
+    int i = k % nr_mods;
+    const Residue* residue = rdb->getResidue(residues[i]);
+    const Residue* mod_res = rdb->getModifiedResidue(residue, mods[i]);
+    if (mod_res->getOneLetterCode() != residues[i] || !mod_res->isModified()) ++nr_wrong;
+    if (!rdb->hasResidue(residue->getName())) ++nr_wrong;
+  }
+  sw.stop();
+  std::cout << nr_iterations << " concurrent modified residue lookups: " << sw.getClockTime() << " s" << std::endl;
+
+  return (nr_wrong == 0) ? 0 : 1;
+}
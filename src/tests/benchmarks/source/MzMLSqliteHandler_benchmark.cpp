@@ -0,0 +1,103 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: direct vs. pipelined writing of chromatograms to sqMass
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+using namespace OpenMS::Internal;
+
+// writes @p chroms in batches as MSDataSqlConsumer does and returns the time in seconds
+double writeChromatograms(const std::vector<MSChromatogram>& chroms, bool lossy, bool pipelined, Size& nr_written)
+{
+  String filename = File::getTemporaryFile();
+  MzMLSqliteHandler handler(filename);
+  handler.setConfig(false, lossy, 0.0001, 500);
+  handler.createTables();
+  StopWatch sw;
+  sw.start();
+  if (pipelined) handler.startPipelinedWriting();
+  for (Size i = 0; i < chroms.size(); i += 250)
+  {
+    handler.writeChromatograms(std::vector<MSChromatogram>(chroms.begin() + i, chroms.begin() + std::min(i + 250, chroms.size())));
+  }
+  if (pipelined) handler.finishPipelinedWriting();
+  sw.stop();
+  nr_written = handler.getNrChromatograms();
+  return sw.getClockTime();
+}
+
+int main(int argc, const char** argv)
+{
+  const Size nr_chromatograms = (argc > 1) ? std::atol(argv[1]) : 100000;
+  const Size nr_points = 400;
+  std::vector<MSChromatogram> chroms(nr_chromatograms);
+  UInt64 seed = 42;
+  for (Size i = 0; i < nr_chromatograms; ++i)
+  {
+    chroms[i].setNativeID(String(i));
+    chroms[i].getPrecursor().setMZ(400.0 + i * 0.01);
+    chroms[i].getProduct().setMZ(200.0 + i * 0.02);
+    for (Size j = 0; j < nr_points; ++j)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      ChromatogramPeak p;
+      p.setRT(j * 3.4);
+      p.setIntensity(1000.0 * std::exp(-0.001 * (j - 200.0) * (j - 200.0)) + (seed >> 44));
+      chroms[i].push_back(p);
+    }
+  }
+  const double mbytes = nr_chromatograms * nr_points * 2 * sizeof(double) / (1024.0 * 1024.0);
+
+  for (Size lossy = 0; lossy < 2; ++lossy)
+  {
+    Size nr_direct(0), nr_pipelined(0);
+    double time_direct = writeChromatograms(chroms, lossy == 1, false, nr_direct);
+    double time_pipelined = writeChromatograms(chroms, lossy == 1, true, nr_pipelined);
+    std::cout << (lossy ? "numpress: " : "zlib: ") << mbytes << " MiB, direct " << mbytes / time_direct
+              << " MiB/s, pipelined " << mbytes / time_pipelined << " MiB/s" << std::endl;
+    if (nr_direct != nr_chromatograms || nr_pipelined != nr_chromatograms) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: multi-run peptide and protein quantification with PeptideAndProteinQuant
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/METADATA/ExperimentalDesign.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  const Size n_peptides = (argc > 1) ? std::atol(argv[1]) : 200000;
+  const Size n_samples = (argc > 2) ? std::atol(argv[2]) : 50;
+
+  ConsensusMap consensus;
+  consensus.setExperimentType("label-free");
+  for (Size j = 0; j < n_samples; ++j)
+  {
+    consensus.getColumnHeaders()[j].filename = "sample" + String(j + 1) + ".mzML";
+  }
+  for (Size i = 0; i < n_peptides; ++i)
+  {
+    String seq = "PEPTIDE" + String(i) + "K";
+    seq.substitute("0", "A").substitute("1", "C").substitute("2", "D").substitute("3", "E").substitute("4", "F");
+    seq.substitute("5", "G").substitute("6", "H").substitute("7", "I").substitute("8", "L").substitute("9", "M");
+    PeptideHit hit;
+    hit.setSequence(AASequence::fromString(seq));
+    hit.setCharge(2 + i % 2);
+    PeptideEvidence evidence;
+    evidence.setProteinAccession("PROT" + String(i / 10));
+    hit.addPeptideEvidence(evidence);
+    PeptideIdentification peptide;
+    peptide.insertHit(hit);
+
+    ConsensusFeature feature;
+    feature.getPeptideIdentifications().push_back(peptide);
+    for (Size j = 0; j < n_samples; ++j)
+    {
+      if ((i + j) % 7 == 0) continue; // not quantified in this sample
+      FeatureHandle handle;
+      handle.setMapIndex(j);
+      handle.setUniqueId(i * n_samples + j + 1);
+      handle.setIntensity(double((i * 31 + j * 17) % 10000 + 1));
+      feature.insert(handle);
+    }
+    consensus.push_back(feature);
+  }
+  ExperimentalDesign design = ExperimentalDesign::fromConsensusMap(consensus);
+
+  PeptideAndProteinQuant quantifier;
+  StopWatch sw;
+  sw.start();
+  quantifier.readQuantData(consensus, design);
+  quantifier.quantifyPeptides();
+  quantifier.quantifyProteins();
+  sw.stop();
+  std::cout << "quantified " << n_peptides << " peptides in " << n_samples
+            << " samples: " << sw.getClockTime() << " s" << std::endl;
+
+  bool ok = (quantifier.getStatistics().quant_peptides == n_peptides) &&
+            (quantifier.getProteinResults().size() == (n_peptides + 9) / 10);
+  return ok ? 0 : 1;
+}
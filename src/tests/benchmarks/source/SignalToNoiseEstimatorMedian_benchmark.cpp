@@ -0,0 +1,97 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+// Benchmark: exact vs. histogram median in SignalToNoiseEstimatorMedian
+// (not part of the test suite; see src/tests/benchmarks/CMakeLists.txt)
+
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace OpenMS;
+
+int main(int argc, const char** argv)
+{
+  // long synthetic profile spectrum: noise plus a few high peaks
+  const Size nr_peaks = (argc > 1) ? std::atol(argv[1]) : 200000;
+  MSSpectrum spec;
+  for (Size i = 0; i < nr_peaks; ++i)
+  {
+    Peak1D peak;
+    peak.setMZ(200.0 + i * 0.01);
+    peak.setIntensity(100.0 + (i * 7919) % 997 + ((i % 5000) == 0 ? 1e6 : 0.0));
+    spec.push_back(peak);
+  }
+
+  Param p;
+  p.setValue("win_len", 20.0);
+  p.setValue("write_log_messages", "false");
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne_hist;
+  sne_hist.setParameters(p);
+  StopWatch sw;
+  sw.start();
+  sne_hist.init(spec);
+  sw.stop();
+  double time_hist = sw.getClockTime();
+
+  p.setValue("median_method", "exact");
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne_exact;
+  sne_exact.setParameters(p);
+  sw.reset();
+  sw.start();
+  sne_exact.init(spec);
+  sw.stop();
+  double time_exact = sw.getClockTime();
+
+  // relative deviation of the histogram estimate from the exact one
+  double max_rel_dev(0), sum_rel_dev(0);
+  for (MSSpectrum::const_iterator it = spec.begin(); it != spec.end(); ++it)
+  {
+    double exact = sne_exact.getSignalToNoise(it);
+    double rel_dev = std::fabs(sne_hist.getSignalToNoise(it) - exact) / exact;
+    max_rel_dev = std::max(max_rel_dev, rel_dev);
+    sum_rel_dev += rel_dev;
+  }
+  std::cout << nr_peaks << " peaks: histogram median " << time_hist << " s, exact median " << time_exact << " s\n"
+            << "relative deviation of histogram S/N: mean " << sum_rel_dev / spec.size() << ", max " << max_rel_dev << std::endl;
+
+  // noise is ~600 everywhere, the histogram estimate is within its bin width
+  return (max_rel_dev < 0.5) ? 0 : 1;
+}
@@ -53,6 +53,7 @@ set(datastructures_executables_list
   OPXLDataStructs_test
   Param_test
   QTCluster_test
+  ReadMostlyHashMap_test
   RangeManager_test
   StringListUtils_test
   StringUtils_test
@@ -188,6 +189,7 @@ set(format_executables_list
   MascotInfile_test
   MascotRemoteQuery_test
   MascotXMLFile_test
+  MappedFASTAFile_test
   #MSDataWritingConsumer_test
   MRMFeaturePickerFile_test
   MsInspectFile_test
@@ -220,6 +222,7 @@ set(format_executables_list
   PepXMLFile_test
   PercolatorOutfile_test
   ProtXMLFile_test
+  ReadAheadDecompressor_test
   SVOutStream_test
   SemanticValidator_test
   SequestInfile_test
@@ -245,7 +248,10 @@ set(format_executables_list
   # DATAACCESS
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
+  MSDataParallelTransformingConsumer_test
+  MSDataSpectraMergingConsumer_test
   MSDataChainingConsumer_test
+  MSDataChannelExtractingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
   SpectrumAccessQuadMZTransforming_test
@@ -297,6 +303,7 @@ set(filtering_executables_list
   GaussFilterAlgorithm_test
   GoodDiffFilter_test
   IDFilter_test
+  ProteinAccessionIndex_test
   IntensityBalanceFilter_test
   InternalCalibration_test
   IsotopeDiffFilter_test
@@ -370,7 +377,9 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  AASequencePool_test
   CoarseIsotopeDistribution_test
+  CoarseIsotopePatternCache_test
   CrossLinksDB_test
   DigestionEnzymeProtein_test
   ElementDB_test
@@ -461,6 +470,7 @@ set(analysis_executables_list
   FeatureHandle_test
   HiddenMarkovModel_test
   IDBoostGraph_test
+  IDCompactGraph_test
   IDMapper_test
   IDMergerAlgorithm_test
   IDRipper_test
@@ -635,6 +645,7 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathHelper_test
     OpenSwathScoring_test
     OpenSwathScores_test
+    OpenSwathOSWWriter_test
     PeakIntegrator_test
     PeakPickerMRM_test
     MRMTransitionGroupPicker_test
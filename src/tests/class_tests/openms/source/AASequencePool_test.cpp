@@ -0,0 +1,144 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/AASequencePool.h>
+#include <OpenMS/METADATA/PeptideHit.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AASequencePool, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AASequencePool* ptr = nullptr;
+AASequencePool* null_ptr = nullptr;
+START_SECTION(AASequencePool())
+{
+  ptr = new AASequencePool();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(virtual ~AASequencePool())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((const SharedSequence& intern(const String& sequence, bool permissive = true)))
+{
+  AASequencePool pool;
+  AASequencePool::SharedSequence s1 = pool.intern("PEPM(Oxidation)TIDE");
+  AASequencePool::SharedSequence s2 = pool.intern("PEPTIDE");
+  AASequencePool::SharedSequence s3 = pool.intern("PEPM(Oxidation)TIDE");
+  TEST_EQUAL(pool.size(), 2)
+  TEST_EQUAL(s1 == s3, true)
+  TEST_EQUAL(s1 == s2, false)
+  TEST_EQUAL(*s1, AASequence::fromString("PEPM(Oxidation)TIDE"))
+  TEST_EQUAL(*s2, AASequence::fromString("PEPTIDE"))
+
+  TEST_EXCEPTION(Exception::ParseError, pool.intern("PEP(TIDE"))
+  TEST_EQUAL(pool.size(), 2)
+
+  // strict parsing is not skipped for strings interned permissively before
+  AASequencePool::SharedSequence s4 = pool.intern("PEP TIDE");
+  TEST_EQUAL(*s4, AASequence::fromString("PEPTIDE"))
+  TEST_EXCEPTION(Exception::ParseError, pool.intern("PEP TIDE", false))
+  TEST_EQUAL(pool.size(), 3)
+  // valid sequences share the instance in both modes
+  TEST_EQUAL(pool.intern("PEPTIDE", false) == s2, true)
+  TEST_EQUAL(pool.intern("PEPTIDE", false) == s2, true)
+  TEST_EQUAL(pool.size(), 4)
+}
+END_SECTION
+
+START_SECTION((const SharedSequence& intern(const AASequence& sequence)))
+{
+  AASequencePool pool;
+  AASequence seq = AASequence::fromString("PEPTIDEK");
+  AASequencePool::SharedSequence s1 = pool.intern(seq);
+  AASequencePool::SharedSequence s2 = pool.intern(AASequence::fromString("PEPTIDEK"));
+  AASequencePool::SharedSequence s3 = pool.intern("PEPTIDEK");
+  TEST_EQUAL(pool.size(), 1)
+  TEST_EQUAL(s1 == s2, true)
+  TEST_EQUAL(s1 == s3, true)
+  TEST_EQUAL(*s1, seq)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  AASequencePool pool;
+  AASequencePool::SharedSequence s1 = pool.intern("PEPTIDE");
+  pool.clear();
+  TEST_EQUAL(pool.size(), 0)
+  // handed out sequences stay valid
+  TEST_EQUAL(*s1, AASequence::fromString("PEPTIDE"))
+  TEST_EQUAL(pool.intern("PEPTIDE") == s1, false)
+}
+END_SECTION
+
+START_SECTION([EXTRA] sharing sequences between peptide hits)
+{
+  AASequencePool pool;
+  vector<PeptideHit> hits(100);
+  for (Size i = 0; i < hits.size(); ++i)
+  {
+    hits[i].setSequence(pool.intern(i % 2 == 0 ? "PEPTIDER" : "PEPM(Oxidation)TIDEK"));
+  }
+  TEST_EQUAL(pool.size(), 2)
+  TEST_EQUAL(&hits[0].getSequence() == &hits[98].getSequence(), true)
+  TEST_EQUAL(&hits[1].getSequence() == &hits[99].getSequence(), true)
+  TEST_EQUAL(hits[1].getSequence().toString(), "PEPM(Oxidation)TIDEK")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
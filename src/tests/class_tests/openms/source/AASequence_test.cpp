@@ -1451,6 +1451,63 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION([EXTRA] repeated modification tokens (parsing cache))
+{
+  // the same token in different contexts must not be confused by the cache
+  for (Size i = 0; i < 2; ++i)
+  {
+    AASequence seq1 = AASequence::fromString("PEPM(Oxidation)TIDEK");
+    AASequence seq2 = AASequence::fromString("(Acetyl)PEPM(Oxidation)TIDEK");
+    AASequence seq3 = AASequence::fromString(".(Acetyl)PEPTIDEK.");
+    AASequence seq4 = AASequence::fromString("PEPTIDEK.(Amidated)");
+    AASequence seq5 = AASequence::fromString("PEPTIDEM[147]");
+    AASequence seq6 = AASequence::fromString("M[147]PEPTIDEM[147]K");
+    AASequence seq7 = AASequence::fromString("PEPTIDEK");
+
+    TEST_EQUAL(seq1.isModified(), true)
+    TEST_STRING_EQUAL(seq1[3].getModificationName(), "Oxidation")
+    TEST_EQUAL(seq1.hasNTerminalModification(), false)
+    TEST_STRING_EQUAL(seq2.getNTerminalModificationName(), "Acetyl")
+    TEST_STRING_EQUAL(seq2[3].getModificationName(), "Oxidation")
+    TEST_STRING_EQUAL(seq3.getNTerminalModificationName(), "Acetyl")
+    TEST_EQUAL(seq3[0].isModified(), false)
+    TEST_STRING_EQUAL(seq4.getCTerminalModificationName(), "Amidated")
+    TEST_EQUAL(seq4[7].isModified(), false)
+    TEST_STRING_EQUAL(seq5[6].getModificationName(), "Oxidation")
+    TEST_EQUAL(seq5.hasCTerminalModification(), false)
+    TEST_STRING_EQUAL(seq6[0].getModificationName(), "Oxidation")
+    TEST_STRING_EQUAL(seq6[7].getModificationName(), "Oxidation")
+    TEST_EQUAL(seq7.isModified(), false)
+    TEST_EQUAL(seq7.size(), 8)
+  }
+
+  // invalid input is still reported every time
+  TEST_EXCEPTION(Exception::ParseError, AASequence::fromString("PEPM(Oxidation"))
+  TEST_EXCEPTION(Exception::InvalidValue, AASequence::fromString("PEPM(NoSuchModification)K"))
+  TEST_EXCEPTION(Exception::InvalidValue, AASequence::fromString("PEPM(NoSuchModification)K"))
+}
+END_SECTION
+
+START_SECTION(static void clearModificationCache())
+{
+  AASequence seq1 = AASequence::fromString("PEPM(Oxidation)TIDEK");
+  AASequence::clearModificationCache();
+  AASequence seq2 = AASequence::fromString("PEPM(Oxidation)TIDEK");
+  TEST_EQUAL(seq1 == seq2, true)
+  TEST_STRING_EQUAL(seq2[3].getModificationName(), "Oxidation")
+
+  // distinct mass tags are cached independently
+  for (Size i = 1; i <= 20; ++i)
+  {
+    AASequence seq = AASequence::fromString("PEPTIDEK[+" + String(i) + ".5]");
+    TEST_REAL_SIMILAR(seq[7].getModification()->getDiffMonoMass(), i + 0.5)
+  }
+  AASequence::clearModificationCache();
+  AASequence seq3 = AASequence::fromString("PEPTIDEK[+3.5]");
+  TEST_REAL_SIMILAR(seq3[7].getModification()->getDiffMonoMass(), 3.5)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
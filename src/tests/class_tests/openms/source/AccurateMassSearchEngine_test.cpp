@@ -43,6 +43,8 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/MzTab.h>
 #include <OpenMS/FORMAT/MzTabFile.h>
+#include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/KERNEL/ConsensusFeature.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
@@ -296,6 +298,79 @@ START_SECTION((void queryByConsensusFeature(const ConsensusFeature& cfeat, const
 }
 END_SECTION
 
+START_SECTION((void queryByMZs(const std::vector<double>& observed_mzs, const std::vector<Int>& observed_charges, const String& ion_mode, std::vector<QueryHit>& hits, const std::vector<EmpiricalFormula>& observed_adducts) const))
+{
+  std::vector<AccurateMassSearchEngine::QueryHit> hits;
+  TEST_EXCEPTION(Exception::InvalidParameter, ams_feat_test.queryByMZs(std::vector<double>(1, 399.33486), std::vector<Int>(1, 1), "blabla", hits));
+  TEST_EXCEPTION(Exception::InvalidParameter, ams_feat_test.queryByMZs(std::vector<double>(2, 399.33486), std::vector<Int>(1, 1), "positive", hits));
+
+  // many queries (more than one chunk), unsorted and with mixed charges
+  std::vector<double> mzs;
+  std::vector<Int> charges;
+  for (Size i = 0; i < 3000; ++i)
+  {
+    mzs.push_back(100.0 + (i * 7919 % 3000) * 0.25);
+    charges.push_back(i % 3);
+  }
+  mzs[1234] = 399.33486;
+  charges[1234] = 1;
+  ams_feat_test.queryByMZs(mzs, charges, "positive", hits);
+
+  // brute force: scan the whole database for every query and every adduct
+  std::vector<std::pair<double, String> > db; // (mass, formula), sorted like the DB of the engine
+  TextFile db_file(OPENMS_GET_TEST_DATA_PATH("reducedHMDBMapping.tsv"), true, -1, true);
+  for (TextFile::ConstIterator it = db_file.begin() + 2; it != db_file.end(); ++it) // skip name and version
+  {
+    std::vector<String> fields;
+    it->split('\t', fields);
+    double mass = fields[0].toDouble();
+    if (mass == 0) mass = EmpiricalFormula(fields[1]).getMonoWeight(); // recomputed from the formula, as the engine does
+    db.push_back(std::make_pair(mass, fields[1]));
+  }
+  std::sort(db.begin(), db.end());
+  std::vector<AdductInfo> adducts;
+  TextFile adduct_file(File::find("CHEMISTRY/PositiveAdducts.tsv"), true, -1, true);
+  for (TextFile::ConstIterator it = adduct_file.begin(); it != adduct_file.end(); ++it)
+  {
+    adducts.push_back(AdductInfo::parseAdductString(*it));
+  }
+
+  Size hit_idx(0);
+  bool all_equal(true);
+  std::vector<String> formulas_1234;
+  for (Size i = 0; i < mzs.size(); ++i)
+  {
+    for (Size a = 0; a < adducts.size(); ++a)
+    {
+      if (charges[i] != 0 && std::abs(charges[i]) != std::abs(adducts[a].getCharge())) continue;
+      double query_mass = adducts[a].getNeutralMass(mzs[i]);
+      double diff_mass = mzs[i] / 1e6 * 5.0 * std::abs(adducts[a].getCharge()); // default: 5 ppm
+      for (Size j = 0; j < db.size(); ++j)
+      {
+        if (db[j].first < query_mass - diff_mass || query_mass + diff_mass < db[j].first) continue;
+        if (!adducts[a].isCompatible(EmpiricalFormula(db[j].second))) continue;
+        if (hit_idx >= hits.size() || hits[hit_idx].query_index != i || hits[hit_idx].adduct_index != a ||
+            hits[hit_idx].db_index != j || hits[hit_idx].query_mass != query_mass)
+        {
+          all_equal = false;
+        }
+        if (i == 1234) formulas_1234.push_back(db[j].second);
+        ++hit_idx;
+      }
+    }
+  }
+  TEST_EQUAL(all_equal, true)
+  TEST_EQUAL(hit_idx, hits.size())
+
+  // same hits as found by queryByFeature() below
+  TEST_EQUAL(formulas_1234.size(), 3)
+  ABORT_IF(formulas_1234.size() != 3)
+  TEST_STRING_EQUAL(formulas_1234[0], "C23H45NO4")
+  TEST_STRING_EQUAL(formulas_1234[1], "C20H37NO3")
+  TEST_STRING_EQUAL(formulas_1234[2], "C22H41NO")
+}
+END_SECTION
+
 FuzzyStringComparator fsc;
 // fsc.setAcceptableAbsolute((3.04011223650013 - 3.04011223637974)*1.1); // 1.3242891228060217e-10
 // also Linux may give slightly different results depending on optimization level (O0 vs O1) 
@@ -0,0 +1,159 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// exact comparison of two distributions
+bool equalDistributions(const IsotopeDistribution& a, const IsotopeDistribution& b)
+{
+  if (a.size() != b.size()) return false;
+  for (Size i = 0; i < a.size(); ++i)
+  {
+    if (a.getContainer()[i].getMZ() != b.getContainer()[i].getMZ() || a.getContainer()[i].getIntensity() != b.getContainer()[i].getIntensity()) return false;
+  }
+  return true;
+}
+
+START_TEST(CoarseIsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CoarseIsotopePatternCache* ptr = nullptr;
+CoarseIsotopePatternCache* null_ptr = nullptr;
+START_SECTION((CoarseIsotopePatternCache(const Size& max_isotope, const bool round_masses = false, const Size max_count = 512, const std::vector<String>& elements = std::vector<String>{"C", "H", "N", "O", "S", "P"})))
+{
+  ptr = new CoarseIsotopePatternCache(5);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getMaxIsotope(), 5)
+  TEST_EQUAL(ptr->getRoundMasses(), false)
+  TEST_EQUAL(ptr->getMaxCount(), 512)
+
+  TEST_EXCEPTION(Exception::ElementNotFound, CoarseIsotopePatternCache(5, false, 10, std::vector<String>(1, "Xx")))
+}
+END_SECTION
+
+START_SECTION((~CoarseIsotopePatternCache()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((IsotopeDistribution run(const EmpiricalFormula& formula) const))
+{
+  // identical to the generator, for cached and uncached elements and counts
+  std::vector<String> formulas = {"C6H12O6", "C100H202", "C1", "H1", "CH4", "C600H1200N100O150S3", "C2H6Br2Se", "C20H30O5S2P", "(13)C2H6"};
+  for (Size max_isotope : {1, 3, 10, 0})
+  {
+    CoarseIsotopePatternGenerator gen(max_isotope);
+    CoarseIsotopePatternCache cache(max_isotope, false, 300);
+    for (const String& f : formulas)
+    {
+      EmpiricalFormula ef(f);
+      TEST_EQUAL(equalDistributions(cache.run(ef), gen.run(ef)), true)
+      TEST_EQUAL(equalDistributions(ef.getIsotopeDistribution(cache), gen.run(ef)), true)
+    }
+  }
+
+  // rounded masses
+  CoarseIsotopePatternGenerator gen(4, true);
+  CoarseIsotopePatternCache cache(4, true);
+  EmpiricalFormula ef("C50H80N10O12S");
+  TEST_EQUAL(equalDistributions(cache.run(ef), gen.run(ef)), true)
+
+  // changing the maximal isotope afterwards does not use the tables anymore
+  cache.setMaxIsotope(7);
+  gen.setMaxIsotope(7);
+  TEST_EQUAL(cache.run(ef).size(), 7)
+  TEST_EQUAL(equalDistributions(cache.run(ef), gen.run(ef)), true)
+}
+END_SECTION
+
+START_SECTION((void run(const std::vector<EmpiricalFormula>& formulas, std::vector<IsotopeDistribution>& result) const))
+{
+  std::vector<EmpiricalFormula> formulas;
+  for (Size i = 1; i < 200; ++i)
+  {
+    formulas.push_back(EmpiricalFormula("C" + String(i) + "H" + String(2 * i + 2) + "N" + String(i / 5) + "O" + String(i / 3) + "S" + String(i % 3)));
+  }
+  CoarseIsotopePatternGenerator gen(6);
+  CoarseIsotopePatternCache cache(6);
+  std::vector<IsotopeDistribution> result;
+  cache.run(formulas, result);
+  TEST_EQUAL(result.size(), formulas.size())
+  bool all_equal = true;
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    if (!equalDistributions(result[i], gen.run(formulas[i]))) all_equal = false;
+  }
+  TEST_EQUAL(all_equal, true)
+}
+END_SECTION
+
+START_SECTION((void estimateFromPeptideWeight(const std::vector<double>& average_weights, std::vector<IsotopeDistribution>& result)))
+{
+  std::vector<double> weights;
+  for (double w = 100.0; w < 10000.0; w += 37.3)
+  {
+    weights.push_back(w);
+  }
+  CoarseIsotopePatternGenerator gen(5);
+  CoarseIsotopePatternCache cache(5);
+  std::vector<IsotopeDistribution> result;
+  cache.estimateFromPeptideWeight(weights, result);
+  TEST_EQUAL(result.size(), weights.size())
+  bool all_equal = true;
+  for (Size i = 0; i < weights.size(); ++i)
+  {
+    if (!equalDistributions(result[i], gen.estimateFromPeptideWeight(weights[i]))) all_equal = false;
+    if (!equalDistributions(result[i], cache.estimateFromPeptideWeight(weights[i]))) all_equal = false;
+  }
+  TEST_EQUAL(all_equal, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
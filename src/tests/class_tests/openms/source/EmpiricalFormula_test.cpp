@@ -606,6 +606,40 @@ START_SECTION(([EXTRA] Check correct charge semantics))
   TEST_EQUAL(ef11.getCharge(), 3)
 END_SECTION
 
+START_SECTION(([EXTRA] Common and rare elements))
+  // Fe, Na and isotopes are not stored in the dense array
+  EmpiricalFormula ef("C5(13)C4H2NaFe2+");
+  TEST_EQUAL(ef.getNumberOf(db->getElement("C")), 5)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("(13)C")), 4)
+  TEST_EQUAL(ef.getNumberOf(db->getElement("Fe")), 2)
+  TEST_EQUAL(ef.getNumberOfAtoms(), 14)
+  TEST_EQUAL(ef.toString(), "(13)C4C5Fe2H2Na1")
+  TEST_EQUAL(std::distance(ef.begin(), ef.end()), 5)
+
+  double mono = Constants::PROTON_MASS_U;
+  double avg = Constants::PROTON_MASS_U;
+  for (EmpiricalFormula::ConstIterator it = ef.begin(); it != ef.end(); ++it)
+  {
+    mono += it->first->getMonoWeight() * it->second;
+    avg += it->first->getAverageWeight() * it->second;
+  }
+  TEST_REAL_SIMILAR(ef.getMonoWeight(), mono)
+  TEST_REAL_SIMILAR(ef.getAverageWeight(), avg)
+
+  // cached weights follow the arithmetic
+  EmpiricalFormula sum = ef + EmpiricalFormula("H2O") - EmpiricalFormula("Fe");
+  TEST_REAL_SIMILAR(sum.getMonoWeight(), EmpiricalFormula("C5(13)C4H4ONaFe+").getMonoWeight())
+  TEST_EQUAL(sum == EmpiricalFormula("C5(13)C4H4ONaFe+"), true)
+
+  // zero counts are not stored
+  EmpiricalFormula diff = ef - ef;
+  TEST_EQUAL(diff.isEmpty(), true)
+  TEST_EQUAL(diff == ef_empty, true)
+  TEST_EQUAL(diff.hasElement(db->getElement("Fe")), false)
+  TEST_EQUAL((ef * 0).isEmpty(), true)
+  TEST_EQUAL(EmpiricalFormula(0, db->getElement("Na")).isEmpty(), true)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -49,6 +49,7 @@ START_TEST(FASTAContainer, "$Id$")
 
 typedef FASTAContainer<TFI_Vector> FCVec;
 typedef FASTAContainer<TFI_File> FCFile;
+typedef FASTAContainer<TFI_Mapped> FCMapped;
 
 FCVec* ptr = nullptr;
 FCVec* nullPointer = nullptr;
@@ -132,6 +133,10 @@ START_SECTION(bool empty() const)
   TEST_EQUAL(f.empty(), false)
   FCFile f2(OPENMS_GET_TEST_DATA_PATH("degenerate_cases/empty.fasta"));
   TEST_EQUAL(f2.empty(), true)
+  FCMapped fm(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(fm.empty(), false)
+  FCMapped fm2(OPENMS_GET_TEST_DATA_PATH("degenerate_cases/empty.fasta"));
+  TEST_EQUAL(fm2.empty(), true)
   FCVec fv(fev);
   TEST_EQUAL(fv.empty(), false);
   std::vector<FASTAFile::FASTAEntry> feve;
@@ -219,6 +224,59 @@ START_SECTION(size_t size() const)
   TEST_EQUAL(pe6.description, "This is the description of the second protein")
 
 END_SECTION
+
+START_SECTION([EXTRA] FASTAContainer<TFI_Mapped>)
+  FCFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  FCMapped fm(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(fm.size(), 0)
+  TEST_EQUAL(fm.getChunkOffset(), 0)
+  FASTAFile::FASTAEntry pe, pe2;
+  TEST_EXCEPTION(Exception::IndexOverflow, fm.readAt(pe, 0))
+
+  // same chunks as the file-based container
+  Size chunk_sizes[] = {2, 1, 3};
+  Size expected_sizes[] = {2, 1, 2};
+  for (Size c = 0; c < 3; ++c)
+  {
+    TEST_EQUAL(f.cacheChunk(chunk_sizes[c]), true)
+    TEST_EQUAL(fm.cacheChunk(chunk_sizes[c]), true)
+    TEST_EQUAL(fm.size(), f.size())
+    TEST_EQUAL(f.activateCache(), true)
+    TEST_EQUAL(fm.activateCache(), true)
+    TEST_EQUAL(fm.getChunkOffset(), f.getChunkOffset())
+    TEST_EQUAL(fm.chunkSize(), expected_sizes[c])
+    for (Size i = 0; i < fm.chunkSize(); ++i)
+    {
+      TEST_EQUAL(fm.chunkAt(i) == f.chunkAt(i), true)
+    }
+  }
+  TEST_EQUAL(fm.chunkAt(1).description, " ##0")
+
+  // reached the end after 5 entries
+  TEST_EQUAL(fm.cacheChunk(3), false)
+  TEST_EQUAL(fm.chunkSize(), 2)
+  TEST_EQUAL(fm.activateCache(), false)
+  TEST_EQUAL(fm.chunkSize(), 0)
+  TEST_EQUAL(fm.size(), 5)
+
+  // random access to earlier entries
+  for (Size i = 0; i < 5; ++i)
+  {
+    TEST_EQUAL(fm.readAt(pe, i), true)
+    TEST_EQUAL(f.readAt(pe2, i), true)
+    TEST_EQUAL(pe == pe2, true)
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, fm.readAt(pe, 5))
+
+  // read, then reset and start reading again
+  fm.reset();
+  TEST_EQUAL(fm.size(), 0)
+  TEST_EQUAL(fm.cacheChunk(2), true)
+  TEST_EQUAL(fm.activateCache(), true)
+  TEST_EQUAL(fm.getChunkOffset(), 0)
+  TEST_EQUAL(fm.chunkAt(0).identifier, "P68509|1433F_BOVIN")
+  TEST_EQUAL(fm.chunkAt(1).description, "This is the description of the second protein")
+END_SECTION
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -153,6 +153,30 @@ START_SECTION((void load(const String& filename, std::vector< FASTAEntry > &data
 
 END_SECTION
 
+START_SECTION([EXTRA] compressed files)
+  vector<FASTAFile::FASTAEntry> data, data_gz, data_bz2;
+  FASTAFile::load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), data);
+  FASTAFile::load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), data_gz);
+  FASTAFile::load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2"), data_bz2);
+  TEST_EQUAL(data_gz.size(), 5)
+  TEST_EQUAL(data == data_gz, true)
+  TEST_EQUAL(data == data_bz2, true)
+
+  // seeking within the decompressed data
+  FASTAFile file;
+  FASTAFile::FASTAEntry entry;
+  file.readStart(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"));
+  file.readNext(entry);
+  std::streampos second = file.position();
+  file.readNext(entry);
+  TEST_EQUAL(entry == data[1], true)
+  while (file.readNext(entry)) {}
+  TEST_EQUAL(file.atEnd(), true)
+  TEST_EQUAL(file.setPosition(second), true)
+  file.readNext(entry);
+  TEST_EQUAL(entry == data[1], true)
+END_SECTION
+
 START_SECTION((void store(const String& filename, const std::vector< FASTAEntry > &data) const))
   vector<FASTAFile::FASTAEntry> data, data2;
   String tmp_filename;
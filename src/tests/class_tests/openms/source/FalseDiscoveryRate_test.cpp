@@ -235,6 +235,73 @@ START_SECTION((void apply(std::vector<ProteinIdentification>& ids)))
 }
 END_SECTION
 
+START_SECTION((void applyBasic(std::vector<PeptideIdentification> & ids)))
+{
+  // run1: 10 (T), 9 (D), 8 (T), 7 (T); run2: 5 (T), 4 (T)
+  vector<PeptideIdentification> pep_ids;
+  double scores[] = {10.0, 9.0, 8.0, 7.0, 5.0, 4.0};
+  const char* td[] = {"target", "decoy", "target", "target+decoy", "target", "target"};
+  for (Size i = 0; i < 6; ++i)
+  {
+    PeptideIdentification pep_id;
+    pep_id.setIdentifier(i < 4 ? "run1" : "run2");
+    pep_id.setScoreType("test");
+    pep_id.setHigherScoreBetter(true);
+    PeptideHit hit;
+    hit.setScore(scores[i]);
+    hit.setMetaValue("target_decoy", td[i]);
+    pep_id.insertHit(hit);
+    pep_ids.push_back(pep_id);
+  }
+
+  FalseDiscoveryRate fdr;
+  Param p = fdr.getParameters();
+  p.setValue("no_qvalues", "true");
+  fdr.setParameters(p);
+
+  // all runs together, conservative formula (D+1)/(T+1)
+  vector<PeptideIdentification> ids = pep_ids;
+  fdr.applyBasic(ids);
+  double expected[] = {0.5, 1.0, 2.0 / 3.0, 0.5, 0.4, 1.0 / 3.0};
+  for (Size i = 0; i < 6; ++i)
+  {
+    TEST_EQUAL(ids[i].getScoreType(), "FDR")
+    TEST_EQUAL(ids[i].isHigherScoreBetter(), false)
+    TEST_REAL_SIMILAR(ids[i].getHits()[0].getScore(), expected[i])
+    TEST_REAL_SIMILAR((double)ids[i].getHits()[0].getMetaValue("test_score"), scores[i])
+  }
+
+  // q-values
+  p.setValue("no_qvalues", "false");
+  fdr.setParameters(p);
+  ids = pep_ids;
+  fdr.applyBasic(ids);
+  double expected_q[] = {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0};
+  for (Size i = 0; i < 6; ++i)
+  {
+    TEST_EQUAL(ids[i].getScoreType(), "q-value")
+    TEST_REAL_SIMILAR(ids[i].getHits()[0].getScore(), expected_q[i])
+  }
+
+  // runs separately
+  p.setValue("no_qvalues", "true");
+  p.setValue("treat_runs_separately", "true");
+  fdr.setParameters(p);
+  ids = pep_ids;
+  fdr.applyBasic(ids);
+  double expected_sep[] = {0.5, 1.0, 2.0 / 3.0, 0.5, 0.5, 1.0 / 3.0};
+  for (Size i = 0; i < 6; ++i)
+  {
+    TEST_REAL_SIMILAR(ids[i].getHits()[0].getScore(), expected_sep[i])
+  }
+
+  // missing target/decoy annotation
+  ids = pep_ids;
+  ids[2].getHits()[0].removeMetaValue("target_decoy");
+  TEST_EXCEPTION(Exception::MissingInformation, fdr.applyBasic(ids))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -197,6 +197,82 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] spectra and chromatograms in parallel)
+{
+  PeakMap exp;
+  exp.resize(8);
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    Peak1D p;
+    for (Size i = 0; i < 1000 + 100 * s; ++i)
+    {
+      p.setMZ(400.0 + i * 0.01);
+      p.setIntensity(float(((i + s) * 7919) % 113));
+      exp[s].push_back(p);
+    }
+    MSChromatogram chrom;
+    ChromatogramPeak cp;
+    for (Size i = 0; i < 500; ++i)
+    {
+      cp.setRT(i * 0.01);
+      cp.setIntensity(float(((i + s) * 7919) % 113));
+      chrom.push_back(cp);
+    }
+    exp.addChromatogram(chrom);
+  }
+  PeakMap exp_ppm = exp;
+  exp_ppm.setChromatograms(std::vector<MSChromatogram>());
+
+  // filtering the experiment must give the same result as filtering each spectrum on its own
+  GaussFilter gauss;
+  Param param;
+  param.setValue("gaussian_width", 0.05);
+  gauss.setParameters(param);
+  PeakMap exp_single = exp;
+  for (Size s = 0; s < exp_single.size(); ++s)
+  {
+    gauss.filter(exp_single[s]);
+    gauss.filter(exp_single.getChromatogram(s));
+  }
+  gauss.filterExperiment(exp);
+
+  bool all_equal = true;
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    for (Size i = 0; i < exp[s].size(); ++i)
+    {
+      if (exp[s][i].getIntensity() != exp_single[s][i].getIntensity() || exp[s][i].getMZ() != exp_single[s][i].getMZ()) all_equal = false;
+    }
+    for (Size i = 0; i < exp.getChromatogram(s).size(); ++i)
+    {
+      if (exp.getChromatogram(s)[i].getIntensity() != exp_single.getChromatogram(s)[i].getIntensity()) all_equal = false;
+    }
+  }
+  TEST_EQUAL(all_equal, true)
+
+  // same in ppm mode, where every thread re-initializes its own kernel
+  param.setValue("use_ppm_tolerance", "true");
+  param.setValue("ppm_tolerance", 100.0);
+  gauss.setParameters(param);
+  PeakMap exp_ppm_single = exp_ppm;
+  for (Size s = 0; s < exp_ppm_single.size(); ++s)
+  {
+    gauss.filter(exp_ppm_single[s]);
+  }
+  gauss.filterExperiment(exp_ppm);
+
+  all_equal = true;
+  for (Size s = 0; s < exp_ppm.size(); ++s)
+  {
+    for (Size i = 0; i < exp_ppm[s].size(); ++i)
+    {
+      if (exp_ppm[s][i].getIntensity() != exp_ppm_single[s][i].getIntensity()) all_equal = false;
+    }
+  }
+  TEST_EQUAL(all_equal, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -120,6 +120,33 @@ START_TEST(IDBoostGraph, "$Id$")
         }
     END_SECTION
 
+    START_SECTION(void applyIndexedFunctorOnCCs(const std::function<unsigned long(Graph&, Size)>& functor))
+    {
+      vector<ProteinIdentification> prots;
+      vector<PeptideIdentification> peps;
+      IdXMLFile idf;
+      idf.load(OPENMS_GET_TEST_DATA_PATH("newMergerTest_out.idXML"),prots,peps);
+      IDBoostGraph idb{prots[0], peps, 0, false};
+      TEST_EXCEPTION(Exception::MissingInformation, idb.applyIndexedFunctorOnCCs([](IDBoostGraph::Graph&, Size){ return 0ul; }))
+      idb.computeConnectedComponents();
+      TEST_EQUAL(idb.getNrConnectedComponents(), 5)
+      // every component is visited exactly once and gets its own index
+      vector<Size> nr_vertices(idb.getNrConnectedComponents(), 0);
+      vector<int> visits(idb.getNrConnectedComponents(), 0);
+      idb.applyIndexedFunctorOnCCs([&](IDBoostGraph::Graph& cc, Size i)
+      {
+        nr_vertices[i] = boost::num_vertices(cc);
+        ++visits[i];
+        return 0ul;
+      });
+      for (Size i = 0; i < visits.size(); ++i)
+      {
+        TEST_EQUAL(visits[i], 1)
+        TEST_EQUAL(nr_vertices[i], boost::num_vertices(idb.getComponent(i)))
+      }
+    }
+    END_SECTION
+
     START_SECTION(IDBoostGraph on consensusXML TODO)
     {
 
@@ -0,0 +1,171 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2019.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/ANALYSIS/ID/IDCompactGraph.h>
+#include <OpenMS/ANALYSIS/ID/IDBoostGraph.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/test_config.h>
+
+using namespace OpenMS;
+using namespace std;
+using Internal::IDCompactGraph;
+using Internal::IDBoostGraph;
+
+START_TEST(IDCompactGraph, "$Id$")
+
+    START_SECTION(IDCompactGraph only best PSMs)
+    {
+      vector<ProteinIdentification> prots;
+      vector<PeptideIdentification> peps;
+      IdXMLFile idf;
+      idf.load(OPENMS_GET_TEST_DATA_PATH("newMergerTest_out.idXML"),prots,peps);
+      IDCompactGraph icg{prots[0], peps, 1};
+      TEST_EQUAL(icg.getNrConnectedComponents(), 0)
+      TEST_EQUAL(icg.getNrProteins(), prots[0].getHits().size())
+      TEST_EQUAL(icg.getNrNodes(), icg.getNrPSMs() + icg.getNrProteins())
+      icg.computeConnectedComponents();
+      TEST_EQUAL(icg.getNrConnectedComponents(), 3)
+      // same components (and order) as in IDBoostGraph. Unmatched protein PH2 is not part of any.
+      IDCompactGraph::NodeRange cc0 = icg.getComponent(0);
+      IDCompactGraph::NodeRange cc1 = icg.getComponent(1);
+      IDCompactGraph::NodeRange cc2 = icg.getComponent(2);
+      TEST_EQUAL(cc0.second - cc0.first, 3)
+      TEST_EQUAL(cc1.second - cc1.first, 4)
+      TEST_EQUAL(cc2.second - cc2.first, 2)
+      TEST_EXCEPTION(Exception::IndexOverflow, icg.getComponent(3))
+
+      Size edges(0);
+      for (Size i = 0; i < icg.getNrConnectedComponents(); ++i)
+      {
+        edges += icg.getNrEdgesInComponent(i);
+        IDCompactGraph::NodeRange nodes = icg.getComponent(i);
+        for (const IDCompactGraph::Node* n = nodes.first; n != nodes.second; ++n)
+        {
+          TEST_EQUAL(icg.getComponentOf(*n), i)
+          // edges only connect PSMs and proteins
+          IDCompactGraph::NodeRange nbs = icg.getNeighbors(*n);
+          for (const IDCompactGraph::Node* nb = nbs.first; nb != nbs.second; ++nb)
+          {
+            TEST_NOT_EQUAL(icg.isProtein(*n), icg.isProtein(*nb))
+          }
+        }
+      }
+      TEST_EQUAL(edges, icg.getNrEdges())
+    }
+    END_SECTION
+
+    START_SECTION(IDCompactGraph all PSMs)
+    {
+      vector<ProteinIdentification> prots;
+      vector<PeptideIdentification> peps;
+      IdXMLFile idf;
+      idf.load(OPENMS_GET_TEST_DATA_PATH("newMergerTest_out.idXML"),prots,peps);
+      IDCompactGraph icg{prots[0], peps, 0};
+      icg.computeConnectedComponents();
+      TEST_EQUAL(icg.getNrConnectedComponents(), 5)
+      Size expected[] = {4, 2, 5, 1, 2};
+      for (Size i = 0; i < 5; ++i)
+      {
+        IDCompactGraph::NodeRange nodes = icg.getComponent(i);
+        TEST_EQUAL(Size(nodes.second - nodes.first), expected[i])
+      }
+    }
+    END_SECTION
+
+    START_SECTION(IDBoostGraph(ProteinIdentification& proteins, const IDCompactGraph& compact_graph))
+    {
+      vector<ProteinIdentification> prots;
+      vector<PeptideIdentification> peps;
+      IdXMLFile idf;
+      idf.load(OPENMS_GET_TEST_DATA_PATH("newMergerTest_out.idXML"),prots,peps);
+      IDCompactGraph icg{prots[0], peps, 1};
+      TEST_EXCEPTION(Exception::MissingInformation, IDBoostGraph(prots[0], icg))
+      icg.computeConnectedComponents();
+      IDBoostGraph idb{prots[0], icg};
+      TEST_EQUAL(idb.getNrConnectedComponents(), 3)
+      idb.computeConnectedComponents(); // no-op, already split
+      TEST_EQUAL(idb.getNrConnectedComponents(), 3)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(0)), 3)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(1)), 4)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(2)), 2)
+      TEST_EQUAL(boost::num_edges(idb.getComponent(1)), icg.getNrEdgesInComponent(1))
+      idb.clusterIndistProteinsAndPeptides();
+      // Only cc 0 and 1 have indist prot group (see IDBoostGraph_test)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(0)), 4)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(1)), 5)
+      TEST_EQUAL(boost::num_vertices(idb.getComponent(2)), 2)
+    }
+    END_SECTION
+
+    START_SECTION(void calculateAndAnnotateIndistProteins(bool addSingletons = true))
+    {
+      vector<ProteinIdentification> prots;
+      vector<PeptideIdentification> peps;
+      IdXMLFile idf;
+      idf.load(OPENMS_GET_TEST_DATA_PATH("newMergerTest_out.idXML"),prots,peps);
+      vector<ProteinIdentification> prots_boost = prots;
+      vector<PeptideIdentification> peps_boost = peps;
+
+      IDCompactGraph icg{prots[0], peps, 0};
+      icg.calculateAndAnnotateIndistProteins(true);
+      IDBoostGraph idb{prots_boost[0], peps_boost, 0, false};
+      idb.computeConnectedComponents();
+      idb.calculateAndAnnotateIndistProteins(true);
+
+      // same groups as IDBoostGraph, possibly in a different order
+      vector<ProteinIdentification::ProteinGroup> groups = prots[0].getIndistinguishableProteins();
+      vector<ProteinIdentification::ProteinGroup> groups_boost = prots_boost[0].getIndistinguishableProteins();
+      TEST_EQUAL(groups.size(), groups_boost.size())
+      for (auto& g : groups) std::sort(g.accessions.begin(), g.accessions.end());
+      for (auto& g : groups_boost) std::sort(g.accessions.begin(), g.accessions.end());
+      std::sort(groups.begin(), groups.end());
+      std::sort(groups_boost.begin(), groups_boost.end());
+      ABORT_IF(groups.size() != groups_boost.size())
+      for (Size i = 0; i < groups.size(); ++i)
+      {
+        TEST_EQUAL(groups[i] == groups_boost[i], true)
+      }
+
+      // without singletons only real groups are annotated
+      prots[0].getIndistinguishableProteins().clear();
+      icg.calculateAndAnnotateIndistProteins(false);
+      for (const auto& g : prots[0].getIndistinguishableProteins())
+      {
+        TEST_EQUAL(g.accessions.size() > 1, true)
+      }
+    }
+    END_SECTION
+
+END_TEST
@@ -531,6 +531,69 @@ START_SECTION((template <class IdentificationType> static void keepHitsMatchingP
 }
 END_SECTION
 
+START_SECTION((static void filterByProteinAccessions(vector<PeptideIdentification>& peptides, vector<ProteinIdentification>& proteins, ProteinAccessionIndex& index, const AccessionFilter& filter)))
+{
+  // whitelist, same result as "keepHitsMatchingProteins":
+  vector<ProteinIdentification> proteins = global_proteins;
+  vector<PeptideIdentification> peptides = global_peptides;
+  ProteinAccessionIndex index(proteins);
+  IDFilter::AccessionFilter filter;
+  filter.whitelist.insert("Q824A5");
+  filter.whitelist.insert("Q872T5");
+  IDFilter::filterByProteinAccessions(peptides, proteins, index, filter);
+  TEST_EQUAL(proteins[0].getHits().size(), 2);
+  TEST_EQUAL(proteins[0].getHits()[0].getAccession(), "Q824A5");
+  TEST_EQUAL(proteins[0].getHits()[1].getAccession(), "Q872T5");
+  TEST_EQUAL(peptides[0].getHits().size(), 2);
+  TEST_EQUAL(peptides[0].getHits()[0].getSequence().toString(),
+                    "LHASGITVTEIPVTATNFK");
+  TEST_EQUAL(peptides[0].getHits()[1].getSequence().toString(),
+                    "MRSLGYVAVISAVATDTDK");
+  // the index was updated:
+  TEST_EQUAL(index.isInRun(index.find("Q824A5"), 0), true);
+  TEST_EQUAL(index.isInRun(index.find("AAD30739"), 0), false);
+
+  // blacklist (reusing the index), same result as "removeHitsMatchingProteins":
+  proteins = global_proteins;
+  peptides = global_peptides;
+  index.build(proteins);
+  filter = IDFilter::AccessionFilter();
+  filter.blacklist.insert("Q824A5");
+  filter.blacklist.insert("Q872T5");
+  IDFilter::filterByProteinAccessions(peptides, proteins, index, filter);
+  TEST_EQUAL(proteins[0].getHits().size(), 2);
+  TEST_EQUAL(proteins[0].getHits()[0].getAccession(), "AAD30739");
+  TEST_EQUAL(proteins[0].getHits()[1].getAccession(), "S53854");
+  TEST_EQUAL(peptides[0].getHits().size(), 9);
+  TEST_EQUAL(peptides[0].getHits()[8].getSequence().toString(),
+                    "MSLLSNM(Oxidation)ISIVKVGYNAR");
+
+  // clean-up, same result as "removeUnreferencedProteins" + "updateProteinReferences":
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IDFilter_test4.idXML"),
+                   proteins, peptides);
+  vector<ProteinIdentification> proteins2 = proteins;
+  vector<PeptideIdentification> peptides2 = peptides;
+  IDFilter::removeUnreferencedProteins(proteins2, peptides2);
+  IDFilter::updateProteinReferences(peptides2, proteins2, true);
+
+  filter = IDFilter::AccessionFilter();
+  filter.update_references = true;
+  filter.remove_peptides_without_reference = true;
+  filter.remove_unreferenced_proteins = true;
+  IDFilter::filterByProteinAccessions(peptides, proteins, filter);
+  TEST_EQUAL(proteins[0].getHits().size(), 3);
+  TEST_EQUAL(proteins == proteins2, true);
+  TEST_EQUAL(peptides == peptides2, true);
+
+  // nothing to do:
+  proteins = global_proteins;
+  peptides = global_peptides;
+  IDFilter::filterByProteinAccessions(peptides, proteins, IDFilter::AccessionFilter());
+  TEST_EQUAL(proteins == global_proteins, true);
+  TEST_EQUAL(peptides == global_peptides, true);
+}
+END_SECTION
+
 START_SECTION((static void keepBestPeptideHits(vector<PeptideIdentification>& peptides, bool strict = false)))
 {
   vector<PeptideIdentification> peptides = global_peptides;
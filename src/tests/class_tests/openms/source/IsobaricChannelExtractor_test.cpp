@@ -572,6 +572,28 @@ START_SECTION(([EXTRA] purity computation without interpolation))
 }
 END_SECTION
 
+START_SECTION(([EXTRA] errors during the (parallel) extraction are passed to the caller))
+{
+  PeakMap exp_purity;
+  MzMLFile mzmlfile;
+  mzmlfile.load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp_purity);
+
+  // purity computation needs peaks in the precursor scan
+  for (PeakMap::Iterator it = exp_purity.begin(); it != exp_purity.end(); ++it)
+  {
+    if (it->getMSLevel() == 1) it->clear(false);
+  }
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  ConsensusMap cm_out;
+  TEST_EXCEPTION(Exception::Precondition, ice.extractChannels(exp_purity, cm_out))
+}
+END_SECTION
+
 // extra test for tmt10plex to ensure high-res extraction works
 START_SECTION(([EXTRA] TMT 10plex support))
 {
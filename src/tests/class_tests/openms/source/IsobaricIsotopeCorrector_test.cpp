@@ -182,6 +182,46 @@ START_SECTION((IsobaricQuantifierStatistics correctIsotopicImpurities(const Cons
     // TEST_EQUAL(stats.empty_channels[117], 1)
   }
 
+  // 5. channels missing from a feature are solved with zero intensity,
+  //    independent of the preceding features
+  {
+    ConsensusXMLFile cm_file;
+    ConsensusMap cm_in, cm_out;
+    cm_file.load(OPENMS_GET_TEST_DATA_PATH("IsobaricIsotopeCorrector.consensusXML"),cm_in);
+    cm_in.clear(false);
+
+    // feature without a handle for channel 114
+    ConsensusFeature cf_missing;
+    BaseFeature bf1, bf2, bf3;
+    bf1.setIntensity(95.341);
+    bf2.setIntensity(101.998);
+    bf3.setIntensity(96.900);
+    cf_missing.insert(1, bf1);cf_missing.insert(2, bf2);cf_missing.insert(3, bf3);
+
+    // ... corrected alone
+    ConsensusMap cm_single = cm_in;
+    cm_single.push_back(cf_missing);
+    ConsensusMap cm_single_out = cm_single;
+    IsobaricIsotopeCorrector::correctIsotopicImpurities(cm_single, cm_single_out, &quant_meth);
+
+    // ... and after a feature with a large intensity in channel 114
+    double v1[4] = {5000.0, 95.341, 101.998, 96.900};
+    cm_in.push_back(getCFWithIntensites(v1));
+    cm_in.push_back(cf_missing);
+    cm_out = cm_in;
+    IsobaricIsotopeCorrector::correctIsotopicImpurities(cm_in, cm_out, &quant_meth);
+
+    ABORT_IF(cm_out[1].getFeatures().size() != 3)
+    ABORT_IF(cm_single_out[0].getFeatures().size() != 3)
+    ConsensusFeature::HandleSetType::const_iterator it = cm_out[1].getFeatures().begin();
+    ConsensusFeature::HandleSetType::const_iterator it_single = cm_single_out[0].getFeatures().begin();
+    for (; it != cm_out[1].getFeatures().end(); ++it, ++it_single)
+    {
+      TEST_EQUAL(it->getMapIndex(), it_single->getMapIndex())
+      TEST_REAL_SIMILAR(it->getIntensity(), it_single->getIntensity())
+    }
+  }
+
   // 4. test precondition
   {
     ConsensusXMLFile cm_file;
@@ -33,6 +33,8 @@
 // --------------------------------------------------------------------------
 #include <boost/shared_ptr.hpp>
 
+#include <cmath>
+
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
@@ -387,6 +389,107 @@ START_SECTION( void scorePeakgroups(MRMTransitionGroupType& transition_group, Tr
 }
 END_SECTION
 
+START_SECTION(void precomputeDIAScores(const std::vector<MRMTransitionGroupType*>& transition_groups, const std::vector<OpenSwath::SwathMap>& swath_maps))
+{
+  // The DIA scores computed for all peak groups at once (precomputeDIAScores,
+  // used by pickExperiment) need to be identical to the ones computed for
+  // each peak group separately (calculateDIAScores in scorePeakgroups)
+  MRMFeatureFinderScoring ff;
+  Param ff_param = ff.getDefaults();
+  ff_param.setValue("add_up_spectra", 3);
+  ff.setParameters(ff_param);
+
+  TransformationDescription trafo;
+  TransitionGroupMapType transition_group_map;
+
+  boost::shared_ptr<PeakMap> exp (new PeakMap);
+  OpenSwath::LightTargetedExperiment transitions;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.mzML"), *exp);
+  {
+    TargetedExperiment transition_exp_;
+    TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("OpenSwath_generic_input.TraML"), transition_exp_);
+    OpenSwathDataAccessHelper::convertTargetedExp(transition_exp_, transitions);
+  }
+
+  // SWATH map with signal for all fragment ions (and their first isotope)
+  // eluting at the RT of the peak groups
+  boost::shared_ptr<PeakMap> swath_map (new PeakMap);
+  const double fragment_mz[] = {618.31, 628.435, 651.3, 654.38};
+  for (Size i = 0; i < 200; ++i)
+  {
+    MSSpectrum s;
+    s.setMSLevel(2);
+    s.setRT(2800.0 + 3.0 * i);
+    double elution = std::exp(-(s.getRT() - 3119.0) * (s.getRT() - 3119.0) / 800.0);
+    for (Size j = 0; j < 4; ++j)
+    {
+      double mz = fragment_mz[j] + 0.001 * (j + 1) * ((i % 3) - 1.0);
+      s.push_back(Peak1D(mz, 100.0 + 5000.0 * (j + 1) * elution));
+      s.push_back(Peak1D(mz + 1.00335, 20.0 + 1500.0 * (j + 1) * elution));
+    }
+    s.sortByPosition();
+    swath_map->addSpectrum(s);
+  }
+
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+  OpenSwath::SpectrumAccessPtr chromatogram_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+  std::vector< OpenSwath::SwathMap > swath_maps(1);
+  swath_maps[0].sptr = swath_ptr;
+
+  // batch computation through pickExperiment
+  FeatureMap output_picked;
+  ff.pickExperiment(chromatogram_ptr, output_picked, transitions, trafo, swath_maps, transition_group_map);
+  TEST_EQUAL(transition_group_map.size(), 2)
+
+  std::vector<MRMFeatureFinderScoring::MRMTransitionGroupType*> groups;
+  for (TransitionGroupMapType::iterator it = transition_group_map.begin(); it != transition_group_map.end(); ++it)
+  {
+    groups.push_back(&it->second);
+  }
+
+  // per peak group computation (nothing precomputed)
+  FeatureMap output_single;
+  for (Size i = 0; i < groups.size(); ++i)
+  {
+    ff.scorePeakgroups(*groups[i], trafo, swath_maps, output_single);
+  }
+
+  // explicit batch computation
+  FeatureMap output_batch;
+  ff.precomputeDIAScores(groups, swath_maps);
+  for (Size i = 0; i < groups.size(); ++i)
+  {
+    ff.scorePeakgroups(*groups[i], trafo, swath_maps, output_batch);
+  }
+
+  TEST_EQUAL(output_single.size(), 3)
+  TEST_EQUAL(output_batch.size(), output_single.size())
+  TEST_EQUAL(output_picked.size(), output_single.size())
+
+  const char* dia_scores[] = {"var_isotope_correlation_score", "var_isotope_overlap_score",
+                              "var_massdev_score", "var_massdev_score_weighted",
+                              "var_bseries_score", "var_yseries_score",
+                              "var_dotprod_score", "var_manhatt_score",
+                              "main_var_xx_swath_prelim_score"};
+  for (Size i = 0; i < output_single.size(); ++i)
+  {
+    // make sure the SWATH map was actually used for scoring
+    ABORT_IF(!output_single[i].metaValueExists("var_dotprod_score"))
+    TEST_EQUAL(double(output_single[i].getMetaValue("var_dotprod_score")) > 0.0, true)
+    TEST_EQUAL(output_single[i].getMetaValue("masserror_ppm").toDoubleList().empty(), false)
+
+    for (Size k = 0; k < sizeof(dia_scores) / sizeof(dia_scores[0]); ++k)
+    {
+      double single = output_single[i].getMetaValue(dia_scores[k]);
+      TEST_EQUAL(double(output_batch[i].getMetaValue(dia_scores[k])) == single, true)
+      TEST_EQUAL(double(output_picked[i].getMetaValue(dia_scores[k])) == single, true)
+    }
+    TEST_EQUAL(output_batch[i].getMetaValue("masserror_ppm").toDoubleList() == output_single[i].getMetaValue("masserror_ppm").toDoubleList(), true)
+    TEST_EQUAL(output_picked[i].getMetaValue("masserror_ppm").toDoubleList() == output_single[i].getMetaValue("masserror_ppm").toDoubleList(), true)
+  }
+}
+END_SECTION
+
 START_SECTION(void prepareProteinPeptideMaps_(OpenSwath::LightTargetedExperiment& transition_exp) )
   NOT_TESTABLE // tested above
 END_SECTION
@@ -494,6 +494,54 @@ START_SECTION((template < typename SpectrumT, typename TransitionT > void pickTr
     }
 
   }
+
+  { // resample_once: chromatograms sampled at identical RT give the same features
+    for (Size consensus = 0; consensus < 2; ++consensus)
+    {
+      MRMTransitionGroupPicker trgroup_picker;
+      Param picker_param = trgroup_picker.getDefaults();
+      picker_param.setValue("PeakPickerMRM:gauss_width", 10.0);
+      picker_param.setValue("PeakPickerMRM:peak_width", -1.0);
+      picker_param.setValue("PeakPickerMRM:signal_to_noise", 1.0);
+      picker_param.setValue("PeakPickerMRM:method", "corrected");
+      picker_param.setValue("compute_total_mi", "true");
+      picker_param.setValue("use_consensus", consensus ? "true" : "false");
+      trgroup_picker.setParameters(picker_param);
+
+      MRMTransitionGroupType transition_group;
+      setup_transition_group2(transition_group);
+      trgroup_picker.pickTransitionGroup(transition_group);
+
+      picker_param.setValue("resample_once", "true");
+      trgroup_picker.setParameters(picker_param);
+      MRMTransitionGroupType transition_group_once;
+      setup_transition_group2(transition_group_once);
+      trgroup_picker.pickTransitionGroup(transition_group_once);
+
+      TEST_EQUAL(transition_group.getFeatures().empty(), false)
+      TEST_EQUAL(transition_group_once.getFeatures().size(), transition_group.getFeatures().size())
+      for (Size i = 0; i < transition_group.getFeatures().size(); ++i)
+      {
+        const MRMFeature& f = transition_group.getFeatures()[i];
+        const MRMFeature& f_once = transition_group_once.getFeatures()[i];
+        TEST_REAL_SIMILAR(f_once.getRT(), f.getRT())
+        TEST_REAL_SIMILAR(f_once.getIntensity(), f.getIntensity())
+        TEST_REAL_SIMILAR(f_once.getMetaValue("leftWidth"), f.getMetaValue("leftWidth"))
+        TEST_REAL_SIMILAR(f_once.getMetaValue("rightWidth"), f.getMetaValue("rightWidth"))
+        TEST_REAL_SIMILAR(f_once.getMetaValue("total_xic"), f.getMetaValue("total_xic"))
+        TEST_REAL_SIMILAR(f_once.getMetaValue("total_mi"), f.getMetaValue("total_mi"))
+        TEST_REAL_SIMILAR(f_once.getMetaValue("peak_apices_sum"), f.getMetaValue("peak_apices_sum"))
+        for (Size k = 1; k <= 3; ++k)
+        {
+          const Feature& sub = f.getFeature(String(k));
+          const Feature& sub_once = f_once.getFeature(String(k));
+          TEST_REAL_SIMILAR(sub_once.getIntensity(), sub.getIntensity())
+          TEST_REAL_SIMILAR(sub_once.getMetaValue("peak_apex_int"), sub.getMetaValue("peak_apex_int"))
+          TEST_REAL_SIMILAR(sub_once.getMetaValue("total_mi"), sub.getMetaValue("total_mi"))
+        }
+      }
+    }
+  }
 }
 END_SECTION
 
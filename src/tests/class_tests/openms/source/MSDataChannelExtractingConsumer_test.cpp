@@ -0,0 +1,215 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChannelExtractingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/QUANTITATION/ItraqFourPlexQuantitationMethod.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// streams a copy of all spectra of exp through a new consumer
+void extractStreaming(const PeakMap& exp, const IsobaricQuantitationMethod* q_method, const Param& p, ConsensusMap& result)
+{
+  MSDataChannelExtractingConsumer consumer(q_method);
+  consumer.setParameters(p);
+  consumer.setExpectedSize(exp.size(), 0);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    MSSpectrum s = exp[i];
+    consumer.consumeSpectrum(s);
+  }
+  consumer.finish(result);
+}
+
+START_TEST(MSDataChannelExtractingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IsobaricQuantitationMethod* q_method = new ItraqFourPlexQuantitationMethod();
+
+MSDataChannelExtractingConsumer* ptr = nullptr;
+MSDataChannelExtractingConsumer* nullPointer = nullptr;
+
+START_SECTION((MSDataChannelExtractingConsumer(const IsobaricQuantitationMethod* const quant_method)))
+{
+  ptr = new MSDataChannelExtractingConsumer(q_method);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION((~MSDataChannelExtractingConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+{
+  NOT_TESTABLE // tested below
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  NOT_TESTABLE // ignored
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  NOT_TESTABLE // ignored
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  MSDataChannelExtractingConsumer consumer(q_method);
+  MSSpectrum s1, s2;
+  s1.setRT(10.0);
+  s2.setRT(5.0);
+  consumer.consumeSpectrum(s1);
+  TEST_EXCEPTION(Exception::InvalidParameter, consumer.consumeSpectrum(s2))
+}
+END_SECTION
+
+START_SECTION((void finish(ConsensusMap& consensus_map)))
+{
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp);
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+
+  // same result as IsobaricChannelExtractor, with and without purity interpolation and filtering
+  for (Size run = 0; run < 3; ++run)
+  {
+    p.setValue("purity_interpolation", run == 1 ? "false" : "true");
+    p.setValue("min_precursor_purity", run == 2 ? 0.75 : 0.0);
+    ice.setParameters(p);
+
+    ConsensusMap cm_expected, cm_streamed;
+    ice.extractChannels(exp, cm_expected);
+    extractStreaming(exp, q_method, p, cm_streamed);
+
+    TEST_EQUAL(cm_streamed.size(), cm_expected.size())
+    TEST_EQUAL(cm_streamed.getColumnHeaders().size(), 4)
+    TEST_EQUAL(cm_streamed.getExperimentType(), "labeled_MS2")
+    ABORT_IF(cm_streamed.size() != cm_expected.size())
+    for (Size i = 0; i < cm_expected.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(cm_streamed[i].getRT(), cm_expected[i].getRT())
+      TEST_REAL_SIMILAR(cm_streamed[i].getMZ(), cm_expected[i].getMZ())
+      TEST_REAL_SIMILAR(cm_streamed[i].getIntensity(), cm_expected[i].getIntensity())
+      TEST_EQUAL(cm_streamed[i].getMetaValue("scan_id"), cm_expected[i].getMetaValue("scan_id"))
+      TEST_REAL_SIMILAR(cm_streamed[i].getMetaValue("precursor_purity"), cm_expected[i].getMetaValue("precursor_purity"))
+      TEST_EQUAL(cm_streamed[i].size(), cm_expected[i].size())
+      ConsensusFeature::const_iterator it_streamed = cm_streamed[i].begin();
+      for (ConsensusFeature::const_iterator it = cm_expected[i].begin(); it != cm_expected[i].end(); ++it, ++it_streamed)
+      {
+        TEST_EQUAL(it_streamed->getMapIndex(), it->getMapIndex())
+        TEST_REAL_SIMILAR(it_streamed->getIntensity(), it->getIntensity())
+      }
+    }
+  }
+
+  // nothing consumed
+  MSDataChannelExtractingConsumer consumer(q_method);
+  ConsensusMap cm_empty;
+  TEST_EXCEPTION(Exception::MissingInformation, consumer.finish(cm_empty))
+}
+END_SECTION
+
+START_SECTION(([EXTRA] MS3 quantification))
+{
+  // add an MS3 spectrum (copy of the reporter region) after each MS2 spectrum
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp);
+  PeakMap exp_ms3 = exp;
+  exp_ms3.clear(false);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    exp_ms3.addSpectrum(exp[i]);
+    if (exp[i].getMSLevel() != 2) continue;
+
+    MSSpectrum ms3 = exp[i];
+    ms3.setMSLevel(3);
+    ms3.setNativeID(exp[i].getNativeID() + "_ms3");
+    ms3.setRT(exp[i].getRT() + 1e-4);
+    ms3.getPrecursors()[0].setMetaValue("spectrum_ref", exp[i].getNativeID());
+    exp_ms3.addSpectrum(ms3);
+  }
+  ABORT_IF(!exp_ms3.isSorted(false))
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  ConsensusMap cm_ms2, cm_expected, cm_streamed;
+  ice.extractChannels(exp, cm_ms2);
+  ice.extractChannels(exp_ms3, cm_expected);
+  extractStreaming(exp_ms3, q_method, p, cm_streamed);
+
+  // the MS2 results are discarded once the first MS3 spectrum is seen
+  TEST_EQUAL(cm_expected.size(), cm_ms2.size())
+  TEST_EQUAL(cm_streamed.size(), cm_expected.size())
+  ABORT_IF(cm_streamed.size() != cm_expected.size())
+  for (Size i = 0; i < cm_expected.size(); ++i)
+  {
+    TEST_EQUAL(cm_streamed[i].getMetaValue("scan_id"), cm_expected[i].getMetaValue("scan_id"))
+    TEST_EQUAL(String(cm_streamed[i].getMetaValue("scan_id")).hasSuffix("_ms3"), true)
+    // position of the MS2 spectrum
+    TEST_REAL_SIMILAR(cm_streamed[i].getRT(), cm_ms2[i].getRT())
+    TEST_REAL_SIMILAR(cm_streamed[i].getMZ(), cm_ms2[i].getMZ())
+    TEST_REAL_SIMILAR(cm_streamed[i].getIntensity(), cm_expected[i].getIntensity())
+  }
+}
+END_SECTION
+
+delete q_method;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,234 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelTransformingConsumer* parallel_consumer_ptr = nullptr;
+MSDataParallelTransformingConsumer* parallel_consumer_nullPointer = nullptr;
+
+PeakMap expc;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), expc);
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 1000)))
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(parallel_consumer_ptr, parallel_consumer_nullPointer)
+  delete parallel_consumer_ptr;
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // remaining data is flushed on destruction
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  PeakMap exp = expc;
+  parallel_consumer_ptr->consumeSpectrum(exp.getSpectrum(0));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 0)
+  delete parallel_consumer_ptr;
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 1)
+
+  // errors while flushing are not thrown from the destructor
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  parallel_consumer_ptr->setSpectraProcessingFunc([](MSSpectrum& /* s */, MSSpectrum& /* scratch */)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test");
+    });
+  parallel_consumer_ptr->consumeSpectrum(exp.getSpectrum(0));
+  delete parallel_consumer_ptr;
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 2);
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrSpectra() > 2, true)
+  MSSpectrum first_spectrum = exp.getSpectrum(0);
+
+  parallel_consumer.setExpectedSize(exp.getNrSpectra(), 0);
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 0) // batch not full yet
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(1));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 2) // batch is passed on
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(2));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 2)
+
+  TEST_EQUAL(first_spectrum == exp.getSpectrum(0), true) // input is not modified
+  TEST_EQUAL(first_spectrum == storing_consumer.getData()[0], true) // nothing happened
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 10);
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrChromatograms() > 0, true)
+
+  // pending spectra are passed on before the first chromatogram
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(0));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 1)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 0)
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 1)
+  TEST_EQUAL(exp.getChromatogram(0) == storing_consumer.getData().getChromatograms()[0], true)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& exp)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+
+  ExperimentalSettings s;
+  s.setComment("forwarded");
+  parallel_consumer.setExperimentalSettings(s);
+  TEST_EQUAL(storing_consumer.getData().getComment(), "forwarded")
+}
+END_SECTION
+
+START_SECTION((void setSpectraProcessingFunc(SpectrumFunction f_spec)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 3);
+
+  PeakMap exp = expc;
+  // use more spectra than fit into a batch, output order must be the input order
+  std::vector<MSSpectrum> input;
+  for (Size k = 0; k < 4; ++k)
+  {
+    for (Size i = 0; i < exp.getNrSpectra(); ++i)
+    {
+      input.push_back(exp.getSpectrum(i));
+      input.back().setRT(input.size());
+      input.back().sortByPosition();
+    }
+  }
+
+  auto f = [](MSSpectrum& s, MSSpectrum& scratch)
+  {
+    // copy every other peak to the scratch spectrum and swap
+    scratch.clear(true);
+    for (Size i = 0; i < s.size(); i += 2)
+    {
+      scratch.push_back(s[i]);
+    }
+    scratch.setRT(s.getRT());
+    std::swap(s, scratch);
+  };
+  parallel_consumer.setSpectraProcessingFunc(f);
+
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(input[i]);
+  }
+  parallel_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.getNrSpectra(), input.size())
+  ABORT_IF(result.getNrSpectra() != input.size())
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    TEST_EQUAL(result[i].getRT(), input[i].getRT())
+    TEST_EQUAL(result[i].size(), (input[i].size() + 1) / 2)
+  }
+
+  // exceptions are passed on to the caller
+  auto f_throw = [](MSSpectrum& /* s */, MSSpectrum& /* scratch */)
+  {
+    throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test");
+  };
+  parallel_consumer.setSpectraProcessingFunc(f_throw);
+  parallel_consumer.consumeSpectrum(input[0]);
+  TEST_EXCEPTION(Exception::IllegalArgument, parallel_consumer.flush())
+}
+END_SECTION
+
+START_SECTION((void setChromatogramProcessingFunc(ChromatogramFunction f_chrom)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrChromatograms() > 0, true)
+  exp.getChromatogram(0).sortByPosition();
+  MSChromatogram first_chromatogram = exp.getChromatogram(0);
+
+  auto f = [](MSChromatogram& c, MSChromatogram& /* scratch */)
+  {
+    c.sortByIntensity();
+  };
+  parallel_consumer.setChromatogramProcessingFunc(f);
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(0));
+  parallel_consumer.flush();
+
+  TEST_EQUAL(first_chromatogram == exp.getChromatogram(0), true) // input is not modified
+  TEST_EQUAL(storing_consumer.getData().getChromatograms()[0].isSorted(), false) // output is
+}
+END_SECTION
+
+START_SECTION((void flush()))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,208 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataSpectraMergingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+using namespace OpenMS;
+using namespace std;
+
+// consumer which fails on every spectrum
+class FailingConsumer :
+  public MSDataStoringConsumer
+{
+public:
+  void consumeSpectrum(SpectrumType&) override
+  {
+    throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test");
+  }
+};
+
+START_TEST(MSDataSpectraMergingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MSDataSpectraMergingConsumer* merging_consumer_ptr = nullptr;
+MSDataSpectraMergingConsumer* merging_consumer_nullPointer = nullptr;
+
+START_SECTION((MSDataSpectraMergingConsumer(Interfaces::IMSDataConsumer* next_consumer, const String& merging_method)))
+{
+  MSDataStoringConsumer storing_consumer;
+  merging_consumer_ptr = new MSDataSpectraMergingConsumer(&storing_consumer, "block_method");
+  TEST_NOT_EQUAL(merging_consumer_ptr, merging_consumer_nullPointer)
+  delete merging_consumer_ptr;
+
+  TEST_EXCEPTION(Exception::IllegalArgument, MSDataSpectraMergingConsumer(&storing_consumer, "average_gaussian"))
+}
+END_SECTION
+
+START_SECTION((~MSDataSpectraMergingConsumer()))
+{
+  // the destructor flushes the open block
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataSpectraMergingConsumer merging_consumer(&storing_consumer, "block_method");
+    MSSpectrum s;
+    s.setMSLevel(1);
+    s.setRT(1.0);
+    merging_consumer.consumeSpectrum(s);
+    TEST_EQUAL(storing_consumer.getData().size(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+
+  // errors of the next consumer are not thrown from the destructor ...
+  FailingConsumer failing_consumer;
+  {
+    MSDataSpectraMergingConsumer merging_consumer(&failing_consumer, "block_method");
+    MSSpectrum s;
+    s.setMSLevel(1);
+    s.setRT(1.0);
+    merging_consumer.consumeSpectrum(s);
+  }
+  // ... but from an explicit flush
+  MSDataSpectraMergingConsumer merging_consumer(&failing_consumer, "block_method");
+  MSSpectrum s;
+  s.setMSLevel(1);
+  s.setRT(1.0);
+  merging_consumer.consumeSpectrum(s);
+  TEST_EXCEPTION(Exception::UnableToCreateFile, merging_consumer.flush())
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  // block method: same result as merging the whole map
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_2.mzML"), exp);
+  exp.sortSpectra();
+
+  Param p;
+  p.setValue("mz_binning_width", 0.0001);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("block_method:rt_block_size", 4);
+  p.setValue("block_method:ms_levels", ListUtils::create<Int>("1,2"));
+
+  PeakMap exp_merged = exp;
+  SpectraMerger merger;
+  merger.setParameters(p);
+  merger.mergeSpectraBlockWise(exp_merged);
+
+  MSDataStoringConsumer storing_consumer;
+  MSDataSpectraMergingConsumer merging_consumer(&storing_consumer, "block_method");
+  merging_consumer.setParameters(p);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    merging_consumer.consumeSpectrum(exp[i]);
+  }
+  merging_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), 37)
+  TEST_EQUAL(result.size(), exp_merged.size())
+  ABORT_IF(result.size() != exp_merged.size())
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(result[i].getRT(), exp_merged[i].getRT())
+    TEST_EQUAL(result[i].getMSLevel(), exp_merged[i].getMSLevel())
+    TEST_EQUAL(result[i].size(), exp_merged[i].size())
+  }
+
+  // unsorted input
+  MSSpectrum s;
+  s.setRT(0.0);
+  TEST_EXCEPTION(Exception::IllegalArgument, merging_consumer.consumeSpectrum(s))
+}
+END_SECTION
+
+START_SECTION([EXTRA] precursor_method)
+{
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_precursor.mzML"), exp);
+  exp.sortSpectra();
+
+  Param p;
+  p.setValue("mz_binning_width", 0.3);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("precursor_method:mz_tolerance", 10e-5);
+  p.setValue("precursor_method:rt_tolerance", 5.0);
+
+  PeakMap exp_merged = exp;
+  SpectraMerger merger;
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp_merged);
+
+  MSDataStoringConsumer storing_consumer;
+  MSDataSpectraMergingConsumer merging_consumer(&storing_consumer, "precursor_method");
+  merging_consumer.setParameters(p);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    merging_consumer.consumeSpectrum(exp[i]);
+  }
+  merging_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), exp_merged.size())
+  ABORT_IF(result.size() != exp_merged.size())
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(result[i].getRT(), exp_merged[i].getRT())
+    TEST_EQUAL(result[i].getMSLevel(), exp_merged[i].getMSLevel())
+    TEST_EQUAL(result[i].size(), exp_merged[i].size())
+  }
+
+  // chromatograms are passed on after all pending spectra
+  MSDataStoringConsumer storing_consumer2;
+  MSDataSpectraMergingConsumer merging_consumer2(&storing_consumer2, "precursor_method");
+  merging_consumer2.setParameters(p);
+  merging_consumer2.consumeSpectrum(exp[exp.size() - 1]);
+  MSChromatogram chrom;
+  merging_consumer2.consumeChromatogram(chrom);
+  TEST_EQUAL(storing_consumer2.getData().size(), 1)
+  TEST_EQUAL(storing_consumer2.getData().getChromatograms().size(), 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -333,6 +333,44 @@ START_SECTION([EXTRA] decodeNP_SLOF)
 }
 END_SECTION
 
+START_SECTION(( void decodeNPRaw(const unsigned char* in, size_t in_size, std::vector<double> & out, const NumpressConfig & config) ))
+{
+  std::vector< double > in = setup_test_vec2();
+
+  MSNumpressCoder::NumpressConfig config;
+  config.estimate_fixed_point = true; // critical
+  MSNumpressCoder::NumpressCompression compressions[] = {MSNumpressCoder::LINEAR, MSNumpressCoder::PIC, MSNumpressCoder::SLOF};
+
+  // reused output vector, larger than needed: decoded in place
+  std::vector<double> out(1000, -1.0);
+  const double* out_data = out.data();
+  for (Size i = 0; i < 3; ++i)
+  {
+    config.np_compression = compressions[i];
+    String raw;
+    MSNumpressCoder().encodeNPRaw(in, raw, config);
+
+    std::vector<double> expected;
+    MSNumpressCoder().decodeNPRaw(raw, expected, config);
+    TEST_EQUAL(expected.size(), 100)
+
+    MSNumpressCoder().decodeNPRaw(reinterpret_cast<const unsigned char*>(raw.c_str()), raw.size(), out, config);
+    TEST_EQUAL(out.size(), 100)
+    TEST_EQUAL(out == expected, true)
+    TEST_EQUAL(out.data() == out_data, true)
+  }
+
+  // empty input
+  MSNumpressCoder().decodeNPRaw(reinterpret_cast<const unsigned char*>(""), 0, out, config);
+  TEST_EQUAL(out.size(), 0)
+
+  // corrupt input
+  config.np_compression = MSNumpressCoder::LINEAR;
+  unsigned char corrupt[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3};
+  TEST_EXCEPTION(Exception::ConversionError, MSNumpressCoder().decodeNPRaw(corrupt, 11, out, config))
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 // Large test
 ///////////////////////////////////////////////////////////////////////////
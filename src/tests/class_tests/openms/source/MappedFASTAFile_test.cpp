@@ -0,0 +1,228 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/MappedFASTAFile.h>
+///////////////////////////
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MappedFASTAFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+MappedFASTAFile* ptr = nullptr;
+MappedFASTAFile* null_ptr = nullptr;
+START_SECTION((MappedFASTAFile()))
+  ptr = new MappedFASTAFile();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->isOpen(), false)
+  TEST_EQUAL(ptr->size(), 0)
+END_SECTION
+
+START_SECTION((virtual ~MappedFASTAFile()))
+  delete ptr;
+END_SECTION
+
+vector<FASTAFile::FASTAEntry> expected;
+FASTAFile().load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), expected);
+
+START_SECTION((MappedFASTAFile(const String& filename)))
+  TEST_EXCEPTION(Exception::FileNotFound, MappedFASTAFile("MappedFASTAFile_test_this_file_does_not_exist"))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(f.isOpen(), true)
+  TEST_EQUAL(f.size(), 5)
+END_SECTION
+
+START_SECTION((void open(const String& filename)))
+  MappedFASTAFile f;
+  TEST_EXCEPTION(Exception::FileNotFound, f.open("MappedFASTAFile_test_this_file_does_not_exist"))
+  TEST_EQUAL(f.isOpen(), false)
+  f.open(OPENMS_GET_TEST_DATA_PATH("degenerate_cases/empty.fasta"));
+  TEST_EQUAL(f.isOpen(), true)
+  TEST_EQUAL(f.size(), 0)
+  f.open(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(f.size(), 5)
+
+  // not a FASTA file
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    ofstream out(tmp_filename.c_str());
+    out << "no FASTA\n>id\nAAA\n";
+  }
+  TEST_EXCEPTION(Exception::ParseError, f.open(tmp_filename))
+  TEST_EQUAL(f.isOpen(), false)
+  TEST_EQUAL(f.size(), 0)
+END_SECTION
+
+START_SECTION((void close()))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  f.close();
+  TEST_EQUAL(f.isOpen(), false)
+  TEST_EQUAL(f.size(), 0)
+END_SECTION
+
+START_SECTION((bool isOpen() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size size() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((StringView getIdentifier(Size index) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(f.getIdentifier(0).getString(), "P68509|1433F_BOVIN")
+  TEST_EQUAL(f.getIdentifier(2).getString(), "sp|P31946|1433B_HUMAN")
+  TEST_EQUAL(f.getIdentifier(4).getString(), "test")
+END_SECTION
+
+START_SECTION((StringView getDescription(Size index) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(f.getDescription(0).getString(), "This is the description of the first protein")
+  TEST_EQUAL(f.getDescription(4).getString(), " ##0")
+END_SECTION
+
+START_SECTION((StringView getRawSequence(Size index) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  String raw = f.getRawSequence(1).getString();
+  TEST_EQUAL(raw.hasPrefix("TMDKSELVQKAKLAEQAERYDDMAAAMKAVTEQGHELSNEERNLLSVAYKNVVGARRSSW\n"), true)
+  TEST_EQUAL(raw.hasSuffix("GEGEN\n"), true)
+END_SECTION
+
+START_SECTION((void getSequence(Size index, String& sequence) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  String sequence;
+  for (Size i = 0; i < f.size(); ++i)
+  {
+    f.getSequence(i, sequence);
+    TEST_EQUAL(sequence, expected[i].sequence)
+  }
+END_SECTION
+
+START_SECTION((void getEntry(Size index, FASTAFile::FASTAEntry& entry) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  FASTAFile::FASTAEntry entry;
+  for (Size i = 0; i < f.size(); ++i)
+  {
+    f.getEntry(i, entry);
+    TEST_EQUAL(entry == expected[i], true)
+  }
+END_SECTION
+
+START_SECTION((void getEntries(Size first, Size count, std::vector<FASTAFile::FASTAEntry>& entries) const))
+  MappedFASTAFile f(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  vector<FASTAFile::FASTAEntry> entries;
+  f.getEntries(0, 100, entries);
+  TEST_EQUAL(entries == expected, true)
+  f.getEntries(3, 1, entries);
+  TEST_EQUAL(entries.size(), 1)
+  TEST_EQUAL(entries[0] == expected[3], true)
+  f.getEntries(5, 1, entries);
+  TEST_EQUAL(entries.empty(), true)
+END_SECTION
+
+START_SECTION([EXTRA] PEFF header and CRLF line endings)
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  {
+    ofstream out(tmp_filename.c_str(), ios::binary);
+    out << "# PEFF 1.0\n# DbName=test\n\n"
+        << ">id1 first entry \r\nAC DE\r\nF\tG\r\n"
+        << ">id2\n"
+        << ">id3\tthird > entry\nKK>\n\n"
+        << ">id4";
+  }
+  MappedFASTAFile f(tmp_filename);
+  TEST_EQUAL(f.size(), 4)
+  vector<FASTAFile::FASTAEntry> entries;
+  f.getEntries(0, f.size(), entries);
+  ABORT_IF(entries.size() != 4)
+  TEST_EQUAL(entries[0].identifier, "id1")
+  TEST_EQUAL(entries[0].description, "first entry")
+  TEST_EQUAL(entries[0].sequence, "ACDEFG")
+  TEST_EQUAL(entries[1].sequence, "")
+  TEST_EQUAL(entries[2].identifier, "id3")
+  TEST_EQUAL(entries[2].description, "third > entry")
+  TEST_EQUAL(entries[2].sequence, "KK>")
+  TEST_EQUAL(entries[3].identifier, "id4")
+  TEST_EQUAL(entries[3].sequence, "")
+END_SECTION
+
+START_SECTION([EXTRA] large file (indexed in several parts) against FASTAFile)
+{
+  // > 2 MB, i.e. split into several parts if more than one thread is used
+  const Size nr_proteins = 5000;
+  vector<FASTAFile::FASTAEntry> proteins;
+  const String aa = "ACDEFGHIKLMNPQRSTVWY";
+  Size seed = 1;
+  for (Size i = 0; i < nr_proteins; ++i)
+  {
+    String sequence(150 + i % 700, 'A');
+    for (Size j = 0; j < sequence.size(); ++j)
+    {
+      seed = seed * 1103515245 + 12345;
+      sequence[j] = aa[(seed >> 16) % aa.size()];
+    }
+    proteins.push_back(FASTAFile::FASTAEntry("sp|P" + String(i) + "|PROT_" + String(i), "protein number " + String(i), sequence));
+  }
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  tmp_filename += ".fasta";
+  FASTAFile().store(tmp_filename, proteins);
+
+  vector<FASTAFile::FASTAEntry> data;
+  FASTAFile().load(tmp_filename, data);
+
+  MappedFASTAFile f(tmp_filename);
+  vector<FASTAFile::FASTAEntry> entries;
+  f.getEntries(0, f.size(), entries);
+
+  TEST_EQUAL(entries.size(), nr_proteins)
+  TEST_EQUAL(entries == data, true)
+  TEST_EQUAL(entries == proteins, true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -350,6 +350,47 @@ START_SECTION([EXTRA] multithreaded example)
  }
 END_SECTION
 
+START_SECTION([EXTRA] multithreaded lookups with concurrent insertions)
+{
+  // name lookups do not lock, insertions (every 1000th iteration) are copy-on-write
+  ModificationsDB* mdb = ModificationsDB::getInstance();
+
+  const char* names[] = {"Oxidation", "Phospho", "Carbamidomethyl", "Acetyl", "Deamidated", "UniMod:35", "unimod:21", "Oxidation (M)"};
+  const char* residues[] = {"M", "S", "C", "K", "N", "M", "T", "M"};
+  const int nr_names = 8;
+
+  std::vector<const ResidueModification*> expected;
+  for (int i = 0; i < nr_names; ++i)
+  {
+    expected.push_back(mdb->getModification(names[i], residues[i]));
+  }
+
+  int nr_iterations(20000), nr_wrong(0), nr_added_found(0);
+  #pragma omp parallel for reduction (+: nr_wrong, nr_added_found)
+  for (int k = 0; k < nr_iterations; ++k)
+  {
+    int i = k % nr_names;
+    if (mdb->getModification(names[i], residues[i]) != expected[i]) ++nr_wrong;
+    if (!mdb->has(names[i])) ++nr_wrong;
+
+    if (k % 1000 == 0)
+    {
+      String modname = "stress_mod_" + String(k);
+      ResidueModification* new_mod = new ResidueModification();
+      new_mod->setFullId(modname);
+      new_mod->setDiffMonoMass(0.001 * k);
+      mdb->addModification(new_mod);
+      if (mdb->getModification(modname) == new_mod) ++nr_added_found;
+    }
+  }
+
+  TEST_EQUAL(nr_wrong, 0)
+  TEST_EQUAL(nr_added_found, nr_iterations / 1000)
+  TEST_EQUAL(mdb->has("stress_mod_0"), true)
+  TEST_EQUAL(mdb->findModificationIndex("stress_mod_1000") < mdb->getNumberOfModifications(), true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -44,6 +44,9 @@
 
 #include <QFile>
 
+#include <chrono>
+#include <thread>
+
 using namespace OpenMS;
 using namespace OpenMS::Internal;
 using namespace std;
@@ -638,6 +641,83 @@ START_SECTION(void writeChromatograms(const std::vector<MSChromatogram>& chroms)
 }
 END_SECTION
 
+START_SECTION(void startPipelinedWriting(Size nr_workers = 0, Size max_inflight_bytes = 512 * 1024 * 1024))
+{
+  MSExperiment exp_orig;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), exp_orig);
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+
+  // reference written directly
+  MSExperiment expected;
+  {
+    MzMLSqliteHandler handler(tmp_filename);
+    handler.setConfig(true, false, 0.0001, 2);
+    handler.createTables();
+    handler.writeSpectra(exp_orig.getSpectra());
+    handler.writeChromatograms(exp_orig.getChromatograms());
+    handler.writeChromatograms(exp_orig.getChromatograms());
+    handler.readExperiment(expected, false);
+  }
+
+  // one spectrum / chromatogram per chunk and a tiny memory limit to exercise the pipeline
+  {
+    MzMLSqliteHandler handler(tmp_filename);
+    handler.setConfig(true, false, 0.0001, 2);
+    handler.createTables();
+    handler.startPipelinedWriting(3, 1024);
+    TEST_EXCEPTION(Exception::IllegalArgument, handler.startPipelinedWriting())
+    handler.writeSpectra(exp_orig.getSpectra());
+    handler.writeChromatograms(exp_orig.getChromatograms());
+    handler.writeChromatograms(exp_orig.getChromatograms());
+    handler.finishPipelinedWriting();
+    handler.finishPipelinedWriting(); // no-op
+
+    TEST_EQUAL(handler.getNrSpectra(), exp_orig.getNrSpectra())
+    TEST_EQUAL(handler.getNrChromatograms(), 2 * exp_orig.getNrChromatograms())
+
+    MSExperiment tmp;
+    handler.readExperiment(tmp, false);
+    TEST_EQUAL(tmp.getNrSpectra(), expected.getNrSpectra())
+    TEST_EQUAL(tmp.getNrChromatograms(), expected.getNrChromatograms())
+    for (Size i = 0; i < tmp.getNrSpectra(); ++i)
+    {
+      TEST_EQUAL(tmp.getSpectra()[i].getNativeID(), expected.getSpectra()[i].getNativeID())
+      TEST_EQUAL(tmp.getSpectra()[i] == expected.getSpectra()[i], true)
+    }
+    for (Size i = 0; i < tmp.getNrChromatograms(); ++i)
+    {
+      TEST_EQUAL(tmp.getChromatograms()[i].getNativeID(), expected.getChromatograms()[i].getNativeID())
+      TEST_EQUAL(tmp.getChromatograms()[i] == expected.getChromatograms()[i], true)
+    }
+  }
+
+  // errors of the writer thread are reported by the next write and when finishing
+  QFile(String(tmp_filename).toQString()).remove();
+  {
+    MzMLSqliteHandler handler(tmp_filename);
+    handler.startPipelinedWriting(1);
+    bool write_failed = false;
+    for (Size k = 0; k < 1000 && !write_failed; ++k)
+    {
+      try
+      {
+        handler.writeChromatograms(exp_orig.getChromatograms()); // no tables
+      }
+      catch (Exception::IllegalArgument&)
+      {
+        write_failed = true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    TEST_EQUAL(write_failed, true)
+    TEST_EXCEPTION(Exception::IllegalArgument, handler.writeSpectra(exp_orig.getSpectra()))
+    TEST_EXCEPTION(Exception::IllegalArgument, handler.finishPipelinedWriting())
+  }
+}
+END_SECTION
+
 // reset error tolerances to default values
 TOLERANCE_ABSOLUTE(1e-5)
 TOLERANCE_RELATIVE(1+1e-5)
@@ -108,6 +108,96 @@ START_SECTION(static void selectSwathTransitions(const OpenMS::TargetedExperimen
 }
 END_SECTION
 
+START_SECTION(static void selectSwathTransitions(const OpenSwath::LightTargetedExperiment &targeted_exp, const TransitionIndex &index, OpenSwath::LightTargetedExperiment &transition_exp_used, double min_upper_edge_dist, double lower, double upper))
+{
+  LightTargetedExperiment exp1;
+
+  LightTransition tr;
+  double mz[] = {300.0, 100.0, 200.0, 250.0, 200.0, 499.5};
+  const char* refs[] = {"pep3", "pep1", "pep2", "pep_missing", "pep2", "pep4"};
+  for (Size i = 0; i < 6; ++i)
+  {
+    tr.transition_name = String("tr") + String(i);
+    tr.precursor_mz = mz[i];
+    tr.peptide_ref = refs[i];
+    exp1.transitions.push_back(tr);
+  }
+  LightCompound pep;
+  const char* peps[] = {"pep1", "pep2", "pep3", "pep4"};
+  for (Size i = 0; i < 4; ++i)
+  {
+    pep.id = peps[i];
+    pep.protein_refs.clear();
+    pep.protein_refs.push_back(i < 2 ? "prot1" : "prot2");
+    exp1.compounds.push_back(pep);
+  }
+  LightProtein prot;
+  prot.id = "prot2"; exp1.proteins.push_back(prot);
+  prot.id = "prot1"; exp1.proteins.push_back(prot);
+
+  OpenSwathHelper::TransitionIndex index(exp1);
+  double windows[][3] = { {1.0, 199.9, 500}, {0.0, 0, 1000}, {1.0, 0, 100}, {0.0, 200, 300}, {0.0, 1000, 2000} };
+  for (Size w = 0; w < 5; ++w)
+  {
+    LightTargetedExperiment exp2, exp3;
+    OpenSwathHelper::selectSwathTransitions(exp1, exp2, windows[w][0], windows[w][1], windows[w][2]);
+    OpenSwathHelper::selectSwathTransitions(exp1, index, exp3, windows[w][0], windows[w][1], windows[w][2]);
+    TEST_EQUAL(exp3.transitions.size(), exp2.transitions.size())
+    for (Size i = 0; i < std::min(exp2.transitions.size(), exp3.transitions.size()); ++i)
+    {
+      TEST_EQUAL(exp3.transitions[i].transition_name, exp2.transitions[i].transition_name)
+    }
+    TEST_EQUAL(exp3.compounds.size(), exp2.compounds.size())
+    for (Size i = 0; i < std::min(exp2.compounds.size(), exp3.compounds.size()); ++i)
+    {
+      TEST_EQUAL(exp3.compounds[i].id, exp2.compounds[i].id)
+    }
+    TEST_EQUAL(exp3.proteins.size(), exp2.proteins.size())
+    for (Size i = 0; i < std::min(exp2.proteins.size(), exp3.proteins.size()); ++i)
+    {
+      TEST_EQUAL(exp3.proteins[i].id, exp2.proteins[i].id)
+    }
+  }
+
+  // select all transitions between 200 and 500 (excluding the upper edge)
+  LightTargetedExperiment exp4;
+  OpenSwathHelper::selectSwathTransitions(exp1, index, exp4, 1.0, 199.9, 500);
+  TEST_EQUAL(exp4.transitions.size(), 4)
+  TEST_EQUAL(exp4.transitions[0].transition_name, "tr0")
+  TEST_EQUAL(exp4.transitions[3].transition_name, "tr4")
+  TEST_EQUAL(exp4.compounds.size(), 2)
+  TEST_EQUAL(exp4.proteins.size(), 2)
+}
+END_SECTION
+
+START_SECTION(static void selectTransitions(const OpenSwath::LightTargetedExperiment &targeted_exp, const TransitionIndex &index, std::vector<Size> &transitions, OpenSwath::LightTargetedExperiment &selected_transitions))
+{
+  LightTargetedExperiment exp1;
+  LightTransition tr;
+  tr.transition_name = "tr0"; tr.peptide_ref = "pep2"; exp1.transitions.push_back(tr);
+  tr.transition_name = "tr1"; tr.peptide_ref = "pep1"; exp1.transitions.push_back(tr);
+  tr.transition_name = "tr2"; tr.peptide_ref = "pep2"; exp1.transitions.push_back(tr);
+  LightCompound pep;
+  pep.id = "pep1"; pep.protein_refs.push_back("prot1"); exp1.compounds.push_back(pep);
+  pep.id = "pep2"; pep.protein_refs.clear(); exp1.compounds.push_back(pep);
+  LightProtein prot;
+  prot.id = "prot1"; exp1.proteins.push_back(prot);
+
+  OpenSwathHelper::TransitionIndex index(exp1);
+  std::vector<Size> selection;
+  selection.push_back(2);
+  selection.push_back(0);
+  LightTargetedExperiment exp2;
+  OpenSwathHelper::selectTransitions(exp1, index, selection, exp2);
+  TEST_EQUAL(exp2.transitions.size(), 2)
+  TEST_EQUAL(exp2.transitions[0].transition_name, "tr0")
+  TEST_EQUAL(exp2.transitions[1].transition_name, "tr2")
+  TEST_EQUAL(exp2.compounds.size(), 1)
+  TEST_EQUAL(exp2.compounds[0].id, "pep2")
+  TEST_EQUAL(exp2.proteins.size(), 0)
+}
+END_SECTION
+
 START_SECTION(static void selectSwathTransitions(const OpenSwath::LightTargetedExperiment &targeted_exp, OpenSwath::LightTargetedExperiment &transition_exp_used, double min_upper_edge_dist, double lower, double upper))
 {
   LightTargetedExperiment exp1;
@@ -0,0 +1,288 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/SqliteConnector.h>
+
+#include <sqlite3.h>
+
+#include <cmath>
+
+using namespace OpenMS;
+using namespace std;
+
+// a feature map with two features, each with two transitions and one precursor trace
+FeatureMap createFeatures()
+{
+  FeatureMap features;
+  for (Size i = 0; i < 2; ++i)
+  {
+    Feature f;
+    f.setUniqueId(1000 + i);
+    f.setRT(1234.56789012345 + i);
+    f.setIntensity(98765.4321f);
+    f.setMetaValue("leftWidth", 1230.123456789);
+    f.setMetaValue("rightWidth", 1240.987654321);
+    f.setMetaValue("norm_RT", 55.123456789);
+    f.setMetaValue("delta_rt", 0.987654321);
+    f.setMetaValue("total_xic", 1000000.123456);
+    f.setMetaValue("peak_apices_sum", 5555.55555);
+    f.setMetaValue("var_xcorr_coelution", 1.23456789);
+    f.setMetaValue("var_library_corr", -0.123456789);
+    f.setMetaValue("ms1_area_intensity", 1000.5);
+    f.setMetaValue("ms1_apex_intensity", 200.25);
+    f.setMetaValue("var_ms1_ppm_diff", 2.123456789);
+
+    std::vector<Feature> subordinates;
+    for (Size k = 0; k < 2; ++k)
+    {
+      Feature sub;
+      sub.setMetaValue("FeatureLevel", "MS2");
+      sub.setMetaValue("native_id", String(101 + k));
+      sub.setIntensity(500.125f + k);
+      sub.setMetaValue("total_xic", 9999.987654321);
+      sub.setMetaValue("peak_apex_int", 77.7777777);
+      subordinates.push_back(sub);
+    }
+    Feature ms1;
+    ms1.setMetaValue("FeatureLevel", "MS1");
+    ms1.setMetaValue("native_id", "PEPTIDE_Precursor_i0");
+    ms1.setIntensity(321.5f);
+    ms1.setMetaValue("peak_apex_int", 12.3456789);
+    subordinates.push_back(ms1);
+    f.setSubordinates(subordinates);
+
+    features.push_back(f);
+  }
+  return features;
+}
+
+// all rows of an OSW table (in insertion order) as typed values
+std::vector<std::vector<DataValue> > readTable(const String& filename, const String& table)
+{
+  SqliteConnector conn(filename);
+  sqlite3_stmt* stmt = nullptr;
+  conn.executePreparedStatement(&stmt, "SELECT * FROM " + table + " ORDER BY rowid;");
+  std::vector<std::vector<DataValue> > rows;
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    std::vector<DataValue> row;
+    for (int k = 0; k < sqlite3_column_count(stmt); ++k)
+    {
+      switch (sqlite3_column_type(stmt, k))
+      {
+        case SQLITE_INTEGER:
+          row.push_back(DataValue(static_cast<long long>(sqlite3_column_int64(stmt, k))));
+          break;
+        case SQLITE_FLOAT:
+          row.push_back(DataValue(sqlite3_column_double(stmt, k)));
+          break;
+        case SQLITE_NULL:
+          row.push_back(DataValue());
+          break;
+        default:
+          row.push_back(DataValue(String(reinterpret_cast<const char*>(sqlite3_column_text(stmt, k)))));
+      }
+    }
+    rows.push_back(row);
+  }
+  sqlite3_finalize(stmt);
+  return rows;
+}
+
+START_TEST(OpenSwathOSWWriter, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathOSWWriter* ptr = nullptr;
+OpenSwathOSWWriter* nullPointer = nullptr;
+
+START_SECTION(OpenSwathOSWWriter(const String& output_filename, const String& input_filename = "inputfile", bool ms1_scores = false, bool sonar = false, bool uis_scores = false))
+{
+  ptr = new OpenSwathOSWWriter("");
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isActive(), false)
+  delete ptr;
+
+  ptr = new OpenSwathOSWWriter("out.osw");
+  TEST_EQUAL(ptr->isActive(), true)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(FeatureRecords prepareRecords(const OpenSwath::LightCompound& pep, const OpenSwath::LightTransition* transition, FeatureMap& output, String id) const)
+{
+  OpenSwathOSWWriter writer("out.osw", "input.mzML", true);
+  OpenSwath::LightCompound pep;
+  FeatureMap features = createFeatures();
+  OpenSwathOSWWriter::FeatureRecords records = writer.prepareRecords(pep, nullptr, features, "42");
+
+  TEST_EQUAL(records.nrFeatures(), 2)
+  TEST_EQUAL(records.feature.size(), 2 * 8)
+  TEST_EQUAL(records.feature_ms1.size(), 2 * 15)
+  TEST_EQUAL(records.feature_precursor.size(), 2 * 4)
+  TEST_EQUAL(records.feature_ms2.size(), 2 * 36)
+  TEST_EQUAL(records.feature_transition.size(), 2 * 2 * 17)
+  TEST_EQUAL(records.nrRows(), 2 + 2 + 2 + 2 + 4)
+
+  // full double precision
+  TEST_EQUAL(records.feature[3] == DataValue(1234.56789012345), true)
+  TEST_EQUAL(records.feature[2].toString(), "42")
+}
+END_SECTION
+
+START_SECTION(void writeRecords(std::vector<FeatureRecords>& records))
+{
+  // the asynchronous path writes the same rows as prepareLine / writeLines
+  OpenSwath::LightCompound pep;
+  FeatureMap features = createFeatures();
+
+  String sync_file, async_file;
+  NEW_TMP_FILE(sync_file);
+  NEW_TMP_FILE(async_file);
+
+  UniqueIdGenerator::setSeed(42); // same run id in both files
+  OpenSwathOSWWriter sync_writer(sync_file, "input.mzML", true);
+  sync_writer.writeHeader();
+  std::vector<String> lines(1, sync_writer.prepareLine(pep, nullptr, features, "42"));
+  sync_writer.writeLines(lines);
+
+  UniqueIdGenerator::setSeed(42);
+  OpenSwathOSWWriter async_writer(async_file, "input.mzML", true);
+  async_writer.writeHeader();
+  async_writer.startAsyncWriting();
+  std::vector<OpenSwathOSWWriter::FeatureRecords> records(1, async_writer.prepareRecords(pep, nullptr, features, "42"));
+  async_writer.writeRecords(records);
+  TEST_EQUAL(records.empty(), true)
+  async_writer.finishAsyncWriting();
+
+  const char* tables[] = {"RUN", "FEATURE", "FEATURE_MS1", "FEATURE_PRECURSOR", "FEATURE_MS2", "FEATURE_TRANSITION"};
+  for (const char* table : tables)
+  {
+    std::vector<std::vector<DataValue> > sync_rows = readTable(sync_file, table);
+    std::vector<std::vector<DataValue> > async_rows = readTable(async_file, table);
+    TEST_EQUAL(sync_rows.empty(), false)
+    TEST_EQUAL(async_rows.size(), sync_rows.size())
+    ABORT_IF(async_rows.size() != sync_rows.size())
+    for (Size i = 0; i < sync_rows.size(); ++i)
+    {
+      TEST_EQUAL(async_rows[i].size(), sync_rows[i].size())
+      ABORT_IF(async_rows[i].size() != sync_rows[i].size())
+      for (Size k = 0; k < sync_rows[i].size(); ++k)
+      {
+        TEST_EQUAL(async_rows[i][k].valueType(), sync_rows[i][k].valueType())
+        if (sync_rows[i][k].valueType() == DataValue::DOUBLE_VALUE)
+        {
+          TEST_REAL_SIMILAR(double(async_rows[i][k]), double(sync_rows[i][k]))
+        }
+        else
+        {
+          TEST_EQUAL(async_rows[i][k].toString(), sync_rows[i][k].toString())
+        }
+      }
+    }
+  }
+
+  // values are stored at full double precision (not only six significant digits)
+  std::vector<std::vector<DataValue> > async_features = readTable(async_file, "FEATURE");
+  std::vector<std::vector<DataValue> > sync_features = readTable(sync_file, "FEATURE");
+  TEST_EQUAL(async_features[0][3] == DataValue(1234.56789012345), true)
+  TEST_EQUAL(std::fabs(double(sync_features[0][3]) - 1234.56789012345) < 1e-9, true)
+  TEST_EQUAL(std::fabs(double(sync_features[0][6]) - 1230.123456789) < 1e-9, true)
+}
+END_SECTION
+
+START_SECTION(void startAsyncWriting(Size max_queued_batches = 0))
+{
+  OpenSwath::LightCompound pep;
+  FeatureMap features = createFeatures();
+  String file;
+  NEW_TMP_FILE(file);
+
+  // a single queued batch, the writer thread has to keep up
+  OpenSwathOSWWriter writer(file, "input.mzML");
+  writer.writeHeader();
+  writer.startAsyncWriting(1);
+  for (Size i = 0; i < 10; ++i)
+  {
+    for (Feature& f : features) f.setUniqueId(f.getUniqueId() + 2);
+    std::vector<OpenSwathOSWWriter::FeatureRecords> records(1, writer.prepareRecords(pep, nullptr, features, "42"));
+    writer.writeRecords(records);
+  }
+  writer.finishAsyncWriting();
+  TEST_EQUAL(readTable(file, "FEATURE").size(), 20)
+  TEST_EQUAL(readTable(file, "FEATURE_TRANSITION").size(), 40)
+}
+END_SECTION
+
+START_SECTION(void finishAsyncWriting())
+{
+  OpenSwath::LightCompound pep;
+  FeatureMap features = createFeatures();
+  String file;
+  NEW_TMP_FILE(file);
+
+  OpenSwathOSWWriter writer(file, "input.mzML");
+  writer.writeHeader();
+  writer.startAsyncWriting();
+  OpenSwathOSWWriter copy(writer); // shares the writer thread
+  writer.finishAsyncWriting();
+  writer.finishAsyncWriting(); // no-op
+
+  // records passed after the thread was stopped are written directly (no exception)
+  std::vector<OpenSwathOSWWriter::FeatureRecords> records(1, copy.prepareRecords(pep, nullptr, features, "42"));
+  copy.writeRecords(records);
+  TEST_EQUAL(readTable(file, "FEATURE").size(), 2)
+
+  // errors of the writer thread are reported (no tables)
+  String file_no_tables;
+  NEW_TMP_FILE(file_no_tables);
+  OpenSwathOSWWriter no_tables(file_no_tables, "input.mzML");
+  no_tables.startAsyncWriting();
+  records.assign(1, no_tables.prepareRecords(pep, nullptr, features, "42"));
+  no_tables.writeRecords(records);
+  TEST_EXCEPTION(Exception::IllegalArgument, no_tables.finishAsyncWriting())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -112,6 +112,13 @@ START_SECTION((void calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature, cons
 }
 END_SECTION
 
+START_SECTION((void calculateDIAScoresBatch(std::vector<DIAScoringTask>& tasks, const std::vector<OpenSwath::SwathMap>& swath_maps, OpenSwath::SpectrumAccessPtr ms1_map, OpenMS::DIAScoring& diascoring)))
+{
+  NOT_TESTABLE // see MRMFeatureFinderScoring_test.cpp (precomputeDIAScores)
+  // - the OpenSwathScoring is a facade and thus does not need testing on its own
+}
+END_SECTION
+
 START_SECTION((void getNormalized_library_intensities_(const std::vector<TransitionType> & transitions, std::vector<double>& normalized_library_intensity)))
 {
   NOT_TESTABLE // see MRMFeatureFinderScoring_test.cpp
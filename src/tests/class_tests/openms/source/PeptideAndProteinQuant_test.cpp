@@ -44,6 +44,44 @@
 using namespace OpenMS;
 using namespace std;
 
+// adds a consensus feature for a peptide (intensity zero: not quantified in that map)
+void addPeptide(ConsensusMap& consensus, const String& seq, Int charge,
+                const String& accession, const vector<double>& intensities)
+{
+  PeptideHit hit;
+  hit.setSequence(AASequence::fromString(seq));
+  hit.setCharge(charge);
+  PeptideEvidence evidence;
+  evidence.setProteinAccession(accession);
+  hit.addPeptideEvidence(evidence);
+  PeptideIdentification peptide;
+  peptide.insertHit(hit);
+
+  ConsensusFeature feature;
+  feature.getPeptideIdentifications().push_back(peptide);
+  for (Size i = 0; i < intensities.size(); ++i)
+  {
+    if (intensities[i] <= 0) continue;
+    FeatureHandle handle;
+    handle.setMapIndex(i);
+    handle.setUniqueId(consensus.size() * intensities.size() + i + 1);
+    handle.setIntensity(intensities[i]);
+    feature.insert(handle);
+  }
+  consensus.push_back(feature);
+}
+
+ConsensusMap createConsensusMap(Size n_maps)
+{
+  ConsensusMap consensus;
+  consensus.setExperimentType("label-free");
+  for (Size i = 0; i < n_maps; ++i)
+  {
+    consensus.getColumnHeaders()[i].filename = "sample" + String(i + 1) + ".mzML";
+  }
+  return consensus;
+}
+
 
 START_TEST(PeptideAndProteinQuant, "$Id$")
 
@@ -357,6 +395,97 @@ START_SECTION((const ProteinQuant& getProteinResults()))
 }
 END_SECTION
 
+// peptide and protein roll-ups with different options
+START_SECTION(([EXTRA] Aggregation options))
+{
+  ConsensusMap consensus = createConsensusMap(3);
+  addPeptide(consensus, "PEPTIDEK", 2, "A", ListUtils::create<double>("100,200,300"));
+  addPeptide(consensus, "PEPTIDEK", 3, "A", ListUtils::create<double>("10,0,0"));
+  addPeptide(consensus, "PEPTIDEM(Oxidation)K", 2, "A", ListUtils::create<double>("50,50,0"));
+  addPeptide(consensus, "PEPTIDEMK", 2, "A", ListUtils::create<double>("50,0,400"));
+  addPeptide(consensus, "SAMPLER", 2, "B", ListUtils::create<double>("0.4,0.4,0"));
+  addPeptide(consensus, "SAMPLER", 3, "B", ListUtils::create<double>("0,0,2"));
+  ExperimentalDesign design = ExperimentalDesign::fromConsensusMap(consensus);
+
+  PeptideAndProteinQuant quantifier;
+  Param parameters;
+  parameters.setValue("top", 0);
+  parameters.setValue("average", "sum");
+  quantifier.setParameters(parameters);
+  quantifier.readQuantData(consensus, design);
+  quantifier.quantifyPeptides();
+  quantifier.quantifyProteins();
+
+  PeptideAndProteinQuant::PeptideQuant pep_quant = quantifier.getPeptideResults();
+  TEST_EQUAL(pep_quant.size(), 4);
+  PeptideAndProteinQuant::PeptideData pep_data = pep_quant[AASequence::fromString("PEPTIDEK")];
+  TEST_EQUAL(pep_data.id_count, 2);
+  TEST_EQUAL(pep_data.abundances[1].size(), 2); // two charges
+  TEST_EQUAL(pep_data.abundances[1][3].size(), 1);
+  TEST_EQUAL(pep_data.total_abundances.size(), 3);
+  TEST_REAL_SIMILAR(pep_data.total_abundances[1], 110);
+  TEST_REAL_SIMILAR(pep_data.total_abundances[3], 300);
+  pep_data = pep_quant[AASequence::fromString("PEPTIDEM(Oxidation)K")];
+  TEST_EQUAL(pep_data.total_abundances.size(), 2);
+  TEST_EQUAL(pep_data.total_abundances.count(3), 0);
+
+  // modified and unmodified forms of a peptide are combined:
+  PeptideAndProteinQuant::ProteinQuant prot_quant = quantifier.getProteinResults();
+  TEST_EQUAL(prot_quant.size(), 2);
+  PeptideAndProteinQuant::ProteinData prot_data = prot_quant["A"];
+  TEST_EQUAL(prot_data.id_count, 4);
+  TEST_EQUAL(prot_data.abundances.size(), 2);
+  TEST_REAL_SIMILAR(prot_data.abundances["PEPTIDEMK"][1], 100);
+  TEST_REAL_SIMILAR(prot_data.abundances["PEPTIDEMK"][2], 50);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[1], 210);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[2], 250);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[3], 700);
+  prot_data = prot_quant["B"];
+  TEST_REAL_SIMILAR(prot_data.total_abundances[1], 0.4);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[3], 2);
+
+  // top peptide per sample:
+  parameters.setValue("top", 1);
+  parameters.setValue("average", "median");
+  quantifier.setParameters(parameters);
+  quantifier.readQuantData(consensus, design);
+  quantifier.quantifyPeptides();
+  quantifier.quantifyProteins();
+  prot_data = quantifier.getProteinResults().find("A")->second;
+  TEST_REAL_SIMILAR(prot_data.total_abundances[1], 110);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[2], 200);
+  TEST_REAL_SIMILAR(prot_data.total_abundances[3], 400);
+
+  // best charge state (the one quantified in most samples, even if the
+  // abundances are small):
+  parameters.setValue("top", 0);
+  parameters.setValue("average", "sum");
+  parameters.setValue("best_charge_and_fraction", "true");
+  quantifier.setParameters(parameters);
+  quantifier.readQuantData(consensus, design);
+  quantifier.quantifyPeptides();
+  pep_quant = quantifier.getPeptideResults();
+  pep_data = pep_quant[AASequence::fromString("PEPTIDEK")];
+  TEST_REAL_SIMILAR(pep_data.total_abundances[1], 100);
+  pep_data = pep_quant[AASequence::fromString("SAMPLER")];
+  TEST_EQUAL(pep_data.total_abundances.size(), 2);
+  TEST_REAL_SIMILAR(pep_data.total_abundances[2], 0.4);
+  TEST_EQUAL(quantifier.getStatistics().quant_peptides, 4);
+
+  // normalization to equal medians (50, 50 and 300 before):
+  parameters.setValue("best_charge_and_fraction", "false");
+  parameters.setValue("consensus:normalize", "true");
+  quantifier.setParameters(parameters);
+  quantifier.readQuantData(consensus, design);
+  quantifier.quantifyPeptides();
+  pep_quant = quantifier.getPeptideResults();
+  pep_data = pep_quant[AASequence::fromString("PEPTIDEK")];
+  TEST_REAL_SIMILAR(pep_data.total_abundances[1], 110);
+  TEST_REAL_SIMILAR(pep_data.total_abundances[3], 50);
+  TEST_REAL_SIMILAR(pep_data.abundances[1][2][3], 50);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -185,6 +185,43 @@ START_SECTION((void setSequence(const AASequence& sequence)))
 END_SECTION
 
         ;
+START_SECTION((void setSequence(const std::shared_ptr<const AASequence>& sequence)))
+	std::shared_ptr<const AASequence> shared = std::make_shared<AASequence>(sequence);
+	PeptideHit hit1, hit2;
+	hit1.setSequence(shared);
+	hit2.setSequence(shared);
+	TEST_EQUAL(hit1.getSequence(), sequence)
+	TEST_EQUAL(&hit1.getSequence() == &hit2.getSequence(), true)
+	// setting a new sequence only affects this hit
+	hit1.setSequence(AASequence::fromString("PEPTIDE"));
+	TEST_EQUAL(hit1.getSequence(), AASequence::fromString("PEPTIDE"))
+	TEST_EQUAL(hit2.getSequence(), sequence)
+	TEST_EQUAL(*shared, sequence)
+END_SECTION
+
+START_SECTION((const std::shared_ptr<const AASequence>& getSharedSequence() const))
+	PeptideHit hit;
+	TEST_EQUAL(hit.getSharedSequence() == nullptr, true)
+	TEST_EQUAL(hit.getSequence().empty(), true)
+	// sequences set by value are not shared
+	hit.setSequence(sequence);
+	TEST_EQUAL(hit.getSharedSequence() == nullptr, true)
+	TEST_EQUAL(PeptideHit(score, rank, charge, sequence).getSharedSequence() == nullptr, true)
+	hit.setSequence(std::make_shared<AASequence>(sequence));
+	TEST_EQUAL(*hit.getSharedSequence(), sequence)
+	// copies share the sequence
+	PeptideHit copy(hit);
+	TEST_EQUAL(copy.getSharedSequence() == hit.getSharedSequence(), true)
+	TEST_EQUAL(copy == hit, true)
+	copy.setSequence(AASequence::fromString("PEPTIDE"));
+	TEST_EQUAL(copy.getSharedSequence() == nullptr, true)
+	TEST_EQUAL(copy.getSequence(), AASequence::fromString("PEPTIDE"))
+	TEST_EQUAL(hit.getSequence(), sequence)
+	// shared and unshared hits with the same sequence are equal
+	copy.setSequence(sequence);
+	TEST_EQUAL(copy == hit, true)
+END_SECTION
+
 START_SECTION((void setPeptideEvidences(const vector<PeptideEvidence> & peptide_evidences)))
      PeptideHit hit;
      vector<PeptideEvidence> pes(2, PeptideEvidence());
@@ -0,0 +1,190 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FILTERING/ID/ProteinAccessionIndex.h>
+
+///////////////////////////
+
+START_TEST(ProteinAccessionIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+vector<ProteinIdentification> proteins(3);
+proteins[0].setIdentifier("run1");
+proteins[1].setIdentifier("run2");
+proteins[2].setIdentifier("run1"); // same run as the first one
+proteins[0].getHits().resize(2);
+proteins[0].getHits()[0].setAccession("A");
+proteins[0].getHits()[1].setAccession("B");
+proteins[1].getHits().resize(2);
+proteins[1].getHits()[0].setAccession("B");
+proteins[1].getHits()[1].setAccession("C");
+proteins[2].getHits().resize(1);
+proteins[2].getHits()[0].setAccession("D");
+
+ProteinAccessionIndex* ptr = nullptr;
+ProteinAccessionIndex* null_ptr = nullptr;
+START_SECTION((ProteinAccessionIndex()))
+{
+  ptr = new ProteinAccessionIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNrRuns(), 0)
+}
+END_SECTION
+
+START_SECTION((~ProteinAccessionIndex()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((explicit ProteinAccessionIndex(const std::vector<ProteinIdentification>& proteins)))
+{
+  ProteinAccessionIndex index(proteins);
+  TEST_EQUAL(index.size(), 4)
+  TEST_EQUAL(index.getNrRuns(), 2)
+}
+END_SECTION
+
+START_SECTION((UInt32 find(const String& accession) const))
+{
+  ProteinAccessionIndex index(proteins);
+  // ids are assigned in order of appearance
+  TEST_EQUAL(index.find("A"), 0)
+  TEST_EQUAL(index.find("B"), 1)
+  TEST_EQUAL(index.find("C"), 2)
+  TEST_EQUAL(index.find("D"), 3)
+  TEST_EQUAL(index.find("E"), ProteinAccessionIndex::NOT_FOUND)
+}
+END_SECTION
+
+START_SECTION((UInt32 insert(const String& accession)))
+{
+  ProteinAccessionIndex index(proteins);
+  TEST_EQUAL(index.insert("B"), 1)
+  TEST_EQUAL(index.insert("E"), 4)
+  TEST_EQUAL(index.size(), 5)
+  TEST_EQUAL(index.find("E"), 4)
+}
+END_SECTION
+
+START_SECTION((const String& getAccession(UInt32 id) const))
+{
+  ProteinAccessionIndex index(proteins);
+  TEST_EQUAL(index.getAccession(2), "C")
+  TEST_EXCEPTION(std::out_of_range, index.getAccession(4))
+}
+END_SECTION
+
+START_SECTION((UInt32 findRun(const String& identifier) const))
+{
+  ProteinAccessionIndex index(proteins);
+  TEST_EQUAL(index.findRun("run1"), 0)
+  TEST_EQUAL(index.findRun("run2"), 1)
+  TEST_EQUAL(index.findRun("run3"), ProteinAccessionIndex::NOT_FOUND)
+}
+END_SECTION
+
+START_SECTION((bool isInRun(UInt32 id, UInt32 run) const))
+{
+  ProteinAccessionIndex index(proteins);
+  UInt32 run1 = index.findRun("run1"), run2 = index.findRun("run2");
+  TEST_EQUAL(index.isInRun(index.find("A"), run1), true)
+  TEST_EQUAL(index.isInRun(index.find("A"), run2), false)
+  TEST_EQUAL(index.isInRun(index.find("B"), run1), true)
+  TEST_EQUAL(index.isInRun(index.find("B"), run2), true)
+  TEST_EQUAL(index.isInRun(index.find("D"), run1), true)
+  TEST_EQUAL(index.isInRun(index.find("D"), run2), false)
+  TEST_EQUAL(index.isInRun(ProteinAccessionIndex::NOT_FOUND, run1), false)
+  TEST_EQUAL(index.isInRun(index.find("A"), ProteinAccessionIndex::NOT_FOUND), false)
+  // accessions added later are in no run
+  TEST_EQUAL(index.isInRun(index.insert("E"), run1), false)
+}
+END_SECTION
+
+START_SECTION((void removeFromRun(UInt32 id, UInt32 run)))
+{
+  ProteinAccessionIndex index(proteins);
+  index.removeFromRun(index.find("B"), index.findRun("run2"));
+  TEST_EQUAL(index.isInRun(index.find("B"), index.findRun("run1")), true)
+  TEST_EQUAL(index.isInRun(index.find("B"), index.findRun("run2")), false)
+  index.removeFromRun(ProteinAccessionIndex::NOT_FOUND, 0); // no effect
+  TEST_EQUAL(index.size(), 4)
+}
+END_SECTION
+
+START_SECTION((void build(const std::vector<ProteinIdentification>& proteins)))
+{
+  ProteinAccessionIndex index(proteins);
+  vector<ProteinIdentification> filtered = proteins;
+  filtered[0].getHits().resize(1); // removes "B" from run1
+  index.insert("E");
+  index.build(filtered);
+  // ids are kept
+  TEST_EQUAL(index.size(), 5)
+  TEST_EQUAL(index.find("B"), 1)
+  TEST_EQUAL(index.find("E"), 4)
+  TEST_EQUAL(index.isInRun(index.find("B"), index.findRun("run1")), false)
+  TEST_EQUAL(index.isInRun(index.find("B"), index.findRun("run2")), true)
+}
+END_SECTION
+
+START_SECTION((std::vector<char> createMask(const std::set<String>& accessions)))
+{
+  ProteinAccessionIndex index(proteins);
+  set<String> accessions;
+  accessions.insert("C");
+  accessions.insert("X");
+  vector<char> mask = index.createMask(accessions);
+  TEST_EQUAL(index.size(), 5) // "X" was added
+  TEST_EQUAL(mask.size(), 5)
+  TEST_EQUAL(mask[index.find("A")], 0)
+  TEST_EQUAL(mask[index.find("C")], 1)
+  TEST_EQUAL(mask[index.find("X")], 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,190 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace OpenMS;
+using namespace std;
+
+///////////////////////////
+
+// reads the whole stream in pieces of @p n bytes
+static String readAll(ReadAheadDecompressor& stream, Size n)
+{
+  String result;
+  vector<char> buffer(n);
+  while (!stream.streamEnd())
+  {
+    size_t len = stream.read(&buffer[0], n);
+    result.append(&buffer[0], len);
+  }
+  return result;
+}
+
+START_TEST(ReadAheadDecompressor, "$Id$")
+
+ifstream plain_file(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"), ios::binary);
+stringstream plain_stream;
+plain_stream << plain_file.rdbuf();
+String plain = plain_stream.str();
+
+ReadAheadDecompressor* ptr = nullptr;
+ReadAheadDecompressor* nullPointer = nullptr;
+START_SECTION((ReadAheadDecompressor()))
+  ptr = new ReadAheadDecompressor;
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isOpen(), false)
+  TEST_EQUAL(ptr->streamEnd(), true)
+END_SECTION
+
+START_SECTION((virtual ~ReadAheadDecompressor()))
+  delete ptr;
+END_SECTION
+
+START_SECTION((ReadAheadDecompressor(const char* filename, Size nr_threads = 0, Size chunk_size = 1024 * 1024)))
+  TEST_EXCEPTION(Exception::FileNotFound, ReadAheadDecompressor stream(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")))
+  ReadAheadDecompressor stream(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+  TEST_EQUAL(stream.isOpen(), true)
+  TEST_EQUAL(stream.streamEnd(), false)
+END_SECTION
+
+START_SECTION((size_t read(char* s, size_t n)))
+  char buffer[31];
+  buffer[30] = buffer[29] = '\0';
+  ReadAheadDecompressor gzip(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1.gz"));
+  TEST_EQUAL(gzip.read(buffer, 10), 10)
+  TEST_EQUAL(gzip.read(&buffer[10], 10), 10)
+  TEST_EQUAL(gzip.read(&buffer[20], 9), 9)
+  TEST_EQUAL(String(buffer), "Was decompression successful?")
+  TEST_EQUAL(gzip.isOpen(), true)
+  TEST_EQUAL(gzip.read(&buffer[29], 10), 1)
+  TEST_EQUAL(gzip.isOpen(), false)
+  TEST_EQUAL(gzip.streamEnd(), true)
+  TEST_EXCEPTION(Exception::IllegalArgument, gzip.read(buffer, 10))
+
+  ReadAheadDecompressor bzip2(OPENMS_GET_TEST_DATA_PATH("Bzip2IfStream_1.bz2"));
+  TEST_EQUAL(bzip2.read(buffer, 29), 29)
+  buffer[29] = '\0';
+  TEST_EQUAL(String(buffer), "Was decompression successful?")
+  TEST_EQUAL(bzip2.read(buffer, 10), 1)
+  TEST_EQUAL(bzip2.isOpen(), false)
+
+  // uncompressed files are passed through
+  ReadAheadDecompressor text(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta"));
+  TEST_EQUAL(readAll(text, 100) == plain, true)
+
+  // corrupt files: the error is raised after the data decompressed before it
+  ReadAheadDecompressor gzip_corrupt(OPENMS_GET_TEST_DATA_PATH("GzipIfStream_1_corrupt.gz"));
+  TEST_EXCEPTION(Exception::ConversionError, readAll(gzip_corrupt, 10))
+  TEST_EQUAL(gzip_corrupt.isOpen(), false)
+  ReadAheadDecompressor bzip2_corrupt(OPENMS_GET_TEST_DATA_PATH("Bzip2IfStream_1_corrupt.bz2"));
+  TEST_EXCEPTION(Exception::ParseError, readAll(bzip2_corrupt, 10))
+  TEST_EQUAL(bzip2_corrupt.isOpen(), false)
+END_SECTION
+
+START_SECTION((bool isParallel() const))
+  // FASTAFile_test.fasta.gz is BGZF compressed, FASTAFile_test.fasta.bz2 consists of several bzip2 streams
+  ReadAheadDecompressor bgzf(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), 4, 100);
+  TEST_EQUAL(bgzf.isParallel(), true)
+  TEST_EQUAL(readAll(bgzf, 7) == plain, true)
+  ReadAheadDecompressor bzip2(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2"), 4, 100);
+  TEST_EQUAL(bzip2.isParallel(), true)
+  TEST_EQUAL(readAll(bzip2, 7) == plain, true)
+
+  // same result with a single thread
+  ReadAheadDecompressor bgzf_single(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), 1, 100);
+  TEST_EQUAL(bgzf_single.isParallel(), false)
+  TEST_EQUAL(readAll(bgzf_single, 4096) == plain, true)
+  ReadAheadDecompressor bzip2_single(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2"), 1, 100);
+  TEST_EQUAL(bzip2_single.isParallel(), false)
+  TEST_EQUAL(readAll(bzip2_single, 4096) == plain, true)
+
+  // regular gzip files can only be decompressed sequentially
+  ReadAheadDecompressor gzip(OPENMS_GET_TEST_DATA_PATH("MzMLFile_6_uncompressed.mzML.gz"), 4);
+  TEST_EQUAL(gzip.isParallel(), false)
+  ReadAheadDecompressor bzip2_mzml(OPENMS_GET_TEST_DATA_PATH("MzMLFile_6_uncompressed.mzML.bz2"), 4);
+  TEST_EQUAL(readAll(gzip, 1000) == readAll(bzip2_mzml, 1000), true)
+END_SECTION
+
+START_SECTION((bool streamEnd() const))
+  // tested above
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((bool isOpen() const))
+  // tested above
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((void open(const char* filename, Size nr_threads = 0, Size chunk_size = 1024 * 1024)))
+  ReadAheadDecompressor stream;
+  TEST_EXCEPTION(Exception::FileNotFound, stream.open(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")))
+  TEST_EQUAL(stream.isOpen(), false)
+  stream.open(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2"), 2, 100);
+  char buffer[10];
+  TEST_EQUAL(stream.read(buffer, 10), 10)
+  // reopening while the background threads are busy
+  stream.open(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), 2, 100);
+  TEST_EQUAL(readAll(stream, 50) == plain, true)
+END_SECTION
+
+START_SECTION((void close()))
+  ReadAheadDecompressor stream(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz"), 2, 100);
+  stream.close();
+  TEST_EQUAL(stream.isOpen(), false)
+  TEST_EQUAL(stream.streamEnd(), true)
+  stream.close();
+  TEST_EQUAL(stream.isOpen(), false)
+END_SECTION
+
+START_SECTION((static bool isCompressed(const char* filename)))
+  TEST_EQUAL(ReadAheadDecompressor::isCompressed(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.gz")), true)
+  TEST_EQUAL(ReadAheadDecompressor::isCompressed(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta.bz2")), true)
+  TEST_EQUAL(ReadAheadDecompressor::isCompressed(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")), false)
+  TEST_EQUAL(ReadAheadDecompressor::isCompressed(OPENMS_GET_TEST_DATA_PATH("ThisFileDoesNotExist")), false)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,145 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/ReadMostlyHashMap.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ReadMostlyHashMap, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ReadMostlyHashMap<String, int>* map_ptr = nullptr;
+ReadMostlyHashMap<String, int>* map_nullPointer = nullptr;
+START_SECTION((ReadMostlyHashMap(Size bucket_count = 1024)))
+  map_ptr = new ReadMostlyHashMap<String, int>;
+  TEST_NOT_EQUAL(map_ptr, map_nullPointer)
+  TEST_EQUAL(map_ptr->size(), 0)
+END_SECTION
+
+START_SECTION((~ReadMostlyHashMap()))
+  delete map_ptr;
+END_SECTION
+
+START_SECTION((const T* find(const Key& key) const))
+  ReadMostlyHashMap<String, int> map(4);
+  const int* int_nullPointer = nullptr;
+  TEST_EQUAL(map.find("a"), int_nullPointer)
+  map.insert("a", 1);
+  TEST_NOT_EQUAL(map.find("a"), int_nullPointer)
+  TEST_EQUAL(*map.find("a"), 1)
+  TEST_EQUAL(map.find("b"), int_nullPointer)
+END_SECTION
+
+START_SECTION((bool has(const Key& key) const))
+  ReadMostlyHashMap<String, int> map;
+  map.insert("a", 1);
+  TEST_EQUAL(map.has("a"), true)
+  TEST_EQUAL(map.has("b"), false)
+END_SECTION
+
+START_SECTION((void insert(const Key& key, const T& value)))
+  // one bucket only: all entries are chained
+  ReadMostlyHashMap<String, int> map(1);
+  for (int i = 0; i < 100; ++i)
+  {
+    map.insert(String(i), i);
+  }
+  TEST_EQUAL(map.size(), 100)
+  TEST_EQUAL(*map.find("0"), 0)
+  TEST_EQUAL(*map.find("99"), 99)
+
+  // replacing a value keeps the previous one valid (readers may still use it)
+  const int* old_value = map.find("42");
+  map.insert("42", -42);
+  TEST_EQUAL(map.size(), 100)
+  TEST_EQUAL(*map.find("42"), -42)
+  TEST_EQUAL(*old_value, 42)
+END_SECTION
+
+START_SECTION((Size size() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void clear()))
+  ReadMostlyHashMap<String, int> map;
+  map.insert("a", 1);
+  map.insert("b", 2);
+  map.clear();
+  TEST_EQUAL(map.size(), 0)
+  TEST_EQUAL(map.has("a"), false)
+  map.insert("a", 3);
+  TEST_EQUAL(*map.find("a"), 3)
+END_SECTION
+
+START_SECTION([EXTRA] concurrent lookups and insertions)
+{
+  ReadMostlyHashMap<int, int> map(64);
+  for (int i = 0; i < 1000; ++i)
+  {
+    map.insert(i, i);
+  }
+
+  int nr_wrong(0);
+  #pragma omp parallel for reduction (+: nr_wrong)
+  for (int k = 0; k < 100000; ++k)
+  {
+    if (k % 100 == 0)
+    {
+      #pragma omp critical (ReadMostlyHashMap_test)
+      {
+        map.insert(1000 + k / 100, k);
+      }
+    }
+    const int* value = map.find(k % 1000);
+    if (value == nullptr || *value != k % 1000) ++nr_wrong;
+  }
+  TEST_EQUAL(nr_wrong, 0)
+  TEST_EQUAL(map.size(), 2000)
+  TEST_EQUAL(*map.find(1999), 99900)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -160,6 +160,33 @@ START_SECTION(Size getNumberOfModifiedResidues() const)
 	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 2)
 END_SECTION
 
+START_SECTION([EXTRA] multithreaded lookups)
+{
+  // lookups of residues and existing modified residues do not lock; new modified residues are created concurrently
+  const char* mods[] = {"Oxidation (M)", "Carbamidomethyl (C)", "Phospho (S)", "Phospho (T)", "Phospho (Y)", "Deamidated (N)", "Acetyl (K)", "Methyl (R)"};
+  const char* residues[] = {"M", "C", "S", "T", "Y", "N", "K", "R"};
+  const int nr_mods = 8;
+
+  int nr_iterations(20000), nr_wrong(0);
+  #pragma omp parallel for reduction (+: nr_wrong)
+  for (int k = 0; k < nr_iterations; ++k)
+  {
+    int i = k % nr_mods;
+    const Residue* residue = ptr->getResidue(residues[i]);
+    const Residue* mod_res = ptr->getModifiedResidue(residue, mods[i]);
+    if (mod_res->getOneLetterCode() != residues[i] || !mod_res->isModified()) ++nr_wrong;
+    if (!ptr->hasResidue(residue->getName())) ++nr_wrong;
+  }
+
+  TEST_EQUAL(nr_wrong, 0)
+  // every modified residue exists only once
+  for (int i = 0; i < nr_mods; ++i)
+  {
+    TEST_EQUAL(ptr->getModifiedResidue(ptr->getResidue(residues[i]), mods[i]), ptr->getModifiedResidue(mods[i]))
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -157,6 +157,75 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] long spectra and chromatograms in parallel)
+{
+  // longer than the block size of the steady state convolution
+  PeakMap exp;
+  exp.resize(8);
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    Peak1D p;
+    for (Size i = 0; i < 2500 + 100 * s; ++i)
+    {
+      p.setMZ(100.0 + i * 0.01);
+      p.setIntensity(1000.0f * (1.0f + std::sin(i * 0.05f)) + (i * 7919) % 113);
+      exp[s].push_back(p);
+    }
+    MSChromatogram chrom;
+    ChromatogramPeak cp;
+    for (Size i = 0; i < 1500; ++i)
+    {
+      cp.setRT(i * 0.1);
+      cp.setIntensity((i * 7919) % 113);
+      chrom.push_back(cp);
+    }
+    exp.addChromatogram(chrom);
+  }
+
+  Param p;
+  p.setValue("frame_length", 11);
+  p.setValue("polynomial_order", 4);
+  SavitzkyGolayFilter sgolay;
+  sgolay.setParameters(p);
+
+  // filtering the experiment must give the same result as filtering each spectrum on its own
+  PeakMap exp_single = exp;
+  for (Size s = 0; s < exp_single.size(); ++s)
+  {
+    sgolay.filter(exp_single[s]);
+    sgolay.filter(exp_single.getChromatogram(s));
+  }
+  sgolay.filterExperiment(exp);
+
+  bool all_equal = true;
+  for (Size s = 0; s < exp.size(); ++s)
+  {
+    for (Size i = 0; i < exp[s].size(); ++i)
+    {
+      if (exp[s][i].getIntensity() != exp_single[s][i].getIntensity() || exp[s][i].getMZ() != exp_single[s][i].getMZ()) all_equal = false;
+    }
+    for (Size i = 0; i < exp.getChromatogram(s).size(); ++i)
+    {
+      if (exp.getChromatogram(s)[i].getIntensity() != exp_single.getChromatogram(s)[i].getIntensity()) all_equal = false;
+    }
+  }
+  TEST_EQUAL(all_equal, true)
+
+  // smoothing a constant signal does not change it (also at the borders)
+  MSSpectrum constant;
+  for (Size i = 0; i < 3000; ++i)
+  {
+    Peak1D peak(100.0 + i * 0.01, 500.0f);
+    constant.push_back(peak);
+  }
+  sgolay.filter(constant);
+  TOLERANCE_ABSOLUTE(0.01)
+  TEST_REAL_SIMILAR(constant[0].getIntensity(), 500.0)
+  TEST_REAL_SIMILAR(constant[1500].getIntensity(), 500.0)
+  TEST_REAL_SIMILAR(constant[2999].getIntensity(), 500.0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -114,6 +114,92 @@ START_SECTION([EXTRA](virtual void init(const PeakIterator& it_begin, const Peak
 
 END_SECTION
 
+START_SECTION([EXTRA] exact median (median_method = 'exact'))
+{
+  MSSpectrum raw_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  p.setValue("median_method", "exact");
+  sne.setParameters(p);
+  sne.init(raw_data.begin(), raw_data.end());
+
+  // compare to the (lower) median of each window computed from scratch
+  for (MSSpectrum::const_iterator it = raw_data.begin(); it != raw_data.end(); ++it)
+  {
+    std::vector<double> window;
+    for (MSSpectrum::const_iterator it2 = raw_data.begin(); it2 != raw_data.end(); ++it2)
+    {
+      if (it2->getMZ() >= it->getMZ() - 20.0 && it2->getMZ() <= it->getMZ() + 20.0) window.push_back(it2->getIntensity());
+    }
+    double noise = 2.0;
+    if (window.size() >= 10)
+    {
+      std::sort(window.begin(), window.end());
+      noise = std::max(1.0, window[(window.size() + 1) / 2 - 1]);
+    }
+    TEST_REAL_SIMILAR(sne.getSignalToNoise(it), it->getIntensity() / noise);
+  }
+  TEST_REAL_SIMILAR(sne.getHistogramRightmostPercent(), 0.0)
+}
+END_SECTION
+
+START_SECTION([EXTRA] exact median with irregular (sparse) spacing)
+{
+  // clusters of two peaks, 6 Th apart, with rising intensities: the lower half
+  // of a window can leave it completely while the upper half is still inside
+  MSSpectrum spec;
+  double mz = 100.0;
+  for (Size i = 0; i < 300; ++i)
+  {
+    mz += (i % 4 == 0) ? 0.5 : 6.0;
+    Peak1D peak;
+    peak.setMZ(mz);
+    peak.setIntensity(i * 10 + (i * 7919) % 31 + 1);
+    spec.push_back(peak);
+  }
+
+  Param p;
+  p.setValue("win_len", 20.0);
+  p.setValue("min_required_elements", 1);
+  p.setValue("auto_mode", -1);
+  p.setValue("max_intensity", 4000);
+  p.setValue("bin_count", 400); // bin width: 10
+  p.setValue("write_log_messages", "false");
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne_hist;
+  sne_hist.setParameters(p);
+  sne_hist.init(spec);
+  p.setValue("median_method", "exact");
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne_exact;
+  sne_exact.setParameters(p);
+  sne_exact.init(spec);
+
+  Size nr_wrong_exact(0), nr_wrong_hist(0);
+  for (MSSpectrum::const_iterator it = spec.begin(); it != spec.end(); ++it)
+  {
+    std::vector<double> window;
+    for (MSSpectrum::const_iterator it2 = spec.begin(); it2 != spec.end(); ++it2)
+    {
+      if (it2->getMZ() >= it->getMZ() - 10.0 && it2->getMZ() <= it->getMZ() + 10.0) window.push_back(it2->getIntensity());
+    }
+    std::sort(window.begin(), window.end());
+    double median = window[(window.size() + 1) / 2 - 1];
+
+    double noise_exact = it->getIntensity() / sne_exact.getSignalToNoise(it);
+    if (std::fabs(noise_exact - median) > 1e-6 * median) ++nr_wrong_exact;
+    // the histogram estimator reports the center of the bin that holds the median
+    double noise_hist = it->getIntensity() / sne_hist.getSignalToNoise(it);
+    if (std::fabs(noise_hist - noise_exact) > 5.0 + 1e-6 * median) ++nr_wrong_hist;
+  }
+  TEST_EQUAL(nr_wrong_exact, 0)
+  TEST_EQUAL(nr_wrong_hist, 0)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -146,6 +146,53 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
 
 END_SECTION
 
+START_SECTION([EXTRA] mergeSpectraPrecursors single linkage over the m/z-RT grid)
+{
+  // precursors are chained via RT (each within tolerance of the next, but not of the first)
+  PeakMap exp;
+  double rts[] = {10.0, 14.0, 18.0, 30.0, 10.5};
+  double mzs[] = {500.0, 500.00002, 500.00004, 500.0, 600.0};
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    spec.setRT(rts[i]);
+    Precursor pc;
+    pc.setMZ(mzs[i]);
+    spec.setPrecursors(std::vector<Precursor>(1, pc));
+    Peak1D peak;
+    peak.setMZ(100.0 + i);
+    peak.setIntensity(1.0f);
+    spec.push_back(peak);
+    exp.addSpectrum(spec);
+  }
+  exp.sortSpectra();
+
+  SpectraMerger merger;
+  Param p;
+  p.setValue("mz_binning_width", 0.0001);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("precursor_method:mz_tolerance", 10e-5);
+  p.setValue("precursor_method:rt_tolerance", 5.0);
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+
+  TEST_EQUAL(exp.size(), 3)
+  ABORT_IF(exp.size() != 3)
+  TEST_REAL_SIMILAR(exp[0].getRT(), 10.5)
+  TEST_EQUAL(exp[0].size(), 1)
+  TEST_REAL_SIMILAR(exp[1].getRT(), 14.0) // average of 10, 14, 18
+  TEST_EQUAL(exp[1].size(), 3)
+  TEST_REAL_SIMILAR(exp[1].getPrecursors()[0].getMZ(), 500.00002)
+  TEST_REAL_SIMILAR(exp[2].getRT(), 30.0)
+  TEST_EQUAL(exp[2].size(), 1)
+
+  // missing precursor
+  exp[0].setPrecursors(std::vector<Precursor>());
+  TEST_EXCEPTION(Exception::MissingInformation, merger.mergeSpectraPrecursors(exp))
+}
+END_SECTION
+
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), exp);    // profile mode
@@ -40,6 +40,7 @@
 ///////////////////////////
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessQuadMZTransforming.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSqliteSwathHandler.h>
 
@@ -249,6 +250,115 @@ START_SECTION(void getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra
 }
 END_SECTION
 
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+
+  ptr = new SpectrumAccessSqMass(handler);
+  OpenSwath::SpectrumPtr s0 = ptr->getSpectrumById(0);
+  OpenSwath::SpectrumPtr s1 = ptr->getSpectrumById(1);
+  TEST_EQUAL(s0->getMZArray()->data.size(), 19914)
+  TEST_EQUAL(s0->getIntensityArray()->data.size(), 19914)
+  TEST_EQUAL(s1->getMZArray()->data.size(), 19800)
+
+  // cached spectra are shared with clones and subsets, but every call returns its own copy
+  OpenSwath::SpectrumPtr s0_clone = ptr->lightClone()->getSpectrumById(0);
+  TEST_EQUAL(s0_clone == s0, false)
+  TEST_EQUAL(s0_clone->getMZArray() == s0->getMZArray(), false)
+  TEST_EQUAL(s0_clone->getMZArray()->data == s0->getMZArray()->data, true)
+  std::vector<int> indices;
+  indices.push_back(1);
+  SpectrumAccessSqMass subset(*ptr, indices);
+  TEST_EQUAL(subset.getSpectrumById(0)->getMZArray()->data == s1->getMZArray()->data, true)
+
+  // modifying a returned spectrum does not change the cache
+  double first_mz = s0->getMZArray()->data[0];
+  s0->getMZArray()->data[0] = -1.0;
+  TEST_REAL_SIMILAR(ptr->getSpectrumById(0)->getMZArray()->data[0], first_mz)
+  s0->getMZArray()->data[0] = first_mz;
+
+  // without cache, spectra are read again
+  ptr->setCacheSize(0);
+  OpenSwath::SpectrumPtr s0_new = ptr->getSpectrumById(0);
+  TEST_EQUAL(s0_new == s0, false)
+  TEST_EQUAL(s0_new->getMZArray()->data == s0->getMZArray()->data, true)
+  TEST_EQUAL(s0_new->getIntensityArray()->data == s0->getIntensityArray()->data, true)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+
+  ptr = new SpectrumAccessSqMass(handler);
+  TEST_REAL_SIMILAR(ptr->getSpectrumMetaById(0).RT, 0.2961)
+  TEST_REAL_SIMILAR(ptr->getSpectrumMetaById(1).RT, 0.4738)
+  TEST_EQUAL(ptr->getSpectrumMetaById(1).ms_level, 1)
+  TEST_EQUAL(ptr->getSpectrumMetaById(1).id, "controllerType=0 controllerNumber=1 scan=2")
+
+  std::vector<int> indices;
+  indices.push_back(1);
+  SpectrumAccessSqMass subset(*ptr, indices);
+  TEST_REAL_SIMILAR(subset.getSpectrumMetaById(0).RT, 0.4738)
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+
+  ptr = new SpectrumAccessSqMass(handler);
+  std::vector<std::size_t> res = ptr->getSpectraByRT(0.3, 0.2);
+  TEST_EQUAL(res.size(), 2)
+  TEST_EQUAL(res[0], 0)
+  TEST_EQUAL(res[1], 1)
+
+  res = ptr->getSpectraByRT(0.45, 0.05);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 1)
+
+  res = ptr->getSpectraByRT(0.3, 0.0);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 1)
+
+  res = ptr->getSpectraByRT(0.1, 0.0);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 0)
+
+  res = ptr->getSpectraByRT(1.0, 0.0);
+  TEST_EQUAL(res.size(), 0)
+
+  // indices refer to the subset
+  std::vector<int> indices;
+  indices.push_back(1);
+  SpectrumAccessSqMass subset(*ptr, indices);
+  res = subset.getSpectraByRT(0.3, 0.2);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 0)
+}
+END_SECTION
+
+START_SECTION([EXTRA] m/z calibration through SpectrumAccessQuadMZTransforming is applied once per access)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"));
+
+  boost::shared_ptr<SpectrumAccessSqMass> sqmass(new SpectrumAccessSqMass(handler));
+  std::vector<double> raw_mz = sqmass->getSpectrumById(0)->getMZArray()->data;
+
+  // shift all m/z values by 0.5 (cached spectrum is now in the cache)
+  SpectrumAccessQuadMZTransforming calibrated(sqmass, 0.5, 1.0, 0.0, false);
+  OpenSwath::SpectrumPtr first = calibrated.getSpectrumById(0);
+  OpenSwath::SpectrumPtr second = calibrated.getSpectrumById(0);
+  TEST_EQUAL(first->getMZArray()->data.size(), raw_mz.size())
+  TEST_EQUAL(first->getMZArray()->data == second->getMZArray()->data, true)
+  TEST_REAL_SIMILAR(second->getMZArray()->data[0], raw_mz[0] + 0.5)
+  TEST_REAL_SIMILAR(second->getMZArray()->data.back(), raw_mz.back() + 0.5)
+
+  // the uncalibrated access is unaffected
+  TEST_EQUAL(sqmass->getSpectrumById(0)->getMZArray()->data == raw_mz, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
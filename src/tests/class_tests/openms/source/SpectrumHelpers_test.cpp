@@ -117,6 +117,31 @@ START_SECTION ( [EXTRA] testscorefunction)
   TEST_REAL_SIMILAR(intresv[0],0 );
   TEST_REAL_SIMILAR(mzresv[1],200 );
   TEST_REAL_SIMILAR(intresv[1],0 );
+
+  // batched lookup: windows unsorted, overlapping and without signal
+  std::vector<double> win_start, win_end;
+  win_start.push_back(499.6); win_end.push_back(501.4);
+  win_start.push_back(300.0); win_end.push_back(300.5);
+  win_start.push_back(499.0); win_end.push_back(501.0);
+  win_start.push_back(600.0); win_end.push_back(600.02);
+  win_start.push_back(499.0); win_end.push_back(501.0);
+  OpenSwath::integrateWindows(sptr, win_start, win_end, mzresv, intresv);
+  TEST_EQUAL(mzresv.size(), 5)
+  TEST_EQUAL(intresv.size(), 5)
+  TEST_REAL_SIMILAR(mzresv[0], 500.338842975207);
+  TEST_REAL_SIMILAR(intresv[0], 121);
+  TEST_REAL_SIMILAR(mzresv[1], -1);
+  TEST_REAL_SIMILAR(intresv[1], 0);
+  TEST_REAL_SIMILAR(mzresv[2], 499.392014652015);
+  TEST_REAL_SIMILAR(intresv[2], 273);
+  TEST_REAL_SIMILAR(mzresv[4], 499.392014652015);
+  TEST_REAL_SIMILAR(intresv[4], 273);
+  for (Size i = 0; i < win_start.size(); ++i)
+  {
+    OpenSwath::integrateWindow(sptr, win_start[i], win_end[i], mzres, intensityres);
+    TEST_EQUAL(mzresv[i], mzres)
+    TEST_EQUAL(intresv[i], intensityres)
+  }
 }
 END_SECTION
 
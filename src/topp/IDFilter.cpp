@@ -313,6 +313,9 @@ protected:
         peptides, "predicted_RT_p_value_first_dim", pred_rt_pv_1d);
     }
 
+    // interned protein accessions, shared by all accession-based filters:
+    ProteinAccessionIndex accession_index(proteins);
+
     String whitelist_fasta = getStringOption_("whitelist:proteins").trim();
     if (!whitelist_fasta.empty())
     {
@@ -326,8 +329,9 @@ protected:
       {
         accessions.insert(it->identifier);
       }
-      IDFilter::keepHitsMatchingProteins(peptides, accessions);
-      IDFilter::keepHitsMatchingProteins(proteins, accessions);
+      IDFilter::AccessionFilter filter;
+      filter.whitelist.swap(accessions);
+      IDFilter::filterByProteinAccessions(peptides, proteins, accession_index, filter);
     }
 
     vector<String> whitelist_accessions =
@@ -336,10 +340,10 @@ protected:
     {
       OPENMS_LOG_INFO << "Filtering by protein whitelisting (accessions input)..."
                << endl;
-      set<String> accessions(whitelist_accessions.begin(),
-                             whitelist_accessions.end());
-      IDFilter::keepHitsMatchingProteins(peptides, accessions);
-      IDFilter::keepHitsMatchingProteins(proteins, accessions);
+      IDFilter::AccessionFilter filter;
+      filter.whitelist.insert(whitelist_accessions.begin(),
+                              whitelist_accessions.end());
+      IDFilter::filterByProteinAccessions(peptides, proteins, accession_index, filter);
     }
 
     String whitelist_peptides = getStringOption_("whitelist:peptides").trim();
@@ -377,8 +381,9 @@ protected:
       {
         accessions.insert(it->identifier);
       }
-      IDFilter::removeHitsMatchingProteins(peptides, accessions);
-      IDFilter::removeHitsMatchingProteins(proteins, accessions);
+      IDFilter::AccessionFilter filter;
+      filter.blacklist.swap(accessions);
+      IDFilter::filterByProteinAccessions(peptides, proteins, accession_index, filter);
     }
 
     vector<String> blacklist_accessions =
@@ -387,10 +392,10 @@ protected:
     {
       OPENMS_LOG_INFO << "Filtering by protein blacklisting (accessions input)..."
                << endl;
-      set<String> accessions(blacklist_accessions.begin(),
-                             blacklist_accessions.end());
-      IDFilter::removeHitsMatchingProteins(peptides, accessions);
-      IDFilter::removeHitsMatchingProteins(proteins, accessions);
+      IDFilter::AccessionFilter filter;
+      filter.blacklist.insert(blacklist_accessions.begin(),
+                              blacklist_accessions.end());
+      IDFilter::filterByProteinAccessions(peptides, proteins, accession_index, filter);
     }
 
     String blacklist_peptides = getStringOption_("blacklist:peptides").trim();
@@ -656,20 +661,22 @@ protected:
 
     // Clean-up:
 
-    if (!getFlag_("keep_unreferenced_protein_hits"))
-    {
-      OPENMS_LOG_INFO << "Removing unreferenced protein hits..." << endl;
-      IDFilter::removeUnreferencedProteins(proteins, peptides);
-    }
-
-    IDFilter::updateHitRanks(proteins);
+    // peptide ranks are assigned before hits without protein references are removed:
     IDFilter::updateHitRanks(peptides);
 
-    // remove non-existant protein references from peptides (and optionally:
-    // remove peptides with no proteins):
-    bool rm_pep = getFlag_("delete_unreferenced_peptide_hits");
-    if (rm_pep) OPENMS_LOG_INFO << "Removing peptide hits without protein references..." << endl;
-    IDFilter::updateProteinReferences(peptides, proteins, rm_pep);
+    // remove unreferenced proteins and non-existant protein references from
+    // peptides (and optionally: remove peptides with no proteins) in one pass:
+    IDFilter::AccessionFilter cleanup;
+    cleanup.update_references = true;
+    cleanup.remove_unreferenced_proteins = !getFlag_("keep_unreferenced_protein_hits");
+    if (cleanup.remove_unreferenced_proteins) OPENMS_LOG_INFO << "Removing unreferenced protein hits..." << endl;
+    cleanup.remove_peptides_without_reference = getFlag_("delete_unreferenced_peptide_hits");
+    if (cleanup.remove_peptides_without_reference) OPENMS_LOG_INFO << "Removing peptide hits without protein references..." << endl;
+    // protein hits may have been removed by other filters in the meantime:
+    accession_index.build(proteins);
+    IDFilter::filterByProteinAccessions(peptides, proteins, accession_index, cleanup);
+
+    IDFilter::updateHitRanks(proteins);
 
     IDFilter::removeEmptyIdentifications(peptides);
     // we want to keep "empty" protein IDs because they contain search meta data
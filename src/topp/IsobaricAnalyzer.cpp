@@ -47,6 +47,8 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/IsobaricChannelExtractor.h>
 #include <OpenMS/ANALYSIS/QUANTITATION/IsobaricQuantifier.h>
 
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChannelExtractingConsumer.h>
+
 #include <OpenMS/SYSTEM/File.h>
 
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
@@ -107,6 +109,10 @@ using namespace std;
   exceed the tolerance to a neighbouring channel with the same nominal mass (C/N channels).
   If the distance is too large, you might have a m/z calibration problem (see @ref TOPP_InternalCalibration).
   
+  Large runs can be processed without loading them into memory first (option @p processOption lowmemory).
+  The reporter ions are then extracted while the input file is read, keeping only the spectra of a few
+  MS1 cycles in memory. The result is the same as with the default in-memory processing.
+
   @note If none of the reporter ions can be detected in an MSn scan, a consensus feature will still be generated, 
   but the intensities of the overall feature and of all its sub-elements will be zero.
   (If desired, such features can be removed by applying an intensity filter in @ref TOPP_FileFilter.)
@@ -217,6 +223,9 @@ protected:
     registerOutputFile_("out", "<file>", "", "output consensusXML file with quantitative information");
     setValidFormats_("out", ListUtils::create<String>("consensusXML"));
 
+    registerStringOption_("processOption", "<name>", "inmemory", "Whether to load all data and process them in-memory or whether to extract the channels on the fly (lowmemory) without loading the whole file into memory first (input spectra must be sorted by RT)", false, true);
+    setValidStrings_("processOption", ListUtils::create<String>("inmemory,lowmemory"));
+
     registerSubsection_("extraction", "Parameters for the channel extraction.");
     registerSubsection_("quantification", "Parameters for the peptide quantification.");
     for (std::map<String, IsobaricQuantitationMethod*>::iterator it = quant_methods_.begin();
@@ -261,15 +270,7 @@ protected:
     //-------------------------------------------------------------
     String in = getStringOption_("in");
     String out = getStringOption_("out");
-
-    //-------------------------------------------------------------
-    // loading input
-    //-------------------------------------------------------------
-
-    MzMLFile mz_data_file;
-    PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
+    String process_option = getStringOption_("processOption");
 
     //-------------------------------------------------------------
     // init quant method
@@ -283,13 +284,32 @@ protected:
     // calculations
     //-------------------------------------------------------------
     Param extract_param(getParam_().copy("extraction:", true));
-    IsobaricChannelExtractor channel_extractor(quant_method);
-    channel_extractor.setParameters(extract_param);
-
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
-    // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    if (process_option == "lowmemory")
+    {
+      // extract channel information while reading the input
+      MSDataChannelExtractingConsumer extracting_consumer(quant_method);
+      extracting_consumer.setParameters(extract_param);
+      mz_data_file.transform(in, &extracting_consumer, true);
+      extracting_consumer.finish(consensus_map_raw);
+    }
+    else
+    {
+      //-------------------------------------------------------------
+      // loading input
+      //-------------------------------------------------------------
+      PeakMap exp;
+      mz_data_file.load(in, exp);
+
+      IsobaricChannelExtractor channel_extractor(quant_method);
+      channel_extractor.setParameters(extract_param);
+
+      // extract channel information
+      channel_extractor.extractChannels(exp, consensus_map_raw);
+    }
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
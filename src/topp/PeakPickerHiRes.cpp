@@ -36,6 +36,7 @@
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
 using namespace OpenMS;
@@ -123,44 +124,6 @@ public:
 
 protected:
 
-  /**
-    @brief Helper class for the Low Memory peak-picking
-  */
-  class PPHiResMzMLConsumer :
-    public MSDataWritingConsumer
-  {
-
-  public:
-
-    PPHiResMzMLConsumer(String filename, const PeakPickerHiRes& pp) :
-      MSDataWritingConsumer(filename),
-      ms_levels_(pp.getParameters().getValue("ms_levels").toIntList())
-    {
-      pp_ = pp;
-    }
-
-    void processSpectrum_(MapType::SpectrumType& s) override
-    {
-      if (!ListUtils::contains(ms_levels_, s.getMSLevel())) {return;}
-
-      MapType::SpectrumType sout;
-      pp_.pick(s, sout);
-      s = sout;  // todo: swap? (requires implementation)
-    }
-
-    void processChromatogram_(MapType::ChromatogramType & c) override
-    {
-      MapType::ChromatogramType c_out;
-      pp_.pick(c, c_out);
-      c = c_out;
-    }
-
-  private:
-
-    PeakPickerHiRes pp_;
-    std::vector<Int> ms_levels_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input profile data file ");
@@ -170,6 +133,8 @@ protected:
 
     registerStringOption_("processOption", "<name>", "inmemory", "Whether to load all data and process them in-memory or whether to process the data on the fly (lowmemory) without loading the whole file into memory first", false, true);
     setValidStrings_("processOption", ListUtils::create<String>("inmemory,lowmemory"));
+    registerIntOption_("batch_size", "<number>", 1000, "Number of spectra which are picked in parallel in 'lowmemory' mode. Larger values scale better with the number of threads but need more memory.", false, true);
+    setMinInt_("batch_size", 1);
 
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
@@ -182,10 +147,28 @@ protected:
   ExitCodes doLowMemAlgorithm(const PeakPickerHiRes& pp)
   {
     ///////////////////////////////////
-    // Create the consumer object, add data processing
+    // Create the writing consumer object, add data processing
+    ///////////////////////////////////
+    PlainMSDataWritingConsumer writing_consumer(out);
+    writing_consumer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+
+    ///////////////////////////////////
+    // Pick batches of spectra in parallel and pass them on in their original order
     ///////////////////////////////////
-    PPHiResMzMLConsumer pp_consumer(out, pp);
-    pp_consumer.addDataProcessing(getProcessingInfo_(DataProcessing::PEAK_PICKING));
+    std::vector<Int> ms_levels = pp.getParameters().getValue("ms_levels").toIntList();
+    MSDataParallelTransformingConsumer pp_consumer(&writing_consumer, getIntOption_("batch_size"));
+    pp_consumer.setSpectraProcessingFunc([&pp, &ms_levels](MSSpectrum& s, MSSpectrum& scratch)
+      {
+        if (!ListUtils::contains(ms_levels, s.getMSLevel())) {return;}
+
+        pp.pick(s, scratch);
+        std::swap(s, scratch); // keep the buffers of the profile spectrum for the next pick() of this thread
+      });
+    pp_consumer.setChromatogramProcessingFunc([&pp](MSChromatogram& c, MSChromatogram& scratch)
+      {
+        pp.pick(c, scratch);
+        std::swap(c, scratch);
+      });
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
@@ -193,6 +176,7 @@ protected:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &pp_consumer);
+    pp_consumer.flush(); // the last batch must be written before the writing consumer is closed
 
     return EXECUTION_OK;
   }
@@ -37,6 +37,7 @@
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/ReadAheadDecompressor.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/SYSTEM/File.h>
@@ -176,8 +177,17 @@ protected:
     // calculations
     //-------------------------------------------------------------
 
-    FASTAContainer<TFI_File> proteins(db_name);
-    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    PeptideIndexing::ExitCodes indexer_exit;
+    if (ReadAheadDecompressor::isCompressed(db_name.c_str()))
+    {
+      FASTAContainer<TFI_File> proteins(db_name);
+      indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    }
+    else
+    { // uncompressed databases are mapped into memory and their entries are located in parallel
+      FASTAContainer<TFI_Mapped> proteins(db_name);
+      indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    }
   
     //-------------------------------------------------------------
     // calculate protein coverage
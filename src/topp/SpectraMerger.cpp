@@ -37,6 +37,8 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataSpectraMergingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
 #include <algorithm>
 
@@ -72,6 +74,10 @@ using namespace std;
 
   In any case, the number of scans will be reduced.
 
+  The methods 'block_method' and 'precursor_method' can also be applied on the fly (option 'processOption lowmemory'),
+  i.e. the spectra are read, merged and written within a sliding RT window without loading the whole file into
+  memory. This requires the spectra of the input file to be sorted by RT.
+
   <B>The command line parameters of this tool are:</B>
   @verbinclude TOPP_SpectraMerger.cli
   <B>INI file documentation of this tool:</B>
@@ -102,6 +108,9 @@ protected:
     registerStringOption_("merging_method", "<method>", "average_gaussian", "Method of merging which should be used.", false);
     setValidStrings_("merging_method", ListUtils::create<String>("average_gaussian,average_tophat,precursor_method,block_method"));
 
+    registerStringOption_("processOption", "<name>", "inmemory", "Whether to load all data and process them in-memory or whether to process the data on the fly (lowmemory) without loading the whole file into memory first (only for 'block_method' and 'precursor_method'; input spectra must be sorted by RT)", false, true);
+    setValidStrings_("processOption", ListUtils::create<String>("inmemory,lowmemory"));
+
     registerSubsection_("algorithm", "Algorithm section for merging spectra");
   }
 
@@ -118,6 +127,29 @@ protected:
     String in(getStringOption_("in"));
     String out(getStringOption_("out"));
     String merging_method(getStringOption_("merging_method"));
+    String process_option(getStringOption_("processOption"));
+
+    if (process_option == "lowmemory")
+    {
+      if (merging_method != "precursor_method" && merging_method != "block_method")
+      {
+        writeLog_("Error: Only 'block_method' and 'precursor_method' can be used with 'processOption lowmemory'.");
+        return ILLEGAL_PARAMETERS;
+      }
+
+      // merge within a sliding RT window and write the spectra right away
+      PlainMSDataWritingConsumer writing_consumer(out);
+      MSDataSpectraMergingConsumer merging_consumer(&writing_consumer, merging_method);
+      merging_consumer.setLogType(log_type_);
+      merging_consumer.setParameters(getParam_().copy("algorithm:", true));
+
+      MzMLFile mz_data_file;
+      mz_data_file.setLogType(log_type_);
+      mz_data_file.transform(in, &merging_consumer);
+      merging_consumer.flush(); // the last window must be written before the writing consumer is closed
+
+      return EXECUTION_OK;
+    }
 
     //-------------------------------------------------------------
     // reading input
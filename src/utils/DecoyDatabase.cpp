@@ -42,6 +42,13 @@
 #include <OpenMS/CHEMISTRY/DigestionEnzyme.h>
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <boost/regex.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
+
+#include <atomic>
+#include <exception>
+#include <thread>
 
 using namespace OpenMS;
 using namespace std;
@@ -71,6 +78,11 @@ using namespace std;
   externally.
 
   The tool will keep track of all protein identifiers and report duplicates.
+  To keep the memory consumption low for huge (e.g. metagenomic) databases, only a 64 bit fingerprint of every identifier is stored.
+
+  The input is read in chunks (see @p chunk_size) on a background thread, while the decoys of the previous chunk are generated in parallel
+  (see @p threads). Every sequence is shuffled with a random number generator seeded with @p seed, so the output
+  does not depend on the number of threads. Entries are written in the order of the input.
 
   <B>The command line parameters of this tool are:</B>
   @verbinclude UTILS_DecoyDatabase.cli
@@ -117,6 +129,9 @@ protected:
     registerStringOption_("enzyme", "<enzyme>", "Trypsin", "Enzyme used for the digestion of the sample. Only applicable if parameter 'type' is 'protein'.",false);
     setValidStrings_("enzyme", all_enzymes);
 
+    registerIntOption_("chunk_size", "<int>", 10000, "Number of entries that are read and processed at once. The output does not depend on this value.", false, true);
+    setMinInt_("chunk_size", 1);
+
     registerSubsection_("Decoy", "Decoy parameters section");
   }
 
@@ -128,6 +143,104 @@ protected:
     return p;
   }
 
+  /**
+    @brief Compact set of identifiers for spotting duplicates in huge databases
+
+    Only a 64 bit fingerprint (hash) of every identifier is stored in an open
+    addressing hash table, i.e. about 16 bytes per identifier instead of the
+    identifier itself plus the overhead of a tree node. Distinct identifiers
+    with the same fingerprint are extremely unlikely (and would only cause a
+    spurious warning).
+  */
+  class IdentifierSet_
+  {
+  public:
+    /// 64 bit fingerprint of @p identifier (FNV-1a, with the bits mixed by the MurmurHash3 finalizer)
+    static UInt64 fingerprint(const String& identifier)
+    {
+      UInt64 h = 14695981039346656037ULL;
+      for (const char c : identifier)
+      {
+        h ^= (unsigned char)c;
+        h *= 1099511628211ULL;
+      }
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    /// inserts @p fp; returns false if it was present already
+    bool insert(UInt64 fp)
+    {
+      if (fp == 0) fp = 1; // 0 marks empty slots
+      if ((size_ + 1) * 2 > slots_.size()) grow_();
+      const Size mask = slots_.size() - 1;
+      for (Size i = fp & mask; ; i = (i + 1) & mask)
+      {
+        if (slots_[i] == fp) return false;
+        if (slots_[i] == 0)
+        {
+          slots_[i] = fp;
+          ++size_;
+          return true;
+        }
+      }
+    }
+
+  private:
+    /// doubles the number of slots (load factor stays below 0.5)
+    void grow_()
+    {
+      vector<UInt64> old;
+      old.swap(slots_);
+      slots_.assign(std::max(Size(1024), old.size() * 2), 0);
+      size_ = 0;
+      for (const UInt64 fp : old)
+      {
+        if (fp != 0) insert(fp);
+      }
+    }
+
+    vector<UInt64> slots_;
+    Size size_ = 0;
+  };
+
+  /**
+    @brief Joins the background reader thread when going out of scope
+
+    If the consumer fails (e.g. writing the output throws), the reader is asked
+    to stop via @p stop and joined before the exception propagates, instead of
+    destroying a joinable std::thread (which would call std::terminate).
+  */
+  struct ReaderGuard_
+  {
+    ReaderGuard_(std::thread& thread, std::atomic<bool>& stop) :
+      thread_(thread), stop_(stop)
+    {
+    }
+
+    /// waits for the reader to finish its chunk
+    void join()
+    {
+      if (thread_.joinable()) thread_.join();
+    }
+
+    ~ReaderGuard_()
+    {
+      if (thread_.joinable())
+      {
+        stop_ = true;
+        thread_.join();
+      }
+    }
+
+    std::thread& thread_;
+    std::atomic<bool>& stop_;
+  };
+
   String getIdentifier_(const String& identifier, const String& decoy_string, const bool as_prefix)
   {
     if (as_prefix) return decoy_string + identifier;
@@ -181,11 +294,8 @@ protected:
                << "You probably want to have them! Just add the contaminant file to the input file list 'in'." << endl;
     }
 
-    set<String> identifiers; // spot duplicate identifiers  // std::unordered_set<string> has slightly more RAM, but slightly less CPU
-
-    FASTAFile f;
-    f.writeStart(out);
-    FASTAFile::FASTAEntry entry;
+    FASTAFile f_out;
+    f_out.writeStart(out);
 
     // Configure Enzymatic digestion
     // TODO: allow user-specified regex
@@ -199,126 +309,220 @@ protected:
     MRMDecoy m;
     m.setParameters(decoy_param);
 
-    for (Size i = 0; i < in.size(); ++i)
+    const boost::regex rna_token("[^\\[]|(\\[[^\\[\\]]*\\])");
+
+    // Creates the decoy of a single entry. Called for many entries in parallel,
+    // so only local random number generators are used (seeded identically for every entry,
+    // i.e. the output does not depend on the number of threads).
+    auto makeDecoy = [&](FASTAFile::FASTAEntry& entry)
     {
-      f.readStart(in[i]);
+      // identifier
+      entry.identifier = getIdentifier_(entry.identifier, decoy_string, decoy_string_position_prefix);
 
-      //-------------------------------------------------------------
-      // calculations
-      //-------------------------------------------------------------
-      while (f.readNext(entry))
+      // sequence
+      if (input_type == SeqType::RNA)
       {
-        if (identifiers.find(entry.identifier) != identifiers.end())
+        string quick_seq = entry.sequence;
+        bool five_p = (entry.sequence.front() == 'p');
+        bool three_p = (entry.sequence.back() == 'p');
+        if (five_p) //we don't want to reverse terminal phosphates
         {
-          OPENMS_LOG_WARN << "DecoyDatabase: Warning, identifier '" << entry.identifier << "' occurs more than once!" << endl;
+          quick_seq.erase(0, 1);
         }
-        identifiers.insert(entry.identifier);
-
-        if (append)
+        if (three_p)
         {
-          f.writeNext(entry);
+          quick_seq.pop_back();
+        }
+        vector<String> tokenized;
+        boost::smatch m;
+        while (boost::regex_search(quick_seq, m, rna_token))
+        {
+          tokenized.push_back(m.str(0));
+          quick_seq = m.suffix();
         }
 
-        // identifier
-        entry.identifier = getIdentifier_(entry.identifier, decoy_string, decoy_string_position_prefix);
-
-        // sequence
-        if (input_type == SeqType::RNA)
+        if (shuffle)
         {
-          string quick_seq = entry.sequence;
-          bool five_p = (entry.sequence.front() == 'p');
-          bool three_p = (entry.sequence.back() == 'p');
-          if (five_p) //we don't want to reverse terminal phosphates
-          {
-            quick_seq.erase(0, 1);
-          }
-          if (three_p)
+          boost::mt19937 generator(seed);
+          boost::uniform_int<> uni_dist;
+          boost::variate_generator<boost::mt19937&, boost::uniform_int<> > pseudoRNG(generator, uni_dist);
+          // same as std::random_shuffle in libstdc++, but independent of the platform
+          for (Size i = 1; i < tokenized.size(); ++i)
           {
-            quick_seq.pop_back();
+            std::iter_swap(tokenized.begin() + i, tokenized.begin() + pseudoRNG(i + 1));
           }
-          vector<String> tokenized;
-          boost::smatch m;
-          while (boost::regex_search(quick_seq, m, boost::regex("[^\\[]|(\\[[^\\[\\]]*\\])")))
+        }
+        else  // reverse
+        {
+          reverse(tokenized.begin(), tokenized.end()); //reverse the tokens
+        }
+        if (five_p)  //add back 5'
+        {
+          tokenized.insert(tokenized.begin(), String("p"));
+        }
+        if (three_p) //add back 3'
+        {
+          tokenized.push_back(String("p"));
+        }
+        entry.sequence = ListUtils::concatenate(tokenized, "");
+      }
+      else // protein input
+      {
+        // if (terminal_aminos != "none")
+        if (enzyme != "no cleavage" && (keepN || keepC))
+        {
+          std::vector<AASequence> peptides;
+          digestion.digest(AASequence::fromString(entry.sequence), peptides);
+          String new_sequence = "";
+          for (auto const& peptide : peptides)
           {
-            tokenized.push_back(m.str(0));
-            quick_seq = m.suffix();
+            if (shuffle)
+            {
+              OpenMS::TargetedExperiment::Peptide p;
+              p.sequence = peptide.toString();
+              OpenMS::TargetedExperiment::Peptide decoy_p = m.shufflePeptide(p, identity_threshold, seed, max_attempts);
+              new_sequence += decoy_p.sequence;
+            }
+            else
+            {
+              OpenMS::TargetedExperiment::Peptide p;
+              p.sequence = peptide.toString();
+              OpenMS::TargetedExperiment::Peptide decoy_p = MRMDecoy::reversePeptide(p, keepN, keepC, keep_const_pattern);
+              new_sequence += decoy_p.sequence;
+            }
           }
-
+          entry.sequence = new_sequence;
+        }
+        else
+        {
+          // sequence
           if (shuffle)
           {
-            srand(seed);
-            random_shuffle(tokenized.begin(), tokenized.end());
+            boost::mt19937 generator(seed); // identical proteins are shuffled the same way
+            boost::uniform_int<> uni_dist;
+            boost::variate_generator<boost::mt19937&, boost::uniform_int<> > pseudoRNG(generator, uni_dist);
+            String temp;
+            temp.reserve(entry.sequence.size());
+            Size x = entry.sequence.size();
+            while (x != 0)
+            {
+              Size y = pseudoRNG(x);
+              temp += entry.sequence[y];
+              --x;
+              entry.sequence[y] = entry.sequence[x]; // overwrite consumed position with last position (about to go out of scope for next dice roll)
+            }
+            entry.sequence.swap(temp);
           }
-          else  // reverse
+          else // reverse
           {
-            reverse(tokenized.begin(), tokenized.end()); //reverse the tokens
+            entry.sequence.reverse();
           }
-          if (five_p)  //add back 5'
+        }
+      }
+    };
+
+    //-------------------------------------------------------------
+    // calculations
+    //-------------------------------------------------------------
+
+    // The input is processed in chunks: while the decoys of one chunk are
+    // generated (in parallel) and written (in input order), a background
+    // thread reads the next chunk.
+    const Size chunk_size = getIntOption_("chunk_size");
+    FASTAFile f_in;
+    Size file_index = 0;
+    bool file_open = false;
+    std::atomic<bool> stop_reading(false); // set if the consumer failed
+    auto readChunk = [&](vector<FASTAFile::FASTAEntry>& chunk)
+    {
+      chunk.resize(chunk_size);
+      Size n = 0;
+      while (n < chunk_size && file_index < in.size() && !stop_reading)
+      {
+        if (!file_open)
+        {
+          f_in.readStart(in[file_index]);
+          file_open = true;
+        }
+        if (f_in.readNext(chunk[n]))
+        {
+          ++n;
+        }
+        else
+        {
+          file_open = false;
+          ++file_index;
+        }
+      }
+      chunk.resize(n);
+    };
+
+    IdentifierSet_ identifiers; // spot duplicate identifiers
+    vector<FASTAFile::FASTAEntry> targets, next_targets, decoys;
+    vector<UInt64> fingerprints;
+    readChunk(targets);
+    while (!targets.empty())
+    {
+      std::exception_ptr read_error;
+      std::thread reader([&]()
+        {
+          try
           {
-            tokenized.insert(tokenized.begin(), String("p"));
+            readChunk(next_targets);
           }
-          if (three_p) //add back 3'
+          catch (...)
           {
-            tokenized.push_back(String("p"));
+            read_error = std::current_exception();
           }
-          entry.sequence = ListUtils::concatenate(tokenized, "");
+        });
+      ReaderGuard_ reader_guard(reader, stop_reading);
+
+      decoys.resize(targets.size());
+      fingerprints.resize(targets.size());
+      std::exception_ptr decoy_error;
+      SignedSize decoy_error_index = targets.size();
+#pragma omp parallel for schedule(dynamic, 100)
+      for (SignedSize i = 0; i < (SignedSize)targets.size(); ++i)
+      {
+        fingerprints[i] = IdentifierSet_::fingerprint(targets[i].identifier);
+        try
+        {
+          decoys[i] = targets[i];
+          makeDecoy(decoys[i]);
         }
-        else // protein input
+        catch (...)
         {
-          // if (terminal_aminos != "none")
-          if (enzyme != "no cleavage" && (keepN || keepC))
-          {
-            std::vector<AASequence> peptides;
-            digestion.digest(AASequence::fromString(entry.sequence), peptides);
-            String new_sequence = "";
-            for (auto const& peptide : peptides)
-            {
-              if (shuffle)
-              {
-                OpenMS::TargetedExperiment::Peptide p;
-                p.sequence = peptide.toString();
-                OpenMS::TargetedExperiment::Peptide decoy_p = m.shufflePeptide(p, identity_threshold, seed, max_attempts);
-                new_sequence += decoy_p.sequence;
-              }
-              else
-              {
-                OpenMS::TargetedExperiment::Peptide p;
-                p.sequence = peptide.toString();
-                OpenMS::TargetedExperiment::Peptide decoy_p = MRMDecoy::reversePeptide(p, keepN, keepC, keep_const_pattern);
-                new_sequence += decoy_p.sequence;
-              }
-            }
-            entry.sequence = new_sequence;
-          }
-          else
+#pragma omp critical (DecoyDatabase_error)
+          if (i < decoy_error_index) // report the first error (in input order)
           {
-            // sequence
-            if (shuffle)
-            {
-              String temp;
-              Size x = entry.sequence.size();
-              srand(seed); // identical proteins are shuffled the same way
-              while (x != 0)
-              {
-                Size y = rand() % x;
-                temp += entry.sequence[y];
-                --x;
-                entry.sequence[y] = entry.sequence[x]; // overwrite consumed position with last position (about to go out of scope for next dice roll)
-              }
-            }
-            else // reverse
-            {
-              entry.sequence.reverse();
-            }
+            decoy_error = std::current_exception();
+            decoy_error_index = i;
           }
         }
+      }
+
+      //-------------------------------------------------------------
+      // writing output
+      //-------------------------------------------------------------
+      for (Size i = 0; i < targets.size(); ++i)
+      {
+        if (SignedSize(i) == decoy_error_index) break;
+        if (!identifiers.insert(fingerprints[i]))
+        {
+          OPENMS_LOG_WARN << "DecoyDatabase: Warning, identifier '" << targets[i].identifier << "' occurs more than once!" << endl;
+        }
+        if (append)
+        {
+          f_out.writeNext(targets[i]);
+        }
+        f_out.writeNext(decoys[i]);
+      }
 
-        //-------------------------------------------------------------
-        // writing output
-        //-------------------------------------------------------------
-        f.writeNext(entry);
-      } // next protein
-    } // input files
+      reader_guard.join();
+      if (decoy_error) std::rethrow_exception(decoy_error);
+      if (read_error) std::rethrow_exception(read_error);
+      targets.swap(next_targets);
+    }
 
     return EXECUTION_OK;
   }
@@ -59,7 +59,7 @@
 #include <OpenMS/ANALYSIS/ID/BasicProteinInferenceAlgorithm.h>
 #include <OpenMS/ANALYSIS/ID/BayesianProteinInferenceAlgorithm.h>
 #include <OpenMS/ANALYSIS/ID/FalseDiscoveryRate.h>
-#include <OpenMS/ANALYSIS/ID/IDBoostGraph.h>
+#include <OpenMS/ANALYSIS/ID/IDCompactGraph.h>
 #include <OpenMS/ANALYSIS/ID/PeptideProteinResolution.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmMedian.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/ElutionPeakDetection.h>
@@ -86,7 +86,7 @@
 
 using namespace OpenMS;
 using namespace std;
-using Internal::IDBoostGraph;
+using Internal::IDCompactGraph;
 
 //-------------------------------------------------------------
 //Doxygen docu
@@ -1244,9 +1244,9 @@ protected:
 
       if (groups)
       {
-        IDBoostGraph ibg{inferred_protein_ids[0], inferred_peptide_ids,0,false};
-        ibg.computeConnectedComponents();
-        ibg.calculateAndAnnotateIndistProteins(true);
+        IDCompactGraph icg{inferred_protein_ids[0], inferred_peptide_ids, 0};
+        icg.computeConnectedComponents();
+        icg.calculateAndAnnotateIndistProteins(true);
       }
     }
     else // if (bayesian)